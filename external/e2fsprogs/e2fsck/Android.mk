@@ -114,6 +114,7 @@ e2fsck_cflags := -O2 -g -W -Wall -fno-strict-aliasing \
 	-DHAVE_INTTYPES_H \
 	-DHAVE_LINUX_FD_H \
 	-DHAVE_NETINET_IN_H \
+	-DHAVE_PTHREAD_H \
 	-DHAVE_SETJMP_H \
 	-DHAVE_SYS_IOCTL_H \
 	-DHAVE_SYS_MMAN_H \
@@ -157,6 +158,7 @@ LOCAL_SRC_FILES := $(e2fsck_src_files)
 LOCAL_C_INCLUDES := $(e2fsck_c_includes)
 LOCAL_CFLAGS := $(e2fsck_cflags)
 LOCAL_SHARED_LIBRARIES := $(addsuffix _host, $(e2fsck_shared_libraries))
+LOCAL_LDLIBS := -lpthread
 LOCAL_MODULE := e2fsck_host
 LOCAL_MODULE_STEM := e2fsck
 LOCAL_MODULE_TAGS := optional
@@ -127,6 +127,8 @@ struct resource_track {
 	void	*brk_start;
 	unsigned long long bytes_read;
 	unsigned long long bytes_written;
+	unsigned long long cache_hits;
+	unsigned long long cache_misses;
 };
 #endif
 
@@ -232,6 +234,9 @@ struct e2fsck_struct {
 	ext2_ino_t stashed_ino;
 	struct ext2_inode *stashed_inode;
 
+	struct process_inode_block *inodes_to_process;
+	int process_inode_count;
+
 	ext2_ino_t lost_and_found;
 	int bad_lost_and_found;
 
@@ -246,6 +251,7 @@ struct e2fsck_struct {
 	int process_inode_size;
 	int inode_buffer_blocks;
 	unsigned int htree_slack_percentage;
+	int num_threads;
 
 	io_channel	journal_io;
 	char	*journal_name;
@@ -292,6 +298,8 @@ struct e2fsck_struct {
 	int blocks_per_page;
 	ext2_u32_list encrypted_dirs;
 
+	e2fsck_t global_ctx;
+
 	void *priv_data;
 };
 
@@ -473,6 +481,12 @@ extern errcode_t e2fsck_allocate_subcluster_bitmap(ext2_filsys fs,
 						   const char *profile_name,
 						   ext2fs_block_bitmap *ret);
 
+extern errcode_t e2fsck_clone_fs(e2fsck_t ctx, ext2_filsys *ret);
+extern void e2fsck_free_cloned_fs(e2fsck_t ctx, ext2_filsys fs);
+extern errcode_t e2fsck_open_cloned_io(e2fsck_t ctx, ext2_filsys fs);
+extern int e2fsck_io_write_gen(ext2_filsys fs, unsigned long long *ret);
+extern const char *e2fsck_operation(e2fsck_t ctx, const char *op);
+
 extern void e2fsck_clear_progbar(e2fsck_t ctx);
 extern int e2fsck_simple_progress(e2fsck_t ctx, const char *label,
 				  float percent, unsigned int dpynum);
@@ -43,6 +43,9 @@
 #ifdef HAVE_ERRNO_H
 #include <errno.h>
 #endif
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
 
 #include "e2fsck.h"
 #include <ext2fs/ext2_ext_attr.h>
@@ -73,6 +76,10 @@ static void process_inodes(e2fsck_t ctx, char *block_buf);
 static EXT2_QSORT_TYPE process_inode_cmp(const void *a, const void *b);
 static errcode_t scan_callback(ext2_filsys fs, ext2_inode_scan scan,
 				  dgrp_t group, void * priv_data);
+static void pass1_scan_inodes(e2fsck_t ctx, ext2_inode_scan scan,
+			      struct ext2_inode *inode, char *block_buf);
+static _INLINE_ void mark_blocks_used(e2fsck_t ctx, blk64_t block,
+				      unsigned int num);
 static void adjust_extattr_refcount(e2fsck_t ctx, ext2_refcount_t refcount,
 				    char *block_buf, int adjust_sign);
 
@@ -98,21 +105,81 @@ struct process_inode_block {
 	struct ext2_inode inode;
 };
 
+#define PASS1_READAHEAD_GROUPS	8
+
 struct scan_callback_struct {
 	e2fsck_t	ctx;
 	char		*block_buf;
+	dgrp_t		end_group;
 };
 
-static struct process_inode_block *inodes_to_process;
-static int process_inode_count;
-
 static __u64 ext2_max_sizes[EXT2_MAX_BLOCK_LOG_SIZE -
 			    EXT2_MIN_BLOCK_LOG_SIZE + 1];
 
-static void unwind_pass1(ext2_filsys fs EXT2FS_ATTR((unused)))
+#ifdef HAVE_PTHREAD_H
+struct pass1_claim {
+	blk64_t		blk;
+	unsigned int	len;
+};
+
+#define RANGE_IDLE	0
+#define RANGE_READY	1
+#define RANGE_RUNNING	2
+#define RANGE_DONE	3
+#define RANGE_SERIAL	4
+
+struct pass1_range {
+	dgrp_t			first_group;
+	dgrp_t			end_group;
+	int			state;
+	int			epoch;
+	e2fsck_t		ctx;
+	ext2_dblist		dblist;
+	struct pass1_claim	*claims;
+	int			num_claims;
+	int			max_claims;
+};
+
+static int pass1_use_threads(e2fsck_t ctx);
+static void pass1_threads(e2fsck_t ctx, ext2_inode_scan scan,
+			  struct scan_callback_struct *scan_struct,
+			  struct ext2_inode *inode);
+
+static void pass1_claim_blocks(e2fsck_t ctx, blk64_t block, unsigned int num)
 {
-	ext2fs_free_mem(&inodes_to_process);
-	inodes_to_process = 0;
+	struct pass1_range *r = (struct pass1_range *) ctx->priv_data;
+	struct pass1_claim *c;
+	errcode_t	retval;
+
+	if (r->num_claims) {
+		c = &r->claims[r->num_claims - 1];
+		if (c->blk + c->len == block && c->len + num > c->len) {
+			c->len += num;
+			return;
+		}
+	}
+	if (r->num_claims >= r->max_claims) {
+		retval = ext2fs_resize_mem(r->max_claims *
+					   sizeof(struct pass1_claim),
+					   (r->max_claims + 1024) *
+					   sizeof(struct pass1_claim),
+					   &r->claims);
+		if (retval) {
+			ctx->flags |= E2F_FLAG_ABORT;
+			return;
+		}
+		r->max_claims += 1024;
+	}
+	c = &r->claims[r->num_claims++];
+	c->blk = block;
+	c->len = num;
+}
+#endif
+
+static void unwind_pass1(e2fsck_t ctx)
+{
+	ext2fs_free_mem(&ctx->inodes_to_process);
+	ctx->inodes_to_process = 0;
 }
 
 int e2fsck_pass1_check_device_inode(ext2_filsys fs EXT2FS_ATTR((unused)),
@@ -378,8 +445,9 @@ static void check_is_really_dir(e2fsck_t ctx, struct problem_context *pctx,
 
 			if (blk < ctx->fs->super->s_first_data_block ||
 			    blk >= ext2fs_blocks_count(ctx->fs->super) ||
-			    ext2fs_fast_test_block_bitmap2(ctx->block_found_map,
-							   blk))
+			    (ctx->block_found_map &&
+			     ext2fs_fast_test_block_bitmap2(ctx->block_found_map,
+							    blk)))
 				return;	
 		}
 		blk = inode->i_block[0];
@@ -390,9 +458,9 @@ static void check_is_really_dir(e2fsck_t ctx, struct problem_context *pctx,
 		return;
 
 	
-	ehandler_operation(_("reading directory block"));
+	e2fsck_operation(ctx, _("reading directory block"));
 	retval = ext2fs_read_dir_block3(ctx->fs, blk, buf, 0);
-	ehandler_operation(0);
+	e2fsck_operation(ctx, 0);
 	if (retval)
 		return;
 
@@ -463,21 +531,16 @@ void e2fsck_pass1(e2fsck_t ctx)
 	int	i;
 	__u64	max_sizes;
 	ext2_filsys fs = ctx->fs;
-	ext2_ino_t	ino = 0;
 	struct ext2_inode *inode;
 	ext2_inode_scan	scan;
 	char		*block_buf;
 #ifdef RESOURCE_TRACK
 	struct resource_track	rtrack;
 #endif
-	unsigned char	frag, fsize;
 	struct		problem_context pctx;
 	struct		scan_callback_struct scan_struct;
-	struct ext2_super_block *sb = ctx->fs->super;
 	const char	*old_op;
 	unsigned int	save_type;
-	int		imagic_fs, extent_fs;
-	int		busted_fs_time = 0;
 	int		inode_size;
 
 	init_resource_track(&rtrack, ctx->fs->io);
@@ -507,9 +570,6 @@ void e2fsck_pass1(e2fsck_t ctx)
 	}
 #undef EXT2_BPP
 
-	imagic_fs = (sb->s_feature_compat & EXT2_FEATURE_COMPAT_IMAGIC_INODES);
-	extent_fs = (sb->s_feature_incompat & EXT3_FEATURE_INCOMPAT_EXTENTS);
-
 	pctx.errcode = e2fsck_allocate_inode_bitmap(fs, _("in-use inode map"),
 						    EXT2FS_BMAP64_RBTREE,
 						    "inode_used_map",
@@ -566,12 +626,12 @@ void e2fsck_pass1(e2fsck_t ctx)
 	inode = (struct ext2_inode *)
 		e2fsck_allocate_memory(ctx, inode_size, "scratch inode");
 
-	inodes_to_process = (struct process_inode_block *)
+	ctx->inodes_to_process = (struct process_inode_block *)
 		e2fsck_allocate_memory(ctx,
 				       (ctx->process_inode_size *
 					sizeof(struct process_inode_block)),
 				       "array of inodes to process");
-	process_inode_count = 0;
+	ctx->process_inode_count = 0;
 
 	pctx.errcode = ext2fs_init_dblist(fs, 0);
 	if (pctx.errcode) {
@@ -615,31 +675,140 @@ void e2fsck_pass1(e2fsck_t ctx)
 	ctx->stashed_inode = inode;
 	scan_struct.ctx = ctx;
 	scan_struct.block_buf = block_buf;
+	scan_struct.end_group = 0;
 	ext2fs_set_inode_callback(scan, scan_callback, &scan_struct);
+	(void) ext2fs_readahead(fs, EXT2_READA_ITABLE, 0,
+				PASS1_READAHEAD_GROUPS);
 	if (ctx->progress)
 		if ((ctx->progress)(ctx, 1, 0, ctx->fs->group_desc_count))
 			return;
-	if ((fs->super->s_wtime < fs->super->s_inodes_count) ||
-	    (fs->super->s_mtime < fs->super->s_inodes_count))
-		busted_fs_time = 1;
-
 	if ((fs->super->s_feature_incompat & EXT4_FEATURE_INCOMPAT_MMP) &&
 	    fs->super->s_mmp_block > fs->super->s_first_data_block &&
 	    fs->super->s_mmp_block < ext2fs_blocks_count(fs->super))
 		ext2fs_mark_block_bitmap2(ctx->block_found_map,
 					  fs->super->s_mmp_block);
 
+#ifdef HAVE_PTHREAD_H
+	if (pass1_use_threads(ctx))
+		pass1_threads(ctx, scan, &scan_struct, inode);
+	else
+#endif
+		pass1_scan_inodes(ctx, scan, inode, block_buf);
+	if (ctx->flags & E2F_FLAG_SIGNAL_MASK)
+		return;
+	ext2fs_close_inode_scan(scan);
+
+	if (ctx->refcount) {
+		adjust_extattr_refcount(ctx, ctx->refcount, block_buf, -1);
+		ea_refcount_free(ctx->refcount);
+		ctx->refcount = 0;
+	}
+	if (ctx->refcount_extra) {
+		adjust_extattr_refcount(ctx, ctx->refcount_extra,
+					block_buf, +1);
+		ea_refcount_free(ctx->refcount_extra);
+		ctx->refcount_extra = 0;
+	}
+
+	if (ctx->invalid_bitmaps)
+		handle_fs_bad_blocks(ctx);
+
+	
+	if (ctx->block_ea_map) {
+		ext2fs_free_block_bitmap(ctx->block_ea_map);
+		ctx->block_ea_map = 0;
+	}
+
+	if (ctx->flags & E2F_FLAG_RESIZE_INODE) {
+		ext2fs_block_bitmap save_bmap;
+
+		save_bmap = fs->block_map;
+		fs->block_map = ctx->block_found_map;
+		clear_problem_context(&pctx);
+		pctx.errcode = ext2fs_create_resize_inode(fs);
+		if (pctx.errcode) {
+			if (!fix_problem(ctx, PR_1_RESIZE_INODE_CREATE,
+					 &pctx)) {
+				ctx->flags |= E2F_FLAG_ABORT;
+				return;
+			}
+			pctx.errcode = 0;
+		}
+		if (!pctx.errcode) {
+			e2fsck_read_inode(ctx, EXT2_RESIZE_INO, inode,
+					  "recreate inode");
+			inode->i_mtime = ctx->now;
+			e2fsck_write_inode(ctx, EXT2_RESIZE_INO, inode,
+					   "recreate inode");
+		}
+		fs->block_map = save_bmap;
+		ctx->flags &= ~E2F_FLAG_RESIZE_INODE;
+	}
+
+	if (ctx->flags & E2F_FLAG_RESTART) {
+		/*
+		 * Only the master copy of the superblock and block
+		 * group descriptors are going to be written during a
+		 * restart, so set the superblock to be used to be the
+		 * master superblock.
+		 */
+		ctx->use_superblock = 0;
+		unwind_pass1(ctx);
+		goto endit;
+	}
+
+	if (ctx->block_dup_map) {
+		if (ctx->options & E2F_OPT_PREEN) {
+			clear_problem_context(&pctx);
+			fix_problem(ctx, PR_1_DUP_BLOCKS_PREENSTOP, &pctx);
+		}
+		e2fsck_pass1_dupblocks(ctx, block_buf);
+	}
+	ext2fs_free_mem(&ctx->inodes_to_process);
+endit:
+	e2fsck_use_inode_shortcuts(ctx, 0);
+
+	ext2fs_free_mem(&block_buf);
+	ext2fs_free_mem(&inode);
+
+	print_resource_track(ctx, _("Pass 1"), &rtrack, ctx->fs->io);
+}
+
+static void pass1_scan_inodes(e2fsck_t ctx, ext2_inode_scan scan,
+			      struct ext2_inode *inode, char *block_buf)
+{
+	ext2_filsys fs = ctx->fs;
+	ext2_ino_t	ino = 0;
+	unsigned char	frag, fsize;
+	struct		problem_context pctx;
+	struct ext2_super_block *sb = ctx->fs->super;
+	const char	*old_op;
+	int		imagic_fs, extent_fs;
+	int		busted_fs_time = 0;
+	int		inode_size = EXT2_INODE_SIZE(fs->super);
+
+	clear_problem_context(&pctx);
+	imagic_fs = (sb->s_feature_compat & EXT2_FEATURE_COMPAT_IMAGIC_INODES);
+	extent_fs = (sb->s_feature_incompat & EXT3_FEATURE_INCOMPAT_EXTENTS);
+	if ((fs->super->s_wtime < fs->super->s_inodes_count) ||
+	    (fs->super->s_mtime < fs->super->s_inodes_count))
+		busted_fs_time = 1;
+
 	while (1) {
-		if (ino % (fs->super->s_inodes_per_group * 4) == 1) {
+		if (!ctx->global_ctx &&
+		    ino % (fs->super->s_inodes_per_group * 4) == 1) {
 			if (e2fsck_mmp_update(fs))
 				fatal_error(ctx, 0);
 		}
-		old_op = ehandler_operation(_("getting next inode from scan"));
+		old_op = e2fsck_operation(ctx,
+					  _("getting next inode from scan"));
 		pctx.errcode = ext2fs_get_next_inode_full(scan, &ino,
 							  inode, inode_size);
-		ehandler_operation(old_op);
+		e2fsck_operation(ctx, old_op);
 		if (ctx->flags & E2F_FLAG_SIGNAL_MASK)
 			return;
+		if (pctx.errcode == EXT2_ET_CALLBACK_NOTHANDLED)
+			break;
 		if (pctx.errcode == EXT2_ET_BAD_BLOCK_IN_INODE_TABLE) {
 			if (!ctx->inode_bb_map)
 				alloc_bb_map(ctx);
@@ -925,7 +1094,8 @@ void e2fsck_pass1(e2fsck_t ctx)
 
 		if (LINUX_S_ISDIR(inode->i_mode)) {
 			ext2fs_mark_inode_bitmap2(ctx->inode_dir_map, ino);
-			e2fsck_add_dir_info(ctx, ino, 0);
+			if (!ctx->global_ctx)
+				e2fsck_add_dir_info(ctx, ino, 0);
 			ctx->fs_directory_count++;
 			if (inode->i_flags & EXT4_ENCRYPT_FL)
 				add_encrypted_dir(ctx, ino);
@@ -978,16 +1148,19 @@ void e2fsck_pass1(e2fsck_t ctx)
 		     inode->i_block[EXT2_DIND_BLOCK] ||
 		     inode->i_block[EXT2_TIND_BLOCK] ||
 		     ext2fs_file_acl_block(fs, inode))) {
-			inodes_to_process[process_inode_count].ino = ino;
-			inodes_to_process[process_inode_count].inode = *inode;
-			process_inode_count++;
+			struct process_inode_block *ib;
+
+			ib = ctx->inodes_to_process +
+				ctx->process_inode_count++;
+			ib->ino = ino;
+			ib->inode = *inode;
 		} else
 			check_blocks(ctx, &pctx, block_buf);
 
 		if (ctx->flags & E2F_FLAG_SIGNAL_MASK)
 			return;
 
-		if (process_inode_count >= ctx->process_inode_size) {
+		if (ctx->process_inode_count >= ctx->process_inode_size) {
 			process_inodes(ctx, block_buf);
 
 			if (ctx->flags & E2F_FLAG_SIGNAL_MASK)
@@ -995,83 +1168,558 @@ void e2fsck_pass1(e2fsck_t ctx)
 		}
 	}
 	process_inodes(ctx, block_buf);
-	ext2fs_close_inode_scan(scan);
+}
 
-	if (ctx->refcount) {
-		adjust_extattr_refcount(ctx, ctx->refcount, block_buf, -1);
-		ea_refcount_free(ctx->refcount);
-		ctx->refcount = 0;
+#ifdef HAVE_PTHREAD_H
+/*
+ * Multi-threaded pass 1.  The inode table is split into ranges of
+ * block groups (one flex_bg each, when the filesystem has them), and
+ * worker threads scan ranges ahead of the main thread into private
+ * contexts.  The main thread consumes the ranges strictly in order,
+ * merging a worker's results only if it found nothing to fix and the
+ * filesystem has not been changed since the range was scanned;
+ * otherwise the range is simply rechecked by the main thread.  The
+ * result is therefore the same as that of a single-threaded run.
+ */
+struct pass1_thread_info {
+	e2fsck_t		ctx;
+	pthread_mutex_t		lock;
+	pthread_cond_t		cond;
+	struct pass1_range	*ranges;
+	int			num_ranges;
+	int			next_range;
+	int			epoch;
+	int			stop;
+	struct ext2_super_block	*super;
+	void			*group_desc;
+	size_t			desc_size;
+};
+
+struct pass1_worker {
+	struct pass1_thread_info *info;
+	pthread_t		thread;
+	ext2_filsys		fs;
+	int			epoch;
+	struct ext2_inode	*inode;
+	char			*block_buf;
+};
+
+static dgrp_t pass1_range_groups(ext2_filsys fs)
+{
+	if ((fs->super->s_feature_incompat & EXT4_FEATURE_INCOMPAT_FLEX_BG) &&
+	    fs->super->s_log_groups_per_flex < 16)
+		return 1 << fs->super->s_log_groups_per_flex;
+	return 1;
+}
+
+static int pass1_use_threads(e2fsck_t ctx)
+{
+	ext2_filsys	fs = ctx->fs;
+	dgrp_t		groups = pass1_range_groups(fs);
+
+	if (ctx->num_threads <= 1 || ctx->qctx || ctx->invalid_bitmaps ||
+	    (ctx->options & E2F_OPT_FRAGCHECK) || fs->cluster_ratio_bits ||
+	    (fs->flags & EXT2_FLAG_IMAGE_FILE))
+		return 0;
+	if (EXT2_INODES_PER_GROUP(fs->super) * groups <=
+	    EXT2_FIRST_INODE(fs->super))
+		return 0;
+	return groups < fs->group_desc_count;
+}
+
+static void pass1_free_range(struct pass1_range *r)
+{
+	e2fsck_t	rctx = r->ctx;
+
+	if (rctx) {
+		if (rctx->inode_used_map)
+			ext2fs_free_inode_bitmap(rctx->inode_used_map);
+		if (rctx->inode_dir_map)
+			ext2fs_free_inode_bitmap(rctx->inode_dir_map);
+		if (rctx->inode_reg_map)
+			ext2fs_free_inode_bitmap(rctx->inode_reg_map);
+		if (rctx->inode_bad_map)
+			ext2fs_free_inode_bitmap(rctx->inode_bad_map);
+		if (rctx->inode_bb_map)
+			ext2fs_free_inode_bitmap(rctx->inode_bb_map);
+		if (rctx->inode_imagic_map)
+			ext2fs_free_inode_bitmap(rctx->inode_imagic_map);
+		if (rctx->inode_link_info)
+			ext2fs_free_icount(rctx->inode_link_info);
+#ifdef ENABLE_HTREE
+		e2fsck_free_dx_dir_info(rctx);
+#endif
+		if (rctx->dirs_to_hash)
+			ext2fs_u32_list_free(rctx->dirs_to_hash);
+		if (rctx->encrypted_dirs)
+			ext2fs_u32_list_free(rctx->encrypted_dirs);
+		ext2fs_free_mem(&rctx->inodes_to_process);
+		ext2fs_free_mem(&r->ctx);
+	}
+	if (r->dblist) {
+		ext2fs_free_dblist(r->dblist);
+		r->dblist = 0;
+	}
+	ext2fs_free_mem(&r->claims);
+	r->num_claims = r->max_claims = 0;
+}
+
+static errcode_t pass1_prepare_range(e2fsck_t ctx, struct pass1_range *r)
+{
+	ext2_filsys	fs = ctx->fs;
+	e2fsck_t	rctx;
+	errcode_t	retval;
+	ext2_ino_t	ipg = EXT2_INODES_PER_GROUP(fs->super);
+	ext2_ino_t	num_inodes = 0, num_dirs = 0;
+	dgrp_t		g;
+
+	for (g = r->first_group; g < r->end_group; g++) {
+		if (ext2fs_bg_free_inodes_count(fs, g) < ipg)
+			num_inodes += ipg - ext2fs_bg_free_inodes_count(fs, g);
+		if (ext2fs_bg_used_dirs_count(fs, g) < ipg)
+			num_dirs += ext2fs_bg_used_dirs_count(fs, g);
 	}
-	if (ctx->refcount_extra) {
-		adjust_extattr_refcount(ctx, ctx->refcount_extra,
-					block_buf, +1);
-		ea_refcount_free(ctx->refcount_extra);
-		ctx->refcount_extra = 0;
+
+	retval = ext2fs_get_mem(sizeof(struct e2fsck_struct), &rctx);
+	if (retval)
+		return retval;
+	*rctx = *ctx;
+	r->ctx = rctx;
+	rctx->global_ctx = ctx;
+	rctx->priv_data = r;
+	rctx->progress = 0;
+	rctx->flags = 0;
+	rctx->inode_used_map = rctx->inode_bad_map = 0;
+	rctx->inode_dir_map = rctx->inode_bb_map = 0;
+	rctx->inode_imagic_map = rctx->inode_reg_map = 0;
+	rctx->block_found_map = rctx->block_dup_map = 0;
+	rctx->block_ea_map = 0;
+	rctx->inode_count = rctx->inode_link_info = 0;
+	rctx->refcount = rctx->refcount_extra = 0;
+	rctx->block_buf = 0;
+	rctx->inodes_to_process = 0;
+	rctx->process_inode_count = 0;
+	rctx->dir_info = 0;
+	rctx->dx_dir_info = 0;
+	rctx->dx_dir_info_count = rctx->dx_dir_info_size = 0;
+	rctx->dirs_to_hash = 0;
+	rctx->encrypted_dirs = 0;
+	rctx->qctx = 0;
+	memset(&rctx->fs_directory_count, 0,
+	       (char *) (rctx->extent_depth_count + MAX_EXTENT_DEPTH_COUNT) -
+	       (char *) &rctx->fs_directory_count);
+
+	retval = e2fsck_allocate_inode_bitmap(fs, _("in-use inode map"),
+					      EXT2FS_BMAP64_RBTREE,
+					      "inode_used_map",
+					      &rctx->inode_used_map);
+	if (!retval)
+		retval = e2fsck_allocate_inode_bitmap(fs,
+					_("directory inode map"),
+					EXT2FS_BMAP64_RBTREE,
+					"inode_dir_map", &rctx->inode_dir_map);
+	if (!retval)
+		retval = e2fsck_allocate_inode_bitmap(fs,
+					_("regular file inode map"),
+					EXT2FS_BMAP64_RBTREE,
+					"inode_reg_map", &rctx->inode_reg_map);
+	if (!retval)
+		retval = e2fsck_allocate_inode_bitmap(fs, _("bad inode map"),
+					EXT2FS_BMAP64_RBTREE,
+					"inode_bad_map", &rctx->inode_bad_map);
+	if (!retval)
+		retval = e2fsck_allocate_inode_bitmap(fs,
+					_("inode in bad block map"),
+					EXT2FS_BMAP64_RBTREE,
+					"inode_bb_map", &rctx->inode_bb_map);
+	if (!retval)
+		retval = e2fsck_allocate_inode_bitmap(fs,
+					_("imagic inode map"),
+					EXT2FS_BMAP64_RBTREE,
+					"inode_imagic_map",
+					&rctx->inode_imagic_map);
+	if (!retval)
+		retval = ext2fs_create_icount2(fs, 0, num_inodes + 10, 0,
+					       &rctx->inode_link_info);
+	if (!retval && ctx->dirs_to_hash)
+		retval = ext2fs_u32_list_create(&rctx->dirs_to_hash, 50);
+	if (!retval)
+		retval = ext2fs_alloc_dblist(fs, num_dirs * 2, &r->dblist);
+	if (!retval)
+		retval = ext2fs_get_array(ctx->process_inode_size,
+					  sizeof(struct process_inode_block),
+					  &rctx->inodes_to_process);
+	if (retval)
+		pass1_free_range(r);
+	return retval;
+}
+
+static void pass1_run_range(struct pass1_worker *w, struct pass1_range *r)
+{
+	e2fsck_t	rctx = r->ctx;
+	ext2_filsys	fs = w->fs;
+	ext2_inode_scan	scan;
+	struct scan_callback_struct scan_struct;
+	errcode_t	retval;
+
+	rctx->fs = fs;
+	rctx->stashed_inode = w->inode;
+	fs->priv_data = rctx;
+	fs->dblist = r->dblist;
+
+	retval = ext2fs_open_inode_scan(fs, rctx->inode_buffer_blocks, &scan);
+	if (retval) {
+		rctx->flags |= E2F_FLAG_ABORT;
+		goto out;
 	}
+	ext2fs_inode_scan_flags(scan, EXT2_SF_SKIP_MISSING_ITABLE, 0);
+	scan_struct.ctx = rctx;
+	scan_struct.block_buf = w->block_buf;
+	scan_struct.end_group = r->end_group;
+	ext2fs_set_inode_callback(scan, scan_callback, &scan_struct);
+	if (ext2fs_inode_scan_goto_blockgroup(scan, r->first_group))
+		rctx->flags |= E2F_FLAG_ABORT;
+	else
+		pass1_scan_inodes(rctx, scan, w->inode, w->block_buf);
+	ext2fs_close_inode_scan(scan);
+out:
+	fs->dblist = 0;
+}
 
-	if (ctx->invalid_bitmaps)
-		handle_fs_bad_blocks(ctx);
+static void *pass1_worker_thread(void *arg)
+{
+	struct pass1_worker	*w = (struct pass1_worker *) arg;
+	struct pass1_thread_info *info = w->info;
+	struct pass1_range	*r;
+	int			reopen;
+
+	pthread_mutex_lock(&info->lock);
+	while (!info->stop) {
+		while (info->next_range < info->num_ranges &&
+		       info->ranges[info->next_range].state == RANGE_SERIAL)
+			info->next_range++;
+		if (info->next_range >= info->num_ranges ||
+		    info->ranges[info->next_range].state != RANGE_READY) {
+			pthread_cond_wait(&info->cond, &info->lock);
+			continue;
+		}
+		r = &info->ranges[info->next_range++];
+		r->state = RANGE_RUNNING;
+		r->epoch = info->epoch;
+		reopen = (w->epoch != info->epoch);
+		if (reopen) {
+			memcpy(w->fs->super, info->super, SUPERBLOCK_SIZE);
+			memcpy(w->fs->group_desc, info->group_desc,
+			       info->desc_size);
+			w->epoch = info->epoch;
+		}
+		pthread_mutex_unlock(&info->lock);
+
+		if (reopen && e2fsck_open_cloned_io(info->ctx, w->fs)) {
+			r->ctx->flags |= E2F_FLAG_ABORT;
+			w->epoch = -1;
+		} else
+			pass1_run_range(w, r);
 
-	
-	if (ctx->block_ea_map) {
-		ext2fs_free_block_bitmap(ctx->block_ea_map);
-		ctx->block_ea_map = 0;
+		pthread_mutex_lock(&info->lock);
+		r->state = RANGE_DONE;
+		pthread_cond_broadcast(&info->cond);
 	}
+	pthread_mutex_unlock(&info->lock);
+	return 0;
+}
 
-	if (ctx->flags & E2F_FLAG_RESIZE_INODE) {
-		ext2fs_block_bitmap save_bmap;
+static void pass1_merge_range(e2fsck_t ctx, struct pass1_range *r)
+{
+	ext2_filsys	fs = ctx->fs;
+	e2fsck_t	rctx = r->ctx;
+	struct problem_context pctx;
+	ext2_u32_iterate iter;
+	ext2_ino_t	ino, last;
+	blk_t		dir;
+	__u16		count;
+	int		i;
 
-		save_bmap = fs->block_map;
-		fs->block_map = ctx->block_found_map;
-		clear_problem_context(&pctx);
-		pctx.errcode = ext2fs_create_resize_inode(fs);
-		if (pctx.errcode) {
-			if (!fix_problem(ctx, PR_1_RESIZE_INODE_CREATE,
-					 &pctx)) {
+	for (i = 0; i < r->num_claims; i++)
+		mark_blocks_used(ctx, r->claims[i].blk, r->claims[i].len);
+
+	clear_problem_context(&pctx);
+	ino = r->first_group * EXT2_INODES_PER_GROUP(fs->super) + 1;
+	last = r->end_group * EXT2_INODES_PER_GROUP(fs->super);
+	for (; ino <= last; ino++) {
+		if (!ext2fs_icount_fetch(rctx->inode_link_info, ino, &count) &&
+		    count) {
+			pctx.errcode = ext2fs_icount_store(ctx->inode_link_info,
+							   ino, count);
+			if (pctx.errcode) {
+				pctx.ino = ino;
+				pctx.num = count;
+				fix_problem(ctx, PR_1_ICOUNT_STORE, &pctx);
 				ctx->flags |= E2F_FLAG_ABORT;
 				return;
 			}
-			pctx.errcode = 0;
 		}
-		if (!pctx.errcode) {
-			e2fsck_read_inode(ctx, EXT2_RESIZE_INO, inode,
-					  "recreate inode");
-			inode->i_mtime = ctx->now;
-			e2fsck_write_inode(ctx, EXT2_RESIZE_INO, inode,
-					   "recreate inode");
+		if (!ext2fs_fast_test_inode_bitmap2(rctx->inode_used_map, ino))
+			continue;
+		ext2fs_mark_inode_bitmap2(ctx->inode_used_map, ino);
+		if (ext2fs_fast_test_inode_bitmap2(rctx->inode_dir_map, ino)) {
+			ext2fs_mark_inode_bitmap2(ctx->inode_dir_map, ino);
+			e2fsck_add_dir_info(ctx, ino, 0);
 		}
-		fs->block_map = save_bmap;
-		ctx->flags &= ~E2F_FLAG_RESIZE_INODE;
+		if (ext2fs_fast_test_inode_bitmap2(rctx->inode_reg_map, ino))
+			ext2fs_mark_inode_bitmap2(ctx->inode_reg_map, ino);
+		if (ext2fs_fast_test_inode_bitmap2(rctx->inode_bad_map, ino))
+			mark_inode_bad(ctx, ino);
+		if (ext2fs_fast_test_inode_bitmap2(rctx->inode_bb_map, ino)) {
+			if (!ctx->inode_bb_map)
+				alloc_bb_map(ctx);
+			ext2fs_mark_inode_bitmap2(ctx->inode_bb_map, ino);
+		}
+		if (ext2fs_fast_test_inode_bitmap2(rctx->inode_imagic_map,
+						   ino)) {
+			if (!ctx->inode_imagic_map)
+				alloc_imagic_map(ctx);
+			ext2fs_mark_inode_bitmap2(ctx->inode_imagic_map, ino);
+		}
+		if (ctx->flags & E2F_FLAG_SIGNAL_MASK)
+			return;
 	}
 
-	if (ctx->flags & E2F_FLAG_RESTART) {
-		/*
-		 * Only the master copy of the superblock and block
-		 * group descriptors are going to be written during a
-		 * restart, so set the superblock to be used to be the
-		 * master superblock.
-		 */
-		ctx->use_superblock = 0;
-		unwind_pass1(fs);
-		goto endit;
+	pctx.errcode = ext2fs_merge_dblist(r->dblist, fs->dblist);
+	if (pctx.errcode) {
+		fix_problem(ctx, PR_1_ALLOCATE_DBCOUNT, &pctx);
+		ctx->flags |= E2F_FLAG_ABORT;
+		return;
 	}
+#ifdef ENABLE_HTREE
+	for (i = 0; i < rctx->dx_dir_info_count; i++)
+		e2fsck_add_dx_dir(ctx, rctx->dx_dir_info[i].ino,
+				  rctx->dx_dir_info[i].numblocks);
+#endif
+	if (rctx->dirs_to_hash &&
+	    !ext2fs_u32_list_iterate_begin(rctx->dirs_to_hash, &iter)) {
+		while (ext2fs_u32_list_iterate(iter, &dir))
+			ext2fs_u32_list_add(ctx->dirs_to_hash, dir);
+		ext2fs_u32_list_iterate_end(iter);
+	}
+	if (rctx->encrypted_dirs &&
+	    !ext2fs_u32_list_iterate_begin(rctx->encrypted_dirs, &iter)) {
+		while (ext2fs_u32_list_iterate(iter, &dir))
+			add_encrypted_dir(ctx, dir);
+		ext2fs_u32_list_iterate_end(iter);
+	}
+
+	ctx->fs_directory_count += rctx->fs_directory_count;
+	ctx->fs_regular_count += rctx->fs_regular_count;
+	ctx->fs_blockdev_count += rctx->fs_blockdev_count;
+	ctx->fs_chardev_count += rctx->fs_chardev_count;
+	ctx->fs_links_count += rctx->fs_links_count;
+	ctx->fs_symlinks_count += rctx->fs_symlinks_count;
+	ctx->fs_fast_symlinks_count += rctx->fs_fast_symlinks_count;
+	ctx->fs_fifo_count += rctx->fs_fifo_count;
+	ctx->fs_total_count += rctx->fs_total_count;
+	ctx->fs_badblocks_count += rctx->fs_badblocks_count;
+	ctx->fs_sockets_count += rctx->fs_sockets_count;
+	ctx->fs_ind_count += rctx->fs_ind_count;
+	ctx->fs_dind_count += rctx->fs_dind_count;
+	ctx->fs_tind_count += rctx->fs_tind_count;
+	ctx->fs_fragmented += rctx->fs_fragmented;
+	ctx->fs_fragmented_dir += rctx->fs_fragmented_dir;
+	ctx->large_files += rctx->large_files;
+	ctx->fs_ext_attr_inodes += rctx->fs_ext_attr_inodes;
+	ctx->fs_ext_attr_blocks += rctx->fs_ext_attr_blocks;
+	for (i = 0; i < MAX_EXTENT_DEPTH_COUNT; i++)
+		ctx->extent_depth_count[i] += rctx->extent_depth_count[i];
+}
 
-	if (ctx->block_dup_map) {
-		if (ctx->options & E2F_OPT_PREEN) {
-			clear_problem_context(&pctx);
-			fix_problem(ctx, PR_1_DUP_BLOCKS_PREENSTOP, &pctx);
+static void pass1_check_serial_range(e2fsck_t ctx, ext2_inode_scan scan,
+				     struct scan_callback_struct *scan_struct,
+				     struct ext2_inode *inode,
+				     struct pass1_thread_info *info,
+				     struct pass1_range *r)
+{
+	ext2_filsys	fs = ctx->fs;
+	unsigned long long before = 0, after = 0;
+	struct problem_context pctx;
+	int		changed;
+
+	clear_problem_context(&pctx);
+	if (r->first_group) {
+		pctx.errcode = ext2fs_inode_scan_goto_blockgroup(scan,
+							r->first_group);
+		if (pctx.errcode) {
+			fix_problem(ctx, PR_1_ISCAN_ERROR, &pctx);
+			ctx->flags |= E2F_FLAG_ABORT;
+			return;
 		}
-		e2fsck_pass1_dupblocks(ctx, block_buf);
 	}
-	ext2fs_free_mem(&inodes_to_process);
-endit:
-	e2fsck_use_inode_shortcuts(ctx, 0);
+	changed = !e2fsck_io_write_gen(fs, &before);
+	scan_struct->end_group = r->end_group;
+	pass1_scan_inodes(ctx, scan, inode, scan_struct->block_buf);
+	if (ctx->flags & E2F_FLAG_SIGNAL_MASK)
+		return;
 
-	ext2fs_free_mem(&block_buf);
-	ext2fs_free_mem(&inode);
+	if (!e2fsck_io_write_gen(fs, &after) || before != after)
+		changed = 1;
+	if (!changed &&
+	    (memcmp(fs->super, info->super, SUPERBLOCK_SIZE) ||
+	     memcmp(fs->group_desc, info->group_desc, info->desc_size)))
+		changed = 1;
+	if (!changed)
+		return;
 
-	print_resource_track(ctx, _("Pass 1"), &rtrack, ctx->fs->io);
+	pthread_mutex_lock(&info->lock);
+	memcpy(info->super, fs->super, SUPERBLOCK_SIZE);
+	memcpy(info->group_desc, fs->group_desc, info->desc_size);
+	info->epoch++;
+	pthread_mutex_unlock(&info->lock);
+}
+
+static void pass1_threads(e2fsck_t ctx, ext2_inode_scan scan,
+			  struct scan_callback_struct *scan_struct,
+			  struct ext2_inode *inode)
+{
+	ext2_filsys	fs = ctx->fs;
+	struct pass1_thread_info info;
+	struct pass1_worker *workers;
+	struct pass1_range *r;
+	struct problem_context pctx;
+	dgrp_t		per_range = pass1_range_groups(fs), g;
+	int		i, k, use, prepared, window;
+	int		num_threads = ctx->num_threads;
+	int		num_workers = 0;
+
+	memset(&info, 0, sizeof(info));
+	info.ctx = ctx;
+	info.num_ranges = (fs->group_desc_count + per_range - 1) / per_range;
+	info.ranges = (struct pass1_range *)
+		e2fsck_allocate_memory(ctx, info.num_ranges *
+				       sizeof(struct pass1_range),
+				       "pass1 inode ranges");
+	for (k = 0; k < info.num_ranges; k++) {
+		info.ranges[k].first_group = k * per_range;
+		info.ranges[k].end_group = (k + 1) * per_range;
+		if (info.ranges[k].end_group > fs->group_desc_count)
+			info.ranges[k].end_group = fs->group_desc_count;
+	}
+	info.ranges[0].state = RANGE_SERIAL;
+	info.next_range = 1;
+	info.desc_size = (size_t) fs->desc_blocks * fs->blocksize;
+	info.super = e2fsck_allocate_memory(ctx, SUPERBLOCK_SIZE,
+					    "pass1 superblock copy");
+	info.group_desc = e2fsck_allocate_memory(ctx, info.desc_size,
+						 "pass1 group descriptor copy");
+	/*
+	 * The workers read through their own I/O channels, so anything
+	 * the main thread writes must reach the device straight away.
+	 */
+	if (!(ctx->options & E2F_OPT_READONLY) &&
+	    io_channel_set_options(fs->io, "writethrough=on"))
+		num_threads = 0;
+	memcpy(info.super, fs->super, SUPERBLOCK_SIZE);
+	memcpy(info.group_desc, fs->group_desc, info.desc_size);
+	pthread_mutex_init(&info.lock, 0);
+	pthread_cond_init(&info.cond, 0);
+
+	window = 2 * num_threads;
+	prepared = 1;
+	workers = (struct pass1_worker *)
+		e2fsck_allocate_memory(ctx, ctx->num_threads *
+				       sizeof(struct pass1_worker),
+				       "pass1 worker threads");
+	for (i = 0; i < num_threads; i++) {
+		struct pass1_worker *w = &workers[num_workers];
+
+		w->info = &info;
+		if (e2fsck_clone_fs(ctx, &w->fs))
+			break;
+		w->inode = (struct ext2_inode *)
+			e2fsck_allocate_memory(ctx, EXT2_INODE_SIZE(fs->super),
+					       "scratch inode");
+		w->block_buf = (char *)
+			e2fsck_allocate_memory(ctx, fs->blocksize * 3,
+					       "block interate buffer");
+		if (pthread_create(&w->thread, 0, pass1_worker_thread, w)) {
+			ext2fs_free_mem(&w->inode);
+			ext2fs_free_mem(&w->block_buf);
+			e2fsck_free_cloned_fs(ctx, w->fs);
+			break;
+		}
+		num_workers++;
+	}
+
+	for (k = 0; k < info.num_ranges; k++) {
+		r = &info.ranges[k];
+		for (; num_workers && prepared < info.num_ranges &&
+			     prepared <= k + window; prepared++) {
+			struct pass1_range *p = &info.ranges[prepared];
+
+			if (pass1_prepare_range(ctx, p))
+				continue;
+			pthread_mutex_lock(&info.lock);
+			p->state = RANGE_READY;
+			pthread_cond_broadcast(&info.cond);
+			pthread_mutex_unlock(&info.lock);
+		}
+
+		pthread_mutex_lock(&info.lock);
+		if (r->state == RANGE_IDLE || r->state == RANGE_READY) {
+			r->state = RANGE_SERIAL;
+			pthread_cond_broadcast(&info.cond);
+		}
+		while (r->state == RANGE_RUNNING)
+			pthread_cond_wait(&info.cond, &info.lock);
+		use = (r->state == RANGE_DONE && r->epoch == info.epoch &&
+		       !(r->ctx->flags & E2F_FLAG_SIGNAL_MASK));
+		pthread_mutex_unlock(&info.lock);
+
+		if (use) {
+			pass1_merge_range(ctx, r);
+			clear_problem_context(&pctx);
+			for (g = r->first_group; g < r->end_group; g++) {
+				if (ctx->flags & E2F_FLAG_SIGNAL_MASK)
+					break;
+				if (!ctx->progress ||
+				    !(ctx->progress)(ctx, 1, g + 1,
+						     fs->group_desc_count))
+					continue;
+				pctx.errcode = EXT2_ET_CANCEL_REQUESTED;
+				fix_problem(ctx, PR_1_ISCAN_ERROR, &pctx);
+				ctx->flags |= E2F_FLAG_ABORT;
+			}
+		} else
+			pass1_check_serial_range(ctx, scan, scan_struct,
+						 inode, &info, r);
+		pass1_free_range(r);
+		if (ctx->flags & E2F_FLAG_SIGNAL_MASK)
+			break;
+		if (e2fsck_mmp_update(fs))
+			fatal_error(ctx, 0);
+	}
+
+	pthread_mutex_lock(&info.lock);
+	info.stop = 1;
+	pthread_cond_broadcast(&info.cond);
+	pthread_mutex_unlock(&info.lock);
+	for (i = 0; i < num_workers; i++) {
+		pthread_join(workers[i].thread, 0);
+		ext2fs_free_mem(&workers[i].inode);
+		ext2fs_free_mem(&workers[i].block_buf);
+		e2fsck_free_cloned_fs(ctx, workers[i].fs);
+	}
+	if (!(ctx->options & E2F_OPT_READONLY))
+		io_channel_set_options(fs->io, "writethrough=off");
+	for (k = 0; k < info.num_ranges; k++)
+		pass1_free_range(&info.ranges[k]);
+	pthread_cond_destroy(&info.cond);
+	pthread_mutex_destroy(&info.lock);
+	ext2fs_free_mem(&workers);
+	ext2fs_free_mem(&info.ranges);
+	ext2fs_free_mem(&info.super);
+	ext2fs_free_mem(&info.group_desc);
+	scan_struct->end_group = 0;
 }
+#endif
 
 static errcode_t scan_callback(ext2_filsys fs,
 			       ext2_inode_scan scan EXT2FS_ATTR((unused)),
@@ -1085,11 +1733,17 @@ static errcode_t scan_callback(ext2_filsys fs,
 
 	process_inodes((e2fsck_t) fs->priv_data, scan_struct->block_buf);
 
+	(void) ext2fs_readahead(fs, EXT2_READA_ITABLE,
+				group + PASS1_READAHEAD_GROUPS, 1);
+
 	if (ctx->progress)
 		if ((ctx->progress)(ctx, 1, group+1,
 				    ctx->fs->group_desc_count))
 			return EXT2_ET_CANCEL_REQUESTED;
 
+	if (scan_struct->end_group && group + 1 >= scan_struct->end_group)
+		return EXT2_ET_CALLBACK_NOTHANDLED;
+
 	return 0;
 }
 
@@ -1105,35 +1759,36 @@ static void process_inodes(e2fsck_t ctx, char *block_buf)
 #if 0
 	printf("begin process_inodes: ");
 #endif
-	if (process_inode_count == 0)
+	if (ctx->process_inode_count == 0)
 		return;
-	old_operation = ehandler_operation(0);
+	old_operation = e2fsck_operation(ctx, 0);
 	old_stashed_inode = ctx->stashed_inode;
 	old_stashed_ino = ctx->stashed_ino;
-	qsort(inodes_to_process, process_inode_count,
+	qsort(ctx->inodes_to_process, ctx->process_inode_count,
 		      sizeof(struct process_inode_block), process_inode_cmp);
 	clear_problem_context(&pctx);
-	for (i=0; i < process_inode_count; i++) {
-		pctx.inode = ctx->stashed_inode = &inodes_to_process[i].inode;
-		pctx.ino = ctx->stashed_ino = inodes_to_process[i].ino;
+	for (i=0; i < ctx->process_inode_count; i++) {
+		pctx.inode = ctx->stashed_inode =
+			&ctx->inodes_to_process[i].inode;
+		pctx.ino = ctx->stashed_ino = ctx->inodes_to_process[i].ino;
 
 #if 0
 		printf("%u ", pctx.ino);
 #endif
 		sprintf(buf, _("reading indirect blocks of inode %u"),
 			pctx.ino);
-		ehandler_operation(buf);
+		e2fsck_operation(ctx, buf);
 		check_blocks(ctx, &pctx, block_buf);
 		if (ctx->flags & E2F_FLAG_SIGNAL_MASK)
 			break;
 	}
 	ctx->stashed_inode = old_stashed_inode;
 	ctx->stashed_ino = old_stashed_ino;
-	process_inode_count = 0;
+	ctx->process_inode_count = 0;
 #if 0
 	printf("end process inodes\n");
 #endif
-	ehandler_operation(old_operation);
+	e2fsck_operation(ctx, old_operation);
 }
 
 static EXT2_QSORT_TYPE process_inode_cmp(const void *a, const void *b)
@@ -1231,6 +1886,12 @@ static _INLINE_ void mark_block_used(e2fsck_t ctx, blk64_t block)
 {
 	struct		problem_context pctx;
 
+#ifdef HAVE_PTHREAD_H
+	if (ctx->global_ctx) {
+		pass1_claim_blocks(ctx, block, 1);
+		return;
+	}
+#endif
 	clear_problem_context(&pctx);
 
 	if (ext2fs_fast_test_block_bitmap2(ctx->block_found_map, block)) {
@@ -1257,6 +1918,12 @@ static _INLINE_ void mark_block_used(e2fsck_t ctx, blk64_t block)
 static _INLINE_ void mark_blocks_used(e2fsck_t ctx, blk64_t block,
 				      unsigned int num)
 {
+#ifdef HAVE_PTHREAD_H
+	if (ctx->global_ctx) {
+		pass1_claim_blocks(ctx, block, num);
+		return;
+	}
+#endif
 	if (ext2fs_test_block_bitmap_range2(ctx->block_found_map, block, num))
 		ext2fs_mark_block_bitmap_range2(ctx->block_found_map, block, num);
 	else
@@ -1327,6 +1994,11 @@ static int check_ext_attr(e2fsck_t ctx, struct problem_context *pctx,
 		return 0;
 	}
 
+	if (ctx->global_ctx) {
+		ctx->flags |= E2F_FLAG_ABORT;
+		return 0;
+	}
+
 	
 	if (!ctx->block_ea_map) {
 		pctx->errcode = e2fsck_allocate_block_bitmap(fs,
@@ -43,6 +43,9 @@
 
 #define _GNU_SOURCE 1 
 #include <string.h>
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
 
 #include "e2fsck.h"
 #include "problem.h"
@@ -67,13 +70,136 @@ static int htree_depth(struct dx_dir_info *dx_dir,
 		       struct dx_dirblock_info *dx_db);
 static EXT2_QSORT_TYPE special_dir_block_cmp(const void *a, const void *b);
 
+#define PASS2_READAHEAD_BLOCKS	256
+
 struct check_dir_struct {
 	char *buf;
 	struct problem_context	pctx;
 	int	count, max;
 	e2fsck_t ctx;
+	unsigned long long list_offset;
+	struct dx_dirblock_info	dx_block;
+};
+
+#ifdef HAVE_PTHREAD_H
+#define PASS2_RANGE_BLOCKS	512
+
+#define RANGE_IDLE	0
+#define RANGE_READY	1
+#define RANGE_RUNNING	2
+#define RANGE_DONE	3
+#define RANGE_SERIAL	4
+
+#define PASS2_BLOCK_CHECKED	0x0001
+#define PASS2_BLOCK_DOTDOT	0x0002
+#define PASS2_BLOCK_LEAF	0x0004
+
+struct pass2_block {
+	int		flags;
+	ext2_ino_t	dotdot;
+	int		hashversion;
+	ext2_dirhash_t	min_hash;
+	ext2_dirhash_t	max_hash;
+	unsigned int	first_link;
+	unsigned int	num_links;
+};
+
+struct pass2_link {
+	ext2_ino_t	ino;
+	int		subdir;
 };
 
+struct pass2_range {
+	unsigned long long	start;
+	unsigned long long	count;
+	int			state;
+	int			epoch;
+	struct dx_dir_info	*dx_dir_info;
+	int			dx_dir_info_count;
+	struct pass2_block	*blocks;
+	struct pass2_link	*links;
+	unsigned int		num_links;
+	unsigned int		max_links;
+};
+
+struct pass2_maps {
+	ext2fs_inode_bitmap	used;
+	ext2fs_inode_bitmap	dir;
+	ext2fs_inode_bitmap	reg;
+	ext2fs_inode_bitmap	bad;
+	ext2fs_inode_bitmap	bb;
+};
+
+struct pass2_thread_info {
+	e2fsck_t		ctx;
+	pthread_mutex_t		lock;
+	pthread_cond_t		cond;
+	struct pass2_range	*ranges;
+	int			num_ranges;
+	int			next_range;
+	int			epoch;
+	int			stop;
+	struct ext2_super_block	*super;
+	void			*group_desc;
+	size_t			desc_size;
+	struct pass2_maps	maps;
+};
+
+struct pass2_worker {
+	struct pass2_thread_info *info;
+	pthread_t		thread;
+	ext2_filsys		fs;
+	e2fsck_t		ctx;
+	int			epoch;
+	struct pass2_maps	maps;
+	struct check_dir_struct	cd;
+	struct pass2_range	*range;
+	struct pass2_block	*block;
+	unsigned long long	index;
+};
+
+static int pass2_use_threads(e2fsck_t ctx);
+static void pass2_threads(e2fsck_t ctx, struct check_dir_struct *cd);
+
+static void pass2_record_dotdot(e2fsck_t ctx, ext2_ino_t dotdot)
+{
+	struct pass2_worker *w = (struct pass2_worker *) ctx->priv_data;
+
+	w->block->flags |= PASS2_BLOCK_DOTDOT;
+	w->block->dotdot = dotdot;
+}
+
+/*
+ * A worker cannot look at the dir_info or icount structures, so it
+ * records each link for the main thread to apply.  A directory that
+ * is linked twice from the same block is left to the main thread,
+ * which will report it.
+ */
+static int pass2_record_link(e2fsck_t ctx, ext2_ino_t ino, int subdir)
+{
+	struct pass2_worker *w = (struct pass2_worker *) ctx->priv_data;
+	struct pass2_range *r = w->range;
+	struct pass2_link *l;
+	unsigned int	i;
+
+	subdir = subdir && ext2fs_test_inode_bitmap2(ctx->inode_dir_map, ino);
+	for (i = w->block->first_link; subdir && i < r->num_links; i++)
+		if (r->links[i].subdir && r->links[i].ino == ino)
+			return 1;
+	if (r->num_links >= r->max_links) {
+		if (ext2fs_resize_mem(r->max_links * sizeof(struct pass2_link),
+				      (r->max_links + 1024) *
+				      sizeof(struct pass2_link), &r->links))
+			return 1;
+		r->max_links += 1024;
+	}
+	l = &r->links[r->num_links++];
+	l->ino = ino;
+	l->subdir = subdir;
+	return 0;
+}
+#endif
+
 void e2fsck_pass2(e2fsck_t ctx)
 {
 	struct ext2_super_block *sb = ctx->fs->super;
@@ -136,8 +262,17 @@ void e2fsck_pass2(e2fsck_t ctx)
 	if (fs->super->s_feature_compat & EXT2_FEATURE_COMPAT_DIR_INDEX)
 		ext2fs_dblist_sort2(fs->dblist, special_dir_block_cmp);
 
-	cd.pctx.errcode = ext2fs_dblist_iterate2(fs->dblist, check_dir_block,
-						 &cd);
+	cd.list_offset = 0;
+	(void) ext2fs_dblist_readahead(fs->dblist, 0,
+				       2 * PASS2_READAHEAD_BLOCKS);
+
+#ifdef HAVE_PTHREAD_H
+	if (pass2_use_threads(ctx))
+		pass2_threads(ctx, &cd);
+	else
+#endif
+		cd.pctx.errcode = ext2fs_dblist_iterate2(fs->dblist,
+							 check_dir_block, &cd);
 	if (ctx->flags & E2F_FLAG_SIGNAL_MASK || ctx->flags & E2F_FLAG_RESTART)
 		return;
 
@@ -401,6 +536,12 @@ static int check_dotdot(e2fsck_t ctx,
 		}
 		return 0;
 	}
+#ifdef HAVE_PTHREAD_H
+	if (ctx->global_ctx) {
+		pass2_record_dotdot(ctx, dirent->inode);
+		return 0;
+	}
+#endif
 	if (e2fsck_dir_info_set_dotdot(ctx, ino, dirent->inode)) {
 		fix_problem(ctx, PR_2_NO_DIRINFO, pctx);
 		return -1;
@@ -458,8 +599,13 @@ static _INLINE_ int check_filetype(e2fsck_t ctx,
 					    dirent->inode))
 		should_be = 0;
 	else {
-		e2fsck_read_inode(ctx, dirent->inode, &inode,
-				  "check_filetype");
+		if (!ctx->global_ctx)
+			e2fsck_read_inode(ctx, dirent->inode, &inode,
+					  "check_filetype");
+		else if (ext2fs_read_inode(ctx->fs, dirent->inode, &inode)) {
+			ctx->flags |= E2F_FLAG_ABORT;
+			return 0;
+		}
 		should_be = ext2_file_type(inode.i_mode);
 	}
 	if (filetype == should_be)
@@ -658,7 +804,7 @@ static int check_dir_block(ext2_filsys fs,
 	problem_t		problem;
 	struct ext2_dx_root_info *root;
 	struct ext2_dx_countlimit *limit;
-	static dict_t de_dict;
+	dict_t			de_dict;
 	struct problem_context	pctx;
 	int	dups_found = 0;
 	int	encrypted = 0;
@@ -674,6 +820,12 @@ static int check_dir_block(ext2_filsys fs,
 	if (ctx->progress && (ctx->progress)(ctx, 2, cd->count++, cd->max))
 		return DIRENT_ABORT;
 
+	if (!ctx->global_ctx &&
+	    (++cd->list_offset % PASS2_READAHEAD_BLOCKS) == 0)
+		(void) ext2fs_dblist_readahead(fs->dblist, cd->list_offset +
+					       PASS2_READAHEAD_BLOCKS,
+					       PASS2_READAHEAD_BLOCKS);
+
 	if (!(ext2fs_test_inode_bitmap2(ctx->inode_used_map, ino)))
 		return 0;
 
@@ -704,9 +856,9 @@ static int check_dir_block(ext2_filsys fs,
 	       db->blockcnt, ino);
 #endif
 
-	ehandler_operation(_("reading directory block"));
+	e2fsck_operation(ctx, _("reading directory block"));
 	cd->pctx.errcode = ext2fs_read_dir_block3(fs, block_nr, buf, 0);
-	ehandler_operation(0);
+	e2fsck_operation(ctx, 0);
 	if (cd->pctx.errcode == EXT2_ET_DIR_CORRUPTED)
 		cd->pctx.errcode = 0; 
 	if (cd->pctx.errcode) {
@@ -719,6 +871,11 @@ static int check_dir_block(ext2_filsys fs,
 #ifdef ENABLE_HTREE
 	dx_dir = e2fsck_get_dx_dir_info(ctx, ino);
 	if (dx_dir && dx_dir->numblocks) {
+		if (ctx->global_ctx && (db->blockcnt == 0 ||
+					db->blockcnt >= dx_dir->numblocks)) {
+			ctx->flags |= E2F_FLAG_ABORT;
+			return DIRENT_ABORT;
+		}
 		if (db->blockcnt >= dx_dir->numblocks) {
 			if (fix_problem(ctx, PR_2_UNEXPECTED_HTREE_BLOCK,
 					&pctx)) {
@@ -729,7 +886,10 @@ static int check_dir_block(ext2_filsys fs,
 			}
 			fatal_error(ctx, _("Can not continue."));
 		}
-		dx_db = &dx_dir->dx_block[db->blockcnt];
+		if (ctx->global_ctx)
+			dx_db = &cd->dx_block;
+		else
+			dx_db = &dx_dir->dx_block[db->blockcnt];
 		dx_db->type = DX_DIRBLOCK_LEAF;
 		dx_db->phys = block_nr;
 		dx_db->min_hash = ~0;
@@ -852,6 +1012,8 @@ out_htree:
 		if (ctx->inode_bad_map &&
 		    ext2fs_test_inode_bitmap2(ctx->inode_bad_map,
 					     dirent->inode)) {
+			if (ctx->global_ctx)
+				goto abort_free_dict;
 			if (e2fsck_process_bad_inode(ctx, ino,
 						     dirent->inode,
 						     buf + fs->blocksize)) {
@@ -930,7 +1092,7 @@ out_htree:
 		}
 #endif
 
-		if ((dot_state > 1) &&
+		if ((dot_state > 1) && !ctx->global_ctx &&
 		    (ext2fs_test_inode_bitmap2(ctx->inode_dir_map,
 					      dirent->inode))) {
 			if (e2fsck_dir_info_get_parent(ctx, dirent->inode,
@@ -961,6 +1123,8 @@ out_htree:
 			pctx.ino = ino;
 			pctx.dirent = dirent;
 			fix_problem(ctx, PR_2_REPORT_DUP_DIRENT, &pctx);
+			if (ctx->global_ctx)
+				goto abort_free_dict;
 			if (!ctx->dirs_to_hash)
 				ext2fs_u32_list_create(&ctx->dirs_to_hash, 50);
 			if (ctx->dirs_to_hash)
@@ -969,6 +1133,14 @@ out_htree:
 		} else
 			dict_alloc_insert(&de_dict, dirent, dirent);
 
+#ifdef HAVE_PTHREAD_H
+		if (ctx->global_ctx) {
+			if (pass2_record_link(ctx, dirent->inode,
+					      dot_state > 1))
+				goto abort_free_dict;
+			goto next;
+		}
+#endif
 		ext2fs_icount_increment(ctx->inode_count, dirent->inode,
 					&links);
 		if (links > 1)
@@ -993,8 +1165,11 @@ out_htree:
 #endif
 		cd->pctx.dir = cd->pctx.ino;
 		if ((dx_db->type == DX_DIRBLOCK_ROOT) ||
-		    (dx_db->type == DX_DIRBLOCK_NODE))
+		    (dx_db->type == DX_DIRBLOCK_NODE)) {
+			if (ctx->global_ctx)
+				goto abort_free_dict;
 			parse_int_node(fs, db, cd, dx_dir, buf);
+		}
 	}
 #endif 
 	if (offset != fs->blocksize) {
@@ -1021,6 +1196,536 @@ abort_free_dict:
 	return DIRENT_ABORT;
 }
 
+#ifdef HAVE_PTHREAD_H
+/*
+ * Multi-threaded pass 2.  The sorted directory block list is split
+ * into ranges which worker threads check ahead of the main thread,
+ * using private copies of the filesystem handle and inode bitmaps.  A
+ * worker does not touch the dir_info, dx_dir or icount structures;
+ * it records the links it found instead.  The main thread walks the
+ * ranges in order and applies a block's links only if the block was
+ * found clean, its parent and dotdot information is still as the
+ * worker assumed, and nothing has been changed on disk since the
+ * range was checked.  Any other block is simply checked again by the
+ * main thread, so every problem is still reported in order.
+ *
+ * The dx_dir hash versions are only known once the first blocks of
+ * all of the directories have been checked, so ranges after those are
+ * not handed out until the main thread has got that far.
+ */
+struct pass2_merge_struct {
+	struct check_dir_struct	*cd;
+	struct pass2_thread_info *info;
+	struct pass2_range	*range;
+	unsigned long long	index;
+	int			use;
+};
+
+static int pass2_use_threads(e2fsck_t ctx)
+{
+	ext2_filsys	fs = ctx->fs;
+
+	if (ctx->num_threads <= 1 || (fs->flags & EXT2_FLAG_IMAGE_FILE))
+		return 0;
+	return ext2fs_dblist_count2(fs->dblist) > PASS2_RANGE_BLOCKS;
+}
+
+static void pass2_free_maps(struct pass2_maps *m)
+{
+	if (m->used)
+		ext2fs_free_inode_bitmap(m->used);
+	if (m->dir)
+		ext2fs_free_inode_bitmap(m->dir);
+	if (m->reg)
+		ext2fs_free_inode_bitmap(m->reg);
+	if (m->bad)
+		ext2fs_free_inode_bitmap(m->bad);
+	if (m->bb)
+		ext2fs_free_inode_bitmap(m->bb);
+	memset(m, 0, sizeof(struct pass2_maps));
+}
+
+static errcode_t pass2_copy_map(ext2fs_inode_bitmap src,
+				ext2fs_inode_bitmap *dest)
+{
+	if (!src)
+		return 0;
+	return ext2fs_copy_bitmap(src, dest);
+}
+
+static errcode_t pass2_copy_maps(struct pass2_maps *src,
+				 struct pass2_maps *dest)
+{
+	errcode_t	retval;
+
+	pass2_free_maps(dest);
+	retval = pass2_copy_map(src->used, &dest->used);
+	if (!retval)
+		retval = pass2_copy_map(src->dir, &dest->dir);
+	if (!retval)
+		retval = pass2_copy_map(src->reg, &dest->reg);
+	if (!retval)
+		retval = pass2_copy_map(src->bad, &dest->bad);
+	if (!retval)
+		retval = pass2_copy_map(src->bb, &dest->bb);
+	if (retval)
+		pass2_free_maps(dest);
+	return retval;
+}
+
+static errcode_t pass2_publish(e2fsck_t ctx, struct pass2_thread_info *info)
+{
+	struct pass2_maps live;
+
+	live.used = ctx->inode_used_map;
+	live.dir = ctx->inode_dir_map;
+	live.reg = ctx->inode_reg_map;
+	live.bad = ctx->inode_bad_map;
+	live.bb = ctx->inode_bb_map;
+	memcpy(info->super, ctx->fs->super, SUPERBLOCK_SIZE);
+	memcpy(info->group_desc, ctx->fs->group_desc, info->desc_size);
+	return pass2_copy_maps(&live, &info->maps);
+}
+
+#ifdef ENABLE_HTREE
+static struct dx_dir_info *pass2_copy_dx_dir_info(e2fsck_t ctx)
+{
+	struct dx_dir_info *dx_dir_info;
+
+	if (!ctx->dx_dir_info_count ||
+	    ext2fs_get_array(ctx->dx_dir_info_count,
+			     sizeof(struct dx_dir_info), &dx_dir_info))
+		return 0;
+	memcpy(dx_dir_info, ctx->dx_dir_info,
+	       ctx->dx_dir_info_count * sizeof(struct dx_dir_info));
+	return dx_dir_info;
+}
+#endif
+
+static int pass2_count_first_blocks(ext2_filsys fs EXT2FS_ATTR((unused)),
+				    struct ext2_db_entry2 *db,
+				    void *priv_data)
+{
+	unsigned long long *count = (unsigned long long *) priv_data;
+
+	if (db->blockcnt == 0)
+		(*count)++;
+	return 0;
+}
+
+static int pass2_worker_block(ext2_filsys fs EXT2FS_ATTR((unused)),
+			      struct ext2_db_entry2 *db,
+			      void *priv_data)
+{
+	struct pass2_worker	*w = (struct pass2_worker *) priv_data;
+	struct pass2_range	*r = w->range;
+	struct pass2_block	*b = &r->blocks[w->index++];
+	e2fsck_t		rctx = w->ctx;
+#ifdef ENABLE_HTREE
+	struct dx_dir_info	*dx_dir;
+#endif
+
+	memset(b, 0, sizeof(struct pass2_block));
+	b->first_link = r->num_links;
+	if (!ext2fs_test_inode_bitmap2(rctx->inode_used_map, db->ino))
+		return 0;
+	w->block = b;
+	w->cd.dx_block.type = 0;
+	rctx->flags = 0;
+	check_dir_block(w->fs, db, &w->cd);
+	if (rctx->flags & E2F_FLAG_ABORT) {
+		r->num_links = b->first_link;
+		return 0;
+	}
+	b->flags |= PASS2_BLOCK_CHECKED;
+	b->num_links = r->num_links - b->first_link;
+#ifdef ENABLE_HTREE
+	if (w->cd.dx_block.type == DX_DIRBLOCK_LEAF) {
+		dx_dir = e2fsck_get_dx_dir_info(rctx, db->ino);
+		b->flags |= PASS2_BLOCK_LEAF;
+		b->hashversion = dx_dir->hashversion;
+		b->min_hash = w->cd.dx_block.min_hash;
+		b->max_hash = w->cd.dx_block.max_hash;
+	}
+#endif
+	return 0;
+}
+
+static void pass2_run_range(struct pass2_worker *w, struct pass2_range *r)
+{
+	e2fsck_t	rctx = w->ctx;
+
+	rctx->dx_dir_info = r->dx_dir_info;
+	rctx->dx_dir_info_count = r->dx_dir_info_count;
+	w->range = r;
+	w->index = 0;
+	r->num_links = 0;
+	ext2fs_dblist_iterate3(w->info->ctx->fs->dblist, pass2_worker_block,
+			       r->start, r->count, w);
+}
+
+static void *pass2_worker_thread(void *arg)
+{
+	struct pass2_worker	*w = (struct pass2_worker *) arg;
+	struct pass2_thread_info *info = w->info;
+	e2fsck_t		rctx = w->ctx;
+	struct pass2_range	*r;
+	int			reopen, failed;
+
+	pthread_mutex_lock(&info->lock);
+	while (!info->stop) {
+		while (info->next_range < info->num_ranges &&
+		       info->ranges[info->next_range].state == RANGE_SERIAL)
+			info->next_range++;
+		if (info->next_range >= info->num_ranges ||
+		    info->ranges[info->next_range].state != RANGE_READY) {
+			pthread_cond_wait(&info->cond, &info->lock);
+			continue;
+		}
+		r = &info->ranges[info->next_range++];
+		r->state = RANGE_RUNNING;
+		r->epoch = info->epoch;
+		reopen = (w->epoch != info->epoch);
+		failed = 0;
+		if (reopen) {
+			memcpy(w->fs->super, info->super, SUPERBLOCK_SIZE);
+			memcpy(w->fs->group_desc, info->group_desc,
+			       info->desc_size);
+			failed = pass2_copy_maps(&info->maps, &w->maps) != 0;
+			w->epoch = info->epoch;
+		}
+		pthread_mutex_unlock(&info->lock);
+
+		if (reopen && !failed) {
+			rctx->inode_used_map = w->maps.used;
+			rctx->inode_dir_map = w->maps.dir;
+			rctx->inode_reg_map = w->maps.reg;
+			rctx->inode_bad_map = w->maps.bad;
+			rctx->inode_bb_map = w->maps.bb;
+			failed = e2fsck_open_cloned_io(info->ctx, w->fs) != 0;
+		}
+		if (failed)
+			w->epoch = -1;
+		else
+			pass2_run_range(w, r);
+
+		pthread_mutex_lock(&info->lock);
+		r->state = RANGE_DONE;
+		pthread_cond_broadcast(&info->cond);
+	}
+	pthread_mutex_unlock(&info->lock);
+	return 0;
+}
+
+static int pass2_block_valid(e2fsck_t ctx, struct ext2_db_entry2 *db,
+			     struct pass2_range *r, struct pass2_block *b)
+{
+	struct pass2_link *l;
+	ext2_ino_t	parent;
+	unsigned int	i;
+#ifdef ENABLE_HTREE
+	struct dx_dir_info *dx_dir;
+#endif
+
+	if (!(b->flags & PASS2_BLOCK_CHECKED) || db->blk == 0 ||
+	    !ext2fs_test_inode_bitmap2(ctx->inode_used_map, db->ino))
+		return 0;
+#ifdef ENABLE_HTREE
+	dx_dir = e2fsck_get_dx_dir_info(ctx, db->ino);
+	if (b->flags & PASS2_BLOCK_LEAF) {
+		if (!dx_dir || db->blockcnt >= dx_dir->numblocks ||
+		    dx_dir->hashversion != b->hashversion)
+			return 0;
+	} else if (dx_dir && dx_dir->numblocks)
+		return 0;
+#endif
+	if ((b->flags & PASS2_BLOCK_DOTDOT) &&
+	    e2fsck_dir_info_get_dotdot(ctx, db->ino, &parent))
+		return 0;
+	for (i = 0, l = r->links + b->first_link; i < b->num_links; i++, l++)
+		if (l->subdir &&
+		    (e2fsck_dir_info_get_parent(ctx, l->ino, &parent) ||
+		     parent))
+			return 0;
+	return 1;
+}
+
+static void pass2_apply_block(e2fsck_t ctx, struct ext2_db_entry2 *db,
+			      struct pass2_range *r, struct pass2_block *b)
+{
+	struct pass2_link *l;
+	__u16		links;
+	unsigned int	i;
+#ifdef ENABLE_HTREE
+	struct dx_dir_info *dx_dir;
+	struct dx_dirblock_info *dx_db;
+
+	if (b->flags & PASS2_BLOCK_LEAF) {
+		dx_dir = e2fsck_get_dx_dir_info(ctx, db->ino);
+		dx_db = &dx_dir->dx_block[db->blockcnt];
+		dx_db->type = DX_DIRBLOCK_LEAF;
+		dx_db->phys = db->blk;
+		dx_db->min_hash = b->min_hash;
+		dx_db->max_hash = b->max_hash;
+	}
+#endif
+	if (b->flags & PASS2_BLOCK_DOTDOT)
+		(void) e2fsck_dir_info_set_dotdot(ctx, db->ino, b->dotdot);
+	for (i = 0, l = r->links + b->first_link; i < b->num_links; i++, l++) {
+		if (l->subdir)
+			(void) e2fsck_dir_info_set_parent(ctx, l->ino, db->ino);
+		ext2fs_icount_increment(ctx->inode_count, l->ino, &links);
+		if (links > 1)
+			ctx->fs_links_count++;
+		ctx->fs_total_count++;
+	}
+}
+
+static int pass2_merge_block(ext2_filsys fs, struct ext2_db_entry2 *db,
+			     void *priv_data)
+{
+	struct pass2_merge_struct *m = (struct pass2_merge_struct *) priv_data;
+	struct check_dir_struct	*cd = m->cd;
+	struct pass2_thread_info *info = m->info;
+	struct pass2_block	*b = 0;
+	e2fsck_t		ctx = cd->ctx;
+	unsigned long long	before = 0, after = 0;
+	int			changed, ret;
+
+	if (m->use)
+		b = &m->range->blocks[m->index];
+	m->index++;
+	if (b && pass2_block_valid(ctx, db, m->range, b)) {
+		if (ctx->flags & E2F_FLAG_SIGNAL_MASK ||
+		    ctx->flags & E2F_FLAG_RESTART)
+			return DIRENT_ABORT;
+		if (ctx->progress &&
+		    (ctx->progress)(ctx, 2, cd->count++, cd->max))
+			return DIRENT_ABORT;
+		pass2_apply_block(ctx, db, m->range, b);
+		return 0;
+	}
+
+	changed = !e2fsck_io_write_gen(fs, &before);
+	ret = check_dir_block(fs, db, cd);
+	if (ctx->flags & E2F_FLAG_SIGNAL_MASK)
+		return ret;
+	if (!e2fsck_io_write_gen(fs, &after) || before != after)
+		changed = 1;
+	if (!changed &&
+	    (memcmp(fs->super, info->super, SUPERBLOCK_SIZE) ||
+	     memcmp(fs->group_desc, info->group_desc, info->desc_size)))
+		changed = 1;
+	if (!changed)
+		return ret;
+
+	m->use = 0;
+	pthread_mutex_lock(&info->lock);
+	if (pass2_publish(ctx, info)) {
+		info->stop = 1;
+		pthread_cond_broadcast(&info->cond);
+	}
+	info->epoch++;
+	pthread_mutex_unlock(&info->lock);
+	return ret;
+}
+
+static void pass2_free_range(struct pass2_range *r)
+{
+	ext2fs_free_mem(&r->blocks);
+	ext2fs_free_mem(&r->links);
+	r->num_links = r->max_links = 0;
+}
+
+static void pass2_threads(e2fsck_t ctx, struct check_dir_struct *cd)
+{
+	ext2_filsys	fs = ctx->fs;
+	struct pass2_thread_info info;
+	struct pass2_worker *workers;
+	struct pass2_merge_struct m;
+	struct pass2_range *r;
+	struct dx_dir_info *dx_dir_info[2];
+	unsigned long long count, first = 0, start;
+	int		dx_dir_info_count[2];
+	int		i, k, use, prepared, window, barrier, snap;
+	int		num_threads = ctx->num_threads;
+	int		num_workers = 0;
+
+	ext2fs_dblist_iterate2(fs->dblist, pass2_count_first_blocks, &first);
+	if (!(fs->super->s_feature_compat & EXT2_FEATURE_COMPAT_DIR_INDEX))
+		first = 0;
+	count = ext2fs_dblist_count2(fs->dblist);
+
+	memset(&info, 0, sizeof(info));
+	info.ctx = ctx;
+	barrier = (first + PASS2_RANGE_BLOCKS - 1) / PASS2_RANGE_BLOCKS;
+	info.num_ranges = barrier + (count - first + PASS2_RANGE_BLOCKS - 1) /
+		PASS2_RANGE_BLOCKS;
+	info.ranges = (struct pass2_range *)
+		e2fsck_allocate_memory(ctx, info.num_ranges *
+				       sizeof(struct pass2_range),
+				       "pass2 directory block ranges");
+	for (k = 0, start = 0; k < info.num_ranges; k++) {
+		r = &info.ranges[k];
+		r->start = start;
+		r->count = (k < barrier ? first : count) - start;
+		if (r->count > PASS2_RANGE_BLOCKS)
+			r->count = PASS2_RANGE_BLOCKS;
+		start += r->count;
+	}
+	info.ranges[0].state = RANGE_SERIAL;
+	info.next_range = 1;
+	info.desc_size = (size_t) fs->desc_blocks * fs->blocksize;
+	info.super = e2fsck_allocate_memory(ctx, SUPERBLOCK_SIZE,
+					    "pass2 superblock copy");
+	info.group_desc = e2fsck_allocate_memory(ctx, info.desc_size,
+						 "pass2 group descriptor copy");
+	/*
+	 * The workers read through their own I/O channels, so anything
+	 * the main thread writes must reach the device straight away.
+	 */
+	if (!(ctx->options & E2F_OPT_READONLY) &&
+	    io_channel_set_options(fs->io, "writethrough=on"))
+		num_threads = 0;
+	pthread_mutex_init(&info.lock, 0);
+	pthread_cond_init(&info.cond, 0);
+	memset(dx_dir_info, 0, sizeof(dx_dir_info));
+	memset(dx_dir_info_count, 0, sizeof(dx_dir_info_count));
+#ifdef ENABLE_HTREE
+	dx_dir_info[0] = pass2_copy_dx_dir_info(ctx);
+	if (dx_dir_info[0])
+		dx_dir_info_count[0] = ctx->dx_dir_info_count;
+#endif
+
+	window = 2 * num_threads;
+	prepared = 1;
+	workers = (struct pass2_worker *)
+		e2fsck_allocate_memory(ctx, ctx->num_threads *
+				       sizeof(struct pass2_worker),
+				       "pass2 worker threads");
+	if (pass2_publish(ctx, &info))
+		num_threads = 0;
+	for (i = 0; i < num_threads; i++) {
+		struct pass2_worker *w = &workers[num_workers];
+		e2fsck_t	rctx;
+
+		w->info = &info;
+		w->epoch = -1;
+		if (e2fsck_clone_fs(ctx, &w->fs))
+			break;
+		rctx = (e2fsck_t) e2fsck_allocate_memory(ctx,
+					sizeof(struct e2fsck_struct),
+					"pass2 thread context");
+		*rctx = *ctx;
+		rctx->global_ctx = ctx;
+		rctx->priv_data = w;
+		rctx->fs = w->fs;
+		rctx->progress = 0;
+		rctx->flags = 0;
+		rctx->inode_used_map = rctx->inode_dir_map = 0;
+		rctx->inode_reg_map = rctx->inode_bad_map = 0;
+		rctx->inode_bb_map = 0;
+		rctx->inode_count = rctx->inode_link_info = 0;
+		rctx->dir_info = 0;
+		rctx->dx_dir_info = 0;
+		rctx->dx_dir_info_count = rctx->dx_dir_info_size = 0;
+		rctx->dirs_to_hash = 0;
+		w->fs->priv_data = rctx;
+		w->ctx = rctx;
+		memset(&w->cd, 0, sizeof(struct check_dir_struct));
+		w->cd.ctx = rctx;
+		w->cd.buf = (char *)
+			e2fsck_allocate_memory(ctx, 2 * fs->blocksize,
+					       "directory scan buffer");
+		if (pthread_create(&w->thread, 0, pass2_worker_thread, w)) {
+			ext2fs_free_mem(&w->cd.buf);
+			ext2fs_free_mem(&w->ctx);
+			e2fsck_free_cloned_fs(ctx, w->fs);
+			break;
+		}
+		num_workers++;
+	}
+
+	memset(&m, 0, sizeof(m));
+	m.cd = cd;
+	m.info = &info;
+	for (k = 0; k < info.num_ranges; k++) {
+		r = &info.ranges[k];
+#ifdef ENABLE_HTREE
+		if (k && k == barrier) {
+			dx_dir_info[1] = pass2_copy_dx_dir_info(ctx);
+			if (dx_dir_info[1])
+				dx_dir_info_count[1] = ctx->dx_dir_info_count;
+		}
+#endif
+		for (; num_workers && prepared < info.num_ranges &&
+			     prepared <= k + window &&
+			     (prepared < barrier || k >= barrier); prepared++) {
+			struct pass2_range *p = &info.ranges[prepared];
+
+			if (ext2fs_get_arrayzero(p->count,
+						 sizeof(struct pass2_block),
+						 &p->blocks))
+				continue;
+			snap = (barrier && prepared >= barrier);
+			p->dx_dir_info = dx_dir_info[snap];
+			p->dx_dir_info_count = dx_dir_info_count[snap];
+			pthread_mutex_lock(&info.lock);
+			p->state = RANGE_READY;
+			pthread_cond_broadcast(&info.cond);
+			pthread_mutex_unlock(&info.lock);
+		}
+
+		pthread_mutex_lock(&info.lock);
+		if (r->state == RANGE_IDLE || r->state == RANGE_READY) {
+			r->state = RANGE_SERIAL;
+			pthread_cond_broadcast(&info.cond);
+		}
+		while (r->state == RANGE_RUNNING)
+			pthread_cond_wait(&info.cond, &info.lock);
+		use = (r->state == RANGE_DONE && r->epoch == info.epoch);
+		pthread_mutex_unlock(&info.lock);
+
+		m.range = r;
+		m.index = 0;
+		m.use = use;
+		cd->pctx.errcode = ext2fs_dblist_iterate3(fs->dblist,
+							  pass2_merge_block,
+							  r->start, r->count,
+							  &m);
+		pass2_free_range(r);
+		if (ctx->flags & E2F_FLAG_SIGNAL_MASK ||
+		    ctx->flags & E2F_FLAG_RESTART || cd->pctx.errcode)
+			break;
+	}
+
+	pthread_mutex_lock(&info.lock);
+	info.stop = 1;
+	pthread_cond_broadcast(&info.cond);
+	pthread_mutex_unlock(&info.lock);
+	for (i = 0; i < num_workers; i++) {
+		pthread_join(workers[i].thread, 0);
+		pass2_free_maps(&workers[i].maps);
+		ext2fs_free_mem(&workers[i].cd.buf);
+		ext2fs_free_mem(&workers[i].ctx);
+		e2fsck_free_cloned_fs(ctx, workers[i].fs);
+	}
+	if (!(ctx->options & E2F_OPT_READONLY))
+		io_channel_set_options(fs->io, "writethrough=off");
+	for (k = 0; k < info.num_ranges; k++)
+		pass2_free_range(&info.ranges[k]);
+	pass2_free_maps(&info.maps);
+	pthread_cond_destroy(&info.cond);
+	pthread_mutex_destroy(&info.lock);
+	ext2fs_free_mem(&dx_dir_info[0]);
+	ext2fs_free_mem(&dx_dir_info[1]);
+	ext2fs_free_mem(&workers);
+	ext2fs_free_mem(&info.ranges);
+	ext2fs_free_mem(&info.super);
+	ext2fs_free_mem(&info.group_desc);
+}
+#endif
+
 struct del_block {
 	e2fsck_t	ctx;
 	e2_blkcnt_t	num;
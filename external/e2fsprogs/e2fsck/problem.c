@@ -1750,6 +1750,9 @@ int end_problem_latch(e2fsck_t ctx, int mask)
 	struct problem_context pctx;
 	int answer = -1;
 
+	if (ctx->global_ctx)
+		return answer;
+
 	ldesc = find_latch(mask);
 	if (ldesc->end_message && (ldesc->flags & PRL_LATCHED)) {
 		clear_problem_context(&pctx);
@@ -1813,6 +1816,11 @@ int fix_problem(e2fsck_t ctx, problem_t code, struct problem_context *pctx)
 	int		print_answer = 0;
 	int		suppress = 0;
 
+	if (ctx->global_ctx) {
+		ctx->flags |= E2F_FLAG_ABORT;
+		return 0;
+	}
+
 	ptr = find_problem(code);
 	if (!ptr) {
 		printf(_("Unhandled error code (0x%x)!\n"), code);
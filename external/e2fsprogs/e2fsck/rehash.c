@@ -48,6 +48,9 @@
 #include <string.h>
 #include <ctype.h>
 #include <errno.h>
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
 #include "e2fsck.h"
 #include "problem.h"
 
@@ -380,6 +383,17 @@ static int duplicate_search_and_fix(e2fsck_t ctx, ext2_filsys fs,
 	return fixed;
 }
 
+static void init_htree_slack(e2fsck_t ctx)
+{
+	if (ctx->htree_slack_percentage == 255) {
+		profile_get_uint(ctx->profile, "options",
+				 "indexed_dir_slack_percentage",
+				 0, 20,
+				 &ctx->htree_slack_percentage);
+		if (ctx->htree_slack_percentage > 100)
+			ctx->htree_slack_percentage = 20;
+	}
+}
 
 static errcode_t copy_dir_entries(e2fsck_t ctx,
 				  struct fill_dir_struct *fd,
@@ -394,14 +408,7 @@ static errcode_t copy_dir_entries(e2fsck_t ctx,
 	int			i;
 	ext2_dirhash_t		prev_hash;
 
-	if (ctx->htree_slack_percentage == 255) {
-		profile_get_uint(ctx->profile, "options",
-				 "indexed_dir_slack_percentage",
-				 0, 20,
-				 &ctx->htree_slack_percentage);
-		if (ctx->htree_slack_percentage > 100)
-			ctx->htree_slack_percentage = 20;
-	}
+	init_htree_slack(ctx);
 
 	outdir->max = 0;
 	retval = alloc_size_dir(fs, outdir,
@@ -686,111 +693,362 @@ static errcode_t write_directory(e2fsck_t ctx, ext2_filsys fs,
 	return 0;
 }
 
-errcode_t e2fsck_rehash_dir(e2fsck_t ctx, ext2_ino_t ino)
+static errcode_t rehash_read_dir(e2fsck_t ctx, ext2_ino_t ino,
+				 struct ext2_inode *inode,
+				 struct fill_dir_struct *fd)
 {
 	ext2_filsys 		fs = ctx->fs;
-	errcode_t		retval;
-	struct ext2_inode 	inode;
-	char			*dir_buf = 0;
-	struct fill_dir_struct	fd;
-	struct out_dir		outdir;
-
-	outdir.max = outdir.num = 0;
-	outdir.buf = 0;
-	outdir.hashes = 0;
-	e2fsck_read_inode(ctx, ino, &inode, "rehash_dir");
 
-	retval = ENOMEM;
-	fd.harray = 0;
-	dir_buf = malloc(inode.i_size);
-	if (!dir_buf)
-		goto errout;
-
-	fd.max_array = inode.i_size / 32;
-	fd.num_array = 0;
-	fd.harray = malloc(fd.max_array * sizeof(struct hash_entry));
-	if (!fd.harray)
-		goto errout;
-
-	fd.ctx = ctx;
-	fd.buf = dir_buf;
-	fd.inode = &inode;
-	fd.err = 0;
-	fd.dir_size = 0;
-	fd.compress = 0;
+	fd->harray = 0;
+	fd->buf = malloc(inode->i_size);
+	if (!fd->buf)
+		return ENOMEM;
+
+	fd->max_array = inode->i_size / 32;
+	fd->num_array = 0;
+	fd->harray = malloc(fd->max_array * sizeof(struct hash_entry));
+	if (!fd->harray)
+		return ENOMEM;
+
+	fd->ctx = ctx;
+	fd->inode = inode;
+	fd->err = 0;
+	fd->dir_size = 0;
+	fd->compress = 0;
 	if (!(fs->super->s_feature_compat & EXT2_FEATURE_COMPAT_DIR_INDEX) ||
-	    (inode.i_size / fs->blocksize) < 2)
-		fd.compress = 1;
-	fd.parent = 0;
+	    (inode->i_size / fs->blocksize) < 2)
+		fd->compress = 1;
+	fd->parent = 0;
 
 retry_nohash:
-	
-	retval = ext2fs_block_iterate3(fs, ino, 0, 0,
-				       fill_dir_block, &fd);
-	if (fd.err) {
-		retval = fd.err;
-		goto errout;
-	}
-
-	if (!fd.compress && (fd.dir_size < (fs->blocksize - 24))) {
-		fd.compress = 1;
-		fd.dir_size = 0;
-		fd.num_array = 0;
+	ext2fs_block_iterate3(fs, ino, 0, 0, fill_dir_block, fd);
+	if (fd->err)
+		return fd->err;
+
+	if (!fd->compress && (fd->dir_size < (fs->blocksize - 24))) {
+		fd->compress = 1;
+		fd->dir_size = 0;
+		fd->num_array = 0;
 		goto retry_nohash;
 	}
 
 #if 0
 	printf("%d entries (%d bytes) found in inode %d\n",
-	       fd.num_array, fd.dir_size, ino);
+	       fd->num_array, fd->dir_size, ino);
 #endif
+	return 0;
+}
 
-	
-resort:
-	if (fd.compress)
-		qsort(fd.harray+2, fd.num_array-2, sizeof(struct hash_entry),
-		      hash_cmp);
-	else
-		qsort(fd.harray, fd.num_array, sizeof(struct hash_entry),
-		      hash_cmp);
+static void rehash_sort_dir(e2fsck_t ctx, ext2_ino_t ino,
+			    struct fill_dir_struct *fd)
+{
+	do {
+		if (fd->compress)
+			qsort(fd->harray+2, fd->num_array-2,
+			      sizeof(struct hash_entry), hash_cmp);
+		else
+			qsort(fd->harray, fd->num_array,
+			      sizeof(struct hash_entry), hash_cmp);
 
-	if (duplicate_search_and_fix(ctx, fs, ino, &fd))
-		goto resort;
+	} while (duplicate_search_and_fix(ctx, ctx->fs, ino, fd));
+}
 
-	if (ctx->options & E2F_OPT_NO) {
-		retval = 0;
-		goto errout;
-	}
+static errcode_t rehash_build_dir(e2fsck_t ctx, ext2_ino_t ino,
+				  struct fill_dir_struct *fd,
+				  struct out_dir *outdir)
+{
+	errcode_t	retval;
 
-	
-	if (fd.compress)
-		qsort(fd.harray+2, fd.num_array-2,
+	if (fd->compress)
+		qsort(fd->harray+2, fd->num_array-2,
 		      sizeof(struct hash_entry), ino_cmp);
 
-	retval = copy_dir_entries(ctx, &fd, &outdir);
+	retval = copy_dir_entries(ctx, fd, outdir);
 	if (retval)
-		goto errout;
+		return retval;
 
-	free(dir_buf); dir_buf = 0;
+	free(fd->buf); fd->buf = 0;
 
-	if (!fd.compress) {
-		
-		retval = calculate_tree(fs, &outdir, ino, fd.parent);
+	if (!fd->compress) {
+		retval = calculate_tree(ctx->fs, outdir, ino, fd->parent);
 		if (retval)
-			goto errout;
+			return retval;
 	}
+	return 0;
+}
+
+errcode_t e2fsck_rehash_dir(e2fsck_t ctx, ext2_ino_t ino)
+{
+	ext2_filsys 		fs = ctx->fs;
+	errcode_t		retval;
+	struct ext2_inode 	inode;
+	struct fill_dir_struct	fd;
+	struct out_dir		outdir;
+
+	outdir.max = outdir.num = 0;
+	outdir.buf = 0;
+	outdir.hashes = 0;
+	e2fsck_read_inode(ctx, ino, &inode, "rehash_dir");
+
+	retval = rehash_read_dir(ctx, ino, &inode, &fd);
+	if (retval)
+		goto errout;
+
+	rehash_sort_dir(ctx, ino, &fd);
+
+	if (ctx->options & E2F_OPT_NO) {
+		retval = 0;
+		goto errout;
+	}
+
+	retval = rehash_build_dir(ctx, ino, &fd, &outdir);
+	if (retval)
+		goto errout;
 
 	retval = write_directory(ctx, fs, &outdir, ino, fd.compress);
 	if (retval)
 		goto errout;
 
 errout:
-	free(dir_buf);
+	free(fd.buf);
 	free(fd.harray);
 
 	free_out_dir(&outdir);
 	return retval;
 }
 
+#ifdef HAVE_PTHREAD_H
+/*
+ * With more than one thread, worker threads read, sort and rebuild the
+ * directories in memory ahead of the main thread, each using a private
+ * copy of the filesystem handle.  Rebuilding one directory never
+ * changes the contents of another, so the main thread only has to
+ * write the new directories out in order.  A directory whose worker
+ * hit a read error or a duplicate entry is rehashed again by the main
+ * thread, which reports the problem as before.
+ */
+#define REHASH_IDLE	0
+#define REHASH_RUNNING	1
+#define REHASH_DONE	2
+#define REHASH_SERIAL	3
+
+struct rehash_job {
+	ext2_ino_t		ino;
+	int			state;
+	int			ok;
+	struct fill_dir_struct	fd;
+	struct out_dir		outdir;
+};
+
+struct rehash_worker {
+	struct rehash_thread_info *info;
+	pthread_t		thread;
+	ext2_filsys		fs;
+	e2fsck_t		ctx;
+	struct ext2_inode	inode;
+};
+
+struct rehash_thread_info {
+	e2fsck_t		ctx;
+	pthread_mutex_t		lock;
+	pthread_cond_t		cond;
+	struct rehash_job	*jobs;
+	int			num_jobs;
+	int			next_job;
+	int			limit;
+	int			window;
+	int			stop;
+	struct rehash_worker	*workers;
+	int			num_workers;
+};
+
+static void rehash_free_job(struct rehash_job *j)
+{
+	free(j->fd.buf);
+	free(j->fd.harray);
+	j->fd.buf = 0;
+	j->fd.harray = 0;
+	free_out_dir(&j->outdir);
+	j->outdir.buf = 0;
+	j->outdir.hashes = 0;
+}
+
+static void rehash_run_job(struct rehash_worker *w, struct rehash_job *j)
+{
+	e2fsck_t	rctx = w->ctx;
+
+	rctx->flags = 0;
+	if (ext2fs_read_inode(w->fs, j->ino, &w->inode) ||
+	    rehash_read_dir(rctx, j->ino, &w->inode, &j->fd))
+		return;
+	rehash_sort_dir(rctx, j->ino, &j->fd);
+	if (rctx->flags & E2F_FLAG_ABORT)
+		return;
+	if (!(rctx->options & E2F_OPT_NO) &&
+	    rehash_build_dir(rctx, j->ino, &j->fd, &j->outdir))
+		return;
+	j->ok = !(rctx->flags & E2F_FLAG_ABORT);
+}
+
+static void *rehash_worker_thread(void *arg)
+{
+	struct rehash_worker	*w = (struct rehash_worker *) arg;
+	struct rehash_thread_info *info = w->info;
+	struct rehash_job	*j;
+
+	pthread_mutex_lock(&info->lock);
+	while (!info->stop) {
+		while (info->next_job < info->num_jobs &&
+		       info->jobs[info->next_job].state == REHASH_SERIAL)
+			info->next_job++;
+		if (info->next_job >= info->num_jobs)
+			break;
+		if (info->next_job >= info->limit) {
+			pthread_cond_wait(&info->cond, &info->lock);
+			continue;
+		}
+		j = &info->jobs[info->next_job++];
+		j->state = REHASH_RUNNING;
+		pthread_mutex_unlock(&info->lock);
+
+		rehash_run_job(w, j);
+
+		pthread_mutex_lock(&info->lock);
+		j->state = REHASH_DONE;
+		pthread_cond_broadcast(&info->cond);
+	}
+	pthread_mutex_unlock(&info->lock);
+	return 0;
+}
+
+static void rehash_start_threads(e2fsck_t ctx, struct rehash_thread_info *info,
+				 int all_dirs, int max)
+{
+	ext2_filsys		fs = ctx->fs;
+	struct dir_info		*dir;
+	struct dir_info_iter	*dirinfo_iter;
+	ext2_u32_iterate	iter;
+	ext2_ino_t		ino;
+	int			i, num_threads = ctx->num_threads;
+
+	memset(info, 0, sizeof(struct rehash_thread_info));
+	if (ctx->num_threads <= 1 || (fs->flags & EXT2_FLAG_IMAGE_FILE) ||
+	    max < 2)
+		return;
+	if (!all_dirs &&
+	    ext2fs_u32_list_iterate_begin(ctx->dirs_to_hash, &iter))
+		return;
+
+	info->ctx = ctx;
+	info->jobs = (struct rehash_job *)
+		e2fsck_allocate_memory(ctx, max * sizeof(struct rehash_job),
+				       "directories to rehash");
+	if (all_dirs) {
+		dirinfo_iter = e2fsck_dir_info_iter_begin(ctx);
+		while (info->num_jobs < max &&
+		       (dir = e2fsck_dir_info_iter(ctx, dirinfo_iter)))
+			if (dir->ino != ctx->lost_and_found)
+				info->jobs[info->num_jobs++].ino = dir->ino;
+		e2fsck_dir_info_iter_end(ctx, dirinfo_iter);
+	} else {
+		while (info->num_jobs < max &&
+		       ext2fs_u32_list_iterate(iter, &ino))
+			if (ino != ctx->lost_and_found)
+				info->jobs[info->num_jobs++].ino = ino;
+		ext2fs_u32_list_iterate_end(iter);
+	}
+
+	init_htree_slack(ctx);
+	if (!(ctx->options & E2F_OPT_READONLY) &&
+	    io_channel_set_options(fs->io, "writethrough=on"))
+		num_threads = 0;
+	info->window = 2 * ctx->num_threads;
+	info->limit = info->window;
+	pthread_mutex_init(&info->lock, 0);
+	pthread_cond_init(&info->cond, 0);
+	info->workers = (struct rehash_worker *)
+		e2fsck_allocate_memory(ctx, ctx->num_threads *
+				       sizeof(struct rehash_worker),
+				       "rehash worker threads");
+	for (i = 0; i < num_threads; i++) {
+		struct rehash_worker *w = &info->workers[info->num_workers];
+		e2fsck_t	rctx;
+
+		w->info = info;
+		if (e2fsck_clone_fs(ctx, &w->fs))
+			break;
+		rctx = (e2fsck_t) e2fsck_allocate_memory(ctx,
+					sizeof(struct e2fsck_struct),
+					"rehash thread context");
+		*rctx = *ctx;
+		rctx->global_ctx = ctx;
+		rctx->priv_data = w;
+		rctx->fs = w->fs;
+		rctx->progress = 0;
+		rctx->flags = 0;
+		w->fs->priv_data = rctx;
+		w->ctx = rctx;
+		if (pthread_create(&w->thread, 0, rehash_worker_thread, w)) {
+			ext2fs_free_mem(&w->ctx);
+			e2fsck_free_cloned_fs(ctx, w->fs);
+			break;
+		}
+		info->num_workers++;
+	}
+}
+
+static errcode_t rehash_finish_job(e2fsck_t ctx,
+				   struct rehash_thread_info *info, int k)
+{
+	struct rehash_job	*j = &info->jobs[k];
+	errcode_t		retval = 0;
+	int			ok;
+
+	pthread_mutex_lock(&info->lock);
+	if (j->state == REHASH_IDLE)
+		j->state = REHASH_SERIAL;
+	while (j->state == REHASH_RUNNING)
+		pthread_cond_wait(&info->cond, &info->lock);
+	ok = (j->state == REHASH_DONE && j->ok);
+	info->limit = k + 1 + info->window;
+	pthread_cond_broadcast(&info->cond);
+	pthread_mutex_unlock(&info->lock);
+
+	if (!ok)
+		retval = e2fsck_rehash_dir(ctx, j->ino);
+	else if (!(ctx->options & E2F_OPT_NO))
+		retval = write_directory(ctx, ctx->fs, &j->outdir, j->ino,
+					 j->fd.compress);
+	rehash_free_job(j);
+	return retval;
+}
+
+static void rehash_stop_threads(e2fsck_t ctx, struct rehash_thread_info *info)
+{
+	int	i;
+
+	if (!info->jobs)
+		return;
+	pthread_mutex_lock(&info->lock);
+	info->stop = 1;
+	pthread_cond_broadcast(&info->cond);
+	pthread_mutex_unlock(&info->lock);
+	for (i = 0; i < info->num_workers; i++) {
+		pthread_join(info->workers[i].thread, 0);
+		ext2fs_free_mem(&info->workers[i].ctx);
+		e2fsck_free_cloned_fs(ctx, info->workers[i].fs);
+	}
+	if (!(ctx->options & E2F_OPT_READONLY))
+		io_channel_set_options(ctx->fs->io, "writethrough=off");
+	for (i = 0; i < info->num_jobs; i++)
+		rehash_free_job(&info->jobs[i]);
+	ext2fs_free_mem(&info->workers);
+	ext2fs_free_mem(&info->jobs);
+	pthread_cond_destroy(&info->cond);
+	pthread_mutex_destroy(&info->lock);
+}
+#endif
+
 void e2fsck_rehash_directories(e2fsck_t ctx)
 {
 	struct problem_context	pctx;
@@ -803,6 +1061,10 @@ void e2fsck_rehash_directories(e2fsck_t ctx)
 	ext2_ino_t		ino;
 	errcode_t		retval;
 	int			cur, max, all_dirs, first = 1;
+#ifdef HAVE_PTHREAD_H
+	struct rehash_thread_info info;
+	int			job = 0;
+#endif
 
 	init_resource_track(&rtrack, ctx->fs->io);
 	all_dirs = ctx->options & E2F_OPT_COMPRESS_DIRS;
@@ -828,6 +1090,9 @@ void e2fsck_rehash_directories(e2fsck_t ctx)
 		}
 		max = ext2fs_u32_list_count(ctx->dirs_to_hash);
 	}
+#ifdef HAVE_PTHREAD_H
+	rehash_start_threads(ctx, &info, all_dirs, max);
+#endif
 	while (1) {
 		if (all_dirs) {
 			if ((dir = e2fsck_dir_info_iter(ctx,
@@ -847,6 +1112,11 @@ void e2fsck_rehash_directories(e2fsck_t ctx)
 		}
 #if 0
 		fix_problem(ctx, PR_3A_OPTIMIZE_DIR, &pctx);
+#endif
+#ifdef HAVE_PTHREAD_H
+		if (info.num_workers && job < info.num_jobs)
+			pctx.errcode = rehash_finish_job(ctx, &info, job++);
+		else
 #endif
 		pctx.errcode = e2fsck_rehash_dir(ctx, ino);
 		if (pctx.errcode) {
@@ -857,6 +1127,9 @@ void e2fsck_rehash_directories(e2fsck_t ctx)
 			e2fsck_simple_progress(ctx, "Rebuilding directory",
 			       100.0 * (float) (++cur) / (float) max, ino);
 	}
+#ifdef HAVE_PTHREAD_H
+	rehash_stop_threads(ctx, &info);
+#endif
 	end_problem_latch(ctx, PR_LATCH_OPTIMIZE_DIR);
 	if (all_dirs)
 		e2fsck_dir_info_iter_end(ctx, dirinfo_iter);
@@ -604,6 +604,7 @@ static void parse_extended_opts(e2fsck_t ctx, const char *opts)
 {
 	char	*buf, *token, *next, *p, *arg;
 	int	ea_ver;
+	int	threads;
 	int	extended_usage = 0;
 
 	buf = string_copy(ctx, opts, 0);
@@ -654,6 +655,19 @@ static void parse_extended_opts(e2fsck_t ctx, const char *opts)
 			else
 				ctx->log_fn = string_copy(ctx, arg, 0);
 			continue;
+		} else if (strcmp(token, "threads") == 0) {
+			if (!arg) {
+				extended_usage++;
+				continue;
+			}
+			threads = strtoul(arg, &p, 0);
+			if (*p || threads < 1 || threads > 256) {
+				fprintf(stderr, "%s",
+					_("Invalid number of threads.\n"));
+				extended_usage++;
+				continue;
+			}
+			ctx->num_threads = threads;
 		} else {
 			fprintf(stderr, _("Unknown extended option: %s\n"),
 				token);
@@ -672,6 +686,7 @@ static void parse_extended_opts(e2fsck_t ctx, const char *opts)
 		fputs(("\tjournal_only\n"), stderr);
 		fputs(("\tdiscard\n"), stderr);
 		fputs(("\tnodiscard\n"), stderr);
+		fputs(("\tthreads=<number of threads>\n"), stderr);
 		fputc('\n', stderr);
 		exit(1);
 	}
@@ -342,11 +342,17 @@ void init_resource_track(struct resource_track *track, io_channel channel)
 #endif
 	track->bytes_read = 0;
 	track->bytes_written = 0;
+	track->cache_hits = 0;
+	track->cache_misses = 0;
 	if (channel && channel->manager && channel->manager->get_stats)
 		channel->manager->get_stats(channel, &io_start);
 	if (io_start) {
 		track->bytes_read = io_start->bytes_read;
 		track->bytes_written = io_start->bytes_written;
+		if (io_start->num_fields >= 4) {
+			track->cache_hits = io_start->cache_hits;
+			track->cache_misses = io_start->cache_misses;
+		}
 	}
 }
 
@@ -412,6 +418,7 @@ void print_resource_track(e2fsck_t ctx, const char *desc,
 		io_stats delta = 0;
 		unsigned long long bytes_read = 0;
 		unsigned long long bytes_written = 0;
+		unsigned long long hits = 0, misses = 0;
 
 		if (desc)
 			log_out(ctx, "%s: ", desc);
@@ -421,12 +428,24 @@ void print_resource_track(e2fsck_t ctx, const char *desc,
 			bytes_read = delta->bytes_read - track->bytes_read;
 			bytes_written = delta->bytes_written -
 				track->bytes_written;
+			if (delta->num_fields >= 4) {
+				hits = delta->cache_hits - track->cache_hits;
+				misses = delta->cache_misses -
+					track->cache_misses;
+			}
 		}
 		log_out(ctx, "I/O read: %lluMB, write: %lluMB, "
 			"rate: %.2fMB/s\n",
 			mbytes(bytes_read), mbytes(bytes_written),
 			(double)mbytes(bytes_read + bytes_written) /
 			timeval_subtract(&time_end, &track->time_start));
+		if (hits + misses) {
+			if (desc)
+				log_out(ctx, "%s: ", desc);
+			log_out(ctx, "I/O cache hits: %llu, misses: %llu, "
+				"hit rate: %.1f%%\n", hits, misses,
+				100.0 * hits / (hits + misses));
+		}
 	}
 }
 #endif 
@@ -817,3 +836,129 @@ errcode_t e2fsck_allocate_subcluster_bitmap(ext2_filsys fs, const char *descr,
 	fs->default_bitmap_type = save_type;
 	return retval;
 }
+
+/*
+ * Worker threads get a private copy of the filesystem handle, with
+ * their own superblock, group descriptors and I/O channel, so that
+ * reads can proceed without locking.  A read error only aborts the
+ * worker's context; the main thread then redoes the work itself.
+ */
+static errcode_t clone_read_error(io_channel channel,
+				  unsigned long block EXT2FS_ATTR((unused)),
+				  int count EXT2FS_ATTR((unused)),
+				  void *data EXT2FS_ATTR((unused)),
+				  size_t size EXT2FS_ATTR((unused)),
+				  int actual EXT2FS_ATTR((unused)),
+				  errcode_t error)
+{
+	ext2_filsys fs = (ext2_filsys) channel->app_data;
+	e2fsck_t ctx = (e2fsck_t) fs->priv_data;
+
+	ctx->flags |= E2F_FLAG_ABORT;
+	return error;
+}
+
+errcode_t e2fsck_open_cloned_io(e2fsck_t ctx, ext2_filsys fs)
+{
+	io_channel	io;
+	errcode_t	retval;
+	int		flags = 0;
+
+	if (fs->flags & EXT2_FLAG_DIRECT_IO)
+		flags |= IO_FLAG_DIRECT_IO;
+	retval = ctx->fs->io->manager->open(fs->device_name, flags, &io);
+	if (retval)
+		return retval;
+	if (ctx->io_options)
+		retval = io_channel_set_options(io, ctx->io_options);
+	if (!retval)
+		retval = io_channel_set_blksize(io, fs->blocksize);
+	if (retval) {
+		io_channel_close(io);
+		return retval;
+	}
+	io->app_data = fs;
+	io->read_error = clone_read_error;
+	if (fs->io)
+		io_channel_close(fs->io);
+	fs->io = fs->image_io = io;
+	ext2fs_flush_icache(fs);
+	return 0;
+}
+
+void e2fsck_free_cloned_fs(e2fsck_t ctx, ext2_filsys fs)
+{
+	fs->device_name = 0;
+	fs->image_header = 0;
+	fs->dblist = 0;
+	if (fs->badblocks == ctx->fs->badblocks)
+		fs->badblocks = 0;
+	ext2fs_free(fs);
+}
+
+errcode_t e2fsck_clone_fs(e2fsck_t ctx, ext2_filsys *ret)
+{
+	ext2_filsys	src = ctx->fs, fs;
+	errcode_t	retval;
+
+	retval = ext2fs_get_mem(sizeof(struct struct_ext2_filsys), &fs);
+	if (retval)
+		return retval;
+	*fs = *src;
+	fs->io = fs->image_io = 0;
+	fs->super = fs->orig_super = 0;
+	fs->group_desc = 0;
+	fs->inode_map = 0;
+	fs->block_map = 0;
+	fs->dblist = 0;
+	fs->icache = 0;
+	fs->mmp_buf = fs->mmp_cmp = 0;
+	fs->mmp_fd = -1;
+
+	retval = ext2fs_get_mem(SUPERBLOCK_SIZE, &fs->super);
+	if (retval)
+		goto errout;
+	memcpy(fs->super, src->super, SUPERBLOCK_SIZE);
+	retval = ext2fs_get_array(fs->desc_blocks, fs->blocksize,
+				  &fs->group_desc);
+	if (retval)
+		goto errout;
+	memcpy(fs->group_desc, src->group_desc,
+	       (size_t) fs->desc_blocks * fs->blocksize);
+	retval = e2fsck_open_cloned_io(ctx, fs);
+	if (retval)
+		goto errout;
+	*ret = fs;
+	return 0;
+errout:
+	e2fsck_free_cloned_fs(ctx, fs);
+	return retval;
+}
+
+/*
+ * The main thread compares write generations around each piece of
+ * serial work to tell whether the workers' view of the disk is stale.
+ * The count includes writes still sitting in the I/O cache.
+ */
+int e2fsck_io_write_gen(ext2_filsys fs, unsigned long long *ret)
+{
+	io_stats	stats = 0;
+
+	if (!fs->io->manager->get_stats ||
+	    fs->io->manager->get_stats(fs->io, &stats) || !stats ||
+	    stats->num_fields < 5)
+		return 0;
+	*ret = stats->write_gen;
+	return 1;
+}
+
+/*
+ * Only the main thread may set the operation reported by the I/O
+ * error handler.
+ */
+const char *e2fsck_operation(e2fsck_t ctx, const char *op)
+{
+	if (ctx->global_ctx)
+		return 0;
+	return ehandler_operation(op);
+}
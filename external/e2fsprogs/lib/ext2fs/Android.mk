@@ -57,6 +57,7 @@ libext2fs_src_files := \
 	progress.c \
 	punch.c \
 	rbtree.c \
+	readahead.c \
 	read_bb.c \
 	read_bb_file.c \
 	res_gdt.c \
@@ -116,7 +117,8 @@ libext2fs_cflags_linux := \
 	-DHAVE_LINUX_FD_H \
 	-DHAVE_SYS_PRCTL_H \
 	-DHAVE_LSEEK64 \
-	-DHAVE_LSEEK64_PROTOTYPE
+	-DHAVE_LSEEK64_PROTOTYPE \
+	-DHAVE_POSIX_FADVISE
 
 include $(CLEAR_VARS)
 
@@ -363,7 +363,8 @@ static uint32_t crc32c_be_body(uint32_t crc, uint8_t const *buf, size_t len)
 }
 #endif
 
-uint32_t ext2fs_crc32c_le(uint32_t crc, unsigned char const *p, size_t len)
+static uint32_t crc32c_le_sw(uint32_t crc, unsigned char const *p,
+			     size_t len)
 {
 #if CRC_LE_BITS == 1
 	int i;
@@ -397,6 +398,151 @@ uint32_t ext2fs_crc32c_le(uint32_t crc, unsigned char const *p, size_t len)
 	return crc;
 }
 
+#if (defined(__x86_64__) || defined(__i386__)) && \
+	(defined(__clang__) || __GNUC__ > 4 || \
+	 (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define CRC32C_X86
+#include <cpuid.h>
+#include <nmmintrin.h>
+#ifdef __x86_64__
+#define CRC32C_PCLMUL
+#include <wmmintrin.h>
+#endif
+#endif
+
+#ifdef CRC32C_X86
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_le_sse42(uint32_t crc, unsigned char const *p,
+				size_t len)
+{
+	while (len && ((uintptr_t) p & 7)) {
+		crc = _mm_crc32_u8(crc, *p++);
+		len--;
+	}
+#ifdef __x86_64__
+	for (; len >= 8; len -= 8, p += 8)
+		crc = _mm_crc32_u64(crc, *(const uint64_t *) p);
+#else
+	for (; len >= 4; len -= 4, p += 4)
+		crc = _mm_crc32_u32(crc, *(const uint32_t *) p);
+#endif
+	while (len--)
+		crc = _mm_crc32_u8(crc, *p++);
+	return crc;
+}
+
+#ifdef CRC32C_PCLMUL
+/*
+ * The crc32 instruction has a latency of three cycles but can issue
+ * every cycle, so run three independent streams over adjacent blocks
+ * of n bytes and recombine them with carry-less multiplies.  Each
+ * constant is chosen so that crc32(0, clmul(crc, k)) equals crc
+ * advanced over n (or 2n) zero bytes.
+ */
+#define CRC32C_LONG		1024
+#define CRC32C_LONG_K1		0x170076faULL
+#define CRC32C_LONG_K2		0x1a0f717c4ULL
+#define CRC32C_SHORT		128
+#define CRC32C_SHORT_K1		0xd3b6092ULL
+#define CRC32C_SHORT_K2		0xb9e02b86ULL
+
+__attribute__((target("sse4.2,pclmul")))
+static uint32_t crc32c_shift(uint64_t crc, uint64_t k)
+{
+	__m128i v;
+
+	v = _mm_clmulepi64_si128(_mm_cvtsi64_si128(crc),
+				 _mm_cvtsi64_si128(k), 0x00);
+	return _mm_crc32_u64(0, _mm_cvtsi128_si64(v));
+}
+
+__attribute__((target("sse4.2,pclmul")))
+static uint32_t crc32c_3way(uint32_t crc, unsigned char const *p,
+			    size_t n, uint64_t k1, uint64_t k2)
+{
+	const uint64_t *a = (const uint64_t *) p;
+	const uint64_t *b = (const uint64_t *) (p + n);
+	const uint64_t *c = (const uint64_t *) (p + 2 * n);
+	uint64_t crc0 = crc, crc1 = 0, crc2 = 0;
+	size_t i;
+
+	for (i = 0; i < n / 8; i++) {
+		crc0 = _mm_crc32_u64(crc0, a[i]);
+		crc1 = _mm_crc32_u64(crc1, b[i]);
+		crc2 = _mm_crc32_u64(crc2, c[i]);
+	}
+	return crc32c_shift(crc0, k2) ^ crc32c_shift(crc1, k1) ^ crc2;
+}
+
+__attribute__((target("sse4.2,pclmul")))
+static uint32_t crc32c_le_pclmul(uint32_t crc, unsigned char const *p,
+				 size_t len)
+{
+	while (len && ((uintptr_t) p & 7)) {
+		crc = _mm_crc32_u8(crc, *p++);
+		len--;
+	}
+	for (; len >= 3 * CRC32C_LONG; len -= 3 * CRC32C_LONG,
+	     p += 3 * CRC32C_LONG)
+		crc = crc32c_3way(crc, p, CRC32C_LONG, CRC32C_LONG_K1,
+				  CRC32C_LONG_K2);
+	for (; len >= 3 * CRC32C_SHORT; len -= 3 * CRC32C_SHORT,
+	     p += 3 * CRC32C_SHORT)
+		crc = crc32c_3way(crc, p, CRC32C_SHORT, CRC32C_SHORT_K1,
+				  CRC32C_SHORT_K2);
+	return crc32c_le_sse42(crc, p, len);
+}
+#endif
+
+static int crc32c_cpu_has(unsigned int ecx_bits)
+{
+	unsigned int eax, ebx, ecx, edx;
+
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+		return 0;
+	return (ecx & ecx_bits) == ecx_bits;
+}
+
+typedef uint32_t (*crc32c_le_fn_t)(uint32_t crc, unsigned char const *p,
+				   size_t len);
+
+static crc32c_le_fn_t crc32c_le_fn;
+
+/*
+ * e2fsck's worker threads may get here at the same time.  They all
+ * pick the same function, so it does not matter which store wins, but
+ * the pointer must be accessed atomically.
+ */
+static crc32c_le_fn_t crc32c_le_select(void)
+{
+	crc32c_le_fn_t fn;
+
+	fn = crc32c_le_sw;
+	if (crc32c_cpu_has(bit_SSE4_2))
+		fn = crc32c_le_sse42;
+#ifdef CRC32C_PCLMUL
+	if (crc32c_cpu_has(bit_SSE4_2 | bit_PCLMUL))
+		fn = crc32c_le_pclmul;
+#endif
+	__atomic_store_n(&crc32c_le_fn, fn, __ATOMIC_RELEASE);
+	return fn;
+}
+#endif
+
+uint32_t ext2fs_crc32c_le(uint32_t crc, unsigned char const *p, size_t len)
+{
+#ifdef CRC32C_X86
+	crc32c_le_fn_t fn;
+
+	fn = __atomic_load_n(&crc32c_le_fn, __ATOMIC_ACQUIRE);
+	if (unlikely(!fn))
+		fn = crc32c_le_select();
+	return fn(crc, p, len);
+#else
+	return crc32c_le_sw(crc, p, len);
+#endif
+}
+
 uint32_t ext2fs_crc32c_be(uint32_t crc, unsigned char const *p, size_t len)
 {
 #if CRC_BE_BITS == 1
@@ -1111,11 +1257,59 @@ static int test_crc32c(void)
 	return failures;
 }
 
+#ifdef CRC32C_X86
+static int test_crc32c_impl(const char *name,
+			    uint32_t (*fn)(uint32_t crc,
+					   unsigned char const *p,
+					   size_t len))
+{
+	static unsigned char buf[16384 + 8];
+	struct crc_test *t;
+	uint32_t crc, sw, hw;
+	size_t i, start, len;
+	int failures = 0;
+
+	for (t = test; t->length; t++) {
+		crc = fn(t->crc, test_buf + t->start, t->length);
+		if (crc != t->crc_le) {
+			printf("Test %d %s fails, %x != %x\n",
+			       (int) (t - test), name, crc, t->crc_le);
+			failures++;
+		}
+	}
+
+	srandom(0);
+	for (i = 0; i < sizeof(buf); i++)
+		buf[i] = random();
+	for (i = 0; i < 1000; i++) {
+		start = random() % 8;
+		len = random() % (sizeof(buf) - start);
+		crc = random();
+		sw = crc32c_le_sw(crc, buf + start, len);
+		hw = fn(crc, buf + start, len);
+		if (sw != hw) {
+			printf("%s fails at offset %d length %d, %x != %x\n",
+			       name, (int) start, (int) len, hw, sw);
+			failures++;
+		}
+	}
+	return failures;
+}
+#endif
+
 int main(int argc, char *argv[])
 {
 	int ret;
 
 	ret = test_crc32c();
+#ifdef CRC32C_X86
+	if (crc32c_cpu_has(bit_SSE4_2))
+		ret += test_crc32c_impl("SSE4.2", crc32c_le_sse42);
+#ifdef CRC32C_PCLMUL
+	if (crc32c_cpu_has(bit_SSE4_2 | bit_PCLMUL))
+		ret += test_crc32c_impl("PCLMUL", crc32c_le_pclmul);
+#endif
+#endif
 	if (!ret)
 		printf("No failures.\n");
 
@@ -131,6 +131,61 @@ errcode_t ext2fs_copy_dblist(ext2_dblist src, ext2_dblist *dest)
 	return 0;
 }
 
+/*
+ * Allocate an empty directory block list with room for SIZE entries.
+ * The list is not attached to FS, and grows as needed.
+ */
+errcode_t ext2fs_alloc_dblist(ext2_filsys fs, ext2_ino_t size,
+			      ext2_dblist *ret_dblist)
+{
+	ext2_dblist	dblist;
+	errcode_t	retval;
+
+	retval = make_dblist(fs, size ? size : 12, 0, 0, &dblist);
+	if (retval)
+		return retval;
+
+	dblist->sorted = 1;
+	*ret_dblist = dblist;
+	return 0;
+}
+
+/*
+ * Append the entries of SRC to DEST and empty SRC.
+ */
+errcode_t ext2fs_merge_dblist(ext2_dblist src, ext2_dblist dest)
+{
+	unsigned long long	count, size;
+	unsigned long		old_size;
+	errcode_t		retval;
+
+	EXT2_CHECK_MAGIC(src, EXT2_ET_MAGIC_DBLIST);
+	EXT2_CHECK_MAGIC(dest, EXT2_ET_MAGIC_DBLIST);
+
+	if (src->count == 0)
+		return 0;
+
+	count = dest->count + src->count;
+	if (count > dest->size) {
+		size = dest->size + dest->size / 2;
+		if (size < count)
+			size = count;
+		old_size = dest->size * sizeof(struct ext2_db_entry2);
+		retval = ext2fs_resize_mem(old_size, (size_t) size *
+					   sizeof(struct ext2_db_entry2),
+					   &dest->list);
+		if (retval)
+			return retval;
+		dest->size = size;
+	}
+	memcpy(dest->list + dest->count, src->list,
+	       (size_t) src->count * sizeof(struct ext2_db_entry2));
+	dest->count = count;
+	dest->sorted = 0;
+	src->count = 0;
+	return 0;
+}
+
 
 
 errcode_t ext2fs_add_dir_block2(ext2_dblist dblist, ext2_ino_t ino,
@@ -192,20 +247,30 @@ void ext2fs_dblist_sort2(ext2_dblist dblist,
 	dblist->sorted = 1;
 }
 
-errcode_t ext2fs_dblist_iterate2(ext2_dblist dblist,
+/*
+ * Iterate over count entries of the directory block list, starting at
+ * entry start.  Once the list has been sorted, disjoint ranges may be
+ * iterated concurrently.
+ */
+errcode_t ext2fs_dblist_iterate3(ext2_dblist dblist,
 				 int (*func)(ext2_filsys fs,
 					     struct ext2_db_entry2 *db_info,
 					     void	*priv_data),
+				 unsigned long long start,
+				 unsigned long long count,
 				 void *priv_data)
 {
-	unsigned long long	i;
+	unsigned long long	i, end;
 	int		ret;
 
 	EXT2_CHECK_MAGIC(dblist, EXT2_ET_MAGIC_DBLIST);
 
 	if (!dblist->sorted)
 		ext2fs_dblist_sort2(dblist, 0);
-	for (i=0; i < dblist->count; i++) {
+	end = start + count;
+	if (end > dblist->count)
+		end = dblist->count;
+	for (i = start; i < end; i++) {
 		ret = (*func)(dblist->fs, &dblist->list[i], priv_data);
 		if (ret & DBLIST_ABORT)
 			return 0;
@@ -213,6 +278,18 @@ errcode_t ext2fs_dblist_iterate2(ext2_dblist dblist,
 	return 0;
 }
 
+errcode_t ext2fs_dblist_iterate2(ext2_dblist dblist,
+				 int (*func)(ext2_filsys fs,
+					     struct ext2_db_entry2 *db_info,
+					     void	*priv_data),
+				 void *priv_data)
+{
+	EXT2_CHECK_MAGIC(dblist, EXT2_ET_MAGIC_DBLIST);
+
+	return ext2fs_dblist_iterate3(dblist, func, 0, dblist->count,
+				      priv_data);
+}
+
 static EXT2_QSORT_TYPE dir_block_cmp2(const void *a, const void *b)
 {
 	const struct ext2_db_entry2 *db_a =
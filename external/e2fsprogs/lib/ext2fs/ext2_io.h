@@ -62,6 +62,9 @@ struct struct_io_stats {
 	int			reserved;
 	unsigned long long	bytes_read;
 	unsigned long long	bytes_written;
+	unsigned long long	cache_hits;
+	unsigned long long	cache_misses;
+	unsigned long long	write_gen;
 };
 
 struct struct_io_manager {
@@ -86,7 +89,10 @@ struct struct_io_manager {
 					int count, const void *data);
 	errcode_t (*discard)(io_channel channel, unsigned long long block,
 			     unsigned long long count);
-	long	reserved[16];
+	errcode_t (*cache_readahead)(io_channel channel,
+				     unsigned long long block,
+				     unsigned long long count);
+	long	reserved[15];
 };
 
 #define IO_FLAG_RW		0x0001
@@ -116,6 +122,9 @@ extern errcode_t io_channel_discard(io_channel channel,
 				    unsigned long long count);
 extern errcode_t io_channel_alloc_buf(io_channel channel,
 				      int count, void *ptr);
+extern errcode_t io_channel_cache_readahead(io_channel io,
+					    unsigned long long block,
+					    unsigned long long count);
 
 extern io_manager unix_io_manager;
 
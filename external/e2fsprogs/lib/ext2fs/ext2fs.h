@@ -781,12 +781,20 @@ extern errcode_t ext2fs_dblist_iterate2(ext2_dblist dblist,
 	int (*func)(ext2_filsys fs, struct ext2_db_entry2 *db_info,
 		    void	*priv_data),
        void *priv_data);
+extern errcode_t ext2fs_dblist_iterate3(ext2_dblist dblist,
+	int (*func)(ext2_filsys fs, struct ext2_db_entry2 *db_info,
+		    void	*priv_data),
+	unsigned long long start, unsigned long long count,
+	void *priv_data);
 extern errcode_t ext2fs_set_dir_block(ext2_dblist dblist, ext2_ino_t ino,
 				      blk_t blk, int blockcnt);
 extern errcode_t ext2fs_set_dir_block2(ext2_dblist dblist, ext2_ino_t ino,
 				       blk64_t blk, e2_blkcnt_t blockcnt);
 extern errcode_t ext2fs_copy_dblist(ext2_dblist src,
 				    ext2_dblist *dest);
+extern errcode_t ext2fs_alloc_dblist(ext2_filsys fs, ext2_ino_t size,
+				     ext2_dblist *ret_dblist);
+extern errcode_t ext2fs_merge_dblist(ext2_dblist src, ext2_dblist dest);
 extern int ext2fs_dblist_count(ext2_dblist dblist);
 extern blk64_t ext2fs_dblist_count2(ext2_dblist dblist);
 extern errcode_t ext2fs_dblist_get_last(ext2_dblist dblist,
@@ -1174,6 +1182,16 @@ errcode_t ext2fs_mmp_update(ext2_filsys fs);
 errcode_t ext2fs_mmp_stop(ext2_filsys fs);
 unsigned ext2fs_mmp_new_seq(void);
 
+#define EXT2_READA_BBITMAP	0x0001
+#define EXT2_READA_IBITMAP	0x0002
+#define EXT2_READA_ITABLE	0x0004
+
+extern errcode_t ext2fs_readahead(ext2_filsys fs, int flags, dgrp_t start,
+				  dgrp_t ngroups);
+extern errcode_t ext2fs_dblist_readahead(ext2_dblist dblist,
+					 unsigned long long start,
+					 unsigned long long count);
+
 extern errcode_t ext2fs_read_bb_inode(ext2_filsys fs,
 				      ext2_badblocks_list *bb_list);
 
@@ -0,0 +1,115 @@
+/*
+ * readahead.c --- tell the I/O channel which metadata blocks will be
+ * 	read soon
+ *
+ * %Begin-Header%
+ * This file may be redistributed under the terms of the GNU Library
+ * General Public License, version 2.
+ * %End-Header%
+ */
+
+#include <stdio.h>
+#include <string.h>
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#include "ext2_fs.h"
+#include "ext2fsP.h"
+
+struct readahead_run {
+	io_channel		io;
+	blk64_t			start;
+	blk64_t			count;
+	errcode_t		retval;
+};
+
+static void readahead_flush(struct readahead_run *ra)
+{
+	if (ra->count && !ra->retval)
+		ra->retval = io_channel_cache_readahead(ra->io, ra->start,
+							ra->count);
+	ra->count = 0;
+}
+
+static void readahead_add(struct readahead_run *ra, blk64_t blk,
+			  blk64_t count)
+{
+	if (!blk || !count)
+		return;
+	if (ra->count && blk == ra->start + ra->count) {
+		ra->count += count;
+		return;
+	}
+	readahead_flush(ra);
+	ra->start = blk;
+	ra->count = count;
+}
+
+errcode_t ext2fs_readahead(ext2_filsys fs, int flags, dgrp_t start,
+			   dgrp_t ngroups)
+{
+	struct readahead_run	ra;
+	blk64_t			blocks, unused;
+	dgrp_t			group, end;
+	int			csum;
+
+	EXT2_CHECK_MAGIC(fs, EXT2_ET_MAGIC_EXT2FS_FILSYS);
+
+	if (start >= fs->group_desc_count)
+		return 0;
+	end = start + ngroups;
+	if (end > fs->group_desc_count || end < start)
+		end = fs->group_desc_count;
+
+	memset(&ra, 0, sizeof(ra));
+	ra.io = fs->io;
+	csum = EXT2_HAS_RO_COMPAT_FEATURE(fs->super,
+					   EXT4_FEATURE_RO_COMPAT_GDT_CSUM);
+	for (group = start; group < end && !ra.retval; group++) {
+		if ((flags & EXT2_READA_BBITMAP) &&
+		    !(csum && ext2fs_bg_flags_test(fs, group,
+						   EXT2_BG_BLOCK_UNINIT)))
+			readahead_add(&ra, ext2fs_block_bitmap_loc(fs, group),
+				      1);
+		if ((flags & EXT2_READA_IBITMAP) &&
+		    !(csum && ext2fs_bg_flags_test(fs, group,
+						   EXT2_BG_INODE_UNINIT)))
+			readahead_add(&ra, ext2fs_inode_bitmap_loc(fs, group),
+				      1);
+		if (!(flags & EXT2_READA_ITABLE) ||
+		    (csum && ext2fs_bg_flags_test(fs, group,
+						  EXT2_BG_INODE_UNINIT)))
+			continue;
+		blocks = fs->inode_blocks_per_group;
+		if (csum) {
+			unused = ((blk64_t) ext2fs_bg_itable_unused(fs, group) *
+				  EXT2_INODE_SIZE(fs->super)) / fs->blocksize;
+			blocks = (unused < blocks) ? blocks - unused : 0;
+		}
+		readahead_add(&ra, ext2fs_inode_table_loc(fs, group), blocks);
+	}
+	readahead_flush(&ra);
+	return ra.retval;
+}
+
+errcode_t ext2fs_dblist_readahead(ext2_dblist dblist,
+				  unsigned long long start,
+				  unsigned long long count)
+{
+	struct readahead_run	ra;
+	unsigned long long	i, end;
+
+	EXT2_CHECK_MAGIC(dblist, EXT2_ET_MAGIC_DBLIST);
+
+	end = start + count;
+	if (end > dblist->count || end < start)
+		end = dblist->count;
+
+	memset(&ra, 0, sizeof(ra));
+	ra.io = dblist->fs->io;
+	for (i = start; i < end && !ra.retval; i++)
+		readahead_add(&ra, dblist->list[i].blk, 1);
+	readahead_flush(&ra);
+	return ra.retval;
+}
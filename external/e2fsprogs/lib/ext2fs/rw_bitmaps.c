@@ -245,6 +245,10 @@ static errcode_t read_bitmaps(ext2_filsys fs, int do_inode, int do_block)
 		goto success_cleanup;
 	}
 
+	(void) ext2fs_readahead(fs, (block_bitmap ? EXT2_READA_BBITMAP : 0) |
+				(inode_bitmap ? EXT2_READA_IBITMAP : 0),
+				0, fs->group_desc_count);
+
 	for (i = 0; i < fs->group_desc_count; i++) {
 		if (block_bitmap) {
 			blk = ext2fs_block_bitmap_loc(fs, i);
@@ -78,6 +78,9 @@ static errcode_t test_set_option(io_channel channel, const char *option,
 static errcode_t test_get_stats(io_channel channel, io_stats *stats);
 static errcode_t test_discard(io_channel channel, unsigned long long block,
 			      unsigned long long count);
+static errcode_t test_cache_readahead(io_channel channel,
+				      unsigned long long block,
+				      unsigned long long count);
 
 static struct struct_io_manager struct_test_manager = {
 	EXT2_ET_MAGIC_IO_MANAGER,
@@ -94,6 +97,7 @@ static struct struct_io_manager struct_test_manager = {
 	test_read_blk64,
 	test_write_blk64,
 	test_discard,
+	test_cache_readahead,
 };
 
 io_manager test_io_manager = &struct_test_manager;
@@ -515,3 +519,19 @@ static errcode_t test_discard(io_channel channel, unsigned long long block,
 			block, count, retval ? error_message(retval) : "OK");
 	return retval;
 }
+
+static errcode_t test_cache_readahead(io_channel channel,
+				      unsigned long long block,
+				      unsigned long long count)
+{
+	struct test_private_data *data;
+	errcode_t	retval = 0;
+
+	EXT2_CHECK_MAGIC(channel, EXT2_ET_MAGIC_IO_CHANNEL);
+	data = (struct test_private_data *) channel->private_data;
+	EXT2_CHECK_MAGIC(data, EXT2_ET_MAGIC_TEST_IO_CHANNEL);
+
+	if (data->real)
+		retval = io_channel_cache_readahead(data->real, block, count);
+	return retval;
+}
@@ -2,7 +2,9 @@
  * unix_io.c --- This is the Unix (well, really POSIX) implementation
  * 	of the I/O manager.
  *
- * Implements a one-block write-through cache.
+ * Implements a hash-indexed LRU block cache, sized in megabytes via the
+ * "cache_size" option, whose dirty blocks are written back in sorted,
+ * coalesced runs.
  *
  * Includes support for Windows NT support under Cygwin.
  *
@@ -69,23 +71,36 @@
 struct unix_cache {
 	char			*buf;
 	unsigned long long	block;
-	int			access_time;
+	struct unix_cache	*hash_next;
+	struct unix_cache	*lru_prev;
+	struct unix_cache	*lru_next;
 	unsigned		dirty:1;
 	unsigned		in_use:1;
 };
 
 #define CACHE_SIZE 8
+#define DEFAULT_CACHE_MB 1
+#define MAX_CACHE_MB 1024
 #define WRITE_DIRECT_SIZE 4	
 #define READ_DIRECT_SIZE 4	
+#define WRITE_COALESCE_SIZE 64
 
 struct unix_private_data {
 	int	magic;
 	int	dev;
 	int	flags;
 	int	align;
-	int	access_time;
 	ext2_loff_t offset;
-	struct unix_cache cache[CACHE_SIZE];
+	unsigned long long cache_bytes;
+	int	cache_size;
+	unsigned int hash_mask;
+	struct unix_cache *cache;
+	struct unix_cache **hash;
+	struct unix_cache **dirty;
+	struct unix_cache *lru_head;
+	struct unix_cache *lru_tail;
+	char	*cache_buf;
+	char	*write_buf;
 	void	*bounce;
 	struct struct_io_stats io_stats;
 };
@@ -107,14 +122,15 @@ static errcode_t unix_set_option(io_channel channel, const char *option,
 				 const char *arg);
 static errcode_t unix_get_stats(io_channel channel, io_stats *stats)
 ;
-static void reuse_cache(io_channel channel, struct unix_private_data *data,
-		 struct unix_cache *cache, unsigned long long block);
 static errcode_t unix_read_blk64(io_channel channel, unsigned long long block,
 			       int count, void *data);
 static errcode_t unix_write_blk64(io_channel channel, unsigned long long block,
 				int count, const void *data);
 static errcode_t unix_discard(io_channel channel, unsigned long long block,
 			      unsigned long long count);
+static errcode_t unix_cache_readahead(io_channel channel,
+				      unsigned long long block,
+				      unsigned long long count);
 
 static struct struct_io_manager struct_unix_manager = {
 	EXT2_ET_MAGIC_IO_MANAGER,
@@ -131,6 +147,7 @@ static struct struct_io_manager struct_unix_manager = {
 	unix_read_blk64,
 	unix_write_blk64,
 	unix_discard,
+	unix_cache_readahead,
 };
 
 io_manager unix_io_manager = &struct_unix_manager;
@@ -282,25 +299,84 @@ error_out:
 
 
 
+static void lru_unlink(struct unix_private_data *data,
+		       struct unix_cache *cache)
+{
+	if (cache->lru_prev)
+		cache->lru_prev->lru_next = cache->lru_next;
+	else
+		data->lru_head = cache->lru_next;
+	if (cache->lru_next)
+		cache->lru_next->lru_prev = cache->lru_prev;
+	else
+		data->lru_tail = cache->lru_prev;
+	cache->lru_prev = cache->lru_next = 0;
+}
+
+static void lru_insert(struct unix_private_data *data,
+		       struct unix_cache *cache, int at_tail)
+{
+	if (at_tail) {
+		cache->lru_prev = data->lru_tail;
+		cache->lru_next = 0;
+		if (data->lru_tail)
+			data->lru_tail->lru_next = cache;
+		else
+			data->lru_head = cache;
+		data->lru_tail = cache;
+	} else {
+		cache->lru_prev = 0;
+		cache->lru_next = data->lru_head;
+		if (data->lru_head)
+			data->lru_head->lru_prev = cache;
+		else
+			data->lru_tail = cache;
+		data->lru_head = cache;
+	}
+}
+
 static errcode_t alloc_cache(io_channel channel,
 			     struct unix_private_data *data)
 {
 	errcode_t		retval;
 	struct unix_cache	*cache;
-	int			i;
-
-	data->access_time = 0;
-	for (i=0, cache = data->cache; i < CACHE_SIZE; i++, cache++) {
-		cache->block = 0;
-		cache->access_time = 0;
-		cache->dirty = 0;
-		cache->in_use = 0;
-		if (cache->buf)
-			ext2fs_free_mem(&cache->buf);
-		retval = io_channel_alloc_buf(channel, 0, &cache->buf);
-		if (retval)
-			return retval;
+	unsigned int		hash_size;
+	int			i, size;
+
+	size = data->cache_bytes / channel->block_size;
+	if (size < CACHE_SIZE)
+		size = CACHE_SIZE;
+	for (hash_size = 1; hash_size < (unsigned int) size; hash_size <<= 1)
+		;
+
+	retval = ext2fs_get_arrayzero(size, sizeof(struct unix_cache),
+				      &data->cache);
+	if (retval)
+		return retval;
+	retval = ext2fs_get_arrayzero(hash_size, sizeof(struct unix_cache *),
+				      &data->hash);
+	if (retval)
+		return retval;
+	retval = ext2fs_get_array(size, sizeof(struct unix_cache *),
+				  &data->dirty);
+	if (retval)
+		return retval;
+	retval = io_channel_alloc_buf(channel, size, &data->cache_buf);
+	if (retval)
+		return retval;
+	retval = io_channel_alloc_buf(channel, WRITE_COALESCE_SIZE,
+				      &data->write_buf);
+	if (retval)
+		return retval;
+
+	data->lru_head = data->lru_tail = 0;
+	for (i=0, cache = data->cache; i < size; i++, cache++) {
+		cache->buf = data->cache_buf + i * channel->block_size;
+		lru_insert(data, cache, 1);
 	}
+	data->cache_size = size;
+	data->hash_mask = hash_size - 1;
+
 	if (channel->align) {
 		if (data->bounce)
 			ext2fs_free_mem(&data->bounce);
@@ -311,90 +387,256 @@ static errcode_t alloc_cache(io_channel channel,
 
 static void free_cache(struct unix_private_data *data)
 {
-	struct unix_cache	*cache;
-	int			i;
-
-	data->access_time = 0;
-	for (i=0, cache = data->cache; i < CACHE_SIZE; i++, cache++) {
-		cache->block = 0;
-		cache->access_time = 0;
-		cache->dirty = 0;
-		cache->in_use = 0;
-		if (cache->buf)
-			ext2fs_free_mem(&cache->buf);
-	}
+	data->cache_size = 0;
+	data->hash_mask = 0;
+	data->lru_head = data->lru_tail = 0;
+	if (data->cache)
+		ext2fs_free_mem(&data->cache);
+	if (data->hash)
+		ext2fs_free_mem(&data->hash);
+	if (data->dirty)
+		ext2fs_free_mem(&data->dirty);
+	if (data->cache_buf)
+		ext2fs_free_mem(&data->cache_buf);
+	if (data->write_buf)
+		ext2fs_free_mem(&data->write_buf);
 	if (data->bounce)
 		ext2fs_free_mem(&data->bounce);
 }
 
 #ifndef NO_IO_CACHE
+static unsigned int cache_hash(struct unix_private_data *data,
+			       unsigned long long block)
+{
+	return (unsigned int) ((block * 0x9E3779B97F4A7C15ULL) >> 32) &
+		data->hash_mask;
+}
+
 static struct unix_cache *find_cached_block(struct unix_private_data *data,
-					    unsigned long long block,
-					    struct unix_cache **eldest)
+					    unsigned long long block)
 {
-	struct unix_cache	*cache, *unused_cache, *oldest_cache;
-	int			i;
+	struct unix_cache	*cache;
 
-	unused_cache = oldest_cache = 0;
-	for (i=0, cache = data->cache; i < CACHE_SIZE; i++, cache++) {
-		if (!cache->in_use) {
-			if (!unused_cache)
-				unused_cache = cache;
-			continue;
-		}
-		if (cache->block == block) {
-			cache->access_time = ++data->access_time;
+	for (cache = data->hash[cache_hash(data, block)]; cache;
+	     cache = cache->hash_next)
+		if (cache->block == block)
 			return cache;
+	return 0;
+}
+
+static void unhash_cache(struct unix_private_data *data,
+			 struct unix_cache *cache)
+{
+	struct unix_cache	**pp;
+
+	if (!cache->in_use)
+		return;
+	for (pp = &data->hash[cache_hash(data, cache->block)]; *pp;
+	     pp = &(*pp)->hash_next) {
+		if (*pp == cache) {
+			*pp = cache->hash_next;
+			break;
 		}
-		if (!oldest_cache ||
-		    (cache->access_time < oldest_cache->access_time))
-			oldest_cache = cache;
 	}
-	if (eldest)
-		*eldest = (unused_cache) ? unused_cache : oldest_cache;
-	return 0;
+	cache->hash_next = 0;
 }
 
-static void reuse_cache(io_channel channel, struct unix_private_data *data,
-		 struct unix_cache *cache, unsigned long long block)
+static void touch_cache(struct unix_private_data *data,
+			struct unix_cache *cache)
 {
-	if (cache->dirty && cache->in_use)
-		raw_write_blk(channel, data, cache->block, 1, cache->buf);
+	if (data->lru_head == cache)
+		return;
+	lru_unlink(data, cache);
+	lru_insert(data, cache, 0);
+}
 
-	cache->in_use = 1;
+static void invalidate_cache(struct unix_private_data *data,
+			     struct unix_cache *cache)
+{
+	unhash_cache(data, cache);
+	cache->in_use = 0;
 	cache->dirty = 0;
-	cache->block = block;
-	cache->access_time = ++data->access_time;
+	lru_unlink(data, cache);
+	lru_insert(data, cache, 1);
+}
+
+static void invalidate_cached_range(struct unix_private_data *data,
+				    unsigned long long block,
+				    unsigned long long count)
+{
+	struct unix_cache	*cache;
+	unsigned long long	i;
+	int			j;
+
+	if (count < (unsigned long long) data->cache_size) {
+		for (i = 0; i < count; i++)
+			if ((cache = find_cached_block(data, block + i)))
+				invalidate_cache(data, cache);
+		return;
+	}
+	for (j = 0, cache = data->cache; j < data->cache_size; j++, cache++)
+		if (cache->in_use && cache->block >= block &&
+		    cache->block - block < count)
+			invalidate_cache(data, cache);
+}
+
+static int cache_block_cmp(const void *a, const void *b)
+{
+	const struct unix_cache *ca = *(const struct unix_cache * const *) a;
+	const struct unix_cache *cb = *(const struct unix_cache * const *) b;
+
+	if (ca->block < cb->block)
+		return -1;
+	return ca->block > cb->block;
+}
+
+/*
+ * Write back N dirty cache blocks with consecutive block numbers as a
+ * single write.  If that fails, the blocks are retried one at a time, so
+ * write_error only ever sees single blocks.  Blocks that made it to disk
+ * are marked clean.
+ */
+static errcode_t write_cached_run(io_channel channel,
+				  struct unix_private_data *data,
+				  struct unix_cache **run, int n)
+{
+	struct unix_cache	*cache;
+	errcode_t		retval, retval2, run_err;
+	errcode_t		(*write_error)(io_channel, unsigned long, int,
+					       const void *, size_t, int,
+					       errcode_t);
+	char			*buf;
+	int			k;
+
+	if (n == 1)
+		buf = run[0]->buf;
+	else {
+		buf = data->write_buf;
+		for (k = 0; k < n; k++)
+			memcpy(buf + k * channel->block_size,
+			       run[k]->buf, channel->block_size);
+	}
+	write_error = channel->write_error;
+	if (n > 1)
+		channel->write_error = 0;
+	run_err = raw_write_blk(channel, data, run[0]->block, n, buf);
+	channel->write_error = write_error;
+
+	retval2 = 0;
+	for (k = 0; k < n; k++) {
+		cache = run[k];
+		retval = run_err;
+		if (run_err && n > 1)
+			retval = raw_write_blk(channel, data, cache->block, 1,
+					       cache->buf);
+		if (retval)
+			retval2 = retval;
+		else
+			cache->dirty = 0;
+	}
+	return retval2;
 }
 
+/*
+ * Dirty blocks are written back in block order, with runs of adjacent
+ * blocks merged into a single write.
+ */
 static errcode_t flush_cached_blocks(io_channel channel,
 				     struct unix_private_data *data,
 				     int invalidate)
 
 {
-	struct unix_cache	*cache;
+	struct unix_cache	*cache, **dirty = data->dirty;
 	errcode_t		retval, retval2;
-	int			i;
+	int			i, j, k, n;
 
-	retval2 = 0;
-	for (i=0, cache = data->cache; i < CACHE_SIZE; i++, cache++) {
+	n = 0;
+	for (i=0, cache = data->cache; i < data->cache_size; i++, cache++) {
 		if (!cache->in_use)
 			continue;
+		if (cache->dirty)
+			dirty[n++] = cache;
+		else if (invalidate)
+			invalidate_cache(data, cache);
+	}
+	if (n > 1)
+		qsort(dirty, n, sizeof(struct unix_cache *), cache_block_cmp);
 
+	retval2 = 0;
+	for (i = 0; i < n; i += j) {
+		for (j = 1; i + j < n && j < WRITE_COALESCE_SIZE; j++)
+			if (dirty[i + j]->block != dirty[i]->block + j)
+				break;
+		retval = write_cached_run(channel, data, dirty + i, j);
+		if (retval)
+			retval2 = retval;
 		if (invalidate)
-			cache->in_use = 0;
+			for (k = 0; k < j; k++)
+				invalidate_cache(data, dirty[i + k]);
+	}
+	return retval2;
+}
 
-		if (!cache->dirty)
-			continue;
+/*
+ * Write back a dirty block that is about to be evicted, together with
+ * the dirty cached blocks directly around it.
+ */
+static errcode_t write_evicted_block(io_channel channel,
+				     struct unix_private_data *data,
+				     struct unix_cache *cache)
+{
+	struct unix_cache	*p, **run = data->dirty;
+	unsigned long long	first;
+	int			before, n;
+
+	for (n = 1; n < WRITE_COALESCE_SIZE; n++) {
+		p = find_cached_block(data, cache->block + n);
+		if (!p || !p->dirty)
+			break;
+	}
+	for (before = 0; before + n < WRITE_COALESCE_SIZE &&
+		     cache->block > (unsigned long long) before; before++) {
+		p = find_cached_block(data, cache->block - before - 1);
+		if (!p || !p->dirty)
+			break;
+	}
+	n += before;
+	first = cache->block - before;
+	for (before = 0; before < n; before++)
+		run[before] = find_cached_block(data, first + before);
+	return write_cached_run(channel, data, run, n);
+}
 
-		retval = raw_write_blk(channel, data,
-				       cache->block, 1, cache->buf);
+/*
+ * Take over the least recently used cache slot for BLOCK.  If the slot
+ * holds a dirty block that cannot be written back, it is left alone and
+ * the error is returned.
+ */
+static errcode_t reuse_cache(io_channel channel,
+			     struct unix_private_data *data,
+			     unsigned long long block,
+			     struct unix_cache **ret_cache)
+{
+	struct unix_cache	*cache = data->lru_tail;
+	unsigned int		hash;
+	errcode_t		retval;
+
+	if (cache->dirty && cache->in_use) {
+		retval = write_evicted_block(channel, data, cache);
 		if (retval)
-			retval2 = retval;
-		else
-			cache->dirty = 0;
+			return retval;
 	}
-	return retval2;
+
+	unhash_cache(data, cache);
+	cache->in_use = 1;
+	cache->dirty = 0;
+	cache->block = block;
+	hash = cache_hash(data, block);
+	cache->hash_next = data->hash[hash];
+	data->hash[hash] = cache;
+	touch_cache(data, cache);
+	*ret_cache = cache;
+	return 0;
 }
 #endif 
 
@@ -473,7 +715,8 @@ static errcode_t unix_open(const char *name, int flags, io_channel *channel)
 
 	memset(data, 0, sizeof(struct unix_private_data));
 	data->magic = EXT2_ET_MAGIC_UNIX_IO_CHANNEL;
-	data->io_stats.num_fields = 2;
+	data->io_stats.num_fields = 5;
+	data->cache_bytes = DEFAULT_CACHE_MB << 20;
 	data->dev = -1;
 
 	open_flags = (flags & IO_FLAG_RW) ? O_RDWR : O_RDONLY;
@@ -644,7 +887,7 @@ static errcode_t unix_read_blk64(io_channel channel, unsigned long long block,
 			       int count, void *buf)
 {
 	struct unix_private_data *data;
-	struct unix_cache *cache, *reuse[READ_DIRECT_SIZE];
+	struct unix_cache *cache;
 	errcode_t	retval;
 	char		*cp;
 	int		i, j;
@@ -656,7 +899,7 @@ static errcode_t unix_read_blk64(io_channel channel, unsigned long long block,
 #ifdef NO_IO_CACHE
 	return raw_read_blk(channel, data, block, count, buf);
 #else
-	if (count < 0 || count > WRITE_DIRECT_SIZE) {
+	if (count < 0 || count > READ_DIRECT_SIZE) {
 		if ((retval = flush_cached_blocks(channel, data, 0)))
 			return retval;
 		return raw_read_blk(channel, data, block, count, buf);
@@ -665,42 +908,35 @@ static errcode_t unix_read_blk64(io_channel channel, unsigned long long block,
 	cp = buf;
 	while (count > 0) {
 		
-		if ((cache = find_cached_block(data, block, &reuse[0]))) {
+		if ((cache = find_cached_block(data, block))) {
 #ifdef DEBUG
 			printf("Using cached block %lu\n", block);
 #endif
+			data->io_stats.cache_hits++;
+			touch_cache(data, cache);
 			memcpy(cp, cache->buf, channel->block_size);
 			count--;
 			block++;
 			cp += channel->block_size;
 			continue;
 		}
-		if (count == 1) {
-			cache = reuse[0];
-			reuse_cache(channel, data, cache, block);
-			if ((retval = raw_read_blk(channel, data, block, 1,
-						   cache->buf))) {
-				cache->in_use = 0;
-				return retval;
-			}
-			memcpy(cp, cache->buf, channel->block_size);
-			return 0;
-		}
 
 		for (i=1; i < count; i++)
-			if (find_cached_block(data, block+i, &reuse[i]))
+			if (find_cached_block(data, block+i))
 				break;
 #ifdef DEBUG
 		printf("Reading %d blocks starting at %lu\n", i, block);
 #endif
+		data->io_stats.cache_misses += i;
 		if ((retval = raw_read_blk(channel, data, block, i, cp)))
 			return retval;
 
 		
 		for (j=0; j < i; j++) {
 			count--;
-			cache = reuse[j];
-			reuse_cache(channel, data, cache, block++);
+			retval = reuse_cache(channel, data, block++, &cache);
+			if (retval)
+				return retval;
 			memcpy(cache->buf, cp, channel->block_size);
 			cp += channel->block_size;
 		}
@@ -719,21 +955,25 @@ static errcode_t unix_write_blk64(io_channel channel, unsigned long long block,
 				int count, const void *buf)
 {
 	struct unix_private_data *data;
-	struct unix_cache *cache, *reuse;
-	errcode_t	retval = 0;
+	struct unix_cache *cache;
+	errcode_t	retval = 0, err;
 	const char	*cp;
 	int		writethrough;
 
 	EXT2_CHECK_MAGIC(channel, EXT2_ET_MAGIC_IO_CHANNEL);
 	data = (struct unix_private_data *) channel->private_data;
 	EXT2_CHECK_MAGIC(data, EXT2_ET_MAGIC_UNIX_IO_CHANNEL);
+	data->io_stats.write_gen++;
 
 #ifdef NO_IO_CACHE
 	return raw_write_blk(channel, data, block, count, buf);
 #else
 	if (count < 0 || count > WRITE_DIRECT_SIZE) {
-		if ((retval = flush_cached_blocks(channel, data, 1)))
+		if ((retval = flush_cached_blocks(channel, data, 0)))
 			return retval;
+		invalidate_cached_range(data, block, (count < 0) ?
+			((unsigned long long) -count + channel->block_size - 1) /
+			channel->block_size : (unsigned long long) count);
 		return raw_write_blk(channel, data, block, count, buf);
 	}
 
@@ -743,11 +983,11 @@ static errcode_t unix_write_blk64(io_channel channel, unsigned long long block,
 
 	cp = buf;
 	while (count > 0) {
-		cache = find_cached_block(data, block, &reuse);
-		if (!cache) {
-			cache = reuse;
-			reuse_cache(channel, data, cache, block);
-		}
+		cache = find_cached_block(data, block);
+		if (cache)
+			touch_cache(data, cache);
+		else if ((err = reuse_cache(channel, data, block, &cache)))
+			return err;
 		memcpy(cache->buf, cp, channel->block_size);
 		cache->dirty = !writethrough;
 		count--;
@@ -781,10 +1021,14 @@ static errcode_t unix_write_byte(io_channel channel, unsigned long offset,
 #endif
 		return EXT2_ET_UNIMPLEMENTED;
 	}
+	data->io_stats.write_gen++;
 
 #ifndef NO_IO_CACHE
-	if ((retval = flush_cached_blocks(channel, data, 1)))
+	if ((retval = flush_cached_blocks(channel, data, 0)))
 		return retval;
+	invalidate_cached_range(data, offset / channel->block_size,
+				(offset % channel->block_size + size +
+				 channel->block_size - 1) / channel->block_size);
 #endif
 
 	if (lseek(data->dev, offset + data->offset, SEEK_SET) < 0)
@@ -817,7 +1061,9 @@ static errcode_t unix_set_option(io_channel channel, const char *option,
 				 const char *arg)
 {
 	struct unix_private_data *data;
+	struct unix_private_data new_data;
 	unsigned long long tmp;
+	errcode_t retval;
 	char *end;
 
 	EXT2_CHECK_MAGIC(channel, EXT2_ET_MAGIC_IO_CHANNEL);
@@ -836,6 +1082,54 @@ static errcode_t unix_set_option(io_channel channel, const char *option,
 			return EXT2_ET_INVALID_ARGUMENT;
 		return 0;
 	}
+	if (!strcmp(option, "cache_size")) {
+		if (!arg)
+			return EXT2_ET_INVALID_ARGUMENT;
+
+		tmp = strtoull(arg, &end, 0);
+		if (*end || tmp > MAX_CACHE_MB)
+			return EXT2_ET_INVALID_ARGUMENT;
+#ifndef NO_IO_CACHE
+		if ((retval = flush_cached_blocks(channel, data, 0)))
+			return retval;
+#endif
+		/*
+		 * Build the new cache in a copy of the private data, so
+		 * that the old one is kept if the allocation fails.
+		 */
+		new_data = *data;
+		new_data.cache_bytes = tmp << 20;
+		new_data.cache = 0;
+		new_data.hash = 0;
+		new_data.dirty = 0;
+		new_data.cache_buf = 0;
+		new_data.write_buf = 0;
+		new_data.bounce = 0;
+		retval = alloc_cache(channel, &new_data);
+		if (retval) {
+			free_cache(&new_data);
+			return retval;
+		}
+		free_cache(data);
+		*data = new_data;
+		return 0;
+	}
+	if (!strcmp(option, "writethrough")) {
+		if (!arg)
+			return EXT2_ET_INVALID_ARGUMENT;
+		if (!strcmp(arg, "off")) {
+			channel->flags &= ~CHANNEL_FLAGS_WRITETHROUGH;
+			return 0;
+		}
+		if (strcmp(arg, "on"))
+			return EXT2_ET_INVALID_ARGUMENT;
+#ifndef NO_IO_CACHE
+		if ((retval = flush_cached_blocks(channel, data, 0)))
+			return retval;
+#endif
+		channel->flags |= CHANNEL_FLAGS_WRITETHROUGH;
+		return 0;
+	}
 	return EXT2_ET_INVALID_ARGUMENT;
 }
 
@@ -879,7 +1173,29 @@ static errcode_t unix_discard(io_channel channel, unsigned long long block,
 			goto unimplemented;
 		return errno;
 	}
+	data->io_stats.write_gen++;
 	return 0;
 unimplemented:
 	return EXT2_ET_UNIMPLEMENTED;
 }
+
+static errcode_t unix_cache_readahead(io_channel channel,
+				      unsigned long long block,
+				      unsigned long long count)
+{
+#if defined(HAVE_POSIX_FADVISE) && defined(POSIX_FADV_WILLNEED)
+	struct unix_private_data *data;
+
+	EXT2_CHECK_MAGIC(channel, EXT2_ET_MAGIC_IO_CHANNEL);
+	data = (struct unix_private_data *) channel->private_data;
+	EXT2_CHECK_MAGIC(data, EXT2_ET_MAGIC_UNIX_IO_CHANNEL);
+
+	return posix_fadvise(data->dev,
+			     (ext2_loff_t) block * channel->block_size +
+			     data->offset,
+			     (ext2_loff_t) count * channel->block_size,
+			     POSIX_FADV_WILLNEED);
+#else
+	return EXT2_ET_OP_NOT_SUPPORTED;
+#endif
+}
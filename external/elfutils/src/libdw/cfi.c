@@ -457,7 +457,17 @@ internal_function
 __libdw_frame_at_address (Dwarf_CFI *cache, struct dwarf_fde *fde,
 			  Dwarf_Addr address, Dwarf_Frame **frame)
 {
-  int result = cie_cache_initial_state (cache, fde->cie);
+  rwlock_rdlock (cache->lock);
+  bool have_initial_state = fde->cie->initial_state != NULL;
+  rwlock_unlock (cache->lock);
+
+  int result = DWARF_E_NOERROR;
+  if (unlikely (! have_initial_state))
+    {
+      rwlock_wrlock (cache->lock);
+      result = cie_cache_initial_state (cache, fde->cie);
+      rwlock_unlock (cache->lock);
+    }
   if (likely (result == DWARF_E_NOERROR))
     {
       Dwarf_Frame *fs = duplicate_frame_state (fde->cie->initial_state, NULL);
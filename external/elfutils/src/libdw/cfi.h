@@ -68,6 +68,14 @@ struct dwarf_fde
   const uint8_t *instructions_end;
 };
 
+struct dwarf_frame_cache_entry
+{
+  Dwarf_Addr address;
+  Dwarf_Frame *frame;
+};
+
+#define CFI_FRAME_CACHE_SIZE	1024
+
 struct Dwarf_CFI_s
 {
   
@@ -98,12 +106,21 @@ struct Dwarf_CFI_s
   struct ebl *ebl;
 
   
+  rwlock_define (, lock);
+
+  
   const uint8_t *search_table;
   Dwarf_Addr search_table_vaddr;
   size_t search_table_entries;
   uint8_t search_table_encoding;
 
   
+  Dwarf_Addr *search_table_addrs;
+
+  
+  struct dwarf_frame_cache_entry *frame_cache;
+
+  
   bool other_byte_order;
 
   bool default_same_value;
@@ -44,13 +44,6 @@
 
 #include "libdwP.h"
 
-#if USE_ZLIB
-# include <endian.h>
-# define crc32		loser_crc32
-# include <zlib.h>
-# undef crc32
-#endif
-
 
 static const char dwarf_scnnames[IDX_last][18] =
 {
@@ -94,7 +87,6 @@ check_section (Dwarf *result, GElf_Ehdr *ehdr, Elf_Scn *scn, bool inscngrp)
   if (scnname == NULL)
     {
     err:
-      __libdw_free_zdata (result);
       Dwarf_Sig8_Hash_free (&result->sig8_hash);
       __libdw_seterrno (DWARF_E_INVALID_ELF);
       free (result);
@@ -103,93 +95,44 @@ check_section (Dwarf *result, GElf_Ehdr *ehdr, Elf_Scn *scn, bool inscngrp)
 
   
   size_t cnt;
+  bool gnu_compressed = false;
   for (cnt = 0; cnt < ndwarf_scnnames; ++cnt)
-    if (strcmp (scnname, dwarf_scnnames[cnt]) == 0)
-      {
-	
-	if (unlikely (result->sectiondata[cnt] != NULL))
-	  
+    {
+      if (strcmp (scnname, dwarf_scnnames[cnt]) == 0)
+	break;
+      else if (scnname[0] == '.' && scnname[1] == 'z'
+	       && strcmp (&scnname[2], &dwarf_scnnames[cnt][1]) == 0)
+	{
+	  gnu_compressed = true;
 	  break;
+	}
+    }
 
-	
-	Elf_Data *data = elf_getdata (scn, NULL);
-	if (data != NULL && data->d_size != 0)
-	  
-	  result->sectiondata[cnt] = data;
+  if (cnt >= ndwarf_scnnames)
+    
+    return result;
 
-	break;
-      }
-#if USE_ZLIB
-    else if (scnname[0] == '.' && scnname[1] == 'z'
-	     && strcmp (&scnname[2], &dwarf_scnnames[cnt][1]) == 0)
-      {
-	
-
-	if (unlikely (result->sectiondata[cnt] != NULL))
-	  
-	  break;
+  if (unlikely (result->sectiondata[cnt] != NULL))
+    
+    return result;
 
-	
-	Elf_Data *data = elf_getdata (scn, NULL);
-	if (data != NULL && data->d_size != 0)
-	  {
-
-	    if (unlikely (data->d_size < 4 + 8)
-		|| unlikely (memcmp (data->d_buf, "ZLIB", 4) != 0))
-	      break;
-
-	    uint64_t size;
-	    memcpy (&size, data->d_buf + 4, sizeof size);
-	    size = be64toh (size);
-
-	    if (unlikely (sizeof (Elf_Data) + size < size))
-	      break;
-
-	    Elf_Data *zdata = malloc (sizeof (Elf_Data) + size);
-	    if (unlikely (zdata == NULL))
-	      break;
-
-	    zdata->d_buf = &zdata[1];
-	    zdata->d_type = ELF_T_BYTE;
-	    zdata->d_version = EV_CURRENT;
-	    zdata->d_size = size;
-	    zdata->d_off = 0;
-	    zdata->d_align = 1;
-
-	    z_stream z =
-	      {
-		.next_in = data->d_buf + 4 + 8,
-		.avail_in = data->d_size - 4 - 8,
-		.next_out = zdata->d_buf,
-		.avail_out = zdata->d_size
-	      };
-	    int zrc = inflateInit (&z);
-	    while (z.avail_in > 0 && likely (zrc == Z_OK))
-	      {
-		z.next_out = zdata->d_buf + (zdata->d_size - z.avail_out);
-		zrc = inflate (&z, Z_FINISH);
-		if (unlikely (zrc != Z_STREAM_END))
-		  {
-		    zrc = Z_DATA_ERROR;
-		    break;
-		  }
-		zrc = inflateReset (&z);
-	      }
-	    if (likely (zrc == Z_OK))
-	      zrc = inflateEnd (&z);
-
-	    if (unlikely (zrc != Z_OK) || unlikely (z.avail_out != 0))
-	      free (zdata);
-	    else
-	      {
-		result->sectiondata[cnt] = zdata;
-		result->sectiondata_gzip_mask |= 1U << cnt;
-	      }
-	  }
+  
+  if ((shdr->sh_flags & SHF_COMPRESSED) != 0)
+    {
+      if (elf_compress (scn, 0, 0) < 0)
+	return result;
+    }
+  else if (gnu_compressed)
+    {
+      if (elf_compress_gnu (scn, 0, 0) < 0)
+	return result;
+    }
 
-	break;
-      }
-#endif
+  
+  Elf_Data *data = elf_getdata (scn, NULL);
+  if (data != NULL && data->d_size != 0)
+    
+    result->sectiondata[cnt] = data;
 
   return result;
 }
@@ -201,7 +144,6 @@ valid_p (Dwarf *result)
   if (likely (result != NULL)
       && unlikely (result->sectiondata[IDX_debug_info] == NULL))
     {
-      __libdw_free_zdata (result);
       Dwarf_Sig8_Hash_free (&result->sig8_hash);
       __libdw_seterrno (DWARF_E_NO_DWARF);
       free (result);
@@ -213,7 +155,6 @@ valid_p (Dwarf *result)
       result->fake_loc_cu = (Dwarf_CU *) calloc (1, sizeof (Dwarf_CU));
       if (unlikely (result->fake_loc_cu == NULL))
 	{
-	  __libdw_free_zdata (result);
 	  Dwarf_Sig8_Hash_free (&result->sig8_hash);
 	  __libdw_seterrno (DWARF_E_NOMEM);
 	  free (result);
@@ -227,6 +168,8 @@ valid_p (Dwarf *result)
 	  result->fake_loc_cu->endp
 	    = (result->sectiondata[IDX_debug_loc]->d_buf
 	       + result->sectiondata[IDX_debug_loc]->d_size);
+	  rwlock_init (result->fake_loc_cu->abbrev_lock);
+	  rwlock_init (result->fake_loc_cu->lock);
 	}
     }
 
@@ -253,7 +196,6 @@ scngrp_read (Dwarf *result, Elf *elf, GElf_Ehdr *ehdr, Elf_Scn *scngrp)
   if (data == NULL)
     {
       
-      __libdw_free_zdata (result);
       Dwarf_Sig8_Hash_free (&result->sig8_hash);
       free (result);
       return NULL;
@@ -266,7 +208,6 @@ scngrp_read (Dwarf *result, Elf *elf, GElf_Ehdr *ehdr, Elf_Scn *scngrp)
       Elf_Scn *scn = elf_getscn (elf, scnidx[cnt]);
       if (scn == NULL)
 	{
-	  __libdw_free_zdata (result);
 	  Dwarf_Sig8_Hash_free (&result->sig8_hash);
 	  __libdw_seterrno (DWARF_E_INVALID_ELF);
 	  free (result);
@@ -307,7 +248,7 @@ dwarf_begin_elf (elf, cmd, scngrp)
   size_t mem_default_size = sysconf (_SC_PAGESIZE) - 4 * sizeof (void *);
 
   
-  Dwarf *result = (Dwarf *) calloc (1, sizeof (Dwarf) + mem_default_size);
+  Dwarf *result = (Dwarf *) calloc (1, sizeof (Dwarf));
   if (unlikely (result == NULL)
       || unlikely (Dwarf_Sig8_Hash_init (&result->sig8_hash, 11) < 0))
     {
@@ -326,11 +267,8 @@ dwarf_begin_elf (elf, cmd, scngrp)
   
   result->mem_default_size = mem_default_size;
   result->oom_handler = __libdw_oom;
-  result->mem_tail = (struct libdw_memblock *) (result + 1);
-  result->mem_tail->size = (result->mem_default_size
-			    - offsetof (struct libdw_memblock, mem));
-  result->mem_tail->remaining = result->mem_tail->size;
-  result->mem_tail->prev = NULL;
+  rwlock_init (result->mem_rwl);
+  rwlock_init (result->lock);
 
   if (cmd == DWARF_C_READ || cmd == DWARF_C_RDWR)
     {
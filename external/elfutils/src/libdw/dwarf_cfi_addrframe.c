@@ -31,6 +31,66 @@
 #endif
 
 #include "cfi.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+static inline size_t
+frame_cache_slot (Dwarf_Addr address)
+{
+  return (address ^ (address >> 10)) & (CFI_FRAME_CACHE_SIZE - 1);
+}
+
+static Dwarf_Frame *
+copy_frame (const Dwarf_Frame *frame)
+{
+  size_t size = offsetof (Dwarf_Frame, regs[frame->nregs]);
+  Dwarf_Frame *copy = malloc (size);
+  if (likely (copy != NULL))
+    memcpy (copy, frame, size);
+  return copy;
+}
+
+static Dwarf_Frame *
+frame_cache_lookup (Dwarf_CFI *cache, Dwarf_Addr address)
+{
+  Dwarf_Frame *result = NULL;
+  rwlock_rdlock (cache->lock);
+  if (cache->frame_cache != NULL)
+    {
+      struct dwarf_frame_cache_entry *entry
+	= &cache->frame_cache[frame_cache_slot (address)];
+      if (entry->frame != NULL && entry->address == address)
+	result = copy_frame (entry->frame);
+    }
+  rwlock_unlock (cache->lock);
+  return result;
+}
+
+static void
+frame_cache_insert (Dwarf_CFI *cache, Dwarf_Addr address,
+		    const Dwarf_Frame *frame)
+{
+  Dwarf_Frame *copy = copy_frame (frame);
+  if (unlikely (copy == NULL))
+    return;
+
+  rwlock_wrlock (cache->lock);
+  if (cache->frame_cache == NULL)
+    cache->frame_cache = calloc (CFI_FRAME_CACHE_SIZE,
+				 sizeof cache->frame_cache[0]);
+  if (likely (cache->frame_cache != NULL))
+    {
+      struct dwarf_frame_cache_entry *entry
+	= &cache->frame_cache[frame_cache_slot (address)];
+      free (entry->frame);
+      entry->address = address;
+      entry->frame = copy;
+      copy = NULL;
+    }
+  rwlock_unlock (cache->lock);
+  free (copy);
+}
 
 int
 dwarf_cfi_addrframe (cache, address, frame)
@@ -42,6 +102,14 @@ dwarf_cfi_addrframe (cache, address, frame)
   if (cache == NULL)
     return -1;
 
+  
+  Dwarf_Frame *cached = frame_cache_lookup (cache, address);
+  if (cached != NULL)
+    {
+      *frame = cached;
+      return 0;
+    }
+
   struct dwarf_fde *fde = __libdw_find_fde (cache, address);
   if (fde == NULL)
     return -1;
@@ -52,6 +120,8 @@ dwarf_cfi_addrframe (cache, address, frame)
       __libdw_seterrno (error);
       return -1;
     }
+
+  frame_cache_insert (cache, address, *frame);
   return 0;
 }
 INTDEF (dwarf_cfi_addrframe)
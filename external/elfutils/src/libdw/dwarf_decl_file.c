@@ -56,30 +56,20 @@ dwarf_decl_file (Dwarf_Die *die)
 
   
   struct Dwarf_CU *cu = die->cu;
-  if (cu->lines == NULL)
-    {
-      Dwarf_Lines *lines;
-      size_t nlines;
-
-      (void) INTUSE(dwarf_getsrclines) (&CUDIE (cu), &lines, &nlines);
-      assert (cu->lines != NULL);
-    }
-
-  if (cu->lines == (void *) -1l)
+  Dwarf_Files *files;
+  if (INTUSE(dwarf_getsrcfiles) (&CUDIE (cu), &files, NULL) != 0)
     {
       __libdw_seterrno (DWARF_E_INVALID_DWARF);
       return NULL;
     }
 
-  assert (cu->files != NULL && cu->files != (void *) -1l);
-
-  if (idx >= cu->files->nfiles)
+  if (idx >= files->nfiles)
     {
       __libdw_seterrno (DWARF_E_INVALID_DWARF);
       return NULL;
     }
 
-  return cu->files->info[idx].name;
+  return files->info[idx].name;
 }
 OLD_VERSION (dwarf_decl_file, ELFUTILS_0.122)
 NEW_VERSION (dwarf_decl_file, ELFUTILS_0.143)
@@ -54,26 +54,11 @@ cu_free (void *arg)
   Dwarf_Abbrev_Hash_free (&p->abbrev_hash);
 
   tdestroy (p->locs, noop_free);
-}
-
 
-#if USE_ZLIB
-void
-internal_function
-__libdw_free_zdata (Dwarf *dwarf)
-{
-  unsigned int gzip_mask = dwarf->sectiondata_gzip_mask;
-  while (gzip_mask != 0)
-    {
-      int i = ffs (gzip_mask);
-      assert (i > 0);
-      --i;
-      assert (i < IDX_last);
-      free (dwarf->sectiondata[i]);
-      gzip_mask &= ~(1U << i);
-    }
+  rwlock_fini (p->abbrev_lock);
+  rwlock_fini (p->lock);
 }
-#endif
+
 
 int
 dwarf_end (dwarf)
@@ -96,26 +81,40 @@ dwarf_end (dwarf)
       
       tdestroy (dwarf->files_lines, noop_free);
 
-      struct libdw_memblock *memp = dwarf->mem_tail;
-      
-      while (memp->prev != NULL)
+      for (size_t i = 0; i < LIBDW_MEM_CHUNKS; ++i)
 	{
-	  struct libdw_memblock *prevp = memp->prev;
-	  free (memp);
-	  memp = prevp;
+	  if (dwarf->mem_tails[i] == NULL)
+	    continue;
+	  for (size_t j = 0; j < (size_t) LIBDW_MEM_CHUNK0 << i; ++j)
+	    {
+	      struct libdw_memblock *memp = dwarf->mem_tails[i][j];
+	      while (memp != NULL)
+		{
+		  struct libdw_memblock *prevp = memp->prev;
+		  free (memp);
+		  memp = prevp;
+		}
+	    }
+	  free (dwarf->mem_tails[i]);
 	}
+      rwlock_fini (dwarf->mem_rwl);
 
       
       free (dwarf->pubnames_sets);
 
-      __libdw_free_zdata (dwarf);
-
       
       if (dwarf->free_elf)
 	elf_end (dwarf->elf);
 
       
-      free (dwarf->fake_loc_cu);
+      if (dwarf->fake_loc_cu != NULL)
+	{
+	  rwlock_fini (dwarf->fake_loc_cu->abbrev_lock);
+	  rwlock_fini (dwarf->fake_loc_cu->lock);
+	  free (dwarf->fake_loc_cu);
+	}
+
+      rwlock_fini (dwarf->lock);
 
       
       free (dwarf);
@@ -75,21 +75,29 @@ dwarf_formref_die (attr, result)
   if (attr->form == DW_FORM_ref_sig8)
     {
 
-      uint64_t sig = read_8ubyte_unaligned (cu->dbg, attr->valp);
-      cu = Dwarf_Sig8_Hash_find (&cu->dbg->sig8_hash, sig, NULL);
+      Dwarf *dbg = cu->dbg;
+      uint64_t sig = read_8ubyte_unaligned (dbg, attr->valp);
+      rwlock_rdlock (dbg->lock);
+      cu = Dwarf_Sig8_Hash_find (&dbg->sig8_hash, sig, NULL);
+      rwlock_unlock (dbg->lock);
       if (cu == NULL)
-	
-	do
-	  {
-	    cu = __libdw_intern_next_unit (attr->cu->dbg, true);
-	    if (cu == NULL)
-	      {
-		__libdw_seterrno (INTUSE(dwarf_errno) ()
-				  ?: DWARF_E_INVALID_REFERENCE);
-		return NULL;
-	      }
-	  }
-	while (cu->type_sig8 != sig);
+	{
+	  rwlock_wrlock (dbg->lock);
+	  cu = Dwarf_Sig8_Hash_find (&dbg->sig8_hash, sig, NULL);
+	  
+	  while (cu == NULL || cu->type_sig8 != sig)
+	    {
+	      cu = __libdw_intern_next_unit (dbg, true);
+	      if (cu == NULL)
+		{
+		  rwlock_unlock (dbg->lock);
+		  __libdw_seterrno (INTUSE(dwarf_errno) ()
+				    ?: DWARF_E_INVALID_REFERENCE);
+		  return NULL;
+		}
+	    }
+	  rwlock_unlock (dbg->lock);
+	}
 
       datap = cu->dbg->sectiondata[IDX_debug_types]->d_buf;
       size = cu->dbg->sectiondata[IDX_debug_types]->d_size;
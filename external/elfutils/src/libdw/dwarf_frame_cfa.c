@@ -60,11 +60,13 @@ dwarf_frame_cfa (fs, ops, nops)
 
     case cfa_expr:
       
+      rwlock_wrlock (fs->cache->lock);
       result = __libdw_intern_expression
 	(NULL, fs->cache->other_byte_order,
 	 fs->cache->e_ident[EI_CLASS] == ELFCLASS32 ? 4 : 8, 4,
 	 &fs->cache->expr_tree, &fs->cfa_data.expr, false, false,
 	 ops, nops, IDX_debug_frame);
+      rwlock_unlock (fs->cache->lock);
       break;
 
     case cfa_invalid:
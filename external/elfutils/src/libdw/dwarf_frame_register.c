@@ -108,12 +108,16 @@ dwarf_frame_register (fs, regno, ops_mem, ops, nops)
 	block.data = (void *) p;
 
 	
-	if (__libdw_intern_expression (NULL,
-				       fs->cache->other_byte_order,
-				       address_size, 4,
-				       &fs->cache->expr_tree, &block,
-				       true, reg->rule == reg_val_expression,
-				       ops, nops, IDX_debug_frame) < 0)
+	rwlock_wrlock (fs->cache->lock);
+	int result = __libdw_intern_expression (NULL,
+						fs->cache->other_byte_order,
+						address_size, 4,
+						&fs->cache->expr_tree, &block,
+						true,
+						reg->rule == reg_val_expression,
+						ops, nops, IDX_debug_frame);
+	rwlock_unlock (fs->cache->lock);
+	if (result < 0)
 	  return -1;
 	break;
       }
@@ -138,7 +138,11 @@ dwarf_getabbrev (die, offset, lengthp)
      Dwarf_Off offset;
      size_t *lengthp;
 {
-  return __libdw_getabbrev (die->cu->dbg, die->cu,
-			    die->cu->orig_abbrev_offset + offset, lengthp,
-			    NULL);
+  struct Dwarf_CU *cu = die->cu;
+  rwlock_wrlock (cu->abbrev_lock);
+  Dwarf_Abbrev *result = __libdw_getabbrev (cu->dbg, cu,
+					    cu->orig_abbrev_offset + offset,
+					    lengthp, NULL);
+  rwlock_unlock (cu->abbrev_lock);
+  return result;
 }
@@ -61,11 +61,14 @@ dwarf_getaranges (dbg, aranges, naranges)
   if (dbg == NULL)
     return -1;
 
-  if (dbg->aranges != NULL)
+  rwlock_rdlock (dbg->lock);
+  Dwarf_Aranges *cached = dbg->aranges;
+  rwlock_unlock (dbg->lock);
+  if (cached != NULL)
     {
-      *aranges = dbg->aranges;
+      *aranges = cached;
       if (naranges != NULL)
-	*naranges = dbg->aranges->naranges;
+	*naranges = cached->naranges;
       return 0;
     }
 
@@ -221,9 +224,6 @@ dwarf_getaranges (dbg, aranges, naranges)
   *aranges = buf;
   (*aranges)->dbg = dbg;
   (*aranges)->naranges = narangelist;
-  dbg->aranges = *aranges;
-  if (naranges != NULL)
-    *naranges = narangelist;
   for (i = 0; i < narangelist; ++i)
     {
       struct arangelist *elt = sortaranges[i];
@@ -231,6 +231,15 @@ dwarf_getaranges (dbg, aranges, naranges)
       free (elt);
     }
 
+  rwlock_wrlock (dbg->lock);
+  if (dbg->aranges == NULL)
+    dbg->aranges = *aranges;
+  else
+    *aranges = dbg->aranges;
+  rwlock_unlock (dbg->lock);
+  if (naranges != NULL)
+    *naranges = (*aranges)->naranges;
+
   return 0;
 }
 INTDEF(dwarf_getaranges)
@@ -41,6 +41,13 @@ dwarf_getcfi (dbg)
   if (dbg == NULL)
     return NULL;
 
+  rwlock_rdlock (dbg->lock);
+  Dwarf_CFI *result = dbg->cfi;
+  rwlock_unlock (dbg->lock);
+  if (result != NULL)
+    return result;
+
+  rwlock_wrlock (dbg->lock);
   if (dbg->cfi == NULL && dbg->sectiondata[IDX_debug_frame] != NULL)
     {
       Dwarf_CFI *cfi = libdw_typed_alloc (dbg, Dwarf_CFI);
@@ -52,6 +59,8 @@ dwarf_getcfi (dbg)
       cfi->search_table_vaddr = 0;
       cfi->search_table_entries = 0;
       cfi->search_table_encoding = DW_EH_PE_omit;
+      cfi->search_table_addrs = NULL;
+      cfi->frame_cache = NULL;
 
       cfi->frame_vaddr = 0;
       cfi->textrel = 0;
@@ -64,10 +73,13 @@ dwarf_getcfi (dbg)
       cfi->cie_tree = cfi->fde_tree = cfi->expr_tree = NULL;
 
       cfi->ebl = NULL;
+      rwlock_init (cfi->lock);
 
       dbg->cfi = cfi;
     }
+  result = dbg->cfi;
+  rwlock_unlock (dbg->lock);
 
-  return dbg->cfi;
+  return result;
 }
 INTDEF (dwarf_getcfi)
@@ -65,6 +65,7 @@ allocate_cfi (Elf *elf, GElf_Addr vaddr)
   cfi->frame_vaddr = vaddr;
   cfi->textrel = 0;		
   cfi->datarel = 0;		
+  rwlock_init (cfi->lock);
 
   return cfi;
 }
@@ -120,15 +120,18 @@ dwarf_getlocation_implicit_value (attr, op, return_block)
     return -1;
 
   struct loc_block_s fake = { .addr = (void *) op };
+  rwlock_rdlock (attr->cu->lock);
   struct loc_block_s **found = tfind (&fake, &attr->cu->locs, loc_compare);
-  if (unlikely (found == NULL))
+  struct loc_block_s *block = found != NULL ? *found : NULL;
+  rwlock_unlock (attr->cu->lock);
+  if (unlikely (block == NULL))
     {
       __libdw_seterrno (DWARF_E_NO_BLOCK);
       return -1;
     }
 
-  return_block->length = (*found)->length;
-  return_block->data = (*found)->data;
+  return_block->length = block->length;
+  return_block->data = block->data;
   return 0;
 }
 
@@ -156,13 +159,17 @@ check_constant_offset (Dwarf_Attribute *attr,
 
   
   struct loc_s fake = { .addr = attr->valp };
+  rwlock_wrlock (attr->cu->lock);
   struct loc_s **found = tfind (&fake, &attr->cu->locs, loc_compare);
 
   if (found == NULL)
     {
       Dwarf_Word offset;
       if (INTUSE(dwarf_formudata) (attr, &offset) != 0)
-	return -1;
+	{
+	  rwlock_unlock (attr->cu->lock);
+	  return -1;
+	}
 
       Dwarf_Op *result = libdw_alloc (attr->cu->dbg,
 				      Dwarf_Op, sizeof (Dwarf_Op), 1);
@@ -190,6 +197,7 @@ check_constant_offset (Dwarf_Attribute *attr,
       *llbuf = (*found)->loc;
       *listlen = 1;
     }
+  rwlock_unlock (attr->cu->lock);
 
   return 0;
 }
@@ -551,13 +559,17 @@ getlocation (struct Dwarf_CU *cu, const Dwarf_Block *block,
       return 0;
     }
 
-  return __libdw_intern_expression (cu->dbg, cu->dbg->other_byte_order,
-				    cu->address_size, (cu->version == 2
-						       ? cu->address_size
-						       : cu->offset_size),
-				    &cu->locs, block,
-				    false, false,
-				    llbuf, listlen, sec_index);
+  rwlock_wrlock (cu->lock);
+  int result = __libdw_intern_expression (cu->dbg, cu->dbg->other_byte_order,
+					  cu->address_size,
+					  (cu->version == 2
+					   ? cu->address_size
+					   : cu->offset_size),
+					  &cu->locs, block,
+					  false, false,
+					  llbuf, listlen, sec_index);
+  rwlock_unlock (cu->lock);
+  return result;
 }
 
 int
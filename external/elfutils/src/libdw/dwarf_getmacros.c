@@ -256,10 +256,13 @@ cache_op_table (Dwarf *dbg, int sec_index, Dwarf_Off macoff,
 		Dwarf_Die *cudie)
 {
   Dwarf_Macro_Op_Table fake = { .offset = macoff, .sec_index = sec_index };
+  rwlock_rdlock (dbg->lock);
   Dwarf_Macro_Op_Table **found = tfind (&fake, &dbg->macro_ops,
 					macro_op_compare);
-  if (found != NULL)
-    return *found;
+  Dwarf_Macro_Op_Table *cached = found != NULL ? *found : NULL;
+  rwlock_unlock (dbg->lock);
+  if (cached != NULL)
+    return cached;
 
   Dwarf_Macro_Op_Table *table = sec_index == IDX_debug_macro
     ? get_table_for_offset (dbg, macoff, startp, endp, cudie)
@@ -268,15 +271,18 @@ cache_op_table (Dwarf *dbg, int sec_index, Dwarf_Off macoff,
   if (table == NULL)
     return NULL;
 
+  rwlock_wrlock (dbg->lock);
   Dwarf_Macro_Op_Table **ret = tsearch (table, &dbg->macro_ops,
 					macro_op_compare);
-  if (unlikely (ret == NULL))
+  table = ret != NULL ? *ret : NULL;
+  rwlock_unlock (dbg->lock);
+  if (unlikely (table == NULL))
     {
       __libdw_seterrno (DWARF_E_NOMEM);
       return NULL;
     }
 
-  return *ret;
+  return table;
 }
 
 static ptrdiff_t
@@ -44,27 +44,23 @@ dwarf_getsrcfiles (Dwarf_Die *cudie, Dwarf_Files **files, size_t *nfiles)
 		    && INTUSE(dwarf_tag) (cudie) != DW_TAG_partial_unit)))
     return -1;
 
-  int res = -1;
+  Dwarf_Lines *lines;
+  size_t nlines;
 
   
   struct Dwarf_CU *const cu = cudie->cu;
-  if (cu->lines == NULL)
-    {
-      Dwarf_Lines *lines;
-      size_t nlines;
-
-      res = INTUSE(dwarf_getsrclines) (cudie, &lines, &nlines);
-    }
-  else if (cu->files != (void *) -1l)
-    
-    res = 0;
+  int res = INTUSE(dwarf_getsrclines) (cudie, &lines, &nlines);
 
   if (likely (res == 0))
     {
-      assert (cu->files != NULL && cu->files != (void *) -1l);
-      *files = cu->files;
+      rwlock_rdlock (cu->lock);
+      Dwarf_Files *cu_files = cu->files;
+      rwlock_unlock (cu->lock);
+
+      assert (cu_files != NULL && cu_files != (void *) -1l);
+      *files = cu_files;
       if (nfiles != NULL)
-	*nfiles = cu->files->nfiles;
+	*nfiles = cu_files->nfiles;
     }
 
   
@@ -724,9 +724,12 @@ __libdw_getsrclines (Dwarf *dbg, Dwarf_Off debug_line_offset,
 		     Dwarf_Lines **linesp, Dwarf_Files **filesp)
 {
   struct files_lines_s fake = { .debug_line_offset = debug_line_offset };
+  rwlock_rdlock (dbg->lock);
   struct files_lines_s **found = tfind (&fake, &dbg->files_lines,
 					files_lines_compare);
-  if (found == NULL)
+  struct files_lines_s *result = found != NULL ? *found : NULL;
+  rwlock_unlock (dbg->lock);
+  if (result == NULL)
     {
       Elf_Data *data = __libdw_checked_get_data (dbg, IDX_debug_line);
       if (data == NULL
@@ -746,8 +749,11 @@ __libdw_getsrclines (Dwarf *dbg, Dwarf_Off debug_line_offset,
 
       node->debug_line_offset = debug_line_offset;
 
+      rwlock_wrlock (dbg->lock);
       found = tsearch (node, &dbg->files_lines, files_lines_compare);
-      if (found == NULL)
+      result = found != NULL ? *found : NULL;
+      rwlock_unlock (dbg->lock);
+      if (result == NULL)
 	{
 	  __libdw_seterrno (DWARF_E_NOMEM);
 	  return -1;
@@ -755,10 +761,10 @@ __libdw_getsrclines (Dwarf *dbg, Dwarf_Off debug_line_offset,
     }
 
   if (linesp != NULL)
-    *linesp = (*found)->lines;
+    *linesp = result->lines;
 
   if (filesp != NULL)
-    *filesp = (*found)->files;
+    *filesp = result->files;
 
   return 0;
 }
@@ -783,34 +789,50 @@ dwarf_getsrclines (Dwarf_Die *cudie, Dwarf_Lines **lines, size_t *nlines)
 
   
   struct Dwarf_CU *const cu = cudie->cu;
-  if (cu->lines == NULL)
-    {
-      
-      cu->lines = (void *) -1l;
-      cu->files = (void *) -1l;
+  rwlock_rdlock (cu->lock);
+  Dwarf_Lines *cu_lines = cu->lines;
+  rwlock_unlock (cu->lock);
 
-      
-      Dwarf_Attribute stmt_list_mem;
-      Dwarf_Attribute *stmt_list = INTUSE(dwarf_attr) (cudie, DW_AT_stmt_list,
-						       &stmt_list_mem);
+  if (cu_lines == NULL)
+    {
+      rwlock_wrlock (cu->lock);
+      if (cu->lines == NULL)
+	{
+	  
+	  Dwarf_Lines *new_lines = (void *) -1l;
+	  Dwarf_Files *new_files = (void *) -1l;
 
-      Dwarf_Off debug_line_offset;
-      if (__libdw_formptr (stmt_list, IDX_debug_line, DWARF_E_NO_DEBUG_LINE,
-			   NULL, &debug_line_offset) == NULL)
-	return -1;
+	  
+	  Dwarf_Attribute stmt_list_mem;
+	  Dwarf_Attribute *stmt_list = INTUSE(dwarf_attr) (cudie,
+							   DW_AT_stmt_list,
+							   &stmt_list_mem);
+
+	  Dwarf_Off debug_line_offset;
+	  if (__libdw_formptr (stmt_list, IDX_debug_line,
+			       DWARF_E_NO_DEBUG_LINE, NULL,
+			       &debug_line_offset) == NULL
+	      || __libdw_getsrclines (cu->dbg, debug_line_offset,
+				      __libdw_getcompdir (cudie),
+				      cu->address_size,
+				      &new_lines, &new_files) < 0)
+	    {
+	      new_lines = (void *) -1l;
+	      new_files = (void *) -1l;
+	    }
 
-      if (__libdw_getsrclines (cu->dbg, debug_line_offset,
-			       __libdw_getcompdir (cudie),
-			       cu->address_size, &cu->lines, &cu->files) < 0)
-	return -1;
+	  cu->files = new_files;
+	  cu->lines = new_lines;
+	}
+      cu_lines = cu->lines;
+      rwlock_unlock (cu->lock);
     }
-  else if (cu->lines == (void *) -1l)
-    return -1;
 
-  *lines = cu->lines;
-  *nlines = cu->lines->nlines;
+  if (cu_lines == (void *) -1l)
+    return -1;
 
-  
+  *lines = cu_lines;
+  *nlines = cu_lines->nlines;
 
   return 0;
 }
@@ -45,6 +45,13 @@ __libdw_findabbrev (struct Dwarf_CU *cu, unsigned int code)
     return DWARF_END_ABBREV;
 
   
+  rwlock_rdlock (cu->abbrev_lock);
+  abb = Dwarf_Abbrev_Hash_find (&cu->abbrev_hash, code, NULL);
+  rwlock_unlock (cu->abbrev_lock);
+  if (abb != NULL)
+    return abb;
+
+  rwlock_wrlock (cu->abbrev_lock);
   abb = Dwarf_Abbrev_Hash_find (&cu->abbrev_hash, code, NULL);
   if (abb == NULL)
     while (cu->last_abbrev_offset != (size_t) -1l)
@@ -57,7 +64,8 @@ __libdw_findabbrev (struct Dwarf_CU *cu, unsigned int code)
 	  {
 	    
 	    cu->last_abbrev_offset = (size_t) -1l;
-	    return DWARF_END_ABBREV;
+	    abb = NULL;
+	    break;
 	  }
 
 	cu->last_abbrev_offset += length;
@@ -66,6 +74,7 @@ __libdw_findabbrev (struct Dwarf_CU *cu, unsigned int code)
 	if (abb->code == code)
 	  break;
       }
+  rwlock_unlock (cu->abbrev_lock);
 
   if (unlikely (abb == NULL))
     abb = DWARF_END_ABBREV;
@@ -148,9 +148,59 @@ __libdw_fde_by_offset (Dwarf_CFI *cache, Dwarf_Off offset)
   return fde;
 }
 
+static Dwarf_Addr *
+decode_search_table (Dwarf_CFI *cache)
+{
+  Dwarf_CFI dummy_cfi =
+    {
+      .e_ident = cache->e_ident,
+      .datarel = cache->search_table_vaddr,
+      .frame_vaddr = cache->search_table_vaddr,
+    };
+
+  size_t n = 2 * cache->search_table_entries;
+  Dwarf_Addr *addrs = malloc (n * sizeof addrs[0]);
+  if (unlikely (addrs == NULL))
+    return (void *) -1l;
+
+  const uint8_t *p = cache->search_table;
+  for (size_t i = 0; i < n; ++i)
+    if (unlikely (read_encoded_value (&dummy_cfi,
+				      cache->search_table_encoding, &p,
+				      &addrs[i])))
+      {
+	free (addrs);
+	return (void *) -1l;
+      }
+
+  return addrs;
+}
+
 static Dwarf_Off
 binary_search_fde (Dwarf_CFI *cache, Dwarf_Addr address)
 {
+  
+  if (cache->search_table_addrs == NULL)
+    cache->search_table_addrs = decode_search_table (cache);
+
+  const Dwarf_Addr *addrs = cache->search_table_addrs;
+  if (likely (addrs != (void *) -1l))
+    {
+      size_t l = 0, u = cache->search_table_entries;
+      while (l < u)
+	{
+	  size_t idx = (l + u) / 2;
+	  if (address < addrs[idx * 2])
+	    u = idx;
+	  else if (idx + 1 < cache->search_table_entries
+		   && address >= addrs[idx * 2 + 2])
+	    l = idx + 1;
+	  else
+	    return addrs[idx * 2 + 1] - cache->frame_vaddr;
+	}
+      return (Dwarf_Off) -1l;
+    }
+
   const size_t size = 2 * encoded_value_size (&cache->data->d, cache->e_ident,
 					      cache->search_table_encoding,
 					      NULL);
@@ -205,9 +255,8 @@ binary_search_fde (Dwarf_CFI *cache, Dwarf_Addr address)
   return (Dwarf_Off) -1l;
 }
 
-struct dwarf_fde *
-internal_function
-__libdw_find_fde (Dwarf_CFI *cache, Dwarf_Addr address)
+static struct dwarf_fde *
+find_fde (Dwarf_CFI *cache, Dwarf_Addr address)
 {
   
 
@@ -283,3 +332,22 @@ __libdw_find_fde (Dwarf_CFI *cache, Dwarf_Addr address)
   __libdw_seterrno (DWARF_E_NO_MATCH);
   return NULL;
 }
+
+struct dwarf_fde *
+internal_function
+__libdw_find_fde (Dwarf_CFI *cache, Dwarf_Addr address)
+{
+  const struct dwarf_fde fde_key = { .start = address, .end = 0 };
+  rwlock_rdlock (cache->lock);
+  struct dwarf_fde **found = tfind (&fde_key, &cache->fde_tree, &compare_fde);
+  struct dwarf_fde *fde = found != NULL ? *found : NULL;
+  rwlock_unlock (cache->lock);
+  if (fde != NULL)
+    return fde;
+
+  rwlock_wrlock (cache->lock);
+  fde = find_fde (cache, address);
+  rwlock_unlock (cache->lock);
+
+  return fde;
+}
@@ -63,4 +63,11 @@ __libdw_destroy_frame_cache (Dwarf_CFI *cache)
   tdestroy (cache->fde_tree, free_fde);
   tdestroy (cache->cie_tree, free_cie);
   tdestroy (cache->expr_tree, free_expr);
+  if (cache->search_table_addrs != (void *) -1l)
+    free (cache->search_table_addrs);
+  if (cache->frame_cache != NULL)
+    for (size_t i = 0; i < CFI_FRAME_CACHE_SIZE; ++i)
+      free (cache->frame_cache[i].frame);
+  free (cache->frame_cache);
+  rwlock_fini (cache->lock);
 }
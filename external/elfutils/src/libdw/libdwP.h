@@ -39,6 +39,12 @@
 
 #define _(Str) dgettext ("elfutils", Str)
 
+/* The per-thread memory block chains of a Dwarf are kept in chunks of
+   LIBDW_MEM_CHUNK0, twice that, four times that and so on slots, indexed
+   by thread id.  Chunks never move once allocated.  */
+#define LIBDW_MEM_CHUNK0	16
+#define LIBDW_MEM_CHUNKS	16
+
 
 struct loc_s
 {
@@ -136,11 +142,6 @@ struct Dwarf
   
   Elf_Data *sectiondata[IDX_last];
 
-#if USE_ZLIB
-  
-  unsigned int sectiondata_gzip_mask:IDX_last;
-#endif
-
   
   bool other_byte_order;
 
@@ -179,13 +180,17 @@ struct Dwarf
 
   struct Dwarf_CU *fake_loc_cu;
 
+  
+  rwlock_define (, lock);
+
   struct libdw_memblock
   {
     size_t size;
     size_t remaining;
     struct libdw_memblock *prev;
     char mem[0];
-  } *mem_tail;
+  } **mem_tails[LIBDW_MEM_CHUNKS];
+  rwlock_define (, mem_rwl);
 
   
   size_t mem_default_size;
@@ -281,6 +286,7 @@ struct Dwarf_CU
   size_t orig_abbrev_offset;
   
   size_t last_abbrev_offset;
+  rwlock_define (, abbrev_lock);
 
   
   Dwarf_Lines *lines;
@@ -292,6 +298,9 @@ struct Dwarf_CU
   void *locs;
 
   
+  rwlock_define (, lock);
+
+  
   void *startp;
   void *endp;
 };
@@ -363,7 +372,7 @@ extern void __libdw_seterrno (int value) internal_function;
 
 
 #define libdw_alloc(dbg, type, tsize, cnt) \
-  ({ struct libdw_memblock *_tail = (dbg)->mem_tail;			      \
+  ({ struct libdw_memblock *_tail = __libdw_alloc_tail (dbg);		      \
      size_t _required = (tsize) * (cnt);				      \
      type *_result = (type *) (_tail->mem + (_tail->size - _tail->remaining));\
      size_t _padding = ((__alignof (type)				      \
@@ -382,17 +391,14 @@ extern void __libdw_seterrno (int value) internal_function;
 #define libdw_typed_alloc(dbg, type) \
   libdw_alloc (dbg, type, sizeof (type), 1)
 
+extern struct libdw_memblock *__libdw_alloc_tail (Dwarf *dbg)
+     __nonnull_attribute__ (1) internal_function;
+
 extern void *__libdw_allocate (Dwarf *dbg, size_t minsize, size_t align)
      __attribute__ ((__malloc__)) __nonnull_attribute__ (1);
 
 extern void __libdw_oom (void) __attribute ((noreturn, visibility ("hidden")));
 
-#if USE_ZLIB
-extern void __libdw_free_zdata (Dwarf *dwarf) internal_function;
-#else
-# define __libdw_free_zdata(dwarf)	((void) (dwarf))
-#endif
-
 extern struct Dwarf_CU *__libdw_intern_next_unit (Dwarf *dbg, bool debug_types)
      __nonnull_attribute__ (1) internal_function;
 
@@ -33,11 +33,143 @@
 
 #include <error.h>
 #include <errno.h>
+#include <limits.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <sys/param.h>
 #include "libdwP.h"
 
 
+#define THREAD_ID_UNSET ((size_t) -1)
+static __thread size_t thread_id = THREAD_ID_UNSET;
+static size_t next_thread_id;
+
+#ifdef USE_LOCKS
+/* Ids of exited threads are handed out again, so the per-Dwarf slot
+   tables only grow with the number of threads alive at once.  */
+static pthread_once_t thread_id_once = PTHREAD_ONCE_INIT;
+static pthread_key_t thread_id_key;
+static pthread_mutex_t free_thread_ids_lock = PTHREAD_MUTEX_INITIALIZER;
+static size_t *free_thread_ids;
+static size_t nfree_thread_ids;
+static size_t free_thread_ids_max;
+
+
+static void
+release_thread_id (void *arg)
+{
+  size_t id = (uintptr_t) arg - 1;
+
+  pthread_mutex_lock (&free_thread_ids_lock);
+  if (nfree_thread_ids == free_thread_ids_max)
+    {
+      size_t newmax = free_thread_ids_max * 2 ?: 16;
+      size_t *ids = realloc (free_thread_ids, newmax * sizeof ids[0]);
+      if (ids != NULL)
+	{
+	  free_thread_ids = ids;
+	  free_thread_ids_max = newmax;
+	}
+    }
+  /* If there is no room the id is simply not reused.  */
+  if (nfree_thread_ids < free_thread_ids_max)
+    free_thread_ids[nfree_thread_ids++] = id;
+  pthread_mutex_unlock (&free_thread_ids_lock);
+
+  thread_id = THREAD_ID_UNSET;
+}
+
+
+static void
+create_thread_id_key (void)
+{
+  if (pthread_key_create (&thread_id_key, release_thread_id) != 0)
+    abort ();
+}
+#endif
+
+
+static size_t
+get_thread_id (void)
+{
+  if (unlikely (thread_id == THREAD_ID_UNSET))
+    {
+#ifdef USE_LOCKS
+      pthread_once (&thread_id_once, create_thread_id_key);
+
+      pthread_mutex_lock (&free_thread_ids_lock);
+      if (nfree_thread_ids > 0)
+	thread_id = free_thread_ids[--nfree_thread_ids];
+      else
+	thread_id = next_thread_id++;
+      pthread_mutex_unlock (&free_thread_ids_lock);
+
+      pthread_setspecific (thread_id_key,
+			   (void *) (uintptr_t) (thread_id + 1));
+#else
+      thread_id = next_thread_id++;
+#endif
+    }
+  return thread_id;
+}
+
+
+/* Return this thread's slot in DBG->mem_tails.  Only the owning thread
+   reads or writes a slot, and a chunk is published once and never moved,
+   so only allocating a new chunk takes the lock.  */
+static struct libdw_memblock **
+get_tail_slot (Dwarf *dbg)
+{
+  size_t id = get_thread_id ();
+  size_t chunk = (sizeof (unsigned long) * CHAR_BIT - 1
+		  - __builtin_clzl (id / LIBDW_MEM_CHUNK0 + 1));
+  if (unlikely (chunk >= LIBDW_MEM_CHUNKS))
+    dbg->oom_handler ();
+
+  struct libdw_memblock **tails = __atomic_load_n (&dbg->mem_tails[chunk],
+						    __ATOMIC_ACQUIRE);
+  if (unlikely (tails == NULL))
+    {
+      rwlock_wrlock (dbg->mem_rwl);
+      tails = dbg->mem_tails[chunk];
+      if (tails == NULL)
+	{
+	  tails = calloc ((size_t) LIBDW_MEM_CHUNK0 << chunk, sizeof tails[0]);
+	  if (tails == NULL)
+	    {
+	      rwlock_unlock (dbg->mem_rwl);
+	      dbg->oom_handler ();
+	    }
+	  __atomic_store_n (&dbg->mem_tails[chunk], tails, __ATOMIC_RELEASE);
+	}
+      rwlock_unlock (dbg->mem_rwl);
+    }
+
+  return &tails[id - LIBDW_MEM_CHUNK0 * ((1ul << chunk) - 1)];
+}
+
+
+struct libdw_memblock *
+internal_function
+__libdw_alloc_tail (Dwarf *dbg)
+{
+  struct libdw_memblock **slot = get_tail_slot (dbg);
+  if (likely (*slot != NULL))
+    return *slot;
+
+  struct libdw_memblock *result = malloc (dbg->mem_default_size);
+  if (result == NULL)
+    dbg->oom_handler ();
+  result->size = (dbg->mem_default_size
+		  - offsetof (struct libdw_memblock, mem));
+  result->remaining = result->size;
+  result->prev = NULL;
+  *slot = result;
+
+  return result;
+}
+
+
 void *
 __libdw_allocate (Dwarf *dbg, size_t minsize, size_t align)
 {
@@ -53,8 +185,9 @@ __libdw_allocate (Dwarf *dbg, size_t minsize, size_t align)
   newp->size = size - offsetof (struct libdw_memblock, mem);
   newp->remaining = (uintptr_t) newp + size - (result + minsize);
 
-  newp->prev = dbg->mem_tail;
-  dbg->mem_tail = newp;
+  struct libdw_memblock **slot = get_tail_slot (dbg);
+  newp->prev = *slot;
+  *slot = newp;
 
   return (void *) result;
 }
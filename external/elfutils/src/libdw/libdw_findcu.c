@@ -113,6 +113,8 @@ __libdw_intern_next_unit (dbg, debug_types)
   newp->orig_abbrev_offset = newp->last_abbrev_offset = abbrev_offset;
   newp->lines = NULL;
   newp->locs = NULL;
+  rwlock_init (newp->abbrev_lock);
+  rwlock_init (newp->lock);
 
   if (debug_types)
     Dwarf_Sig8_Hash_insert (&dbg->sig8_hash, type_sig8, newp);
@@ -144,27 +146,37 @@ __libdw_findcu (dbg, start, debug_types)
 
   
   struct Dwarf_CU fake = { .start = start, .end = 0 };
+  rwlock_rdlock (dbg->lock);
   struct Dwarf_CU **found = tfind (&fake, tree, findcu_cb);
-  if (found != NULL)
-    return *found;
+  struct Dwarf_CU *result = found != NULL ? *found : NULL;
+  rwlock_unlock (dbg->lock);
+  if (result != NULL)
+    return result;
 
-  if (start < *next_offset)
-    {
-      __libdw_seterrno (DWARF_E_INVALID_DWARF);
-      return NULL;
-    }
+  rwlock_wrlock (dbg->lock);
 
-  
-  while (1)
-    {
-      struct Dwarf_CU *newp = __libdw_intern_next_unit (dbg, debug_types);
-      if (newp == NULL)
-	return NULL;
+  found = tfind (&fake, tree, findcu_cb);
+  if (found != NULL)
+    result = *found;
+  else if (start < *next_offset)
+    __libdw_seterrno (DWARF_E_INVALID_DWARF);
+  else
+    
+    while (1)
+      {
+	struct Dwarf_CU *newp = __libdw_intern_next_unit (dbg, debug_types);
+	if (newp == NULL)
+	  break;
 
-      
-      if (start < *next_offset)
 	
-	return newp;
-    }
-  
+	if (start < *next_offset)
+	  {
+	    
+	    result = newp;
+	    break;
+	  }
+      }
+  rwlock_unlock (dbg->lock);
+
+  return result;
 }
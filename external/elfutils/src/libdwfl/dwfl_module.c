@@ -97,6 +97,8 @@ __libdwfl_module_free (Dwfl_Module *mod)
   if (mod->reloc_info != NULL)
     free (mod->reloc_info);
 
+  __libdwfl_symidx_free (mod);
+
   if (mod->eh_cfi != NULL)
     dwarf_cfi_end (mod->eh_cfi);
 
@@ -28,6 +28,340 @@
 
 #include "libdwflP.h"
 
+static bool
+symidx_wanted (const char *name, const GElf_Sym *sym)
+{
+  return (name != NULL && name[0] != '\0'
+	  && sym->st_shndx != SHN_UNDEF
+	  && GELF_ST_TYPE (sym->st_info) != STT_SECTION
+	  && GELF_ST_TYPE (sym->st_info) != STT_FILE
+	  && GELF_ST_TYPE (sym->st_info) != STT_TLS);
+}
+
+static int
+compare_symidx_entries (const void *a, const void *b)
+{
+  const struct dwfl_symidx_entry *p1 = a;
+  const struct dwfl_symidx_entry *p2 = b;
+
+  if (p1->value != p2->value)
+    return p1->value < p2->value ? -1 : 1;
+  if (p1->ndx != p2->ndx)
+    return p1->ndx < p2->ndx ? -1 : 1;
+  return (int) p1->adjusted - (int) p2->adjusted;
+}
+
+static int
+compare_symidx_order (const void *a, const void *b)
+{
+  const struct dwfl_symidx_entry *const *p1 = a;
+  const struct dwfl_symidx_entry *const *p2 = b;
+
+  if ((*p1)->ndx != (*p2)->ndx)
+    return (*p1)->ndx < (*p2)->ndx ? -1 : 1;
+  return (int) (*p1)->adjusted - (int) (*p2)->adjusted;
+}
+
+static bool
+symidx_add (struct dwfl_symidx_range *range, size_t *nalloc,
+	    GElf_Addr value, GElf_Xword size, int ndx, bool adjusted)
+{
+  if (range->nentries == *nalloc)
+    {
+      size_t n = *nalloc == 0 ? 64 : *nalloc * 2;
+      struct dwfl_symidx_entry *entries
+	= realloc (range->entries, n * sizeof entries[0]);
+      if (unlikely (entries == NULL))
+	return false;
+      range->entries = entries;
+      *nalloc = n;
+    }
+
+  struct dwfl_symidx_entry *e = &range->entries[range->nentries++];
+  e->value = value;
+  /* Saturate, so that the running maximum of the ends still covers
+     symbols that would wrap around the address space.  */
+  e->end = value + size < value ? (GElf_Addr) -1 : value + size;
+  e->ndx = ndx;
+  e->adjusted = adjusted;
+  return true;
+}
+
+static bool
+symidx_add_late (struct dwfl_symidx_range *range, GElf_Addr value,
+		 GElf_Xword size, int ndx, GElf_Addr resolved)
+{
+  struct dwfl_symidx_late *late
+    = realloc (range->late, (range->nlate + 1) * sizeof late[0]);
+  if (unlikely (late == NULL))
+    return false;
+  range->late = late;
+
+  late = &range->late[range->nlate++];
+  late->entry.value = value;
+  late->entry.end = value + size < value ? (GElf_Addr) -1 : value + size;
+  late->entry.ndx = ndx;
+  late->entry.adjusted = true;
+  late->resolved = resolved;
+  return true;
+}
+
+static bool
+build_symidx_range (Dwfl_Module *mod, int start, int end,
+		    bool adjust_st_value, struct dwfl_symidx_range *range)
+{
+  size_t nalloc = 0;
+
+  for (int i = start; i < end; ++i)
+    {
+      GElf_Sym sym;
+      GElf_Addr value;
+      GElf_Word shndx;
+      Elf *elf;
+      bool resolved;
+      const char *name = __libdwfl_getsym (mod, i, &sym, &value,
+					   &shndx, &elf, NULL,
+					   &resolved, adjust_st_value);
+      if (! symidx_wanted (name, &sym))
+	continue;
+
+      if (! symidx_add (range, &nalloc, value, sym.st_size, i, false))
+	return false;
+
+      if (resolved && mod->e_type != ET_REL)
+	{
+	  GElf_Addr adjusted_st_value;
+	  adjusted_st_value = dwfl_adjusted_st_value (mod, elf, sym.st_value);
+	  /* The adjusted address is only tried when the resolved one is
+	     not above ADDR either.  */
+	  if (value > adjusted_st_value)
+	    {
+	      if (! symidx_add_late (range, adjusted_st_value, sym.st_size,
+				     i, value))
+		return false;
+	    }
+	  else if (value != adjusted_st_value
+		   && ! symidx_add (range, &nalloc, adjusted_st_value,
+				    sym.st_size, i, true))
+	    return false;
+	}
+    }
+
+  if (range->nentries == 0)
+    return true;
+
+  qsort (range->entries, range->nentries, sizeof range->entries[0],
+	 compare_symidx_entries);
+
+  range->max_end = malloc (range->nentries * sizeof range->max_end[0]);
+  if (unlikely (range->max_end == NULL))
+    return false;
+  GElf_Addr max_end = 0;
+  for (size_t i = 0; i < range->nentries; ++i)
+    {
+      if (range->entries[i].end > max_end)
+	max_end = range->entries[i].end;
+      range->max_end[i] = max_end;
+    }
+  return true;
+}
+
+static void
+free_symidx (struct dwfl_symidx *idx)
+{
+  if (idx == NULL)
+    return;
+  free (idx->globals.entries);
+  free (idx->globals.max_end);
+  free (idx->globals.late);
+  free (idx->locals.entries);
+  free (idx->locals.max_end);
+  free (idx->locals.late);
+  free (idx);
+}
+
+void
+internal_function
+__libdwfl_symidx_free (Dwfl_Module *mod)
+{
+  free_symidx (mod->symidx[0]);
+  free_symidx (mod->symidx[1]);
+  mod->symidx[0] = mod->symidx[1] = NULL;
+  free (mod->secranges);
+  mod->secranges = NULL;
+  mod->secranges_elf = NULL;
+  mod->nsecranges = 0;
+}
+
+/* Sort the symbols of MOD by address, separately for the globals and
+   the locals, which __libdwfl_addrsym searches in that order.  */
+static struct dwfl_symidx *
+get_symidx (Dwfl_Module *mod, int syments, int first_global,
+	    bool adjust_st_value)
+{
+  struct dwfl_symidx *idx = mod->symidx[adjust_st_value];
+  if (idx != NULL)
+    return idx;
+
+  idx = calloc (1, sizeof *idx);
+  if (unlikely (idx == NULL)
+      || ! build_symidx_range (mod, first_global == 0 ? 1 : first_global,
+			       syments, adjust_st_value, &idx->globals)
+      || ! build_symidx_range (mod, 1, first_global,
+			       adjust_st_value, &idx->locals))
+    {
+      free_symidx (idx);
+      __libdwfl_seterrno (DWFL_E_NOMEM);
+      return NULL;
+    }
+
+  mod->symidx[adjust_st_value] = idx;
+  return idx;
+}
+
+/* Collect the entries of RANGE at or below ADDR that can decide the
+   result: those whose symbol contains ADDR and, when there are none,
+   the sizeless ones at the highest end of any symbol below ADDR.  No
+   other symbol can be chosen or affect the choice.  The candidates are
+   returned in symbol table order in *CANDP and their highest end in
+   *MAX_ENDP.  */
+static ssize_t
+symidx_candidates (const struct dwfl_symidx_range *range, GElf_Addr addr,
+		   const struct dwfl_symidx_entry ***candp, size_t *nallocp,
+		   GElf_Addr *max_endp)
+{
+  size_t lo = 0;
+  size_t hi = range->nentries;
+  while (lo < hi)
+    {
+      size_t mid = (lo + hi) / 2;
+      if (range->entries[mid].value <= addr)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  inline bool late_counts (const struct dwfl_symidx_late *late)
+  {
+    return late->entry.value <= addr && late->resolved <= addr;
+  }
+
+  bool any = lo > 0;
+  GElf_Addr max_end = any ? range->max_end[lo - 1] : 0;
+  for (size_t i = 0; i < range->nlate; ++i)
+    if (late_counts (&range->late[i]))
+      {
+	any = true;
+	if (range->late[i].entry.end > max_end)
+	  max_end = range->late[i].entry.end;
+      }
+  if (! any)
+    return 0;
+
+  size_t n = 0;
+  inline bool add (const struct dwfl_symidx_entry *e)
+  {
+    if (n == *nallocp)
+      {
+	size_t nalloc = *nallocp == 0 ? 16 : *nallocp * 2;
+	const struct dwfl_symidx_entry **cand
+	  = realloc (*candp, nalloc * sizeof cand[0]);
+	if (unlikely (cand == NULL))
+	  return false;
+	*candp = cand;
+	*nallocp = nalloc;
+      }
+    (*candp)[n++] = e;
+    return true;
+  }
+
+  *max_endp = max_end;
+  if (max_end > addr)
+    {
+      for (size_t i = lo; i-- > 0 && range->max_end[i] > addr; )
+	if (addr - range->entries[i].value
+	    < range->entries[i].end - range->entries[i].value
+	    && ! add (&range->entries[i]))
+	  return -1;
+      for (size_t i = 0; i < range->nlate; ++i)
+	{
+	  const struct dwfl_symidx_entry *e = &range->late[i].entry;
+	  if (late_counts (&range->late[i])
+	      && addr - e->value < e->end - e->value
+	      && ! add (e))
+	    return -1;
+	}
+    }
+  else
+    {
+      size_t first = lo;
+      while (first > 0 && range->entries[first - 1].value == max_end)
+	--first;
+      for (size_t i = first; i < lo; ++i)
+	if (! add (&range->entries[i]))
+	  return -1;
+      for (size_t i = 0; i < range->nlate; ++i)
+	if (late_counts (&range->late[i])
+	    && range->late[i].entry.value == max_end
+	    && ! add (&range->late[i].entry))
+	  return -1;
+    }
+
+  qsort (*candp, n, sizeof (*candp)[0], compare_symidx_order);
+  return n;
+}
+
+static GElf_Word
+find_section_by_addr (Dwfl_Module *mod, Elf *elf, GElf_Addr addr)
+{
+  if (mod->secranges_elf != elf)
+    {
+      size_t nscns;
+      struct dwfl_secrange *ranges = NULL;
+      if (elf_getshdrnum (elf, &nscns) == 0 && nscns > 0)
+	ranges = realloc (mod->secranges, nscns * sizeof ranges[0]);
+      if (ranges != NULL)
+	{
+	  size_t n = 0;
+	  Elf_Scn *scn = NULL;
+	  while ((scn = elf_nextscn (elf, scn)) != NULL)
+	    {
+	      GElf_Shdr shdr_mem;
+	      GElf_Shdr *shdr = gelf_getshdr (scn, &shdr_mem);
+	      if (likely (shdr != NULL) && n < nscns)
+		{
+		  ranges[n].start = shdr->sh_addr;
+		  ranges[n].end = shdr->sh_addr + shdr->sh_size;
+		  ranges[n].shndx = elf_ndxscn (scn);
+		  n++;
+		}
+	    }
+	  mod->secranges = ranges;
+	  mod->nsecranges = n;
+	  mod->secranges_elf = elf;
+	}
+      else
+	{
+	  Elf_Scn *scn = NULL;
+	  while ((scn = elf_nextscn (elf, scn)) != NULL)
+	    {
+	      GElf_Shdr shdr_mem;
+	      GElf_Shdr *shdr = gelf_getshdr (scn, &shdr_mem);
+	      if (likely (shdr != NULL)
+		  && addr >= shdr->sh_addr
+		  && addr < shdr->sh_addr + shdr->sh_size)
+		return elf_ndxscn (scn);
+	    }
+	  return SHN_ABS;
+	}
+    }
+
+  for (size_t i = 0; i < mod->nsecranges; ++i)
+    if (addr >= mod->secranges[i].start && addr < mod->secranges[i].end)
+      return mod->secranges[i].shndx;
+  return SHN_ABS;
+}
+
 
 const char *
 internal_function
@@ -65,21 +399,8 @@ __libdwfl_addrsym (Dwfl_Module *mod, GElf_Addr addr, GElf_Off *off,
       if (addr_shndx == SHN_UNDEF || addr_symelf != symelf)
 	{
 	  GElf_Addr mod_addr = dwfl_deadjust_st_value (mod, symelf, addr);
-	  Elf_Scn *scn = NULL;
-	  addr_shndx = SHN_ABS;
+	  addr_shndx = find_section_by_addr (mod, symelf, mod_addr);
 	  addr_symelf = symelf;
-	  while ((scn = elf_nextscn (symelf, scn)) != NULL)
-	    {
-	      GElf_Shdr shdr_mem;
-	      GElf_Shdr *shdr = gelf_getshdr (scn, &shdr_mem);
-	      if (likely (shdr != NULL)
-		  && mod_addr >= shdr->sh_addr
-		  && mod_addr < shdr->sh_addr + shdr->sh_size)
-		{
-		  addr_shndx = elf_ndxscn (scn);
-		  break;
-		}
-	    }
 	}
 
       return shndx == addr_shndx && addr_symelf == symelf;
@@ -172,49 +493,60 @@ __libdwfl_addrsym (Dwfl_Module *mod, GElf_Addr addr, GElf_Off *off,
       }
   }
 
+  const struct dwfl_symidx_entry **cand = NULL;
+  size_t ncand_alloc = 0;
+
   
-  inline void search_table (int start, int end)
+  inline bool search_table (const struct dwfl_symidx_range *range)
     {
-      for (int i = start; i < end; ++i)
+      GElf_Addr max_end = 0;
+      ssize_t ncand = symidx_candidates (range, addr, &cand, &ncand_alloc,
+					 &max_end);
+      if (unlikely (ncand < 0))
+	return false;
+
+      if (max_end > min_label)
+	min_label = max_end;
+
+      for (ssize_t i = 0; i < ncand; ++i)
 	{
 	  GElf_Sym sym;
 	  GElf_Addr value;
 	  GElf_Word shndx;
 	  Elf *elf;
 	  bool resolved;
-	  const char *name = __libdwfl_getsym (mod, i, &sym, &value,
+	  const char *name = __libdwfl_getsym (mod, cand[i]->ndx, &sym, &value,
 					       &shndx, &elf, NULL,
 					       &resolved, adjust_st_value);
-	  if (name != NULL && name[0] != '\0'
-	      && sym.st_shndx != SHN_UNDEF
-	      && value <= addr
-	      && GELF_ST_TYPE (sym.st_info) != STT_SECTION
-	      && GELF_ST_TYPE (sym.st_info) != STT_FILE
-	      && GELF_ST_TYPE (sym.st_info) != STT_TLS)
-	    {
-	      try_sym_value (value, &sym, name, shndx, elf, resolved);
-
-	      if (resolved && mod->e_type != ET_REL)
-		{
-		  GElf_Addr adjusted_st_value;
-		  adjusted_st_value = dwfl_adjusted_st_value (mod, elf,
-							      sym.st_value);
-		  if (value != adjusted_st_value && adjusted_st_value <= addr)
-		    try_sym_value (adjusted_st_value, &sym, name, shndx,
-				   elf, false);
-		}
-	    }
+	  if (name == NULL)
+	    continue;
+	  if (cand[i]->adjusted)
+	    try_sym_value (cand[i]->value, &sym, name, shndx, elf, false);
+	  else
+	    try_sym_value (value, &sym, name, shndx, elf, resolved);
 	}
+      return true;
     }
 
   int first_global = INTUSE (dwfl_module_getsymtab_first_global) (mod);
   if (first_global < 0)
     return NULL;
-  search_table (first_global == 0 ? 1 : first_global, syments);
+  struct dwfl_symidx *idx = get_symidx (mod, syments, first_global,
+					adjust_st_value);
+  if (idx == NULL)
+    return NULL;
+  bool ok = search_table (&idx->globals);
 
-  if (closest_name == NULL && first_global > 1
+  if (ok && closest_name == NULL && first_global > 1
       && (sizeless_name == NULL || sizeless_value != addr))
-    search_table (1, first_global);
+    ok = search_table (&idx->locals);
+
+  free (cand);
+  if (unlikely (! ok))
+    {
+      __libdwfl_seterrno (DWFL_E_NOMEM);
+      return NULL;
+    }
 
   if (closest_name == NULL
       && sizeless_name != NULL && sizeless_value >= min_label)
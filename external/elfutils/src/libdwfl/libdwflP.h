@@ -148,6 +148,45 @@ struct dwfl_file
   GElf_Addr address_sync;
 };
 
+struct dwfl_symidx_entry
+{
+  GElf_Addr value;
+  GElf_Addr end;
+  int ndx;
+  bool adjusted;
+};
+
+/* An adjusted entry whose symbol resolves to an address above it.  It
+   can only be chosen for addresses at or above both, so it is kept out
+   of the sorted entries.  */
+struct dwfl_symidx_late
+{
+  struct dwfl_symidx_entry entry;
+  GElf_Addr resolved;
+};
+
+struct dwfl_symidx_range
+{
+  struct dwfl_symidx_entry *entries;
+  GElf_Addr *max_end;
+  size_t nentries;
+  struct dwfl_symidx_late *late;
+  size_t nlate;
+};
+
+struct dwfl_symidx
+{
+  struct dwfl_symidx_range globals;
+  struct dwfl_symidx_range locals;
+};
+
+struct dwfl_secrange
+{
+  GElf_Addr start;
+  GElf_Addr end;
+  GElf_Word shndx;
+};
+
 struct Dwfl_Module
 {
   Dwfl *dwfl;
@@ -178,6 +217,15 @@ struct Dwfl_Module
   Elf_Data *symxndxdata;	
   Elf_Data *aux_symxndxdata;	
 
+  /* Built on the first address lookup and never changed afterwards,
+     except that secranges follows the last Elf looked at.  Like the
+     symbol table data above they are filled without locking, so
+     concurrent lookups in one module need outside serialization.  */
+  struct dwfl_symidx *symidx[2];
+  Elf *secranges_elf;
+  struct dwfl_secrange *secranges;
+  size_t nsecranges;
+
   Dwarf *dw;			
   Dwarf *alt;			
   int alt_fd; 			
@@ -364,16 +412,16 @@ struct __libdwfl_pid_arg
 {
   DIR *dir;
   
-  pid_t tid_attached;
-  
-  bool tid_was_stopped;
-  
   bool assume_ptrace_stopped;
 };
 
 extern struct __libdwfl_pid_arg *__libdwfl_get_pid_arg (Dwfl *dwfl)
   internal_function;
 
+
+extern pid_t __libdwfl_pid_tid_attached (void)
+  internal_function;
+
 extern bool __libdwfl_ptrace_attach (pid_t tid, bool *tid_was_stoppedp)
   internal_function;
 
@@ -395,6 +443,8 @@ extern const char *__libdwfl_addrsym (Dwfl_Module *mod, GElf_Addr addr,
 
 extern void __libdwfl_module_free (Dwfl_Module *mod) internal_function;
 
+extern void __libdwfl_symidx_free (Dwfl_Module *mod) internal_function;
+
 extern void __libdwfl_getelf (Dwfl_Module *mod) internal_function;
 
 extern Dwfl_Error __libdwfl_relocate (Dwfl_Module *mod, Elf *file, bool debug)
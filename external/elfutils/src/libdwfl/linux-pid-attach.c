@@ -39,6 +39,10 @@
 
 #ifdef __linux__
 
+
+static __thread pid_t pid_tid_attached;
+static __thread bool pid_tid_was_stopped;
+
 static bool
 linux_proc_pid_is_stopped (pid_t pid)
 {
@@ -105,10 +109,10 @@ __libdwfl_ptrace_attach (pid_t tid, bool *tid_was_stoppedp)
 }
 
 static bool
-pid_memory_read (Dwfl *dwfl, Dwarf_Addr addr, Dwarf_Word *result, void *arg)
+pid_memory_read (Dwfl *dwfl, Dwarf_Addr addr, Dwarf_Word *result,
+		 void *arg __attribute__ ((unused)))
 {
-  struct __libdwfl_pid_arg *pid_arg = arg;
-  pid_t tid = pid_arg->tid_attached;
+  pid_t tid = pid_tid_attached;
   assert (tid > 0);
   Dwfl_Process *process = dwfl->process;
   if (ebl_get_elfclass (process->ebl) == ELFCLASS64)
@@ -221,12 +225,12 @@ static bool
 pid_set_initial_registers (Dwfl_Thread *thread, void *thread_arg)
 {
   struct __libdwfl_pid_arg *pid_arg = thread_arg;
-  assert (pid_arg->tid_attached == 0);
+  assert (pid_tid_attached == 0);
   pid_t tid = INTUSE(dwfl_thread_tid) (thread);
   if (! pid_arg->assume_ptrace_stopped
-      && ! __libdwfl_ptrace_attach (tid, &pid_arg->tid_was_stopped))
+      && ! __libdwfl_ptrace_attach (tid, &pid_tid_was_stopped))
     return false;
-  pid_arg->tid_attached = tid;
+  pid_tid_attached = tid;
   Dwfl_Process *process = thread->process;
   Ebl *ebl = process->ebl;
   return ebl_set_initial_registers_tid (ebl, tid,
@@ -254,10 +258,10 @@ pid_thread_detach (Dwfl_Thread *thread, void *thread_arg)
 {
   struct __libdwfl_pid_arg *pid_arg = thread_arg;
   pid_t tid = INTUSE(dwfl_thread_tid) (thread);
-  assert (pid_arg->tid_attached == tid);
-  pid_arg->tid_attached = 0;
+  assert (pid_tid_attached == tid);
+  pid_tid_attached = 0;
   if (! pid_arg->assume_ptrace_stopped)
-    __libdwfl_ptrace_detach (tid, pid_arg->tid_was_stopped);
+    __libdwfl_ptrace_detach (tid, pid_tid_was_stopped);
 }
 
 static const Dwfl_Thread_Callbacks pid_thread_callbacks =
@@ -332,7 +336,6 @@ dwfl_linux_proc_attach (Dwfl *dwfl, pid_t pid, bool assume_ptrace_stopped)
       goto fail;
     }
   pid_arg->dir = dir;
-  pid_arg->tid_attached = 0;
   pid_arg->assume_ptrace_stopped = assume_ptrace_stopped;
   if (! INTUSE(dwfl_attach_state) (dwfl, NULL, pid, &pid_thread_callbacks,
 				   pid_arg))
@@ -356,6 +359,13 @@ __libdwfl_get_pid_arg (Dwfl *dwfl)
   return NULL;
 }
 
+pid_t
+internal_function
+__libdwfl_pid_tid_attached (void)
+{
+  return pid_tid_attached;
+}
+
 #else	
 
 static pid_t
@@ -454,5 +464,12 @@ __libdwfl_get_pid_arg (Dwfl *dwfl __attribute__ ((unused)))
   return NULL;
 }
 
+pid_t
+internal_function
+__libdwfl_pid_tid_attached (void)
+{
+  return 0;
+}
+
 #endif 
 
@@ -364,7 +364,7 @@ dwfl_linux_proc_find_elf (Dwfl_Module *mod __attribute__ ((unused)),
       struct __libdwfl_pid_arg *pid_arg = __libdwfl_get_pid_arg (mod->dwfl);
       if (pid_arg != NULL && ! pid_arg->assume_ptrace_stopped)
 	{
-	  pid_t tid = pid_arg->tid_attached;
+	  pid_t tid = __libdwfl_pid_tid_attached ();
 	  if (tid != 0)
 	    pid = tid;
 	  else
@@ -261,6 +261,21 @@ relocate_section (Dwfl_Module *mod, Elf *relocated, const GElf_Ehdr *ehdr,
     return DWFL_E_NOERROR;
 
   
+  GElf_Xword tsize = tshdr->sh_size;
+  if (strncmp (tname, ".zdebug", strlen (".zdebug")) == 0)
+    if (elf_compress_gnu (tscn, 0, 0) < 0)
+      return DWFL_E_LIBELF;
+
+  if ((tshdr->sh_flags & SHF_COMPRESSED) != 0)
+    if (elf_compress (tscn, 0, 0) < 0)
+      return DWFL_E_LIBELF;
+
+  
+  tshdr = gelf_getshdr (tscn, &tshdr_mem);
+  if (tshdr == NULL)
+    return DWFL_E_LIBELF;
+
+  
   Elf_Data *tdata = elf_rawdata (tscn, NULL);
   if (tdata == NULL)
     return DWFL_E_LIBELF;
@@ -279,7 +294,7 @@ relocate_section (Dwfl_Module *mod, Elf *relocated, const GElf_Ehdr *ehdr,
   GElf_Off shdrs_end = shdrs_start + shnums * shentsize;
   if (unlikely ((shdrs_start < shdr->sh_offset + shdr->sh_size
 		 && shdr->sh_offset < shdrs_end)
-		|| (shdrs_start < tshdr->sh_offset + tshdr->sh_size
+		|| (shdrs_start < tshdr->sh_offset + tsize
 		    && tshdr->sh_offset < shdrs_end)))
     return DWFL_E_BADELF;
 
@@ -294,7 +309,7 @@ relocate_section (Dwfl_Module *mod, Elf *relocated, const GElf_Ehdr *ehdr,
       GElf_Off phdrs_end = phdrs_start + phnums * phentsize;
       if (unlikely ((phdrs_start < shdr->sh_offset + shdr->sh_size
 		     && shdr->sh_offset < phdrs_end)
-		    || (phdrs_start < tshdr->sh_offset + tshdr->sh_size
+		    || (phdrs_start < tshdr->sh_offset + tsize
 			&& tshdr->sh_offset < phdrs_end)))
 	return DWFL_E_BADELF;
     }
@@ -42,6 +42,8 @@ LIBELF_SRC_FILES := \
 	elf_begin.c \
 	elf_clone.c \
 	elf_cntl.c \
+	elf_compress.c \
+	elf_compress_gnu.c \
 	elf_end.c \
 	elf_error.c \
 	elf_fill.c \
@@ -82,6 +84,7 @@ LIBELF_SRC_FILES := \
 	gelf_checksum.c \
 	gelf_fsize.c \
 	gelf_getauxv.c \
+	gelf_getchdr.c \
 	gelf_getclass.c \
 	gelf_getdyn.c \
 	gelf_getehdr.c \
@@ -151,6 +154,8 @@ LOCAL_CFLAGS += -Wno-pointer-arith
 
 LOCAL_MODULE := libelf
 
+LOCAL_STATIC_LIBRARIES := libz
+
 LOCAL_EXPORT_C_INCLUDE_DIRS := $(LOCAL_PATH)
 
 include $(BUILD_HOST_STATIC_LIBRARY)
@@ -183,6 +188,8 @@ LOCAL_CFLAGS += -include $(LOCAL_PATH)/../../bionic-fixup/AndroidFixup.h
 
 LOCAL_MODULE := libelf
 
+LOCAL_STATIC_LIBRARIES := libz
+
 LOCAL_EXPORT_C_INCLUDE_DIRS := $(LOCAL_PATH)
 
 include $(BUILD_STATIC_LIBRARY)
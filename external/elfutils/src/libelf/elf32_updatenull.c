@@ -343,6 +343,7 @@ __elfw2(LIBELFBITS,updatenull_wrlock) (Elf *elf, int *change_bop, size_t shnum)
 		}
 
 	      if (shdr->sh_entsize != 0
+		  && (shdr->sh_flags & SHF_COMPRESSED) == 0
 		  && unlikely (shdr->sh_size % shdr->sh_entsize != 0)
 		  && (elf->flags & ELF_F_PERMISSIVE) == 0)
 		{
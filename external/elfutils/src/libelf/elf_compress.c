@@ -0,0 +1,518 @@
+/* Compress or decompress a section.
+   Copyright (C) 2015 Red Hat, Inc.
+   This file is part of elfutils.
+
+   This file is free software; you can redistribute it and/or modify
+   it under the terms of either
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at
+       your option) any later version
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at
+       your option) any later version
+
+   or both in parallel, as here.
+
+   elfutils is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libelfP.h"
+#include "common.h"
+
+#ifdef USE_ZLIB
+# include <zlib.h>
+#endif
+
+
+void *
+internal_function
+__libelf_compress (Elf_Scn *scn, size_t hsize, int ei_data,
+		   size_t *orig_size, size_t *new_size, bool force)
+{
+#ifdef USE_ZLIB
+  Elf *elf = scn->elf;
+
+  size_t total = 0;
+  Elf_Data *data = NULL;
+  while ((data = __elf_getdata_rdlock (scn, data)) != NULL)
+    total += data->d_size;
+
+  z_stream z = { .zalloc = Z_NULL, .zfree = Z_NULL, .opaque = Z_NULL };
+  if (unlikely (deflateInit (&z, Z_BEST_COMPRESSION) != Z_OK))
+    {
+      __libelf_seterrno (ELF_E_COMPRESS_ERROR);
+      return NULL;
+    }
+
+  size_t out_size = hsize + deflateBound (&z, total);
+  char *out_buf = malloc (out_size);
+  if (unlikely (out_buf == NULL))
+    {
+      deflateEnd (&z);
+      __libelf_seterrno (ELF_E_NOMEM);
+      return NULL;
+    }
+
+  z.next_out = (Bytef *) out_buf + hsize;
+  z.avail_out = out_size - hsize;
+
+  void *cvt_buf = NULL;
+  size_t cvt_size = 0;
+  int zrc;
+  data = NULL;
+  do
+    {
+      int flush = Z_NO_FLUSH;
+      data = __elf_getdata_rdlock (scn, data);
+      if (data == NULL)
+	{
+	  flush = Z_FINISH;
+	  z.next_in = NULL;
+	  z.avail_in = 0;
+	}
+      else
+	{
+	  void *buf = data->d_buf;
+	  if (ei_data != MY_ELFDATA && data->d_type != ELF_T_BYTE
+	      && data->d_size != 0)
+	    {
+	      if (cvt_size < data->d_size)
+		{
+		  void *newp = realloc (cvt_buf, data->d_size);
+		  if (unlikely (newp == NULL))
+		    goto nomem;
+		  cvt_buf = newp;
+		  cvt_size = data->d_size;
+		}
+
+#if EV_NUM != 2
+	      xfct_t fp = __elf_xfctstom[__libelf_version - 1][data->d_version - 1][elf->class - 1][data->d_type];
+#else
+	      xfct_t fp = __elf_xfctstom[0][0][elf->class - 1][data->d_type];
+#endif
+	      fp (cvt_buf, buf, data->d_size, 1);
+	      buf = cvt_buf;
+	    }
+	  z.next_in = buf;
+	  z.avail_in = data->d_size;
+	}
+
+      do
+	{
+	  if (z.avail_out == 0)
+	    {
+	      size_t used = out_size;
+	      out_size *= 2;
+	      char *newp = realloc (out_buf, out_size);
+	      if (unlikely (newp == NULL))
+		goto nomem;
+	      out_buf = newp;
+	      z.next_out = (Bytef *) out_buf + used;
+	      z.avail_out = out_size - used;
+	    }
+
+	  zrc = deflate (&z, flush);
+	  if (unlikely (zrc == Z_STREAM_ERROR))
+	    {
+	      __libelf_seterrno (ELF_E_COMPRESS_ERROR);
+	      goto fail;
+	    }
+	}
+      while (z.avail_in > 0 || (flush == Z_FINISH && zrc != Z_STREAM_END));
+    }
+  while (data != NULL);
+
+  free (cvt_buf);
+  deflateEnd (&z);
+
+  *orig_size = total;
+  *new_size = hsize + z.total_out;
+
+  if (! force && *new_size >= total)
+    {
+      free (out_buf);
+      return (void *) -1;
+    }
+
+  return out_buf;
+
+ nomem:
+  __libelf_seterrno (ELF_E_NOMEM);
+ fail:
+  free (cvt_buf);
+  free (out_buf);
+  deflateEnd (&z);
+  return NULL;
+#else
+  (void) scn;
+  (void) hsize;
+  (void) ei_data;
+  (void) orig_size;
+  (void) new_size;
+  (void) force;
+  __libelf_seterrno (ELF_E_UNKNOWN_COMPRESSION_TYPE);
+  return NULL;
+#endif
+}
+
+
+void *
+internal_function
+__libelf_decompress (void *buf_in, size_t size_in, size_t size_out)
+{
+#ifdef USE_ZLIB
+  void *buf_out = malloc (size_out ?: 1);
+  if (unlikely (buf_out == NULL))
+    {
+      __libelf_seterrno (ELF_E_NOMEM);
+      return NULL;
+    }
+
+  z_stream z =
+    {
+      .next_in = buf_in,
+      .avail_in = size_in,
+      .next_out = buf_out,
+      .avail_out = size_out
+    };
+  int zrc = inflateInit (&z);
+  while (z.avail_in > 0 && likely (zrc == Z_OK))
+    {
+      z.next_out = (Bytef *) buf_out + (size_out - z.avail_out);
+      zrc = inflate (&z, Z_FINISH);
+      if (unlikely (zrc != Z_STREAM_END))
+	{
+	  zrc = Z_DATA_ERROR;
+	  break;
+	}
+      zrc = inflateReset (&z);
+    }
+  if (likely (zrc == Z_OK))
+    zrc = inflateEnd (&z);
+  else
+    inflateEnd (&z);
+
+  if (unlikely (zrc != Z_OK) || unlikely (z.avail_out != 0))
+    {
+      free (buf_out);
+      __libelf_seterrno (ELF_E_DECOMPRESS_ERROR);
+      return NULL;
+    }
+
+  return buf_out;
+#else
+  (void) buf_in;
+  (void) size_in;
+  (void) size_out;
+  __libelf_seterrno (ELF_E_UNKNOWN_COMPRESSION_TYPE);
+  return NULL;
+#endif
+}
+
+
+void
+internal_function
+__libelf_reset_rawdata (Elf_Scn *scn, void *buf, size_t size, size_t align,
+			Elf_Type type)
+{
+  if (scn->data_base != scn->rawdata_base)
+    free (scn->data_base);
+
+  if (scn->elf->map_address == NULL
+      || scn->rawdata_base == scn->zdata_base)
+    free (scn->rawdata_base);
+
+  Elf_Data_List *runp = scn->data_list.next;
+  while (runp != NULL)
+    {
+      Elf_Data_List *oldp = runp;
+      runp = runp->next;
+      if ((oldp->flags & ELF_F_MALLOCED) != 0)
+	free (oldp);
+    }
+  scn->data_list.next = NULL;
+  scn->data_list_rear = NULL;
+  scn->data_base = NULL;
+
+  scn->rawdata_base = scn->zdata_base = buf;
+  scn->rawdata.d.d_buf = buf;
+  scn->rawdata.d.d_size = size;
+  scn->rawdata.d.d_align = align;
+  scn->rawdata.d.d_type = type;
+  scn->rawdata.d.d_off = 0;
+  scn->rawdata.d.d_version = __libelf_version;
+  scn->rawdata.s = scn;
+  scn->data_read = 1;
+  scn->flags |= ELF_F_FILEDATA;
+
+  
+  (void) __elf_getdata_rdlock (scn, NULL);
+
+  scn->flags |= ELF_F_DIRTY;
+}
+
+
+int
+internal_function
+__libelf_unshare_shdrs_wrlock (Elf *elf)
+{
+  
+  if (elf->cmd != ELF_C_READ_MMAP
+      || elf->state.elf.shdr_malloced != 0
+      || elf->state.elf.shdr == NULL)
+    return 0;
+
+  size_t shnum;
+  if (__elf_getshdrnum_rdlock (elf, &shnum) != 0)
+    return -1;
+
+  if (elf->class == ELFCLASS32)
+    {
+      Elf32_Shdr *old = elf->state.elf32.shdr;
+      Elf32_Shdr *shdr = malloc (shnum * sizeof (Elf32_Shdr));
+      if (unlikely (shdr == NULL))
+	{
+	  __libelf_seterrno (ELF_E_NOMEM);
+	  return -1;
+	}
+      memcpy (shdr, old, shnum * sizeof (Elf32_Shdr));
+
+      Elf_ScnList *list = &elf->state.elf32.scns;
+      for (size_t cnt = 0; cnt < list->cnt && cnt < shnum; ++cnt)
+	if (list->data[cnt].shdr.e32 == &old[cnt])
+	  list->data[cnt].shdr.e32 = &shdr[cnt];
+
+      elf->state.elf32.shdr = shdr;
+    }
+  else
+    {
+      Elf64_Shdr *old = elf->state.elf64.shdr;
+      Elf64_Shdr *shdr = malloc (shnum * sizeof (Elf64_Shdr));
+      if (unlikely (shdr == NULL))
+	{
+	  __libelf_seterrno (ELF_E_NOMEM);
+	  return -1;
+	}
+      memcpy (shdr, old, shnum * sizeof (Elf64_Shdr));
+
+      Elf_ScnList *list = &elf->state.elf64.scns;
+      for (size_t cnt = 0; cnt < list->cnt && cnt < shnum; ++cnt)
+	if (list->data[cnt].shdr.e64 == &old[cnt])
+	  list->data[cnt].shdr.e64 = &shdr[cnt];
+
+      elf->state.elf64.shdr = shdr;
+    }
+
+  elf->state.elf.shdr_malloced = 1;
+
+  return 0;
+}
+
+
+static void
+update_shdr (Elf_Scn *scn, GElf_Xword flags, GElf_Xword size,
+	     GElf_Xword align)
+{
+  if (scn->elf->class == ELFCLASS32)
+    {
+      Elf32_Shdr *shdr = scn->shdr.e32;
+      shdr->sh_flags = flags;
+      shdr->sh_size = size;
+      shdr->sh_addralign = align;
+    }
+  else
+    {
+      Elf64_Shdr *shdr = scn->shdr.e64;
+      shdr->sh_flags = flags;
+      shdr->sh_size = size;
+      shdr->sh_addralign = align;
+    }
+
+  scn->shdr_flags |= ELF_F_DIRTY;
+}
+
+
+int
+elf_compress (Elf_Scn *scn, int type, unsigned int flags)
+{
+  if (scn == NULL)
+    return -1;
+
+  if ((flags & ~ELF_CHF_FORCE) != 0)
+    {
+      __libelf_seterrno (ELF_E_INVALID_OPERAND);
+      return -1;
+    }
+
+  bool force = (flags & ELF_CHF_FORCE) != 0;
+
+  Elf *elf = scn->elf;
+  if (unlikely (elf->kind != ELF_K_ELF))
+    {
+      __libelf_seterrno (ELF_E_INVALID_HANDLE);
+      return -1;
+    }
+
+  int result = -1;
+
+  rwlock_wrlock (elf->lock);
+
+  if (__libelf_unshare_shdrs_wrlock (elf) != 0)
+    goto out;
+
+  GElf_Xword sh_flags;
+  GElf_Word sh_type;
+  GElf_Xword sh_addralign;
+  if (elf->class == ELFCLASS32)
+    {
+      Elf32_Shdr *shdr = scn->shdr.e32 ?: __elf32_getshdr_wrlock (scn);
+      if (shdr == NULL)
+	goto out;
+      sh_flags = shdr->sh_flags;
+      sh_type = shdr->sh_type;
+      sh_addralign = shdr->sh_addralign;
+    }
+  else
+    {
+      Elf64_Shdr *shdr = scn->shdr.e64 ?: __elf64_getshdr_wrlock (scn);
+      if (shdr == NULL)
+	goto out;
+      sh_flags = shdr->sh_flags;
+      sh_type = shdr->sh_type;
+      sh_addralign = shdr->sh_addralign;
+    }
+
+  if (unlikely (scn->index == 0)
+      || (sh_flags & SHF_ALLOC) != 0
+      || sh_type == SHT_NULL || sh_type == SHT_NOBITS)
+    {
+      __libelf_seterrno (ELF_E_INVALID_SECTION);
+      goto out;
+    }
+
+  int ei_data = (elf->class == ELFCLASS32
+		 || (offsetof (struct Elf, state.elf32.ehdr)
+		     == offsetof (struct Elf, state.elf64.ehdr))
+		 ? elf->state.elf32.ehdr->e_ident[EI_DATA]
+		 : elf->state.elf64.ehdr->e_ident[EI_DATA]);
+
+  if (type == ELFCOMPRESS_ZLIB)
+    {
+      if ((sh_flags & SHF_COMPRESSED) != 0)
+	{
+	  __libelf_seterrno (ELF_E_ALREADY_COMPRESSED);
+	  goto out;
+	}
+
+      size_t hsize = (elf->class == ELFCLASS32
+		      ? sizeof (Elf32_Chdr) : sizeof (Elf64_Chdr));
+      size_t orig_size, new_size;
+      char *out_buf = __libelf_compress (scn, hsize, ei_data, &orig_size,
+					 &new_size, force);
+      if (out_buf == NULL)
+	goto out;
+      if (out_buf == (void *) -1)
+	{
+	  result = 0;
+	  goto out;
+	}
+
+      size_t align;
+      if (elf->class == ELFCLASS32)
+	{
+	  Elf32_Chdr chdr;
+	  chdr.ch_type = ELFCOMPRESS_ZLIB;
+	  chdr.ch_size = orig_size;
+	  chdr.ch_addralign = sh_addralign;
+	  if (ei_data != MY_ELFDATA)
+	    {
+	      CONVERT (chdr.ch_type);
+	      CONVERT (chdr.ch_size);
+	      CONVERT (chdr.ch_addralign);
+	    }
+	  memcpy (out_buf, &chdr, sizeof chdr);
+	  align = __alignof__ (Elf32_Chdr);
+	}
+      else
+	{
+	  Elf64_Chdr chdr;
+	  chdr.ch_type = ELFCOMPRESS_ZLIB;
+	  chdr.ch_reserved = 0;
+	  chdr.ch_size = orig_size;
+	  chdr.ch_addralign = sh_addralign;
+	  if (ei_data != MY_ELFDATA)
+	    {
+	      CONVERT (chdr.ch_type);
+	      CONVERT (chdr.ch_size);
+	      CONVERT (chdr.ch_addralign);
+	    }
+	  memcpy (out_buf, &chdr, sizeof chdr);
+	  align = __alignof__ (Elf64_Chdr);
+	}
+
+      update_shdr (scn, sh_flags | SHF_COMPRESSED, new_size, align);
+      __libelf_reset_rawdata (scn, out_buf, new_size, align, ELF_T_BYTE);
+      result = 1;
+    }
+  else if (type == 0)
+    {
+      if ((sh_flags & SHF_COMPRESSED) == 0)
+	{
+	  __libelf_seterrno (ELF_E_NOT_COMPRESSED);
+	  goto out;
+	}
+
+      Elf_Data *data = __elf_getdata_rdlock (scn, NULL);
+      if (data == NULL)
+	goto out;
+
+      GElf_Chdr chdr;
+      size_t hsize = __libelf_read_chdr (elf, data->d_buf, data->d_size,
+					 &chdr);
+      if (hsize == 0)
+	goto out;
+
+      if (chdr.ch_type != ELFCOMPRESS_ZLIB)
+	{
+	  __libelf_seterrno (ELF_E_UNKNOWN_COMPRESSION_TYPE);
+	  goto out;
+	}
+
+      void *buf = __libelf_decompress ((char *) data->d_buf + hsize,
+				       data->d_size - hsize,
+				       chdr.ch_size);
+      if (buf == NULL)
+	goto out;
+
+      update_shdr (scn, sh_flags & ~SHF_COMPRESSED, chdr.ch_size,
+		   chdr.ch_addralign);
+      __libelf_reset_rawdata (scn, buf, chdr.ch_size, chdr.ch_addralign,
+			      __libelf_data_type (elf, sh_type));
+      result = 1;
+    }
+  else
+    __libelf_seterrno (ELF_E_UNKNOWN_COMPRESSION_TYPE);
+
+ out:
+  rwlock_unlock (elf->lock);
+
+  return result;
+}
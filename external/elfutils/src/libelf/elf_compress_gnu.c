@@ -0,0 +1,208 @@
+/* Compress or decompress a .zdebug section.
+   Copyright (C) 2015 Red Hat, Inc.
+   This file is part of elfutils.
+
+   This file is free software; you can redistribute it and/or modify
+   it under the terms of either
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at
+       your option) any later version
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at
+       your option) any later version
+
+   or both in parallel, as here.
+
+   elfutils is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libelfP.h"
+#include "common.h"
+
+
+#define GNU_ZLIB_HSIZE	12
+
+
+int
+elf_compress_gnu (Elf_Scn *scn, int compress, unsigned int flags)
+{
+  if (scn == NULL)
+    return -1;
+
+  if ((flags & ~ELF_CHF_FORCE) != 0)
+    {
+      __libelf_seterrno (ELF_E_INVALID_OPERAND);
+      return -1;
+    }
+
+  bool force = (flags & ELF_CHF_FORCE) != 0;
+
+  Elf *elf = scn->elf;
+  if (unlikely (elf->kind != ELF_K_ELF))
+    {
+      __libelf_seterrno (ELF_E_INVALID_HANDLE);
+      return -1;
+    }
+
+  int result = -1;
+
+  rwlock_wrlock (elf->lock);
+
+  if (__libelf_unshare_shdrs_wrlock (elf) != 0)
+    goto out;
+
+  Elf32_Shdr *shdr32 = NULL;
+  Elf64_Shdr *shdr64 = NULL;
+  GElf_Xword sh_flags;
+  GElf_Word sh_type;
+  if (elf->class == ELFCLASS32)
+    {
+      shdr32 = scn->shdr.e32 ?: __elf32_getshdr_wrlock (scn);
+      if (shdr32 == NULL)
+	goto out;
+      sh_flags = shdr32->sh_flags;
+      sh_type = shdr32->sh_type;
+    }
+  else
+    {
+      shdr64 = scn->shdr.e64 ?: __elf64_getshdr_wrlock (scn);
+      if (shdr64 == NULL)
+	goto out;
+      sh_flags = shdr64->sh_flags;
+      sh_type = shdr64->sh_type;
+    }
+
+  if (unlikely (scn->index == 0)
+      || (sh_flags & SHF_ALLOC) != 0
+      || sh_type == SHT_NULL || sh_type == SHT_NOBITS)
+    {
+      __libelf_seterrno (ELF_E_INVALID_SECTION);
+      goto out;
+    }
+
+  if ((sh_flags & SHF_COMPRESSED) != 0)
+    {
+      __libelf_seterrno (ELF_E_ALREADY_COMPRESSED);
+      goto out;
+    }
+
+  if (compress == 1)
+    {
+      int ei_data = (elf->class == ELFCLASS32
+		     || (offsetof (struct Elf, state.elf32.ehdr)
+			 == offsetof (struct Elf, state.elf64.ehdr))
+		     ? elf->state.elf32.ehdr->e_ident[EI_DATA]
+		     : elf->state.elf64.ehdr->e_ident[EI_DATA]);
+
+      size_t orig_size, new_size;
+      unsigned char *out_buf = __libelf_compress (scn, GNU_ZLIB_HSIZE,
+						  ei_data, &orig_size,
+						  &new_size, force);
+      if (out_buf == NULL)
+	goto out;
+      if (out_buf == (void *) -1)
+	{
+	  result = 0;
+	  goto out;
+	}
+
+      
+      memcpy (out_buf, "ZLIB", 4);
+      uint64_t size = orig_size;
+      for (int i = 11; i >= 4; --i)
+	{
+	  out_buf[i] = size & 0xff;
+	  size >>= 8;
+	}
+
+      if (shdr32 != NULL)
+	{
+	  shdr32->sh_size = new_size;
+	  shdr32->sh_addralign = 1;
+	}
+      else
+	{
+	  shdr64->sh_size = new_size;
+	  shdr64->sh_addralign = 1;
+	}
+      scn->shdr_flags |= ELF_F_DIRTY;
+
+      __libelf_reset_rawdata (scn, out_buf, new_size, 1, ELF_T_BYTE);
+      result = 1;
+    }
+  else if (compress == 0)
+    {
+      Elf_Data *data = __elf_getdata_rdlock (scn, NULL);
+      if (data == NULL)
+	goto out;
+
+      const unsigned char *zbuf = data->d_buf;
+      size_t zsize = data->d_size;
+      if (zsize < GNU_ZLIB_HSIZE || memcmp (zbuf, "ZLIB", 4) != 0)
+	{
+	  
+	  if (scn->zdata_base != NULL && scn->rawdata_base == scn->zdata_base)
+	    result = 0;
+	  else
+	    __libelf_seterrno (ELF_E_NOT_COMPRESSED);
+	  goto out;
+	}
+
+      uint64_t size = 0;
+      for (int i = 4; i < GNU_ZLIB_HSIZE; ++i)
+	size = (size << 8) | zbuf[i];
+
+      if (unlikely (size != (size_t) size))
+	{
+	  __libelf_seterrno (ELF_E_DECOMPRESS_ERROR);
+	  goto out;
+	}
+
+      void *buf = __libelf_decompress ((void *) (zbuf + GNU_ZLIB_HSIZE),
+				       zsize - GNU_ZLIB_HSIZE, size);
+      if (buf == NULL)
+	goto out;
+
+      GElf_Xword align;
+      if (shdr32 != NULL)
+	{
+	  shdr32->sh_size = size;
+	  align = shdr32->sh_addralign;
+	}
+      else
+	{
+	  shdr64->sh_size = size;
+	  align = shdr64->sh_addralign;
+	}
+      scn->shdr_flags |= ELF_F_DIRTY;
+
+      __libelf_reset_rawdata (scn, buf, size, align ?: 1,
+			      __libelf_data_type (elf, sh_type));
+      result = 1;
+    }
+  else
+    __libelf_seterrno (ELF_E_INVALID_OPERAND);
+
+ out:
+  rwlock_unlock (elf->lock);
+
+  return result;
+}
@@ -141,7 +141,8 @@ elf_end (elf)
 		if (scn->data_base != scn->rawdata_base)
 		  free (scn->data_base);
 
-		if (elf->map_address == NULL)
+		if (elf->map_address == NULL
+		    || scn->rawdata_base == scn->zdata_base)
 		  free (scn->rawdata_base);
 
 		runp = scn->data_list.next;
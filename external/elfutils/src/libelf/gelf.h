@@ -93,6 +93,9 @@ typedef Elf64_Move GElf_Move;
 typedef Elf64_Lib GElf_Lib;
 
 
+typedef Elf64_Chdr GElf_Chdr;
+
+
 
 #define GELF_ST_BIND(val)		ELF64_ST_BIND (val)
 #define GELF_ST_TYPE(val)		ELF64_ST_TYPE (val)
@@ -238,6 +241,9 @@ extern size_t gelf_getnote (Elf_Data *__data, size_t __offset,
 
 extern long int gelf_checksum (Elf *__elf);
 
+
+extern GElf_Chdr *gelf_getchdr (Elf_Scn *__scn, GElf_Chdr *__dst);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,148 @@
+/* Return compression header.
+   Copyright (C) 2015 Red Hat, Inc.
+   This file is part of elfutils.
+
+   This file is free software; you can redistribute it and/or modify
+   it under the terms of either
+
+     * the GNU Lesser General Public License as published by the Free
+       Software Foundation; either version 3 of the License, or (at
+       your option) any later version
+
+   or
+
+     * the GNU General Public License as published by the Free
+       Software Foundation; either version 2 of the License, or (at
+       your option) any later version
+
+   or both in parallel, as here.
+
+   elfutils is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received copies of the GNU General Public License and
+   the GNU Lesser General Public License along with this program.  If
+   not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <gelf.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "libelfP.h"
+#include "common.h"
+
+
+size_t
+internal_function
+__libelf_read_chdr (Elf *elf, const void *buf, size_t size, GElf_Chdr *dest)
+{
+  int ei_data = (elf->class == ELFCLASS32
+		 || (offsetof (struct Elf, state.elf32.ehdr)
+		     == offsetof (struct Elf, state.elf64.ehdr))
+		 ? elf->state.elf32.ehdr->e_ident[EI_DATA]
+		 : elf->state.elf64.ehdr->e_ident[EI_DATA]);
+
+  if (elf->class == ELFCLASS32)
+    {
+      Elf32_Chdr chdr;
+      if (unlikely (size < sizeof chdr))
+	goto invalid;
+      memcpy (&chdr, buf, sizeof chdr);
+      if (ei_data != MY_ELFDATA)
+	{
+	  CONVERT (chdr.ch_type);
+	  CONVERT (chdr.ch_size);
+	  CONVERT (chdr.ch_addralign);
+	}
+      dest->ch_type = chdr.ch_type;
+      dest->ch_reserved = 0;
+      dest->ch_size = chdr.ch_size;
+      dest->ch_addralign = chdr.ch_addralign;
+      return sizeof chdr;
+    }
+  else
+    {
+      Elf64_Chdr chdr;
+      if (unlikely (size < sizeof chdr))
+	goto invalid;
+      memcpy (&chdr, buf, sizeof chdr);
+      if (ei_data != MY_ELFDATA)
+	{
+	  CONVERT (chdr.ch_type);
+	  CONVERT (chdr.ch_reserved);
+	  CONVERT (chdr.ch_size);
+	  CONVERT (chdr.ch_addralign);
+	}
+      *dest = chdr;
+      return sizeof chdr;
+    }
+
+ invalid:
+  __libelf_seterrno (ELF_E_INVALID_DATA);
+  return 0;
+}
+
+
+GElf_Chdr *
+gelf_getchdr (Elf_Scn *scn, GElf_Chdr *dest)
+{
+  GElf_Chdr *result = NULL;
+
+  if (scn == NULL)
+    return NULL;
+
+  if (dest == NULL)
+    {
+      __libelf_seterrno (ELF_E_INVALID_OPERAND);
+      return NULL;
+    }
+
+  Elf *elf = scn->elf;
+  if (unlikely (elf->kind != ELF_K_ELF))
+    {
+      __libelf_seterrno (ELF_E_INVALID_HANDLE);
+      return NULL;
+    }
+
+  rwlock_wrlock (elf->lock);
+
+  GElf_Xword flags;
+  if (elf->class == ELFCLASS32)
+    {
+      Elf32_Shdr *shdr = scn->shdr.e32 ?: __elf32_getshdr_wrlock (scn);
+      if (shdr == NULL)
+	goto out;
+      flags = shdr->sh_flags;
+    }
+  else
+    {
+      Elf64_Shdr *shdr = scn->shdr.e64 ?: __elf64_getshdr_wrlock (scn);
+      if (shdr == NULL)
+	goto out;
+      flags = shdr->sh_flags;
+    }
+
+  if ((flags & SHF_COMPRESSED) == 0)
+    {
+      __libelf_seterrno (ELF_E_NOT_COMPRESSED);
+      goto out;
+    }
+
+  Elf_Data *data = __elf_getdata_rdlock (scn, NULL);
+  if (data == NULL)
+    goto out;
+
+  if (__libelf_read_chdr (elf, data->d_buf, data->d_size, dest) != 0)
+    result = dest;
+
+ out:
+  rwlock_unlock (elf->lock);
+
+  return result;
+}
@@ -109,6 +109,13 @@ enum
 };
 
 
+enum
+{
+  ELF_CHF_FORCE = 0x1
+#define ELF_CHF_FORCE		ELF_CHF_FORCE
+};
+
+
 typedef enum
 {
   ELF_K_NONE,			
@@ -238,6 +245,12 @@ extern Elf_Data *elf_getdata_rawchunk (Elf *__elf,
 extern char *elf_strptr (Elf *__elf, size_t __index, size_t __offset);
 
 
+extern int elf_compress (Elf_Scn *__scn, int __type, unsigned int __flags);
+
+extern int elf_compress_gnu (Elf_Scn *__scn, int __compress,
+			     unsigned int __flags);
+
+
 extern Elf_Arhdr *elf_getarhdr (Elf *__elf);
 
 extern loff_t elf_getaroff (Elf *__elf);
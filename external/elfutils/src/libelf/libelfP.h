@@ -38,6 +38,7 @@
 #include <gelf.h>
 
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
@@ -130,6 +131,11 @@ enum
   ELF_E_INVALID_PHDR,
   ELF_E_NO_PHDR,
   ELF_E_INVALID_OFFSET,
+  ELF_E_NOT_COMPRESSED,
+  ELF_E_ALREADY_COMPRESSED,
+  ELF_E_UNKNOWN_COMPRESSION_TYPE,
+  ELF_E_COMPRESS_ERROR,
+  ELF_E_DECOMPRESS_ERROR,
   
   ELF_E_NUM
 };
@@ -175,6 +181,7 @@ struct Elf_Scn
 
   char *rawdata_base;		
   char *data_base;		
+  char *zdata_base;		
 
   struct Elf_ScnList *list;	
 };
@@ -366,6 +373,24 @@ extern int __libelf_readsections (Elf *elf) internal_function;
 extern int __libelf_set_rawdata (Elf_Scn *scn) internal_function;
 extern int __libelf_set_rawdata_wrlock (Elf_Scn *scn) internal_function;
 
+extern Elf_Type __libelf_data_type (Elf *elf, int sh_type) internal_function;
+
+extern void __libelf_reset_rawdata (Elf_Scn *scn, void *buf, size_t size,
+				    size_t align, Elf_Type type)
+     internal_function;
+
+extern int __libelf_unshare_shdrs_wrlock (Elf *elf) internal_function;
+
+extern void *__libelf_compress (Elf_Scn *scn, size_t hsize, int ei_data,
+				size_t *orig_size, size_t *new_size,
+				bool force) internal_function;
+
+extern void *__libelf_decompress (void *buf_in, size_t size_in,
+				  size_t size_out) internal_function;
+
+extern size_t __libelf_read_chdr (Elf *elf, const void *buf, size_t size,
+				  GElf_Chdr *dest) internal_function;
+
 
 extern off_t __elf32_updatenull_wrlock (Elf *elf, int *change_bop,
 					size_t shnum) internal_function;
@@ -31,6 +31,7 @@
 #include <libintl.h>
 #include <locale.h>
 #include <mcheck.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdio_ext.h>
@@ -48,6 +49,8 @@ ARGP_PROGRAM_BUG_ADDRESS_DEF = PACKAGE_BUGREPORT;
 
 
 #define OPT_DEMANGLER 0x100
+#define OPT_BATCH 0x101
+#define OPT_THREADS 0x102
 
 static const struct argp_option options[] =
 {
@@ -65,6 +68,12 @@ static const struct argp_option options[] =
     N_("Show all source locations that caused inline expansion of subroutines at the address."),
     0 },
 
+  { NULL, 0, NULL, 0, N_("Batch mode options:"), 3 },
+  { "batch", OPT_BATCH, "FILE", OPTION_ARG_OPTIONAL,
+    N_("Read ADDRs from FILE (standard input by default) and resolve them in sorted batches; output stays in input order"), 0 },
+  { "threads", OPT_THREADS, "NUM", 0,
+    N_("Resolve each batch with NUM threads"), 0 },
+
   { NULL, 0, NULL, 0, N_("Miscellaneous:"), 0 },
   
   { "target", 'b', "ARG", OPTION_HIDDEN, NULL, 0 },
@@ -90,6 +99,8 @@ static const struct argp argp =
 
 static int handle_address (const char *addr, Dwfl *dwfl);
 
+static int handle_batch (Dwfl *dwfl, int argc, char *argv[]);
+
 
 static bool only_basenames;
 
@@ -108,6 +119,13 @@ static const char *just_section;
 static bool show_inlines;
 
 
+static bool batch_mode;
+
+static const char *batch_file;
+
+static unsigned int batch_threads = 1;
+
+
 int
 main (int argc, char *argv[])
 {
@@ -136,7 +154,14 @@ main (int argc, char *argv[])
   (void) argp_parse (&argp, argc, argv, 0, &remaining, &dwfl);
   assert (dwfl != NULL);
 
-  if (remaining == argc)
+  if (batch_mode)
+    {
+      if (remaining != argc)
+	error (EXIT_FAILURE, 0,
+	       gettext ("--batch reads addresses from a file, not from the command line"));
+      result = handle_batch (dwfl, argc, argv);
+    }
+  else if (remaining == argc)
     {
       
       (void) __fsetlocking (stdin, FSETLOCKING_BYCALLER);
@@ -230,6 +255,21 @@ parse_opt (int key, char *arg, struct argp_state *state)
       show_inlines = true;
       break;
 
+    case OPT_BATCH:
+      batch_mode = true;
+      batch_file = arg;
+      break;
+
+    case OPT_THREADS:
+      {
+	char *endp;
+	unsigned long int n = strtoul (arg, &endp, 0);
+	if (*endp != '\0' || n == 0 || n > 1024)
+	  argp_error (state, gettext ("invalid number of threads '%s'"), arg);
+	batch_threads = n;
+      }
+      break;
+
     default:
       return ARGP_ERR_UNKNOWN;
     }
@@ -255,10 +295,12 @@ get_diename (Dwarf_Die *die)
 }
 
 static bool
-print_dwarf_function (Dwfl_Module *mod, Dwarf_Addr addr)
+print_dwarf_function (Dwfl_Module *mod, Dwarf_Addr addr, FILE *out)
 {
   Dwarf_Addr bias = 0;
   Dwarf_Die *cudie = dwfl_module_addrdie (mod, addr, &bias);
+  if (cudie == NULL)
+    return false;
 
   Dwarf_Die *scopes;
   int nscopes = dwarf_getscopes (cudie, addr - bias, &scopes);
@@ -273,7 +315,7 @@ print_dwarf_function (Dwfl_Module *mod, Dwarf_Addr addr)
 	  const char *name = get_diename (&scopes[i]);
 	  if (name == NULL)
 	    return false;
-	  puts (name);
+	  fprintf (out, "%s\n", name);
 	  return true;
 	}
 
@@ -282,7 +324,7 @@ print_dwarf_function (Dwfl_Module *mod, Dwarf_Addr addr)
 	  const char *name = get_diename (&scopes[i]);
 	  if (name == NULL)
 	    return false;
-	  printf ("%s inlined", name);
+	  fprintf (out, "%s inlined", name);
 
 	  Dwarf_Files *files;
 	  if (dwarf_getsrcfiles (cudie, &files, NULL) == 0)
@@ -325,17 +367,17 @@ print_dwarf_function (Dwfl_Module *mod, Dwarf_Addr addr)
 		    }
 
 		  if (lineno == 0)
-		    printf (" from %s%s%s",
-			    comp_dir, comp_dir_sep, file);
+		    fprintf (out, " from %s%s%s",
+			     comp_dir, comp_dir_sep, file);
 		  else if (colno == 0)
-		    printf (" at %s%s%s:%u",
-			    comp_dir, comp_dir_sep, file, lineno);
+		    fprintf (out, " at %s%s%s:%u",
+			     comp_dir, comp_dir_sep, file, lineno);
 		  else
-		    printf (" at %s%s%s:%u:%u",
-			    comp_dir, comp_dir_sep, file, lineno, colno);
+		    fprintf (out, " at %s%s%s:%u:%u",
+			     comp_dir, comp_dir_sep, file, lineno, colno);
 		}
 	    }
-	  printf (" in ");
+	  fputs (" in ", out);
 	  continue;
 	}
       }
@@ -344,7 +386,7 @@ print_dwarf_function (Dwfl_Module *mod, Dwarf_Addr addr)
 }
 
 static void
-print_addrsym (Dwfl_Module *mod, GElf_Addr addr)
+print_addrsym (Dwfl_Module *mod, GElf_Addr addr, FILE *out)
 {
   GElf_Sym s;
   GElf_Off off;
@@ -357,16 +399,16 @@ print_addrsym (Dwfl_Module *mod, GElf_Addr addr)
       if (i >= 0)
 	name = dwfl_module_relocation_info (mod, i, NULL);
       if (name == NULL)
-	puts ("??");
+	fputs ("??\n", out);
       else
-	printf ("(%s)+%#" PRIx64 "\n", name, addr);
+	fprintf (out, "(%s)+%#" PRIx64 "\n", name, addr);
     }
   else
     {
       if (off == 0)
-	printf ("%s", name);
+	fprintf (out, "%s", name);
       else
-	printf ("%s+%#" PRIx64 "", name, off);
+	fprintf (out, "%s+%#" PRIx64 "", name, off);
 
       
       if (show_symbol_sections)
@@ -382,12 +424,12 @@ print_addrsym (Dwfl_Module *mod, GElf_Addr addr)
 		  Elf *elf = dwfl_module_getelf (mod, &ebias);
 		  GElf_Ehdr ehdr;
 		  if (gelf_getehdr (elf, &ehdr) != NULL)
-		    printf (" (%s)", elf_strptr (elf, ehdr.e_shstrndx,
-						 shdr->sh_name));
+		    fprintf (out, " (%s)",
+			     elf_strptr (elf, ehdr.e_shstrndx, shdr->sh_name));
 		}
 	    }
 	}
-      puts ("");
+      fputc ('\n', out);
     }
 }
 
@@ -484,7 +526,8 @@ adjust_to_section (const char *name, uintmax_t *addr, Dwfl *dwfl)
 }
 
 static void
-print_src (const char *src, int lineno, int linecol, Dwarf_Die *cu)
+print_src (const char *src, int lineno, int linecol, Dwarf_Die *cu,
+	   FILE *out)
 {
   const char *comp_dir = "";
   const char *comp_dir_sep = "";
@@ -500,15 +543,15 @@ print_src (const char *src, int lineno, int linecol, Dwarf_Die *cu)
     }
 
   if (linecol != 0)
-    printf ("%s%s%s:%d:%d",
-	    comp_dir, comp_dir_sep, src, lineno, linecol);
+    fprintf (out, "%s%s%s:%d:%d",
+	     comp_dir, comp_dir_sep, src, lineno, linecol);
   else
-    printf ("%s%s%s:%d",
-	    comp_dir, comp_dir_sep, src, lineno);
+    fprintf (out, "%s%s%s:%d",
+	     comp_dir, comp_dir_sep, src, lineno);
 }
 
-static int
-handle_address (const char *string, Dwfl *dwfl)
+static bool
+parse_address (const char *string, Dwfl *dwfl, uintmax_t *addrp)
 {
   char *endp;
   uintmax_t addr = strtoumax (string, &endp, 0);
@@ -553,22 +596,123 @@ handle_address (const char *string, Dwfl *dwfl)
 
       free (name);
       if (!parsed)
-	return 1;
+	return false;
     }
   else if (just_section != NULL
 	   && !adjust_to_section (just_section, &addr, dwfl))
+    return false;
+
+  *addrp = addr;
+  return true;
+}
+
+struct inline_cache
+{
+  Dwfl_Module *mod;
+  Dwarf_Addr addr;
+  int result;
+  char *text;
+  size_t len;
+};
+
+static int
+print_inlines (Dwfl_Module *mod, Dwarf_Addr addr, FILE *out)
+{
+  Dwarf_Addr bias = 0;
+  Dwarf_Die *cudie = dwfl_module_addrdie (mod, addr, &bias);
+  if (cudie == NULL)
+    return 0;
+
+  Dwarf_Die *scopes = NULL;
+  int nscopes = dwarf_getscopes (cudie, addr - bias, &scopes);
+  if (nscopes < 0)
     return 1;
 
+  if (nscopes > 0)
+    {
+      Dwarf_Die subroutine;
+      Dwarf_Off dieoff = dwarf_dieoffset (&scopes[0]);
+      dwarf_offdie (dwfl_module_getdwarf (mod, &bias),
+		    dieoff, &subroutine);
+      free (scopes);
+
+      nscopes = dwarf_getscopes_die (&subroutine, &scopes);
+      if (nscopes > 1)
+	{
+	  Dwarf_Die cu;
+	  Dwarf_Files *files;
+	  if (dwarf_diecu (&scopes[0], &cu, NULL, NULL) != NULL
+	      && dwarf_getsrcfiles (cudie, &files, NULL) == 0)
+	    {
+	      for (int i = 0; i < nscopes - 1; i++)
+		{
+		  Dwarf_Word val;
+		  Dwarf_Attribute attr;
+		  Dwarf_Die *die = &scopes[i];
+		  if (dwarf_tag (die) != DW_TAG_inlined_subroutine)
+		    continue;
+
+		  if (show_functions)
+		    {
+		      for (int j = i + 1; j < nscopes; j++)
+			{
+			  Dwarf_Die *parent = &scopes[j];
+			  int tag = dwarf_tag (parent);
+			  if (tag == DW_TAG_inlined_subroutine
+			      || tag == DW_TAG_entry_point
+			      || tag == DW_TAG_subprogram)
+			    {
+			      fprintf (out, "%s\n", get_diename (parent));
+			      break;
+			    }
+			}
+		    }
+
+		  const char *src = NULL;
+		  int lineno = 0;
+		  int linecol = 0;
+		  if (dwarf_formudata (dwarf_attr (die, DW_AT_call_file,
+						   &attr), &val) == 0)
+		    src = dwarf_filesrc (files, val, NULL, NULL);
+
+		  if (dwarf_formudata (dwarf_attr (die, DW_AT_call_line,
+						   &attr), &val) == 0)
+		    lineno = val;
+
+		  if (dwarf_formudata (dwarf_attr (die, DW_AT_call_column,
+						   &attr), &val) == 0)
+		    linecol = val;
+
+		  if (src != NULL)
+		    {
+		      print_src (src, lineno, linecol, &cu, out);
+		      fputc ('\n', out);
+		    }
+		  else
+		    fputs ("??:0\n", out);
+		}
+	    }
+	}
+    }
+  free (scopes);
+
+  return 0;
+}
+
+static int
+print_address (Dwfl *dwfl, Dwarf_Addr addr, FILE *out,
+	       struct inline_cache *inlines)
+{
   Dwfl_Module *mod = dwfl_addrmodule (dwfl, addr);
 
   if (show_functions)
     {
-      if (! print_dwarf_function (mod, addr) && !show_symbols)
-	puts (dwfl_module_addrname (mod, addr) ?: "??");
+      if (! print_dwarf_function (mod, addr, out) && !show_symbols)
+	fprintf (out, "%s\n", dwfl_module_addrname (mod, addr) ?: "??");
     }
 
   if (show_symbols)
-    print_addrsym (mod, addr);
+    print_addrsym (mod, addr, out);
 
   Dwfl_Line *line = dwfl_module_getsrc (mod, addr);
 
@@ -578,7 +722,7 @@ handle_address (const char *string, Dwfl *dwfl)
   if (line != NULL && (src = dwfl_lineinfo (line, &addr, &lineno, &linecol,
 					    NULL, NULL)) != NULL)
     {
-      print_src (src, lineno, linecol, dwfl_linecu (line));
+      print_src (src, lineno, linecol, dwfl_linecu (line), out);
       if (show_flags)
 	{
 	  Dwarf_Addr bias;
@@ -590,14 +734,14 @@ handle_address (const char *string, Dwfl *dwfl)
 	  {
 	    bool flag;
 	    if ((*get) (info, &flag) == 0 && flag)
-	      fputs (note, stdout);
+	      fputs (note, out);
 	  }
 	  inline void show_int (int (*get) (Dwarf_Line *, unsigned int *),
 				const char *name)
 	  {
 	    unsigned int val;
 	    if ((*get) (info, &val) == 0 && val != 0)
-	      printf (" (%s %u)", name, val);
+	      fprintf (out, " (%s %u)", name, val);
 	  }
 
 	  show (&dwarf_linebeginstatement, " (is_stmt)");
@@ -607,91 +751,239 @@ handle_address (const char *string, Dwfl *dwfl)
 	  show_int (&dwarf_lineisa, "isa");
 	  show_int (&dwarf_linediscriminator, "discriminator");
 	}
-      putchar ('\n');
+      fputc ('\n', out);
     }
   else
-    puts ("??:0");
+    fputs ("??:0\n", out);
 
   if (show_inlines)
     {
-      Dwarf_Addr bias = 0;
-      Dwarf_Die *cudie = dwfl_module_addrdie (mod, addr, &bias);
+      if (inlines == NULL)
+	return print_inlines (mod, addr, out);
+
+      
+      if (inlines->text == NULL
+	  || inlines->mod != mod || inlines->addr != addr)
+	{
+	  free (inlines->text);
+	  FILE *text = open_memstream (&inlines->text, &inlines->len);
+	  if (text == NULL)
+	    error (EXIT_FAILURE, errno,
+		   gettext ("cannot allocate output buffer"));
+	  inlines->result = print_inlines (mod, addr, text);
+	  fclose (text);
+	  inlines->mod = mod;
+	  inlines->addr = addr;
+	}
+      fwrite_unlocked (inlines->text, 1, inlines->len, out);
+      return inlines->result;
+    }
+
+  return 0;
+}
+
+
+static int
+handle_address (const char *string, Dwfl *dwfl)
+{
+  uintmax_t addr;
+  if (! parse_address (string, dwfl, &addr))
+    return 1;
+
+  return print_address (dwfl, addr, stdout, NULL);
+}
+
+
+
+#define BATCH_SIZE 65536
+
+struct batch_entry
+{
+  Dwarf_Addr addr;
+  int result;
+  unsigned int worker;
+  size_t start;
+  size_t len;
+};
+
+struct batch_worker
+{
+  Dwfl *dwfl;
+  struct batch_entry **entries;
+  size_t nentries;
+  unsigned int id;
+  char *buf;
+  size_t size;
+  struct inline_cache inlines;
+};
+
+static int
+compare_batch_entries (const void *a, const void *b)
+{
+  const struct batch_entry *e1 = *(const struct batch_entry **) a;
+  const struct batch_entry *e2 = *(const struct batch_entry **) b;
+  return e1->addr < e2->addr ? -1 : e1->addr > e2->addr;
+}
+
+
+   
+   
+   
+static void *
+resolve_batch (void *arg)
+{
+  struct batch_worker *w = arg;
+
+  FILE *out = open_memstream (&w->buf, &w->size);
+  if (out == NULL)
+    error (EXIT_FAILURE, errno, gettext ("cannot allocate output buffer"));
+  (void) __fsetlocking (out, FSETLOCKING_BYCALLER);
+
+  struct batch_entry *prev = NULL;
+  for (size_t i = 0; i < w->nentries; ++i)
+    {
+      struct batch_entry *e = w->entries[i];
+      e->worker = w->id;
+      if (prev != NULL && prev->addr == e->addr)
+	{
+	  e->result = prev->result;
+	  e->start = prev->start;
+	  e->len = prev->len;
+	  continue;
+	}
 
-      Dwarf_Die *scopes = NULL;
-      int nscopes = dwarf_getscopes (cudie, addr - bias, &scopes);
-      if (nscopes < 0)
-	return 1;
+      e->start = ftello (out);
+      e->result = print_address (w->dwfl, e->addr, out, &w->inlines);
+      e->len = ftello (out) - e->start;
+      prev = e;
+    }
+
+  fclose (out);
+  return NULL;
+}
+
+static int
+handle_batch (Dwfl *dwfl, int argc, char *argv[])
+{
+  FILE *in = stdin;
+  if (batch_file != NULL && strcmp (batch_file, "-") != 0)
+    {
+      in = fopen (batch_file, "r");
+      if (in == NULL)
+	error (EXIT_FAILURE, errno, gettext ("cannot open '%s'"), batch_file);
+    }
+  (void) __fsetlocking (in, FSETLOCKING_BYCALLER);
+
+  
+     
+  struct batch_worker workers[batch_threads];
+  memset (workers, 0, sizeof workers);
+  workers[0].dwfl = dwfl;
+  for (unsigned int t = 1; t < batch_threads; ++t)
+    {
+      int remaining;
+      (void) argp_parse (&argp, argc, argv, 0, &remaining, &workers[t].dwfl);
+      assert (workers[t].dwfl != NULL);
+    }
 
-      if (nscopes > 0)
+  struct batch_entry *entries = malloc (BATCH_SIZE * sizeof entries[0]);
+  struct batch_entry **sorted = malloc (BATCH_SIZE * sizeof sorted[0]);
+  if (entries == NULL || sorted == NULL)
+    error (EXIT_FAILURE, errno, gettext ("cannot allocate memory"));
+
+  int result = 0;
+  char *buf = NULL;
+  size_t len = 0;
+  bool eof = false;
+  while (! eof)
+    {
+      
+	 
+	 
+      size_t n = 0;
+      size_t nsorted = 0;
+      while (n < BATCH_SIZE)
 	{
-	  Dwarf_Die subroutine;
-	  Dwarf_Off dieoff = dwarf_dieoffset (&scopes[0]);
-	  dwarf_offdie (dwfl_module_getdwarf (mod, &bias),
-			dieoff, &subroutine);
-	  free (scopes);
-
-	  nscopes = dwarf_getscopes_die (&subroutine, &scopes);
-	  if (nscopes > 1)
+	  ssize_t chars = getline (&buf, &len, in);
+	  if (chars < 0)
 	    {
-	      Dwarf_Die cu;
-	      Dwarf_Files *files;
-	      if (dwarf_diecu (&scopes[0], &cu, NULL, NULL) != NULL
-		  && dwarf_getsrcfiles (cudie, &files, NULL) == 0)
-		{
-		  for (int i = 0; i < nscopes - 1; i++)
-		    {
-		      Dwarf_Word val;
-		      Dwarf_Attribute attr;
-		      Dwarf_Die *die = &scopes[i];
-		      if (dwarf_tag (die) != DW_TAG_inlined_subroutine)
-			continue;
+	      eof = true;
+	      break;
+	    }
 
-		      if (show_functions)
-			{
-			  for (int j = i + 1; j < nscopes; j++)
-			    {
-			      Dwarf_Die *parent = &scopes[j];
-			      int tag = dwarf_tag (parent);
-			      if (tag == DW_TAG_inlined_subroutine
-				  || tag == DW_TAG_entry_point
-				  || tag == DW_TAG_subprogram)
-				{
-				  puts (get_diename (parent));
-				  break;
-				}
-			    }
-			}
+	  if (buf[chars - 1] == '\n')
+	    buf[chars - 1] = '\0';
 
-		      src = NULL;
-		      lineno = 0;
-		      linecol = 0;
-		      if (dwarf_formudata (dwarf_attr (die, DW_AT_call_file,
-						       &attr), &val) == 0)
-			src = dwarf_filesrc (files, val, NULL, NULL);
+	  struct batch_entry *e = &entries[n++];
+	  uintmax_t addr;
+	  e->result = 1;
+	  e->len = 0;
+	  if (parse_address (buf, dwfl, &addr))
+	    {
+	      e->addr = addr;
+	      sorted[nsorted++] = e;
+	    }
+	}
 
-		      if (dwarf_formudata (dwarf_attr (die, DW_AT_call_line,
-						       &attr), &val) == 0)
-			lineno = val;
+      if (n == 0)
+	break;
 
-		      if (dwarf_formudata (dwarf_attr (die, DW_AT_call_column,
-						       &attr), &val) == 0)
-			linecol = val;
+      qsort (sorted, nsorted, sizeof sorted[0], compare_batch_entries);
 
-		      if (src != NULL)
-			{
-			  print_src (src, lineno, linecol, &cu);
-			  putchar ('\n');
-			}
-		      else
-			puts ("??:0");
-		    }
-		}
-	    }
+      
+      unsigned int nworkers = 0;
+      size_t per_worker = (nsorted + batch_threads - 1) / batch_threads;
+      for (size_t first = 0; first < nsorted; first += per_worker)
+	{
+	  struct batch_worker *w = &workers[nworkers];
+	  w->entries = &sorted[first];
+	  w->nentries = (nsorted - first < per_worker
+			 ? nsorted - first : per_worker);
+	  w->id = nworkers++;
+	  w->buf = NULL;
+	  w->size = 0;
 	}
-      free (scopes);
+
+      pthread_t threads[nworkers];
+      for (unsigned int t = 1; t < nworkers; ++t)
+	{
+	  int err = pthread_create (&threads[t], NULL, resolve_batch,
+				    &workers[t]);
+	  if (err != 0)
+	    error (EXIT_FAILURE, err, gettext ("cannot create thread"));
+	}
+      if (nworkers > 0)
+	resolve_batch (&workers[0]);
+      for (unsigned int t = 1; t < nworkers; ++t)
+	pthread_join (threads[t], NULL);
+
+      for (size_t i = 0; i < n; ++i)
+	{
+	  struct batch_entry *e = &entries[i];
+	  if (e->len != 0)
+	    fwrite_unlocked (workers[e->worker].buf + e->start, 1, e->len,
+			     stdout);
+	  if (e->result != 0)
+	    result = e->result;
+	}
+
+      for (unsigned int t = 0; t < nworkers; ++t)
+	free (workers[t].buf);
     }
 
-  return 0;
+  free (buf);
+  free (sorted);
+  free (entries);
+  for (unsigned int t = 0; t < batch_threads; ++t)
+    {
+      free (workers[t].inlines.text);
+      if (t > 0)
+	dwfl_end (workers[t].dwfl);
+    }
+  if (in != stdin)
+    fclose (in);
+
+  return result;
 }
 
 
@@ -30,6 +30,7 @@
 #include <inttypes.h>
 #include <libintl.h>
 #include <locale.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
@@ -64,6 +65,9 @@ static const struct argp_option options[] =
   { "gnu-ld", ARGP_gnuld, NULL, 0,
     N_("Binary has been created with GNU ld and is therefore known to be \
 broken in certain ways"), 0 },
+  { "jobs", 'j', "JOBS", 0,
+    N_("Check symbol tables and relocation sections with JOBS concurrent "
+       "jobs (default 1)"), 0 },
   { NULL, 0, NULL, 0, NULL, 0 }
 };
 
@@ -91,11 +95,15 @@ static void check_note_section (Ebl *ebl, GElf_Ehdr *ehdr,
 
 #define ERROR(str, args...) \
   do {									      \
-    printf (str, ##args);						      \
-    ++error_count;							      \
+    fprintf (section_output ?: stdout, str, ##args);			      \
+    __atomic_add_fetch (&error_count, 1, __ATOMIC_RELAXED);		      \
   } while (0)
 static unsigned int error_count;
 
+static __thread FILE *section_output;
+
+static int jobs = 1;
+
 static bool be_strict;
 
 static bool be_quiet;
@@ -178,8 +186,7 @@ main (int argc, char *argv[])
 
 
 static error_t
-parse_opt (int key, char *arg __attribute__ ((unused)),
-	   struct argp_state *state __attribute__ ((unused)))
+parse_opt (int key, char *arg, struct argp_state *state)
 {
   switch (key)
     {
@@ -198,6 +205,15 @@ parse_opt (int key, char *arg __attribute__ ((unused)),
       gnuld = true;
       break;
 
+    case 'j':
+      jobs = atoi (arg);
+      if (jobs < 1)
+	{
+	  argp_error (state, N_("-j JOBS should be 1 or higher."));
+	  return EINVAL;
+	}
+      break;
+
     case ARGP_KEY_NO_ARGS:
       fputs (gettext ("Missing file name.\n"), stderr);
       argp_help (&argp, stderr, ARGP_HELP_SEE, program_invocation_short_name);
@@ -1225,14 +1241,14 @@ section [%2d] '%s': section entry size does not match ElfXX_Rel\n"),
 			|| (dyn->d_tag == DT_FLAGS
 			    && (dyn->d_un.d_val & DF_TEXTREL) != 0)))
 		  {
-		    textrel = true;
+		    __atomic_store_n (&textrel, true, __ATOMIC_RELAXED);
 		    break;
 		  }
 	      }
 	}
     }
 
-  if (textrel)
+  if (__atomic_load_n (&textrel, __ATOMIC_RELAXED))
     {
       struct loaded_segment *seg = *loadedp;
       while (seg != NULL && !seg->read_only)
@@ -1346,8 +1362,8 @@ section [%2d] '%s': relocation %zu: offset out of bounds\n"),
 	      
 	      if  (loaded->read_only)
 		{
-		  if (textrel)
-		    needed_textrel = true;
+		  if (__atomic_load_n (&textrel, __ATOMIC_RELAXED))
+		    __atomic_store_n (&needed_textrel, true, __ATOMIC_RELAXED);
 		  else
 		    ERROR (gettext ("section [%2d] '%s': relocation %zu: read-only section modified but text relocation flag not set\n"),
 			   idx, section_name (ebl, idx), cnt);
@@ -2509,7 +2525,8 @@ section_flags_string (GElf_Word flags, char *buf, size_t len)
       NEWFLAG (LINK_ORDER),
       NEWFLAG (OS_NONCONFORMING),
       NEWFLAG (GROUP),
-      NEWFLAG (TLS)
+      NEWFLAG (TLS),
+      NEWFLAG (COMPRESSED)
     };
 #undef NEWFLAG
   const size_t nknown_flags = sizeof (known_flags) / sizeof (known_flags[0]);
@@ -3345,6 +3362,94 @@ static const struct
 	       sizeof string - (prefix ? 1 : 0)))
 
 
+struct section_check
+{
+  FILE *out;
+  char *buf;
+  size_t size;
+  void (*check) (Ebl *ebl, GElf_Ehdr *ehdr, GElf_Shdr *shdr, int idx);
+  GElf_Shdr shdr;
+};
+
+struct check_jobs
+{
+  Ebl *ebl;
+  GElf_Ehdr *ehdr;
+  struct section_check *checks;
+  size_t nchecks;
+  size_t next;
+};
+
+static void *
+check_worker (void *arg)
+{
+  struct check_jobs *cj = (struct check_jobs *) arg;
+  size_t i;
+  while ((i = __atomic_fetch_add (&cj->next, 1, __ATOMIC_RELAXED))
+	 < cj->nchecks)
+    {
+      struct section_check *sc = &cj->checks[i];
+      if (sc->check == NULL)
+	continue;
+
+      section_output = sc->out;
+      sc->check (cj->ebl, cj->ehdr, &sc->shdr, i);
+    }
+  section_output = NULL;
+  return NULL;
+}
+
+static void
+run_section_checks (Ebl *ebl, GElf_Ehdr *ehdr, struct section_check *checks)
+{
+  size_t n = 0;
+  for (size_t cnt = 1; cnt < shnum; ++cnt)
+    if (checks[cnt].check != NULL)
+      ++n;
+
+  if (n > 0)
+    {
+      
+      Elf_Scn *scn = NULL;
+      while ((scn = elf_nextscn (ebl->elf, scn)) != NULL)
+	{
+	  GElf_Shdr shdr_mem;
+	  GElf_Shdr *shdr = gelf_getshdr (scn, &shdr_mem);
+	  if (shdr != NULL && shdr->sh_type != SHT_NOBITS)
+	    (void) elf_getdata (scn, NULL);
+	}
+
+      struct check_jobs cj =
+	{
+	  .ebl = ebl,
+	  .ehdr = ehdr,
+	  .checks = checks,
+	  .nchecks = shnum
+	};
+      size_t nworkers = (size_t) jobs < n ? (size_t) jobs : n;
+      pthread_t workers[nworkers];
+      for (size_t w = 1; w < nworkers; ++w)
+	{
+	  int err = pthread_create (&workers[w], NULL, check_worker, &cj);
+	  if (err != 0)
+	    error (EXIT_FAILURE, err, "pthread_create");
+	}
+      check_worker (&cj);
+      for (size_t w = 1; w < nworkers; ++w)
+	pthread_join (workers[w], NULL);
+    }
+
+  
+  for (size_t cnt = 1; cnt < shnum; ++cnt)
+    if (checks[cnt].out != NULL)
+      {
+	fclose (checks[cnt].out);
+	fwrite (checks[cnt].buf, 1, checks[cnt].size, stdout);
+	free (checks[cnt].buf);
+      }
+  free (checks);
+}
+
 static size_t eh_frame_hdr_scnndx;
 static size_t eh_frame_scnndx;
 static size_t gcc_except_table_scnndx;
@@ -3402,8 +3507,24 @@ zeroth section has nonzero link value while ELF header does not signal overflow
   size_t gnu_hash_idx = 0;
 
   size_t versym_scnndx = 0;
+
+  
+  struct section_check *checks = NULL;
+  if (jobs > 1)
+    checks = xcalloc (shnum, sizeof checks[0]);
+
   for (size_t cnt = 1; cnt < shnum; ++cnt)
     {
+      if (checks != NULL)
+	{
+	  section_output = open_memstream (&checks[cnt].buf,
+					   &checks[cnt].size);
+	  if (section_output == NULL)
+	    error (EXIT_FAILURE, errno,
+		   gettext ("cannot open memory stream"));
+	  checks[cnt].out = section_output;
+	}
+
       shdr = gelf_getshdr (elf_getscn (ebl->elf, cnt), &shdr_mem);
       if (shdr == NULL)
 	{
@@ -3450,7 +3571,8 @@ section [%2d] '%s' has wrong type: expected %s, is %s\n"),
 		if (special_sections[s].attrflag == exact
 		    || special_sections[s].attrflag == exact_or_gnuld)
 		  {
-		    if ((shdr->sh_flags & ~(SHF_LINK_ORDER | SHF_GROUP))
+		    if ((shdr->sh_flags & ~(SHF_LINK_ORDER | SHF_GROUP
+					    | SHF_COMPRESSED))
 			!= special_sections[s].attr
 			&& (special_sections[s].attrflag == exact || !gnuld))
 		      ERROR (gettext ("\
@@ -3467,6 +3589,7 @@ section [%2zu] '%s' has wrong flags: expected %s, is %s\n"),
 		    if ((shdr->sh_flags & special_sections[s].attr)
 			!= special_sections[s].attr
 			|| ((shdr->sh_flags & ~(SHF_LINK_ORDER | SHF_GROUP
+						| SHF_COMPRESSED
 						| special_sections[s].attr
 						| special_sections[s].attr2))
 			    != 0))
@@ -3538,7 +3661,8 @@ section [%2zu] '%s' has SHF_ALLOC flag not set but there are loadable segments\n
 	    gcc_except_table_scnndx = cnt;
 	}
 
-      if (shdr->sh_entsize != 0 && shdr->sh_size % shdr->sh_entsize)
+      if (shdr->sh_entsize != 0 && shdr->sh_size % shdr->sh_entsize
+	  && (shdr->sh_flags & SHF_COMPRESSED) == 0)
 	ERROR (gettext ("\
 section [%2zu] '%s': size not multiple of entry size\n"),
 	       cnt, section_name (ebl, cnt));
@@ -3560,7 +3684,8 @@ section [%2zu] '%s': size not multiple of entry size\n"),
 
 #define ALL_SH_FLAGS (SHF_WRITE | SHF_ALLOC | SHF_EXECINSTR | SHF_MERGE \
 		      | SHF_STRINGS | SHF_INFO_LINK | SHF_LINK_ORDER \
-		      | SHF_OS_NONCONFORMING | SHF_GROUP | SHF_TLS)
+		      | SHF_OS_NONCONFORMING | SHF_GROUP | SHF_TLS \
+		      | SHF_COMPRESSED)
       if (shdr->sh_flags & ~(GElf_Xword) ALL_SH_FLAGS)
 	{
 	  GElf_Xword sh_flags = shdr->sh_flags & ~(GElf_Xword) ALL_SH_FLAGS;
@@ -3579,6 +3704,18 @@ section [%2zu] '%s': size not multiple of entry size\n"),
 			    " %#" PRIx64 "\n"),
 		   cnt, section_name (ebl, cnt), sh_flags);
 	}
+      if (shdr->sh_flags & SHF_COMPRESSED)
+	{
+	  if (shdr->sh_flags & SHF_ALLOC)
+	    ERROR (gettext ("\
+section [%2zu] '%s': compressed section with SHF_ALLOC flag set\n"),
+		   cnt, section_name (ebl, cnt));
+
+	  if (shdr->sh_type == SHT_NOBITS)
+	    ERROR (gettext ("\
+section [%2zu] '%s': compressed section of type SHT_NOBITS\n"),
+		   cnt, section_name (ebl, cnt));
+	}
       if (shdr->sh_flags & SHF_TLS)
 	{
 	  
@@ -3729,15 +3866,33 @@ section [%2zu] '%s': relocatable files cannot have dynamic symbol tables\n"),
 		   cnt, section_name (ebl, cnt));
 	  
 	case SHT_SYMTAB:
-	  check_symtab (ebl, ehdr, shdr, cnt);
+	  if (checks != NULL)
+	    {
+	      checks[cnt].check = check_symtab;
+	      checks[cnt].shdr = *shdr;
+	    }
+	  else
+	    check_symtab (ebl, ehdr, shdr, cnt);
 	  break;
 
 	case SHT_RELA:
-	  check_rela (ebl, ehdr, shdr, cnt);
+	  if (checks != NULL)
+	    {
+	      checks[cnt].check = check_rela;
+	      checks[cnt].shdr = *shdr;
+	    }
+	  else
+	    check_rela (ebl, ehdr, shdr, cnt);
 	  break;
 
 	case SHT_REL:
-	  check_rel (ebl, ehdr, shdr, cnt);
+	  if (checks != NULL)
+	    {
+	      checks[cnt].check = check_rel;
+	      checks[cnt].shdr = *shdr;
+	    }
+	  else
+	    check_rel (ebl, ehdr, shdr, cnt);
 	  break;
 
 	case SHT_DYNAMIC:
@@ -3794,6 +3949,12 @@ section [%2zu] '%s': relocatable files cannot have dynamic symbol tables\n"),
 	}
     }
 
+  if (checks != NULL)
+    {
+      section_output = NULL;
+      run_section_checks (ebl, ehdr, checks);
+    }
+
   if (has_interp_segment && !dot_interp_section)
     ERROR (gettext ("INTERP program header entry but no .interp section\n"));
 
@@ -34,6 +34,7 @@
 #include <libdwfl.h>
 #include <libintl.h>
 #include <locale.h>
+#include <pthread.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdlib.h>
@@ -108,6 +109,9 @@ static const struct argp_option options[] =
     N_("Display just offsets instead of resolving values to addresses in DWARF data"), 0 },
   { "wide", 'W', NULL, 0,
     N_("Ignored for compatibility (lines always wide)"), 0 },
+  { "jobs", 'j', "JOBS", 0,
+    N_("Format relocations, symbol tables and DWARF units with JOBS "
+       "concurrent jobs (default 1)"), 0 },
   { NULL, 0, NULL, 0, NULL, 0 }
 };
 
@@ -201,6 +205,10 @@ struct section_argument
 static size_t shnum;
 static size_t phnum;
 
+static int jobs = 1;
+
+static __thread FILE *output;
+
 
 static void process_file (int fd, const char *fname, bool only_one);
 static void process_elf_file (Dwfl_Module *dwflmod, int fd);
@@ -245,6 +253,8 @@ main (int argc, char *argv[])
   int remaining;
   argp_parse (&argp, argc, argv, 0, &remaining, NULL);
 
+  output = stdout;
+
   
   elf_version (EV_CURRENT);
 
@@ -271,8 +281,7 @@ main (int argc, char *argv[])
 
 
 static error_t
-parse_opt (int key, char *arg,
-	   struct argp_state *state __attribute__ ((unused)))
+parse_opt (int key, char *arg, struct argp_state *state)
 {
   void add_dump_section (const char *name, bool implicit)
   {
@@ -445,6 +454,14 @@ parse_opt (int key, char *arg,
       break;
     case 'W':			
       break;
+    case 'j':
+      jobs = atoi (arg);
+      if (jobs < 1)
+	{
+	  argp_error (state, N_("-j JOBS should be 1 or higher."));
+	  return EINVAL;
+	}
+      break;
     case ELF_INPUT_SECTION:
       if (arg == NULL)
 	elf_input_section = ".gnu_debugdata";
@@ -595,7 +612,7 @@ check_archive_index (int fd, const char *fname, bool only_one)
       if (elf_kind (elf) == ELF_K_AR)
 	{
 	  if (!only_one)
-	    printf ("\n%s:\n\n", fname);
+	    fprintf (output, "\n%s:\n\n", fname);
 	  dump_archive_index (elf, fname);
 	}
       else
@@ -644,7 +661,7 @@ process_dwflmod (Dwfl_Module *dwflmod,
       const char *fname;
       dwfl_module_info (dwflmod, NULL, NULL, NULL, NULL, NULL, &fname, NULL);
 
-      printf ("\n%s:\n\n", fname);
+      fprintf (output, "\n%s:\n\n", fname);
     }
 
   process_elf_file (dwflmod, a->fd);
@@ -866,104 +883,112 @@ print_file_type (unsigned short int e_type)
 	N_("DYN (Shared object file)"),
 	N_("CORE (Core file)")
       };
-      puts (gettext (knowntypes[e_type]));
+      fprintf (output, "%s\n", gettext (knowntypes[e_type]));
     }
   else if (e_type >= ET_LOOS && e_type <= ET_HIOS)
-    printf (gettext ("OS Specific: (%x)\n"),  e_type);
+    fprintf (output, gettext ("OS Specific: (%x)\n"),  e_type);
   else if (e_type >= ET_LOPROC )
-    printf (gettext ("Processor Specific: (%x)\n"),  e_type);
+    fprintf (output, gettext ("Processor Specific: (%x)\n"),  e_type);
   else
-    puts ("???");
+    fprintf (output, "%s\n", "???");
 }
 
 
 static void
 print_ehdr (Ebl *ebl, GElf_Ehdr *ehdr)
 {
-  fputs_unlocked (gettext ("ELF Header:\n  Magic:  "), stdout);
+  fputs_unlocked (gettext ("ELF Header:\n  Magic:  "), output);
   for (size_t cnt = 0; cnt < EI_NIDENT; ++cnt)
-    printf (" %02hhx", ehdr->e_ident[cnt]);
+    fprintf (output, " %02hhx", ehdr->e_ident[cnt]);
 
-  printf (gettext ("\n  Class:                             %s\n"),
-	  ehdr->e_ident[EI_CLASS] == ELFCLASS32 ? "ELF32"
-	  : ehdr->e_ident[EI_CLASS] == ELFCLASS64 ? "ELF64"
-	  : "\?\?\?");
+  fprintf (output, gettext ("\n  Class:                             %s\n"),
+	   ehdr->e_ident[EI_CLASS] == ELFCLASS32 ? "ELF32"
+	   : ehdr->e_ident[EI_CLASS] == ELFCLASS64 ? "ELF64"
+	   : "\?\?\?");
 
-  printf (gettext ("  Data:                              %s\n"),
-	  ehdr->e_ident[EI_DATA] == ELFDATA2LSB
-	  ? "2's complement, little endian"
-	  : ehdr->e_ident[EI_DATA] == ELFDATA2MSB
-	  ? "2's complement, big endian" : "\?\?\?");
+  fprintf (output, gettext ("  Data:                              %s\n"),
+	   ehdr->e_ident[EI_DATA] == ELFDATA2LSB
+	   ? "2's complement, little endian"
+	   : ehdr->e_ident[EI_DATA] == ELFDATA2MSB
+	   ? "2's complement, big endian" : "\?\?\?");
 
-  printf (gettext ("  Ident Version:                     %hhd %s\n"),
-	  ehdr->e_ident[EI_VERSION],
-	  ehdr->e_ident[EI_VERSION] == EV_CURRENT ? gettext ("(current)")
-	  : "(\?\?\?)");
+  fprintf (output, gettext ("  Ident Version:                     %hhd %s\n"),
+	   ehdr->e_ident[EI_VERSION],
+	   ehdr->e_ident[EI_VERSION] == EV_CURRENT ? gettext ("(current)")
+	   : "(\?\?\?)");
 
   char buf[512];
-  printf (gettext ("  OS/ABI:                            %s\n"),
-	  ebl_osabi_name (ebl, ehdr->e_ident[EI_OSABI], buf, sizeof (buf)));
+  fprintf (output, gettext ("  OS/ABI:                            %s\n"),
+	   ebl_osabi_name (ebl, ehdr->e_ident[EI_OSABI], buf, sizeof (buf)));
 
-  printf (gettext ("  ABI Version:                       %hhd\n"),
-	  ehdr->e_ident[EI_ABIVERSION]);
+  fprintf (output, gettext ("  ABI Version:                       %hhd\n"),
+	   ehdr->e_ident[EI_ABIVERSION]);
 
-  fputs_unlocked (gettext ("  Type:                              "), stdout);
+  fputs_unlocked (gettext ("  Type:                              "), output);
   print_file_type (ehdr->e_type);
 
-  printf (gettext ("  Machine:                           %s\n"), ebl->name);
+  fprintf (output, gettext ("  Machine:                           %s\n"),
+	   ebl->name);
 
-  printf (gettext ("  Version:                           %d %s\n"),
-	  ehdr->e_version,
-	  ehdr->e_version  == EV_CURRENT ? gettext ("(current)") : "(\?\?\?)");
+  fprintf (output, gettext ("  Version:                           %d %s\n"),
+	   ehdr->e_version,
+	   ehdr->e_version  == EV_CURRENT
+	   ? gettext ("(current)") : "(\?\?\?)");
 
-  printf (gettext ("  Entry point address:               %#" PRIx64 "\n"),
-	  ehdr->e_entry);
+  fprintf (output, gettext ("  Entry point address:               %#"
+			    PRIx64 "\n"),
+	   ehdr->e_entry);
 
-  printf (gettext ("  Start of program headers:          %" PRId64 " %s\n"),
-	  ehdr->e_phoff, gettext ("(bytes into file)"));
+  fprintf (output, gettext ("  Start of program headers:          %"
+			    PRId64 " %s\n"),
+	   ehdr->e_phoff, gettext ("(bytes into file)"));
 
-  printf (gettext ("  Start of section headers:          %" PRId64 " %s\n"),
-	  ehdr->e_shoff, gettext ("(bytes into file)"));
+  fprintf (output, gettext ("  Start of section headers:          %"
+			    PRId64 " %s\n"),
+	   ehdr->e_shoff, gettext ("(bytes into file)"));
 
-  printf (gettext ("  Flags:                             %s\n"),
-	  ebl_machine_flag_name (ebl, ehdr->e_flags, buf, sizeof (buf)));
+  fprintf (output, gettext ("  Flags:                             %s\n"),
+	   ebl_machine_flag_name (ebl, ehdr->e_flags, buf, sizeof (buf)));
 
-  printf (gettext ("  Size of this header:               %" PRId16 " %s\n"),
-	  ehdr->e_ehsize, gettext ("(bytes)"));
+  fprintf (output, gettext ("  Size of this header:               %"
+			    PRId16 " %s\n"),
+	   ehdr->e_ehsize, gettext ("(bytes)"));
 
-  printf (gettext ("  Size of program header entries:    %" PRId16 " %s\n"),
-	  ehdr->e_phentsize, gettext ("(bytes)"));
+  fprintf (output, gettext ("  Size of program header entries:    %"
+			    PRId16 " %s\n"),
+	   ehdr->e_phentsize, gettext ("(bytes)"));
 
-  printf (gettext ("  Number of program headers entries: %" PRId16),
-	  ehdr->e_phnum);
+  fprintf (output, gettext ("  Number of program headers entries: %" PRId16),
+	   ehdr->e_phnum);
   if (ehdr->e_phnum == PN_XNUM)
     {
       GElf_Shdr shdr_mem;
       GElf_Shdr *shdr = gelf_getshdr (elf_getscn (ebl->elf, 0), &shdr_mem);
       if (shdr != NULL)
-	printf (gettext (" (%" PRIu32 " in [0].sh_info)"),
-		(uint32_t) shdr->sh_info);
+	fprintf (output, gettext (" (%" PRIu32 " in [0].sh_info)"),
+		 (uint32_t) shdr->sh_info);
       else
-	fputs_unlocked (gettext (" ([0] not available)"), stdout);
+	fputs_unlocked (gettext (" ([0] not available)"), output);
     }
-  fputc_unlocked ('\n', stdout);
+  fputc_unlocked ('\n', output);
 
-  printf (gettext ("  Size of section header entries:    %" PRId16 " %s\n"),
-	  ehdr->e_shentsize, gettext ("(bytes)"));
+  fprintf (output, gettext ("  Size of section header entries:    %"
+			    PRId16 " %s\n"),
+	   ehdr->e_shentsize, gettext ("(bytes)"));
 
-  printf (gettext ("  Number of section headers entries: %" PRId16),
-	  ehdr->e_shnum);
+  fprintf (output, gettext ("  Number of section headers entries: %" PRId16),
+	   ehdr->e_shnum);
   if (ehdr->e_shnum == 0)
     {
       GElf_Shdr shdr_mem;
       GElf_Shdr *shdr = gelf_getshdr (elf_getscn (ebl->elf, 0), &shdr_mem);
       if (shdr != NULL)
-	printf (gettext (" (%" PRIu32 " in [0].sh_size)"),
-		(uint32_t) shdr->sh_size);
+	fprintf (output, gettext (" (%" PRIu32 " in [0].sh_size)"),
+		 (uint32_t) shdr->sh_size);
       else
-	fputs_unlocked (gettext (" ([0] not available)"), stdout);
+	fputs_unlocked (gettext (" ([0] not available)"), output);
     }
-  fputc_unlocked ('\n', stdout);
+  fputc_unlocked ('\n', output);
 
   if (unlikely (ehdr->e_shstrndx == SHN_XINDEX))
     {
@@ -979,12 +1004,14 @@ print_ehdr (Ebl *ebl, GElf_Ehdr *ehdr)
 	  buf[sizeof (buf) - 1] = '\0';
 	}
 
-      printf (gettext ("  Section header string table index: XINDEX%s\n\n"),
-	      buf);
+      fprintf (output,
+	       gettext ("  Section header string table index: XINDEX%s\n\n"),
+	       buf);
     }
   else
-    printf (gettext ("  Section header string table index: %" PRId16 "\n\n"),
-	    ehdr->e_shstrndx);
+    fprintf (output, gettext ("  Section header string table index: %"
+			      PRId16 "\n\n"),
+	     ehdr->e_shstrndx);
 }
 
 
@@ -1014,22 +1041,24 @@ print_shdr (Ebl *ebl, GElf_Ehdr *ehdr)
   size_t shstrndx;
 
   if (! print_file_header)
-    printf (gettext ("\
+    fprintf (output, gettext ("\
 There are %d section headers, starting at offset %#" PRIx64 ":\n\
 \n"),
-	    ehdr->e_shnum, ehdr->e_shoff);
+	     ehdr->e_shnum, ehdr->e_shoff);
 
   
   if (unlikely (elf_getshdrstrndx (ebl->elf, &shstrndx) < 0))
     error (EXIT_FAILURE, 0,
 	   gettext ("cannot get section header string table index"));
 
-  puts (gettext ("Section Headers:"));
+  fprintf (output, "%s\n", gettext ("Section Headers:"));
 
   if (ehdr->e_ident[EI_CLASS] == ELFCLASS32)
-    puts (gettext ("[Nr] Name                 Type         Addr     Off    Size   ES Flags Lk Inf Al"));
+    fprintf (output, "%s\n",
+	     gettext ("[Nr] Name                 Type         Addr     Off    Size   ES Flags Lk Inf Al"));
   else
-    puts (gettext ("[Nr] Name                 Type         Addr             Off      Size     ES Flags Lk Inf Al"));
+    fprintf (output, "%s\n",
+	     gettext ("[Nr] Name                 Type         Addr             Off      Size     ES Flags Lk Inf Al"));
 
   for (cnt = 0; cnt < shnum; ++cnt)
     {
@@ -1070,26 +1099,28 @@ There are %d section headers, starting at offset %#" PRIx64 ":\n\
 	*cp++ = 'T';
       if (shdr->sh_flags & SHF_ORDERED)
 	*cp++ = 'O';
+      if (shdr->sh_flags & SHF_COMPRESSED)
+	*cp++ = 'C';
       if (shdr->sh_flags & SHF_EXCLUDE)
 	*cp++ = 'E';
       *cp = '\0';
 
       char buf[128];
-      printf ("[%2zu] %-20s %-12s %0*" PRIx64 " %0*" PRIx64 " %0*" PRIx64
-	      " %2" PRId64 " %-5s %2" PRId32 " %3" PRId32
-	      " %2" PRId64 "\n",
-	      cnt,
-	      elf_strptr (ebl->elf, shstrndx, shdr->sh_name)
-	      ?: "<corrupt>",
-	      ebl_section_type_name (ebl, shdr->sh_type, buf, sizeof (buf)),
-	      ehdr->e_ident[EI_CLASS] == ELFCLASS32 ? 8 : 16, shdr->sh_addr,
-	      ehdr->e_ident[EI_CLASS] == ELFCLASS32 ? 6 : 8, shdr->sh_offset,
-	      ehdr->e_ident[EI_CLASS] == ELFCLASS32 ? 6 : 8, shdr->sh_size,
-	      shdr->sh_entsize, flagbuf, shdr->sh_link, shdr->sh_info,
-	      shdr->sh_addralign);
+      fprintf (output, "[%2zu] %-20s %-12s %0*" PRIx64 " %0*" PRIx64
+	       " %0*" PRIx64 " %2" PRId64 " %-5s %2" PRId32 " %3" PRId32
+	       " %2" PRId64 "\n",
+	       cnt,
+	       elf_strptr (ebl->elf, shstrndx, shdr->sh_name)
+	       ?: "<corrupt>",
+	       ebl_section_type_name (ebl, shdr->sh_type, buf, sizeof (buf)),
+	       ehdr->e_ident[EI_CLASS] == ELFCLASS32 ? 8 : 16, shdr->sh_addr,
+	       ehdr->e_ident[EI_CLASS] == ELFCLASS32 ? 6 : 8, shdr->sh_offset,
+	       ehdr->e_ident[EI_CLASS] == ELFCLASS32 ? 6 : 8, shdr->sh_size,
+	       shdr->sh_entsize, flagbuf, shdr->sh_link, shdr->sh_info,
+	       shdr->sh_addralign);
     }
 
-  fputc_unlocked ('\n', stdout);
+  fputc_unlocked ('\n', output);
 }
 
 
@@ -1100,12 +1131,12 @@ print_phdr (Ebl *ebl, GElf_Ehdr *ehdr)
     
     return;
 
-  puts (gettext ("Program Headers:"));
+  fprintf (output, "%s\n", gettext ("Program Headers:"));
   if (ehdr->e_ident[EI_CLASS] == ELFCLASS32)
-    puts (gettext ("\
+    fprintf (output, "%s\n", gettext ("\
   Type           Offset   VirtAddr   PhysAddr   FileSiz  MemSiz   Flg Align"));
   else
-    puts (gettext ("\
+    fprintf (output, "%s\n", gettext ("\
   Type           Offset   VirtAddr           PhysAddr           FileSiz  MemSiz   Flg Align"));
 
   
@@ -1121,22 +1152,22 @@ print_phdr (Ebl *ebl, GElf_Ehdr *ehdr)
       
       if (unlikely (phdr == NULL))
 	{
-	  puts ("  ???");
+	  fprintf (output, "%s\n", "  ???");
 	  continue;
 	}
 
-      printf ("  %-14s 0x%06" PRIx64 " 0x%0*" PRIx64 " 0x%0*" PRIx64
-	      " 0x%06" PRIx64 " 0x%06" PRIx64 " %c%c%c 0x%" PRIx64 "\n",
-	      ebl_segment_type_name (ebl, phdr->p_type, buf, sizeof (buf)),
-	      phdr->p_offset,
-	      ehdr->e_ident[EI_CLASS] == ELFCLASS32 ? 8 : 16, phdr->p_vaddr,
-	      ehdr->e_ident[EI_CLASS] == ELFCLASS32 ? 8 : 16, phdr->p_paddr,
-	      phdr->p_filesz,
-	      phdr->p_memsz,
-	      phdr->p_flags & PF_R ? 'R' : ' ',
-	      phdr->p_flags & PF_W ? 'W' : ' ',
-	      phdr->p_flags & PF_X ? 'E' : ' ',
-	      phdr->p_align);
+      fprintf (output, "  %-14s 0x%06" PRIx64 " 0x%0*" PRIx64 " 0x%0*" PRIx64
+	       " 0x%06" PRIx64 " 0x%06" PRIx64 " %c%c%c 0x%" PRIx64 "\n",
+	       ebl_segment_type_name (ebl, phdr->p_type, buf, sizeof (buf)),
+	       phdr->p_offset,
+	       ehdr->e_ident[EI_CLASS] == ELFCLASS32 ? 8 : 16, phdr->p_vaddr,
+	       ehdr->e_ident[EI_CLASS] == ELFCLASS32 ? 8 : 16, phdr->p_paddr,
+	       phdr->p_filesz,
+	       phdr->p_memsz,
+	       phdr->p_flags & PF_R ? 'R' : ' ',
+	       phdr->p_flags & PF_W ? 'W' : ' ',
+	       phdr->p_flags & PF_X ? 'E' : ' ',
+	       phdr->p_align);
 
       if (phdr->p_type == PT_INTERP)
 	{
@@ -1153,8 +1184,9 @@ print_phdr (Ebl *ebl, GElf_Ehdr *ehdr)
 	      && phdr->p_filesz <= maxsize - phdr->p_offset
 	      && memchr (filedata + phdr->p_offset, '\0',
 			 phdr->p_filesz) != NULL)
-	    printf (gettext ("\t[Requesting program interpreter: %s]\n"),
-		    filedata + phdr->p_offset);
+	    fprintf (output,
+		     gettext ("\t[Requesting program interpreter: %s]\n"),
+		     filedata + phdr->p_offset);
 	}
       else if (phdr->p_type == PT_GNU_RELRO)
 	{
@@ -1174,12 +1206,13 @@ print_phdr (Ebl *ebl, GElf_Ehdr *ehdr)
     error (EXIT_FAILURE, 0,
 	   gettext ("cannot get section header string table index"));
 
-  puts (gettext ("\n Section to Segment mapping:\n  Segment Sections..."));
+  fprintf (output, "%s\n",
+	   gettext ("\n Section to Segment mapping:\n  Segment Sections..."));
 
   for (size_t cnt = 0; cnt < phnum; ++cnt)
     {
       
-      printf ("   %2.2zu     ", cnt);
+      fprintf (output, "   %2.2zu     ", cnt);
 
       GElf_Phdr phdr_mem;
       GElf_Phdr *phdr = gelf_getphdr (ebl->elf, cnt, &phdr_mem);
@@ -1220,22 +1253,22 @@ print_phdr (Ebl *ebl, GElf_Ehdr *ehdr)
 		  && shdr->sh_addr >= relro_from
 		  && shdr->sh_addr + shdr->sh_size <= relro_to)
 		{
-		  fputs_unlocked (" [RELRO:", stdout);
+		  fputs_unlocked (" [RELRO:", output);
 		  in_relro = true;
 		}
 	      else if (has_relro && in_relro && shdr->sh_addr >= relro_to)
 		{
-		  fputs_unlocked ("]", stdout);
+		  fputs_unlocked ("]", output);
 		  in_relro =  false;
 		}
 	      else if (has_relro && in_relro
 		       && shdr->sh_addr + shdr->sh_size > relro_to)
-		fputs_unlocked ("] <RELRO:", stdout);
+		fputs_unlocked ("] <RELRO:", output);
 	      else if (phdr->p_type == PT_LOAD && (phdr->p_flags & PF_W) == 0)
 		{
 		  if (!in_ro)
 		    {
-		      fputs_unlocked (" [RO:", stdout);
+		      fputs_unlocked (" [RO:", output);
 		      in_ro = true;
 		    }
 		}
@@ -1260,34 +1293,34 @@ print_phdr (Ebl *ebl, GElf_Ehdr *ehdr)
 		    {
 		      if ((phdr2->p_flags & PF_W) == 0 && !in_ro)
 			{
-			  fputs_unlocked (" [RO:", stdout);
+			  fputs_unlocked (" [RO:", output);
 			  in_ro = true;
 			}
 		      else if ((phdr2->p_flags & PF_W) != 0 && in_ro)
 			{
-			  fputs_unlocked ("]", stdout);
+			  fputs_unlocked ("]", output);
 			  in_ro = false;
 			}
 		    }
 		}
 
-	      printf (" %s",
-		      elf_strptr (ebl->elf, shstrndx, shdr->sh_name));
+	      fprintf (output, " %s",
+		       elf_strptr (ebl->elf, shstrndx, shdr->sh_name));
 
 	      
 	      if (has_relro && in_relro
 		       && shdr->sh_addr + shdr->sh_size > relro_to)
 		{
-		  fputs_unlocked (">", stdout);
+		  fputs_unlocked (">", output);
 		  in_relro =  false;
 		}
 	    }
 	}
       if (in_relro || in_ro)
-	fputs_unlocked ("]", stdout);
+	fputs_unlocked ("]", output);
 
       
-      fputc_unlocked ('\n', stdout);
+      fputc_unlocked ('\n', output);
     }
 }
 
@@ -1325,22 +1358,22 @@ handle_scngrp (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr)
   GElf_Sym sym_mem;
   GElf_Sym *sym = gelf_getsym (symdata, shdr->sh_info, &sym_mem);
 
-  printf ((grpref[0] & GRP_COMDAT)
-	  ? ngettext ("\
+  fprintf (output, (grpref[0] & GRP_COMDAT)
+	   ? ngettext ("\
 \nCOMDAT section group [%2zu] '%s' with signature '%s' contains %zu entry:\n",
-		      "\
+		       "\
 \nCOMDAT section group [%2zu] '%s' with signature '%s' contains %zu entries:\n",
-		      data->d_size / sizeof (Elf32_Word) - 1)
-	  : ngettext ("\
+		       data->d_size / sizeof (Elf32_Word) - 1)
+	   : ngettext ("\
 \nSection group [%2zu] '%s' with signature '%s' contains %zu entry:\n", "\
 \nSection group [%2zu] '%s' with signature '%s' contains %zu entries:\n",
-		      data->d_size / sizeof (Elf32_Word) - 1),
-	  elf_ndxscn (scn),
-	  elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
-	  (sym == NULL ? NULL
-	   : elf_strptr (ebl->elf, symshdr->sh_link, sym->st_name))
-	  ?: gettext ("<INVALID SYMBOL>"),
-	  data->d_size / sizeof (Elf32_Word) - 1);
+		       data->d_size / sizeof (Elf32_Word) - 1),
+	   elf_ndxscn (scn),
+	   elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
+	   (sym == NULL ? NULL
+	    : elf_strptr (ebl->elf, symshdr->sh_link, sym->st_name))
+	   ?: gettext ("<INVALID SYMBOL>"),
+	   data->d_size / sizeof (Elf32_Word) - 1);
 
   for (size_t cnt = 1; cnt < data->d_size / sizeof (Elf32_Word); ++cnt)
     {
@@ -1349,11 +1382,11 @@ handle_scngrp (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr)
 					 &grpshdr_mem);
 
       const char *str;
-      printf ("  [%2u] %s\n",
-	      grpref[cnt],
-	      grpshdr != NULL
-	      && (str = elf_strptr (ebl->elf, shstrndx, grpshdr->sh_name))
-	      ? str : gettext ("<INVALID SECTION>"));
+      fprintf (output, "  [%2u] %s\n",
+	       grpref[cnt],
+	       grpshdr != NULL
+	       && (str = elf_strptr (ebl->elf, shstrndx, grpshdr->sh_name))
+	       ? str : gettext ("<INVALID SECTION>"));
     }
 }
 
@@ -1440,8 +1473,8 @@ print_flags (int class, GElf_Xword d_val, const struct flags *flags,
     if (d_val & flags[cnt].mask)
       {
 	if (!first)
-	  putchar_unlocked (' ');
-	fputs_unlocked (flags[cnt].str, stdout);
+	  putc_unlocked (' ', output);
+	fputs_unlocked (flags[cnt].str, output);
 	d_val &= ~flags[cnt].mask;
 	first = false;
       }
@@ -1449,11 +1482,11 @@ print_flags (int class, GElf_Xword d_val, const struct flags *flags,
   if (d_val != 0)
     {
       if (!first)
-	putchar_unlocked (' ');
-      printf ("%#0*" PRIx64, class == ELFCLASS32 ? 10 : 18, d_val);
+	putc_unlocked (' ', output);
+      fprintf (output, "%#0*" PRIx64, class == ELFCLASS32 ? 10 : 18, d_val);
     }
 
-  putchar_unlocked ('\n');
+  putc_unlocked ('\n', output);
 }
 
 
@@ -1513,17 +1546,17 @@ handle_dynamic (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr)
     error (EXIT_FAILURE, 0, gettext ("invalid sh_link value in section %Zu"),
 	   elf_ndxscn (scn));
 
-  printf (ngettext ("\
+  fprintf (output, ngettext ("\
 \nDynamic segment contains %lu entry:\n Addr: %#0*" PRIx64 "  Offset: %#08" PRIx64 "  Link to section: [%2u] '%s'\n",
-		    "\
+		     "\
 \nDynamic segment contains %lu entries:\n Addr: %#0*" PRIx64 "  Offset: %#08" PRIx64 "  Link to section: [%2u] '%s'\n",
-		    shdr->sh_size / sh_entsize),
-	  (unsigned long int) (shdr->sh_size / sh_entsize),
-	  class == ELFCLASS32 ? 10 : 18, shdr->sh_addr,
-	  shdr->sh_offset,
-	  (int) shdr->sh_link,
-	  elf_strptr (ebl->elf, shstrndx, glink->sh_name));
-  fputs_unlocked (gettext ("  Type              Value\n"), stdout);
+		     shdr->sh_size / sh_entsize),
+	   (unsigned long int) (shdr->sh_size / sh_entsize),
+	   class == ELFCLASS32 ? 10 : 18, shdr->sh_addr,
+	   shdr->sh_offset,
+	   (int) shdr->sh_link,
+	   elf_strptr (ebl->elf, shstrndx, glink->sh_name));
+  fputs_unlocked (gettext ("  Type              Value\n"), output);
 
   for (cnt = 0; cnt < shdr->sh_size / sh_entsize; ++cnt)
     {
@@ -1533,8 +1566,8 @@ handle_dynamic (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr)
 	break;
 
       char buf[64];
-      printf ("  %-17s ",
-	      ebl_dynamic_tag_name (ebl, dyn->d_tag, buf, sizeof (buf)));
+      fprintf (output, "  %-17s ",
+	       ebl_dynamic_tag_name (ebl, dyn->d_tag, buf, sizeof (buf)));
 
       switch (dyn->d_tag)
 	{
@@ -1543,27 +1576,27 @@ handle_dynamic (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr)
 	case DT_BIND_NOW:
 	case DT_TEXTREL:
 	  
-	  fputc_unlocked ('\n', stdout);
+	  fputc_unlocked ('\n', output);
 	  break;
 
 	case DT_NEEDED:
-	  printf (gettext ("Shared library: [%s]\n"),
-		  elf_strptr (ebl->elf, shdr->sh_link, dyn->d_un.d_val));
+	  fprintf (output, gettext ("Shared library: [%s]\n"),
+		   elf_strptr (ebl->elf, shdr->sh_link, dyn->d_un.d_val));
 	  break;
 
 	case DT_SONAME:
-	  printf (gettext ("Library soname: [%s]\n"),
-		  elf_strptr (ebl->elf, shdr->sh_link, dyn->d_un.d_val));
+	  fprintf (output, gettext ("Library soname: [%s]\n"),
+		   elf_strptr (ebl->elf, shdr->sh_link, dyn->d_un.d_val));
 	  break;
 
 	case DT_RPATH:
-	  printf (gettext ("Library rpath: [%s]\n"),
-		  elf_strptr (ebl->elf, shdr->sh_link, dyn->d_un.d_val));
+	  fprintf (output, gettext ("Library rpath: [%s]\n"),
+		   elf_strptr (ebl->elf, shdr->sh_link, dyn->d_un.d_val));
 	  break;
 
 	case DT_RUNPATH:
-	  printf (gettext ("Library runpath: [%s]\n"),
-		  elf_strptr (ebl->elf, shdr->sh_link, dyn->d_un.d_val));
+	  fprintf (output, gettext ("Library runpath: [%s]\n"),
+		   elf_strptr (ebl->elf, shdr->sh_link, dyn->d_un.d_val));
 	  break;
 
 	case DT_PLTRELSZ:
@@ -1582,20 +1615,20 @@ handle_dynamic (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr)
 	case DT_SYMINENT:
 	case DT_GNU_CONFLICTSZ:
 	case DT_GNU_LIBLISTSZ:
-	  printf (gettext ("%" PRId64 " (bytes)\n"), dyn->d_un.d_val);
+	  fprintf (output, gettext ("%" PRId64 " (bytes)\n"), dyn->d_un.d_val);
 	  break;
 
 	case DT_VERDEFNUM:
 	case DT_VERNEEDNUM:
 	case DT_RELACOUNT:
 	case DT_RELCOUNT:
-	  printf ("%" PRId64 "\n", dyn->d_un.d_val);
+	  fprintf (output, "%" PRId64 "\n", dyn->d_un.d_val);
 	  break;
 
 	case DT_PLTREL:;
 	  const char *tagname = ebl_dynamic_tag_name (ebl, dyn->d_un.d_val,
 						      NULL, 0);
-	  puts (tagname ?: "???");
+	  fprintf (output, "%s\n", tagname ?: "???");
 	  break;
 
 	case DT_FLAGS:
@@ -1615,8 +1648,8 @@ handle_dynamic (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr)
 	  break;
 
 	default:
-	  printf ("%#0*" PRIx64 "\n",
-		  class == ELFCLASS32 ? 10 : 18, dyn->d_un.d_val);
+	  fprintf (output, "%#0*" PRIx64 "\n",
+		   class == ELFCLASS32 ? 10 : 18, dyn->d_un.d_val);
 	  break;
 	}
     }
@@ -1644,10 +1677,153 @@ print_dynamic (Ebl *ebl)
 }
 
 
+struct print_unit
+{
+  void (*print) (struct print_unit *unit);
+  Dwfl_Module *dwflmod;
+  Ebl *ebl;
+  GElf_Ehdr *ehdr;
+  Elf_Scn *scn;
+  GElf_Shdr shdr;
+  Dwarf *dbg;
+  void (*fp) (Dwfl_Module *, Ebl *, GElf_Ehdr *, Elf_Scn *, GElf_Shdr *,
+	      Dwarf *);
+  Dwarf_Off cu_offset;
+  bool debug_types;
+  bool second_pass;
+  bool stop;
+  char *buf;
+  size_t size;
+};
+
+struct print_units
+{
+  struct print_unit *units;
+  size_t n;
+  size_t alloc;
+  size_t next;
+  bool second_pass;
+};
+
+static struct print_unit *
+add_print_unit (struct print_units *pu, void (*print) (struct print_unit *),
+		Ebl *ebl, GElf_Ehdr *ehdr, Elf_Scn *scn, GElf_Shdr *shdr)
+{
+  if (pu->n == pu->alloc)
+    {
+      pu->alloc = pu->alloc == 0 ? 16 : pu->alloc * 2;
+      pu->units = xrealloc (pu->units, pu->alloc * sizeof pu->units[0]);
+    }
+
+  struct print_unit *unit = &pu->units[pu->n++];
+  *unit = (struct print_unit)
+    {
+      .print = print,
+      .ebl = ebl,
+      .ehdr = ehdr,
+      .scn = scn,
+      .shdr = *shdr
+    };
+  return unit;
+}
+
+static void *
+print_unit_worker (void *arg)
+{
+  struct print_units *pu = (struct print_units *) arg;
+  size_t i;
+  while ((i = __atomic_fetch_add (&pu->next, 1, __ATOMIC_RELAXED)) < pu->n)
+    {
+      struct print_unit *unit = &pu->units[i];
+      if (unit->second_pass != pu->second_pass)
+	continue;
+
+      output = open_memstream (&unit->buf, &unit->size);
+      if (output == NULL)
+	error (EXIT_FAILURE, errno, gettext ("cannot open memory stream"));
+      unit->print (unit);
+      fclose (output);
+    }
+  output = stdout;
+  return NULL;
+}
+
+static void
+run_print_pass (struct print_units *pu, bool second_pass)
+{
+  size_t n = 0;
+  for (size_t i = 0; i < pu->n; ++i)
+    if (pu->units[i].second_pass == second_pass)
+      ++n;
+  if (n == 0)
+    return;
+
+  pu->next = 0;
+  pu->second_pass = second_pass;
+
+  size_t nworkers = (size_t) jobs < n ? (size_t) jobs : n;
+  pthread_t workers[nworkers];
+  for (size_t w = 1; w < nworkers; ++w)
+    {
+      int err = pthread_create (&workers[w], NULL, print_unit_worker, pu);
+      if (err != 0)
+	error (EXIT_FAILURE, err, "pthread_create");
+    }
+  print_unit_worker (pu);
+  for (size_t w = 1; w < nworkers; ++w)
+    pthread_join (workers[w], NULL);
+}
+
+static void
+print_units (struct print_units *pu)
+{
+  run_print_pass (pu, false);
+  run_print_pass (pu, true);
+
+  
+  Elf_Scn *stopped_scn = NULL;
+  for (size_t i = 0; i < pu->n; ++i)
+    {
+      struct print_unit *unit = &pu->units[i];
+      if (unit->scn != stopped_scn)
+	fwrite (unit->buf, 1, unit->size, output);
+      if (unit->stop)
+	stopped_scn = unit->scn;
+      free (unit->buf);
+    }
+  free (pu->units);
+}
+
+static void
+preload_section_data (Ebl *ebl)
+{
+  Elf_Scn *scn = NULL;
+  while ((scn = elf_nextscn (ebl->elf, scn)) != NULL)
+    {
+      GElf_Shdr shdr_mem;
+      GElf_Shdr *shdr = gelf_getshdr (scn, &shdr_mem);
+      if (shdr != NULL && shdr->sh_type != SHT_PROGBITS
+	  && shdr->sh_type != SHT_NOBITS)
+	(void) elf_getdata (scn, NULL);
+    }
+}
+
+
+static void
+print_relocs_unit (struct print_unit *unit)
+{
+  if (unit->shdr.sh_type == SHT_REL)
+    handle_relocs_rel (unit->ebl, unit->ehdr, unit->scn, &unit->shdr);
+  else
+    handle_relocs_rela (unit->ebl, unit->ehdr, unit->scn, &unit->shdr);
+}
+
+
 static void
 print_relocs (Ebl *ebl, GElf_Ehdr *ehdr)
 {
   
+  struct print_units pu = { .units = NULL };
   Elf_Scn *scn = NULL;
 
   while ((scn = elf_nextscn (ebl->elf, scn)) != NULL)
@@ -1658,12 +1834,21 @@ print_relocs (Ebl *ebl, GElf_Ehdr *ehdr)
 
       if (likely (shdr != NULL))
 	{
-	  if (shdr->sh_type == SHT_REL)
+	  if (jobs > 1 && (shdr->sh_type == SHT_REL
+			   || shdr->sh_type == SHT_RELA))
+	    add_print_unit (&pu, print_relocs_unit, ebl, ehdr, scn, shdr);
+	  else if (shdr->sh_type == SHT_REL)
 	    handle_relocs_rel (ebl, ehdr, scn, shdr);
 	  else if (shdr->sh_type == SHT_RELA)
 	    handle_relocs_rela (ebl, ehdr, scn, shdr);
 	}
     }
+
+  if (pu.n > 0)
+    {
+      preload_section_data (ebl);
+      print_units (&pu);
+    }
 }
 
 
@@ -1692,8 +1877,9 @@ handle_relocs_rel (Ebl *ebl, GElf_Ehdr *ehdr, Elf_Scn *scn, GElf_Shdr *shdr)
 
   if (unlikely (symshdr == NULL || symdata == NULL || destshdr == NULL))
     {
-      printf (gettext ("\nInvalid symbol table at offset %#0" PRIx64 "\n"),
-	      shdr->sh_offset);
+      fprintf (output, gettext ("\nInvalid symbol table at offset %#0"
+				PRIx64 "\n"),
+	       shdr->sh_offset);
       return;
     }
 
@@ -1710,33 +1896,33 @@ handle_relocs_rel (Ebl *ebl, GElf_Ehdr *ehdr, Elf_Scn *scn, GElf_Shdr *shdr)
 	   gettext ("cannot get section header string table index"));
 
   if (shdr->sh_info != 0)
-    printf (ngettext ("\
+    fprintf (output, ngettext ("\
 \nRelocation section [%2zu] '%s' for section [%2u] '%s' at offset %#0" PRIx64 " contains %d entry:\n",
-		    "\
+		     "\
 \nRelocation section [%2zu] '%s' for section [%2u] '%s' at offset %#0" PRIx64 " contains %d entries:\n",
-		      nentries),
-	    elf_ndxscn (scn),
-	    elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
-	    (unsigned int) shdr->sh_info,
-	    elf_strptr (ebl->elf, shstrndx, destshdr->sh_name),
-	    shdr->sh_offset,
-	    nentries);
+		       nentries),
+	     elf_ndxscn (scn),
+	     elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
+	     (unsigned int) shdr->sh_info,
+	     elf_strptr (ebl->elf, shstrndx, destshdr->sh_name),
+	     shdr->sh_offset,
+	     nentries);
   else
-    printf (ngettext ("\
+    fprintf (output, ngettext ("\
 \nRelocation section [%2u] '%s' at offset %#0" PRIx64 " contains %d entry:\n",
-		    "\
+		     "\
 \nRelocation section [%2u] '%s' at offset %#0" PRIx64 " contains %d entries:\n",
-		      nentries),
-	    (unsigned int) elf_ndxscn (scn),
-	    elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
-	    shdr->sh_offset,
-	    nentries);
+		       nentries),
+	     (unsigned int) elf_ndxscn (scn),
+	     elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
+	     shdr->sh_offset,
+	     nentries);
   fputs_unlocked (class == ELFCLASS32
 		  ? gettext ("\
   Offset      Type                 Value       Name\n")
 		  : gettext ("\
   Offset              Type                 Value               Name\n"),
-	 stdout);
+	 output);
 
   int is_statically_linked = 0;
   for (int cnt = 0; cnt < nentries; ++cnt)
@@ -1776,35 +1962,35 @@ handle_relocs_rel (Ebl *ebl, GElf_Ehdr *ehdr, Elf_Scn *scn, GElf_Shdr *shdr)
 		}
 
 	      if (is_statically_linked > 0 && shdr->sh_link == 0)
-		printf ("\
+		fprintf (output, "\
   %#0*" PRIx64 "  %-20s %*s  %s\n",
-			class == ELFCLASS32 ? 10 : 18, rel->r_offset,
-			ebl_reloc_type_check (ebl, GELF_R_TYPE (rel->r_info))
-			? ebl_reloc_type_name (ebl, GELF_R_TYPE (rel->r_info),
-					       buf, sizeof (buf)) + 2
-			: gettext ("<INVALID RELOC>"),
-			class == ELFCLASS32 ? 10 : 18, "",
-			elf_strptr (ebl->elf, shstrndx, destshdr->sh_name));
+			 class == ELFCLASS32 ? 10 : 18, rel->r_offset,
+			 ebl_reloc_type_check (ebl, GELF_R_TYPE (rel->r_info))
+			 ? ebl_reloc_type_name (ebl, GELF_R_TYPE (rel->r_info),
+						buf, sizeof (buf)) + 2
+			 : gettext ("<INVALID RELOC>"),
+			 class == ELFCLASS32 ? 10 : 18, "",
+			 elf_strptr (ebl->elf, shstrndx, destshdr->sh_name));
 	      else
-		printf ("  %#0*" PRIx64 "  %-20s <%s %ld>\n",
-			class == ELFCLASS32 ? 10 : 18, rel->r_offset,
-			ebl_reloc_type_check (ebl, GELF_R_TYPE (rel->r_info))
-			? ebl_reloc_type_name (ebl, GELF_R_TYPE (rel->r_info),
-					       buf, sizeof (buf)) + 2
-			: gettext ("<INVALID RELOC>"),
-			gettext ("INVALID SYMBOL"),
-			(long int) GELF_R_SYM (rel->r_info));
+		fprintf (output, "  %#0*" PRIx64 "  %-20s <%s %ld>\n",
+			 class == ELFCLASS32 ? 10 : 18, rel->r_offset,
+			 ebl_reloc_type_check (ebl, GELF_R_TYPE (rel->r_info))
+			 ? ebl_reloc_type_name (ebl, GELF_R_TYPE (rel->r_info),
+						buf, sizeof (buf)) + 2
+			 : gettext ("<INVALID RELOC>"),
+			 gettext ("INVALID SYMBOL"),
+			 (long int) GELF_R_SYM (rel->r_info));
 	    }
 	  else if (GELF_ST_TYPE (sym->st_info) != STT_SECTION)
-	    printf ("  %#0*" PRIx64 "  %-20s %#0*" PRIx64 "  %s\n",
-		    class == ELFCLASS32 ? 10 : 18, rel->r_offset,
-		    likely (ebl_reloc_type_check (ebl,
-						  GELF_R_TYPE (rel->r_info)))
-		    ? ebl_reloc_type_name (ebl, GELF_R_TYPE (rel->r_info),
-					   buf, sizeof (buf)) + 2
-		    : gettext ("<INVALID RELOC>"),
-		    class == ELFCLASS32 ? 10 : 18, sym->st_value,
-		    elf_strptr (ebl->elf, symshdr->sh_link, sym->st_name));
+	    fprintf (output, "  %#0*" PRIx64 "  %-20s %#0*" PRIx64 "  %s\n",
+		     class == ELFCLASS32 ? 10 : 18, rel->r_offset,
+		     likely (ebl_reloc_type_check (ebl,
+						   GELF_R_TYPE (rel->r_info)))
+		     ? ebl_reloc_type_name (ebl, GELF_R_TYPE (rel->r_info),
+					    buf, sizeof (buf)) + 2
+		     : gettext ("<INVALID RELOC>"),
+		     class == ELFCLASS32 ? 10 : 18, sym->st_value,
+		     elf_strptr (ebl->elf, symshdr->sh_link, sym->st_name));
 	  else
 	    {
 	      
@@ -1816,24 +2002,25 @@ handle_relocs_rel (Ebl *ebl, GElf_Ehdr *ehdr, Elf_Scn *scn, GElf_Shdr *shdr)
 				      &secshdr_mem);
 
 	      if (unlikely (secshdr == NULL))
-		printf ("  %#0*" PRIx64 "  %-20s <%s %ld>\n",
-			class == ELFCLASS32 ? 10 : 18, rel->r_offset,
-			ebl_reloc_type_check (ebl, GELF_R_TYPE (rel->r_info))
-			? ebl_reloc_type_name (ebl, GELF_R_TYPE (rel->r_info),
-					       buf, sizeof (buf)) + 2
-			: gettext ("<INVALID RELOC>"),
-			gettext ("INVALID SECTION"),
-			(long int) (sym->st_shndx == SHN_XINDEX
-				    ? xndx : sym->st_shndx));
+		fprintf (output, "  %#0*" PRIx64 "  %-20s <%s %ld>\n",
+			 class == ELFCLASS32 ? 10 : 18, rel->r_offset,
+			 ebl_reloc_type_check (ebl, GELF_R_TYPE (rel->r_info))
+			 ? ebl_reloc_type_name (ebl, GELF_R_TYPE (rel->r_info),
+						buf, sizeof (buf)) + 2
+			 : gettext ("<INVALID RELOC>"),
+			 gettext ("INVALID SECTION"),
+			 (long int) (sym->st_shndx == SHN_XINDEX
+				     ? xndx : sym->st_shndx));
 	      else
-		printf ("  %#0*" PRIx64 "  %-20s %#0*" PRIx64 "  %s\n",
-			class == ELFCLASS32 ? 10 : 18, rel->r_offset,
-			ebl_reloc_type_check (ebl, GELF_R_TYPE (rel->r_info))
-			? ebl_reloc_type_name (ebl, GELF_R_TYPE (rel->r_info),
-					       buf, sizeof (buf)) + 2
-			: gettext ("<INVALID RELOC>"),
-			class == ELFCLASS32 ? 10 : 18, sym->st_value,
-			elf_strptr (ebl->elf, shstrndx, secshdr->sh_name));
+		fprintf (output, "  %#0*" PRIx64 "  %-20s %#0*"
+			 PRIx64 "  %s\n",
+			 class == ELFCLASS32 ? 10 : 18, rel->r_offset,
+			 ebl_reloc_type_check (ebl, GELF_R_TYPE (rel->r_info))
+			 ? ebl_reloc_type_name (ebl, GELF_R_TYPE (rel->r_info),
+						buf, sizeof (buf)) + 2
+			 : gettext ("<INVALID RELOC>"),
+			 class == ELFCLASS32 ? 10 : 18, sym->st_value,
+			 elf_strptr (ebl->elf, shstrndx, secshdr->sh_name));
 	    }
 	}
     }
@@ -1865,8 +2052,9 @@ handle_relocs_rela (Ebl *ebl, GElf_Ehdr *ehdr, Elf_Scn *scn, GElf_Shdr *shdr)
 
   if (unlikely (symshdr == NULL || symdata == NULL || destshdr == NULL))
     {
-      printf (gettext ("\nInvalid symbol table at offset %#0" PRIx64 "\n"),
-	      shdr->sh_offset);
+      fprintf (output, gettext ("\nInvalid symbol table at offset %#0"
+				PRIx64 "\n"),
+	       shdr->sh_offset);
       return;
     }
 
@@ -1883,33 +2071,33 @@ handle_relocs_rela (Ebl *ebl, GElf_Ehdr *ehdr, Elf_Scn *scn, GElf_Shdr *shdr)
 	   gettext ("cannot get section header string table index"));
 
   if (shdr->sh_info != 0)
-    printf (ngettext ("\
+    fprintf (output, ngettext ("\
 \nRelocation section [%2zu] '%s' for section [%2u] '%s' at offset %#0" PRIx64 " contains %d entry:\n",
-		    "\
+		     "\
 \nRelocation section [%2zu] '%s' for section [%2u] '%s' at offset %#0" PRIx64 " contains %d entries:\n",
-		    nentries),
-	  elf_ndxscn (scn),
-	  elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
-	  (unsigned int) shdr->sh_info,
-	  elf_strptr (ebl->elf, shstrndx, destshdr->sh_name),
-	  shdr->sh_offset,
-	  nentries);
+		     nentries),
+	   elf_ndxscn (scn),
+	   elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
+	   (unsigned int) shdr->sh_info,
+	   elf_strptr (ebl->elf, shstrndx, destshdr->sh_name),
+	   shdr->sh_offset,
+	   nentries);
   else
-    printf (ngettext ("\
+    fprintf (output, ngettext ("\
 \nRelocation section [%2u] '%s' at offset %#0" PRIx64 " contains %d entry:\n",
-		    "\
+		     "\
 \nRelocation section [%2u] '%s' at offset %#0" PRIx64 " contains %d entries:\n",
-		      nentries),
-	    (unsigned int) elf_ndxscn (scn),
-	    elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
-	    shdr->sh_offset,
-	    nentries);
+		       nentries),
+	     (unsigned int) elf_ndxscn (scn),
+	     elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
+	     shdr->sh_offset,
+	     nentries);
   fputs_unlocked (class == ELFCLASS32
 		  ? gettext ("\
   Offset      Type            Value       Addend Name\n")
 		  : gettext ("\
   Offset              Type            Value               Addend Name\n"),
-		  stdout);
+		  output);
 
   int is_statically_linked = 0;
   for (int cnt = 0; cnt < nentries; ++cnt)
@@ -1950,38 +2138,38 @@ handle_relocs_rela (Ebl *ebl, GElf_Ehdr *ehdr, Elf_Scn *scn, GElf_Shdr *shdr)
 		}
 
 	      if (is_statically_linked > 0 && shdr->sh_link == 0)
-		printf ("\
+		fprintf (output, "\
   %#0*" PRIx64 "  %-15s %*s  %#6" PRIx64 " %s\n",
-			class == ELFCLASS32 ? 10 : 18, rel->r_offset,
-			ebl_reloc_type_check (ebl, GELF_R_TYPE (rel->r_info))
-			? ebl_reloc_type_name (ebl, GELF_R_TYPE (rel->r_info),
-					       buf, sizeof (buf)) + 2
-			: gettext ("<INVALID RELOC>"),
-			class == ELFCLASS32 ? 10 : 18, "",
-			rel->r_addend,
-			elf_strptr (ebl->elf, shstrndx, destshdr->sh_name));
+			 class == ELFCLASS32 ? 10 : 18, rel->r_offset,
+			 ebl_reloc_type_check (ebl, GELF_R_TYPE (rel->r_info))
+			 ? ebl_reloc_type_name (ebl, GELF_R_TYPE (rel->r_info),
+						buf, sizeof (buf)) + 2
+			 : gettext ("<INVALID RELOC>"),
+			 class == ELFCLASS32 ? 10 : 18, "",
+			 rel->r_addend,
+			 elf_strptr (ebl->elf, shstrndx, destshdr->sh_name));
 	      else
-		printf ("  %#0*" PRIx64 "  %-15s <%s %ld>\n",
-			class == ELFCLASS32 ? 10 : 18, rel->r_offset,
-			ebl_reloc_type_check (ebl, GELF_R_TYPE (rel->r_info))
-			? ebl_reloc_type_name (ebl, GELF_R_TYPE (rel->r_info),
-					       buf, sizeof (buf)) + 2
-			: gettext ("<INVALID RELOC>"),
-			gettext ("INVALID SYMBOL"),
-			(long int) GELF_R_SYM (rel->r_info));
+		fprintf (output, "  %#0*" PRIx64 "  %-15s <%s %ld>\n",
+			 class == ELFCLASS32 ? 10 : 18, rel->r_offset,
+			 ebl_reloc_type_check (ebl, GELF_R_TYPE (rel->r_info))
+			 ? ebl_reloc_type_name (ebl, GELF_R_TYPE (rel->r_info),
+						buf, sizeof (buf)) + 2
+			 : gettext ("<INVALID RELOC>"),
+			 gettext ("INVALID SYMBOL"),
+			 (long int) GELF_R_SYM (rel->r_info));
 	    }
 	  else if (GELF_ST_TYPE (sym->st_info) != STT_SECTION)
-	    printf ("\
+	    fprintf (output, "\
   %#0*" PRIx64 "  %-15s %#0*" PRIx64 "  %+6" PRId64 " %s\n",
-		    class == ELFCLASS32 ? 10 : 18, rel->r_offset,
-		    likely (ebl_reloc_type_check (ebl,
-						  GELF_R_TYPE (rel->r_info)))
-		    ? ebl_reloc_type_name (ebl, GELF_R_TYPE (rel->r_info),
-					   buf, sizeof (buf)) + 2
-		    : gettext ("<INVALID RELOC>"),
-		    class == ELFCLASS32 ? 10 : 18, sym->st_value,
-		    rel->r_addend,
-		    elf_strptr (ebl->elf, symshdr->sh_link, sym->st_name));
+		     class == ELFCLASS32 ? 10 : 18, rel->r_offset,
+		     likely (ebl_reloc_type_check (ebl,
+						   GELF_R_TYPE (rel->r_info)))
+		     ? ebl_reloc_type_name (ebl, GELF_R_TYPE (rel->r_info),
+					    buf, sizeof (buf)) + 2
+		     : gettext ("<INVALID RELOC>"),
+		     class == ELFCLASS32 ? 10 : 18, sym->st_value,
+		     rel->r_addend,
+		     elf_strptr (ebl->elf, symshdr->sh_link, sym->st_name));
 	  else
 	    {
 	      
@@ -1993,35 +2181,43 @@ handle_relocs_rela (Ebl *ebl, GElf_Ehdr *ehdr, Elf_Scn *scn, GElf_Shdr *shdr)
 				      &secshdr_mem);
 
 	      if (unlikely (secshdr == NULL))
-		printf ("  %#0*" PRIx64 "  %-15s <%s %ld>\n",
-			class == ELFCLASS32 ? 10 : 18, rel->r_offset,
-			ebl_reloc_type_check (ebl, GELF_R_TYPE (rel->r_info))
-			? ebl_reloc_type_name (ebl, GELF_R_TYPE (rel->r_info),
-					       buf, sizeof (buf)) + 2
-			: gettext ("<INVALID RELOC>"),
-			gettext ("INVALID SECTION"),
-			(long int) (sym->st_shndx == SHN_XINDEX
-				    ? xndx : sym->st_shndx));
+		fprintf (output, "  %#0*" PRIx64 "  %-15s <%s %ld>\n",
+			 class == ELFCLASS32 ? 10 : 18, rel->r_offset,
+			 ebl_reloc_type_check (ebl, GELF_R_TYPE (rel->r_info))
+			 ? ebl_reloc_type_name (ebl, GELF_R_TYPE (rel->r_info),
+						buf, sizeof (buf)) + 2
+			 : gettext ("<INVALID RELOC>"),
+			 gettext ("INVALID SECTION"),
+			 (long int) (sym->st_shndx == SHN_XINDEX
+				     ? xndx : sym->st_shndx));
 	      else
-		printf ("\
+		fprintf (output, "\
   %#0*" PRIx64 "  %-15s %#0*" PRIx64 "  %+6" PRId64 " %s\n",
-			class == ELFCLASS32 ? 10 : 18, rel->r_offset,
-			ebl_reloc_type_check (ebl, GELF_R_TYPE (rel->r_info))
-			? ebl_reloc_type_name (ebl, GELF_R_TYPE (rel->r_info),
-					       buf, sizeof (buf)) + 2
-			: gettext ("<INVALID RELOC>"),
-			class == ELFCLASS32 ? 10 : 18, sym->st_value,
-			rel->r_addend,
-			elf_strptr (ebl->elf, shstrndx, secshdr->sh_name));
+			 class == ELFCLASS32 ? 10 : 18, rel->r_offset,
+			 ebl_reloc_type_check (ebl, GELF_R_TYPE (rel->r_info))
+			 ? ebl_reloc_type_name (ebl, GELF_R_TYPE (rel->r_info),
+						buf, sizeof (buf)) + 2
+			 : gettext ("<INVALID RELOC>"),
+			 class == ELFCLASS32 ? 10 : 18, sym->st_value,
+			 rel->r_addend,
+			 elf_strptr (ebl->elf, shstrndx, secshdr->sh_name));
 	    }
 	}
     }
 }
 
 
+static void
+print_symtab_unit (struct print_unit *unit)
+{
+  handle_symtab (unit->ebl, unit->scn, &unit->shdr);
+}
+
+
 static void
 print_symtab (Ebl *ebl, int type)
 {
+  struct print_units pu = { .units = NULL };
   Elf_Scn *scn = NULL;
 
   while ((scn = elf_nextscn (ebl->elf, scn)) != NULL)
@@ -2031,7 +2227,18 @@ print_symtab (Ebl *ebl, int type)
       GElf_Shdr *shdr = gelf_getshdr (scn, &shdr_mem);
 
       if (shdr != NULL && shdr->sh_type == (GElf_Word) type)
-	handle_symtab (ebl, scn, shdr);
+	{
+	  if (jobs > 1)
+	    add_print_unit (&pu, print_symtab_unit, ebl, NULL, scn, shdr);
+	  else
+	    handle_symtab (ebl, scn, shdr);
+	}
+    }
+
+  if (pu.n > 0)
+    {
+      preload_section_data (ebl);
+      print_units (&pu);
     }
 }
 
@@ -2102,24 +2309,25 @@ handle_symtab (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr)
 				       ? sizeof (Elf32_Sym)
 				       : sizeof (Elf64_Sym));
 
-  printf (ngettext ("\nSymbol table [%2u] '%s' contains %u entry:\n",
-		    "\nSymbol table [%2u] '%s' contains %u entries:\n",
-		    nsyms),
-	  (unsigned int) elf_ndxscn (scn),
-	  elf_strptr (ebl->elf, shstrndx, shdr->sh_name), nsyms);
-  printf (ngettext (" %lu local symbol  String table: [%2u] '%s'\n",
-		    " %lu local symbols  String table: [%2u] '%s'\n",
-		    shdr->sh_info),
-	  (unsigned long int) shdr->sh_info,
-	  (unsigned int) shdr->sh_link,
-	  elf_strptr (ebl->elf, shstrndx, glink->sh_name));
+  fprintf (output,
+	   ngettext ("\nSymbol table [%2u] '%s' contains %u entry:\n",
+		     "\nSymbol table [%2u] '%s' contains %u entries:\n",
+		     nsyms),
+	   (unsigned int) elf_ndxscn (scn),
+	   elf_strptr (ebl->elf, shstrndx, shdr->sh_name), nsyms);
+  fprintf (output, ngettext (" %lu local symbol  String table: [%2u] '%s'\n",
+			     " %lu local symbols  String table: [%2u] '%s'\n",
+			     shdr->sh_info),
+	   (unsigned long int) shdr->sh_info,
+	   (unsigned int) shdr->sh_link,
+	   elf_strptr (ebl->elf, shstrndx, glink->sh_name));
 
   fputs_unlocked (class == ELFCLASS32
 		  ? gettext ("\
   Num:    Value   Size Type    Bind   Vis          Ndx Name\n")
 		  : gettext ("\
   Num:            Value   Size Type    Bind   Vis          Ndx Name\n"),
-		  stdout);
+		  output);
 
   for (unsigned int cnt = 0; cnt < nsyms; ++cnt)
     {
@@ -2137,20 +2345,20 @@ handle_symtab (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr)
       if (likely (sym->st_shndx != SHN_XINDEX))
 	xndx = sym->st_shndx;
 
-      printf (gettext ("\
+      fprintf (output, gettext ("\
 %5u: %0*" PRIx64 " %6" PRId64 " %-7s %-6s %-9s %6s %s"),
-	      cnt,
-	      class == ELFCLASS32 ? 8 : 16,
-	      sym->st_value,
-	      sym->st_size,
-	      ebl_symbol_type_name (ebl, GELF_ST_TYPE (sym->st_info),
-				    typebuf, sizeof (typebuf)),
-	      ebl_symbol_binding_name (ebl, GELF_ST_BIND (sym->st_info),
-				       bindbuf, sizeof (bindbuf)),
-	      get_visibility_type (GELF_ST_VISIBILITY (sym->st_other)),
-	      ebl_section_name (ebl, sym->st_shndx, xndx, scnbuf,
-				sizeof (scnbuf), NULL, shnum),
-	      elf_strptr (ebl->elf, shdr->sh_link, sym->st_name));
+	       cnt,
+	       class == ELFCLASS32 ? 8 : 16,
+	       sym->st_value,
+	       sym->st_size,
+	       ebl_symbol_type_name (ebl, GELF_ST_TYPE (sym->st_info),
+				     typebuf, sizeof (typebuf)),
+	       ebl_symbol_binding_name (ebl, GELF_ST_BIND (sym->st_info),
+					bindbuf, sizeof (bindbuf)),
+	       get_visibility_type (GELF_ST_VISIBILITY (sym->st_other)),
+	       ebl_section_name (ebl, sym->st_shndx, xndx, scnbuf,
+				 sizeof (scnbuf), NULL, shnum),
+	       elf_strptr (ebl->elf, shdr->sh_link, sym->st_name));
 
       if (versym_data != NULL)
 	{
@@ -2218,10 +2426,10 @@ handle_symtab (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr)
 
 		  if (vernaux != NULL && vernaux->vna_other == *versym)
 		    {
-		      printf ("@%s (%u)",
-			      elf_strptr (ebl->elf, verneed_stridx,
-					  vernaux->vna_name),
-			      (unsigned int) vernaux->vna_other);
+		      fprintf (output, "@%s (%u)",
+			       elf_strptr (ebl->elf, verneed_stridx,
+					   vernaux->vna_name),
+			       (unsigned int) vernaux->vna_other);
 		      check_def = 0;
 		    }
 		  else if (unlikely (! is_nobits))
@@ -2260,15 +2468,15 @@ handle_symtab (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr)
 					   &verdaux_mem);
 
 		      if (verdaux != NULL)
-			printf ((*versym & 0x8000) ? "@%s" : "@@%s",
-				elf_strptr (ebl->elf, verdef_stridx,
-					    verdaux->vda_name));
+			fprintf (output, (*versym & 0x8000) ? "@%s" : "@@%s",
+				 elf_strptr (ebl->elf, verdef_stridx,
+					     verdaux->vda_name));
 		    }
 		}
 	    }
 	}
 
-      putchar_unlocked ('\n');
+      putc_unlocked ('\n', output);
     }
 }
 
@@ -2352,17 +2560,17 @@ handle_verneed (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr)
     error (EXIT_FAILURE, 0, gettext ("invalid sh_link value in section %Zu"),
 	   elf_ndxscn (scn));
 
-  printf (ngettext ("\
+  fprintf (output, ngettext ("\
 \nVersion needs section [%2u] '%s' contains %d entry:\n Addr: %#0*" PRIx64 "  Offset: %#08" PRIx64 "  Link to section: [%2u] '%s'\n",
-		    "\
+		     "\
 \nVersion needs section [%2u] '%s' contains %d entries:\n Addr: %#0*" PRIx64 "  Offset: %#08" PRIx64 "  Link to section: [%2u] '%s'\n",
-		    shdr->sh_info),
-	  (unsigned int) elf_ndxscn (scn),
-	  elf_strptr (ebl->elf, shstrndx, shdr->sh_name), shdr->sh_info,
-	  class == ELFCLASS32 ? 10 : 18, shdr->sh_addr,
-	  shdr->sh_offset,
-	  (unsigned int) shdr->sh_link,
-	  elf_strptr (ebl->elf, shstrndx, glink->sh_name));
+		     shdr->sh_info),
+	   (unsigned int) elf_ndxscn (scn),
+	   elf_strptr (ebl->elf, shstrndx, shdr->sh_name), shdr->sh_info,
+	   class == ELFCLASS32 ? 10 : 18, shdr->sh_addr,
+	   shdr->sh_offset,
+	   (unsigned int) shdr->sh_link,
+	   elf_strptr (ebl->elf, shstrndx, glink->sh_name));
 
   unsigned int offset = 0;
   for (int cnt = shdr->sh_info; --cnt >= 0; )
@@ -2373,10 +2581,10 @@ handle_verneed (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr)
       if (unlikely (need == NULL))
 	break;
 
-      printf (gettext ("  %#06x: Version: %hu  File: %s  Cnt: %hu\n"),
-	      offset, (unsigned short int) need->vn_version,
-	      elf_strptr (ebl->elf, shdr->sh_link, need->vn_file),
-	      (unsigned short int) need->vn_cnt);
+      fprintf (output, gettext ("  %#06x: Version: %hu  File: %s  Cnt: %hu\n"),
+	       offset, (unsigned short int) need->vn_version,
+	       elf_strptr (ebl->elf, shdr->sh_link, need->vn_file),
+	       (unsigned short int) need->vn_cnt);
 
       unsigned int auxoffset = offset + need->vn_aux;
       for (int cnt2 = need->vn_cnt; --cnt2 >= 0; )
@@ -2386,11 +2594,12 @@ handle_verneed (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr)
 	  if (unlikely (aux == NULL))
 	    break;
 
-	  printf (gettext ("  %#06x: Name: %s  Flags: %s  Version: %hu\n"),
-		  auxoffset,
-		  elf_strptr (ebl->elf, shdr->sh_link, aux->vna_name),
-		  get_ver_flags (aux->vna_flags),
-		  (unsigned short int) aux->vna_other);
+	  fprintf (output,
+		   gettext ("  %#06x: Name: %s  Flags: %s  Version: %hu\n"),
+		   auxoffset,
+		   elf_strptr (ebl->elf, shdr->sh_link, aux->vna_name),
+		   get_ver_flags (aux->vna_flags),
+		   (unsigned short int) aux->vna_other);
 
 	  if (aux->vna_next == 0)
 	    break;
@@ -2429,18 +2638,18 @@ handle_verdef (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr)
 	   elf_ndxscn (scn));
 
   int class = gelf_getclass (ebl->elf);
-  printf (ngettext ("\
+  fprintf (output, ngettext ("\
 \nVersion definition section [%2u] '%s' contains %d entry:\n Addr: %#0*" PRIx64 "  Offset: %#08" PRIx64 "  Link to section: [%2u] '%s'\n",
-		    "\
+		     "\
 \nVersion definition section [%2u] '%s' contains %d entries:\n Addr: %#0*" PRIx64 "  Offset: %#08" PRIx64 "  Link to section: [%2u] '%s'\n",
-		    shdr->sh_info),
-	  (unsigned int) elf_ndxscn (scn),
-	  elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
-	  shdr->sh_info,
-	  class == ELFCLASS32 ? 10 : 18, shdr->sh_addr,
-	  shdr->sh_offset,
-	  (unsigned int) shdr->sh_link,
-	  elf_strptr (ebl->elf, shstrndx, glink->sh_name));
+		     shdr->sh_info),
+	   (unsigned int) elf_ndxscn (scn),
+	   elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
+	   shdr->sh_info,
+	   class == ELFCLASS32 ? 10 : 18, shdr->sh_addr,
+	   shdr->sh_offset,
+	   (unsigned int) shdr->sh_link,
+	   elf_strptr (ebl->elf, shstrndx, glink->sh_name));
 
   unsigned int offset = 0;
   for (int cnt = shdr->sh_info; --cnt >= 0; )
@@ -2457,13 +2666,13 @@ handle_verdef (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr)
       if (unlikely (aux == NULL))
 	break;
 
-      printf (gettext ("\
+      fprintf (output, gettext ("\
   %#06x: Version: %hd  Flags: %s  Index: %hd  Cnt: %hd  Name: %s\n"),
-	      offset, def->vd_version,
-	      get_ver_flags (def->vd_flags),
-	      def->vd_ndx,
-	      def->vd_cnt,
-	      elf_strptr (ebl->elf, shdr->sh_link, aux->vda_name));
+	       offset, def->vd_version,
+	       get_ver_flags (def->vd_flags),
+	       def->vd_ndx,
+	       def->vd_cnt,
+	       elf_strptr (ebl->elf, shdr->sh_link, aux->vda_name));
 
       auxoffset += aux->vda_next;
       for (int cnt2 = 1; cnt2 < def->vd_cnt; ++cnt2)
@@ -2472,9 +2681,9 @@ handle_verdef (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr)
 	  if (unlikely (aux == NULL))
 	    break;
 
-	  printf (gettext ("  %#06x: Parent %d: %s\n"),
-		  auxoffset, cnt2,
-		  elf_strptr (ebl->elf, shdr->sh_link, aux->vda_name));
+	  fprintf (output, gettext ("  %#06x: Parent %d: %s\n"),
+		   auxoffset, cnt2,
+		   elf_strptr (ebl->elf, shdr->sh_link, aux->vda_name));
 
 	  if (aux->vda_next == 0)
 	    break;
@@ -2725,24 +2934,24 @@ handle_versym (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr)
 	   elf_ndxscn (scn));
 
   
-  printf (ngettext ("\
+  fprintf (output, ngettext ("\
 \nVersion symbols section [%2u] '%s' contains %d entry:\n Addr: %#0*" PRIx64 "  Offset: %#08" PRIx64 "  Link to section: [%2u] '%s'",
-		    "\
+		     "\
 \nVersion symbols section [%2u] '%s' contains %d entries:\n Addr: %#0*" PRIx64 "  Offset: %#08" PRIx64 "  Link to section: [%2u] '%s'",
-		    shdr->sh_size / sh_entsize),
-	  (unsigned int) elf_ndxscn (scn),
-	  elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
-	  (int) (shdr->sh_size / sh_entsize),
-	  class == ELFCLASS32 ? 10 : 18, shdr->sh_addr,
-	  shdr->sh_offset,
-	  (unsigned int) shdr->sh_link,
-	  elf_strptr (ebl->elf, shstrndx, glink->sh_name));
+		     shdr->sh_size / sh_entsize),
+	   (unsigned int) elf_ndxscn (scn),
+	   elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
+	   (int) (shdr->sh_size / sh_entsize),
+	   class == ELFCLASS32 ? 10 : 18, shdr->sh_addr,
+	   shdr->sh_offset,
+	   (unsigned int) shdr->sh_link,
+	   elf_strptr (ebl->elf, shstrndx, glink->sh_name));
 
   
   for (unsigned int cnt = 0; cnt < shdr->sh_size / sh_entsize; ++cnt)
     {
       if (cnt % 2 == 0)
-	printf ("\n %4d:", cnt);
+	fprintf (output, "\n %4d:", cnt);
 
       GElf_Versym symmem;
       GElf_Versym *sym = gelf_getversym (data, cnt, &symmem);
@@ -2754,28 +2963,28 @@ handle_versym (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr)
 	  ssize_t n;
 	case 0:
 	  fputs_unlocked (gettext ("   0 *local*                     "),
-			  stdout);
+			  output);
 	  break;
 
 	case 1:
 	  fputs_unlocked (gettext ("   1 *global*                    "),
-			  stdout);
+			  output);
 	  break;
 
 	default:
-	  n = printf ("%4d%c%s",
-		      *sym & 0x7fff, *sym & 0x8000 ? 'h' : ' ',
-		      (vername != NULL
-		       && (unsigned int) (*sym & 0x7fff) < nvername)
-		      ? vername[*sym & 0x7fff] : "???");
+	  n = fprintf (output, "%4d%c%s",
+		       *sym & 0x7fff, *sym & 0x8000 ? 'h' : ' ',
+		       (vername != NULL
+			&& (unsigned int) (*sym & 0x7fff) < nvername)
+		       ? vername[*sym & 0x7fff] : "???");
 	  if ((unsigned int) (*sym & 0x7fff) < nvername
 	      && filename != NULL && filename[*sym & 0x7fff] != NULL)
-	    n += printf ("(%s)", filename[*sym & 0x7fff]);
-	  printf ("%*s", MAX (0, 33 - (int) n), " ");
+	    n += fprintf (output, "(%s)", filename[*sym & 0x7fff]);
+	  fprintf (output, "%*s", MAX (0, 33 - (int) n), " ");
 	  break;
 	}
     }
-  putchar_unlocked ('\n');
+  putc_unlocked ('\n', output);
 }
 
 
@@ -2800,22 +3009,22 @@ print_hash_info (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr, size_t shstrndx,
       return;
     }
 
-  printf (ngettext ("\
+  fprintf (output, ngettext ("\
 \nHistogram for bucket list length in section [%2u] '%s' (total of %d bucket):\n Addr: %#0*" PRIx64 "  Offset: %#08" PRIx64 "  Link to section: [%2u] '%s'\n",
-		    "\
+		     "\
 \nHistogram for bucket list length in section [%2u] '%s' (total of %d buckets):\n Addr: %#0*" PRIx64 "  Offset: %#08" PRIx64 "  Link to section: [%2u] '%s'\n",
-		    nbucket),
-	  (unsigned int) elf_ndxscn (scn),
-	  elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
-	  (int) nbucket,
-	  gelf_getclass (ebl->elf) == ELFCLASS32 ? 10 : 18,
-	  shdr->sh_addr,
-	  shdr->sh_offset,
-	  (unsigned int) shdr->sh_link,
-	  elf_strptr (ebl->elf, shstrndx, glink->sh_name));
+		     nbucket),
+	   (unsigned int) elf_ndxscn (scn),
+	   elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
+	   (int) nbucket,
+	   gelf_getclass (ebl->elf) == ELFCLASS32 ? 10 : 18,
+	   shdr->sh_addr,
+	   shdr->sh_offset,
+	   (unsigned int) shdr->sh_link,
+	   elf_strptr (ebl->elf, shstrndx, glink->sh_name));
 
   if (extrastr != NULL)
-    fputs (extrastr, stdout);
+    fputs (extrastr, output);
 
   if (likely (nbucket > 0))
     {
@@ -2823,18 +3032,18 @@ print_hash_info (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr, size_t shstrndx,
 
       
       fputs_unlocked (gettext ("\
- Length  Number  % of total  Coverage\n"), stdout);
-      printf (gettext ("      0  %6" PRIu32 "      %5.1f%%\n"),
-	      counts[0], (counts[0] * 100.0) / nbucket);
+ Length  Number  % of total  Coverage\n"), output);
+      fprintf (output, gettext ("      0  %6" PRIu32 "      %5.1f%%\n"),
+	       counts[0], (counts[0] * 100.0) / nbucket);
 
       uint64_t nzero_counts = 0;
       for (Elf32_Word cnt = 1; cnt <= maxlength; ++cnt)
 	{
 	  nzero_counts += counts[cnt] * cnt;
-	  printf (gettext ("\
+	  fprintf (output, gettext ("\
 %7d  %6" PRIu32 "      %5.1f%%    %5.1f%%\n"),
-		  (int) cnt, counts[cnt], (counts[cnt] * 100.0) / nbucket,
-		  (nzero_counts * 100.0) / nsyms);
+		   (int) cnt, counts[cnt], (counts[cnt] * 100.0) / nbucket,
+		   (nzero_counts * 100.0) / nsyms);
 	}
 
       Elf32_Word acc = 0;
@@ -2844,11 +3053,11 @@ print_hash_info (Ebl *ebl, Elf_Scn *scn, GElf_Shdr *shdr, size_t shstrndx,
 	  success += counts[cnt] * acc;
 	}
 
-      printf (gettext ("\
+      fprintf (output, gettext ("\
  Average number of tests:   successful lookup: %f\n\
 			  unsuccessful lookup: %f\n"),
-	      (double) success / (double) nzero_counts,
-	      (double) nzero_counts / (double) nbucket);
+	       (double) success / (double) nzero_counts,
+	       (double) nzero_counts / (double) nbucket);
     }
 
   free (counts);
@@ -3109,21 +3318,21 @@ print_liblist (Ebl *ebl)
 	{
 	  size_t sh_entsize = gelf_fsize (ebl->elf, ELF_T_LIB, 1, EV_CURRENT);
 	  int nentries = shdr->sh_size / sh_entsize;
-	  printf (ngettext ("\
+	  fprintf (output, ngettext ("\
 \nLibrary list section [%2zu] '%s' at offset %#0" PRIx64 " contains %d entry:\n",
-			    "\
+			     "\
 \nLibrary list section [%2zu] '%s' at offset %#0" PRIx64 " contains %d entries:\n",
-			    nentries),
-		  elf_ndxscn (scn),
-		  elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
-		  shdr->sh_offset,
-		  nentries);
+			     nentries),
+		   elf_ndxscn (scn),
+		   elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
+		   shdr->sh_offset,
+		   nentries);
 
 	  Elf_Data *data = elf_getdata (scn, NULL);
 	  if (data == NULL)
 	    return;
 
-	  puts (gettext ("\
+	  fprintf (output, "%s\n", gettext ("\
        Library                       Time Stamp          Checksum Version Flags"));
 
 	  for (int cnt = 0; cnt < nentries; ++cnt)
@@ -3138,13 +3347,14 @@ print_liblist (Ebl *ebl)
 	      if (unlikely (tm == NULL))
 		continue;
 
-	      printf ("  [%2d] %-29s %04u-%02u-%02uT%02u:%02u:%02u %08x %-7u %u\n",
-		      cnt, elf_strptr (ebl->elf, shdr->sh_link, lib->l_name),
-		      tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday,
-		      tm->tm_hour, tm->tm_min, tm->tm_sec,
-		      (unsigned int) lib->l_checksum,
-		      (unsigned int) lib->l_version,
-		      (unsigned int) lib->l_flags);
+	      fprintf (output, "  [%2d] %-29s %04u-%02u-%02uT%02u:%02u:%02u"
+		       " %08x %-7u %u\n",
+		       cnt, elf_strptr (ebl->elf, shdr->sh_link, lib->l_name),
+		       tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday,
+		       tm->tm_hour, tm->tm_min, tm->tm_sec,
+		       (unsigned int) lib->l_checksum,
+		       (unsigned int) lib->l_version,
+		       (unsigned int) lib->l_flags);
 	    }
 	}
     }
@@ -3171,12 +3381,12 @@ print_attributes (Ebl *ebl, const GElf_Ehdr *ehdr)
 			       || ehdr->e_machine != EM_ARM)))
 	continue;
 
-      printf (gettext ("\
+      fprintf (output, gettext ("\
 \nObject attributes section [%2zu] '%s' of %" PRIu64
-		       " bytes at offset %#0" PRIx64 ":\n"),
-	      elf_ndxscn (scn),
-	      elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
-	      shdr->sh_size, shdr->sh_offset);
+			" bytes at offset %#0" PRIx64 ":\n"),
+	       elf_ndxscn (scn),
+	       elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
+	       shdr->sh_size, shdr->sh_offset);
 
       Elf_Data *data = elf_rawdata (scn, NULL);
       if (unlikely (data == NULL || data->d_size == 0))
@@ -3188,7 +3398,7 @@ print_attributes (Ebl *ebl, const GElf_Ehdr *ehdr)
       if (unlikely (*p++ != 'A'))
 	return;
 
-      fputs_unlocked (gettext ("  Owner          Size\n"), stdout);
+      fputs_unlocked (gettext ("  Owner          Size\n"), output);
 
       inline size_t left (void)
       {
@@ -3217,7 +3427,7 @@ print_attributes (Ebl *ebl, const GElf_Ehdr *ehdr)
 	    break;
 	  ++q;
 
-	  printf (gettext ("  %-13s  %4" PRIu32 "\n"), name, len);
+	  fprintf (output, gettext ("  %-13s  %4" PRIu32 "\n"), name, len);
 
 	  bool gnu_vendor = (q - name == sizeof "gnu"
 			     && !memcmp (name, "gnu", sizeof "gnu"));
@@ -3256,13 +3466,13 @@ print_attributes (Ebl *ebl, const GElf_Ehdr *ehdr)
 		  {
 		  default:
 		    
-		    printf (gettext ("    %-4u %12" PRIu32 "\n"),
-			    subsection_tag, subsection_len);
+		    fprintf (output, gettext ("    %-4u %12" PRIu32 "\n"),
+			     subsection_tag, subsection_len);
 		    break;
 
 		  case 1:	
-		    printf (gettext ("    File: %11" PRIu32 "\n"),
-			    subsection_len);
+		    fprintf (output, gettext ("    File: %11" PRIu32 "\n"),
+			     subsection_len);
 
 		    while (r < q)
 		      {
@@ -3302,25 +3512,28 @@ print_attributes (Ebl *ebl, const GElf_Ehdr *ehdr)
 			if (tag_name != NULL)
 			  {
 			    if (tag == 32)
-			      printf (gettext ("      %s: %" PRId64 ", %s\n"),
-				      tag_name, value, string);
+			      fprintf (output, gettext ("      %s: %"
+							PRId64 ", %s\n"),
+				       tag_name, value, string);
 			    else if (string == NULL && value_name == NULL)
-			      printf (gettext ("      %s: %" PRId64 "\n"),
-				      tag_name, value);
+			      fprintf (output, gettext ("      %s: %"
+							PRId64 "\n"),
+				       tag_name, value);
 			    else
-			      printf (gettext ("      %s: %s\n"),
-				      tag_name, string ?: value_name);
+			      fprintf (output, gettext ("      %s: %s\n"),
+				       tag_name, string ?: value_name);
 			  }
 			else
 			  {
 			    assert (tag != 32
 				    || strcmp ((const char *) name, "gnu"));
 			    if (string == NULL)
-			      printf (gettext ("      %u: %" PRId64 "\n"),
-				      tag, value);
+			      fprintf (output, gettext ("      %u: %"
+							PRId64 "\n"),
+				       tag, value);
 			    else
-			      printf (gettext ("      %u: %s\n"),
-				      tag, string);
+			      fprintf (output, gettext ("      %u: %s\n"),
+				       tag, string);
 			  }
 		      }
 		  }
@@ -3330,6 +3543,8 @@ print_attributes (Ebl *ebl, const GElf_Ehdr *ehdr)
 }
 
 
+static pthread_mutex_t dwfl_lock = PTHREAD_MUTEX_INITIALIZER;
+
 static char *
 format_dwarf_addr (Dwfl_Module *dwflmod,
 		   int address_size, Dwarf_Addr address, Dwarf_Addr raw)
@@ -3337,6 +3552,7 @@ format_dwarf_addr (Dwfl_Module *dwflmod,
   
   GElf_Sym sym;
   GElf_Off off = 0;
+  pthread_mutex_lock (&dwfl_lock);
   const char *name = (print_address_names && ! print_unresolved_addresses)
     ? dwfl_module_addrinfo (dwflmod, address, &off, &sym, NULL, NULL, NULL)
     : NULL;
@@ -3357,6 +3573,7 @@ format_dwarf_addr (Dwfl_Module *dwflmod,
       scn = (i < 0 ? NULL
 	     : dwfl_module_relocation_info (dwflmod, i, NULL));
     }
+  pthread_mutex_unlock (&dwfl_lock);
 
   char *result;
   if ((name != NULL
@@ -3648,7 +3865,7 @@ string_or_unknown (const char *known, unsigned int code,
                    unsigned int lo_user, unsigned int hi_user,
 		   bool print_unknown_num)
 {
-  static char unknown_buf[20];
+  static __thread char unknown_buf[20];
 
   if (likely (known != NULL))
     return known;
@@ -3777,15 +3994,15 @@ static void
 print_block (size_t n, const void *block)
 {
   if (n == 0)
-    puts (_("empty block"));
+    fprintf (output, "%s\n", _("empty block"));
   else
     {
-      printf (_("%zu byte block:"), n);
+      fprintf (output, _("%zu byte block:"), n);
       const unsigned char *data = block;
       do
-	printf (" %02x", *data++);
+	fprintf (output, " %02x", *data++);
       while (--n > 0);
-      putchar ('\n');
+      putc ('\n', output);
     }
 }
 
@@ -3798,7 +4015,7 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 
   if (len == 0)
     {
-      printf ("%*s(empty)\n", indent, "");
+      fprintf (output, "%*s(empty)\n", indent, "");
       return;
     }
 
@@ -3837,8 +4054,8 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	  CONSUME (addrsize);
 
 	  char *a = format_dwarf_addr (dwflmod, 0, addr, addr);
-	  printf ("%*s[%4" PRIuMAX "] %s %s\n",
-		  indent, "", (uintmax_t) offset, op_name, a);
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s %s\n",
+		   indent, "", (uintmax_t) offset, op_name, a);
 	  free (a);
 
 	  offset += 1 + addrsize;
@@ -3856,9 +4073,9 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	  data += ref_size;
 	  CONSUME (ref_size);
 
-	  printf ("%*s[%4" PRIuMAX "] %s %#" PRIxMAX "\n",
-		  indent, "", (uintmax_t) offset,
-		  op_name, (uintmax_t) addr);
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s %#" PRIxMAX "\n",
+		   indent, "", (uintmax_t) offset,
+		   op_name, (uintmax_t) addr);
 	  offset += 1 + ref_size;
 	  break;
 
@@ -3868,9 +4085,9 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	case DW_OP_const1u:
 	  
 	  NEED (1);
-	  printf ("%*s[%4" PRIuMAX "] %s %" PRIu8 "\n",
-		  indent, "", (uintmax_t) offset,
-		  op_name, *((uint8_t *) data));
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s %" PRIu8 "\n",
+		   indent, "", (uintmax_t) offset,
+		   op_name, *((uint8_t *) data));
 	  ++data;
 	  --len;
 	  offset += 2;
@@ -3879,9 +4096,9 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	case DW_OP_const2u:
 	  NEED (2);
 	  
-	  printf ("%*s[%4" PRIuMAX "] %s %" PRIu16 "\n",
-		  indent, "", (uintmax_t) offset,
-		  op_name, read_2ubyte_unaligned (dbg, data));
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s %" PRIu16 "\n",
+		   indent, "", (uintmax_t) offset,
+		   op_name, read_2ubyte_unaligned (dbg, data));
 	  CONSUME (2);
 	  data += 2;
 	  offset += 3;
@@ -3890,9 +4107,9 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	case DW_OP_const4u:
 	  NEED (4);
 	  
-	  printf ("%*s[%4" PRIuMAX "] %s %" PRIu32 "\n",
-		  indent, "", (uintmax_t) offset,
-		  op_name, read_4ubyte_unaligned (dbg, data));
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s %" PRIu32 "\n",
+		   indent, "", (uintmax_t) offset,
+		   op_name, read_4ubyte_unaligned (dbg, data));
 	  CONSUME (4);
 	  data += 4;
 	  offset += 5;
@@ -3901,9 +4118,9 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	case DW_OP_const8u:
 	  NEED (8);
 	  
-	  printf ("%*s[%4" PRIuMAX "] %s %" PRIu64 "\n",
-		  indent, "", (uintmax_t) offset,
-		  op_name, (uint64_t) read_8ubyte_unaligned (dbg, data));
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s %" PRIu64 "\n",
+		   indent, "", (uintmax_t) offset,
+		   op_name, (uint64_t) read_8ubyte_unaligned (dbg, data));
 	  CONSUME (8);
 	  data += 8;
 	  offset += 9;
@@ -3912,9 +4129,9 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	case DW_OP_const1s:
 	  NEED (1);
 	  
-	  printf ("%*s[%4" PRIuMAX "] %s %" PRId8 "\n",
-		  indent, "", (uintmax_t) offset,
-		  op_name, *((int8_t *) data));
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s %" PRId8 "\n",
+		   indent, "", (uintmax_t) offset,
+		   op_name, *((int8_t *) data));
 	  ++data;
 	  --len;
 	  offset += 2;
@@ -3923,9 +4140,9 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	case DW_OP_const2s:
 	  NEED (2);
 	  
-	  printf ("%*s[%4" PRIuMAX "] %s %" PRId16 "\n",
-		  indent, "", (uintmax_t) offset,
-		  op_name, read_2sbyte_unaligned (dbg, data));
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s %" PRId16 "\n",
+		   indent, "", (uintmax_t) offset,
+		   op_name, read_2sbyte_unaligned (dbg, data));
 	  CONSUME (2);
 	  data += 2;
 	  offset += 3;
@@ -3934,9 +4151,9 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	case DW_OP_const4s:
 	  NEED (4);
 	  
-	  printf ("%*s[%4" PRIuMAX "] %s %" PRId32 "\n",
-		  indent, "", (uintmax_t) offset,
-		  op_name, read_4sbyte_unaligned (dbg, data));
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s %" PRId32 "\n",
+		   indent, "", (uintmax_t) offset,
+		   op_name, read_4sbyte_unaligned (dbg, data));
 	  CONSUME (4);
 	  data += 4;
 	  offset += 5;
@@ -3945,9 +4162,9 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	case DW_OP_const8s:
 	  NEED (8);
 	  
-	  printf ("%*s[%4" PRIuMAX "] %s %" PRId64 "\n",
-		  indent, "", (uintmax_t) offset,
-		  op_name, read_8sbyte_unaligned (dbg, data));
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s %" PRId64 "\n",
+		   indent, "", (uintmax_t) offset,
+		   op_name, read_8sbyte_unaligned (dbg, data));
 	  CONSUME (8);
 	  data += 8;
 	  offset += 9;
@@ -3961,8 +4178,8 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	  uint64_t uleb;
 	  NEED (1);
 	  get_uleb128 (uleb, data, data + len);
-	  printf ("%*s[%4" PRIuMAX "] %s %" PRIu64 "\n",
-		  indent, "", (uintmax_t) offset, op_name, uleb);
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s %" PRIu64 "\n",
+		   indent, "", (uintmax_t) offset, op_name, uleb);
 	  CONSUME (data - start);
 	  offset += 1 + (data - start);
 	  break;
@@ -3974,8 +4191,8 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	  get_uleb128 (uleb, data, data + len);
 	  NEED (1);
 	  get_uleb128 (uleb2, data, data + len);
-	  printf ("%*s[%4" PRIuMAX "] %s %" PRIu64 ", %" PRIu64 "\n",
-		  indent, "", (uintmax_t) offset, op_name, uleb, uleb2);
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s %" PRIu64 ", %" PRIu64 "\n",
+		   indent, "", (uintmax_t) offset, op_name, uleb, uleb2);
 	  CONSUME (data - start);
 	  offset += 1 + (data - start);
 	  break;
@@ -3987,8 +4204,8 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	  int64_t sleb;
 	  NEED (1);
 	  get_sleb128 (sleb, data, data + len);
-	  printf ("%*s[%4" PRIuMAX "] %s %" PRId64 "\n",
-		  indent, "", (uintmax_t) offset, op_name, sleb);
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s %" PRId64 "\n",
+		   indent, "", (uintmax_t) offset, op_name, sleb);
 	  CONSUME (data - start);
 	  offset += 1 + (data - start);
 	  break;
@@ -3999,26 +4216,26 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	  get_uleb128 (uleb, data, data + len);
 	  NEED (1);
 	  get_sleb128 (sleb, data, data + len);
-	  printf ("%*s[%4" PRIuMAX "] %s %" PRIu64 " %" PRId64 "\n",
-		  indent, "", (uintmax_t) offset, op_name, uleb, sleb);
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s %" PRIu64 " %" PRId64 "\n",
+		   indent, "", (uintmax_t) offset, op_name, uleb, sleb);
 	  CONSUME (data - start);
 	  offset += 1 + (data - start);
 	  break;
 
 	case DW_OP_call2:
 	  NEED (2);
-	  printf ("%*s[%4" PRIuMAX "] %s %" PRIu16 "\n",
-		  indent, "", (uintmax_t) offset, op_name,
-		  read_2ubyte_unaligned (dbg, data));
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s %" PRIu16 "\n",
+		   indent, "", (uintmax_t) offset, op_name,
+		   read_2ubyte_unaligned (dbg, data));
 	  CONSUME (2);
 	  offset += 3;
 	  break;
 
 	case DW_OP_call4:
 	  NEED (4);
-	  printf ("%*s[%4" PRIuMAX "] %s %" PRIu32 "\n",
-		  indent, "", (uintmax_t) offset, op_name,
-		  read_4ubyte_unaligned (dbg, data));
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s %" PRIu32 "\n",
+		   indent, "", (uintmax_t) offset, op_name,
+		   read_4ubyte_unaligned (dbg, data));
 	  CONSUME (4);
 	  offset += 5;
 	  break;
@@ -4026,9 +4243,10 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	case DW_OP_skip:
 	case DW_OP_bra:
 	  NEED (2);
-	  printf ("%*s[%4" PRIuMAX "] %s %" PRIuMAX "\n",
-		  indent, "", (uintmax_t) offset, op_name,
-		  (uintmax_t) (offset + read_2sbyte_unaligned (dbg, data) + 3));
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s %" PRIuMAX "\n",
+		   indent, "", (uintmax_t) offset, op_name,
+		   (uintmax_t) (offset
+				+ read_2sbyte_unaligned (dbg, data) + 3));
 	  CONSUME (2);
 	  data += 2;
 	  offset += 3;
@@ -4038,8 +4256,8 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	  start = data;
 	  NEED (1);
 	  get_uleb128 (uleb, data, data + len);
-	  printf ("%*s[%4" PRIuMAX "] %s: ",
-		  indent, "", (uintmax_t) offset, op_name);
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s: ",
+		   indent, "", (uintmax_t) offset, op_name);
 	  NEED (uleb);
 	  print_block (uleb, data);
 	  data += uleb;
@@ -4062,9 +4280,10 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	  NEED (1);
 	  get_sleb128 (sleb, data, data + len);
 
-	  printf ("%*s[%4" PRIuMAX "] %s [%6" PRIxMAX "] %+" PRId64 "\n",
-		  indent, "", (intmax_t) offset,
-		  op_name, (uintmax_t) addr, sleb);
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s [%6" PRIxMAX "] %+"
+		   PRId64 "\n",
+		   indent, "", (intmax_t) offset,
+		   op_name, (uintmax_t) addr, sleb);
 	  CONSUME (data - start);
 	  offset += 1 + (data - start);
 	  break;
@@ -4074,8 +4293,8 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	  start = data;
 	  NEED (1);
 	  get_uleb128 (uleb, data, data + len);
-	  printf ("%*s[%4" PRIuMAX "] %s:\n",
-		  indent, "", (uintmax_t) offset, op_name);
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s:\n",
+		   indent, "", (uintmax_t) offset, op_name);
 	  NEED (uleb);
 	  print_ops (dwflmod, dbg, indent + 6, indent + 6, vers,
 		     addrsize, offset_size, cu, uleb, data);
@@ -4093,8 +4312,8 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	  NEED (1);
 	  uint8_t usize = *(uint8_t *) data++;
 	  NEED (usize);
-	  printf ("%*s[%4" PRIuMAX "] %s [%6" PRIxMAX "] ",
-		  indent, "", (uintmax_t) offset, op_name, uleb);
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s [%6" PRIxMAX "] ",
+		   indent, "", (uintmax_t) offset, op_name, uleb);
 	  print_block (usize, data);
 	  data += usize;
 	  CONSUME (data - start);
@@ -4109,8 +4328,9 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	  get_uleb128 (uleb2, data, data + len);
 	  if (! print_unresolved_addresses && cu != NULL)
 	    uleb2 += cu->start;
-	  printf ("%*s[%4" PRIuMAX "] %s %" PRIu64 " [%6" PRIx64 "]\n",
-		  indent, "", (uintmax_t) offset, op_name, uleb, uleb2);
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s %" PRIu64 " [%6"
+		   PRIx64 "]\n",
+		   indent, "", (uintmax_t) offset, op_name, uleb, uleb2);
 	  CONSUME (data - start);
 	  offset += 1 + (data - start);
 	  break;
@@ -4123,9 +4343,10 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	  get_uleb128 (uleb, data, data + len);
 	  if (! print_unresolved_addresses && cu != NULL)
 	    uleb += cu->start;
-	  printf ("%*s[%4" PRIuMAX "] %s %" PRIu8 " [%6" PRIxMAX "]\n",
-		  indent, "", (uintmax_t) offset,
-		  op_name, usize, uleb);
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s %" PRIu8 " [%6"
+		   PRIxMAX "]\n",
+		   indent, "", (uintmax_t) offset,
+		   op_name, usize, uleb);
 	  CONSUME (data - start);
 	  offset += 1 + (data - start);
 	  break;
@@ -4137,8 +4358,8 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	  get_uleb128 (uleb, data, data + len);
 	  if (uleb != 0 && ! print_unresolved_addresses && cu != NULL)
 	    uleb += cu->start;
-	  printf ("%*s[%4" PRIuMAX "] %s [%6" PRIxMAX "]\n",
-		  indent, "", (uintmax_t) offset, op_name, uleb);
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s [%6" PRIxMAX "]\n",
+		   indent, "", (uintmax_t) offset, op_name, uleb);
 	  CONSUME (data - start);
 	  offset += 1 + (data - start);
 	  break;
@@ -4148,8 +4369,8 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 	  uintmax_t param_off = (uintmax_t) read_4ubyte_unaligned (dbg, data);
 	  if (! print_unresolved_addresses && cu != NULL)
 	    param_off += cu->start;
-	  printf ("%*s[%4" PRIuMAX "] %s [%6" PRIxMAX "]\n",
-		  indent, "", (uintmax_t) offset, op_name, param_off);
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s [%6" PRIxMAX "]\n",
+		   indent, "", (uintmax_t) offset, op_name, param_off);
 	  CONSUME (4);
 	  data += 4;
 	  offset += 5;
@@ -4157,8 +4378,8 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
 
 	default:
 	  
-	  printf ("%*s[%4" PRIuMAX "] %s\n",
-		  indent, "", (uintmax_t) offset, op_name);
+	  fprintf (output, "%*s[%4" PRIuMAX "] %s\n",
+		   indent, "", (uintmax_t) offset, op_name);
 	  ++offset;
 	  break;
 	}
@@ -4167,8 +4388,8 @@ print_ops (Dwfl_Module *dwflmod, Dwarf *dbg, int indent, int indentrest,
       continue;
 
     invalid:
-      printf (gettext ("%*s[%4" PRIuMAX "] %s  <TRUNCATED>\n"),
-	      indent, "", (uintmax_t) offset, op_name);
+      fprintf (output, gettext ("%*s[%4" PRIuMAX "] %s  <TRUNCATED>\n"),
+	       indent, "", (uintmax_t) offset, op_name);
       break;
     }
 }
@@ -4238,6 +4459,12 @@ compare_listptr (const void *a, const void *b, void *arg)
 	}
     }
 
+  
+  if (p1->cu->start < p2->cu->start)
+    return -1;
+  if (p1->cu->start > p2->cu->start)
+    return 1;
+
   return 0;
 }
 
@@ -4259,13 +4486,17 @@ reset_listptr (struct listptr_table *table)
   table->n = table->alloc = 0;
 }
 
+static pthread_mutex_t listptr_lock = PTHREAD_MUTEX_INITIALIZER;
+
 static bool
 notice_listptr (enum section_e section, struct listptr_table *table,
 		uint_fast8_t address_size, uint_fast8_t offset_size,
 		struct Dwarf_CU *cu, Dwarf_Off offset)
 {
+  bool ok = true;
   if (print_debug_sections & section)
     {
+      pthread_mutex_lock (&listptr_lock);
       if (table->n == table->alloc)
 	{
 	  if (table->alloc == 0)
@@ -4289,10 +4520,11 @@ notice_listptr (enum section_e section, struct listptr_table *table,
       if (p->offset != offset)
 	{
 	  table->n--;
-	  return false;
+	  ok = false;
 	}
+      pthread_mutex_unlock (&listptr_lock);
     }
-  return true;
+  return ok;
 }
 
 static void
@@ -4321,16 +4553,18 @@ skip_listptr_hole (struct listptr_table *table, size_t *idxp,
       || p->offset >= (Dwarf_Off) (endp - *readp + offset))
     {
       *readp = endp;
-      printf (gettext (" [%6tx]  <UNUSED GARBAGE IN REST OF SECTION>\n"),
-	      offset);
+      fprintf (output,
+	       gettext (" [%6tx]  <UNUSED GARBAGE IN REST OF SECTION>\n"),
+	       offset);
       return true;
     }
 
   if (p->offset != (Dwarf_Off) offset)
     {
       *readp += p->offset - offset;
-      printf (gettext (" [%6tx]  <UNUSED GARBAGE> ... %" PRIu64 " bytes ...\n"),
-	      offset, (Dwarf_Off) p->offset - offset);
+      fprintf (output, gettext (" [%6tx]  <UNUSED GARBAGE> ... %"
+				PRIu64 " bytes ...\n"),
+	       offset, (Dwarf_Off) p->offset - offset);
       return true;
     }
 
@@ -4355,16 +4589,18 @@ print_debug_abbrev_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
   const size_t sh_size = (dbg->sectiondata[IDX_debug_abbrev] ?
 			  dbg->sectiondata[IDX_debug_abbrev]->d_size : 0);
 
-  printf (gettext ("\nDWARF section [%2zu] '%s' at offset %#" PRIx64 ":\n"
-		   " [ Code]\n"),
-	  elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
-	  (uint64_t) shdr->sh_offset);
+  fprintf (output,
+	   gettext ("\nDWARF section [%2zu] '%s' at offset %#" PRIx64 ":\n"
+		    " [ Code]\n"),
+	   elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
+	   (uint64_t) shdr->sh_offset);
 
   Dwarf_Off offset = 0;
   while (offset < sh_size)
     {
-      printf (gettext ("\nAbbreviation section at offset %" PRIu64 ":\n"),
-	      offset);
+      fprintf (output, gettext ("\nAbbreviation section at offset %"
+				PRIu64 ":\n"),
+	       offset);
 
       while (1)
 	{
@@ -4376,9 +4612,9 @@ print_debug_abbrev_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 	    {
 	      if (unlikely (res < 0))
 		{
-		  printf (gettext ("\
+		  fprintf (output, gettext ("\
  *** error while reading abbreviation: %s\n"),
-			  dwarf_errmsg (-1));
+			   dwarf_errmsg (-1));
 		  return;
 		}
 
@@ -4392,11 +4628,11 @@ print_debug_abbrev_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 	  unsigned int tag = dwarf_getabbrevtag (&abbrev);
 	  int has_children = dwarf_abbrevhaschildren (&abbrev);
 
-	  printf (gettext (" [%5u] offset: %" PRId64
-			   ", children: %s, tag: %s\n"),
-		  code, (int64_t) offset,
-		  has_children ? gettext ("yes") : gettext ("no"),
-		  dwarf_tag_name (tag));
+	  fprintf (output, gettext (" [%5u] offset: %" PRId64
+				    ", children: %s, tag: %s\n"),
+		   code, (int64_t) offset,
+		   has_children ? gettext ("yes") : gettext ("no"),
+		   dwarf_tag_name (tag));
 
 	  size_t cnt = 0;
 	  unsigned int name;
@@ -4405,9 +4641,10 @@ print_debug_abbrev_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 	  while (dwarf_getabbrevattr (&abbrev, cnt,
 				      &name, &form, &enoffset) == 0)
 	    {
-	      printf ("          attr: %s, form: %s, offset: %#" PRIx64 "\n",
-		      dwarf_attr_name (name), dwarf_form_name (form),
-		      (uint64_t) enoffset);
+	      fprintf (output, "          attr: %s, form: %s, offset: %#"
+		       PRIx64 "\n",
+		       dwarf_attr_name (name), dwarf_form_name (form),
+		       (uint64_t) enoffset);
 
 	      ++cnt;
 	    }
@@ -4441,13 +4678,13 @@ print_decoded_aranges_section (Ebl *ebl, GElf_Ehdr *ehdr, Elf_Scn *scn,
       return;
     }
 
-  printf (ngettext ("\
+  fprintf (output, ngettext ("\
 \nDWARF section [%2zu] '%s' at offset %#" PRIx64 " contains %zu entry:\n",
-		    "\
+		     "\
 \nDWARF section [%2zu] '%s' at offset %#" PRIx64 " contains %zu entries:\n",
-		    cnt),
-	  elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
-	  (uint64_t) shdr->sh_offset, cnt);
+		     cnt),
+	   elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
+	   (uint64_t) shdr->sh_offset, cnt);
 
   
   size_t tmp = cnt;
@@ -4463,7 +4700,8 @@ print_decoded_aranges_section (Ebl *ebl, GElf_Ehdr *ehdr, Elf_Scn *scn,
       Dwarf_Arange *runp = dwarf_onearange (aranges, n);
       if (unlikely (runp == NULL))
 	{
-	  printf ("cannot get arange %zu: %s\n", n, dwarf_errmsg (-1));
+	  fprintf (output, "cannot get arange %zu: %s\n", n,
+		   dwarf_errmsg (-1));
 	  return;
 	}
 
@@ -4472,13 +4710,13 @@ print_decoded_aranges_section (Ebl *ebl, GElf_Ehdr *ehdr, Elf_Scn *scn,
       Dwarf_Off offset;
 
       if (unlikely (dwarf_getarangeinfo (runp, &start, &length, &offset) != 0))
-	printf (gettext (" [%*zu] ???\n"), digits, n);
+	fprintf (output, gettext (" [%*zu] ???\n"), digits, n);
       else
-	printf (gettext (" [%*zu] start: %0#*" PRIx64
-			 ", length: %5" PRIu64 ", CU DIE offset: %6"
-			 PRId64 "\n"),
-		digits, n, ehdr->e_ident[EI_CLASS] == ELFCLASS32 ? 10 : 18,
-		(uint64_t) start, (uint64_t) length, (int64_t) offset);
+	fprintf (output, gettext (" [%*zu] start: %0#*" PRIx64
+				  ", length: %5" PRIu64 ", CU DIE offset: %6"
+				  PRId64 "\n"),
+		 digits, n, ehdr->e_ident[EI_CLASS] == ELFCLASS32 ? 10 : 18,
+		 (uint64_t) start, (uint64_t) length, (int64_t) offset);
     }
 }
 
@@ -4503,10 +4741,10 @@ print_debug_aranges_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
       return;
     }
 
-  printf (gettext ("\
+  fprintf (output, gettext ("\
 \nDWARF section [%2zu] '%s' at offset %#" PRIx64 ":\n"),
-	  elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
-	  (uint64_t) shdr->sh_offset);
+	   elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
+	   (uint64_t) shdr->sh_offset);
 
   const unsigned char *readp = data->d_buf;
   const unsigned char *readendp = readp + data->d_size;
@@ -4516,7 +4754,7 @@ print_debug_aranges_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
       const unsigned char *hdrstart = readp;
       size_t start_offset = hdrstart - (const unsigned char *) data->d_buf;
 
-      printf (gettext ("\nTable at offset %Zu:\n"), start_offset);
+      fprintf (output, gettext ("\nTable at offset %Zu:\n"), start_offset);
       if (readp + 4 > readendp)
 	{
 	invalid_data:
@@ -4536,8 +4774,8 @@ print_debug_aranges_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 	}
 
       const unsigned char *nexthdr = readp + length;
-      printf (gettext ("\n Length:        %6" PRIu64 "\n"),
-	      (uint64_t) length);
+      fprintf (output, gettext ("\n Length:        %6" PRIu64 "\n"),
+	       (uint64_t) length);
 
       if (unlikely (length > (size_t) (readendp - readp)))
 	goto invalid_data;
@@ -4548,8 +4786,8 @@ print_debug_aranges_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
       if (readp + 2 > readendp)
 	goto invalid_data;
       uint_fast16_t version = read_2ubyte_unaligned_inc (dbg, readp);
-      printf (gettext (" DWARF version: %6" PRIuFAST16 "\n"),
-	      version);
+      fprintf (output, gettext (" DWARF version: %6" PRIuFAST16 "\n"),
+	       version);
       if (version != 2)
 	{
 	  error (0, 0, gettext ("unsupported aranges version"));
@@ -4563,14 +4801,14 @@ print_debug_aranges_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 	offset = read_8ubyte_unaligned_inc (dbg, readp);
       else
 	offset = read_4ubyte_unaligned_inc (dbg, readp);
-      printf (gettext (" CU offset:     %6" PRIx64 "\n"),
-	      (uint64_t) offset);
+      fprintf (output, gettext (" CU offset:     %6" PRIx64 "\n"),
+	       (uint64_t) offset);
 
       if (readp + 1 > readendp)
 	goto invalid_data;
       unsigned int address_size = *readp++;
-      printf (gettext (" Address size:  %6" PRIu64 "\n"),
-	      (uint64_t) address_size);
+      fprintf (output, gettext (" Address size:  %6" PRIu64 "\n"),
+	       (uint64_t) address_size);
       if (address_size != 4 && address_size != 8)
 	{
 	  error (0, 0, gettext ("unsupported address size"));
@@ -4578,8 +4816,8 @@ print_debug_aranges_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 	}
 
       unsigned int segment_size = *readp++;
-      printf (gettext (" Segment size:  %6" PRIu64 "\n\n"),
-	      (uint64_t) segment_size);
+      fprintf (output, gettext (" Segment size:  %6" PRIu64 "\n\n"),
+	       (uint64_t) segment_size);
       if (segment_size != 0 && segment_size != 4 && segment_size != 8)
 	{
 	  error (0, 0, gettext ("unsupported segment size"));
@@ -4622,10 +4860,10 @@ print_debug_aranges_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 				       range_address + range_length - 1,
 				       range_length);
 	  if (segment_size != 0)
-	    printf (gettext ("   %s..%s (%" PRIx64 ")\n"), b, e,
-		    (uint64_t) segment);
+	    fprintf (output, gettext ("   %s..%s (%" PRIx64 ")\n"), b, e,
+		     (uint64_t) segment);
 	  else
-	    printf (gettext ("   %s..%s\n"), b, e);
+	    fprintf (output, gettext ("   %s..%s\n"), b, e);
 	  free (b);
 	  free (e);
 	}
@@ -4634,7 +4872,7 @@ print_debug_aranges_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
       if (readp != nexthdr)
 	{
 	  size_t padding = nexthdr - readp;
-	  printf (gettext ("   %Zu padding bytes\n"), padding);
+	  fprintf (output, gettext ("   %Zu padding bytes\n"), padding);
 	  readp = nexthdr;
 	}
     }
@@ -4656,10 +4894,10 @@ print_debug_ranges_section (Dwfl_Module *dwflmod,
       return;
     }
 
-  printf (gettext ("\
+  fprintf (output, gettext ("\
 \nDWARF section [%2zu] '%s' at offset %#" PRIx64 ":\n"),
-	  elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
-	  (uint64_t) shdr->sh_offset);
+	   elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
+	   (uint64_t) shdr->sh_offset);
 
   sort_listptr (&known_rangelistptr, "rangelistptr");
   size_t listptr_idx = 0;
@@ -4681,7 +4919,7 @@ print_debug_ranges_section (Dwfl_Module *dwflmod,
 
       if (unlikely (data->d_size - offset < (size_t) address_size * 2))
 	{
-	  printf (gettext (" [%6tx]  <INVALID DATA>\n"), offset);
+	  fprintf (output, gettext (" [%6tx]  <INVALID DATA>\n"), offset);
 	  break;
 	}
 
@@ -4703,14 +4941,14 @@ print_debug_ranges_section (Dwfl_Module *dwflmod,
       if (begin == (Dwarf_Addr) -1l) 
 	{
 	  char *b = format_dwarf_addr (dwflmod, address_size, end, end);
-	  printf (gettext (" [%6tx]  base address %s\n"), offset, b);
+	  fprintf (output, gettext (" [%6tx]  base address %s\n"), offset, b);
 	  free (b);
 	  base = end;
 	}
       else if (begin == 0 && end == 0) 
 	{
 	  if (first)
-	    printf (gettext (" [%6tx]  empty list\n"), offset);
+	    fprintf (output, gettext (" [%6tx]  empty list\n"), offset);
 	  first = true;
 	}
       else
@@ -4721,9 +4959,9 @@ print_debug_ranges_section (Dwfl_Module *dwflmod,
 				       end);
 	  
 	  if (first)		
-	    printf (gettext (" [%6tx]  %s..%s\n"), offset, b, e);
+	    fprintf (output, gettext (" [%6tx]  %s..%s\n"), offset, b, e);
 	  else
-	    printf (gettext ("           %s..%s\n"), b, e);
+	    fprintf (output, gettext ("           %s..%s\n"), b, e);
 	  free (b);
 	  free (e);
 
@@ -4779,7 +5017,7 @@ print_cfa_program (const unsigned char *readp, const unsigned char *const endp,
     return regnamebuf;
   }
 
-  puts ("\n   Program:");
+  fprintf (output, "%s\n", "\n   Program:");
   Dwarf_Word pc = vma_base;
   while (readp < endp)
     {
@@ -4795,35 +5033,35 @@ print_cfa_program (const unsigned char *readp, const unsigned char *const endp,
 	    int64_t sop2;
 
 	  case DW_CFA_nop:
-	    puts ("     nop");
+	    fprintf (output, "%s\n", "     nop");
 	    break;
 	  case DW_CFA_set_loc:
 	    if ((uint64_t) (endp - readp) < 1)
 	      goto invalid;
 	    get_uleb128 (op1, readp, endp);
 	    op1 += vma_base;
-	    printf ("     set_loc %" PRIu64 "\n", op1 * code_align);
+	    fprintf (output, "     set_loc %" PRIu64 "\n", op1 * code_align);
 	    break;
 	  case DW_CFA_advance_loc1:
 	    if ((uint64_t) (endp - readp) < 1)
 	      goto invalid;
-	    printf ("     advance_loc1 %u to %#" PRIx64 "\n",
-		    *readp, pc += *readp * code_align);
+	    fprintf (output, "     advance_loc1 %u to %#" PRIx64 "\n",
+		     *readp, pc += *readp * code_align);
 	    ++readp;
 	    break;
 	  case DW_CFA_advance_loc2:
 	    if ((uint64_t) (endp - readp) < 2)
 	      goto invalid;
 	    op1 = read_2ubyte_unaligned_inc (dbg, readp);
-	    printf ("     advance_loc2 %" PRIu64 " to %#" PRIx64 "\n",
-		    op1, pc += op1 * code_align);
+	    fprintf (output, "     advance_loc2 %" PRIu64 " to %#" PRIx64 "\n",
+		     op1, pc += op1 * code_align);
 	    break;
 	  case DW_CFA_advance_loc4:
 	    if ((uint64_t) (endp - readp) < 4)
 	      goto invalid;
 	    op1 = read_4ubyte_unaligned_inc (dbg, readp);
-	    printf ("     advance_loc4 %" PRIu64 " to %#" PRIx64 "\n",
-		    op1, pc += op1 * code_align);
+	    fprintf (output, "     advance_loc4 %" PRIu64 " to %#" PRIx64 "\n",
+		     op1, pc += op1 * code_align);
 	    break;
 	  case DW_CFA_offset_extended:
 	    if ((uint64_t) (endp - readp) < 1)
@@ -4832,28 +5070,30 @@ print_cfa_program (const unsigned char *readp, const unsigned char *const endp,
 	    if ((uint64_t) (endp - readp) < 1)
 	      goto invalid;
 	    get_uleb128 (op2, readp, endp);
-	    printf ("     offset_extended r%" PRIu64 " (%s) at cfa%+" PRId64
-		    "\n",
-		    op1, regname (op1), op2 * data_align);
+	    fprintf (output, "     offset_extended r%" PRIu64 " (%s) at cfa%+"
+		     PRId64 "\n",
+		     op1, regname (op1), op2 * data_align);
 	    break;
 	  case DW_CFA_restore_extended:
 	    if ((uint64_t) (endp - readp) < 1)
 	      goto invalid;
 	    get_uleb128 (op1, readp, endp);
-	    printf ("     restore_extended r%" PRIu64 " (%s)\n",
-		    op1, regname (op1));
+	    fprintf (output, "     restore_extended r%" PRIu64 " (%s)\n",
+		     op1, regname (op1));
 	    break;
 	  case DW_CFA_undefined:
 	    if ((uint64_t) (endp - readp) < 1)
 	      goto invalid;
 	    get_uleb128 (op1, readp, endp);
-	    printf ("     undefined r%" PRIu64 " (%s)\n", op1, regname (op1));
+	    fprintf (output, "     undefined r%" PRIu64 " (%s)\n", op1,
+		     regname (op1));
 	    break;
 	  case DW_CFA_same_value:
 	    if ((uint64_t) (endp - readp) < 1)
 	      goto invalid;
 	    get_uleb128 (op1, readp, endp);
-	    printf ("     same_value r%" PRIu64 " (%s)\n", op1, regname (op1));
+	    fprintf (output, "     same_value r%" PRIu64 " (%s)\n", op1,
+		     regname (op1));
 	    break;
 	  case DW_CFA_register:
 	    if ((uint64_t) (endp - readp) < 1)
@@ -4862,14 +5102,15 @@ print_cfa_program (const unsigned char *readp, const unsigned char *const endp,
 	    if ((uint64_t) (endp - readp) < 1)
 	      goto invalid;
 	    get_uleb128 (op2, readp, endp);
-	    printf ("     register r%" PRIu64 " (%s) in r%" PRIu64 " (%s)\n",
-		    op1, regname (op1), op2, regname (op2));
+	    fprintf (output, "     register r%" PRIu64 " (%s) in r%"
+		     PRIu64 " (%s)\n",
+		     op1, regname (op1), op2, regname (op2));
 	    break;
 	  case DW_CFA_remember_state:
-	    puts ("     remember_state");
+	    fprintf (output, "%s\n", "     remember_state");
 	    break;
 	  case DW_CFA_restore_state:
-	    puts ("     restore_state");
+	    fprintf (output, "%s\n", "     restore_state");
 	    break;
 	  case DW_CFA_def_cfa:
 	    if ((uint64_t) (endp - readp) < 1)
@@ -4878,31 +5119,32 @@ print_cfa_program (const unsigned char *readp, const unsigned char *const endp,
 	    if ((uint64_t) (endp - readp) < 1)
 	      goto invalid;
 	    get_uleb128 (op2, readp, endp);
-	    printf ("     def_cfa r%" PRIu64 " (%s) at offset %" PRIu64 "\n",
-		    op1, regname (op1), op2);
+	    fprintf (output, "     def_cfa r%" PRIu64 " (%s) at offset %"
+		     PRIu64 "\n",
+		     op1, regname (op1), op2);
 	    break;
 	  case DW_CFA_def_cfa_register:
 	    if ((uint64_t) (endp - readp) < 1)
 	      goto invalid;
 	    get_uleb128 (op1, readp, endp);
-	    printf ("     def_cfa_register r%" PRIu64 " (%s)\n",
-		    op1, regname (op1));
+	    fprintf (output, "     def_cfa_register r%" PRIu64 " (%s)\n",
+		     op1, regname (op1));
 	    break;
 	  case DW_CFA_def_cfa_offset:
 	    if ((uint64_t) (endp - readp) < 1)
 	      goto invalid;
 	    get_uleb128 (op1, readp, endp);
-	    printf ("     def_cfa_offset %" PRIu64 "\n", op1);
+	    fprintf (output, "     def_cfa_offset %" PRIu64 "\n", op1);
 	    break;
 	  case DW_CFA_def_cfa_expression:
 	    if ((uint64_t) (endp - readp) < 1)
 	      goto invalid;
 	    get_uleb128 (op1, readp, endp);	
-	    printf ("     def_cfa_expression %" PRIu64 "\n", op1);
+	    fprintf (output, "     def_cfa_expression %" PRIu64 "\n", op1);
 	    if ((uint64_t) (endp - readp) < op1)
 	      {
 	    invalid:
-	        fputs (gettext ("         <INVALID DATA>\n"), stdout);
+	        fputs (gettext ("         <INVALID DATA>\n"), output);
 		return;
 	      }
 	    print_ops (dwflmod, dbg, 10, 10, version, ptr_size, 0, NULL,
@@ -4916,8 +5158,8 @@ print_cfa_program (const unsigned char *readp, const unsigned char *const endp,
 	    if ((uint64_t) (endp - readp) < 1)
 	      goto invalid;
 	    get_uleb128 (op2, readp, endp);	
-	    printf ("     expression r%" PRIu64 " (%s) \n",
-		    op1, regname (op1));
+	    fprintf (output, "     expression r%" PRIu64 " (%s) \n",
+		     op1, regname (op1));
 	    if ((uint64_t) (endp - readp) < op2)
 	      goto invalid;
 	    print_ops (dwflmod, dbg, 10, 10, version, ptr_size, 0, NULL,
@@ -4931,9 +5173,9 @@ print_cfa_program (const unsigned char *readp, const unsigned char *const endp,
 	    if ((uint64_t) (endp - readp) < 1)
 	      goto invalid;
 	    get_sleb128 (sop2, readp, endp);
-	    printf ("     offset_extended_sf r%" PRIu64 " (%s) at cfa%+"
-		    PRId64 "\n",
-		    op1, regname (op1), sop2 * data_align);
+	    fprintf (output, "     offset_extended_sf r%" PRIu64
+		     " (%s) at cfa%+" PRId64 "\n",
+		     op1, regname (op1), sop2 * data_align);
 	    break;
 	  case DW_CFA_def_cfa_sf:
 	    if ((uint64_t) (endp - readp) < 1)
@@ -4942,14 +5184,16 @@ print_cfa_program (const unsigned char *readp, const unsigned char *const endp,
 	    if ((uint64_t) (endp - readp) < 1)
 	      goto invalid;
 	    get_sleb128 (sop2, readp, endp);
-	    printf ("     def_cfa_sf r%" PRIu64 " (%s) at offset %" PRId64 "\n",
-		    op1, regname (op1), sop2 * data_align);
+	    fprintf (output, "     def_cfa_sf r%" PRIu64 " (%s) at offset %"
+		     PRId64 "\n",
+		     op1, regname (op1), sop2 * data_align);
 	    break;
 	  case DW_CFA_def_cfa_offset_sf:
 	    if ((uint64_t) (endp - readp) < 1)
 	      goto invalid;
 	    get_sleb128 (sop1, readp, endp);
-	    printf ("     def_cfa_offset_sf %" PRId64 "\n", sop1 * data_align);
+	    fprintf (output, "     def_cfa_offset_sf %" PRId64 "\n",
+		     sop1 * data_align);
 	    break;
 	  case DW_CFA_val_offset:
 	    if ((uint64_t) (endp - readp) < 1)
@@ -4958,8 +5202,9 @@ print_cfa_program (const unsigned char *readp, const unsigned char *const endp,
 	    if ((uint64_t) (endp - readp) < 1)
 	      goto invalid;
 	    get_uleb128 (op2, readp, endp);
-	    printf ("     val_offset %" PRIu64 " at offset %" PRIu64 "\n",
-		    op1, op2 * data_align);
+	    fprintf (output, "     val_offset %" PRIu64 " at offset %"
+		     PRIu64 "\n",
+		     op1, op2 * data_align);
 	    break;
 	  case DW_CFA_val_offset_sf:
 	    if ((uint64_t) (endp - readp) < 1)
@@ -4968,8 +5213,9 @@ print_cfa_program (const unsigned char *readp, const unsigned char *const endp,
 	    if ((uint64_t) (endp - readp) < 1)
 	      goto invalid;
 	    get_sleb128 (sop2, readp, endp);
-	    printf ("     val_offset_sf %" PRIu64 " at offset %" PRId64 "\n",
-		    op1, sop2 * data_align);
+	    fprintf (output, "     val_offset_sf %" PRIu64 " at offset %"
+		     PRId64 "\n",
+		     op1, sop2 * data_align);
 	    break;
 	  case DW_CFA_val_expression:
 	    if ((uint64_t) (endp - readp) < 1)
@@ -4978,8 +5224,8 @@ print_cfa_program (const unsigned char *readp, const unsigned char *const endp,
 	    if ((uint64_t) (endp - readp) < 1)
 	      goto invalid;
 	    get_uleb128 (op2, readp, endp);	
-	    printf ("     val_expression r%" PRIu64 " (%s)\n",
-		    op1, regname (op1));
+	    fprintf (output, "     val_expression r%" PRIu64 " (%s)\n",
+		     op1, regname (op1));
 	    if ((uint64_t) (endp - readp) < op2)
 	      goto invalid;
 	    print_ops (dwflmod, dbg, 10, 10, version, ptr_size, 0,
@@ -4990,37 +5236,39 @@ print_cfa_program (const unsigned char *readp, const unsigned char *const endp,
 	    if ((uint64_t) (endp - readp) < 8)
 	      goto invalid;
 	    op1 = read_8ubyte_unaligned_inc (dbg, readp);
-	    printf ("     MIPS_advance_loc8 %" PRIu64 " to %#" PRIx64 "\n",
-		    op1, pc += op1 * code_align);
+	    fprintf (output, "     MIPS_advance_loc8 %" PRIu64 " to %#"
+		     PRIx64 "\n",
+		     op1, pc += op1 * code_align);
 	    break;
 	  case DW_CFA_GNU_window_save:
-	    puts ("     GNU_window_save");
+	    fprintf (output, "%s\n", "     GNU_window_save");
 	    break;
 	  case DW_CFA_GNU_args_size:
 	    if ((uint64_t) (endp - readp) < 1)
 	      goto invalid;
 	    get_uleb128 (op1, readp, endp);
-	    printf ("     args_size %" PRIu64 "\n", op1);
+	    fprintf (output, "     args_size %" PRIu64 "\n", op1);
 	    break;
 	  default:
-	    printf ("     ??? (%u)\n", opcode);
+	    fprintf (output, "     ??? (%u)\n", opcode);
 	    break;
 	  }
       else if (opcode < DW_CFA_offset)
-	printf ("     advance_loc %u to %#" PRIx64 "\n",
-		opcode & 0x3f, pc += (opcode & 0x3f) * code_align);
+	fprintf (output, "     advance_loc %u to %#" PRIx64 "\n",
+		 opcode & 0x3f, pc += (opcode & 0x3f) * code_align);
       else if (opcode < DW_CFA_restore)
 	{
 	  uint64_t offset;
 	  if ((uint64_t) (endp - readp) < 1)
 	    goto invalid;
 	  get_uleb128 (offset, readp, endp);
-	  printf ("     offset r%u (%s) at cfa%+" PRId64 "\n",
-		  opcode & 0x3f, regname (opcode & 0x3f), offset * data_align);
+	  fprintf (output, "     offset r%u (%s) at cfa%+" PRId64 "\n",
+		   opcode & 0x3f, regname (opcode & 0x3f),
+		   offset * data_align);
 	}
       else
-	printf ("     restore r%u (%s)\n",
-		opcode & 0x3f, regname (opcode & 0x3f));
+	fprintf (output, "     restore r%u (%s)\n",
+		 opcode & 0x3f, regname (opcode & 0x3f));
     }
 }
 
@@ -5050,31 +5298,31 @@ print_encoding (unsigned int val)
   switch (val & 0xf)
     {
     case DW_EH_PE_absptr:
-      fputs ("absptr", stdout);
+      fputs ("absptr", output);
       break;
     case DW_EH_PE_uleb128:
-      fputs ("uleb128", stdout);
+      fputs ("uleb128", output);
       break;
     case DW_EH_PE_udata2:
-      fputs ("udata2", stdout);
+      fputs ("udata2", output);
       break;
     case DW_EH_PE_udata4:
-      fputs ("udata4", stdout);
+      fputs ("udata4", output);
       break;
     case DW_EH_PE_udata8:
-      fputs ("udata8", stdout);
+      fputs ("udata8", output);
       break;
     case DW_EH_PE_sleb128:
-      fputs ("sleb128", stdout);
+      fputs ("sleb128", output);
       break;
     case DW_EH_PE_sdata2:
-      fputs ("sdata2", stdout);
+      fputs ("sdata2", output);
       break;
     case DW_EH_PE_sdata4:
-      fputs ("sdata4", stdout);
+      fputs ("sdata4", output);
       break;
     case DW_EH_PE_sdata8:
-      fputs ("sdata8", stdout);
+      fputs ("sdata8", output);
       break;
     default:
       
@@ -5091,19 +5339,19 @@ print_relinfo (unsigned int val)
   switch (val & 0x70)
     {
     case DW_EH_PE_pcrel:
-      fputs ("pcrel", stdout);
+      fputs ("pcrel", output);
       break;
     case DW_EH_PE_textrel:
-      fputs ("textrel", stdout);
+      fputs ("textrel", output);
       break;
     case DW_EH_PE_datarel:
-      fputs ("datarel", stdout);
+      fputs ("datarel", output);
       break;
     case DW_EH_PE_funcrel:
-      fputs ("funcrel", stdout);
+      fputs ("funcrel", output);
       break;
     case DW_EH_PE_aligned:
-      fputs ("aligned", stdout);
+      fputs ("aligned", output);
       break;
     default:
       return val;
@@ -5116,10 +5364,10 @@ print_relinfo (unsigned int val)
 static void
 print_encoding_base (const char *pfx, unsigned int fde_encoding)
 {
-  printf ("(%s", pfx);
+  fprintf (output, "(%s", pfx);
 
   if (fde_encoding == DW_EH_PE_omit)
-    puts ("omit)");
+    fprintf (output, "%s\n", "omit)");
   else
     {
       unsigned int w = fde_encoding;
@@ -5129,15 +5377,15 @@ print_encoding_base (const char *pfx, unsigned int fde_encoding)
       if (w & 0x70)
 	{
 	  if (w != fde_encoding)
-	    fputc_unlocked (' ', stdout);
+	    fputc_unlocked (' ', output);
 
 	  w = print_relinfo (w);
 	}
 
       if (w != 0)
-	printf ("%s%x", w != fde_encoding ? " " : "", w);
+	fprintf (output, "%s%x", w != fde_encoding ? " " : "", w);
 
-      puts (")");
+      fprintf (output, "%s\n", ")");
     }
 }
 
@@ -5228,13 +5476,13 @@ print_debug_frame_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
     }
 
   if (is_eh_frame)
-    printf (gettext ("\
+    fprintf (output, gettext ("\
 \nCall frame information section [%2zu] '%s' at offset %#" PRIx64 ":\n"),
-	    elf_ndxscn (scn), scnname, (uint64_t) shdr->sh_offset);
+	     elf_ndxscn (scn), scnname, (uint64_t) shdr->sh_offset);
   else
-    printf (gettext ("\
+    fprintf (output, gettext ("\
 \nDWARF section [%2zu] '%s' at offset %#" PRIx64 ":\n"),
-	    elf_ndxscn (scn), scnname, (uint64_t) shdr->sh_offset);
+	     elf_ndxscn (scn), scnname, (uint64_t) shdr->sh_offset);
 
   struct cieinfo
   {
@@ -5276,7 +5524,7 @@ print_debug_frame_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 
       if (unlikely (unit_length == 0))
 	{
-	  printf (gettext ("\n [%6tx] Zero terminator\n"), offset);
+	  fprintf (output, gettext ("\n [%6tx] Zero terminator\n"), offset);
 	  continue;
 	}
 
@@ -5346,21 +5594,21 @@ print_debug_frame_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 	  else
 	    get_uleb128 (return_address_register, readp, cieend);
 
-	  printf ("\n [%6tx] CIE length=%" PRIu64 "\n"
-		  "   CIE_id:                   %" PRIu64 "\n"
-		  "   version:                  %u\n"
-		  "   augmentation:             \"%s\"\n",
-		  offset, (uint64_t) unit_length, (uint64_t) cie_id,
-		  version, augmentation);
+	  fprintf (output, "\n [%6tx] CIE length=%" PRIu64 "\n"
+		   "   CIE_id:                   %" PRIu64 "\n"
+		   "   version:                  %u\n"
+		   "   augmentation:             \"%s\"\n",
+		   offset, (uint64_t) unit_length, (uint64_t) cie_id,
+		   version, augmentation);
 	  if (version >= 4)
-	    printf ("   address_size:             %u\n"
-		    "   segment_size:             %u\n",
-		    ptr_size, segment_size);
-	  printf ("   code_alignment_factor:    %u\n"
-		  "   data_alignment_factor:    %d\n"
-		  "   return_address_register:  %u\n",
-		  code_alignment_factor,
-		  data_alignment_factor, return_address_register);
+	    fprintf (output, "   address_size:             %u\n"
+		     "   segment_size:             %u\n",
+		     ptr_size, segment_size);
+	  fprintf (output, "   code_alignment_factor:    %u\n"
+		   "   data_alignment_factor:    %d\n"
+		   "   return_address_register:  %u\n",
+		   code_alignment_factor,
+		   data_alignment_factor, return_address_register);
 
 	  if (augmentation[0] == 'z')
 	    {
@@ -5378,7 +5626,7 @@ print_debug_frame_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 	      const char *cp = augmentation + 1;
 	      while (*cp != '\0' && cp < augmentation + augmentationlen + 1)
 		{
-		  printf ("   %-26s%#x ", hdr, *readp);
+		  fprintf (output, "   %-26s%#x ", hdr, *readp);
 		  hdr = "";
 
 		  if (*cp == 'R')
@@ -5403,25 +5651,25 @@ print_debug_frame_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 					    &val, dbg);
 
 		      while (++startp < readp)
-			printf ("%#x ", *startp);
+			fprintf (output, "%#x ", *startp);
 
-		      putchar ('(');
+		      putc ('(', output);
 		      print_encoding (encoding);
-		      putchar (' ');
+		      putc (' ', output);
 		      switch (encoding & 0xf)
 			{
 			case DW_EH_PE_sleb128:
 			case DW_EH_PE_sdata2:
 			case DW_EH_PE_sdata4:
-			  printf ("%" PRId64 ")\n", val);
+			  fprintf (output, "%" PRId64 ")\n", val);
 			  break;
 			default:
-			  printf ("%#" PRIx64 ")\n", val);
+			  fprintf (output, "%#" PRIx64 ")\n", val);
 			  break;
 			}
 		    }
 		  else
-		    printf ("(%x)\n", *readp++);
+		    fprintf (output, "(%x)\n", *readp++);
 
 		  ++cp;
 		}
@@ -5453,7 +5701,7 @@ print_debug_frame_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 	      cie = cie->next;
 	  if (unlikely (cie == NULL))
 	    {
-	      puts ("invalid CIE reference in FDE");
+	      fprintf (output, "%s\n", "invalid CIE reference in FDE");
 	      return;
 	    }
 
@@ -5480,11 +5728,11 @@ print_debug_frame_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 
 	  char *a = format_dwarf_addr (dwflmod, cie->address_size,
 				       pc_start, initial_location);
-	  printf ("\n [%6tx] FDE length=%" PRIu64 " cie=[%6tx]\n"
-		  "   CIE_pointer:              %" PRIu64 "\n"
-		  "   initial_location:         %s",
-		  offset, (uint64_t) unit_length,
-		  cie->cie_offset, (uint64_t) cie_id, a);
+	  fprintf (output, "\n [%6tx] FDE length=%" PRIu64 " cie=[%6tx]\n"
+		   "   CIE_pointer:              %" PRIu64 "\n"
+		   "   initial_location:         %s",
+		   offset, (uint64_t) unit_length,
+		   cie->cie_offset, (uint64_t) cie_id, a);
 	  free (a);
 	  if ((fde_encoding & 0x70) == DW_EH_PE_pcrel)
 	    {
@@ -5494,19 +5742,19 @@ print_debug_frame_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 			  & (ptr_size == 4
 			     ? UINT64_C (0xffffffff)
 			     : UINT64_C (0xffffffffffffffff)));
-	      printf (gettext (" (offset: %#" PRIx64 ")"),
-		      (uint64_t) vma_base);
+	      fprintf (output, gettext (" (offset: %#" PRIx64 ")"),
+		       (uint64_t) vma_base);
 	    }
 
-	  printf ("\n   address_range:            %#" PRIx64,
-		  (uint64_t) address_range);
+	  fprintf (output, "\n   address_range:            %#" PRIx64,
+		   (uint64_t) address_range);
 	  if ((fde_encoding & 0x70) == DW_EH_PE_pcrel)
-	    printf (gettext (" (end offset: %#" PRIx64 ")"),
-		    ((uint64_t) vma_base + (uint64_t) address_range)
-		    & (ptr_size == 4
-		       ? UINT64_C (0xffffffff)
-		       : UINT64_C (0xffffffffffffffff)));
-	  putchar ('\n');
+	    fprintf (output, gettext (" (end offset: %#" PRIx64 ")"),
+		     ((uint64_t) vma_base + (uint64_t) address_range)
+		     & (ptr_size == 4
+			? UINT64_C (0xffffffff)
+			: UINT64_C (0xffffffffffffffff)));
+	  putc ('\n', output);
 
 	  if (cie->augmentation[0] == 'z')
 	    {
@@ -5538,9 +5786,9 @@ print_debug_frame_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 					    &readp[augmentationlen],
 					    &lsda_pointer, dbg);
 			  u = p - readp;
-			  printf (gettext ("\
+			  fprintf (output, gettext ("\
    %-26sLSDA pointer: %#" PRIx64 "\n"),
-				  hdr, lsda_pointer);
+				   hdr, lsda_pointer);
 			  hdr = "";
 			}
 		      ++cp;
@@ -5548,7 +5796,7 @@ print_debug_frame_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 
 		  while (u < augmentationlen)
 		    {
-		      printf ("   %-26s%#x\n", hdr, readp[u++]);
+		      fprintf (output, "   %-26s%#x\n", hdr, readp[u++]);
 		      hdr = "";
 		    }
 		}
@@ -5559,7 +5807,8 @@ print_debug_frame_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 
       
       if (ptr_size != 4 && ptr_size !=8)
-	printf ("invalid CIE pointer size (%u), must be 4 or 8.\n", ptr_size);
+	fprintf (output, "invalid CIE pointer size (%u), must be 4 or 8.\n",
+		 ptr_size);
       else
 	print_cfa_program (readp, cieend, vma_base, code_alignment_factor,
 			   data_alignment_factor, version, ptr_size,
@@ -5623,9 +5872,9 @@ attr_callback (Dwarf_Attribute *attrp, void *arg)
 	    }
 	  char *a = format_dwarf_addr (cbargs->dwflmod, cbargs->addrsize,
 				       addr, addr);
-	  printf ("           %*s%-20s (%s) %s\n",
-		  (int) (level * 2), "", dwarf_attr_name (attr),
-		  dwarf_form_name (form), a);
+	  fprintf (output, "           %*s%-20s (%s) %s\n",
+		   (int) (level * 2), "", dwarf_attr_name (attr),
+		   dwarf_form_name (form), a);
 	  free (a);
 	}
       break;
@@ -5639,9 +5888,9 @@ attr_callback (Dwarf_Attribute *attrp, void *arg)
       const char *str = dwarf_formstring (attrp);
       if (unlikely (str == NULL))
 	goto attrval_out;
-      printf ("           %*s%-20s (%s) \"%s\"\n",
-	      (int) (level * 2), "", dwarf_attr_name (attr),
-	      dwarf_form_name (form), str);
+      fprintf (output, "           %*s%-20s (%s) \"%s\"\n",
+	       (int) (level * 2), "", dwarf_attr_name (attr),
+	       dwarf_form_name (form), str);
       break;
 
     case DW_FORM_ref_addr:
@@ -5657,18 +5906,18 @@ attr_callback (Dwarf_Attribute *attrp, void *arg)
       if (unlikely (dwarf_formref_die (attrp, &ref) == NULL))
 	goto attrval_out;
 
-      printf ("           %*s%-20s (%s) [%6" PRIxMAX "]\n",
-	      (int) (level * 2), "", dwarf_attr_name (attr),
-	      dwarf_form_name (form), (uintmax_t) dwarf_dieoffset (&ref));
+      fprintf (output, "           %*s%-20s (%s) [%6" PRIxMAX "]\n",
+	       (int) (level * 2), "", dwarf_attr_name (attr),
+	       dwarf_form_name (form), (uintmax_t) dwarf_dieoffset (&ref));
       break;
 
     case DW_FORM_ref_sig8:
       if (cbargs->silent)
 	break;
-      printf ("           %*s%-20s (%s) {%6" PRIx64 "}\n",
-	      (int) (level * 2), "", dwarf_attr_name (attr),
-	      dwarf_form_name (form),
-	      (uint64_t) read_8ubyte_unaligned (attrp->cu->dbg, attrp->valp));
+      fprintf (output, "           %*s%-20s (%s) {%6" PRIx64 "}\n",
+	       (int) (level * 2), "", dwarf_attr_name (attr),
+	       dwarf_form_name (form),
+	       (uint64_t) read_8ubyte_unaligned (attrp->cu->dbg, attrp->valp));
       break;
 
     case DW_FORM_sec_offset:
@@ -5692,9 +5941,9 @@ attr_callback (Dwarf_Attribute *attrp, void *arg)
 		  || (form != DW_FORM_data4 && form != DW_FORM_data8)))
 	    {
 	      if (!cbargs->silent)
-		printf ("           %*s%-20s (%s) %" PRIxMAX "\n",
-			(int) (level * 2), "", dwarf_attr_name (attr),
-			dwarf_form_name (form), (uintmax_t) num);
+		fprintf (output, "           %*s%-20s (%s) %" PRIxMAX "\n",
+			 (int) (level * 2), "", dwarf_attr_name (attr),
+			 dwarf_form_name (form), (uintmax_t) num);
 	      return DWARF_CB_OK;
 	    }
 	  
@@ -5717,10 +5966,11 @@ attr_callback (Dwarf_Attribute *attrp, void *arg)
 					cbargs->addrsize, cbargs->offset_size,
 					cbargs->cu, num);
 	    if (!cbargs->silent)
-	      printf ("           %*s%-20s (%s) location list [%6" PRIxMAX "]%s\n",
-		      (int) (level * 2), "", dwarf_attr_name (attr),
-		      dwarf_form_name (form), (uintmax_t) num,
-		      nlpt ? "" : " <WARNING offset too big>");
+	      fprintf (output, "           %*s%-20s (%s) location list [%6"
+		       PRIxMAX "]%s\n",
+		       (int) (level * 2), "", dwarf_attr_name (attr),
+		       dwarf_form_name (form), (uintmax_t) num,
+		       nlpt ? "" : " <WARNING offset too big>");
 	  }
 	  return DWARF_CB_OK;
 
@@ -5730,10 +5980,11 @@ attr_callback (Dwarf_Attribute *attrp, void *arg)
 					cbargs->addrsize, cbargs->offset_size,
 					cbargs->cu, num);
 	    if (!cbargs->silent)
-	      printf ("           %*s%-20s (%s) range list [%6" PRIxMAX "]%s\n",
-		      (int) (level * 2), "", dwarf_attr_name (attr),
-		      dwarf_form_name (form), (uintmax_t) num,
-		      nlpt ? "" : " <WARNING offset too big>");
+	      fprintf (output, "           %*s%-20s (%s) range list [%6"
+		       PRIxMAX "]%s\n",
+		       (int) (level * 2), "", dwarf_attr_name (attr),
+		       dwarf_form_name (form), (uintmax_t) num,
+		       nlpt ? "" : " <WARNING offset too big>");
 	  }
 	  return DWARF_CB_OK;
 
@@ -5780,9 +6031,9 @@ attr_callback (Dwarf_Attribute *attrp, void *arg)
 	{
 	  char *a = format_dwarf_addr (cbargs->dwflmod, cbargs->addrsize,
 				       highpc, highpc);
-	  printf ("           %*s%-20s (%s) %" PRIuMAX " (%s)\n",
-		  (int) (level * 2), "", dwarf_attr_name (attr),
-		  dwarf_form_name (form), (uintmax_t) num, a);
+	  fprintf (output, "           %*s%-20s (%s) %" PRIuMAX " (%s)\n",
+		   (int) (level * 2), "", dwarf_attr_name (attr),
+		   dwarf_form_name (form), (uintmax_t) num, a);
 	  free (a);
 	}
       else
@@ -5794,23 +6045,23 @@ attr_callback (Dwarf_Attribute *attrp, void *arg)
 
 	  if (valuestr == NULL)
 	    {
-	      printf ("           %*s%-20s (%s)",
-		      (int) (level * 2), "", dwarf_attr_name (attr),
-		      dwarf_form_name (form));
+	      fprintf (output, "           %*s%-20s (%s)",
+		       (int) (level * 2), "", dwarf_attr_name (attr),
+		       dwarf_form_name (form));
 	      if (form == DW_FORM_sdata)
-		printf (" %" PRIdMAX "\n", (intmax_t) snum);
+		fprintf (output, " %" PRIdMAX "\n", (intmax_t) snum);
 	      else
-		printf (" %" PRIuMAX "\n", (uintmax_t) num);
+		fprintf (output, " %" PRIuMAX "\n", (uintmax_t) num);
 	    }
 	  else
 	    {
-	      printf ("           %*s%-20s (%s) %s",
-		      (int) (level * 2), "", dwarf_attr_name (attr),
-		      dwarf_form_name (form), valuestr);
+	      fprintf (output, "           %*s%-20s (%s) %s",
+		       (int) (level * 2), "", dwarf_attr_name (attr),
+		       dwarf_form_name (form), valuestr);
 	      if (form == DW_FORM_sdata)
-		printf (" (%" PRIdMAX ")\n", (intmax_t) snum);
+		fprintf (output, " (%" PRIdMAX ")\n", (intmax_t) snum);
 	      else
-		printf (" (%" PRIuMAX ")\n", (uintmax_t) num);
+		fprintf (output, " (%" PRIuMAX ")\n", (uintmax_t) num);
 	    }
 	}
       break;
@@ -5822,17 +6073,17 @@ attr_callback (Dwarf_Attribute *attrp, void *arg)
       if (unlikely (dwarf_formflag (attrp, &flag) != 0))
 	goto attrval_out;
 
-      printf ("           %*s%-20s (%s) %s\n",
-	      (int) (level * 2), "", dwarf_attr_name (attr),
-	      dwarf_form_name (form), nl_langinfo (flag ? YESSTR : NOSTR));
+      fprintf (output, "           %*s%-20s (%s) %s\n",
+	       (int) (level * 2), "", dwarf_attr_name (attr),
+	       dwarf_form_name (form), nl_langinfo (flag ? YESSTR : NOSTR));
       break;
 
     case DW_FORM_flag_present:
       if (cbargs->silent)
 	break;
-      printf ("           %*s%-20s (%s) %s\n",
-	      (int) (level * 2), "", dwarf_attr_name (attr),
-	      dwarf_form_name (form), nl_langinfo (YESSTR));
+      fprintf (output, "           %*s%-20s (%s) %s\n",
+	       (int) (level * 2), "", dwarf_attr_name (attr),
+	       dwarf_form_name (form), nl_langinfo (YESSTR));
       break;
 
     case DW_FORM_exprloc:
@@ -5846,9 +6097,9 @@ attr_callback (Dwarf_Attribute *attrp, void *arg)
       if (unlikely (dwarf_formblock (attrp, &block) != 0))
 	goto attrval_out;
 
-      printf ("           %*s%-20s (%s) ",
-	      (int) (level * 2), "", dwarf_attr_name (attr),
-	      dwarf_form_name (form));
+      fprintf (output, "           %*s%-20s (%s) ",
+	       (int) (level * 2), "", dwarf_attr_name (attr),
+	       dwarf_form_name (form));
 
       switch (attr)
 	{
@@ -5883,7 +6134,7 @@ attr_callback (Dwarf_Attribute *attrp, void *arg)
 	case DW_AT_GNU_call_site_data_value:
 	case DW_AT_GNU_call_site_target:
 	case DW_AT_GNU_call_site_target_clobbered:
-	  putchar ('\n');
+	  putc ('\n', output);
 	  print_ops (cbargs->dwflmod, cbargs->dbg,
 		     12 + level * 2, 12 + level * 2,
 		     cbargs->version, cbargs->addrsize, cbargs->offset_size,
@@ -5895,71 +6146,55 @@ attr_callback (Dwarf_Attribute *attrp, void *arg)
     default:
       if (cbargs->silent)
 	break;
-      printf ("           %*s%-20s (form: %#x) ???\n",
-	      (int) (level * 2), "", dwarf_attr_name (attr),
-	      (int) form);
+      fprintf (output, "           %*s%-20s (form: %#x) ???\n",
+	       (int) (level * 2), "", dwarf_attr_name (attr),
+	       (int) form);
       break;
     }
 
   return DWARF_CB_OK;
 }
 
-static void
-print_debug_units (Dwfl_Module *dwflmod,
-		   Ebl *ebl, GElf_Ehdr *ehdr,
-		   Elf_Scn *scn, GElf_Shdr *shdr,
-		   Dwarf *dbg, bool debug_types)
+static bool
+print_debug_unit (Dwfl_Module *dwflmod, Dwarf *dbg, const char *secname,
+		  bool silent, bool debug_types, Dwarf_Off offset,
+		  Dwarf_Off *nextcup)
 {
-  const bool silent = !(print_debug_sections & section_info);
-  const char *secname = section_name (ebl, ehdr, shdr);
-
-  if (!silent)
-    printf (gettext ("\
-\nDWARF section [%2zu] '%s' at offset %#" PRIx64 ":\n [Offset]\n"),
-	    elf_ndxscn (scn), secname, (uint64_t) shdr->sh_offset);
-
-  
-  if (!silent && shdr->sh_size == 0)
-    return;
-
-  int maxdies = 20;
-  Dwarf_Die *dies = (Dwarf_Die *) xmalloc (maxdies * sizeof (Dwarf_Die));
-
-  Dwarf_Off offset = 0;
-
   
   size_t cuhl;
   Dwarf_Half version;
   Dwarf_Off abbroffset;
   uint8_t addrsize;
   uint8_t offsize;
-  Dwarf_Off nextcu;
   uint64_t typesig;
   Dwarf_Off typeoff;
- next_cu:
-  if (dwarf_next_unit (dbg, offset, &nextcu, &cuhl, &version,
+  if (dwarf_next_unit (dbg, offset, nextcup, &cuhl, &version,
 		       &abbroffset, &addrsize, &offsize,
 		       debug_types ? &typesig : NULL,
 		       debug_types ? &typeoff : NULL) != 0)
-    goto do_return;
+    return false;
 
   if (!silent)
     {
       if (debug_types)
-	printf (gettext (" Type unit at offset %" PRIu64 ":\n"
-			 " Version: %" PRIu16 ", Abbreviation section offset: %"
-			 PRIu64 ", Address size: %" PRIu8
-			 ", Offset size: %" PRIu8
-			 "\n Type signature: %#" PRIx64
-			 ", Type offset: %#" PRIx64 "\n"),
-		(uint64_t) offset, version, abbroffset, addrsize, offsize,
-		typesig, (uint64_t) typeoff);
+	fprintf (output,
+		 gettext (" Type unit at offset %" PRIu64 ":\n"
+			  " Version: %" PRIu16
+			  ", Abbreviation section offset: %" PRIu64
+			  ", Address size: %" PRIu8
+			  ", Offset size: %" PRIu8
+			  "\n Type signature: %#" PRIx64
+			  ", Type offset: %#" PRIx64 "\n"),
+		 (uint64_t) offset, version, abbroffset, addrsize, offsize,
+		 typesig, (uint64_t) typeoff);
       else
-	printf (gettext (" Compilation unit at offset %" PRIu64 ":\n"
-			 " Version: %" PRIu16 ", Abbreviation section offset: %"
-			 PRIu64 ", Address size: %" PRIu8
-			 ", Offset size: %" PRIu8 "\n"),
-		(uint64_t) offset, version, abbroffset, addrsize, offsize);
+	fprintf (output,
+		 gettext (" Compilation unit at offset %" PRIu64 ":\n"
+			  " Version: %" PRIu16
+			  ", Abbreviation section offset: %" PRIu64
+			  ", Address size: %" PRIu8
+			  ", Offset size: %" PRIu8 "\n"),
+		 (uint64_t) offset, version, abbroffset, addrsize, offsize);
     }
 
   struct attrcb_args args =
@@ -5974,6 +6209,10 @@ print_debug_units (Dwfl_Module *dwflmod,
 
   offset += cuhl;
 
+  int maxdies = 20;
+  Dwarf_Die *dies = (Dwarf_Die *) xmalloc (maxdies * sizeof (Dwarf_Die));
+  bool ok = false;
+
   int level = 0;
 
   if (unlikely ((debug_types ? dwarf_offdie_types : dwarf_offdie)
@@ -6010,9 +6249,9 @@ print_debug_units (Dwfl_Module *dwflmod,
 	}
 
       if (!silent)
-	printf (" [%6" PRIx64 "]  %*s%s\n",
-		(uint64_t) offset, (int) (level * 2), "",
-		dwarf_tag_name (tag));
+	fprintf (output, " [%6" PRIx64 "]  %*s%s\n",
+		 (uint64_t) offset, (int) (level * 2), "",
+		 dwarf_tag_name (tag));
 
       
       args.level = level;
@@ -6052,12 +6291,44 @@ print_debug_units (Dwfl_Module *dwflmod,
     }
   while (level >= 0);
 
-  offset = nextcu;
-  if (offset != 0)
-     goto next_cu;
+  ok = true;
 
  do_return:
   free (dies);
+  return ok;
+}
+
+static void
+print_debug_units_header (Ebl *ebl, GElf_Ehdr *ehdr, Elf_Scn *scn,
+			  GElf_Shdr *shdr)
+{
+  if (print_debug_sections & section_info)
+    fprintf (output, gettext ("\
+\nDWARF section [%2zu] '%s' at offset %#" PRIx64 ":\n [Offset]\n"),
+	     elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
+	     (uint64_t) shdr->sh_offset);
+}
+
+static void
+print_debug_units (Dwfl_Module *dwflmod,
+		   Ebl *ebl, GElf_Ehdr *ehdr,
+		   Elf_Scn *scn, GElf_Shdr *shdr,
+		   Dwarf *dbg, bool debug_types)
+{
+  const bool silent = !(print_debug_sections & section_info);
+  const char *secname = section_name (ebl, ehdr, shdr);
+
+  print_debug_units_header (ebl, ehdr, scn, shdr);
+
+  
+  if (!silent && shdr->sh_size == 0)
+    return;
+
+  Dwarf_Off offset = 0;
+  while (print_debug_unit (dwflmod, dbg, secname, silent, debug_types,
+			   offset, &offset)
+	 && offset != 0)
+    continue;
 }
 
 static void
@@ -6079,10 +6350,10 @@ static void
 print_decoded_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 			    Elf_Scn *scn, GElf_Shdr *shdr, Dwarf *dbg)
 {
-  printf (gettext ("\
+  fprintf (output, gettext ("\
 \nDWARF section [%2zu] '%s' at offset %#" PRIx64 ":\n\n"),
-	  elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
-	  (uint64_t) shdr->sh_offset);
+	   elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
+	   (uint64_t) shdr->sh_offset);
 
   size_t address_size
     = elf_getident (ebl->elf, NULL)[EI_CLASS] == ELFCLASS32 ? 4 : 8;
@@ -6102,30 +6373,32 @@ print_decoded_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
       if (dwarf_getsrclines (&cudie, &lines, &nlines) != 0)
 	continue;
 
-      printf (" CU [%" PRIx64 "] %s\n",
-	      dwarf_dieoffset (&cudie), dwarf_diename (&cudie));
-      printf ("  line:col SBPE* disc isa op address"
-	      " (Statement Block Prologue Epilogue *End)\n");
+      fprintf (output, " CU [%" PRIx64 "] %s\n",
+	       dwarf_dieoffset (&cudie), dwarf_diename (&cudie));
+      fprintf (output, "  line:col SBPE* disc isa op address"
+	       " (Statement Block Prologue Epilogue *End)\n");
       const char *last_file = "";
       for (size_t n = 0; n < nlines; n++)
 	{
 	  Dwarf_Line *line = dwarf_onesrcline (lines, n);
 	  if (line == NULL)
 	    {
-	      printf ("  dwarf_onesrcline: %s\n", dwarf_errmsg (-1));
+	      fprintf (output, "  dwarf_onesrcline: %s\n", dwarf_errmsg (-1));
 	      continue;
 	    }
 	  Dwarf_Word mtime, length;
 	  const char *file = dwarf_linesrc (line, &mtime, &length);
 	  if (file == NULL)
 	    {
-	      printf ("  <%s> (mtime: ?, length: ?)\n", dwarf_errmsg (-1));
+	      fprintf (output, "  <%s> (mtime: ?, length: ?)\n",
+		       dwarf_errmsg (-1));
 	      last_file = "";
 	    }
 	  else if (strcmp (last_file, file) != 0)
 	    {
-	      printf ("  %s (mtime: %" PRIu64 ", length: %" PRIu64 ")\n",
-		      file, mtime, length);
+	      fprintf (output, "  %s (mtime: %" PRIu64 ", length: %"
+		       PRIu64 ")\n",
+		       file, mtime, length);
 	      last_file = file;
 	    }
 
@@ -6148,14 +6421,14 @@ print_decoded_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 	  
 	  char *a = format_dwarf_addr (dwflmod, address_size,
 				       address - (endseq ? 1 : 0), address);
-	  printf ("  %4d:%-3d %c%c%c%c%c %4d %3d %2d %s\n",
-		  lineno, colno,
-		  (statement ? 'S' : ' '),
-		  (block ? 'B' : ' '),
-		  (prologue_end ? 'P' : ' '),
-		  (epilogue_begin ? 'E' : ' '),
-		  (endseq ? '*' : ' '),
-		  disc, isa, lineop, a);
+	  fprintf (output, "  %4d:%-3d %c%c%c%c%c %4d %3d %2d %s\n",
+		   lineno, colno,
+		   (statement ? 'S' : ' '),
+		   (block ? 'B' : ' '),
+		   (prologue_end ? 'P' : ' '),
+		   (epilogue_begin ? 'E' : ' '),
+		   (endseq ? '*' : ' '),
+		   disc, isa, lineop, a);
 	  free (a);
 
 	  if (endseq)
@@ -6175,10 +6448,10 @@ print_debug_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
       return;
     }
 
-  printf (gettext ("\
+  fprintf (output, gettext ("\
 \nDWARF section [%2zu] '%s' at offset %#" PRIx64 ":\n"),
-	  elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
-	  (uint64_t) shdr->sh_offset);
+	   elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
+	   (uint64_t) shdr->sh_offset);
 
   if (shdr->sh_size == 0)
     return;
@@ -6199,7 +6472,7 @@ print_debug_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
     {
       size_t start_offset = linep - (const unsigned char *) data->d_buf;
 
-      printf (gettext ("\nTable at offset %Zu:\n"), start_offset);
+      fprintf (output, gettext ("\nTable at offset %Zu:\n"), start_offset);
 
       if (unlikely (linep + 4 > lineendp))
 	goto invalid_data;
@@ -6254,22 +6527,23 @@ print_debug_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
       uint_fast8_t opcode_base = *linep++;
 
       
-      printf (gettext ("\n"
-		       " Length:                     %" PRIu64 "\n"
-		       " DWARF version:              %" PRIuFAST16 "\n"
-		       " Prologue length:            %" PRIu64 "\n"
-		       " Minimum instruction length: %" PRIuFAST8 "\n"
-		       " Maximum operations per instruction: %" PRIuFAST8 "\n"
-		       " Initial value if '%s': %" PRIuFAST8 "\n"
-		       " Line base:                  %" PRIdFAST8 "\n"
-		       " Line range:                 %" PRIuFAST8 "\n"
-		       " Opcode base:                %" PRIuFAST8 "\n"
-		       "\n"
-		       "Opcodes:\n"),
-	      (uint64_t) unit_length, version, (uint64_t) header_length,
-	      minimum_instr_len, max_ops_per_instr,
-	      "is_stmt", default_is_stmt, line_base,
-	      line_range, opcode_base);
+      fprintf (output,
+	       gettext ("\n"
+			" Length:                     %" PRIu64 "\n"
+			" DWARF version:              %" PRIuFAST16 "\n"
+			" Prologue length:            %" PRIu64 "\n"
+			" Minimum instruction length: %" PRIuFAST8 "\n"
+			" Maximum operations per instruction: %" PRIuFAST8 "\n"
+			" Initial value if '%s': %" PRIuFAST8 "\n"
+			" Line base:                  %" PRIdFAST8 "\n"
+			" Line range:                 %" PRIuFAST8 "\n"
+			" Opcode base:                %" PRIuFAST8 "\n"
+			"\n"
+			"Opcodes:\n"),
+	       (uint64_t) unit_length, version, (uint64_t) header_length,
+	       minimum_instr_len, max_ops_per_instr,
+	       "is_stmt", default_is_stmt, line_base,
+	       line_range, opcode_base);
 
       if (unlikely (linep + opcode_base - 1 >= lineendp))
 	{
@@ -6290,22 +6564,22 @@ print_debug_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 	}
       const uint8_t *standard_opcode_lengths = linep - 1;
       for (uint_fast8_t cnt = 1; cnt < opcode_base; ++cnt)
-	printf (ngettext ("  [%*" PRIuFAST8 "]  %hhu argument\n",
-			  "  [%*" PRIuFAST8 "]  %hhu arguments\n",
-			  (int) linep[cnt - 1]),
-		opcode_base_l10, cnt, linep[cnt - 1]);
+	fprintf (output, ngettext ("  [%*" PRIuFAST8 "]  %hhu argument\n",
+				   "  [%*" PRIuFAST8 "]  %hhu arguments\n",
+				   (int) linep[cnt - 1]),
+		 opcode_base_l10, cnt, linep[cnt - 1]);
       linep += opcode_base - 1;
       if (unlikely (linep >= lineendp))
 	goto invalid_unit;
 
-      puts (gettext ("\nDirectory table:"));
+      fprintf (output, "%s\n", gettext ("\nDirectory table:"));
       while (*linep != 0)
 	{
 	  unsigned char *endp = memchr (linep, '\0', lineendp - linep);
 	  if (unlikely (endp == NULL))
 	    goto invalid_unit;
 
-	  printf (" %s\n", (char *) linep);
+	  fprintf (output, " %s\n", (char *) linep);
 
 	  linep = endp + 1;
 	}
@@ -6314,8 +6588,9 @@ print_debug_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 
       if (unlikely (linep >= lineendp))
 	goto invalid_unit;
-      puts (gettext ("\nFile name table:\n"
-		     " Entry Dir   Time      Size      Name"));
+      fprintf (output, "%s\n",
+	       gettext ("\nFile name table:\n"
+			" Entry Dir   Time      Size      Name"));
       for (unsigned int cnt = 1; *linep != 0; ++cnt)
 	{
 	  
@@ -6343,13 +6618,13 @@ print_debug_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 	    goto invalid_unit;
 	  get_uleb128 (fsize, linep, lineendp);
 
-	  printf (" %-5u %-5u %-9u %-9u %s\n",
-		  cnt, diridx, mtime, fsize, fname);
+	  fprintf (output, " %-5u %-5u %-9u %-9u %s\n",
+		   cnt, diridx, mtime, fsize, fname);
 	}
       
       ++linep;
 
-      puts (gettext ("\nLine number statements:"));
+      fprintf (output, "%s\n", gettext ("\nLine number statements:"));
       Dwarf_Word address = 0;
       unsigned int op_index = 0;
       size_t line = 1;
@@ -6412,7 +6687,7 @@ print_debug_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 	  
 	  unsigned int opcode = *linep++;
 
-	  printf (" [%6" PRIx64 "]", (uint64_t)offset);
+	  fprintf (output, " [%6" PRIx64 "]", (uint64_t)offset);
 	  
 	  if (likely (opcode >= opcode_base))
 	    {
@@ -6428,14 +6703,14 @@ print_debug_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 
 	      char *a = format_dwarf_addr (dwflmod, 0, address, address);
 	      if (show_op_index)
-		printf (gettext ("\
+		fprintf (output, gettext ("\
  special opcode %u: address+%u = %s, op_index = %u, line%+d = %zu\n"),
-			opcode, op_addr_advance, a, op_index,
-			line_increment, line);
+			 opcode, op_addr_advance, a, op_index,
+			 line_increment, line);
 	      else
-		printf (gettext ("\
+		fprintf (output, gettext ("\
  special opcode %u: address+%u = %s, line%+d = %zu\n"),
-			opcode, op_addr_advance, a, line_increment, line);
+			 opcode, op_addr_advance, a, line_increment, line);
 	      free (a);
 	    }
 	  else if (opcode == 0)
@@ -6453,12 +6728,12 @@ print_debug_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 	      
 	      opcode = *linep++;
 
-	      printf (gettext (" extended opcode %u: "), opcode);
+	      fprintf (output, gettext (" extended opcode %u: "), opcode);
 
 	      switch (opcode)
 		{
 		case DW_LNE_end_sequence:
-		  puts (gettext (" end of sequence"));
+		  fprintf (output, "%s\n", gettext (" end of sequence"));
 
 		  
 		  address = 0;
@@ -6477,7 +6752,7 @@ print_debug_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 		    address = read_8ubyte_unaligned_inc (dbg, linep);
 		  {
 		    char *a = format_dwarf_addr (dwflmod, 0, address, address);
-		    printf (gettext (" set address to %s\n"), a);
+		    fprintf (output, gettext (" set address to %s\n"), a);
 		    free (a);
 		  }
 		  break;
@@ -6504,10 +6779,10 @@ print_debug_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 		      goto invalid_unit;
 		    get_uleb128 (filelength, linep, lineendp);
 
-		    printf (gettext ("\
+		    fprintf (output, gettext ("\
  define new file: dir=%u, mtime=%" PRIu64 ", length=%" PRIu64 ", name=%s\n"),
-			    diridx, (uint64_t) mtime, (uint64_t) filelength,
-			    fname);
+			     diridx, (uint64_t) mtime, (uint64_t) filelength,
+			     fname);
 		  }
 		  break;
 
@@ -6517,12 +6792,13 @@ print_debug_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 		    goto invalid_unit;
 
 		  get_uleb128 (u128, linep, lineendp);
-		  printf (gettext (" set discriminator to %u\n"), u128);
+		  fprintf (output, gettext (" set discriminator to %u\n"),
+			   u128);
 		  break;
 
 		default:
 		  
-		  puts (gettext (" unknown opcode"));
+		  fprintf (output, "%s\n", gettext (" unknown opcode"));
 		  linep += len - 1;
 		  break;
 		}
@@ -6534,7 +6810,7 @@ print_debug_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 		{
 		case DW_LNS_copy:
 		  
-		  puts (gettext (" copy"));
+		  fprintf (output, "%s\n", gettext (" copy"));
 		  break;
 
 		case DW_LNS_advance_pc:
@@ -6543,12 +6819,13 @@ print_debug_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 		  {
 		    char *a = format_dwarf_addr (dwflmod, 0, address, address);
 		    if (show_op_index)
-		      printf (gettext ("\
+		      fprintf (output, gettext ("\
  advance address by %u to %s, op_index to %u\n"),
-			      op_addr_advance, a, op_index);
+			       op_addr_advance, a, op_index);
 		    else
-		      printf (gettext (" advance address by %u to %s\n"),
-			      op_addr_advance, a);
+		      fprintf (output,
+			       gettext (" advance address by %u to %s\n"),
+			       op_addr_advance, a);
 		    free (a);
 		  }
 		  break;
@@ -6556,16 +6833,16 @@ print_debug_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 		case DW_LNS_advance_line:
 		  get_sleb128 (s128, linep, lineendp);
 		  line += s128;
-		  printf (gettext ("\
+		  fprintf (output, gettext ("\
  advance line by constant %d to %" PRId64 "\n"),
-			  s128, (int64_t) line);
+			   s128, (int64_t) line);
 		  break;
 
 		case DW_LNS_set_file:
 		  
 		  get_uleb128 (u128, linep, lineendp);
-		  printf (gettext (" set file to %" PRIu64 "\n"),
-			  (uint64_t) u128);
+		  fprintf (output, gettext (" set file to %" PRIu64 "\n"),
+			   (uint64_t) u128);
 		  break;
 
 		case DW_LNS_set_column:
@@ -6574,20 +6851,20 @@ print_debug_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 		    goto invalid_unit;
 
 		  get_uleb128 (u128, linep, lineendp);
-		  printf (gettext (" set column to %" PRIu64 "\n"),
-			  (uint64_t) u128);
+		  fprintf (output, gettext (" set column to %" PRIu64 "\n"),
+			   (uint64_t) u128);
 		  break;
 
 		case DW_LNS_negate_stmt:
 		  
 		  is_stmt = 1 - is_stmt;
-		  printf (gettext (" set '%s' to %" PRIuFAST8 "\n"),
-			  "is_stmt", is_stmt);
+		  fprintf (output, gettext (" set '%s' to %" PRIuFAST8 "\n"),
+			   "is_stmt", is_stmt);
 		  break;
 
 		case DW_LNS_set_basic_block:
 		  
-		  puts (gettext (" set basic block flag"));
+		  fprintf (output, "%s\n", gettext (" set basic block flag"));
 		  break;
 
 		case DW_LNS_const_add_pc:
@@ -6600,13 +6877,13 @@ print_debug_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 		  {
 		    char *a = format_dwarf_addr (dwflmod, 0, address, address);
 		    if (show_op_index)
-		      printf (gettext ("\
+		      fprintf (output, gettext ("\
  advance address by constant %u to %s, op_index to %u\n"),
-			      op_addr_advance, a, op_index);
+			       op_addr_advance, a, op_index);
 		    else
-		      printf (gettext ("\
+		      fprintf (output, gettext ("\
  advance address by constant %u to %s\n"),
-			      op_addr_advance, a);
+			       op_addr_advance, a);
 		    free (a);
 		  }
 		  break;
@@ -6620,21 +6897,22 @@ print_debug_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 		  op_index = 0;
 		  {
 		    char *a = format_dwarf_addr (dwflmod, 0, address, address);
-		    printf (gettext ("\
+		    fprintf (output, gettext ("\
  advance address by fixed value %u to %s\n"),
-			    u128, a);
+			     u128, a);
 		    free (a);
 		  }
 		  break;
 
 		case DW_LNS_set_prologue_end:
 		  
-		  puts (gettext (" set prologue end flag"));
+		  fprintf (output, "%s\n", gettext (" set prologue end flag"));
 		  break;
 
 		case DW_LNS_set_epilogue_begin:
 		  
-		  puts (gettext (" set epilogue begin flag"));
+		  fprintf (output, "%s\n",
+			   gettext (" set epilogue begin flag"));
 		  break;
 
 		case DW_LNS_set_isa:
@@ -6643,22 +6921,23 @@ print_debug_line_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 		    goto invalid_unit;
 
 		  get_uleb128 (u128, linep, lineendp);
-		  printf (gettext (" set isa to %u\n"), u128);
+		  fprintf (output, gettext (" set isa to %u\n"), u128);
 		  break;
 		}
 	    }
 	  else
 	    {
-	      printf (ngettext (" unknown opcode with %" PRIu8 " parameter:",
-				" unknown opcode with %" PRIu8 " parameters:",
-				standard_opcode_lengths[opcode]),
-		      standard_opcode_lengths[opcode]);
+	      fprintf (output,
+		       ngettext (" unknown opcode with %" PRIu8 " parameter:",
+				 " unknown opcode with %" PRIu8 " parameters:",
+				 standard_opcode_lengths[opcode]),
+		       standard_opcode_lengths[opcode]);
 	      for (int n = standard_opcode_lengths[opcode]; n > 0; --n)
 		{
 		  get_uleb128 (u128, linep, lineendp);
 		  if (n != standard_opcode_lengths[opcode])
-		    putc_unlocked (',', stdout);
-		  printf (" %u", u128);
+		    putc_unlocked (',', output);
+		  fprintf (output, " %u", u128);
 		}
 
 	      
@@ -6686,10 +6965,10 @@ print_debug_loc_section (Dwfl_Module *dwflmod,
       return;
     }
 
-  printf (gettext ("\
+  fprintf (output, gettext ("\
 \nDWARF section [%2zu] '%s' at offset %#" PRIx64 ":\n"),
-	  elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
-	  (uint64_t) shdr->sh_offset);
+	   elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
+	   (uint64_t) shdr->sh_offset);
 
   sort_listptr (&known_loclistptr, "loclistptr");
   size_t listptr_idx = 0;
@@ -6713,7 +6992,7 @@ print_debug_loc_section (Dwfl_Module *dwflmod,
 
       if (unlikely (data->d_size - offset < (size_t) address_size * 2))
 	{
-	  printf (gettext (" [%6tx]  <INVALID DATA>\n"), offset);
+	  fprintf (output, gettext (" [%6tx]  <INVALID DATA>\n"), offset);
 	  break;
 	}
 
@@ -6735,14 +7014,14 @@ print_debug_loc_section (Dwfl_Module *dwflmod,
       if (begin == (Dwarf_Addr) -1l) 
 	{
 	  char *b = format_dwarf_addr (dwflmod, address_size, end, end);
-	  printf (gettext (" [%6tx]  base address %s\n"), offset, b);
+	  fprintf (output, gettext (" [%6tx]  base address %s\n"), offset, b);
 	  free (b);
 	  base = end;
 	}
       else if (begin == 0 && end == 0) 
 	{
 	  if (first)
-	    printf (gettext (" [%6tx]  empty list\n"), offset);
+	    fprintf (output, gettext (" [%6tx]  empty list\n"), offset);
 	  first = true;
 	}
       else
@@ -6756,16 +7035,16 @@ print_debug_loc_section (Dwfl_Module *dwflmod,
 				       end);
 
 	  if (first)		
-	    printf (gettext (" [%6tx]  %s..%s"), offset, b, e);
+	    fprintf (output, gettext (" [%6tx]  %s..%s"), offset, b, e);
 	  else
-	    printf (gettext ("           %s..%s"), b, e);
+	    fprintf (output, gettext ("           %s..%s"), b, e);
 
 	  free (b);
 	  free (e);
 
 	  if (endp - readp <= (ptrdiff_t) len)
 	    {
-	      fputs (gettext ("   <INVALID DATA>\n"), stdout);
+	      fputs (gettext ("   <INVALID DATA>\n"), output);
 	      break;
 	    }
 
@@ -6806,11 +7085,11 @@ print_debug_macinfo_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 			     Ebl *ebl, GElf_Ehdr *ehdr,
 			     Elf_Scn *scn, GElf_Shdr *shdr, Dwarf *dbg)
 {
-  printf (gettext ("\
+  fprintf (output, gettext ("\
 \nDWARF section [%2zu] '%s' at offset %#" PRIx64 ":\n"),
-	  elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
-	  (uint64_t) shdr->sh_offset);
-  putc_unlocked ('\n', stdout);
+	   elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
+	   (uint64_t) shdr->sh_offset);
+  putc_unlocked ('\n', output);
 
   Elf_Data *data = dbg->sectiondata[IDX_debug_macinfo];
   if (unlikely (data == NULL || data->d_buf == NULL))
@@ -6887,20 +7166,21 @@ print_debug_macinfo_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 	  endp = memchr (readp, '\0', readendp - readp);
 	  if (unlikely (endp == NULL))
 	    {
-	      printf (gettext ("\
+	      fprintf (output, gettext ("\
 %*s*** non-terminated string at end of section"),
-		      level, "");
+		       level, "");
 	      return;
 	    }
 
 	  if (opcode == DW_MACINFO_define)
-	    printf ("%*s#define %s, line %u\n",
-		    level, "", (char *) readp, u128);
+	    fprintf (output, "%*s#define %s, line %u\n",
+		     level, "", (char *) readp, u128);
 	  else if (opcode == DW_MACINFO_undef)
-	    printf ("%*s#undef %s, line %u\n",
-		    level, "", (char *) readp, u128);
+	    fprintf (output, "%*s#undef %s, line %u\n",
+		     level, "", (char *) readp, u128);
 	  else
-	    printf (" #vendor-ext %s, number %u\n", (char *) readp, u128);
+	    fprintf (output, " #vendor-ext %s, number %u\n", (char *) readp,
+		     u128);
 
 	  readp = endp + 1;
 	  break;
@@ -6910,9 +7190,9 @@ print_debug_macinfo_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 	  get_uleb128 (u128, readp, readendp);
 	  if (readendp - readp < 1)
 	    {
-	      printf (gettext ("\
+	      fprintf (output, gettext ("\
 %*s*** missing DW_MACINFO_start_file argument at end of section"),
-		      level, "");
+		       level, "");
 	      return;
 	    }
 	  get_uleb128 (u128_2, readp, readendp);
@@ -6934,21 +7214,21 @@ print_debug_macinfo_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 			 ?: "???");
 	    }
 
-	  printf ("%*sstart_file %u, [%u] %s\n",
-		  level, "", u128, u128_2, fname);
+	  fprintf (output, "%*sstart_file %u, [%u] %s\n",
+		   level, "", u128, u128_2, fname);
 	  ++level;
 	  break;
 
 	case DW_MACINFO_end_file:
 	  --level;
-	  printf ("%*send_file\n", level, "");
+	  fprintf (output, "%*send_file\n", level, "");
 	  
 	  break;
 
 	default:
 	  
 	  if (unlikely (opcode != 0 || readp != readendp))
-	    printf ("%*s*** invalid opcode %u\n", level, "", opcode);
+	    fprintf (output, "%*s*** invalid opcode %u\n", level, "", opcode);
 	  break;
 	}
     }
@@ -6960,11 +7240,11 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 			   Ebl *ebl, GElf_Ehdr *ehdr,
 			   Elf_Scn *scn, GElf_Shdr *shdr, Dwarf *dbg)
 {
-  printf (gettext ("\
+  fprintf (output, gettext ("\
 \nDWARF section [%2zu] '%s' at offset %#" PRIx64 ":\n"),
-	  elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
-	  (uint64_t) shdr->sh_offset);
-  putc_unlocked ('\n', stdout);
+	   elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
+	   (uint64_t) shdr->sh_offset);
+  putc_unlocked ('\n', output);
 
   Elf_Data *data = dbg->sectiondata[IDX_debug_macro];
   if (unlikely (data == NULL || data->d_buf == NULL))
@@ -7007,8 +7287,8 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 
   while (readp < readendp)
     {
-      printf (gettext (" Offset:             0x%" PRIx64 "\n"),
-	      (uint64_t) (readp - (const unsigned char *) data->d_buf));
+      fprintf (output, gettext (" Offset:             0x%" PRIx64 "\n"),
+	       (uint64_t) (readp - (const unsigned char *) data->d_buf));
 
       
       
@@ -7019,23 +7299,25 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 	  return;
 	}
       const uint16_t vers = read_2ubyte_unaligned_inc (dbg, readp);
-      printf (gettext (" Version:            %" PRIu16 "\n"), vers);
+      fprintf (output, gettext (" Version:            %" PRIu16 "\n"), vers);
 
       
       
       if (vers != 4)
 	{
-	  printf (gettext ("  unknown version, cannot parse section\n"));
+	  fprintf (output,
+		   gettext ("  unknown version, cannot parse section\n"));
 	  return;
 	}
 
       if (readp + 1 > readendp)
 	goto invalid_data;
       const unsigned char flag = *readp++;
-      printf (gettext (" Flag:               0x%" PRIx8 "\n"), flag);
+      fprintf (output, gettext (" Flag:               0x%" PRIx8 "\n"), flag);
 
       unsigned int offset_len = (flag & 0x01) ? 8 : 4;
-      printf (gettext (" Offset length:      %" PRIu8 "\n"), offset_len);
+      fprintf (output, gettext (" Offset length:      %" PRIu8 "\n"),
+	       offset_len);
       Dwarf_Off line_offset = -1;
       if (flag & 0x02)
 	{
@@ -7043,8 +7325,8 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 	    line_offset = read_8ubyte_unaligned_inc (dbg, readp);
 	  else
 	    line_offset = read_4ubyte_unaligned_inc (dbg, readp);
-	  printf (gettext (" .debug_line offset: 0x%" PRIx64 "\n"),
-		  line_offset);
+	  fprintf (output, gettext (" .debug_line offset: 0x%" PRIx64 "\n"),
+		   line_offset);
 	}
 
       const unsigned char *vendor[DW_MACRO_GNU_hi_user - DW_MACRO_GNU_lo_user];
@@ -7056,14 +7338,15 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 	  if (readp + 1 > readendp)
 	    goto invalid_data;
 	  unsigned int tlen = *readp++;
-	  printf (gettext ("  extension opcode table, %" PRIu8 " items:\n"),
-		  tlen);
+	  fprintf (output, gettext ("  extension opcode table, %"
+				    PRIu8 " items:\n"),
+		   tlen);
 	  for (unsigned int i = 0; i < tlen; i++)
 	    {
 	      if (readp + 1 > readendp)
 		goto invalid_data;
 	      unsigned int opcode = *readp++;
-	      printf (gettext ("    [%" PRIx8 "]"), opcode);
+	      fprintf (output, gettext ("    [%" PRIx8 "]"), opcode);
 	      if (opcode < DW_MACRO_GNU_lo_user
 		  || opcode > DW_MACRO_GNU_hi_user)
 		goto invalid_data;
@@ -7075,13 +7358,13 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 	      unsigned int args = *readp++;
 	      if (args > 0)
 		{
-		  printf (gettext (" %" PRIu8 " arguments:"), args);
+		  fprintf (output, gettext (" %" PRIu8 " arguments:"), args);
 		  while (args > 0)
 		    {
 		      if (readp + 1 > readendp)
 			goto invalid_data;
 		      unsigned int form = *readp++;
-		      printf (" %s", dwarf_form_string (form));
+		      fprintf (output, " %s", dwarf_form_string (form));
 		      if (form != DW_FORM_data1
 			  && form != DW_FORM_data2
 			  && form != DW_FORM_data4
@@ -7099,15 +7382,15 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 			goto invalid_data;
 		      args--;
 		      if (args > 0)
-			putchar_unlocked (',');
+			putc_unlocked (',', output);
 		    }
 		}
 	      else
-		printf (gettext (" no arguments."));
-	      putchar_unlocked ('\n');
+		fprintf (output, gettext (" no arguments."));
+	      putc_unlocked ('\n', output);
 	    }
 	}
-      putchar_unlocked ('\n');
+      putc_unlocked ('\n', output);
 
       int level = 1;
       if (readp + 1 > readendp)
@@ -7147,14 +7430,14 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 						NULL, NULL) ?: "???");
 		    }
 		}
-	      printf ("%*sstart_file %u, [%u] %s\n",
-		      level, "", u128, u128_2, fname);
+	      fprintf (output, "%*sstart_file %u, [%u] %s\n",
+		       level, "", u128, u128_2, fname);
 	      ++level;
 	      break;
 
 	    case DW_MACRO_GNU_end_file:
 	      --level;
-	      printf ("%*send_file\n", level, "");
+	      fprintf (output, "%*send_file\n", level, "");
 	      break;
 
 	    case DW_MACRO_GNU_define:
@@ -7162,8 +7445,8 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 	      endp = memchr (readp, '\0', readendp - readp);
 	      if (endp == NULL)
 		goto invalid_data;
-	      printf ("%*s#define %s, line %u\n",
-		      level, "", readp, u128);
+	      fprintf (output, "%*s#define %s, line %u\n",
+		       level, "", readp, u128);
 	      readp = endp + 1;
 	      break;
 
@@ -7172,8 +7455,8 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 	      endp = memchr (readp, '\0', readendp - readp);
 	      if (endp == NULL)
 		goto invalid_data;
-	      printf ("%*s#undef %s, line %u\n",
-		      level, "", readp, u128);
+	      fprintf (output, "%*s#undef %s, line %u\n",
+		       level, "", readp, u128);
 	      readp = endp + 1;
 	      break;
 
@@ -7185,8 +7468,8 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 		off = read_8ubyte_unaligned_inc (dbg, readp);
 	      else
 		off = read_4ubyte_unaligned_inc (dbg, readp);
-	      printf ("%*s#define %s, line %u (indirect)\n",
-		      level, "", dwarf_getstring (dbg, off, NULL), u128);
+	      fprintf (output, "%*s#define %s, line %u (indirect)\n",
+		       level, "", dwarf_getstring (dbg, off, NULL), u128);
 	      break;
 
 	    case DW_MACRO_GNU_undef_indirect:
@@ -7197,8 +7480,8 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 		off = read_8ubyte_unaligned_inc (dbg, readp);
 	      else
 		off = read_4ubyte_unaligned_inc (dbg, readp);
-	      printf ("%*s#undef %s, line %u (indirect)\n",
-		      level, "", dwarf_getstring (dbg, off, NULL), u128);
+	      fprintf (output, "%*s#undef %s, line %u (indirect)\n",
+		       level, "", dwarf_getstring (dbg, off, NULL), u128);
 	      break;
 
 	    case DW_MACRO_GNU_transparent_include:
@@ -7208,12 +7491,13 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 		off = read_8ubyte_unaligned_inc (dbg, readp);
 	      else
 		off = read_4ubyte_unaligned_inc (dbg, readp);
-	      printf ("%*s#include offset 0x%" PRIx64 "\n",
-		      level, "", off);
+	      fprintf (output, "%*s#include offset 0x%" PRIx64 "\n",
+		       level, "", off);
 	      break;
 
 	    default:
-	      printf ("%*svendor opcode 0x%" PRIx8, level, "", opcode);
+	      fprintf (output, "%*svendor opcode 0x%" PRIx8, level, "",
+		       opcode);
 	      if (opcode < DW_MACRO_GNU_lo_user
 		  || opcode > DW_MACRO_GNU_lo_user
 		  || vendor[opcode - DW_MACRO_GNU_lo_user] == NULL)
@@ -7235,7 +7519,7 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 		      if (readp + 1 > readendp)
 			goto invalid_data;
 		      val = *readp++;
-		      printf (" %" PRIx8, (unsigned int) val);
+		      fprintf (output, " %" PRIx8, (unsigned int) val);
 		      break;
 
 		    case DW_FORM_data2:
@@ -7249,29 +7533,29 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 		      if (readp + 4 > readendp)
 			goto invalid_data;
 		      val = read_4ubyte_unaligned_inc (dbg, readp);
-		      printf (" %" PRIx32, (unsigned int) val);
+		      fprintf (output, " %" PRIx32, (unsigned int) val);
 		      break;
 
 		    case DW_FORM_data8:
 		      if (readp + 8 > readendp)
 			goto invalid_data;
 		      val = read_8ubyte_unaligned_inc (dbg, readp);
-		      printf (" %" PRIx64, val);
+		      fprintf (output, " %" PRIx64, val);
 		      break;
 
 		    case DW_FORM_sdata:
 		      get_sleb128 (val, readp, readendp);
-		      printf (" %" PRIx64, val);
+		      fprintf (output, " %" PRIx64, val);
 		      break;
 
 		    case DW_FORM_udata:
 		      get_uleb128 (val, readp, readendp);
-		      printf (" %" PRIx64, val);
+		      fprintf (output, " %" PRIx64, val);
 		      break;
 
 		    case DW_FORM_block:
 		      get_uleb128 (val, readp, readendp);
-		      printf (" block[%" PRIu64 "]", val);
+		      fprintf (output, " block[%" PRIu64 "]", val);
 		      if (readp + val > readendp)
 			goto invalid_data;
 		      readp += val;
@@ -7281,7 +7565,7 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 		      if (readp + 1 > readendp)
 			goto invalid_data;
 		      val = *readp++;
-		      printf (" block[%" PRIu64 "]", val);
+		      fprintf (output, " block[%" PRIu64 "]", val);
 		      if (readp + val > readendp)
 			goto invalid_data;
 		      break;
@@ -7290,7 +7574,7 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 		      if (readp + 2 > readendp)
 			goto invalid_data;
 		      val = read_2ubyte_unaligned_inc (dbg, readp);
-		      printf (" block[%" PRIu64 "]", val);
+		      fprintf (output, " block[%" PRIu64 "]", val);
 		      if (readp + val > readendp)
 			goto invalid_data;
 		      break;
@@ -7299,7 +7583,7 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 		      if (readp + 2 > readendp)
 			goto invalid_data;
 		      val =read_4ubyte_unaligned_inc (dbg, readp);
-		      printf (" block[%" PRIu64 "]", val);
+		      fprintf (output, " block[%" PRIu64 "]", val);
 		      if (readp + val > readendp)
 			goto invalid_data;
 		      break;
@@ -7308,14 +7592,15 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 		      if (readp + 1 > readendp)
 			goto invalid_data;
 		      val = *readp++;
-		      printf (" %s", nl_langinfo (val != 0 ? YESSTR : NOSTR));
+		      fprintf (output, " %s",
+			       nl_langinfo (val != 0 ? YESSTR : NOSTR));
 		      break;
 
 		    case DW_FORM_string:
 		      endp = memchr (readp, '\0', readendp - readp);
 		      if (endp == NULL)
 			goto invalid_data;
-		      printf (" %s", readp);
+		      fprintf (output, " %s", readp);
 		      readp = endp + 1;
 		      break;
 
@@ -7326,7 +7611,8 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 			val = read_8ubyte_unaligned_inc (dbg, readp);
 		      else
 			val = read_4ubyte_unaligned_inc (dbg, readp);
-		      printf (" %s", dwarf_getstring (dbg, val, NULL));
+		      fprintf (output, " %s",
+			       dwarf_getstring (dbg, val, NULL));
 		      break;
 
 		    case DW_FORM_sec_offset:
@@ -7336,7 +7622,7 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 			val = read_8ubyte_unaligned_inc (dbg, readp);
 		      else
 			val = read_4ubyte_unaligned_inc (dbg, readp);
-		      printf (" %" PRIx64, val);
+		      fprintf (output, " %" PRIx64, val);
 		      break;
 
 		      default:
@@ -7346,16 +7632,16 @@ print_debug_macro_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 
 		  args--;
 		  if (args > 0)
-		    putchar_unlocked (',');
+		    putc_unlocked (',', output);
 		}
-	      putchar_unlocked ('\n');
+	      putc_unlocked ('\n', output);
 	    }
 
 	  if (readp + 1 > readendp)
 	    goto invalid_data;
 	  opcode = *readp++;
 	  if (opcode == 0)
-	    putchar_unlocked ('\n');
+	    putc_unlocked ('\n', output);
 	}
     }
 }
@@ -7367,9 +7653,9 @@ print_pubnames (Dwarf *dbg __attribute__ ((unused)), Dwarf_Global *global,
 {
   int *np = (int *) arg;
 
-  printf (gettext (" [%5d] DIE offset: %6" PRId64
-		   ", CU DIE offset: %6" PRId64 ", name: %s\n"),
-	  (*np)++, global->die_offset, global->cu_offset, global->name);
+  fprintf (output, gettext (" [%5d] DIE offset: %6" PRId64
+			    ", CU DIE offset: %6" PRId64 ", name: %s\n"),
+	   (*np)++, global->die_offset, global->cu_offset, global->name);
 
   return 0;
 }
@@ -7380,9 +7666,10 @@ print_debug_pubnames_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 			      Ebl *ebl, GElf_Ehdr *ehdr,
 			      Elf_Scn *scn, GElf_Shdr *shdr, Dwarf *dbg)
 {
-  printf (gettext ("\nDWARF section [%2zu] '%s' at offset %#" PRIx64 ":\n"),
-	  elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
-	  (uint64_t) shdr->sh_offset);
+  fprintf (output, gettext ("\nDWARF section [%2zu] '%s' at offset %#"
+			    PRIx64 ":\n"),
+	   elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
+	   (uint64_t) shdr->sh_offset);
 
   int n = 0;
   (void) dwarf_getpubnames (dbg, print_pubnames, &n, 0);
@@ -7406,12 +7693,13 @@ print_debug_str_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
     }
   digits = MAX (4, digits);
 
-  printf (gettext ("\nDWARF section [%2zu] '%s' at offset %#" PRIx64 ":\n"
-		   " %*s  String\n"),
-	  elf_ndxscn (scn),
-	  section_name (ebl, ehdr, shdr), (uint64_t) shdr->sh_offset,
+  fprintf (output,
+	   gettext ("\nDWARF section [%2zu] '%s' at offset %#" PRIx64 ":\n"
+		    " %*s  String\n"),
+	   elf_ndxscn (scn),
+	   section_name (ebl, ehdr, shdr), (uint64_t) shdr->sh_offset,
 	  
-	  digits + 2, sgettext ("debugstr|Offset"));
+	   digits + 2, sgettext ("debugstr|Offset"));
 
   Dwarf_Off offset = 0;
   while (offset < sh_size)
@@ -7420,12 +7708,13 @@ print_debug_str_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
       const char *str = dwarf_getstring (dbg, offset, &len);
       if (unlikely (str == NULL))
 	{
-	  printf (gettext (" *** error while reading strings: %s\n"),
-		  dwarf_errmsg (-1));
+	  fprintf (output, gettext (" *** error while reading strings: %s\n"),
+		   dwarf_errmsg (-1));
 	  break;
 	}
 
-      printf (" [%*" PRIx64 "]  \"%s\"\n", digits, (uint64_t) offset, str);
+      fprintf (output, " [%*" PRIx64 "]  \"%s\"\n", digits, (uint64_t) offset,
+	       str);
 
       offset += len + 1;
     }
@@ -7438,9 +7727,9 @@ print_debug_frame_hdr_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 			       GElf_Ehdr *ehdr __attribute__ ((unused)),
 			       Elf_Scn *scn, GElf_Shdr *shdr, Dwarf *dbg)
 {
-  printf (gettext ("\
+  fprintf (output, gettext ("\
 \nCall frame search table section [%2zu] '.eh_frame_hdr':\n"),
-	  elf_ndxscn (scn));
+	   elf_ndxscn (scn));
 
   Elf_Data *data = elf_rawdata (scn, NULL);
 
@@ -7467,13 +7756,13 @@ print_debug_frame_hdr_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
   unsigned int fde_count_enc = *readp++;
   unsigned int table_enc = *readp++;
 
-  printf (" version:          %u\n"
-	  " eh_frame_ptr_enc: %#x ",
-	  version, eh_frame_ptr_enc);
+  fprintf (output, " version:          %u\n"
+	   " eh_frame_ptr_enc: %#x ",
+	   version, eh_frame_ptr_enc);
   print_encoding_base ("", eh_frame_ptr_enc);
-  printf (" fde_count_enc:    %#x ", fde_count_enc);
+  fprintf (output, " fde_count_enc:    %#x ", fde_count_enc);
   print_encoding_base ("", fde_count_enc);
-  printf (" table_enc:        %#x ", table_enc);
+  fprintf (output, " table_enc:        %#x ", table_enc);
   print_encoding_base ("", table_enc);
 
   uint64_t eh_frame_ptr = 0;
@@ -7484,13 +7773,13 @@ print_debug_frame_hdr_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
       if (unlikely (readp == NULL))
 	goto invalid_data;
 
-      printf (" eh_frame_ptr:     %#" PRIx64, eh_frame_ptr);
+      fprintf (output, " eh_frame_ptr:     %#" PRIx64, eh_frame_ptr);
       if ((eh_frame_ptr_enc & 0x70) == DW_EH_PE_pcrel)
-	printf (" (offset: %#" PRIx64 ")",
+	fprintf (output, " (offset: %#" PRIx64 ")",
 		
-		(uint64_t) shdr->sh_offset + 4 + eh_frame_ptr);
+		 (uint64_t) shdr->sh_offset + 4 + eh_frame_ptr);
 
-      putchar_unlocked ('\n');
+      putc_unlocked ('\n', output);
     }
 
   uint64_t fde_count = 0;
@@ -7500,13 +7789,13 @@ print_debug_frame_hdr_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
       if (unlikely (readp == NULL))
 	goto invalid_data;
 
-      printf (" fde_count:        %" PRIu64 "\n", fde_count);
+      fprintf (output, " fde_count:        %" PRIu64 "\n", fde_count);
     }
 
   if (fde_count == 0 || table_enc == DW_EH_PE_omit)
     return;
 
-  puts (" Table:");
+  fprintf (output, "%s\n", " Table:");
 
   
   if (table_enc == (DW_EH_PE_datarel | DW_EH_PE_sdata4))
@@ -7517,10 +7806,10 @@ print_debug_frame_hdr_section (Dwfl_Module *dwflmod __attribute__ ((unused)),
 				   + (int64_t) initial_location);
 	int32_t address = read_4sbyte_unaligned_inc (dbg, readp);
 	
-	printf ("  %#" PRIx32 " (offset: %#6" PRIx64 ") -> %#" PRIx32
-		" fde=[%6" PRIx64 "]\n",
-		initial_location, initial_offset,
-		address, address - (eh_frame_ptr + 4));
+	fprintf (output, "  %#" PRIx32 " (offset: %#6" PRIx64 ") -> %#" PRIx32
+		 " fde=[%6" PRIx64 "]\n",
+		 initial_location, initial_offset,
+		 address, address - (eh_frame_ptr + 4));
       }
   else
     while (0 && readp < dataend)
@@ -7538,9 +7827,9 @@ print_debug_exception_table (Dwfl_Module *dwflmod __attribute__ ((unused)),
 			     GElf_Shdr *shdr __attribute__ ((unused)),
 			     Dwarf *dbg __attribute__ ((unused)))
 {
-  printf (gettext ("\
+  fprintf (output, gettext ("\
 \nException handling table section [%2zu] '.gcc_except_table':\n"),
-	  elf_ndxscn (scn));
+	   elf_ndxscn (scn));
 
   Elf_Data *data = elf_rawdata (scn, NULL);
 
@@ -7561,26 +7850,26 @@ print_debug_exception_table (Dwfl_Module *dwflmod __attribute__ ((unused)),
       return;
     }
   unsigned int lpstart_encoding = *readp++;
-  printf (gettext (" LPStart encoding:    %#x "), lpstart_encoding);
+  fprintf (output, gettext (" LPStart encoding:    %#x "), lpstart_encoding);
   print_encoding_base ("", lpstart_encoding);
   if (lpstart_encoding != DW_EH_PE_omit)
     {
       uint64_t lpstart;
       readp = read_encoded (lpstart_encoding, readp, dataend, &lpstart, dbg);
-      printf (" LPStart:             %#" PRIx64 "\n", lpstart);
+      fprintf (output, " LPStart:             %#" PRIx64 "\n", lpstart);
     }
 
   if (unlikely (readp + 1 > dataend))
     goto invalid_data;
   unsigned int ttype_encoding = *readp++;
-  printf (gettext (" TType encoding:      %#x "), ttype_encoding);
+  fprintf (output, gettext (" TType encoding:      %#x "), ttype_encoding);
   print_encoding_base ("", ttype_encoding);
   const unsigned char *ttype_base = NULL;
   if (ttype_encoding != DW_EH_PE_omit)
     {
       unsigned int ttype_base_offset;
       get_uleb128 (ttype_base_offset, readp, dataend);
-      printf (" TType base offset:   %#x\n", ttype_base_offset);
+      fprintf (output, " TType base offset:   %#x\n", ttype_base_offset);
       if ((size_t) (dataend - readp) > ttype_base_offset)
         ttype_base = readp + ttype_base_offset;
     }
@@ -7588,7 +7877,7 @@ print_debug_exception_table (Dwfl_Module *dwflmod __attribute__ ((unused)),
   if (unlikely (readp + 1 > dataend))
     goto invalid_data;
   unsigned int call_site_encoding = *readp++;
-  printf (gettext (" Call site encoding:  %#x "), call_site_encoding);
+  fprintf (output, gettext (" Call site encoding:  %#x "), call_site_encoding);
   print_encoding_base ("", call_site_encoding);
   unsigned int call_site_table_len;
   get_uleb128 (call_site_table_len, readp, dataend);
@@ -7601,7 +7890,7 @@ print_debug_exception_table (Dwfl_Module *dwflmod __attribute__ ((unused)),
   while (readp < action_table)
     {
       if (u == 0)
-	puts (gettext ("\n Call site table:"));
+	fprintf (output, "%s\n", gettext ("\n Call site table:"));
 
       uint64_t call_site_start;
       readp = read_encoded (call_site_encoding, readp, dataend,
@@ -7615,11 +7904,11 @@ print_debug_exception_table (Dwfl_Module *dwflmod __attribute__ ((unused)),
       unsigned int action;
       get_uleb128 (action, readp, dataend);
       max_action = MAX (action, max_action);
-      printf (gettext (" [%4u] Call site start:   %#" PRIx64 "\n"
-		       "        Call site length:  %" PRIu64 "\n"
-		       "        Landing pad:       %#" PRIx64 "\n"
-		       "        Action:            %u\n"),
-	      u++, call_site_start, call_site_length, landing_pad, action);
+      fprintf (output, gettext (" [%4u] Call site start:   %#" PRIx64 "\n"
+				"        Call site length:  %" PRIu64 "\n"
+				"        Landing pad:       %#" PRIx64 "\n"
+				"        Action:            %u\n"),
+	       u++, call_site_start, call_site_length, landing_pad, action);
     }
   if (readp != action_table)
     goto invalid_data;
@@ -7627,11 +7916,11 @@ print_debug_exception_table (Dwfl_Module *dwflmod __attribute__ ((unused)),
   unsigned int max_ar_filter = 0;
   if (max_action > 0)
     {
-      puts ("\n Action table:");
+      fprintf (output, "%s\n", "\n Action table:");
 
       if ((size_t) (dataend - action_table) < max_action + 1)
 	{
-	  fputs (gettext ("   <INVALID DATA>\n"), stdout);
+	  fputs (gettext ("   <INVALID DATA>\n"), output);
 	  return;
 	}
 
@@ -7648,15 +7937,15 @@ print_debug_exception_table (Dwfl_Module *dwflmod __attribute__ ((unused)),
 	  int ar_disp;
 	  get_sleb128 (ar_disp, readp, action_table_end);
 
-	  printf (" [%4u] ar_filter:  % d\n"
-		  "        ar_disp:    % -5d",
-		  u, ar_filter, ar_disp);
+	  fprintf (output, " [%4u] ar_filter:  % d\n"
+		   "        ar_disp:    % -5d",
+		   u, ar_filter, ar_disp);
 	  if (abs (ar_disp) & 1)
-	    printf (" -> [%4u]\n", u + (ar_disp + 1) / 2);
+	    fprintf (output, " -> [%4u]\n", u + (ar_disp + 1) / 2);
 	  else if (ar_disp != 0)
-	    puts (" -> ???");
+	    fprintf (output, "%s\n", " -> ???");
 	  else
-	    putchar_unlocked ('\n');
+	    putc_unlocked ('\n', output);
 	  ++u;
 	}
       while (readp < action_table_end);
@@ -7664,7 +7953,7 @@ print_debug_exception_table (Dwfl_Module *dwflmod __attribute__ ((unused)),
 
   if (max_ar_filter > 0 && ttype_base != NULL)
     {
-      puts ("\n TType table:");
+      fprintf (output, "%s\n", "\n TType table:");
 
       
       switch (ttype_encoding & 7)
@@ -7690,7 +7979,7 @@ print_debug_exception_table (Dwfl_Module *dwflmod __attribute__ ((unused)),
 	  uint64_t ttype;
 	  readp = read_encoded (ttype_encoding, readp, ttype_base, &ttype,
 				dbg);
-	  printf (" [%4u] %#" PRIx64 "\n", max_ar_filter--, ttype);
+	  fprintf (output, " [%4u] %#" PRIx64 "\n", max_ar_filter--, ttype);
 	}
       while (readp < ttype_base);
     }
@@ -7700,10 +7989,10 @@ static void
 print_gdb_index_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 			 Elf_Scn *scn, GElf_Shdr *shdr, Dwarf *dbg)
 {
-  printf (gettext ("\nGDB section [%2zu] '%s' at offset %#" PRIx64
-		   " contains %" PRId64 " bytes :\n"),
-	  elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
-	  (uint64_t) shdr->sh_offset, (uint64_t) shdr->sh_size);
+  fprintf (output, gettext ("\nGDB section [%2zu] '%s' at offset %#" PRIx64
+			    " contains %" PRId64 " bytes :\n"),
+	   elf_ndxscn (scn), section_name (ebl, ehdr, shdr),
+	   (uint64_t) shdr->sh_offset, (uint64_t) shdr->sh_size);
 
   Elf_Data *data = elf_rawdata (scn, NULL);
 
@@ -7729,7 +8018,7 @@ print_gdb_index_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
     }
 
   int32_t vers = read_4ubyte_unaligned (dbg, readp);
-  printf (gettext (" Version:         %" PRId32 "\n"), vers);
+  fprintf (output, gettext (" Version:         %" PRId32 "\n"), vers);
 
   
   
@@ -7738,7 +8027,7 @@ print_gdb_index_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
   
   if (vers < 4 || vers > 8)
     {
-      printf (gettext ("  unknown version, cannot parse section\n"));
+      fprintf (output, gettext ("  unknown version, cannot parse section\n"));
       return;
     }
 
@@ -7747,44 +8036,44 @@ print_gdb_index_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
     goto invalid_data;
 
   uint32_t cu_off = read_4ubyte_unaligned (dbg, readp);
-  printf (gettext (" CU offset:       %#" PRIx32 "\n"), cu_off);
+  fprintf (output, gettext (" CU offset:       %#" PRIx32 "\n"), cu_off);
 
   readp += 4;
   if (unlikely (readp + 4 > dataend))
     goto invalid_data;
 
   uint32_t tu_off = read_4ubyte_unaligned (dbg, readp);
-  printf (gettext (" TU offset:       %#" PRIx32 "\n"), tu_off);
+  fprintf (output, gettext (" TU offset:       %#" PRIx32 "\n"), tu_off);
 
   readp += 4;
   if (unlikely (readp + 4 > dataend))
     goto invalid_data;
 
   uint32_t addr_off = read_4ubyte_unaligned (dbg, readp);
-  printf (gettext (" address offset:  %#" PRIx32 "\n"), addr_off);
+  fprintf (output, gettext (" address offset:  %#" PRIx32 "\n"), addr_off);
 
   readp += 4;
   if (unlikely (readp + 4 > dataend))
     goto invalid_data;
 
   uint32_t sym_off = read_4ubyte_unaligned (dbg, readp);
-  printf (gettext (" symbol offset:   %#" PRIx32 "\n"), sym_off);
+  fprintf (output, gettext (" symbol offset:   %#" PRIx32 "\n"), sym_off);
 
   readp += 4;
   if (unlikely (readp + 4 > dataend))
     goto invalid_data;
 
   uint32_t const_off = read_4ubyte_unaligned (dbg, readp);
-  printf (gettext (" constant offset: %#" PRIx32 "\n"), const_off);
+  fprintf (output, gettext (" constant offset: %#" PRIx32 "\n"), const_off);
 
   readp = data->d_buf + cu_off;
 
   const unsigned char *nextp = data->d_buf + tu_off;
   size_t cu_nr = (nextp - readp) / 16;
 
-  printf (gettext ("\n CU list at offset %#" PRIx32
-		   " contains %zu entries:\n"),
-	  cu_off, cu_nr);
+  fprintf (output, gettext ("\n CU list at offset %#" PRIx32
+			    " contains %zu entries:\n"),
+	   cu_off, cu_nr);
 
   size_t n = 0;
   while (readp + 16 <= dataend && n < cu_nr)
@@ -7795,8 +8084,8 @@ print_gdb_index_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
       uint64_t len = read_8ubyte_unaligned (dbg, readp);
       readp += 8;
 
-      printf (" [%4zu] start: %0#8" PRIx64
-	      ", length: %5" PRIu64 "\n", n, off, len);
+      fprintf (output, " [%4zu] start: %0#8" PRIx64
+	       ", length: %5" PRIu64 "\n", n, off, len);
       n++;
     }
 
@@ -7804,9 +8093,9 @@ print_gdb_index_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
   nextp = data->d_buf + addr_off;
   size_t tu_nr = (nextp - readp) / 24;
 
-  printf (gettext ("\n TU list at offset %#" PRIx32
-		   " contains %zu entries:\n"),
-	  tu_off, tu_nr);
+  fprintf (output, gettext ("\n TU list at offset %#" PRIx32
+			    " contains %zu entries:\n"),
+	   tu_off, tu_nr);
 
   n = 0;
   while (readp + 24 <= dataend && n < tu_nr)
@@ -7820,9 +8109,9 @@ print_gdb_index_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
       uint64_t sig = read_8ubyte_unaligned (dbg, readp);
       readp += 8;
 
-      printf (" [%4zu] CU offset: %5" PRId64
-	      ", type offset: %5" PRId64
-	      ", signature: %0#8" PRIx64 "\n", n, off, type, sig);
+      fprintf (output, " [%4zu] CU offset: %5" PRId64
+	       ", type offset: %5" PRId64
+	       ", signature: %0#8" PRIx64 "\n", n, off, type, sig);
       n++;
     }
 
@@ -7830,9 +8119,9 @@ print_gdb_index_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
   nextp = data->d_buf + sym_off;
   size_t addr_nr = (nextp - readp) / 20;
 
-  printf (gettext ("\n Address list at offset %#" PRIx32
-		   " contains %zu entries:\n"),
-	  addr_off, addr_nr);
+  fprintf (output, gettext ("\n Address list at offset %#" PRIx32
+			    " contains %zu entries:\n"),
+	   addr_off, addr_nr);
 
   n = 0;
   while (readp + 20 <= dataend && n < addr_nr)
@@ -7848,8 +8137,8 @@ print_gdb_index_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 
       char *l = format_dwarf_addr (dwflmod, 8, low, low);
       char *h = format_dwarf_addr (dwflmod, 8, high - 1, high);
-      printf (" [%4zu] %s..%s, CU index: %5" PRId32 "\n",
-	      n, l, h, idx);
+      fprintf (output, " [%4zu] %s..%s, CU index: %5" PRId32 "\n",
+	       n, l, h, idx);
       free (l);
       free (h);
       n++;
@@ -7859,9 +8148,9 @@ print_gdb_index_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
   nextp = data->d_buf + const_off;
   size_t sym_nr = (nextp - readp) / 8;
 
-  printf (gettext ("\n Symbol table at offset %#" PRIx32
-		   " contains %zu slots:\n"),
-	  addr_off, sym_nr);
+  fprintf (output, gettext ("\n Symbol table at offset %#" PRIx32
+			    " contains %zu slots:\n"),
+	   addr_off, sym_nr);
 
   n = 0;
   while (readp + 8 <= dataend && n < sym_nr)
@@ -7879,7 +8168,7 @@ print_gdb_index_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 			|| memchr (sym, '\0', dataend - sym) == NULL))
 	    goto invalid_data;
 
-	  printf (" [%4zu] symbol: %s, CUs: ", n, sym);
+	  fprintf (output, " [%4zu] symbol: %s, CUs: ", n, sym);
 
 	  const unsigned char *readcus = data->d_buf + const_off + vector;
 	  if (unlikely (readcus + 4 > dataend))
@@ -7897,41 +8186,110 @@ print_gdb_index_section (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr,
 	      kind = (cu_kind >> 28) & 7;
 	      is_static = cu_kind & (1U << 31);
 	      if (cu > cu_nr - 1)
-		printf ("%" PRId32 "T", cu - (uint32_t) cu_nr);
+		fprintf (output, "%" PRId32 "T", cu - (uint32_t) cu_nr);
 	      else
-		printf ("%" PRId32, cu);
+		fprintf (output, "%" PRId32, cu);
 	      if (kind != 0)
 		{
-		  printf (" (");
+		  fprintf (output, " (");
 		  switch (kind)
 		    {
 		    case 1:
-		      printf ("type");
+		      fprintf (output, "type");
 		      break;
 		    case 2:
-		      printf ("var");
+		      fprintf (output, "var");
 		      break;
 		    case 3:
-		      printf ("func");
+		      fprintf (output, "func");
 		      break;
 		    case 4:
-		      printf ("other");
+		      fprintf (output, "other");
 		      break;
 		    default:
-		      printf ("unknown-0x%" PRIx32, kind);
+		      fprintf (output, "unknown-0x%" PRIx32, kind);
 		      break;
 		    }
-		  printf (":%c)", (is_static ? 'S' : 'G'));
+		  fprintf (output, ":%c)", (is_static ? 'S' : 'G'));
 		}
 	      if (cus > 0)
-		printf (", ");
+		fprintf (output, ", ");
 	    }
-	  printf ("\n");
+	  fprintf (output, "\n");
 	}
       n++;
     }
 }
 
+static void
+print_debug_section_unit (struct print_unit *unit)
+{
+  unit->fp (unit->dwflmod, unit->ebl, unit->ehdr, unit->scn, &unit->shdr,
+	    unit->dbg);
+}
+
+static void
+print_debug_units_header_unit (struct print_unit *unit)
+{
+  print_debug_units_header (unit->ebl, unit->ehdr, unit->scn, &unit->shdr);
+}
+
+static void
+print_debug_cu_unit (struct print_unit *unit)
+{
+  Dwarf_Off nextcu;
+  unit->stop = ! print_debug_unit (unit->dwflmod, unit->dbg,
+				   section_name (unit->ebl, unit->ehdr,
+						 &unit->shdr),
+				   !(print_debug_sections & section_info),
+				   unit->debug_types, unit->cu_offset,
+				   &nextcu);
+}
+
+static void
+add_debug_units (struct print_units *pu, Dwfl_Module *dwflmod, Ebl *ebl,
+		 GElf_Ehdr *ehdr, Elf_Scn *scn, GElf_Shdr *shdr, Dwarf *dbg,
+		 void (*fp) (Dwfl_Module *, Ebl *, GElf_Ehdr *, Elf_Scn *,
+			     GElf_Shdr *, Dwarf *),
+		 enum section_e bitmask)
+{
+  
+  if (fp != print_debug_info_section && fp != print_debug_types_section)
+    {
+      struct print_unit *unit = add_print_unit (pu, print_debug_section_unit,
+						ebl, ehdr, scn, shdr);
+      unit->dwflmod = dwflmod;
+      unit->dbg = dbg;
+      unit->fp = fp;
+      unit->second_pass = (bitmask & (section_loc | section_ranges)) != 0;
+      return;
+    }
+
+  
+  add_print_unit (pu, print_debug_units_header_unit, ebl, ehdr, scn, shdr);
+  if ((print_debug_sections & section_info) && shdr->sh_size == 0)
+    return;
+
+  const bool debug_types = fp == print_debug_types_section;
+  Dwarf_Off offset = 0;
+  Dwarf_Off nextcu;
+  uint64_t typesig;
+  while (dwarf_next_unit (dbg, offset, &nextcu, NULL, NULL, NULL, NULL,
+			  NULL, debug_types ? &typesig : NULL, NULL) == 0)
+    {
+      struct print_unit *unit = add_print_unit (pu, print_debug_cu_unit,
+						ebl, ehdr, scn, shdr);
+      unit->dwflmod = dwflmod;
+      unit->dbg = dbg;
+      unit->cu_offset = offset;
+      unit->debug_types = debug_types;
+
+      offset = nextcu;
+      if (offset == 0)
+	break;
+    }
+}
+
 static void
 print_debug (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr)
 {
@@ -7960,6 +8318,14 @@ print_debug (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr)
 	   gettext ("cannot get section header string table index"));
 
   
+#ifdef USE_LOCKS
+  const bool parallel = jobs > 1;
+#else
+  const bool parallel = false;
+#endif
+  struct print_units pu = { .units = NULL };
+
+  
   Elf_Scn *scn = NULL;
   while ((scn = elf_nextscn (ebl->elf, scn)) != NULL)
     {
@@ -8008,21 +8374,42 @@ print_debug (Dwfl_Module *dwflmod, Ebl *ebl, GElf_Ehdr *ehdr)
 	  int n;
 	  for (n = 0; n < ndebug_sections; ++n)
 	    if (strcmp (name, debug_sections[n].name) == 0
-#if USE_ZLIB
 		|| (name[0] == '.' && name[1] == 'z'
 		    && debug_sections[n].name[1] == 'd'
-		    && strcmp (&name[2], &debug_sections[n].name[1]) == 0)
-#endif
-		)
+		    && strcmp (&name[2], &debug_sections[n].name[1]) == 0))
 	      {
 		if ((print_debug_sections | implicit_debug_sections)
 		    & debug_sections[n].bitmask)
-		  debug_sections[n].fp (dwflmod, ebl, ehdr, scn, shdr, dbg);
+		  {
+		    
+		    if (name[1] == 'z')
+		      (void) elf_compress_gnu (scn, 0, 0);
+		    if (((shdr->sh_flags & SHF_COMPRESSED) != 0
+			 && elf_compress (scn, 0, 0) < 0)
+			|| (shdr = gelf_getshdr (scn, &shdr_mem)) == NULL)
+		      error (0, 0,
+			     gettext ("cannot decompress section [%zu] '%s': %s"),
+			     elf_ndxscn (scn), name, elf_errmsg (-1));
+		    else if (parallel)
+		      add_debug_units (&pu, dwflmod, ebl, ehdr, scn, shdr, dbg,
+				       debug_sections[n].fp,
+				       debug_sections[n].bitmask);
+		    else
+		      debug_sections[n].fp (dwflmod, ebl, ehdr, scn, shdr, dbg);
+		  }
 		break;
 	      }
 	}
     }
 
+  if (pu.n > 0)
+    {
+      
+      GElf_Addr bias;
+      (void) dwfl_module_getelf (dwflmod, &bias);
+      print_units (&pu);
+    }
+
   reset_listptr (&known_loclistptr);
   reset_listptr (&known_rangelistptr);
 }
@@ -8053,21 +8440,21 @@ print_core_item (unsigned int colno, char sep, unsigned int wrap,
 
   if (colno == 0)
     {
-      printf ("%*s", ITEM_INDENT, "");
+      fprintf (output, "%*s", ITEM_INDENT, "");
       colno = ITEM_INDENT + n;
     }
   else if (colno + 2 + n < wrap)
     {
-      printf ("%c ", sep);
+      fprintf (output, "%c ", sep);
       colno += 2 + n;
     }
   else
     {
-      printf ("\n%*s", ITEM_INDENT, "");
+      fprintf (output, "\n%*s", ITEM_INDENT, "");
       colno = ITEM_INDENT + n;
     }
 
-  printf ("%s: %*s%s", name, (int) (name_width - len), "", out);
+  fprintf (output, "%s: %*s%s", name, (int) (name_width - len), "", out);
 
   free (out);
 
@@ -8301,7 +8688,7 @@ handle_core_item (Elf *core, const Ebl_Core_Item *item, const void *desc,
 	  int len = size;
 	  if (eol != NULL)
 	    len = eol - s;
-	  printf ("%*s%.*s\n", ITEM_INDENT, "", len, s);
+	  fprintf (output, "%*s%.*s\n", ITEM_INDENT, "", len, s);
 	  if (eol == NULL)
 	    break;
 	  size -= eol + 1 - s;
@@ -8427,8 +8814,8 @@ handle_core_items (Elf *core, const void *desc, size_t descsz,
 	  descsz += eltsz;
 	}
       else if (reps > 1)
-	printf (gettext ("\n%*s... <repeats %u more times> ..."),
-		ITEM_INDENT, "", reps);
+	fprintf (output, gettext ("\n%*s... <repeats %u more times> ..."),
+		 ITEM_INDENT, "", reps);
 
       last = desc;
     }
@@ -8700,10 +9087,10 @@ handle_auxv_note (Ebl *ebl, Elf *core, GElf_Word descsz, GElf_Off desc_pos)
 	{
 	  
 	  if (av->a_un.a_val == 0)
-	    printf ("    %" PRIu64 "\n", av->a_type);
+	    fprintf (output, "    %" PRIu64 "\n", av->a_type);
 	  else
-	    printf ("    %" PRIu64 ": %#" PRIx64 "\n",
-		    av->a_type, av->a_un.a_val);
+	    fprintf (output, "    %" PRIu64 ": %#" PRIx64 "\n",
+		     av->a_type, av->a_un.a_val);
 	}
       else
 	switch (fmt[0])
@@ -8711,36 +9098,36 @@ handle_auxv_note (Ebl *ebl, Elf *core, GElf_Word descsz, GElf_Off desc_pos)
 	  case '\0':		
 	    if (av->a_un.a_val == 0)
 	      {
-		printf ("    %s\n", name);
+		fprintf (output, "    %s\n", name);
 		break;
 	      }
 	    
 	  case 'x':		
 	  case 'p':		
 	  case 's':		
-	    printf ("    %s: %#" PRIx64 "\n", name, av->a_un.a_val);
+	    fprintf (output, "    %s: %#" PRIx64 "\n", name, av->a_un.a_val);
 	    break;
 	  case 'u':
-	    printf ("    %s: %" PRIu64 "\n", name, av->a_un.a_val);
+	    fprintf (output, "    %s: %" PRIu64 "\n", name, av->a_un.a_val);
 	    break;
 	  case 'd':
-	    printf ("    %s: %" PRId64 "\n", name, av->a_un.a_val);
+	    fprintf (output, "    %s: %" PRId64 "\n", name, av->a_un.a_val);
 	    break;
 
 	  case 'b':
-	    printf ("    %s: %#" PRIx64 "  ", name, av->a_un.a_val);
+	    fprintf (output, "    %s: %#" PRIx64 "  ", name, av->a_un.a_val);
 	    GElf_Xword bit = 1;
 	    const char *pfx = "<";
 	    for (const char *p = fmt + 1; *p != 0; p = strchr (p, '\0') + 1)
 	      {
 		if (av->a_un.a_val & bit)
 		  {
-		    printf ("%s%s", pfx, p);
+		    fprintf (output, "%s%s", pfx, p);
 		    pfx = " ";
 		  }
 		bit <<= 1;
 	      }
-	    printf (">\n");
+	    fprintf (output, ">\n");
 	    break;
 
 	  default:
@@ -8806,15 +9193,15 @@ handle_siginfo_note (Elf *core, GElf_Word descsz, GElf_Off desc_pos)
       || ! buf_read_int (core, &ptr, end, &si_code))
     {
     fail:
-      printf ("    Not enough data in NT_SIGINFO note.\n");
+      fprintf (output, "    Not enough data in NT_SIGINFO note.\n");
       return;
     }
 
   if (gelf_getclass (core) == ELFCLASS64)
     ptr += 4;
 
-  printf ("    si_signo: %d, si_errno: %d, si_code: %d\n",
-	  si_signo, si_errno, si_code);
+  fprintf (output, "    si_signo: %d, si_errno: %d, si_code: %d\n",
+	   si_signo, si_errno, si_code);
 
   if (si_code > 0)
     switch (si_signo)
@@ -8827,7 +9214,7 @@ handle_siginfo_note (Elf *core, GElf_Word descsz, GElf_Off desc_pos)
 	  uint64_t addr;
 	  if (! buf_read_ulong (core, &ptr, end, &addr))
 	    goto fail;
-	  printf ("    fault address: %#" PRIx64 "\n", addr);
+	  fprintf (output, "    fault address: %#" PRIx64 "\n", addr);
 	  break;
 	}
       default:
@@ -8839,7 +9226,7 @@ handle_siginfo_note (Elf *core, GElf_Word descsz, GElf_Off desc_pos)
       if (! buf_read_int (core, &ptr, end, &pid)
 	  || ! buf_read_int (core, &ptr, end, &uid))
 	goto fail;
-      printf ("    sender PID: %d, sender UID: %d\n", pid, uid);
+      fprintf (output, "    sender PID: %d, sender UID: %d\n", pid, uid);
     }
 }
 
@@ -8859,7 +9246,7 @@ handle_file_note (Elf *core, GElf_Word descsz, GElf_Off desc_pos)
       || ! buf_read_ulong (core, &ptr, end, &page_size))
     {
     fail:
-      printf ("    Not enough data in NT_FILE note.\n");
+      fprintf (output, "    Not enough data in NT_FILE note.\n");
       return;
     }
 
@@ -8872,7 +9259,7 @@ handle_file_note (Elf *core, GElf_Word descsz, GElf_Off desc_pos)
   unsigned char const *const fstart = ptr + 3 * count * addrsize;
   char const *fptr = (char *) fstart;
 
-  printf ("    %" PRId64 " files:\n", count);
+  fprintf (output, "    %" PRId64 " files:\n", count);
   for (uint64_t i = 0; i < count; ++i)
     {
       uint64_t mstart, mend, moffset;
@@ -8885,10 +9272,10 @@ handle_file_note (Elf *core, GElf_Word descsz, GElf_Off desc_pos)
       if (fnext == NULL)
 	goto fail;
 
-      int ct = printf ("      %08" PRIx64 "-%08" PRIx64
-		       " %08" PRIx64 " %" PRId64,
-		       mstart, mend, moffset * page_size, mend - mstart);
-      printf ("%*s%s\n", ct > 50 ? 3 : 53 - ct, "", fptr);
+      int ct = fprintf (output, "      %08" PRIx64 "-%08" PRIx64
+			" %08" PRIx64 " %" PRId64,
+			mstart, mend, moffset * page_size, mend - mstart);
+      fprintf (output, "%*s%s\n", ct > 50 ? 3 : 53 - ct, "", fptr);
 
       fptr = fnext + 1;
     }
@@ -8912,19 +9299,19 @@ handle_core_note (Ebl *ebl, const GElf_Nhdr *nhdr,
 					  nregloc == 0 ? nhdr->n_descsz : 0,
 					  items, nitems);
   if (colno != 0)
-    putchar_unlocked ('\n');
+    putc_unlocked ('\n', output);
 
   colno = handle_core_registers (ebl, ebl->elf, desc + regs_offset,
 				 reglocs, nregloc);
   if (colno != 0)
-    putchar_unlocked ('\n');
+    putc_unlocked ('\n', output);
 }
 
 static void
 handle_notes_data (Ebl *ebl, const GElf_Ehdr *ehdr,
 		   GElf_Off start, Elf_Data *data)
 {
-  fputs_unlocked (gettext ("  Owner          Data size  Type\n"), stdout);
+  fputs_unlocked (gettext ("  Owner          Data size  Type\n"), output);
 
   if (data == NULL)
     goto bad_note;
@@ -8942,13 +9329,13 @@ handle_notes_data (Ebl *ebl, const GElf_Ehdr *ehdr,
 
       char buf[100];
       char buf2[100];
-      printf (gettext ("  %-13.*s  %9" PRId32 "  %s\n"),
-	      (int) nhdr.n_namesz, name, nhdr.n_descsz,
-	      ehdr->e_type == ET_CORE
-	      ? ebl_core_note_type_name (ebl, nhdr.n_type,
-					 buf, sizeof (buf))
-	      : ebl_object_note_type_name (ebl, name, nhdr.n_type,
-					   buf2, sizeof (buf2)));
+      fprintf (output, gettext ("  %-13.*s  %9" PRId32 "  %s\n"),
+	       (int) nhdr.n_namesz, name, nhdr.n_descsz,
+	       ehdr->e_type == ET_CORE
+	       ? ebl_core_note_type_name (ebl, nhdr.n_type,
+					  buf, sizeof (buf))
+	       : ebl_object_note_type_name (ebl, name, nhdr.n_type,
+					    buf2, sizeof (buf2)));
 
       
       if (memchr (name, '\0', nhdr.n_namesz) != NULL
@@ -9017,11 +9404,11 @@ handle_notes (Ebl *ebl, GElf_Ehdr *ehdr)
 	    
 	    continue;
 
-	  printf (gettext ("\
+	  fprintf (output, gettext ("\
 \nNote section [%2zu] '%s' of %" PRIu64 " bytes at offset %#0" PRIx64 ":\n"),
-		  elf_ndxscn (scn),
-		  elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
-		  shdr->sh_size, shdr->sh_offset);
+		   elf_ndxscn (scn),
+		   elf_strptr (ebl->elf, shstrndx, shdr->sh_name),
+		   shdr->sh_size, shdr->sh_offset);
 
 	  handle_notes_data (ebl, ehdr, shdr->sh_offset,
 			     elf_getdata (scn, NULL));
@@ -9038,9 +9425,9 @@ handle_notes (Ebl *ebl, GElf_Ehdr *ehdr)
 	
 	continue;
 
-      printf (gettext ("\
+      fprintf (output, gettext ("\
 \nNote segment of %" PRIu64 " bytes at offset %#0" PRIx64 ":\n"),
-	      phdr->p_filesz, phdr->p_offset);
+	       phdr->p_filesz, phdr->p_offset);
 
       handle_notes_data (ebl, ehdr, phdr->p_offset,
 			 elf_getdata_rawchunk (ebl->elf,
@@ -9056,26 +9443,27 @@ hex_dump (const uint8_t *data, size_t len)
   size_t pos = 0;
   while (pos < len)
     {
-      printf ("  0x%08Zx ", pos);
+      fprintf (output, "  0x%08Zx ", pos);
 
       const size_t chunk = MIN (len - pos, 16);
 
       for (size_t i = 0; i < chunk; ++i)
 	if (i % 4 == 3)
-	  printf ("%02x ", data[pos + i]);
+	  fprintf (output, "%02x ", data[pos + i]);
 	else
-	  printf ("%02x", data[pos + i]);
+	  fprintf (output, "%02x", data[pos + i]);
 
       if (chunk < 16)
-	printf ("%*s", (int) ((16 - chunk) * 2 + (16 - chunk + 3) / 4), "");
+	fprintf (output, "%*s",
+		 (int) ((16 - chunk) * 2 + (16 - chunk + 3) / 4), "");
 
       for (size_t i = 0; i < chunk; ++i)
 	{
 	  unsigned char b = data[pos + i];
-	  printf ("%c", isprint (b) ? b : '.');
+	  fprintf (output, "%c", isprint (b) ? b : '.');
 	}
 
-      putchar ('\n');
+      putc ('\n', output);
       pos += chunk;
     }
 }
@@ -9084,8 +9472,8 @@ static void
 dump_data_section (Elf_Scn *scn, const GElf_Shdr *shdr, const char *name)
 {
   if (shdr->sh_size == 0 || shdr->sh_type == SHT_NOBITS)
-    printf (gettext ("\nSection [%Zu] '%s' has no data to dump.\n"),
-	    elf_ndxscn (scn), name);
+    fprintf (output, gettext ("\nSection [%Zu] '%s' has no data to dump.\n"),
+	     elf_ndxscn (scn), name);
   else
     {
       Elf_Data *data = elf_rawdata (scn, NULL);
@@ -9094,10 +9482,11 @@ dump_data_section (Elf_Scn *scn, const GElf_Shdr *shdr, const char *name)
 	       elf_ndxscn (scn), name, elf_errmsg (-1));
       else
 	{
-	  printf (gettext ("\nHex dump of section [%Zu] '%s', %" PRIu64
-			   " bytes at offset %#0" PRIx64 ":\n"),
-		  elf_ndxscn (scn), name,
-		  shdr->sh_size, shdr->sh_offset);
+	  fprintf (output,
+		   gettext ("\nHex dump of section [%Zu] '%s', %" PRIu64
+			    " bytes at offset %#0" PRIx64 ":\n"),
+		   elf_ndxscn (scn), name,
+		   shdr->sh_size, shdr->sh_offset);
 	  hex_dump (data->d_buf, data->d_size);
 	}
     }
@@ -9107,8 +9496,9 @@ static void
 print_string_section (Elf_Scn *scn, const GElf_Shdr *shdr, const char *name)
 {
   if (shdr->sh_size == 0 || shdr->sh_type == SHT_NOBITS)
-    printf (gettext ("\nSection [%Zu] '%s' has no strings to dump.\n"),
-	    elf_ndxscn (scn), name);
+    fprintf (output,
+	     gettext ("\nSection [%Zu] '%s' has no strings to dump.\n"),
+	     elf_ndxscn (scn), name);
   else
     {
       Elf_Data *data = elf_rawdata (scn, NULL);
@@ -9117,10 +9507,11 @@ print_string_section (Elf_Scn *scn, const GElf_Shdr *shdr, const char *name)
 	       elf_ndxscn (scn), name, elf_errmsg (-1));
       else
 	{
-	  printf (gettext ("\nString section [%Zu] '%s' contains %" PRIu64
-			   " bytes at offset %#0" PRIx64 ":\n"),
-		  elf_ndxscn (scn), name,
-		  shdr->sh_size, shdr->sh_offset);
+	  fprintf (output,
+		   gettext ("\nString section [%Zu] '%s' contains %" PRIu64
+			    " bytes at offset %#0" PRIx64 ":\n"),
+		   elf_ndxscn (scn), name,
+		   shdr->sh_size, shdr->sh_offset);
 
 	  const char *start = data->d_buf;
 	  const char *const limit = start + data->d_size;
@@ -9130,11 +9521,11 @@ print_string_section (Elf_Scn *scn, const GElf_Shdr *shdr, const char *name)
 	      const size_t pos = start - (const char *) data->d_buf;
 	      if (unlikely (end == NULL))
 		{
-		  printf ("  [%6Zx]- %.*s\n",
-			  pos, (int) (limit - start), start);
+		  fprintf (output, "  [%6Zx]- %.*s\n",
+			   pos, (int) (limit - start), start);
 		  break;
 		}
-	      printf ("  [%6Zx]  %s\n", pos, start);
+	      fprintf (output, "  [%6Zx]  %s\n", pos, start);
 	      start = end + 1;
 	    } while (start < limit);
 	}
@@ -9254,12 +9645,13 @@ dump_archive_index (Elf *elf, const char *fname)
 	       gettext ("cannot get symbol index of archive '%s': %s"),
 	       fname, elf_errmsg (result));
       else
-	printf (gettext ("\nArchive '%s' has no symbol index\n"), fname);
+	fprintf (output, gettext ("\nArchive '%s' has no symbol index\n"),
+		 fname);
       return;
     }
 
-  printf (gettext ("\nIndex of archive '%s' has %Zu entries:\n"),
-	  fname, narsym);
+  fprintf (output, gettext ("\nIndex of archive '%s' has %Zu entries:\n"),
+	   fname, narsym);
 
   size_t as_off = 0;
   for (const Elf_Arsym *s = arsym; s < &arsym[narsym - 1]; ++s)
@@ -9281,12 +9673,13 @@ dump_archive_index (Elf *elf, const char *fname)
 
 	  const Elf_Arhdr *h = elf_getarhdr (subelf);
 
-	  printf (gettext ("Archive member '%s' contains:\n"), h->ar_name);
+	  fprintf (output, gettext ("Archive member '%s' contains:\n"),
+		   h->ar_name);
 
 	  elf_end (subelf);
 	}
 
-      printf ("\t%s\n", s->as_name);
+      fprintf (output, "\t%s\n", s->as_name);
     }
 }
 
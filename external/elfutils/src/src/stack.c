@@ -26,6 +26,7 @@
 #include <string.h>
 #include <locale.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include ELFUTILS_HEADER(dwfl)
 
 #include <dwarf.h>
@@ -52,6 +53,8 @@ static bool show_inlines = false;
 
 static int maxframes = 256;
 
+static int jobs = 1;
+
 struct frame
 {
   Dwarf_Addr pc;
@@ -435,6 +438,128 @@ print_frames (struct frames *frames, pid_t tid, int dwflerr, const char *what)
     }
 }
 
+struct thread_frames
+{
+  pid_t tid;
+  int err;
+  struct frames frames;
+};
+
+struct unwind_jobs
+{
+  struct thread_frames *threads;
+  size_t nthreads;
+  size_t allocated;
+  size_t next;
+};
+
+static int
+collect_thread (Dwfl_Thread *thread, void *arg)
+{
+  struct unwind_jobs *uj = (struct unwind_jobs *) arg;
+  if (uj->nthreads == uj->allocated)
+    {
+      uj->allocated = uj->allocated == 0 ? 64 : uj->allocated * 2;
+      uj->threads = realloc (uj->threads,
+			     sizeof (struct thread_frames) * uj->allocated);
+      if (uj->threads == NULL)
+	error (EXIT_BAD, errno, "realloc threads");
+    }
+  uj->threads[uj->nthreads++].tid = dwfl_thread_tid (thread);
+  return DWARF_CB_OK;
+}
+
+static int
+prepare_module (Dwfl_Module *mod, void **userdata __attribute__((unused)),
+		const char *name __attribute__((unused)), Dwarf_Addr start,
+		void *arg __attribute__((unused)))
+{
+  
+  Dwarf_Addr bias;
+  (void) dwfl_addrmodule (dwfl, start);
+  (void) dwfl_module_eh_cfi (mod, &bias);
+  (void) dwfl_module_dwarf_cfi (mod, &bias);
+  return DWARF_CB_OK;
+}
+
+static void *
+unwind_worker (void *arg)
+{
+  struct unwind_jobs *uj = (struct unwind_jobs *) arg;
+  size_t i;
+  while ((i = __atomic_fetch_add (&uj->next, 1, __ATOMIC_RELAXED))
+	 < uj->nthreads)
+    {
+      struct thread_frames *tf = &uj->threads[i];
+      tf->err = 0;
+      switch (dwfl_getthread_frames (dwfl, tf->tid, frame_callback,
+				     &tf->frames))
+	{
+	case DWARF_CB_OK:
+	case DWARF_CB_ABORT:
+	  break;
+	case -1:
+	  tf->err = dwfl_errno ();
+	  break;
+	default:
+	  abort ();
+	}
+    }
+  return NULL;
+}
+
+static void
+unwind_threads_parallel (void)
+{
+  struct unwind_jobs uj = { .threads = NULL };
+  switch (dwfl_getthreads (dwfl, collect_thread, &uj))
+    {
+    case DWARF_CB_OK:
+    case DWARF_CB_ABORT:
+      break;
+    case -1:
+      error (0, 0, "dwfl_getthreads: %s", dwfl_errmsg (-1));
+      break;
+    default:
+      abort ();
+    }
+
+  
+  if (dwfl_getmodules (dwfl, prepare_module, NULL, 0) != 0)
+    error (EXIT_BAD, 0, "dwfl_getmodules: %s", dwfl_errmsg (-1));
+
+  for (size_t i = 0; i < uj.nthreads; i++)
+    {
+      struct frames *frames = &uj.threads[i].frames;
+      frames->allocated = maxframes == 0 ? 2048 : maxframes;
+      frames->frames = 0;
+      frames->frame = malloc (sizeof (struct frame) * frames->allocated);
+      if (frames->frame == NULL)
+	error (EXIT_BAD, errno, "malloc frames.frame");
+    }
+
+  
+  size_t nworkers = (size_t) jobs < uj.nthreads ? (size_t) jobs : uj.nthreads;
+  pthread_t workers[nworkers];
+  for (size_t w = 1; w < nworkers; w++)
+    {
+      int err = pthread_create (&workers[w], NULL, unwind_worker, &uj);
+      if (err != 0)
+	error (EXIT_BAD, err, "pthread_create");
+    }
+  unwind_worker (&uj);
+  for (size_t w = 1; w < nworkers; w++)
+    pthread_join (workers[w], NULL);
+
+  for (size_t i = 0; i < uj.nthreads; i++)
+    {
+      struct thread_frames *tf = &uj.threads[i];
+      print_frames (&tf->frames, tf->tid, tf->err, "dwfl_getthread_frames");
+      free (tf->frames.frame);
+    }
+  free (uj.threads);
+}
+
 static int
 thread_callback (Dwfl_Thread *thread, void *thread_arg)
 {
@@ -547,6 +672,19 @@ parse_opt (int key, char *arg __attribute__ ((unused)),
       show_modules = true;
       break;
 
+    case 'j':
+      jobs = atoi (arg);
+      if (jobs < 1)
+	{
+	  argp_error (state, N_("-j JOBS should be 1 or higher."));
+	  return EINVAL;
+	}
+#ifndef USE_LOCKS
+      
+      jobs = 1;
+#endif
+      break;
+
     case ARGP_KEY_END:
       if (core == NULL && exec != NULL)
 	argp_error (state,
@@ -661,6 +799,8 @@ main (int argc, char **argv)
 	N_("Show at most MAXFRAMES per thread (default 256, use 0 for unlimited)"), 0 },
       { "list-modules", 'l', NULL, 0,
 	N_("Show module memory map with build-id, elf and debug files detected"), 0 },
+      { "jobs", 'j', "JOBS", 0,
+	N_("Unwind the threads of process PID with JOBS concurrent jobs (default 1)"), 0 },
       { NULL, 0, NULL, 0, NULL, 0 }
     };
 
@@ -713,17 +853,20 @@ invoked with bad or missing arguments it will exit with return code 64.")
   else
     {
       printf ("PID %d - %s\n", dwfl_pid (dwfl), pid != 0 ? "process" : "core");
-      switch (dwfl_getthreads (dwfl, thread_callback, &frames))
-	{
-	case DWARF_CB_OK:
-	case DWARF_CB_ABORT:
-	  break;
-	case -1:
-	  error (0, 0, "dwfl_getthreads: %s", dwfl_errmsg (-1));
-	  break;
-	default:
-	  abort ();
-	}
+      if (jobs > 1 && pid != 0)
+	unwind_threads_parallel ();
+      else
+	switch (dwfl_getthreads (dwfl, thread_callback, &frames))
+	  {
+	  case DWARF_CB_OK:
+	  case DWARF_CB_ABORT:
+	    break;
+	  case -1:
+	    error (0, 0, "dwfl_getthreads: %s", dwfl_errmsg (-1));
+	    break;
+	  default:
+	    abort ();
+	  }
     }
   free (frames.frame);
   dwfl_end (dwfl);
@@ -57,6 +57,7 @@ ARGP_PROGRAM_BUG_ADDRESS_DEF = PACKAGE_BUGREPORT;
 #define OPT_PERMISSIVE		0x101
 #define OPT_STRIP_SECTIONS	0x102
 #define OPT_RELOC_DEBUG 	0x103
+#define OPT_COMPRESS_DEBUG	0x104
 
 
 static const struct argp_option options[] =
@@ -77,6 +78,8 @@ static const struct argp_option options[] =
     N_("Copy modified/access timestamps to the output"), 0 },
   { "reloc-debug-sections", OPT_RELOC_DEBUG, NULL, 0,
     N_("Resolve all trivial relocations between debug sections if the removed sections are placed in a debug file (only relevant for ET_REL files, operation is not reversable, needs -f)"), 0 },
+  { "compress-debug-sections", OPT_COMPRESS_DEBUG, "TYPE", OPTION_ARG_OPTIONAL,
+    N_("Compress the debug sections placed in the debug file with TYPE, which is 'zlib' (the default) or 'none' (needs -f)"), 0 },
   { "remove-comment", OPT_REMOVE_COMMENT, NULL, 0,
     N_("Remove .comment section"), 0 },
   { "remove-section", 'R', "SECTION", OPTION_HIDDEN, NULL, 0 },
@@ -129,6 +132,9 @@ static bool permissive;
 static bool reloc_debug;
 
 
+static int compress_debug_type = -1;
+
+
 int
 main (int argc, char *argv[])
 {
@@ -160,6 +166,10 @@ main (int argc, char *argv[])
     error (EXIT_FAILURE, 0,
 	   gettext ("--reloc-debug-sections used without -f"));
 
+  if (compress_debug_type >= 0 && debug_fname == NULL)
+    error (EXIT_FAILURE, 0,
+	   gettext ("--compress-debug-sections used without -f"));
+
   
   elf_version (EV_CURRENT);
 
@@ -236,6 +246,19 @@ parse_opt (int key, char *arg, struct argp_state *state)
       reloc_debug = true;
       break;
 
+    case OPT_COMPRESS_DEBUG:
+      if (arg == NULL || strcmp (arg, "zlib") == 0)
+	compress_debug_type = ELFCOMPRESS_ZLIB;
+      else if (strcmp (arg, "none") == 0)
+	compress_debug_type = 0;
+      else
+	{
+	  argp_error (state,
+		      gettext ("unknown compression type '%s'"), arg);
+	  return EINVAL;
+	}
+      break;
+
     case OPT_REMOVE_COMMENT:
       remove_comment = true;
       break;
@@ -1503,7 +1526,7 @@ handle_elf (int fd, Elf *elf, const char *prefix, const char *fname,
 	      GElf_Shdr *tshdr = gelf_getshdr (tscn, &tshdr_mem);
 	      if (tshdr->sh_type == SHT_NOBITS
 		  || tshdr->sh_size == 0
-		  || (tshdr->sh_flags & SHF_ALLOC) != 0)
+		  || (tshdr->sh_flags & (SHF_ALLOC | SHF_COMPRESSED)) != 0)
 		continue;
 
 	      const char *tname =  elf_strptr (debugelf, shstrndx,
@@ -1669,6 +1692,43 @@ handle_elf (int fd, Elf *elf, const char *prefix, const char *fname,
 	}
     }
 
+  if (debug_fname != NULL && compress_debug_type >= 0)
+    for (cnt = 1; cnt < shnum; ++cnt)
+      {
+	scn = elf_getscn (debugelf, cnt);
+	GElf_Shdr shdr_mem;
+	GElf_Shdr *shdr = gelf_getshdr (scn, &shdr_mem);
+	if (shdr == NULL)
+	  INTERNAL_ERROR (fname);
+
+	if (shdr->sh_type == SHT_NOBITS
+	    || (shdr->sh_flags & SHF_ALLOC) != 0
+	    || ((shdr->sh_flags & SHF_COMPRESSED) != 0)
+	       == (compress_debug_type != 0)
+	    || shdr_info[cnt].name == NULL
+	    || strncmp (shdr_info[cnt].name, ".debug", 6) != 0)
+	  continue;
+
+	
+	void *debug_buf = (shdr_info[cnt].debug_data != NULL
+			   ? shdr_info[cnt].debug_data->d_buf : NULL);
+
+	int zrc = elf_compress (scn, compress_debug_type, 0);
+	if (zrc < 0)
+	  {
+	    error (0, 0, gettext ("while compressing section '%s': %s"),
+		   shdr_info[cnt].name, elf_errmsg (-1));
+	    result = 1;
+	    goto fail_close;
+	  }
+
+	if (zrc > 0)
+	  {
+	    free (debug_buf);
+	    shdr_info[cnt].debug_data = NULL;
+	  }
+      }
+
   if (debug_fname != NULL)
     {
       
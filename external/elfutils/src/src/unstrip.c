@@ -53,6 +53,8 @@ ARGP_PROGRAM_VERSION_HOOK_DEF = print_version;
 
 ARGP_PROGRAM_BUG_ADDRESS_DEF = PACKAGE_BUGREPORT;
 
+#define OPT_COMPRESS_DEBUG	0x100
+
 static const struct argp_option options[] =
 {
   
@@ -75,6 +77,9 @@ static const struct argp_option options[] =
  { "force", 'F', NULL, 0,
     N_("Force combining files even if some ELF headers don't seem to match"),
    0 },
+  { "compress-debug-sections", OPT_COMPRESS_DEBUG, "TYPE", OPTION_ARG_OPTIONAL,
+    N_("Compress the .debug sections of the output with TYPE, which is 'zlib' (the default) or 'none'"),
+    0 },
   { NULL, 0, NULL, 0, NULL, 0 }
 };
 
@@ -93,6 +98,9 @@ struct arg_info
   bool force;
 };
 
+
+static int compress_debug_type = -1;
+
 static error_t
 parse_opt (int key, char *arg, struct argp_state *state)
 {
@@ -144,6 +152,18 @@ parse_opt (int key, char *arg, struct argp_state *state)
       info->force = true;
       break;
 
+    case OPT_COMPRESS_DEBUG:
+      if (arg == NULL || strcmp (arg, "zlib") == 0)
+	compress_debug_type = ELFCOMPRESS_ZLIB;
+      else if (strcmp (arg, "none") == 0)
+	compress_debug_type = 0;
+      else
+	{
+	  argp_error (state, _("unknown compression type '%s'"), arg);
+	  return EINVAL;
+	}
+      break;
+
     case ARGP_KEY_ARGS:
     case ARGP_KEY_NO_ARGS:
       
@@ -1697,6 +1717,21 @@ more sections in stripped file than debug file -- arguments reversed?"));
 	    GElf_Shdr *shdr = gelf_getshdr (scn, &shdr_mem);
 	    ELF_CHECK (shdr != NULL, _("cannot get section header: %s"));
 
+	    if (compress_debug_type >= 0
+		&& shdr->sh_type == SHT_PROGBITS
+		&& (shdr->sh_flags & SHF_ALLOC) == 0
+		&& ((shdr->sh_flags & SHF_COMPRESSED) != 0)
+		   != (compress_debug_type != 0)
+		&& strncmp (get_section_name (1 + i, shdr,
+					      strtab_data ?: shstrtab),
+			    ".debug", strlen (".debug")) == 0)
+	      {
+		ELF_CHECK (elf_compress (scn, compress_debug_type, 0) >= 0,
+			   _("cannot compress section data: %s"));
+		shdr = gelf_getshdr (scn, &shdr_mem);
+		ELF_CHECK (shdr != NULL, _("cannot get section header: %s"));
+	      }
+
 	    /* We must make sure we have read in the data of all sections
 	       beforehand and marked them to be written out.  When we're
 	       modifying the existing file in place, we might overwrite
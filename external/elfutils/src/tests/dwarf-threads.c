@@ -0,0 +1,286 @@
+/* Test program for concurrent readers of one Dwarf handle.
+   Copyright (C) 2015 Red Hat, Inc.
+   This file is part of elfutils.
+
+   This file is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   elfutils is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include ELFUTILS_HEADER(dw)
+#include <dwarf.h>
+#include <errno.h>
+#include <error.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#ifdef USE_LOCKS
+
+/* Number of times a fresh Dwarf handle is shared between the threads.
+   Every round starts with cold caches so the threads race to fill them.  */
+#define ROUNDS 50
+
+struct worker
+{
+  Dwarf *dbg;
+  Dwarf_CFI *cfi_eh;
+  pthread_barrier_t *barrier;
+  unsigned int index;
+  uint64_t sum;
+};
+
+static uint64_t
+mix (uint64_t h, uint64_t v)
+{
+  v *= 0x9e3779b97f4a7c15ULL;
+  v ^= v >> 29;
+  return h + (v ^ (h << 7));
+}
+
+static int
+macro_cb (Dwarf_Macro *macro, void *arg)
+{
+  uint64_t *sum = arg;
+  unsigned int opcode;
+  if (dwarf_macro_opcode (macro, &opcode) == 0)
+    *sum = mix (*sum, opcode);
+  return DWARF_CB_OK;
+}
+
+/* Fold everything the read-side calls return for ADDR into an
+   order-independent checksum.  */
+static uint64_t
+check_addr (Dwarf *dbg, Dwarf_CFI *cfi, Dwarf_CFI *cfi_eh, Dwarf_Addr addr)
+{
+  uint64_t h = addr;
+
+  Dwarf_Die cudie;
+  if (dwarf_addrdie (dbg, addr, &cudie) != NULL)
+    {
+      h = mix (h, dwarf_dieoffset (&cudie));
+
+      Dwarf_Die *scopes = NULL;
+      int nscopes = dwarf_getscopes (&cudie, addr, &scopes);
+      h = mix (h, nscopes);
+      for (int i = 0; i < nscopes; ++i)
+	{
+	  h = mix (h, dwarf_dieoffset (&scopes[i]));
+	  h = mix (h, dwarf_tag (&scopes[i]));
+	  const char *file = dwarf_decl_file (&scopes[i]);
+	  for (; file != NULL && *file != '\0'; ++file)
+	    h = mix (h, *file);
+
+	  Dwarf_Attribute attr;
+	  Dwarf_Op *expr;
+	  size_t exprlen;
+	  if (dwarf_attr (&scopes[i], DW_AT_frame_base, &attr) != NULL
+	      && dwarf_getlocation_addr (&attr, addr, &expr, &exprlen, 1) == 1)
+	    for (size_t j = 0; j < exprlen; ++j)
+	      h = mix (h, expr[j].atom);
+	}
+      free (scopes);
+
+      Dwarf_Line *line = dwarf_getsrc_die (&cudie, addr);
+      int lineno;
+      if (line != NULL && dwarf_lineno (line, &lineno) == 0)
+	h = mix (h, lineno);
+    }
+
+  Dwarf_CFI *caches[] = { cfi, cfi_eh };
+  for (size_t i = 0; i < sizeof caches / sizeof caches[0]; ++i)
+    {
+      Dwarf_Frame *frame;
+      if (caches[i] == NULL
+	  || dwarf_cfi_addrframe (caches[i], addr, &frame) != 0)
+	continue;
+
+      Dwarf_Addr start, end;
+      bool signalp;
+      h = mix (h, dwarf_frame_info (frame, &start, &end, &signalp));
+      h = mix (h, start);
+      h = mix (h, end);
+
+      Dwarf_Op *ops;
+      size_t nops;
+      if (dwarf_frame_cfa (frame, &ops, &nops) == 0)
+	for (size_t j = 0; j < nops; ++j)
+	  h = mix (h, ops[j].atom + ops[j].number);
+      free (frame);
+    }
+
+  return h;
+}
+
+static uint64_t
+check_dwarf (Dwarf *dbg, Dwarf_CFI *cfi_eh, unsigned int first)
+{
+  uint64_t sum = 0;
+
+  /* Count the units first so every thread can start at a different
+     one and hit the lazy caches in a different order.  */
+  size_t ncus = 0;
+  Dwarf_Off off = 0;
+  Dwarf_Off next;
+  size_t hsize;
+  while (dwarf_nextcu (dbg, off, &next, &hsize, NULL, NULL, NULL) == 0)
+    {
+      ++ncus;
+      off = next;
+    }
+
+  Dwarf_Aranges *aranges;
+  size_t naranges;
+  if (dwarf_getaranges (dbg, &aranges, &naranges) == 0)
+    sum = mix (sum, naranges);
+
+  Dwarf_CFI *cfi = dwarf_getcfi (dbg);
+
+  for (size_t n = 0; n < ncus; ++n)
+    {
+      size_t want = (n + first) % ncus;
+      off = 0;
+      for (size_t i = 0; i <= want; ++i)
+	{
+	  if (dwarf_nextcu (dbg, off, &next, &hsize, NULL, NULL, NULL) != 0)
+	    error (EXIT_FAILURE, 0, "dwarf_nextcu: %s", dwarf_errmsg (-1));
+	  if (i < want)
+	    off = next;
+	}
+
+      Dwarf_Die cudie;
+      if (dwarf_offdie (dbg, off + hsize, &cudie) == NULL)
+	error (EXIT_FAILURE, 0, "dwarf_offdie: %s", dwarf_errmsg (-1));
+
+      uint64_t h = off;
+      Dwarf_Files *files;
+      size_t nfiles;
+      if (dwarf_getsrcfiles (&cudie, &files, &nfiles) == 0)
+	h = mix (h, nfiles);
+
+      ptrdiff_t token = 0;
+      while ((token = dwarf_getmacros (&cudie, macro_cb, &h, token)) > 0)
+	;
+      sum += h;
+
+      Dwarf_Lines *lines;
+      size_t nlines;
+      if (dwarf_getsrclines (&cudie, &lines, &nlines) != 0)
+	continue;
+
+      for (size_t i = 0; i < nlines; ++i)
+	{
+	  Dwarf_Addr addr;
+	  if (dwarf_lineaddr (dwarf_onesrcline (lines, i), &addr) == 0)
+	    sum += check_addr (dbg, cfi, cfi_eh, addr);
+	}
+    }
+
+  return sum;
+}
+
+static void *
+worker_thread (void *arg)
+{
+  struct worker *w = arg;
+  pthread_barrier_wait (w->barrier);
+  w->sum = check_dwarf (w->dbg, w->cfi_eh, w->index);
+  return NULL;
+}
+
+int
+main (int argc, char *argv[])
+{
+  if (argc < 2)
+    error (EXIT_FAILURE, 0, "usage: %s FILE [THREADS]", argv[0]);
+
+  unsigned int nthreads = argc > 2 ? atoi (argv[2]) : 8;
+  if (nthreads == 0)
+    nthreads = 1;
+
+  int fd = open (argv[1], O_RDONLY);
+  if (fd < 0)
+    error (EXIT_FAILURE, errno, "cannot open '%s'", argv[1]);
+
+  /* The reference checksum comes from a private handle used by a
+     single thread.  */
+  Dwarf *dbg = dwarf_begin (fd, DWARF_C_READ);
+  if (dbg == NULL)
+    error (EXIT_FAILURE, 0, "dwarf_begin: %s", dwarf_errmsg (-1));
+  Dwarf_CFI *cfi_eh = dwarf_getcfi_elf (dwarf_getelf (dbg));
+  uint64_t expected = check_dwarf (dbg, cfi_eh, 0);
+  dwarf_cfi_end (cfi_eh);
+  dwarf_end (dbg);
+
+  struct worker workers[nthreads];
+  pthread_t threads[nthreads];
+  pthread_barrier_t barrier;
+  int result = EXIT_SUCCESS;
+
+  for (unsigned int round = 0; round < ROUNDS; ++round)
+    {
+      dbg = dwarf_begin (fd, DWARF_C_READ);
+      if (dbg == NULL)
+	error (EXIT_FAILURE, 0, "dwarf_begin: %s", dwarf_errmsg (-1));
+      cfi_eh = dwarf_getcfi_elf (dwarf_getelf (dbg));
+
+      pthread_barrier_init (&barrier, NULL, nthreads);
+      for (unsigned int i = 0; i < nthreads; ++i)
+	{
+	  workers[i].dbg = dbg;
+	  workers[i].cfi_eh = cfi_eh;
+	  workers[i].barrier = &barrier;
+	  workers[i].index = i + round;
+	  workers[i].sum = 0;
+	  int err = pthread_create (&threads[i], NULL, worker_thread,
+				    &workers[i]);
+	  if (err != 0)
+	    error (EXIT_FAILURE, err, "pthread_create");
+	}
+
+      for (unsigned int i = 0; i < nthreads; ++i)
+	{
+	  pthread_join (threads[i], NULL);
+	  if (workers[i].sum != expected)
+	    {
+	      printf ("round %u thread %u: checksum %#" PRIx64
+		      " expected %#" PRIx64 "\n",
+		      round, i, workers[i].sum, expected);
+	      result = EXIT_FAILURE;
+	    }
+	}
+      pthread_barrier_destroy (&barrier);
+
+      dwarf_cfi_end (cfi_eh);
+      dwarf_end (dbg);
+    }
+
+  close (fd);
+  return result;
+}
+
+#else
+
+int
+main (void)
+{
+  /* Without --enable-thread-safety concurrent use is not supported.  */
+  return 77;
+}
+
+#endif
@@ -74,7 +74,12 @@ static struct
       "program header only allowed in executables, shared objects, \
 and core files" },
     { ELF_E_NO_PHDR, "file has no program header" },
-    { ELF_E_INVALID_OFFSET, "invalid offset" }
+    { ELF_E_INVALID_OFFSET, "invalid offset" },
+    { ELF_E_NOT_COMPRESSED, "section not compressed" },
+    { ELF_E_ALREADY_COMPRESSED, "section already compressed" },
+    { ELF_E_UNKNOWN_COMPRESSION_TYPE, "unknown compression type" },
+    { ELF_E_COMPRESS_ERROR, "compression error" },
+    { ELF_E_DECOMPRESS_ERROR, "decompression error" }
   };
 
 
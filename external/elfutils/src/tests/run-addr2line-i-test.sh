@@ -144,4 +144,41 @@ _Z2fuv
 /tmp/x.cpp:33
 EOF
 
+# Batch mode sorts and groups the addresses, but keeps the input order.
+tempfiles addr2line.in addr2line.line addr2line.batch
+for a in 5f2 5a0 5e1 5f2 5b0 5c0 5a1 5f0 5d0 5a0 5b1 5e0 5f1; do
+  echo 0x0000000000000$a
+done > addr2line.in
+
+testrun_compare ${abs_top_builddir}/src/addr2line -i -e testfile-inlines --batch=addr2line.in <<\EOF
+/tmp/x.cpp:5
+/tmp/x.cpp:33
+/tmp/x.cpp:5
+/tmp/x.cpp:10
+/tmp/x.cpp:20
+/tmp/x.cpp:26
+/tmp/x.cpp:5
+/tmp/x.cpp:33
+/tmp/x.cpp:10
+/tmp/x.cpp:5
+/tmp/x.cpp:15
+/tmp/x.cpp:6
+/tmp/x.cpp:31
+/tmp/x.cpp:10
+/tmp/x.cpp:20
+/tmp/x.cpp:5
+/tmp/x.cpp:11
+/tmp/x.cpp:5
+/tmp/x.cpp:15
+/tmp/x.cpp:25
+/tmp/x.cpp:10
+/tmp/x.cpp:32
+EOF
+
+testrun ${abs_top_builddir}/src/addr2line -f -i -e testfile-inlines < addr2line.in > addr2line.line
+for threads in 1 3; do
+  testrun ${abs_top_builddir}/src/addr2line -f -i -e testfile-inlines --batch --threads=$threads < addr2line.in > addr2line.batch
+  cmp addr2line.line addr2line.batch || exit 1
+done
+
 exit 0
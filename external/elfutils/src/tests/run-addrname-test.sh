@@ -211,6 +211,19 @@ local_outer+0x9
 ??:0
 EOF
 
+# Sizeless symbols run up to the next symbol, sized ones stop at their end.
+testrun_compare ${abs_top_builddir}/src/addr2line -S -e testfile49 \
+		0xa 0xb 0x10c 0x1ff <<\EOF
+sizeless_x+0x1
+??:0
+sizeless_x+0x2
+??:0
+(.text)+0x10c
+??:0
+(.text)+0x1ff
+??:0
+EOF
+
 #	.macro global label size
 #\label:	.globl \label
 #	.size \label, \size
@@ -292,6 +305,27 @@ l0local2
 ??:0
 EOF
 
+# Just past symbol ends, where only the longest symbol of each group
+# still covers the address.
+testrun_compare ${abs_top_builddir}/src/addr2line -S -e testfile64 0 2 3 6 7 10 11 13 <<\EOF
+_start
+??:0
+gglobal1+0x1
+??:0
+(.text)+0x3
+??:0
+wweak1+0x1
+??:0
+(.text)+0x7
+??:0
+llocal1+0x1
+??:0
+(.text)+0xb
+??:0
+l0local2+0x1
+??:0
+EOF
+
 testfiles testfile65
 testrun_compare ${abs_top_builddir}/src/addr2line -S --core=testfile65 0x7fff94bffa30 <<\EOF
 __vdso_time
@@ -333,6 +367,31 @@ _start (.opd)
 ??:0
 EOF
 
+# testfile72 is testfile66 with the function descriptor of _start (and
+# its R_PPC64_RELATIVE addend) changed to point at 0x103e0, above the
+# descriptor itself.  Addresses below the entry point must not match.
+testfiles testfile72
+testrun_compare ${abs_top_builddir}/src/addr2line -x -e testfile72 _start 0x103cf 0x103d0 0x103d3 0x103df 0x103e0 0x103e3 0x103e4 0x2d8 <<\EOF
+_start (.opd)
+??:0
+()+0x103cf
+??:0
+()+0x103d0
+??:0
+()+0x103d3
+??:0
+()+0x103df
+??:0
+_start (.opd)
+??:0
+_start+0x3 (.opd)
+??:0
+()+0x103e4
+??:0
+()+0x2d8
+??:0
+EOF
+
 testfiles testfile69.core testfile69.so
 testrun_compare ${abs_top_builddir}/src/addr2line --core=./testfile69.core -S 0x7f0bc6a33535 0x7f0bc6a33546 <<\EOF
 libstatic+0x9
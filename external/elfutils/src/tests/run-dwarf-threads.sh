@@ -0,0 +1,28 @@
+#! /bin/sh
+# Copyright (C) 2015 Red Hat, Inc.
+# This file is part of elfutils.
+#
+# This file is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# elfutils is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+. $srcdir/test-subr.sh
+
+# Several threads share one Dwarf handle and must see the same
+# results as a single reader.
+testfiles testfile11 testfile12 testfile51 testfileppc64
+
+for file in testfile11 testfile12 testfile51 testfileppc64; do
+  testrun ${abs_builddir}/dwarf-threads $file 8
+done
+
+exit 0
@@ -0,0 +1,37 @@
+#! /bin/sh
+# Copyright (C) 2015 Red Hat, Inc.
+# This file is part of elfutils.
+#
+# This file is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# elfutils is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+. $srcdir/test-subr.sh
+
+# readelf and elflint -j must print exactly what a single job prints,
+# whatever order the sections and DWARF units were processed in.
+testfiles testfile testfile11 testfile12 testfile47 testfileloc testfileppc64
+
+tempfiles jobs1.out jobs4.out
+
+status=0
+for file in testfile testfile11 testfile12 testfile47 testfileloc testfileppc64; do
+  testrun ${abs_top_builddir}/src/readelf -r -s -w $file > jobs1.out
+  testrun ${abs_top_builddir}/src/readelf -j4 -r -s -w $file > jobs4.out
+  cmp jobs1.out jobs4.out || status=1
+
+  testrun ${abs_top_builddir}/src/elflint --gnu-ld $file > jobs1.out || :
+  testrun ${abs_top_builddir}/src/elflint -j4 --gnu-ld $file > jobs4.out || :
+  cmp jobs1.out jobs4.out || status=1
+done
+
+exit $status
@@ -0,0 +1,60 @@
+#! /bin/sh
+# Copyright (C) 2015 Red Hat, Inc.
+# This file is part of elfutils.
+#
+# This file is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# elfutils is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+. $srcdir/test-subr.sh
+
+# Strip with and without --compress-debug-sections.  The compressed
+# debug file must read back the same DWARF, pass elflint and unstrip
+# (decompressing again) to exactly what the plain debug file gives.
+# Covers 32/64-bit, both byte orders and ET_REL files that need
+# relocating after decompression.
+testfiles testfile testfile2 testfile23 testfile30 testfile47
+
+tempfiles plain.stripped plain.debug plain.unstrip plain.w plain.lint
+tempfiles zlib.stripped zlib.debug zlib.unstrip zlib.w zlib.lint
+tempfiles zlib.sections
+
+status=0
+for file in testfile testfile2 testfile23 testfile30 testfile47; do
+  testrun ${abs_top_builddir}/src/strip -o plain.stripped -f plain.debug $file
+  testrun ${abs_top_builddir}/src/strip --compress-debug-sections \
+	  -o zlib.stripped -f zlib.debug $file
+
+  # Sections are only compressed when that makes them smaller.
+  testrun ${abs_top_builddir}/src/readelf -S zlib.debug > zlib.sections
+  grep -q ' \.debug_.* C ' zlib.sections || status=1
+
+  # elflint must not find anything it does not find in the plain file.
+  testrun ${abs_top_builddir}/src/elflint -q -d plain.debug > plain.lint 2>&1 || :
+  testrun ${abs_top_builddir}/src/elflint -q -d zlib.debug > zlib.lint 2>&1 || :
+  cmp plain.lint zlib.lint || status=1
+
+  # Apart from the section offsets the DWARF is the same.
+  testrun ${abs_top_builddir}/src/readelf -w plain.debug \
+    | sed 's/ at offset 0x[0-9a-f]*:/:/' > plain.w
+  testrun ${abs_top_builddir}/src/readelf -w zlib.debug \
+    | sed 's/ at offset 0x[0-9a-f]*:/:/' > zlib.w
+  cmp plain.w zlib.w || status=1
+
+  testrun ${abs_top_builddir}/src/unstrip -o plain.unstrip \
+	  plain.stripped plain.debug
+  testrun ${abs_top_builddir}/src/unstrip --compress-debug-sections=none \
+	  -o zlib.unstrip zlib.stripped zlib.debug
+  cmp plain.unstrip zlib.unstrip || status=1
+done
+
+exit $status
@@ -342,6 +342,16 @@ void idct16x16_10_add_12_sse2(const tran_low_t *in, uint8_t *out, int stride) {
   vpx_highbd_idct16x16_10_add_sse2(in, out, stride, 12);
 }
 #endif  // HAVE_SSE2
+
+#if HAVE_AVX2
+void idct16x16_256_add_10_avx2(const tran_low_t *in, uint8_t *out, int stride) {
+  vpx_highbd_idct16x16_256_add_avx2(in, out, stride, 10);
+}
+
+void idct16x16_256_add_12_avx2(const tran_low_t *in, uint8_t *out, int stride) {
+  vpx_highbd_idct16x16_256_add_avx2(in, out, stride, 12);
+}
+#endif  // HAVE_AVX2
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
 class Trans16x16TestBase {
@@ -922,6 +932,24 @@ INSTANTIATE_TEST_CASE_P(
                    &idct16x16_256_add_12_sse2, 3167, VPX_BITS_12)));
 #endif  // HAVE_SSE2 && CONFIG_VP9_HIGHBITDEPTH && !CONFIG_EMULATE_HARDWARE
 
+#if HAVE_AVX2 && !CONFIG_VP9_HIGHBITDEPTH && !CONFIG_EMULATE_HARDWARE
+INSTANTIATE_TEST_CASE_P(
+    AVX2, Trans16x16DCT,
+    ::testing::Values(
+        make_tuple(&vpx_fdct16x16_sse2,
+                   &vpx_idct16x16_256_add_avx2, 0, VPX_BITS_8)));
+#endif  // HAVE_AVX2 && !CONFIG_VP9_HIGHBITDEPTH && !CONFIG_EMULATE_HARDWARE
+
+#if HAVE_AVX2 && CONFIG_VP9_HIGHBITDEPTH && !CONFIG_EMULATE_HARDWARE
+INSTANTIATE_TEST_CASE_P(
+    AVX2, InvTrans16x16DCT,
+    ::testing::Values(
+        make_tuple(&idct16x16_10,
+                   &idct16x16_256_add_10_avx2, 3167, VPX_BITS_10),
+        make_tuple(&idct16x16_12,
+                   &idct16x16_256_add_12_avx2, 3167, VPX_BITS_12)));
+#endif  // HAVE_AVX2 && CONFIG_VP9_HIGHBITDEPTH && !CONFIG_EMULATE_HARDWARE
+
 #if HAVE_MSA && !CONFIG_VP9_HIGHBITDEPTH && !CONFIG_EMULATE_HARDWARE
 INSTANTIATE_TEST_CASE_P(
     MSA, Trans16x16DCT,
@@ -380,7 +380,11 @@ INSTANTIATE_TEST_CASE_P(
         make_tuple(&vpx_fdct32x32_avx2,
                    &vpx_idct32x32_1024_add_sse2, 0, VPX_BITS_8),
         make_tuple(&vpx_fdct32x32_rd_avx2,
-                   &vpx_idct32x32_1024_add_sse2, 1, VPX_BITS_8)));
+                   &vpx_idct32x32_1024_add_sse2, 1, VPX_BITS_8),
+        make_tuple(&vpx_fdct32x32_c,
+                   &vpx_idct32x32_1024_add_avx2, 0, VPX_BITS_8),
+        make_tuple(&vpx_fdct32x32_rd_c,
+                   &vpx_idct32x32_1024_add_avx2, 1, VPX_BITS_8)));
 #endif  // HAVE_AVX2 && !CONFIG_VP9_HIGHBITDEPTH && !CONFIG_EMULATE_HARDWARE
 
 #if HAVE_MSA && !CONFIG_VP9_HIGHBITDEPTH && !CONFIG_EMULATE_HARDWARE
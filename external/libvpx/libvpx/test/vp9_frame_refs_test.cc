@@ -0,0 +1,276 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./vpx_config.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vpx_encoder.h"
+
+namespace {
+
+const int kWidth = 352;
+const int kHeight = 288;
+const int kBorder = 32;
+const int kNumFrames = 12;
+const uint8_t kGuard = 0xa5;
+
+// A planar I420 frame with a kBorder pixel border around the luma plane and a
+// kBorder / 2 border around the chroma planes, so that the encoder can extend
+// the edges in place instead of copying the frame into its lookahead.
+struct RefCountedFrame {
+  RefCountedFrame() : refs(0), max_refs(0) {}
+
+  void Init(int index) {
+    const int y_stride = kWidth + 2 * kBorder;
+    const int uv_stride = y_stride / 2;
+    const int y_rows = kHeight + 2 * kBorder;
+    const int uv_rows = y_rows / 2;
+
+    y.assign(y_stride * y_rows, 0);
+    u.assign(uv_stride * uv_rows, 0);
+    v.assign(uv_stride * uv_rows, 0);
+
+    memset(&img, 0, sizeof(img));
+    img.fmt = VPX_IMG_FMT_I420;
+    img.bit_depth = 8;
+    img.w = kWidth;
+    img.h = kHeight;
+    img.d_w = kWidth;
+    img.d_h = kHeight;
+    img.x_chroma_shift = 1;
+    img.y_chroma_shift = 1;
+    img.bps = 12;
+    img.stride[VPX_PLANE_Y] = y_stride;
+    img.stride[VPX_PLANE_U] = uv_stride;
+    img.stride[VPX_PLANE_V] = uv_stride;
+    img.planes[VPX_PLANE_Y] = &y[kBorder * y_stride + kBorder];
+    img.planes[VPX_PLANE_U] = &u[kBorder / 2 * uv_stride + kBorder / 2];
+    img.planes[VPX_PLANE_V] = &v[kBorder / 2 * uv_stride + kBorder / 2];
+    img.fb_priv = this;
+
+    // A moving diagonal gradient gives the encoder some motion to find.
+    for (int r = 0; r < kHeight; ++r)
+      for (int c = 0; c < kWidth; ++c)
+        img.planes[VPX_PLANE_Y][r * y_stride + c] =
+            static_cast<uint8_t>((r + c + 3 * index) & 0xff);
+    for (int r = 0; r < kHeight / 2; ++r) {
+      for (int c = 0; c < kWidth / 2; ++c) {
+        img.planes[VPX_PLANE_U][r * uv_stride + c] =
+            static_cast<uint8_t>(128 + ((r - index) & 0x1f));
+        img.planes[VPX_PLANE_V][r * uv_stride + c] =
+            static_cast<uint8_t>(128 - ((c + index) & 0x1f));
+      }
+    }
+  }
+
+  // Fills the rows above and below each plane with kGuard.
+  void SetGuards() {
+    FillRows(&y, 0, kBorder, kGuard);
+    FillRows(&y, kBorder + kHeight, kBorder, kGuard);
+    FillRows(&u, 0, kBorder / 2, kGuard);
+    FillRows(&u, (kBorder + kHeight) / 2, kBorder / 2, kGuard);
+    FillRows(&v, 0, kBorder / 2, kGuard);
+    FillRows(&v, (kBorder + kHeight) / 2, kBorder / 2, kGuard);
+  }
+
+  // Returns true if the rows above and below each plane still hold kGuard.
+  bool GuardsIntact() const {
+    return RowsHold(y, 0, kBorder, kGuard) &&
+           RowsHold(y, kBorder + kHeight, kBorder, kGuard) &&
+           RowsHold(u, 0, kBorder / 2, kGuard) &&
+           RowsHold(u, (kBorder + kHeight) / 2, kBorder / 2, kGuard) &&
+           RowsHold(v, 0, kBorder / 2, kGuard) &&
+           RowsHold(v, (kBorder + kHeight) / 2, kBorder / 2, kGuard);
+  }
+
+  std::vector<uint8_t> y, u, v;
+  vpx_image_t img;
+  int refs;
+  int max_refs;
+
+ private:
+  int Stride(const std::vector<uint8_t> &plane) const {
+    return &plane == &y ? img.stride[VPX_PLANE_Y] : img.stride[VPX_PLANE_U];
+  }
+
+  void FillRows(std::vector<uint8_t> *plane, int row, int rows, uint8_t val) {
+    const int stride = Stride(*plane);
+    memset(&(*plane)[row * stride], val, rows * stride);
+  }
+
+  bool RowsHold(const std::vector<uint8_t> &plane, int row, int rows,
+                uint8_t val) const {
+    const int stride = Stride(plane);
+    for (int i = row * stride; i < (row + rows) * stride; ++i) {
+      if (plane[i] != val)
+        return false;
+    }
+    return true;
+  }
+};
+
+int RetainFrame(void *priv, vpx_codec_frame_buffer_t *fb) {
+  RefCountedFrame *const frame = static_cast<RefCountedFrame *>(fb->priv);
+  int *const total = static_cast<int *>(priv);
+  ++frame->refs;
+  ++*total;
+  if (frame->refs > frame->max_refs)
+    frame->max_refs = frame->refs;
+  return 0;
+}
+
+int ReleaseFrame(void *priv, vpx_codec_frame_buffer_t *fb) {
+  RefCountedFrame *const frame = static_cast<RefCountedFrame *>(fb->priv);
+  int *const total = static_cast<int *>(priv);
+  --frame->refs;
+  --*total;
+  return 0;
+}
+
+// Encodes kNumFrames synthetic frames and returns the concatenated packets.
+// When |total_refs| is non-NULL the frames are handed to the encoder by
+// reference through VP9E_SET_FRAME_BUFFER_REFS, declaring a |border| pixel
+// border around each frame.
+std::string Encode(RefCountedFrame *frames, int *total_refs, int border) {
+  vpx_codec_enc_cfg_t cfg;
+  vpx_codec_ctx_t enc;
+  std::string out;
+
+  EXPECT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_config_default(&vpx_codec_vp9_cx_algo, &cfg, 0));
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  cfg.g_lag_in_frames = 6;
+  cfg.rc_target_bitrate = 300;
+  EXPECT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_init(&enc, &vpx_codec_vp9_cx_algo, &cfg, 0));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP8E_SET_CPUUSED, 4));
+
+  vpx_frame_buffer_refs_t refs;
+  refs.retain_cb = RetainFrame;
+  refs.release_cb = ReleaseFrame;
+  refs.cb_priv = total_refs;
+  refs.border = border;
+  if (total_refs != NULL) {
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&enc, VP9E_SET_FRAME_BUFFER_REFS, &refs));
+  }
+
+  for (int i = 0; i < kNumFrames; ++i) {
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_encode(&enc, &frames[i].img, i, 1, 0,
+                                             VPX_DL_GOOD_QUALITY));
+    vpx_codec_iter_t iter = NULL;
+    const vpx_codec_cx_pkt_t *pkt;
+    while ((pkt = vpx_codec_get_cx_data(&enc, &iter)) != NULL) {
+      if (pkt->kind == VPX_CODEC_CX_FRAME_PKT)
+        out.append(static_cast<const char *>(pkt->data.frame.buf),
+                   pkt->data.frame.sz);
+    }
+  }
+  // Drain the lookahead.
+  bool got_data;
+  do {
+    got_data = false;
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_encode(&enc, NULL, kNumFrames, 1, 0,
+                               VPX_DL_GOOD_QUALITY));
+    vpx_codec_iter_t iter = NULL;
+    const vpx_codec_cx_pkt_t *pkt;
+    while ((pkt = vpx_codec_get_cx_data(&enc, &iter)) != NULL) {
+      got_data = true;
+      if (pkt->kind == VPX_CODEC_CX_FRAME_PKT)
+        out.append(static_cast<const char *>(pkt->data.frame.buf),
+                   pkt->data.frame.sz);
+    }
+  } while (got_data);
+
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+  return out;
+}
+
+TEST(VP9FrameRefsTest, ReferencedFramesMatchCopiedFrames) {
+  RefCountedFrame copied[kNumFrames];
+  RefCountedFrame referenced[kNumFrames];
+  for (int i = 0; i < kNumFrames; ++i) {
+    copied[i].Init(i);
+    referenced[i].Init(i);
+  }
+
+  int total_refs = 0;
+  const std::string copy_stream = Encode(copied, NULL, 0);
+  const std::string ref_stream = Encode(referenced, &total_refs, kBorder);
+
+  ASSERT_FALSE(copy_stream.empty());
+  EXPECT_TRUE(copy_stream == ref_stream);
+
+  // Every frame was held at least once and all references were dropped by
+  // the time the encoder was destroyed.
+  EXPECT_EQ(0, total_refs);
+  for (int i = 0; i < kNumFrames; ++i) {
+    EXPECT_EQ(0, copied[i].max_refs);
+    EXPECT_EQ(1, referenced[i].max_refs) << "frame " << i;
+    EXPECT_EQ(0, referenced[i].refs) << "frame " << i;
+  }
+}
+
+TEST(VP9FrameRefsTest, SmallBorderFallsBackToCopy) {
+  RefCountedFrame frames[kNumFrames];
+  for (int i = 0; i < kNumFrames; ++i) {
+    frames[i].Init(i);
+    // Claim a border narrower than the encoder needs to extend into.
+    frames[i].img.w = frames[i].img.stride[VPX_PLANE_Y] - 8;
+  }
+
+  int total_refs = 0;
+  Encode(frames, &total_refs, kBorder);
+  for (int i = 0; i < kNumFrames; ++i)
+    EXPECT_EQ(0, frames[i].max_refs) << "frame " << i;
+}
+
+TEST(VP9FrameRefsTest, UndeclaredBorderIsNotWritten) {
+  RefCountedFrame frames[kNumFrames];
+  for (int i = 0; i < kNumFrames; ++i) {
+    frames[i].Init(i);
+    frames[i].SetGuards();
+  }
+
+  // The stride leaves room for the encoder's horizontal extension, but no
+  // border is declared, so the rows above and below the planes must not be
+  // touched.
+  int total_refs = 0;
+  Encode(frames, &total_refs, 0);
+  for (int i = 0; i < kNumFrames; ++i) {
+    EXPECT_EQ(0, frames[i].max_refs) << "frame " << i;
+    EXPECT_TRUE(frames[i].GuardsIntact()) << "frame " << i;
+  }
+}
+
+TEST(VP9FrameRefsTest, DeclaredBorderTooSmallFallsBackToCopy) {
+  RefCountedFrame frames[kNumFrames];
+  for (int i = 0; i < kNumFrames; ++i) {
+    frames[i].Init(i);
+    frames[i].SetGuards();
+  }
+
+  int total_refs = 0;
+  Encode(frames, &total_refs, 8);
+  for (int i = 0; i < kNumFrames; ++i) {
+    EXPECT_EQ(0, frames[i].max_refs) << "frame " << i;
+    EXPECT_TRUE(frames[i].GuardsIntact()) << "frame " << i;
+  }
+}
+
+}  // namespace
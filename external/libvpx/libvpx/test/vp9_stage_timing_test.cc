@@ -0,0 +1,162 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./vpx_config.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vpx_encoder.h"
+
+namespace {
+
+const int kWidth = 352;
+const int kHeight = 288;
+const int kNumFrames = 20;
+const int kCpuUsed = 4;
+
+class VP9StageTimingTest : public ::testing::Test {
+ protected:
+  VP9StageTimingTest() : width_(kWidth), height_(kHeight), pts_(0) {}
+
+  virtual void SetUp() {
+    Init(kWidth, kHeight, 1);
+  }
+
+  virtual void TearDown() {
+    vpx_img_free(&img_);
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc_));
+  }
+
+  void Init(int width, int height, int threads) {
+    vpx_codec_enc_cfg_t cfg;
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_enc_config_default(&vpx_codec_vp9_cx_algo, &cfg, 0));
+    cfg.g_w = width;
+    cfg.g_h = height;
+    cfg.g_threads = threads;
+    cfg.g_lag_in_frames = 0;
+    cfg.rc_end_usage = VPX_CBR;
+    cfg.rc_target_bitrate = 300;
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_enc_init(&enc_, &vpx_codec_vp9_cx_algo, &cfg, 0));
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&enc_, VP8E_SET_CPUUSED, kCpuUsed));
+
+    ASSERT_TRUE(vpx_img_alloc(&img_, VPX_IMG_FMT_I420, width, height, 1) !=
+                NULL);
+    width_ = width;
+    height_ = height;
+  }
+
+  void Reinit(int width, int height, int threads) {
+    TearDown();
+    Init(width, height, threads);
+  }
+
+  // Encodes |count| frames of a moving gradient in real-time mode.
+  void EncodeFrames(int count) {
+    for (int i = 0; i < count; ++i, ++pts_) {
+      for (int r = 0; r < height_; ++r)
+        for (int c = 0; c < width_; ++c)
+          img_.planes[VPX_PLANE_Y][r * img_.stride[VPX_PLANE_Y] + c] =
+              static_cast<uint8_t>((r + c + 5 * pts_) & 0xff);
+      ASSERT_EQ(VPX_CODEC_OK, vpx_codec_encode(&enc_, &img_, pts_, 1, 0,
+                                               VPX_DL_REALTIME));
+      vpx_codec_iter_t iter = NULL;
+      while (vpx_codec_get_cx_data(&enc_, &iter) != NULL) {
+      }
+    }
+  }
+
+  vpx_stage_timing_t GetTiming() {
+    vpx_stage_timing_t timing;
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&enc_, VP9E_GET_STAGE_TIMING, &timing));
+    return timing;
+  }
+
+  vpx_codec_ctx_t enc_;
+  vpx_image_t img_;
+  int width_;
+  int height_;
+  int pts_;
+};
+
+TEST_F(VP9StageTimingTest, CountersStayIdleUntilEnabled) {
+  EncodeFrames(3);
+  const vpx_stage_timing_t timing = GetTiming();
+  EXPECT_EQ(0u, timing.frames);
+  EXPECT_EQ(0u, timing.frame);
+}
+
+TEST_F(VP9StageTimingTest, CountersAccumulate) {
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc_, VP9E_SET_STAGE_TIMING, 1));
+  EncodeFrames(kNumFrames);
+
+  const vpx_stage_timing_t timing = GetTiming();
+  EXPECT_EQ(static_cast<unsigned int>(kNumFrames), timing.frames);
+#if CONFIG_OS_SUPPORT
+  EXPECT_GT(timing.frame, 0u);
+  EXPECT_GT(timing.mode_decision, 0u);
+  EXPECT_GT(timing.tokenize, 0u);
+  EXPECT_LE(timing.motion_search, timing.mode_decision);
+  EXPECT_LE(timing.mode_decision + timing.loop_filter + timing.bitstream,
+            timing.frame);
+#endif  // CONFIG_OS_SUPPORT
+  EXPECT_EQ(kCpuUsed, timing.speed);
+
+  // Re-enabling resets the counters.
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc_, VP9E_SET_STAGE_TIMING, 1));
+  EXPECT_EQ(0u, GetTiming().frames);
+}
+
+#if CONFIG_OS_SUPPORT && CONFIG_MULTITHREAD
+TEST_F(VP9StageTimingTest, PipelinedLoopFilterIsCounted) {
+  // Two tile columns with two threads run the loop filter alongside the tile
+  // encode; its level pick and filtering must still land in loop_filter.
+  Reinit(640, 480, 2);
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc_, VP9E_SET_TILE_COLUMNS, 1));
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc_, VP9E_SET_STAGE_TIMING, 1));
+  EncodeFrames(kNumFrames);
+
+  const vpx_stage_timing_t timing = GetTiming();
+  EXPECT_EQ(static_cast<unsigned int>(kNumFrames), timing.frames);
+  EXPECT_GT(timing.loop_filter, 0u);
+  EXPECT_LE(timing.loop_filter, timing.frame);
+}
+#endif  // CONFIG_OS_SUPPORT && CONFIG_MULTITHREAD
+
+#if CONFIG_OS_SUPPORT
+TEST_F(VP9StageTimingTest, UnreachableTargetRaisesSpeed) {
+  // A 1us budget cannot be met, so the encoder should keep trading quality
+  // for speed.
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc_, VP9E_SET_TARGET_FRAME_TIME, 1));
+  EncodeFrames(kNumFrames);
+  EXPECT_GT(GetTiming().speed, kCpuUsed);
+
+  // Clearing the target restores the configured speed.
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc_, VP9E_SET_TARGET_FRAME_TIME, 0));
+  EncodeFrames(1);
+  EXPECT_EQ(kCpuUsed, GetTiming().speed);
+}
+
+TEST_F(VP9StageTimingTest, GenerousTargetKeepsConfiguredSpeed) {
+  // The configured speed is the quality ceiling; a budget that is always met
+  // never lowers it.
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc_, VP9E_SET_TARGET_FRAME_TIME, 10000000));
+  EncodeFrames(kNumFrames);
+  EXPECT_EQ(kCpuUsed, GetTiming().speed);
+}
+#endif  // CONFIG_OS_SUPPORT
+
+}  // namespace
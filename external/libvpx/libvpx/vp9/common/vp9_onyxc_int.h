@@ -258,6 +258,7 @@ typedef struct VP9Common {
   int log2_tile_cols, log2_tile_rows;
   int byte_alignment;
   int skip_loop_filter;
+  int frame_border;
 
   
   void *cb_priv;
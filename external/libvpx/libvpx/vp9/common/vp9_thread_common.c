@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <limits.h>
+
 #include "./vpx_config.h"
 #include "vpx_mem/vpx_mem.h"
 #include "vp9/common/vp9_entropymode.h"
@@ -174,6 +176,8 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame,
 
   
   memset(lf_sync->cur_sb_col, -1, sizeof(*lf_sync->cur_sb_col) * sb_rows);
+  for (i = 0; i < (start >> MI_BLOCK_SIZE_LOG2); ++i)
+    lf_sync->cur_sb_col[i] = INT_MAX;
 
   
   
@@ -11,6 +11,8 @@
 #ifndef VP9_ENCODER_VP9_BLOCK_H_
 #define VP9_ENCODER_VP9_BLOCK_H_
 
+#include "vpx_ports/vpx_timer.h"
+
 #include "vp9/common/vp9_entropymv.h"
 #include "vp9/common/vp9_entropy.h"
 
@@ -42,6 +44,16 @@ struct macroblock_plane {
   int64_t quant_thred[2];
 };
 
+typedef enum {
+  STAGE_MODE_DECISION,
+  STAGE_MOTION_SEARCH,
+  STAGE_TOKENIZE,
+  STAGE_TEMPORAL_FILTER,
+  STAGE_LOOP_FILTER,
+  STAGE_BITSTREAM,
+  ENCODE_STAGES
+} ENCODE_STAGE;
+
 typedef unsigned int vp9_coeff_cost[PLANE_TYPES][REF_TYPES][COEF_BANDS][2]
                                    [COEFF_CONTEXTS][ENTROPY_TOKENS];
 
@@ -139,8 +151,21 @@ struct macroblock {
   void (*highbd_itxm_add)(const tran_low_t *input, uint8_t *dest, int stride,
                           int eob, int bd);
 #endif
+
+  int time_stages;
+  int64_t stage_ns[ENCODE_STAGES];
 };
 
+static INLINE int64_t vp9_stage_begin(const MACROBLOCK *x) {
+  return x->time_stages ? vpx_nsec_timestamp() : 0;
+}
+
+static INLINE void vp9_stage_end(MACROBLOCK *x, ENCODE_STAGE stage,
+                                 int64_t start) {
+  if (x->time_stages)
+    x->stage_ns[stage] += vpx_nsec_timestamp() - start;
+}
+
 #ifdef __cplusplus
 }  
 #endif
@@ -486,7 +486,7 @@ static void set_vbp_thresholds(VP9_COMP *cpi, int64_t thresholds[], int q) {
       thresholds[1] = (5 * threshold_base) >> 2;
       if (cm->width >= 1920 && cm->height >= 1080)
         thresholds[1] = (7 * threshold_base) >> 2;
-      thresholds[2] = threshold_base << cpi->oxcf.speed;
+      thresholds[2] = threshold_base << cpi->active_speed;
     }
   }
 }
@@ -1158,6 +1158,7 @@ static void rd_pick_sb_modes(VP9_COMP *cpi,
   struct macroblock_plane *const p = x->plane;
   struct macroblockd_plane *const pd = xd->plane;
   const AQ_MODE aq_mode = cpi->oxcf.aq_mode;
+  const int64_t stage_start = vp9_stage_begin(x);
   int i, orig_rdmult;
 
   vpx_clear_system_state();
@@ -1261,6 +1262,8 @@ static void rd_pick_sb_modes(VP9_COMP *cpi,
 
   ctx->rate = rd_cost->rate;
   ctx->dist = rd_cost->dist;
+
+  vp9_stage_end(x, STAGE_MODE_DECISION, stage_start);
 }
 
 static void update_stats(VP9_COMMON *cm, ThreadData *td) {
@@ -2886,6 +2889,7 @@ static void nonrd_pick_sb_modes(VP9_COMP *cpi,
   TileInfo *const tile_info = &tile_data->tile_info;
   MACROBLOCKD *const xd = &x->e_mbd;
   MB_MODE_INFO *mbmi;
+  const int64_t stage_start = vp9_stage_begin(x);
   set_offsets(cpi, tile_info, x, mi_row, mi_col, bsize);
   mbmi = &xd->mi[0]->mbmi;
   mbmi->sb_type = bsize;
@@ -2912,6 +2916,8 @@ static void nonrd_pick_sb_modes(VP9_COMP *cpi,
 
   ctx->rate = rd_cost->rate;
   ctx->dist = rd_cost->dist;
+
+  vp9_stage_end(x, STAGE_MODE_DECISION, stage_start);
 }
 
 static void fill_mode_info_sb(VP9_COMMON *cm, MACROBLOCK *x,
@@ -3782,6 +3788,10 @@ void vp9_encode_tile(VP9_COMP *cpi, ThreadData *td,
       encode_nonrd_sb_row(cpi, td, this_tile, mi_row, &tok);
     else
       encode_rd_sb_row(cpi, td, this_tile, mi_row, &tok);
+
+    if (cpi->lf_pipeline != NULL && cpi->lf_pipeline->running)
+      vp9_lf_pipeline_row_done(cpi->lf_pipeline, tile_col,
+                               MIN(mi_row + MI_BLOCK_SIZE, cm->mi_rows));
   }
   cpi->tok_count[tile_row][tile_col] =
       (unsigned int)(tok - cpi->tile_tok[tile_row][tile_col]);
@@ -4102,6 +4112,7 @@ static void encode_superblock(VP9_COMP *cpi, ThreadData *td,
   const int mis = cm->mi_stride;
   const int mi_width = num_8x8_blocks_wide_lookup[bsize];
   const int mi_height = num_8x8_blocks_high_lookup[bsize];
+  int64_t stage_start;
 
   x->skip_recode = !x->select_tx_size && mbmi->sb_type >= BLOCK_8X8 &&
                    cpi->oxcf.aq_mode != COMPLEXITY_AQ &&
@@ -4127,7 +4138,9 @@ static void encode_superblock(VP9_COMP *cpi, ThreadData *td,
       vp9_encode_intra_block_plane(x, MAX(bsize, BLOCK_8X8), plane);
     if (output_enabled)
       sum_intra_stats(td->counts, mi);
+    stage_start = vp9_stage_begin(x);
     vp9_tokenize_sb(cpi, td, t, !output_enabled, MAX(bsize, BLOCK_8X8));
+    vp9_stage_end(x, STAGE_TOKENIZE, stage_start);
   } else {
     int ref;
     const int is_compound = has_second_ref(mbmi);
@@ -4145,7 +4158,9 @@ static void encode_superblock(VP9_COMP *cpi, ThreadData *td,
     vp9_build_inter_predictors_sbuv(xd, mi_row, mi_col, MAX(bsize, BLOCK_8X8));
 
     vp9_encode_sb(x, MAX(bsize, BLOCK_8X8));
+    stage_start = vp9_stage_begin(x);
     vp9_tokenize_sb(cpi, td, t, !output_enabled, MAX(bsize, BLOCK_8X8));
+    vp9_stage_end(x, STAGE_TOKENIZE, stage_start);
   }
 
   if (output_enabled) {
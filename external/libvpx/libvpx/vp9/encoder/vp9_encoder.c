@@ -1453,6 +1453,10 @@ void vp9_change_config(struct VP9_COMP *cpi, const VP9EncoderConfig *oxcf) {
   if (cm->profile != oxcf->profile)
     cm->profile = oxcf->profile;
   cm->bit_depth = oxcf->bit_depth;
+
+  if (oxcf->mode != REALTIME || cpi->target_frame_time == 0 ||
+      cpi->active_speed < oxcf->speed)
+    cpi->active_speed = oxcf->speed;
   cm->color_space = oxcf->color_space;
 
   if (cm->profile <= PROFILE_1)
@@ -2028,6 +2032,8 @@ void vp9_remove_compressor(VP9_COMP *cpi) {
   if (cpi->num_workers > 1)
     vp9_loop_filter_dealloc(&cpi->lf_row_sync);
 
+  vp9_lf_pipeline_dealloc(cpi);
+
   dealloc_compressor_data(cpi);
 
   for (i = 0; i < sizeof(cpi->mbgraph_stats) /
@@ -2727,6 +2733,13 @@ void vp9_update_reference_frames(VP9_COMP *cpi) {
 static void loopfilter_frame(VP9_COMP *cpi, VP9_COMMON *cm) {
   MACROBLOCKD *xd = &cpi->td.mb.e_mbd;
   struct loopfilter *lf = &cm->lf;
+
+  if (cpi->lf_pipeline != NULL && cpi->lf_pipeline->picked) {
+    cpi->lf_pipeline->picked = 0;
+    vpx_extend_frame_inner_borders(cm->frame_to_show);
+    return;
+  }
+
   if (xd->lossless) {
       lf->filter_level = 0;
   } else {
@@ -3641,6 +3654,7 @@ static void encode_frame_to_data_rate(VP9_COMP *cpi,
   const VP9EncoderConfig *const oxcf = &cpi->oxcf;
   struct segmentation *const seg = &cm->seg;
   TX_SIZE t;
+  int64_t stage_start;
 
   set_ext_overrides(cpi);
   vpx_clear_system_state();
@@ -3784,10 +3798,14 @@ static void encode_frame_to_data_rate(VP9_COMP *cpi,
   cm->frame_to_show = get_frame_new_buffer(cm);
 
   
+  stage_start = vp9_stage_begin(&cpi->td.mb);
   loopfilter_frame(cpi, cm);
+  vp9_stage_end(&cpi->td.mb, STAGE_LOOP_FILTER, stage_start);
 
   
+  stage_start = vp9_stage_begin(&cpi->td.mb);
   vp9_pack_bitstream(cpi, dest, size);
+  vp9_stage_end(&cpi->td.mb, STAGE_BITSTREAM, stage_start);
 
   if (cm->seg.update_map)
     update_reference_segmentation_map(cpi);
@@ -3952,8 +3970,8 @@ static void setup_denoiser_buffer(VP9_COMP *cpi) {
 #endif
 
 int vp9_receive_raw_frame(VP9_COMP *cpi, unsigned int frame_flags,
-                          YV12_BUFFER_CONFIG *sd, int64_t time_stamp,
-                          int64_t end_time) {
+                          YV12_BUFFER_CONFIG *sd, void *fb_priv,
+                          int64_t time_stamp, int64_t end_time) {
   VP9_COMMON *cm = &cpi->common;
   struct vpx_usec_timer timer;
   int res = 0;
@@ -3975,7 +3993,9 @@ int vp9_receive_raw_frame(VP9_COMP *cpi, unsigned int frame_flags,
 #if CONFIG_VP9_HIGHBITDEPTH
                          use_highbitdepth,
 #endif  
-                         frame_flags))
+                         frame_flags,
+                         cpi->oxcf.noise_sensitivity > 0 ? NULL : &cpi->fb_refs,
+                         fb_priv))
     res = -1;
   vpx_usec_timer_mark(&timer);
   cpi->time_receive_data += vpx_usec_timer_elapsed(&timer);
@@ -4103,6 +4123,25 @@ static void adjust_image_stat(double y, double u, double v, double all,
 }
 #endif  
 
+static void update_stage_timing(VP9_COMP *cpi, int64_t frame_time) {
+  MACROBLOCK *const x = &cpi->td.mb;
+  vpx_stage_timing_t *const timing = &cpi->stage_timing;
+
+  timing->mode_decision += x->stage_ns[STAGE_MODE_DECISION];
+  timing->motion_search += x->stage_ns[STAGE_MOTION_SEARCH];
+  timing->tokenize += x->stage_ns[STAGE_TOKENIZE];
+  timing->temporal_filter += x->stage_ns[STAGE_TEMPORAL_FILTER];
+  timing->loop_filter += x->stage_ns[STAGE_LOOP_FILTER];
+  timing->bitstream += x->stage_ns[STAGE_BITSTREAM];
+  timing->frame += frame_time;
+  ++timing->frames;
+
+  vp9_update_rt_speed(cpi, frame_time, x->stage_ns[STAGE_MODE_DECISION] +
+                                           x->stage_ns[STAGE_TOKENIZE]);
+  timing->speed = cpi->active_speed;
+  vp9_zero(x->stage_ns);
+}
+
 int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
                             size_t *size, uint8_t *dest,
                             int64_t *time_stamp, int64_t *time_end, int flush) {
@@ -4111,6 +4150,7 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
   BufferPool *const pool = cm->buffer_pool;
   RATE_CONTROL *const rc = &cpi->rc;
   struct vpx_usec_timer  cmptimer;
+  const int64_t frame_start = vp9_stage_begin(&cpi->td.mb);
   YV12_BUFFER_CONFIG *force_src_buffer = NULL;
   struct lookahead_entry *last_source = NULL;
   struct lookahead_entry *source = NULL;
@@ -4181,7 +4221,9 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
 
       if (oxcf->arnr_max_frames > 0) {
         
+        const int64_t stage_start = vp9_stage_begin(&cpi->td.mb);
         vp9_temporal_filter(cpi, arf_src_index);
+        vp9_stage_end(&cpi->td.mb, STAGE_TEMPORAL_FILTER, stage_start);
         vpx_extend_frame_borders(&cpi->alt_ref_buffer);
         force_src_buffer = &cpi->alt_ref_buffer;
       }
@@ -4355,6 +4397,9 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
   vpx_usec_timer_mark(&cmptimer);
   cpi->time_compress_data += vpx_usec_timer_elapsed(&cmptimer);
 
+  if (cpi->td.mb.time_stages)
+    update_stage_timing(cpi, vpx_nsec_timestamp() - frame_start);
+
   if (cpi->b_calculate_psnr && oxcf->pass != 1 && cm->show_frame)
     generate_psnr_packet(cpi);
 
@@ -4674,6 +4719,22 @@ int vp9_get_quantizer(VP9_COMP *cpi) {
   return cpi->common.base_qindex;
 }
 
+void vp9_set_stage_timing(VP9_COMP *cpi, int enable) {
+  cpi->td.mb.time_stages = enable;
+  vp9_zero(cpi->td.mb.stage_ns);
+  vp9_zero(cpi->stage_timing);
+  cpi->stage_timing.speed = cpi->active_speed;
+}
+
+void vp9_set_target_frame_time(VP9_COMP *cpi, unsigned int usec) {
+  cpi->target_frame_time = usec;
+  cpi->speed_debt = 0;
+  if (usec == 0)
+    cpi->active_speed = cpi->oxcf.speed;
+  else if (!cpi->td.mb.time_stages)
+    vp9_set_stage_timing(cpi, 1);
+}
+
 void vp9_apply_encoding_flags(VP9_COMP *cpi, vpx_enc_frame_flags_t flags) {
   if (flags & (VP8_EFLAG_NO_REF_LAST | VP8_EFLAG_NO_REF_GF |
                VP8_EFLAG_NO_REF_ARF)) {
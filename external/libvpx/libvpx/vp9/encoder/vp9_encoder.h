@@ -288,6 +288,7 @@ typedef struct VP9_COMP {
   VP9_COMMON common;
   VP9EncoderConfig oxcf;
   struct lookahead_ctx    *lookahead;
+  vpx_frame_buffer_refs_t fb_refs;
   struct lookahead_entry  *alt_ref_source;
 
   YV12_BUFFER_CONFIG *Source;
@@ -384,6 +385,11 @@ typedef struct VP9_COMP {
   uint64_t time_pick_lpf;
   uint64_t time_encode_sb_row;
 
+  vpx_stage_timing_t stage_timing;
+  unsigned int target_frame_time;
+  int active_speed;
+  int64_t speed_debt;
+
 #if CONFIG_FP_MB_STATS
   int use_fp_mb_stats;
 #endif
@@ -491,6 +497,7 @@ typedef struct VP9_COMP {
   VPxWorker *workers;
   struct EncWorkerData *tile_thr_data;
   VP9LfSync lf_row_sync;
+  struct VP9LfPipeline *lf_pipeline;
 } VP9_COMP;
 
 void vp9_initialize_enc(void);
@@ -504,8 +511,8 @@ void vp9_change_config(VP9_COMP *cpi, const VP9EncoderConfig *oxcf);
   
   
 int vp9_receive_raw_frame(VP9_COMP *cpi, unsigned int frame_flags,
-                          YV12_BUFFER_CONFIG *sd, int64_t time_stamp,
-                          int64_t end_time_stamp);
+                          YV12_BUFFER_CONFIG *sd, void *fb_priv,
+                          int64_t time_stamp, int64_t end_time_stamp);
 
 int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
                             size_t *size, uint8_t *dest,
@@ -540,6 +547,10 @@ void vp9_set_svc(VP9_COMP *cpi, int use_svc);
 
 int vp9_get_quantizer(struct VP9_COMP *cpi);
 
+void vp9_set_stage_timing(VP9_COMP *cpi, int enable);
+
+void vp9_set_target_frame_time(VP9_COMP *cpi, unsigned int usec);
+
 static INLINE int frame_is_kf_gf_arf(const VP9_COMP *cpi) {
   return frame_is_intra_only(&cpi->common) ||
          cpi->refresh_alt_ref_frame ||
@@ -8,9 +8,19 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <limits.h>
+
 #include "vp9/encoder/vp9_encodeframe.h"
 #include "vp9/encoder/vp9_encoder.h"
 #include "vp9/encoder/vp9_ethread.h"
+#include "vp9/encoder/vp9_picklpf.h"
+
+static void accumulate_stage_times(MACROBLOCK *x, const MACROBLOCK *x_t) {
+  int i;
+
+  for (i = 0; i < ENCODE_STAGES; i++)
+    x->stage_ns[i] += x_t->stage_ns[i];
+}
 
 static void accumulate_rd_opt(ThreadData *td, ThreadData *td_t) {
   int i, j, k, l, m, n;
@@ -51,6 +61,158 @@ static int enc_worker_hook(EncWorkerData *const thread_data, void *unused) {
   return 0;
 }
 
+#if CONFIG_MULTITHREAD
+static int lf_pipeline_allowed(const VP9_COMP *cpi) {
+  return cpi->sf.recode_loop == DISALLOW_RECODE &&
+         cpi->sf.lpf_pick >= LPF_PICK_FROM_Q &&
+         cpi->oxcf.content != VP9E_CONTENT_SCREEN &&
+         !(cpi->rc.next_key_frame_forced && cpi->rc.frames_to_key == 1);
+}
+
+static void lf_pipeline_wait(VP9LfPipeline *const lf_pipe, int mi_rows) {
+  pthread_mutex_lock(&lf_pipe->mutex_);
+  for (;;) {
+    int done = INT_MAX;
+    int i;
+    for (i = 0; i < lf_pipe->tile_cols; ++i)
+      done = MIN(done, lf_pipe->mi_rows_done[i]);
+    if (done >= mi_rows)
+      break;
+    pthread_cond_wait(&lf_pipe->cond_, &lf_pipe->mutex_);
+  }
+  pthread_mutex_unlock(&lf_pipe->mutex_);
+}
+
+static int lf_pipeline_worker_hook(VP9LfPipeline *const lf_pipe,
+                                   void *unused) {
+  LFWorkerData *const lf_data = &lf_pipe->lf_data;
+  const int mi_rows = lf_data->cm->mi_rows;
+  int mi_row;
+
+  (void) unused;
+
+  for (mi_row = 0; mi_row < mi_rows; mi_row += MI_BLOCK_SIZE) {
+    int64_t start;
+    lf_pipeline_wait(lf_pipe, MIN(mi_row + 2 * MI_BLOCK_SIZE, mi_rows));
+    start = lf_pipe->time_stages ? vpx_nsec_timestamp() : 0;
+    vp9_loop_filter_rows(lf_data->frame_buffer, lf_data->cm, lf_data->planes,
+                         mi_row, mi_row + MI_BLOCK_SIZE, 0);
+    if (lf_pipe->time_stages)
+      lf_pipe->stage_ns += vpx_nsec_timestamp() - start;
+  }
+
+  return 1;
+}
+
+static void lf_pipeline_start(VP9_COMP *cpi) {
+  VP9_COMMON *const cm = &cpi->common;
+  struct loopfilter *const lf = &cm->lf;
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  VP9LfPipeline *lf_pipe = cpi->lf_pipeline;
+  int64_t stage_start;
+  int i;
+
+  if (lf_pipe != NULL) {
+    lf_pipe->picked = 0;
+    lf_pipe->running = 0;
+  }
+
+  if (!lf_pipeline_allowed(cpi))
+    return;
+
+  if (lf_pipe == NULL) {
+    CHECK_MEM_ERROR(cm, cpi->lf_pipeline,
+                    vpx_calloc(1, sizeof(*cpi->lf_pipeline)));
+    lf_pipe = cpi->lf_pipeline;
+    if (pthread_mutex_init(&lf_pipe->mutex_, NULL) ||
+        pthread_cond_init(&lf_pipe->cond_, NULL))
+      vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
+                         "Failed to init loop filter pipeline sync");
+    winterface->init(&lf_pipe->worker);
+    lf_pipe->worker.hook = (VPxWorkerHook)lf_pipeline_worker_hook;
+    lf_pipe->worker.data1 = lf_pipe;
+    lf_pipe->worker.data2 = NULL;
+    if (!winterface->reset(&lf_pipe->worker))
+      vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
+                         "Loop filter thread creation failed");
+  }
+
+  // The level pick and the filtering below both belong to the loop filter
+  // stage even though they now run alongside the tile encode.
+  stage_start = vp9_stage_begin(&cpi->td.mb);
+  if (cpi->td.mb.e_mbd.lossless)
+    lf->filter_level = 0;
+  else
+    vp9_pick_filter_level(cpi->Source, cpi, cpi->sf.lpf_pick);
+  lf_pipe->picked = 1;
+
+  if (lf->filter_level == 0) {
+    vp9_stage_end(&cpi->td.mb, STAGE_LOOP_FILTER, stage_start);
+    return;
+  }
+
+  lf_pipe->tile_cols = 1 << cm->log2_tile_cols;
+  for (i = 0; i < lf_pipe->tile_cols; ++i)
+    lf_pipe->mi_rows_done[i] = 0;
+
+  vp9_loop_filter_frame_init(cm, lf->filter_level);
+  vp9_loop_filter_data_reset(&lf_pipe->lf_data, get_frame_new_buffer(cm), cm,
+                             cpi->td.mb.e_mbd.plane);
+  vp9_stage_end(&cpi->td.mb, STAGE_LOOP_FILTER, stage_start);
+  lf_pipe->time_stages = cpi->td.mb.time_stages;
+  lf_pipe->stage_ns = 0;
+  lf_pipe->running = 1;
+  winterface->launch(&lf_pipe->worker);
+}
+
+static void lf_pipeline_finish(VP9_COMP *cpi) {
+  VP9LfPipeline *const lf_pipe = cpi->lf_pipeline;
+  int i;
+
+  if (lf_pipe == NULL || !lf_pipe->running)
+    return;
+
+  pthread_mutex_lock(&lf_pipe->mutex_);
+  for (i = 0; i < lf_pipe->tile_cols; ++i)
+    lf_pipe->mi_rows_done[i] = INT_MAX;
+  pthread_cond_broadcast(&lf_pipe->cond_);
+  pthread_mutex_unlock(&lf_pipe->mutex_);
+
+  vpx_get_worker_interface()->sync(&lf_pipe->worker);
+  lf_pipe->running = 0;
+  cpi->td.mb.stage_ns[STAGE_LOOP_FILTER] += lf_pipe->stage_ns;
+}
+#endif
+
+void vp9_lf_pipeline_row_done(VP9LfPipeline *lf_pipe, int tile_col,
+                              int mi_rows_done) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&lf_pipe->mutex_);
+  lf_pipe->mi_rows_done[tile_col] = mi_rows_done;
+  pthread_cond_broadcast(&lf_pipe->cond_);
+  pthread_mutex_unlock(&lf_pipe->mutex_);
+#else
+  (void)lf_pipe;
+  (void)tile_col;
+  (void)mi_rows_done;
+#endif
+}
+
+void vp9_lf_pipeline_dealloc(VP9_COMP *cpi) {
+  VP9LfPipeline *const lf_pipe = cpi->lf_pipeline;
+
+  if (lf_pipe == NULL)
+    return;
+
+  vpx_get_worker_interface()->end(&lf_pipe->worker);
+#if CONFIG_MULTITHREAD
+  pthread_mutex_destroy(&lf_pipe->mutex_);
+  pthread_cond_destroy(&lf_pipe->cond_);
+#endif
+  vpx_free(lf_pipe);
+  cpi->lf_pipeline = NULL;
+}
+
 static int get_max_tile_cols(VP9_COMP *cpi) {
   const int aligned_width = ALIGN_POWER_OF_TWO(cpi->oxcf.width, MI_SIZE_LOG2);
   int mi_cols = aligned_width >> MI_SIZE_LOG2;
@@ -141,6 +303,7 @@ void vp9_encode_tiles_mt(VP9_COMP *cpi) {
     if (thread_data->td != &cpi->td) {
       thread_data->td->mb = cpi->td.mb;
       thread_data->td->rd_counts = cpi->td.rd_counts;
+      vp9_zero(thread_data->td->mb.stage_ns);
     }
     if (thread_data->td->counts != &cpi->common.counts) {
       memcpy(thread_data->td->counts, &cpi->common.counts,
@@ -165,6 +328,10 @@ void vp9_encode_tiles_mt(VP9_COMP *cpi) {
     }
   }
 
+#if CONFIG_MULTITHREAD
+  lf_pipeline_start(cpi);
+#endif
+
   
   for (i = 0; i < num_workers; i++) {
     VPxWorker *const worker = &cpi->workers[i];
@@ -185,6 +352,10 @@ void vp9_encode_tiles_mt(VP9_COMP *cpi) {
     winterface->sync(worker);
   }
 
+#if CONFIG_MULTITHREAD
+  lf_pipeline_finish(cpi);
+#endif
+
   for (i = 0; i < num_workers; i++) {
     VPxWorker *const worker = &cpi->workers[i];
     EncWorkerData *const thread_data = (EncWorkerData*)worker->data1;
@@ -193,6 +364,7 @@ void vp9_encode_tiles_mt(VP9_COMP *cpi) {
     if (i < cpi->num_workers - 1) {
       vp9_accumulate_frame_counts(cm, thread_data->td->counts, 0);
       accumulate_rd_opt(&cpi->td, thread_data->td);
+      accumulate_stage_times(&cpi->td.mb, &thread_data->td->mb);
     }
   }
 }
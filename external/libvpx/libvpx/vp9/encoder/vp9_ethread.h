@@ -11,6 +11,10 @@
 #ifndef VP9_ENCODER_VP9_ETHREAD_H_
 #define VP9_ENCODER_VP9_ETHREAD_H_
 
+#include "./vpx_config.h"
+#include "vpx_util/vpx_thread.h"
+#include "vp9/common/vp9_loopfilter.h"
+
 struct VP9_COMP;
 struct ThreadData;
 
@@ -20,6 +24,28 @@ typedef struct EncWorkerData {
   int start;
 } EncWorkerData;
 
+typedef struct VP9LfPipeline {
+  VPxWorker worker;
+  LFWorkerData lf_data;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t mutex_;
+  pthread_cond_t cond_;
+#endif
+  int mi_rows_done[1 << 6];
+  int tile_cols;
+  int picked;
+  int running;
+  // Filtering time spent on the pipeline thread, added to the main
+  // thread's STAGE_LOOP_FILTER once the pipeline is finished.
+  int time_stages;
+  int64_t stage_ns;
+} VP9LfPipeline;
+
 void vp9_encode_tiles_mt(struct VP9_COMP *cpi);
 
+void vp9_lf_pipeline_row_done(VP9LfPipeline *lf_pipe, int tile_col,
+                              int mi_rows_done);
+
+void vp9_lf_pipeline_dealloc(struct VP9_COMP *cpi);
+
 #endif  
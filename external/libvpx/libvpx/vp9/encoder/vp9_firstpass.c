@@ -766,7 +766,8 @@ void vp9_first_pass(VP9_COMP *cpi, const struct lookahead_entry *source) {
         
         
         unscaled_last_source_buf_2d.buf =
-            cpi->unscaled_last_source->y_buffer + recon_yoffset;
+            cpi->unscaled_last_source->y_buffer +
+            (mb_row * cpi->unscaled_last_source->y_stride + mb_col) * 16;
         unscaled_last_source_buf_2d.stride =
             cpi->unscaled_last_source->y_stride;
 #if CONFIG_VP9_HIGHBITDEPTH
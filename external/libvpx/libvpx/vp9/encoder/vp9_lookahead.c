@@ -30,14 +30,87 @@ static struct lookahead_entry *pop(struct lookahead_ctx *ctx,
   return buf;
 }
 
+static void release_ref(struct lookahead_entry *buf) {
+  if (buf->fb_refs.release_cb != NULL) {
+    buf->fb_refs.release_cb(buf->fb_refs.cb_priv, &buf->fb);
+    memset(&buf->fb_refs, 0, sizeof(buf->fb_refs));
+    memset(&buf->fb, 0, sizeof(buf->fb));
+  }
+}
+
+static int can_reference(const YV12_BUFFER_CONFIG *src,
+#if CONFIG_VP9_HIGHBITDEPTH
+                         int use_highbitdepth,
+#endif
+                         const vpx_frame_buffer_refs_t *fb_refs,
+                         void *fb_priv) {
+  const int er_y = MAX(src->y_width + 16, ALIGN_POWER_OF_TWO(src->y_width, 6))
+      - src->y_crop_width;
+  const int eb_y = MAX(src->y_height + 16, ALIGN_POWER_OF_TWO(src->y_height, 6))
+      - src->y_crop_height;
+
+  const int border = MAX(16, MAX(er_y, eb_y));
+
+  if (fb_refs == NULL || fb_refs->retain_cb == NULL ||
+      fb_refs->release_cb == NULL || fb_priv == NULL)
+    return 0;
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (!!(src->flags & YV12_FLAG_HIGHBITDEPTH) != !!use_highbitdepth)
+    return 0;
+#endif
+  // src->border only reflects the horizontal slack in the stride. Rows
+  // above and below the planes are written too, so the application must
+  // also have declared them.
+  return fb_refs->border >= border && src->border >= border;
+}
+
+static int reference_frame(struct lookahead_entry *buf,
+                           YV12_BUFFER_CONFIG *src,
+                           const vpx_frame_buffer_refs_t *fb_refs,
+                           void *fb_priv) {
+  const int aligned_width = ALIGN_POWER_OF_TWO(src->y_crop_width, 3);
+  const int aligned_height = ALIGN_POWER_OF_TWO(src->y_crop_height, 3);
+
+  buf->fb.data = NULL;
+  buf->fb.size = 0;
+  buf->fb.priv = fb_priv;
+  if (fb_refs->retain_cb(fb_refs->cb_priv, &buf->fb))
+    return 1;
+  buf->fb_refs = *fb_refs;
+
+  buf->img = buf->own_img;
+  buf->img.y_width = aligned_width;
+  buf->img.y_height = aligned_height;
+  buf->img.y_crop_width = src->y_crop_width;
+  buf->img.y_crop_height = src->y_crop_height;
+  buf->img.y_stride = src->y_stride;
+  buf->img.uv_width = aligned_width >> src->subsampling_x;
+  buf->img.uv_height = aligned_height >> src->subsampling_y;
+  buf->img.uv_crop_width = src->uv_crop_width;
+  buf->img.uv_crop_height = src->uv_crop_height;
+  buf->img.uv_stride = src->uv_stride;
+  buf->img.y_buffer = src->y_buffer;
+  buf->img.u_buffer = src->u_buffer;
+  buf->img.v_buffer = src->v_buffer;
+  buf->img.alpha_buffer = NULL;
+  buf->img.buffer_alloc = NULL;
+  buf->img.buffer_alloc_sz = 0;
+  buf->img.border = src->border;
+  buf->img.subsampling_x = src->subsampling_x;
+  buf->img.subsampling_y = src->subsampling_y;
+  vp9_copy_and_extend_frame(src, &buf->img);
+  return 0;
+}
 
 void vp9_lookahead_destroy(struct lookahead_ctx *ctx) {
   if (ctx) {
     if (ctx->buf) {
       unsigned int i;
 
-      for (i = 0; i < ctx->max_sz; i++)
-        vpx_free_frame_buffer(&ctx->buf[i].img);
+      for (i = 0; i < ctx->max_sz; i++) {
+        release_ref(&ctx->buf[i]);
+        vpx_free_frame_buffer(&ctx->buf[i].own_img);
+      }
       free(ctx->buf);
     }
     free(ctx);
@@ -70,8 +143,8 @@ struct lookahead_ctx *vp9_lookahead_init(unsigned int width,
     ctx->buf = calloc(depth, sizeof(*ctx->buf));
     if (!ctx->buf)
       goto bail;
-    for (i = 0; i < depth; i++)
-      if (vpx_alloc_frame_buffer(&ctx->buf[i].img,
+    for (i = 0; i < depth; i++) {
+      if (vpx_alloc_frame_buffer(&ctx->buf[i].own_img,
                                  width, height, subsampling_x, subsampling_y,
 #if CONFIG_VP9_HIGHBITDEPTH
                                  use_highbitdepth,
@@ -79,6 +152,8 @@ struct lookahead_ctx *vp9_lookahead_init(unsigned int width,
                                  VP9_ENC_BORDER_IN_PIXELS,
                                  legacy_byte_alignment))
         goto bail;
+      ctx->buf[i].img = ctx->buf[i].own_img;
+    }
   }
   return ctx;
  bail:
@@ -93,7 +168,9 @@ int vp9_lookahead_push(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG   *src,
 #if CONFIG_VP9_HIGHBITDEPTH
                        int use_highbitdepth,
 #endif
-                       unsigned int flags) {
+                       unsigned int flags,
+                       const vpx_frame_buffer_refs_t *fb_refs,
+                       void *fb_priv) {
   struct lookahead_entry *buf;
 #if USE_PARTIAL_COPY
   int row, col, active_end;
@@ -112,15 +189,28 @@ int vp9_lookahead_push(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG   *src,
     return 1;
   ctx->sz++;
   buf = pop(ctx, &ctx->write_idx);
+  release_ref(buf);
+
+  if (can_reference(src,
+#if CONFIG_VP9_HIGHBITDEPTH
+                    use_highbitdepth,
+#endif
+                    fb_refs, fb_priv) &&
+      !reference_frame(buf, src, fb_refs, fb_priv)) {
+    buf->ts_start = ts_start;
+    buf->ts_end = ts_end;
+    buf->flags = flags;
+    return 0;
+  }
 
-  new_dimensions = width != buf->img.y_crop_width ||
-                   height != buf->img.y_crop_height ||
-                   uv_width != buf->img.uv_crop_width ||
-                   uv_height != buf->img.uv_crop_height;
-  larger_dimensions = width > buf->img.y_width ||
-                      height > buf->img.y_height ||
-                      uv_width > buf->img.uv_width ||
-                      uv_height > buf->img.uv_height;
+  new_dimensions = width != buf->own_img.y_crop_width ||
+                   height != buf->own_img.y_crop_height ||
+                   uv_width != buf->own_img.uv_crop_width ||
+                   uv_height != buf->own_img.uv_crop_height;
+  larger_dimensions = width > buf->own_img.y_width ||
+                      height > buf->own_img.y_height ||
+                      uv_width > buf->own_img.uv_width ||
+                      uv_height > buf->own_img.uv_height;
   assert(!larger_dimensions || new_dimensions);
 
 #if USE_PARTIAL_COPY
@@ -179,18 +269,19 @@ int vp9_lookahead_push(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG   *src,
                                  VP9_ENC_BORDER_IN_PIXELS,
                                  0))
           return 1;
-      vpx_free_frame_buffer(&buf->img);
-      buf->img = new_img;
+      vpx_free_frame_buffer(&buf->own_img);
+      buf->own_img = new_img;
     } else if (new_dimensions) {
-      buf->img.y_crop_width = src->y_crop_width;
-      buf->img.y_crop_height = src->y_crop_height;
-      buf->img.uv_crop_width = src->uv_crop_width;
-      buf->img.uv_crop_height = src->uv_crop_height;
-      buf->img.subsampling_x = src->subsampling_x;
-      buf->img.subsampling_y = src->subsampling_y;
+      buf->own_img.y_crop_width = src->y_crop_width;
+      buf->own_img.y_crop_height = src->y_crop_height;
+      buf->own_img.uv_crop_width = src->uv_crop_width;
+      buf->own_img.uv_crop_height = src->uv_crop_height;
+      buf->own_img.subsampling_x = src->subsampling_x;
+      buf->own_img.subsampling_y = src->subsampling_y;
     }
     
-    vp9_copy_and_extend_frame(src, &buf->img);
+    vp9_copy_and_extend_frame(src, &buf->own_img);
+    buf->img = buf->own_img;
 #if USE_PARTIAL_COPY
   }
 #endif
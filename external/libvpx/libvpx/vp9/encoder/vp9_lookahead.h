@@ -12,6 +12,7 @@
 #define VP9_ENCODER_VP9_LOOKAHEAD_H_
 
 #include "vpx_scale/yv12config.h"
+#include "vpx/vpx_frame_buffer.h"
 #include "vpx/vpx_integer.h"
 
 #if CONFIG_SPATIAL_SVC
@@ -30,6 +31,9 @@ struct lookahead_entry {
   int64_t             ts_start;
   int64_t             ts_end;
   unsigned int        flags;
+  YV12_BUFFER_CONFIG  own_img;
+  vpx_frame_buffer_refs_t fb_refs;
+  vpx_codec_frame_buffer_t fb;
 };
 
 #define MAX_PRE_FRAMES 1
@@ -60,7 +64,9 @@ int vp9_lookahead_push(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG *src,
 #if CONFIG_VP9_HIGHBITDEPTH
                        int use_highbitdepth,
 #endif
-                       unsigned int flags);
+                       unsigned int flags,
+                       const vpx_frame_buffer_refs_t *fb_refs,
+                       void *fb_priv);
 
 
 struct lookahead_entry *vp9_lookahead_pop(struct lookahead_ctx *ctx,
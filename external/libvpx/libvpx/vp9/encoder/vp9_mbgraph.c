@@ -172,8 +172,10 @@ static void update_mbgraph_mb_stats
   YV12_BUFFER_CONFIG *buf,
   int mb_y_offset,
   YV12_BUFFER_CONFIG *golden_ref,
+  int gld_y_offset,
   const MV *prev_golden_ref_mv,
   YV12_BUFFER_CONFIG *alt_ref,
+  int arf_y_offset,
   int mb_row,
   int mb_col
 ) {
@@ -181,13 +183,15 @@ static void update_mbgraph_mb_stats
   MACROBLOCKD *const xd = &x->e_mbd;
   int intra_error;
   VP9_COMMON *cm = &cpi->common;
+  YV12_BUFFER_CONFIG *const new_buf = get_frame_new_buffer(cm);
 
   
   x->plane[0].src.buf = buf->y_buffer + mb_y_offset;
   x->plane[0].src.stride = buf->y_stride;
 
-  xd->plane[0].dst.buf = get_frame_new_buffer(cm)->y_buffer + mb_y_offset;
-  xd->plane[0].dst.stride = get_frame_new_buffer(cm)->y_stride;
+  xd->plane[0].dst.buf = new_buf->y_buffer +
+                         (mb_row * new_buf->y_stride + mb_col) * 16;
+  xd->plane[0].dst.stride = new_buf->y_stride;
 
   
   intra_error = find_best_16x16_intra(cpi,
@@ -199,7 +203,7 @@ static void update_mbgraph_mb_stats
   
   if (golden_ref) {
     int g_motion_error;
-    xd->plane[0].pre[0].buf = golden_ref->y_buffer + mb_y_offset;
+    xd->plane[0].pre[0].buf = golden_ref->y_buffer + gld_y_offset;
     xd->plane[0].pre[0].stride = golden_ref->y_stride;
     g_motion_error = do_16x16_motion_search(cpi,
                                             prev_golden_ref_mv,
@@ -215,7 +219,7 @@ static void update_mbgraph_mb_stats
   
   if (alt_ref) {
     int a_motion_error;
-    xd->plane[0].pre[0].buf = alt_ref->y_buffer + mb_y_offset;
+    xd->plane[0].pre[0].buf = alt_ref->y_buffer + arf_y_offset;
     xd->plane[0].pre[0].stride = alt_ref->y_stride;
     a_motion_error = do_16x16_zerozero_search(cpi,
                                               &stats->ref[ALTREF_FRAME].m.mv);
@@ -271,8 +275,8 @@ static void update_mbgraph_frame_stats(VP9_COMP *cpi,
       MBGRAPH_MB_STATS *mb_stats = &stats->mb_stats[offset + mb_col];
 
       update_mbgraph_mb_stats(cpi, mb_stats, buf, mb_y_in_offset,
-                              golden_ref, &gld_left_mv, alt_ref,
-                              mb_row, mb_col);
+                              golden_ref, gld_y_in_offset, &gld_left_mv,
+                              alt_ref, arf_y_in_offset, mb_row, mb_col);
       gld_left_mv = mb_stats->ref[GOLDEN_FRAME].m.mv.as_mv;
       if (mb_col == 0) {
         gld_top_mv = gld_left_mv;
@@ -34,9 +34,61 @@ static int get_max_filter_level(const VP9_COMP *cpi) {
 }
 
 
+static void get_filter_band(const VP9_COMMON *cm, int partial_frame,
+                            int *top, int *bottom) {
+  int start_mi_row = 0;
+  int mi_rows_to_filter = cm->mi_rows;
+
+  if (partial_frame && cm->mi_rows > 8) {
+    start_mi_row = cm->mi_rows >> 1;
+    start_mi_row &= 0xfffffff8;
+    mi_rows_to_filter = MAX(cm->mi_rows / 8, 8);
+  }
+
+  *top = MAX((start_mi_row << MI_SIZE_LOG2) - 8, 0);
+  *bottom = MIN(ALIGN_POWER_OF_TWO(start_mi_row + mi_rows_to_filter,
+                                   MI_BLOCK_SIZE_LOG2) << MI_SIZE_LOG2,
+                cm->frame_to_show->y_height);
+}
+
+static YV12_BUFFER_CONFIG get_y_band(const YV12_BUFFER_CONFIG *buf,
+                                     int top, int bottom) {
+  YV12_BUFFER_CONFIG band = *buf;
+  band.y_buffer += top * buf->y_stride;
+  band.y_height = bottom - top;
+  band.y_crop_height = MAX(MIN(bottom, buf->y_crop_height) - top, 0);
+  return band;
+}
+
+static int64_t get_band_sse(const VP9_COMMON *cm,
+                            const YV12_BUFFER_CONFIG *a,
+                            const YV12_BUFFER_CONFIG *b,
+                            int top, int bottom) {
+  const YV12_BUFFER_CONFIG a_band = get_y_band(a, top, bottom);
+  const YV12_BUFFER_CONFIG b_band = get_y_band(b, top, bottom);
+
+  if (a_band.y_crop_height == 0)
+    return 0;
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (cm->use_highbitdepth)
+    return vp9_highbd_get_y_sse(&a_band, &b_band);
+#else
+  (void)cm;
+#endif
+  return vp9_get_y_sse(&a_band, &b_band);
+}
+
+static void copy_y_band(const YV12_BUFFER_CONFIG *src,
+                        YV12_BUFFER_CONFIG *dst, int top, int bottom) {
+  const YV12_BUFFER_CONFIG src_band = get_y_band(src, top, bottom);
+  YV12_BUFFER_CONFIG dst_band = get_y_band(dst, top, bottom);
+  vpx_yv12_copy_y(&src_band, &dst_band);
+}
+
 static int64_t try_filter_frame(const YV12_BUFFER_CONFIG *sd,
                                 VP9_COMP *const cpi,
-                                int filt_level, int partial_frame) {
+                                int filt_level, int partial_frame,
+                                int top, int bottom, int64_t outside_err) {
   VP9_COMMON *const cm = &cpi->common;
   int64_t filt_err;
 
@@ -48,18 +100,10 @@ static int64_t try_filter_frame(const YV12_BUFFER_CONFIG *sd,
     vp9_loop_filter_frame(cm->frame_to_show, cm, &cpi->td.mb.e_mbd, filt_level,
                           1, partial_frame);
 
-#if CONFIG_VP9_HIGHBITDEPTH
-  if (cm->use_highbitdepth) {
-    filt_err = vp9_highbd_get_y_sse(sd, cm->frame_to_show);
-  } else {
-    filt_err = vp9_get_y_sse(sd, cm->frame_to_show);
-  }
-#else
-  filt_err = vp9_get_y_sse(sd, cm->frame_to_show);
-#endif  
+  filt_err = outside_err + get_band_sse(cm, sd, cm->frame_to_show, top, bottom);
 
   
-  vpx_yv12_copy_y(&cpi->last_frame_uf, cm->frame_to_show);
+  copy_y_band(&cpi->last_frame_uf, cm->frame_to_show, top, bottom);
 
   return filt_err;
 }
@@ -72,7 +116,9 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
   const int max_filter_level = get_max_filter_level(cpi);
   int filt_direction = 0;
   int64_t best_err;
+  int64_t outside_err;
   int filt_best;
+  int top, bottom;
 
   
   
@@ -84,10 +130,26 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
   
   memset(ss_err, 0xFF, sizeof(ss_err));
 
+  get_filter_band(cm, partial_frame, &top, &bottom);
+
   
-  vpx_yv12_copy_y(cm->frame_to_show, &cpi->last_frame_uf);
+  copy_y_band(cm->frame_to_show, &cpi->last_frame_uf, top, bottom);
+
+  outside_err = 0;
+  if (top > 0 || bottom < cm->frame_to_show->y_height) {
+#if CONFIG_VP9_HIGHBITDEPTH
+    if (cm->use_highbitdepth)
+      outside_err = vp9_highbd_get_y_sse(sd, cm->frame_to_show);
+    else
+      outside_err = vp9_get_y_sse(sd, cm->frame_to_show);
+#else
+    outside_err = vp9_get_y_sse(sd, cm->frame_to_show);
+#endif
+    outside_err -= get_band_sse(cm, sd, cm->frame_to_show, top, bottom);
+  }
 
-  best_err = try_filter_frame(sd, cpi, filt_mid, partial_frame);
+  best_err = try_filter_frame(sd, cpi, filt_mid, partial_frame,
+                              top, bottom, outside_err);
   filt_best = filt_mid;
   ss_err[filt_mid] = best_err;
 
@@ -108,7 +170,8 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
     if (filt_direction <= 0 && filt_low != filt_mid) {
       
       if (ss_err[filt_low] < 0) {
-        ss_err[filt_low] = try_filter_frame(sd, cpi, filt_low, partial_frame);
+        ss_err[filt_low] = try_filter_frame(sd, cpi, filt_low, partial_frame,
+                                            top, bottom, outside_err);
       }
       
       
@@ -124,7 +187,8 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
     
     if (filt_direction >= 0 && filt_high != filt_mid) {
       if (ss_err[filt_high] < 0) {
-        ss_err[filt_high] = try_filter_frame(sd, cpi, filt_high, partial_frame);
+        ss_err[filt_high] = try_filter_frame(sd, cpi, filt_high, partial_frame,
+                                             top, bottom, outside_err);
       }
       
       if (ss_err[filt_high] < (best_err - bias)) {
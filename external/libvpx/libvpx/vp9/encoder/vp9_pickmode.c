@@ -141,6 +141,7 @@ static int combined_motion_search(VP9_COMP *cpi, MACROBLOCK *x,
   const int tmp_row_max = x->mv_row_max;
   int rv = 0;
   int cost_list[5];
+  const int64_t stage_start = vp9_stage_begin(x);
   const YV12_BUFFER_CONFIG *scaled_ref_frame = vp9_get_scaled_ref_frame(cpi,
                                                                         ref);
   if (scaled_ref_frame) {
@@ -203,6 +204,7 @@ static int combined_motion_search(VP9_COMP *cpi, MACROBLOCK *x,
     for (i = 0; i < MAX_MB_PLANE; i++)
       xd->plane[i].pre[0] = backup_yv12[i];
   }
+  vp9_stage_end(x, STAGE_MOTION_SEARCH, stage_start);
   return rv;
 }
 
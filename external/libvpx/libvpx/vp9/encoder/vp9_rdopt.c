@@ -743,7 +743,7 @@ static int64_t rd_pick_intra4x4block(VP9_COMP *cpi, MACROBLOCK *x,
   const int src_stride = p->src.stride;
   const int dst_stride = pd->dst.stride;
   const uint8_t *src_init = &p->src.buf[row * 4 * src_stride + col * 4];
-  uint8_t *dst_init = &pd->dst.buf[row * 4 * src_stride + col * 4];
+  uint8_t *dst_init = &pd->dst.buf[row * 4 * dst_stride + col * 4];
   ENTROPY_CONTEXT ta[2], tempa[2];
   ENTROPY_CONTEXT tl[2], templ[2];
   const int num_4x4_blocks_wide = num_4x4_blocks_wide_lookup[bsize];
@@ -1507,6 +1507,7 @@ static void joint_motion_search(VP9_COMP *cpi, MACROBLOCK *x,
   int ite, ref;
   const InterpKernel *kernel = vp9_filter_kernels[mbmi->interp_filter];
   struct scale_factors sf;
+  const int64_t stage_start = vp9_stage_begin(x);
 
   
   struct buf_2d backup_yv12[2][MAX_MB_PLANE];
@@ -1672,6 +1673,7 @@ static void joint_motion_search(VP9_COMP *cpi, MACROBLOCK *x,
                                 &x->mbmi_ext->ref_mvs[refs[ref]][0].as_mv,
                                 x->nmvjointcost, x->mvcost, MV_COST_WEIGHT);
   }
+  vp9_stage_end(x, STAGE_MOTION_SEARCH, stage_start);
 }
 
 static int64_t rd_pick_best_sub8x8_mode(VP9_COMP *cpi, MACROBLOCK *x,
@@ -2430,8 +2432,10 @@ static int64_t handle_inter_mode(VP9_COMP *cpi, MACROBLOCK *x,
       *rate2 += rate_mv;
     } else {
       int_mv tmp_mv;
+      const int64_t stage_start = vp9_stage_begin(x);
       single_motion_search(cpi, x, bsize, mi_row, mi_col,
                            &tmp_mv, &rate_mv);
+      vp9_stage_end(x, STAGE_MOTION_SEARCH, stage_start);
       if (tmp_mv.as_int == INVALID_MV)
         return INT64_MAX;
 
@@ -11,9 +11,12 @@
 #include <limits.h>
 
 #include "vp9/encoder/vp9_encoder.h"
+#include "vp9/encoder/vp9_lookahead.h"
 #include "vp9/encoder/vp9_speed_features.h"
 #include "vp9/encoder/vp9_rdopt.h"
 
+#define MAX_RT_SPEED 8
+
 
 static int frame_is_boosted(const VP9_COMP *cpi) {
   return frame_is_kf_gf_arf(cpi) || vp9_is_upper_layer_key_frame(cpi);
@@ -288,6 +291,7 @@ static void set_rt_speed_feature(VP9_COMP *cpi, SPEED_FEATURES *sf,
     sf->use_lp32x32fdct = 1;
     sf->mode_skip_start = 11;
     sf->intra_y_mode_mask[TX_16X16] = INTRA_DC_H_V;
+    sf->lpf_pick = LPF_PICK_FROM_SUBIMAGE;
   }
 
   if (speed >= 3) {
@@ -406,9 +410,10 @@ void vp9_set_speed_features_framesize_dependent(VP9_COMP *cpi) {
   int i;
 
   if (oxcf->mode == REALTIME) {
-    set_rt_speed_feature_framesize_dependent(cpi, sf, oxcf->speed);
+    set_rt_speed_feature_framesize_dependent(cpi, sf, cpi->active_speed);
   } else if (oxcf->mode == GOOD) {
-    set_good_speed_feature_framesize_dependent(cpi, sf, oxcf->speed);
+    set_good_speed_feature_framesize_dependent(cpi, sf,
+                                               cpi->active_speed);
   }
 
   if (sf->disable_split_mask == DISABLE_ALL_SPLIT) {
@@ -509,9 +514,9 @@ void vp9_set_speed_features_framesize_independent(VP9_COMP *cpi) {
   sf->simple_model_rd_from_var = 0;
 
   if (oxcf->mode == REALTIME)
-    set_rt_speed_feature(cpi, sf, oxcf->speed, oxcf->content);
+    set_rt_speed_feature(cpi, sf, cpi->active_speed, oxcf->content);
   else if (oxcf->mode == GOOD)
-    set_good_speed_feature(cpi, cm, sf, oxcf->speed);
+    set_good_speed_feature(cpi, cm, sf, cpi->active_speed);
 
   cpi->full_search_sad = vp9_full_search_sad;
   cpi->diamond_search_sad = oxcf->mode == BEST ? vp9_full_range_search
@@ -547,3 +552,30 @@ void vp9_set_speed_features_framesize_independent(VP9_COMP *cpi) {
     sf->max_delta_qindex = 0;
   }
 }
+
+void vp9_update_rt_speed(VP9_COMP *cpi, int64_t frame_time,
+                         int64_t speed_sensitive_time) {
+  const VP9EncoderConfig *const oxcf = &cpi->oxcf;
+  const int64_t target = (int64_t)cpi->target_frame_time * 1000;
+  int64_t limit;
+
+  if (oxcf->mode != REALTIME || target == 0)
+    return;
+
+  limit = target * (1 + vp9_lookahead_depth(cpi->lookahead));
+  cpi->speed_debt += frame_time - target;
+  if (cpi->speed_debt > limit)
+    cpi->speed_debt = limit;
+  else if (cpi->speed_debt < -limit)
+    cpi->speed_debt = -limit;
+
+  if (cpi->speed_debt > limit / 2 && cpi->active_speed < MAX_RT_SPEED &&
+      4 * speed_sensitive_time >= frame_time) {
+    ++cpi->active_speed;
+    cpi->speed_debt = 0;
+  } else if (cpi->speed_debt < -limit / 2 &&
+             cpi->active_speed > oxcf->speed) {
+    --cpi->active_speed;
+    cpi->speed_debt = 0;
+  }
+}
@@ -425,6 +425,9 @@ struct VP9_COMP;
 void vp9_set_speed_features_framesize_independent(struct VP9_COMP *cpi);
 void vp9_set_speed_features_framesize_dependent(struct VP9_COMP *cpi);
 
+void vp9_update_rt_speed(struct VP9_COMP *cpi, int64_t frame_time,
+                         int64_t speed_sensitive_time);
+
 #ifdef __cplusplus
 }  
 #endif
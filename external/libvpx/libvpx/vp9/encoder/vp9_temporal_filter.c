@@ -35,6 +35,7 @@ static void temporal_filter_predictors_mb_c(MACROBLOCKD *xd,
                                             uint8_t *u_mb_ptr,
                                             uint8_t *v_mb_ptr,
                                             int stride,
+                                            int uv_stride,
                                             int uv_block_width,
                                             int uv_block_height,
                                             int mv_row,
@@ -48,14 +49,10 @@ static void temporal_filter_predictors_mb_c(MACROBLOCKD *xd,
     vp9_filter_kernels[xd->mi[0]->mbmi.interp_filter];
 
   enum mv_precision mv_precision_uv;
-  int uv_stride;
-  if (uv_block_width == 8) {
-    uv_stride = (stride + 1) >> 1;
+  if (uv_block_width == 8)
     mv_precision_uv = MV_PRECISION_Q4;
-  } else {
-    uv_stride = stride;
+  else
     mv_precision_uv = MV_PRECISION_Q3;
-  }
 
 #if CONFIG_VP9_HIGHBITDEPTH
   if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
@@ -212,6 +209,7 @@ void vp9_highbd_temporal_filter_apply_c(uint8_t *frame1_8,
 
 static int temporal_filter_find_matching_mb_c(VP9_COMP *cpi,
                                               uint8_t *arf_frame_buf,
+                                              int arf_stride,
                                               uint8_t *frame_ptr_buf,
                                               int stride) {
   MACROBLOCK *const x = &cpi->td.mb;
@@ -237,7 +235,7 @@ static int temporal_filter_find_matching_mb_c(VP9_COMP *cpi,
 
   
   x->plane[0].src.buf = arf_frame_buf;
-  x->plane[0].src.stride = stride;
+  x->plane[0].src.stride = arf_stride;
   xd->plane[0].pre[0].buf = frame_ptr_buf;
   xd->plane[0].pre[0].stride = stride;
 
@@ -340,10 +338,15 @@ static void temporal_filter_iterate_c(VP9_COMP *cpi,
       for (frame = 0; frame < frame_count; frame++) {
         const int thresh_low  = 10000;
         const int thresh_high = 20000;
+        int y_offset, uv_offset;
 
         if (frames[frame] == NULL)
           continue;
 
+        y_offset = mb_row * 16 * frames[frame]->y_stride + mb_col * 16;
+        uv_offset = mb_row * mb_uv_height * frames[frame]->uv_stride +
+                    mb_col * mb_uv_width;
+
         mbd->mi[0]->bmi[0].as_mv[0].as_mv.row = 0;
         mbd->mi[0]->bmi[0].as_mv[0].as_mv.col = 0;
 
@@ -353,7 +356,8 @@ static void temporal_filter_iterate_c(VP9_COMP *cpi,
           
           int err = temporal_filter_find_matching_mb_c(cpi,
               frames[alt_ref_index]->y_buffer + mb_y_offset,
-              frames[frame]->y_buffer + mb_y_offset,
+              frames[alt_ref_index]->y_stride,
+              frames[frame]->y_buffer + y_offset,
               frames[frame]->y_stride);
 
           
@@ -366,10 +370,10 @@ static void temporal_filter_iterate_c(VP9_COMP *cpi,
         if (filter_weight != 0) {
           
           temporal_filter_predictors_mb_c(mbd,
-              frames[frame]->y_buffer + mb_y_offset,
-              frames[frame]->u_buffer + mb_uv_offset,
-              frames[frame]->v_buffer + mb_uv_offset,
-              frames[frame]->y_stride,
+              frames[frame]->y_buffer + y_offset,
+              frames[frame]->u_buffer + uv_offset,
+              frames[frame]->v_buffer + uv_offset,
+              frames[frame]->y_stride, frames[frame]->uv_stride,
               mb_uv_width, mb_uv_height,
               mbd->mi[0]->bmi[0].as_mv[0].as_mv.row,
               mbd->mi[0]->bmi[0].as_mv[0].as_mv.col,
@@ -441,7 +445,7 @@ static void temporal_filter_iterate_c(VP9_COMP *cpi,
         dst1 = cpi->alt_ref_buffer.y_buffer;
         dst1_16 = CONVERT_TO_SHORTPTR(dst1);
         stride = cpi->alt_ref_buffer.y_stride;
-        byte = mb_y_offset;
+        byte = mb_row * 16 * stride + mb_col * 16;
         for (i = 0, k = 0; i < 16; i++) {
           for (j = 0; j < 16; j++, k++) {
             unsigned int pval = accumulator[k] + (count[k] >> 1);
@@ -462,7 +466,7 @@ static void temporal_filter_iterate_c(VP9_COMP *cpi,
         dst1_16 = CONVERT_TO_SHORTPTR(dst1);
         dst2_16 = CONVERT_TO_SHORTPTR(dst2);
         stride = cpi->alt_ref_buffer.uv_stride;
-        byte = mb_uv_offset;
+        byte = mb_row * mb_uv_height * stride + mb_col * mb_uv_width;
         for (i = 0, k = 256; i < mb_uv_height; i++) {
           for (j = 0; j < mb_uv_width; j++, k++) {
             int m = k + 256;
@@ -489,7 +493,7 @@ static void temporal_filter_iterate_c(VP9_COMP *cpi,
         
         dst1 = cpi->alt_ref_buffer.y_buffer;
         stride = cpi->alt_ref_buffer.y_stride;
-        byte = mb_y_offset;
+        byte = mb_row * 16 * stride + mb_col * 16;
         for (i = 0, k = 0; i < 16; i++) {
           for (j = 0; j < 16; j++, k++) {
             unsigned int pval = accumulator[k] + (count[k] >> 1);
@@ -507,7 +511,7 @@ static void temporal_filter_iterate_c(VP9_COMP *cpi,
         dst1 = cpi->alt_ref_buffer.u_buffer;
         dst2 = cpi->alt_ref_buffer.v_buffer;
         stride = cpi->alt_ref_buffer.uv_stride;
-        byte = mb_uv_offset;
+        byte = mb_row * mb_uv_height * stride + mb_col * mb_uv_width;
         for (i = 0, k = 256; i < mb_uv_height; i++) {
           for (j = 0; j < mb_uv_width; j++, k++) {
             int m = k + 256;
@@ -534,7 +538,7 @@ static void temporal_filter_iterate_c(VP9_COMP *cpi,
       
       dst1 = cpi->alt_ref_buffer.y_buffer;
       stride = cpi->alt_ref_buffer.y_stride;
-      byte = mb_y_offset;
+      byte = mb_row * 16 * stride + mb_col * 16;
       for (i = 0, k = 0; i < 16; i++) {
         for (j = 0; j < 16; j++, k++) {
           unsigned int pval = accumulator[k] + (count[k] >> 1);
@@ -552,7 +556,7 @@ static void temporal_filter_iterate_c(VP9_COMP *cpi,
       dst1 = cpi->alt_ref_buffer.u_buffer;
       dst2 = cpi->alt_ref_buffer.v_buffer;
       stride = cpi->alt_ref_buffer.uv_stride;
-      byte = mb_uv_offset;
+      byte = mb_row * mb_uv_height * stride + mb_col * mb_uv_width;
       for (i = 0, k = 256; i < mb_uv_height; i++) {
         for (j = 0; j < mb_uv_width; j++, k++) {
           int m = k + 256;
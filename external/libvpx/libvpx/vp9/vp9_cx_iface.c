@@ -991,7 +991,8 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t  *ctx,
       
       
       if (vp9_receive_raw_frame(cpi, flags | ctx->next_frame_flags,
-                                &sd, dst_time_stamp, dst_end_time_stamp)) {
+                                &sd, img->fb_priv,
+                                dst_time_stamp, dst_end_time_stamp)) {
         res = update_error_state(ctx, &cpi->common.error);
       }
       ctx->next_frame_flags = 0;
@@ -1282,6 +1283,45 @@ static vpx_codec_err_t ctrl_get_active_map(vpx_codec_alg_priv_t *ctx,
   }
 }
 
+static vpx_codec_err_t ctrl_set_frame_buffer_refs(vpx_codec_alg_priv_t *ctx,
+                                                  va_list args) {
+  const vpx_frame_buffer_refs_t *const refs =
+      va_arg(args, vpx_frame_buffer_refs_t *);
+
+  if (refs == NULL) {
+    memset(&ctx->cpi->fb_refs, 0, sizeof(ctx->cpi->fb_refs));
+    return VPX_CODEC_OK;
+  }
+  if ((refs->retain_cb == NULL) != (refs->release_cb == NULL) ||
+      refs->border < 0)
+    return VPX_CODEC_INVALID_PARAM;
+  ctx->cpi->fb_refs = *refs;
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_stage_timing(vpx_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  vp9_set_stage_timing(ctx->cpi, CAST(VP9E_SET_STAGE_TIMING, args) != 0);
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_get_stage_timing(vpx_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  vpx_stage_timing_t *const timing = va_arg(args, vpx_stage_timing_t *);
+
+  if (timing == NULL)
+    return VPX_CODEC_INVALID_PARAM;
+  *timing = ctx->cpi->stage_timing;
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_target_frame_time(vpx_codec_alg_priv_t *ctx,
+                                                  va_list args) {
+  vp9_set_target_frame_time(ctx->cpi,
+                            CAST(VP9E_SET_TARGET_FRAME_TIME, args));
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t ctrl_set_scale_mode(vpx_codec_alg_priv_t *ctx,
                                            va_list args) {
   vpx_scaling_mode_t *const mode = va_arg(args, vpx_scaling_mode_t *);
@@ -1437,6 +1477,9 @@ static vpx_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   {VP9E_SET_NOISE_SENSITIVITY,        ctrl_set_noise_sensitivity},
   {VP9E_SET_MIN_GF_INTERVAL,          ctrl_set_min_gf_interval},
   {VP9E_SET_MAX_GF_INTERVAL,          ctrl_set_max_gf_interval},
+  {VP9E_SET_FRAME_BUFFER_REFS,        ctrl_set_frame_buffer_refs},
+  {VP9E_SET_STAGE_TIMING,             ctrl_set_stage_timing},
+  {VP9E_SET_TARGET_FRAME_TIME,        ctrl_set_target_frame_time},
 
   
   {VP8E_GET_LAST_QUANTIZER,           ctrl_get_quantizer},
@@ -1444,6 +1487,7 @@ static vpx_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   {VP9_GET_REFERENCE,                 ctrl_get_reference},
   {VP9E_GET_SVC_LAYER_ID,             ctrl_get_svc_layer_id},
   {VP9E_GET_ACTIVEMAP,                ctrl_get_active_map},
+  {VP9E_GET_STAGE_TIMING,             ctrl_get_stage_timing},
 
   { -1, NULL},
 };
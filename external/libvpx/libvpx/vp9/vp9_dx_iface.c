@@ -54,6 +54,7 @@ struct vpx_codec_alg_priv {
   int                     last_show_frame;  
   int                     byte_alignment;
   int                     skip_loop_filter;
+  int                     frame_border;
 
   
   int                     frame_parallel_decode;  
@@ -294,6 +295,7 @@ static void init_buffer_callbacks(vpx_codec_alg_priv_t *ctx) {
     cm->new_fb_idx = INVALID_IDX;
     cm->byte_alignment = ctx->byte_alignment;
     cm->skip_loop_filter = ctx->skip_loop_filter;
+    cm->frame_border = ctx->frame_border;
 
     if (ctx->get_ext_fb_cb != NULL && ctx->release_ext_fb_cb != NULL) {
       pool->get_fb_cb = ctx->get_ext_fb_cb;
@@ -1081,6 +1083,26 @@ static vpx_codec_err_t ctrl_set_skip_loop_filter(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_set_frame_border(vpx_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  const int frame_border = va_arg(args, int);
+  int i;
+
+  if (frame_border != 0 &&
+      (frame_border < VP9_DEC_BORDER_IN_PIXELS ||
+       frame_border > VP9_ENC_BORDER_IN_PIXELS ||
+       (frame_border & 31) != 0))
+    return VPX_CODEC_INVALID_PARAM;
+
+  ctx->frame_border = frame_border;
+  for (i = 0; ctx->frame_workers && i < ctx->num_frame_workers; ++i) {
+    VPxWorker *const worker = &ctx->frame_workers[i];
+    FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+    frame_worker_data->pbi->common.frame_border = frame_border;
+  }
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   {VP8_COPY_REFERENCE,            ctrl_copy_reference},
 
@@ -1095,6 +1117,7 @@ static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   {VPXD_SET_DECRYPTOR,            ctrl_set_decryptor},
   {VP9_SET_BYTE_ALIGNMENT,        ctrl_set_byte_alignment},
   {VP9_SET_SKIP_LOOP_FILTER,      ctrl_set_skip_loop_filter},
+  {VP9_SET_FRAME_BORDER,          ctrl_set_frame_border},
 
   
   {VP8D_GET_LAST_REF_UPDATES,     ctrl_get_last_ref_updates},
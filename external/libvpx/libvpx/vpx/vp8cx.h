@@ -12,6 +12,7 @@
 
 #include "./vp8.h"
 #include "./vpx_encoder.h"
+#include "./vpx_frame_buffer.h"
 
 
 #ifdef __cplusplus
@@ -142,6 +143,14 @@ enum vp8e_enc_control_id {
   VP9E_SET_MAX_GF_INTERVAL,
 
   VP9E_GET_ACTIVEMAP,
+
+  VP9E_SET_FRAME_BUFFER_REFS,
+
+  VP9E_SET_STAGE_TIMING,
+
+  VP9E_GET_STAGE_TIMING,
+
+  VP9E_SET_TARGET_FRAME_TIME,
 };
 
 typedef enum vpx_scaling_mode_1d {
@@ -208,6 +217,18 @@ typedef enum {
   VP8_TUNE_SSIM
 } vp8e_tuning;
 
+typedef struct vpx_stage_timing {
+  uint64_t mode_decision;
+  uint64_t motion_search;
+  uint64_t tokenize;
+  uint64_t temporal_filter;
+  uint64_t loop_filter;
+  uint64_t bitstream;
+  uint64_t frame;
+  unsigned int frames;
+  int speed;
+} vpx_stage_timing_t;
+
 typedef struct vpx_svc_layer_id {
   int spatial_layer_id;       
   int temporal_layer_id;      
@@ -280,6 +301,14 @@ VPX_CTRL_USE_TYPE(VP9E_SET_MAX_GF_INTERVAL,  unsigned int)
 #define VPX_CTRL_VP9E_SET_MAX_GF_INTERVAL
 
 VPX_CTRL_USE_TYPE(VP9E_GET_ACTIVEMAP, vpx_active_map_t *)
+
+VPX_CTRL_USE_TYPE(VP9E_SET_FRAME_BUFFER_REFS, vpx_frame_buffer_refs_t *)
+
+VPX_CTRL_USE_TYPE(VP9E_SET_STAGE_TIMING, int)
+
+VPX_CTRL_USE_TYPE(VP9E_GET_STAGE_TIMING, vpx_stage_timing_t *)
+
+VPX_CTRL_USE_TYPE(VP9E_SET_TARGET_FRAME_TIME, unsigned int)
 #ifdef __cplusplus
 }  
 #endif
@@ -335,6 +335,17 @@ extern "C" {
 #define VPX_DL_REALTIME     (1)        
 #define VPX_DL_GOOD_QUALITY (1000000)  
 #define VPX_DL_BEST_QUALITY (0)        
+  /*!\brief Encode a frame
+   *
+   * A VP9 encoder normally copies img into its lookahead. When the
+   * application has registered callbacks with VP9E_SET_FRAME_BUFFER_REFS
+   * and img->fb_priv is set, the encoder may instead retain the frame and
+   * read it until the matching release callback. It then writes edge
+   * extensions into the memory around the planes, so it only does this when
+   * vpx_frame_buffer_refs_t.border says that memory exists. The stride of
+   * the image alone does not show how many rows are allocated above and
+   * below each plane.
+   */
   vpx_codec_err_t  vpx_codec_encode(vpx_codec_ctx_t            *ctx,
                                     const vpx_image_t          *img,
                                     vpx_codec_pts_t             pts,
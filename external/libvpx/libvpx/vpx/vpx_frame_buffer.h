@@ -34,6 +34,26 @@ typedef int (*vpx_get_frame_buffer_cb_fn_t)(
 typedef int (*vpx_release_frame_buffer_cb_fn_t)(
     void *priv, vpx_codec_frame_buffer_t *fb);
 
+typedef int (*vpx_retain_frame_buffer_cb_fn_t)(
+    void *priv, vpx_codec_frame_buffer_t *fb);
+
+/*!\brief Callbacks that let an encoder hold source frames by reference.
+ *
+ * border is the number of luma pixels of writable memory the application
+ * guarantees on every side of the Y plane of each frame it passes: above
+ * and below the plane, and to its left and right. The chroma planes must
+ * have the same border scaled by the chroma subsampling. The encoder
+ * extends the frame edges into this memory. Frames whose border is too
+ * small for that are copied instead. A border of 0 means frames are always
+ * copied.
+ */
+typedef struct vpx_frame_buffer_refs {
+  vpx_retain_frame_buffer_cb_fn_t retain_cb;
+  vpx_release_frame_buffer_cb_fn_t release_cb;
+  void *cb_priv;
+  int border;
+} vpx_frame_buffer_refs_t;
+
 #ifdef __cplusplus
 }  
 #endif
@@ -0,0 +1,498 @@
+/*
+ *  Copyright (c) 2015 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+
+#include "./vpx_dsp_rtcd.h"
+#include "vpx_dsp/inv_txfm.h"
+#include "vpx_dsp/txfm_common.h"
+#include "vpx_ports/mem.h"
+
+#define pair256_set_epi16(a, b) \
+  _mm256_set_epi16((int16_t)(b), (int16_t)(a), (int16_t)(b), (int16_t)(a), \
+                   (int16_t)(b), (int16_t)(a), (int16_t)(b), (int16_t)(a), \
+                   (int16_t)(b), (int16_t)(a), (int16_t)(b), (int16_t)(a), \
+                   (int16_t)(b), (int16_t)(a), (int16_t)(b), (int16_t)(a))
+
+static INLINE __m256i load_tran_low(const tran_low_t *a) {
+#if CONFIG_VP9_HIGHBITDEPTH
+  const __m256i lo = _mm256_loadu_si256((const __m256i *)a);
+  const __m256i hi = _mm256_loadu_si256((const __m256i *)(a + 8));
+  return _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xd8);
+#else
+  return _mm256_loadu_si256((const __m256i *)a);
+#endif
+}
+
+static INLINE void butterfly(__m256i a, __m256i b, __m256i c0, __m256i c1,
+                             __m256i *out0, __m256i *out1) {
+  const __m256i rounding = _mm256_set1_epi32(DCT_CONST_ROUNDING);
+  const __m256i lo = _mm256_unpacklo_epi16(a, b);
+  const __m256i hi = _mm256_unpackhi_epi16(a, b);
+  __m256i u0 = _mm256_madd_epi16(lo, c0);
+  __m256i u1 = _mm256_madd_epi16(hi, c0);
+  __m256i v0 = _mm256_madd_epi16(lo, c1);
+  __m256i v1 = _mm256_madd_epi16(hi, c1);
+
+  u0 = _mm256_srai_epi32(_mm256_add_epi32(u0, rounding), DCT_CONST_BITS);
+  u1 = _mm256_srai_epi32(_mm256_add_epi32(u1, rounding), DCT_CONST_BITS);
+  v0 = _mm256_srai_epi32(_mm256_add_epi32(v0, rounding), DCT_CONST_BITS);
+  v1 = _mm256_srai_epi32(_mm256_add_epi32(v1, rounding), DCT_CONST_BITS);
+
+  *out0 = _mm256_packs_epi32(u0, u1);
+  *out1 = _mm256_packs_epi32(v0, v1);
+}
+
+static INLINE void transpose_8x8_in_lane(const __m256i *in, __m256i *out) {
+  const __m256i tr0_0 = _mm256_unpacklo_epi16(in[0], in[1]);
+  const __m256i tr0_1 = _mm256_unpacklo_epi16(in[2], in[3]);
+  const __m256i tr0_2 = _mm256_unpackhi_epi16(in[0], in[1]);
+  const __m256i tr0_3 = _mm256_unpackhi_epi16(in[2], in[3]);
+  const __m256i tr0_4 = _mm256_unpacklo_epi16(in[4], in[5]);
+  const __m256i tr0_5 = _mm256_unpacklo_epi16(in[6], in[7]);
+  const __m256i tr0_6 = _mm256_unpackhi_epi16(in[4], in[5]);
+  const __m256i tr0_7 = _mm256_unpackhi_epi16(in[6], in[7]);
+
+  const __m256i tr1_0 = _mm256_unpacklo_epi32(tr0_0, tr0_1);
+  const __m256i tr1_1 = _mm256_unpacklo_epi32(tr0_4, tr0_5);
+  const __m256i tr1_2 = _mm256_unpackhi_epi32(tr0_0, tr0_1);
+  const __m256i tr1_3 = _mm256_unpackhi_epi32(tr0_4, tr0_5);
+  const __m256i tr1_4 = _mm256_unpacklo_epi32(tr0_2, tr0_3);
+  const __m256i tr1_5 = _mm256_unpacklo_epi32(tr0_6, tr0_7);
+  const __m256i tr1_6 = _mm256_unpackhi_epi32(tr0_2, tr0_3);
+  const __m256i tr1_7 = _mm256_unpackhi_epi32(tr0_6, tr0_7);
+
+  out[0] = _mm256_unpacklo_epi64(tr1_0, tr1_1);
+  out[1] = _mm256_unpackhi_epi64(tr1_0, tr1_1);
+  out[2] = _mm256_unpacklo_epi64(tr1_2, tr1_3);
+  out[3] = _mm256_unpackhi_epi64(tr1_2, tr1_3);
+  out[4] = _mm256_unpacklo_epi64(tr1_4, tr1_5);
+  out[5] = _mm256_unpackhi_epi64(tr1_4, tr1_5);
+  out[6] = _mm256_unpacklo_epi64(tr1_6, tr1_7);
+  out[7] = _mm256_unpackhi_epi64(tr1_6, tr1_7);
+}
+
+static INLINE void transpose_16x16(const __m256i *in, __m256i *out) {
+  __m256i top[8], bottom[8];
+  int i;
+
+  transpose_8x8_in_lane(in, top);
+  transpose_8x8_in_lane(in + 8, bottom);
+  for (i = 0; i < 8; ++i) {
+    out[i] = _mm256_permute2x128_si256(top[i], bottom[i], 0x20);
+    out[i + 8] = _mm256_permute2x128_si256(top[i], bottom[i], 0x31);
+  }
+}
+
+static void idct16_avx2(const __m256i *in, __m256i *out) {
+  const __m256i k__cospi_p16_p16 = _mm256_set1_epi16((int16_t)cospi_16_64);
+  const __m256i k__cospi_m16_p16 = pair256_set_epi16(-cospi_16_64,
+                                                     cospi_16_64);
+  const __m256i k__cospi_p16_m16 = pair256_set_epi16(cospi_16_64,
+                                                     -cospi_16_64);
+  const __m256i k__cospi_m08_p24 = pair256_set_epi16(-cospi_8_64,
+                                                     cospi_24_64);
+  const __m256i k__cospi_p24_p08 = pair256_set_epi16(cospi_24_64, cospi_8_64);
+  const __m256i k__cospi_m24_m08 = pair256_set_epi16(-cospi_24_64,
+                                                     -cospi_8_64);
+  __m256i s1[16], s2[16];
+
+  butterfly(in[1], in[15], pair256_set_epi16(cospi_30_64, -cospi_2_64),
+            pair256_set_epi16(cospi_2_64, cospi_30_64), &s2[8], &s2[15]);
+  butterfly(in[9], in[7], pair256_set_epi16(cospi_14_64, -cospi_18_64),
+            pair256_set_epi16(cospi_18_64, cospi_14_64), &s2[9], &s2[14]);
+  butterfly(in[5], in[11], pair256_set_epi16(cospi_22_64, -cospi_10_64),
+            pair256_set_epi16(cospi_10_64, cospi_22_64), &s2[10], &s2[13]);
+  butterfly(in[13], in[3], pair256_set_epi16(cospi_6_64, -cospi_26_64),
+            pair256_set_epi16(cospi_26_64, cospi_6_64), &s2[11], &s2[12]);
+
+  butterfly(in[2], in[14], pair256_set_epi16(cospi_28_64, -cospi_4_64),
+            pair256_set_epi16(cospi_4_64, cospi_28_64), &s1[4], &s1[7]);
+  butterfly(in[10], in[6], pair256_set_epi16(cospi_12_64, -cospi_20_64),
+            pair256_set_epi16(cospi_20_64, cospi_12_64), &s1[5], &s1[6]);
+  s1[8] = _mm256_add_epi16(s2[8], s2[9]);
+  s1[9] = _mm256_sub_epi16(s2[8], s2[9]);
+  s1[10] = _mm256_sub_epi16(s2[11], s2[10]);
+  s1[11] = _mm256_add_epi16(s2[10], s2[11]);
+  s1[12] = _mm256_add_epi16(s2[12], s2[13]);
+  s1[13] = _mm256_sub_epi16(s2[12], s2[13]);
+  s1[14] = _mm256_sub_epi16(s2[15], s2[14]);
+  s1[15] = _mm256_add_epi16(s2[14], s2[15]);
+
+  butterfly(in[0], in[8], k__cospi_p16_p16, k__cospi_p16_m16, &s2[0], &s2[1]);
+  butterfly(in[4], in[12], pair256_set_epi16(cospi_24_64, -cospi_8_64),
+            pair256_set_epi16(cospi_8_64, cospi_24_64), &s2[2], &s2[3]);
+  s2[4] = _mm256_add_epi16(s1[4], s1[5]);
+  s2[5] = _mm256_sub_epi16(s1[4], s1[5]);
+  s2[6] = _mm256_sub_epi16(s1[7], s1[6]);
+  s2[7] = _mm256_add_epi16(s1[6], s1[7]);
+  s2[8] = s1[8];
+  butterfly(s1[9], s1[14], k__cospi_m08_p24, k__cospi_p24_p08,
+            &s2[9], &s2[14]);
+  butterfly(s1[10], s1[13], k__cospi_m24_m08, k__cospi_m08_p24,
+            &s2[10], &s2[13]);
+  s2[11] = s1[11];
+  s2[12] = s1[12];
+  s2[15] = s1[15];
+
+  s1[0] = _mm256_add_epi16(s2[0], s2[3]);
+  s1[1] = _mm256_add_epi16(s2[1], s2[2]);
+  s1[2] = _mm256_sub_epi16(s2[1], s2[2]);
+  s1[3] = _mm256_sub_epi16(s2[0], s2[3]);
+  s1[4] = s2[4];
+  butterfly(s2[5], s2[6], k__cospi_m16_p16, k__cospi_p16_p16, &s1[5], &s1[6]);
+  s1[7] = s2[7];
+  s1[8] = _mm256_add_epi16(s2[8], s2[11]);
+  s1[9] = _mm256_add_epi16(s2[9], s2[10]);
+  s1[10] = _mm256_sub_epi16(s2[9], s2[10]);
+  s1[11] = _mm256_sub_epi16(s2[8], s2[11]);
+  s1[12] = _mm256_sub_epi16(s2[15], s2[12]);
+  s1[13] = _mm256_sub_epi16(s2[14], s2[13]);
+  s1[14] = _mm256_add_epi16(s2[13], s2[14]);
+  s1[15] = _mm256_add_epi16(s2[12], s2[15]);
+
+  s2[0] = _mm256_add_epi16(s1[0], s1[7]);
+  s2[1] = _mm256_add_epi16(s1[1], s1[6]);
+  s2[2] = _mm256_add_epi16(s1[2], s1[5]);
+  s2[3] = _mm256_add_epi16(s1[3], s1[4]);
+  s2[4] = _mm256_sub_epi16(s1[3], s1[4]);
+  s2[5] = _mm256_sub_epi16(s1[2], s1[5]);
+  s2[6] = _mm256_sub_epi16(s1[1], s1[6]);
+  s2[7] = _mm256_sub_epi16(s1[0], s1[7]);
+  s2[8] = s1[8];
+  s2[9] = s1[9];
+  butterfly(s1[10], s1[13], k__cospi_m16_p16, k__cospi_p16_p16,
+            &s2[10], &s2[13]);
+  butterfly(s1[11], s1[12], k__cospi_m16_p16, k__cospi_p16_p16,
+            &s2[11], &s2[12]);
+  s2[14] = s1[14];
+  s2[15] = s1[15];
+
+  out[0] = _mm256_add_epi16(s2[0], s2[15]);
+  out[1] = _mm256_add_epi16(s2[1], s2[14]);
+  out[2] = _mm256_add_epi16(s2[2], s2[13]);
+  out[3] = _mm256_add_epi16(s2[3], s2[12]);
+  out[4] = _mm256_add_epi16(s2[4], s2[11]);
+  out[5] = _mm256_add_epi16(s2[5], s2[10]);
+  out[6] = _mm256_add_epi16(s2[6], s2[9]);
+  out[7] = _mm256_add_epi16(s2[7], s2[8]);
+  out[8] = _mm256_sub_epi16(s2[7], s2[8]);
+  out[9] = _mm256_sub_epi16(s2[6], s2[9]);
+  out[10] = _mm256_sub_epi16(s2[5], s2[10]);
+  out[11] = _mm256_sub_epi16(s2[4], s2[11]);
+  out[12] = _mm256_sub_epi16(s2[3], s2[12]);
+  out[13] = _mm256_sub_epi16(s2[2], s2[13]);
+  out[14] = _mm256_sub_epi16(s2[1], s2[14]);
+  out[15] = _mm256_sub_epi16(s2[0], s2[15]);
+}
+
+#if !CONFIG_VP9_HIGHBITDEPTH
+static void idct32_avx2(const __m256i *in, __m256i *out) {
+  const __m256i k__cospi_p16_p16 = _mm256_set1_epi16((int16_t)cospi_16_64);
+  const __m256i k__cospi_m16_p16 = pair256_set_epi16(-cospi_16_64,
+                                                     cospi_16_64);
+  const __m256i k__cospi_m08_p24 = pair256_set_epi16(-cospi_8_64,
+                                                     cospi_24_64);
+  const __m256i k__cospi_p24_p08 = pair256_set_epi16(cospi_24_64, cospi_8_64);
+  const __m256i k__cospi_m24_m08 = pair256_set_epi16(-cospi_24_64,
+                                                     -cospi_8_64);
+  __m256i even_in[16], even[16], s[32], t[32];
+  int i;
+
+  for (i = 0; i < 16; ++i)
+    even_in[i] = in[2 * i];
+  idct16_avx2(even_in, even);
+
+  butterfly(in[1], in[31], pair256_set_epi16(cospi_31_64, -cospi_1_64),
+            pair256_set_epi16(cospi_1_64, cospi_31_64), &s[16], &s[31]);
+  butterfly(in[17], in[15], pair256_set_epi16(cospi_15_64, -cospi_17_64),
+            pair256_set_epi16(cospi_17_64, cospi_15_64), &s[17], &s[30]);
+  butterfly(in[9], in[23], pair256_set_epi16(cospi_23_64, -cospi_9_64),
+            pair256_set_epi16(cospi_9_64, cospi_23_64), &s[18], &s[29]);
+  butterfly(in[25], in[7], pair256_set_epi16(cospi_7_64, -cospi_25_64),
+            pair256_set_epi16(cospi_25_64, cospi_7_64), &s[19], &s[28]);
+  butterfly(in[5], in[27], pair256_set_epi16(cospi_27_64, -cospi_5_64),
+            pair256_set_epi16(cospi_5_64, cospi_27_64), &s[20], &s[27]);
+  butterfly(in[21], in[11], pair256_set_epi16(cospi_11_64, -cospi_21_64),
+            pair256_set_epi16(cospi_21_64, cospi_11_64), &s[21], &s[26]);
+  butterfly(in[13], in[19], pair256_set_epi16(cospi_19_64, -cospi_13_64),
+            pair256_set_epi16(cospi_13_64, cospi_19_64), &s[22], &s[25]);
+  butterfly(in[29], in[3], pair256_set_epi16(cospi_3_64, -cospi_29_64),
+            pair256_set_epi16(cospi_29_64, cospi_3_64), &s[23], &s[24]);
+
+  for (i = 16; i < 32; i += 4) {
+    t[i] = _mm256_add_epi16(s[i], s[i + 1]);
+    t[i + 1] = _mm256_sub_epi16(s[i], s[i + 1]);
+    t[i + 2] = _mm256_sub_epi16(s[i + 3], s[i + 2]);
+    t[i + 3] = _mm256_add_epi16(s[i + 2], s[i + 3]);
+  }
+
+  s[16] = t[16];
+  butterfly(t[17], t[30], pair256_set_epi16(-cospi_4_64, cospi_28_64),
+            pair256_set_epi16(cospi_28_64, cospi_4_64), &s[17], &s[30]);
+  butterfly(t[18], t[29], pair256_set_epi16(-cospi_28_64, -cospi_4_64),
+            pair256_set_epi16(-cospi_4_64, cospi_28_64), &s[18], &s[29]);
+  s[19] = t[19];
+  s[20] = t[20];
+  butterfly(t[21], t[26], pair256_set_epi16(-cospi_20_64, cospi_12_64),
+            pair256_set_epi16(cospi_12_64, cospi_20_64), &s[21], &s[26]);
+  butterfly(t[22], t[25], pair256_set_epi16(-cospi_12_64, -cospi_20_64),
+            pair256_set_epi16(-cospi_20_64, cospi_12_64), &s[22], &s[25]);
+  s[23] = t[23];
+  s[24] = t[24];
+  s[27] = t[27];
+  s[28] = t[28];
+  s[31] = t[31];
+
+  t[16] = _mm256_add_epi16(s[16], s[19]);
+  t[17] = _mm256_add_epi16(s[17], s[18]);
+  t[18] = _mm256_sub_epi16(s[17], s[18]);
+  t[19] = _mm256_sub_epi16(s[16], s[19]);
+  t[20] = _mm256_sub_epi16(s[23], s[20]);
+  t[21] = _mm256_sub_epi16(s[22], s[21]);
+  t[22] = _mm256_add_epi16(s[21], s[22]);
+  t[23] = _mm256_add_epi16(s[20], s[23]);
+  t[24] = _mm256_add_epi16(s[24], s[27]);
+  t[25] = _mm256_add_epi16(s[25], s[26]);
+  t[26] = _mm256_sub_epi16(s[25], s[26]);
+  t[27] = _mm256_sub_epi16(s[24], s[27]);
+  t[28] = _mm256_sub_epi16(s[31], s[28]);
+  t[29] = _mm256_sub_epi16(s[30], s[29]);
+  t[30] = _mm256_add_epi16(s[29], s[30]);
+  t[31] = _mm256_add_epi16(s[28], s[31]);
+
+  s[16] = t[16];
+  s[17] = t[17];
+  butterfly(t[18], t[29], k__cospi_m08_p24, k__cospi_p24_p08, &s[18], &s[29]);
+  butterfly(t[19], t[28], k__cospi_m08_p24, k__cospi_p24_p08, &s[19], &s[28]);
+  butterfly(t[20], t[27], k__cospi_m24_m08, k__cospi_m08_p24, &s[20], &s[27]);
+  butterfly(t[21], t[26], k__cospi_m24_m08, k__cospi_m08_p24, &s[21], &s[26]);
+  s[22] = t[22];
+  s[23] = t[23];
+  s[24] = t[24];
+  s[25] = t[25];
+  s[30] = t[30];
+  s[31] = t[31];
+
+  t[16] = _mm256_add_epi16(s[16], s[23]);
+  t[17] = _mm256_add_epi16(s[17], s[22]);
+  t[18] = _mm256_add_epi16(s[18], s[21]);
+  t[19] = _mm256_add_epi16(s[19], s[20]);
+  t[20] = _mm256_sub_epi16(s[19], s[20]);
+  t[21] = _mm256_sub_epi16(s[18], s[21]);
+  t[22] = _mm256_sub_epi16(s[17], s[22]);
+  t[23] = _mm256_sub_epi16(s[16], s[23]);
+  t[24] = _mm256_sub_epi16(s[31], s[24]);
+  t[25] = _mm256_sub_epi16(s[30], s[25]);
+  t[26] = _mm256_sub_epi16(s[29], s[26]);
+  t[27] = _mm256_sub_epi16(s[28], s[27]);
+  t[28] = _mm256_add_epi16(s[27], s[28]);
+  t[29] = _mm256_add_epi16(s[26], s[29]);
+  t[30] = _mm256_add_epi16(s[25], s[30]);
+  t[31] = _mm256_add_epi16(s[24], s[31]);
+
+  for (i = 20; i < 24; ++i)
+    butterfly(t[i], t[47 - i], k__cospi_m16_p16, k__cospi_p16_p16,
+              &t[i], &t[47 - i]);
+
+  for (i = 0; i < 16; ++i) {
+    out[i] = _mm256_add_epi16(even[i], t[31 - i]);
+    out[31 - i] = _mm256_sub_epi16(even[i], t[31 - i]);
+  }
+}
+
+static INLINE void recon_and_store_16(uint8_t *dest, __m256i in) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m128i d = _mm_loadu_si128((const __m128i *)dest);
+  __m256i x = _mm256_add_epi16(_mm256_cvtepu8_epi16(d), in);
+  x = _mm256_permute4x64_epi64(_mm256_packus_epi16(x, zero), 0x08);
+  _mm_storeu_si128((__m128i *)dest, _mm256_castsi256_si128(x));
+}
+
+static INLINE void round_shift_recon_16(uint8_t *dest, int stride,
+                                        const __m256i *in, int rows) {
+  const __m256i rounding = _mm256_set1_epi16(32);
+  int i;
+
+  for (i = 0; i < rows; ++i) {
+    const __m256i x = _mm256_srai_epi16(_mm256_adds_epi16(in[i], rounding), 6);
+    recon_and_store_16(dest + i * stride, x);
+  }
+}
+
+void vpx_idct16x16_256_add_avx2(const tran_low_t *input, uint8_t *dest,
+                                int stride) {
+  __m256i in[16], out[16];
+  int i;
+
+  for (i = 0; i < 16; ++i)
+    in[i] = load_tran_low(input + i * 16);
+
+  transpose_16x16(in, out);
+  idct16_avx2(out, in);
+  transpose_16x16(in, out);
+  idct16_avx2(out, in);
+
+  round_shift_recon_16(dest, stride, in, 16);
+}
+
+void vpx_idct32x32_1024_add_avx2(const tran_low_t *input, uint8_t *dest,
+                                 int stride) {
+  DECLARE_ALIGNED(32, int16_t, buf[32 * 32]);
+  __m256i in[32], out[32];
+  int i, j;
+
+  for (i = 0; i < 32; i += 16) {
+    __m256i nonzero = _mm256_setzero_si256();
+    for (j = 0; j < 16; ++j) {
+      in[j] = load_tran_low(input + (i + j) * 32);
+      in[j + 16] = load_tran_low(input + (i + j) * 32 + 16);
+      nonzero = _mm256_or_si256(nonzero, _mm256_or_si256(in[j], in[j + 16]));
+    }
+
+    if (_mm256_testz_si256(nonzero, nonzero)) {
+      for (j = 0; j < 16; ++j) {
+        _mm256_store_si256((__m256i *)(buf + (i + j) * 32), nonzero);
+        _mm256_store_si256((__m256i *)(buf + (i + j) * 32 + 16), nonzero);
+      }
+      continue;
+    }
+
+    transpose_16x16(in, out);
+    transpose_16x16(in + 16, out + 16);
+    idct32_avx2(out, in);
+    transpose_16x16(in, out);
+    transpose_16x16(in + 16, out + 16);
+
+    for (j = 0; j < 16; ++j) {
+      _mm256_store_si256((__m256i *)(buf + (i + j) * 32), out[j]);
+      _mm256_store_si256((__m256i *)(buf + (i + j) * 32 + 16), out[j + 16]);
+    }
+  }
+
+  for (i = 0; i < 32; i += 16) {
+    for (j = 0; j < 32; ++j)
+      in[j] = _mm256_load_si256((const __m256i *)(buf + j * 32 + i));
+    idct32_avx2(in, out);
+    round_shift_recon_16(dest + i, stride, out, 32);
+  }
+}
+
+static INLINE void dc_add_16x2(uint8_t *dest, int stride, __m256i add,
+                               __m256i sub) {
+  __m256i d = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)dest));
+  d = _mm256_inserti128_si256(
+      d, _mm_loadu_si128((const __m128i *)(dest + stride)), 1);
+  d = _mm256_subs_epu8(_mm256_adds_epu8(d, add), sub);
+  _mm_storeu_si128((__m128i *)dest, _mm256_castsi256_si128(d));
+  _mm_storeu_si128((__m128i *)(dest + stride),
+                   _mm256_extracti128_si256(d, 1));
+}
+
+static INLINE int idct_dc_value(const tran_low_t *input) {
+  int a = dct_const_round_shift(input[0] * cospi_16_64);
+  a = dct_const_round_shift(a * cospi_16_64);
+  return ROUND_POWER_OF_TWO(a, 6);
+}
+
+void vpx_idct16x16_1_add_avx2(const tran_low_t *input, uint8_t *dest,
+                              int stride) {
+  const int a = idct_dc_value(input);
+  const __m256i add = _mm256_set1_epi8((char)(a > 0 ? MIN(a, 255) : 0));
+  const __m256i sub = _mm256_set1_epi8((char)(a < 0 ? MIN(-a, 255) : 0));
+  int i;
+
+  for (i = 0; i < 16; i += 2)
+    dc_add_16x2(dest + i * stride, stride, add, sub);
+}
+
+void vpx_idct32x32_1_add_avx2(const tran_low_t *input, uint8_t *dest,
+                              int stride) {
+  const int a = idct_dc_value(input);
+  const __m256i add = _mm256_set1_epi8((char)(a > 0 ? MIN(a, 255) : 0));
+  const __m256i sub = _mm256_set1_epi8((char)(a < 0 ? MIN(-a, 255) : 0));
+  int i;
+
+  for (i = 0; i < 32; ++i) {
+    __m256i d = _mm256_loadu_si256((const __m256i *)dest);
+    d = _mm256_subs_epu8(_mm256_adds_epu8(d, add), sub);
+    _mm256_storeu_si256((__m256i *)dest, d);
+    dest += stride;
+  }
+}
+#else
+static INLINE int out_of_range_16x16(const __m256i *in) {
+  const __m256i max = _mm256_set1_epi16(3155);
+  const __m256i min = _mm256_set1_epi16(-3155);
+  __m256i hi = in[0], lo = in[0];
+  int i;
+
+  for (i = 1; i < 16; ++i) {
+    hi = _mm256_max_epi16(hi, in[i]);
+    lo = _mm256_min_epi16(lo, in[i]);
+  }
+  hi = _mm256_or_si256(_mm256_cmpgt_epi16(hi, max),
+                       _mm256_cmpgt_epi16(min, lo));
+  return !_mm256_testz_si256(hi, hi);
+}
+
+void vpx_highbd_idct16x16_256_add_avx2(const tran_low_t *input, uint8_t *dest8,
+                                       int stride, int bd) {
+  tran_low_t out[16 * 16];
+  tran_low_t temp_in[16], temp_out[16];
+  uint16_t *dest = CONVERT_TO_SHORTPTR(dest8);
+  __m256i in[16], tmp[16];
+  int i, j;
+
+  for (i = 0; i < 16; ++i)
+    in[i] = load_tran_low(input + i * 16);
+
+  if (out_of_range_16x16(in)) {
+    vpx_highbd_idct16x16_256_add_c(input, dest8, stride, bd);
+    return;
+  }
+
+  transpose_16x16(in, tmp);
+  idct16_avx2(tmp, in);
+  transpose_16x16(in, tmp);
+
+  if (!out_of_range_16x16(tmp)) {
+    const __m256i rounding = _mm256_set1_epi16(32);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i max = _mm256_set1_epi16((1 << bd) - 1);
+    idct16_avx2(tmp, in);
+    for (i = 0; i < 16; ++i) {
+      const __m256i x = _mm256_srai_epi16(_mm256_add_epi16(in[i], rounding), 6);
+      __m256i d = _mm256_loadu_si256((const __m256i *)(dest + i * stride));
+      d = _mm256_min_epi16(_mm256_max_epi16(_mm256_add_epi16(d, x), zero),
+                           max);
+      _mm256_storeu_si256((__m256i *)(dest + i * stride), d);
+    }
+    return;
+  }
+
+  for (i = 0; i < 16; ++i) {
+    _mm256_storeu_si256((__m256i *)(out + i * 16),
+                        _mm256_cvtepi16_epi32(_mm256_castsi256_si128(tmp[i])));
+    _mm256_storeu_si256((__m256i *)(out + i * 16 + 8),
+                        _mm256_cvtepi16_epi32(
+                            _mm256_extracti128_si256(tmp[i], 1)));
+  }
+  for (i = 0; i < 16; ++i) {
+    for (j = 0; j < 16; ++j)
+      temp_in[j] = out[j * 16 + i];
+    vpx_highbd_idct16_c(temp_in, temp_out, bd);
+    for (j = 0; j < 16; ++j) {
+      dest[j * stride + i] = highbd_clip_pixel_add(
+          dest[j * stride + i], ROUND_POWER_OF_TWO(temp_out[j], 6), bd);
+    }
+  }
+}
+#endif
@@ -25,6 +25,7 @@
 #include <windows.h>
 #else
 #include <sys/time.h>
+#include <time.h>
 
 #ifndef timersub
 #define timersub(a, b, result) \
@@ -86,6 +87,29 @@ vpx_usec_timer_elapsed(struct vpx_usec_timer *t) {
 #endif
 }
 
+
+static INLINE int64_t
+vpx_nsec_timestamp(void) {
+#if defined(_WIN32)
+  LARGE_INTEGER count, freq;
+
+  QueryPerformanceCounter(&count);
+  QueryPerformanceFrequency(&freq);
+  return (count.QuadPart / freq.QuadPart) * 1000000000 +
+         (count.QuadPart % freq.QuadPart) * 1000000000 / freq.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#else
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return ((int64_t)tv.tv_sec * 1000000 + tv.tv_usec) * 1000;
+#endif
+}
+
 #else 
 
 #ifndef timersub
@@ -107,6 +131,11 @@ vpx_usec_timer_elapsed(struct vpx_usec_timer *t) {
   return 0;
 }
 
+static INLINE int64_t
+vpx_nsec_timestamp(void) {
+  return 0;
+}
+
 #endif 
 
 #endif  
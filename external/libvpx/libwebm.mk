@@ -7,3 +7,23 @@ LOCAL_SRC_FILES := libwebm/mkvparser.cpp
 LOCAL_MODULE := libwebm
 
 include $(BUILD_STATIC_LIBRARY)
+
+# StreamParser tests; run from external/libvpx/libwebm, or point
+# LIBWEBM_TEST_DATA_PATH at testing/testdata.
+include $(CLEAR_VARS)
+LOCAL_MODULE := libwebm_stream_parser_test
+LOCAL_MODULE_TAGS := tests
+LOCAL_CPP_EXTENSION := .cc
+LOCAL_C_INCLUDES := $(LOCAL_PATH)/libwebm
+LOCAL_SRC_FILES := libwebm/testing/stream_parser_test.cc
+LOCAL_STATIC_LIBRARIES := libwebm
+include $(BUILD_NATIVE_TEST)
+
+include $(CLEAR_VARS)
+LOCAL_MODULE := webm_stream_parser_benchmark
+LOCAL_MODULE_TAGS := optional
+LOCAL_CPP_EXTENSION := .cc
+LOCAL_C_INCLUDES := $(LOCAL_PATH)/libwebm
+LOCAL_SRC_FILES := libwebm/testing/stream_parser_benchmark.cc \
+                   libwebm/mkvparser.cpp
+include $(BUILD_HOST_EXECUTABLE)
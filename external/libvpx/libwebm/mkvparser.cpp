@@ -7262,6 +7262,13 @@ long Block::Parse(const Cluster* pCluster) {
   if (pCluster->m_pSegment == NULL)
     return -1;
 
+  return Parse(pCluster->m_pSegment->m_pReader);
+}
+
+long Block::Parse(IMkvReader* pReader) {
+  if (pReader == NULL)
+    return -1;
+
   assert(m_start >= 0);
   assert(m_size >= 0);
   assert(m_track <= 0);
@@ -7273,8 +7280,6 @@ long Block::Parse(const Cluster* pCluster) {
 
   long len;
 
-  IMkvReader* const pReader = pCluster->m_pSegment->m_pReader;
-
   m_track = ReadUInt(pReader, pos, len);
 
   if (m_track <= 0)
@@ -7695,4 +7700,519 @@ long Block::Frame::Read(IMkvReader* pReader, unsigned char* buf) const {
 
 long long Block::GetDiscardPadding() const { return m_discard_padding; }
 
+
+namespace {
+
+// Serves reads from a caller-owned buffer holding the stream bytes starting
+// at absolute offset |base|. The parser checks every range against the
+// available data first, so a read outside the buffer is an error.
+class BufferReader : public IMkvReader {
+ public:
+  BufferReader(const unsigned char* buf, long len, long long base)
+      : m_buf(buf), m_len(len), m_base(base) {}
+  virtual ~BufferReader() {}
+
+  virtual int Read(long long pos, long len, unsigned char* buf) {
+    if (pos < m_base || len < 0 || (pos - m_base) + len > m_len)
+      return -1;
+
+    memcpy(buf, m_buf + (pos - m_base), len);
+    return 0;
+  }
+
+  virtual int Length(long long* total, long long* available) {
+    if (total)
+      *total = -1;
+    if (available)
+      *available = m_base + m_len;
+    return 0;
+  }
+
+ private:
+  const unsigned char* const m_buf;
+  const long m_len;
+  const long long m_base;
+};
+
+// Reads the ID and size of the element at |pos|, which must lie before
+// |avail|. |size| is set to -1 for an element of unknown size.
+long ReadElementHeader(IMkvReader* pReader, long long pos, long long avail,
+                       long long& id, long long& size, long& header_len) {
+  long len;
+
+  if (pos >= avail)
+    return E_BUFFER_NOT_FULL;
+
+  long long result = GetUIntLength(pReader, pos, len);
+
+  if (result < 0)
+    return static_cast<long>(result);
+
+  if (result > 0 || (pos + len) > avail)
+    return E_BUFFER_NOT_FULL;
+
+  id = ReadID(pReader, pos, len);
+
+  if (id < 0)
+    return E_FILE_FORMAT_INVALID;
+
+  const long long size_pos = pos + len;
+
+  if (size_pos >= avail)
+    return E_BUFFER_NOT_FULL;
+
+  result = GetUIntLength(pReader, size_pos, len);
+
+  if (result < 0)
+    return static_cast<long>(result);
+
+  if (result > 0 || (size_pos + len) > avail)
+    return E_BUFFER_NOT_FULL;
+
+  if (len > 8)
+    return E_FILE_FORMAT_INVALID;
+
+  size = ReadUInt(pReader, size_pos, len);
+
+  if (size < 0)
+    return static_cast<long>(size);
+
+  const long long unknown_size = (1LL << (7 * len)) - 1;
+
+  if (size == unknown_size)
+    size = -1;
+
+  header_len = static_cast<long>(size_pos + len - pos);
+  return 0;
+}
+
+bool IsSegmentChild(long long id) {
+  switch (id) {
+    case 0x014D9B74:  // SeekHead ID
+    case 0x0549A966:  // Segment Info ID
+    case 0x0654AE6B:  // Tracks ID
+    case 0x0F43B675:  // Cluster ID
+    case 0x0C53BB6B:  // Cues ID
+    case 0x0141A469:  // Attachments ID
+    case 0x0043A770:  // Chapters ID
+    case 0x0254C367:  // Tags ID
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+StreamParser::Callback::~Callback() {}
+
+StreamParser::StreamParser(Callback* pCallback)
+    : m_pCallback(pCallback),
+      m_state(kTopLevel),
+      m_pos(0),
+      m_skip(0),
+      m_segment_stop(-1),
+      m_cluster_stop(-1),
+      m_cluster_timecode(0),
+      m_timecode_scale(1000000) {}
+
+long long StreamParser::GetPosition() const { return m_pos; }
+
+long long StreamParser::GetTimecodeScale() const { return m_timecode_scale; }
+
+long StreamParser::Parse(const unsigned char* buf, long len, long& consumed) {
+  consumed = 0;
+
+  if (len < 0 || (buf == NULL && len > 0) || m_pCallback == NULL)
+    return -1;
+
+  BufferReader reader(buf, len, m_pos);
+  const long long avail = m_pos + len;
+  long long pos = m_pos;
+  long status = 0;
+
+  for (;;) {
+    if (m_skip > 0) {
+      const long long n = (m_skip < avail - pos) ? m_skip : avail - pos;
+      pos += n;
+      m_skip -= n;
+
+      if (m_skip > 0)
+        break;  // need more data
+    }
+
+    if (m_state == kCluster && m_cluster_stop >= 0 && pos >= m_cluster_stop)
+      m_state = kSegment;
+
+    if (m_state != kTopLevel && m_segment_stop >= 0 && pos >= m_segment_stop)
+      m_state = kTopLevel;
+
+    long long id = 0, size = 0;
+    long header_len = 0;
+
+    status = ReadElementHeader(&reader, pos, avail, id, size, header_len);
+
+    if (status == E_BUFFER_NOT_FULL) {
+      status = 0;
+      break;
+    }
+
+    if (status < 0)
+      break;
+
+    const long long payload = pos + header_len;
+
+    if (m_state == kTopLevel) {
+      if (id == 0x08538067) {  // Segment ID
+        m_segment_stop = (size < 0) ? -1 : payload + size;
+        m_state = kSegment;
+        pos = payload;
+        continue;
+      }
+
+      if (size < 0) {
+        status = E_FILE_FORMAT_INVALID;
+        break;
+      }
+
+      pos = payload;  // EBML header, Void, ...
+      m_skip = size;
+      continue;
+    }
+
+    if (id == 0x0A45DFA3 || id == 0x08538067) {  // EBML Header or Segment ID
+      // A new segment starts; this happens when live streams are chained.
+      m_state = kTopLevel;
+      continue;
+    }
+
+    if (m_state == kCluster) {
+      if (IsSegmentChild(id)) {  // end of a cluster of unknown size
+        m_state = kSegment;
+        continue;
+      }
+
+      if (size < 0) {
+        status = E_FILE_FORMAT_INVALID;
+        break;
+      }
+
+      const bool complete = (payload + size) <= avail;
+
+      if (id == 0x67) {  // TimeCode ID
+        if (!complete)
+          break;
+
+        m_cluster_timecode = UnserializeUInt(&reader, payload, size);
+
+        if (m_cluster_timecode < 0) {
+          status = E_FILE_FORMAT_INVALID;
+          break;
+        }
+      } else if (id == 0x23) {  // SimpleBlock ID
+        if (!complete)
+          break;
+
+        status = ParseBlock(&reader, payload, size, true, false, 0, buf);
+      } else if (id == 0x20) {  // BlockGroup ID
+        if (!complete)
+          break;
+
+        status = ParseBlockGroup(&reader, payload, size, buf);
+      } else {
+        m_skip = size;
+      }
+
+      if (status)
+        break;
+
+      pos = (m_skip > 0) ? payload : payload + size;
+      continue;
+    }
+
+    assert(m_state == kSegment);
+
+    if (id == 0x0F43B675) {  // Cluster ID
+      m_cluster_stop = (size < 0) ? -1 : payload + size;
+      m_cluster_timecode = 0;
+      m_state = kCluster;
+      pos = payload;
+      continue;
+    }
+
+    if (size < 0) {
+      status = E_FILE_FORMAT_INVALID;
+      break;
+    }
+
+    if (id == 0x0549A966 || id == 0x0654AE6B) {  // Segment Info or Tracks ID
+      if ((payload + size) > avail)
+        break;
+
+      if (id == 0x0549A966)
+        status = ParseInfo(&reader, payload, size);
+      else
+        status = ParseTracks(&reader, payload, size, buf);
+
+      if (status)
+        break;
+
+      pos = payload + size;
+      continue;
+    }
+
+    pos = payload;  // SeekHead, Cues, Tags, ...
+    m_skip = size;
+  }
+
+  consumed = static_cast<long>(pos - m_pos);
+  m_pos = pos;
+
+  return status;
+}
+
+long StreamParser::ParseInfo(IMkvReader* pReader, long long pos,
+                             long long size) {
+  const long long stop = pos + size;
+
+  while (pos < stop) {
+    long long id, size;
+
+    long status = ParseElementHeader(pReader, pos, stop, id, size);
+
+    if (status < 0)
+      return status;
+
+    if (id == 0x0AD7B1) {  // Timecode Scale
+      m_timecode_scale = UnserializeUInt(pReader, pos, size);
+
+      if (m_timecode_scale <= 0)
+        return E_FILE_FORMAT_INVALID;
+    }
+
+    pos += size;
+  }
+
+  return (pos == stop) ? 0 : E_FILE_FORMAT_INVALID;
+}
+
+long StreamParser::ParseTracks(IMkvReader* pReader, long long pos,
+                               long long size, const unsigned char* buf) {
+  const long long stop = pos + size;
+
+  while (pos < stop) {
+    long long id, size;
+
+    long status = ParseElementHeader(pReader, pos, stop, id, size);
+
+    if (status < 0)
+      return status;
+
+    if (id == 0x2E) {  // TrackEntry ID
+      status = ParseTrackEntry(pReader, pos, size, buf);
+
+      if (status)
+        return status;
+    }
+
+    pos += size;
+  }
+
+  return (pos == stop) ? 0 : E_FILE_FORMAT_INVALID;
+}
+
+long StreamParser::ParseTrackEntry(IMkvReader* pReader, long long pos,
+                                   long long size, const unsigned char* buf) {
+  const long long stop = pos + size;
+
+  TrackInfo info;
+  info.number = -1;
+  info.type = -1;
+  info.codec_id = NULL;
+  info.codec_private = NULL;
+  info.codec_private_size = 0;
+  info.width = 0;
+  info.height = 0;
+  info.sampling_rate = 0.0;
+  info.channels = 0;
+
+  char* codec_id = NULL;
+  long status = 0;
+
+  while (pos < stop) {
+    long long id, size;
+
+    status = ParseElementHeader(pReader, pos, stop, id, size);
+
+    if (status < 0)
+      break;
+
+    if (id == 0x57) {  // Track Number
+      info.number = UnserializeUInt(pReader, pos, size);
+    } else if (id == 0x03) {  // Track Type
+      info.type = UnserializeUInt(pReader, pos, size);
+    } else if (id == 0x06) {  // Codec ID
+      delete[] codec_id;
+      codec_id = NULL;
+      status = UnserializeString(pReader, pos, size, codec_id);
+    } else if (id == 0x23A2) {  // Codec Private
+      info.codec_private = buf + (pos - m_pos);
+      info.codec_private_size = static_cast<size_t>(size);
+    } else if (id == 0x60 || id == 0x61) {  // VideoSettings or AudioSettings ID
+      const long long settings_stop = pos + size;
+      long long settings_pos = pos;
+
+      while (settings_pos < settings_stop) {
+        long long sid, ssize;
+
+        status = ParseElementHeader(pReader, settings_pos, settings_stop, sid,
+                                    ssize);
+
+        if (status < 0)
+          break;
+
+        if (id == 0x60 && sid == 0x30) {  // pixel width
+          info.width = UnserializeUInt(pReader, settings_pos, ssize);
+        } else if (id == 0x60 && sid == 0x3A) {  // pixel height
+          info.height = UnserializeUInt(pReader, settings_pos, ssize);
+        } else if (id == 0x61 && sid == 0x35) {  // Sample Rate
+          status = UnserializeFloat(pReader, settings_pos, ssize,
+                                    info.sampling_rate);
+        } else if (id == 0x61 && sid == 0x1F) {  // Channel Count
+          info.channels = UnserializeUInt(pReader, settings_pos, ssize);
+        }
+
+        if (status < 0)
+          break;
+
+        settings_pos += ssize;
+      }
+    }
+
+    if (status < 0)
+      break;
+
+    pos += size;
+  }
+
+  if (status == 0 && (pos != stop || info.number <= 0 || info.type < 0 ||
+                      info.width < 0 || info.height < 0 || info.channels < 0))
+    status = E_FILE_FORMAT_INVALID;
+
+  if (status == 0) {
+    info.codec_id = codec_id;
+    status = m_pCallback->OnTrack(info);
+  }
+
+  delete[] codec_id;
+  return status;
+}
+
+long StreamParser::ParseBlockGroup(IMkvReader* pReader, long long pos,
+                                   long long size, const unsigned char* buf) {
+  const long long stop = pos + size;
+
+  // See Cluster::CreateBlockGroup for the interpretation of ReferenceBlock.
+  long long prev = 1;  // nonce
+  long long next = 0;  // nonce
+  long long discard_padding = 0;
+
+  long long bpos = -1;
+  long long bsize = -1;
+
+  while (pos < stop) {
+    long long id, size;
+
+    long status = ParseElementHeader(pReader, pos, stop, id, size);
+
+    if (status < 0)
+      return status;
+
+    if (id == 0x21) {  // Block ID
+      if (bpos < 0) {
+        bpos = pos;
+        bsize = size;
+      }
+    } else if (id == 0x7B) {  // ReferenceBlock
+      if (size > 8 || size <= 0)
+        return E_FILE_FORMAT_INVALID;
+
+      long long time;
+
+      status = UnserializeInt(pReader, pos, size, time);
+
+      if (status)
+        return E_FILE_FORMAT_INVALID;
+
+      if (time <= 0)
+        prev = time;
+      else
+        next = time;
+    } else if (id == 0x35A2) {  // DiscardPadding
+      status = UnserializeInt(pReader, pos, size, discard_padding);
+
+      if (status)
+        return E_FILE_FORMAT_INVALID;
+    }
+
+    pos += size;
+  }
+
+  if (pos != stop || bpos < 0)
+    return E_FILE_FORMAT_INVALID;
+
+  return ParseBlock(pReader, bpos, bsize, false, (prev > 0) && (next <= 0),
+                    discard_padding, buf);
+}
+
+long StreamParser::ParseBlock(IMkvReader* pReader, long long pos,
+                              long long size, bool simple, bool key,
+                              long long discard_padding,
+                              const unsigned char* buf) {
+  Block block(pos, size, discard_padding);
+
+  long status = block.Parse(pReader);
+
+  if (status)
+    return status;
+
+  if (!simple)
+    block.SetKey(key);
+
+  long len;
+
+  if (ReadUInt(pReader, pos, len) < 0)  // track number
+    return E_FILE_FORMAT_INVALID;
+
+  long long timecode;
+
+  status = UnserializeInt(pReader, pos + len, 2, timecode);
+
+  if (status)
+    return E_FILE_FORMAT_INVALID;
+
+  Frame frame;
+  frame.track = block.GetTrackNumber();
+  frame.time = (m_cluster_timecode + timecode) * m_timecode_scale;
+  frame.key = block.IsKey();
+  frame.invisible = block.IsInvisible();
+  frame.discard_padding = block.GetDiscardPadding();
+
+  const int frame_count = block.GetFrameCount();
+
+  for (int i = 0; i < frame_count; ++i) {
+    const Block::Frame& f = block.GetFrame(i);
+
+    frame.data = buf + (f.pos - m_pos);
+    frame.len = f.len;
+
+    status = m_pCallback->OnFrame(frame);
+
+    if (status)
+      return status;
+  }
+
+  return 0;
+}
+
 }  // end namespace mkvparser
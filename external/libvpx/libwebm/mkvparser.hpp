@@ -82,6 +82,7 @@ class Block {
   ~Block();
 
   long Parse(const Cluster*);
+  long Parse(IMkvReader*);
 
   long long GetTrackNumber() const;
   long long GetTimeCode(const Cluster*) const;  // absolute, but not scaled
@@ -1014,6 +1015,87 @@ class Segment {
   const BlockEntry* GetBlock(const CuePoint&, const CuePoint::TrackPosition&);
 };
 
+// Push-mode parser for live streams. The caller appends data in chunks of
+// any size; Info, Tracks and block elements are parsed straight out of the
+// caller's buffer once they are complete and reported through a Callback.
+// Frame payloads are never copied: a reported Frame points into the buffer
+// passed to Parse() and is only valid for the duration of the callback.
+// Nothing is retained once a cluster has been parsed, and elements the
+// parser has no use for (SeekHead, Cues, Tags, ...) are skipped without
+// being buffered, so memory use does not grow with the stream duration.
+class StreamParser {
+  StreamParser(const StreamParser&);
+  StreamParser& operator=(const StreamParser&);
+
+ public:
+  struct TrackInfo {
+    long long number;
+    long long type;  // Track::Type
+    const char* codec_id;  // NULL if absent
+    const unsigned char* codec_private;  // points into the caller's buffer
+    size_t codec_private_size;
+    long long width;  // video only
+    long long height;  // video only
+    double sampling_rate;  // audio only
+    long long channels;  // audio only
+  };
+
+  struct Frame {
+    long long track;
+    long long time;  // absolute, and scaled (ns)
+    bool key;
+    bool invisible;
+    long long discard_padding;
+    const unsigned char* data;  // points into the caller's buffer
+    long len;
+  };
+
+  class Callback {
+   public:
+    // A non-zero return value stops parsing and is returned by Parse().
+    virtual long OnTrack(const TrackInfo&) = 0;
+    virtual long OnFrame(const Frame&) = 0;
+
+   protected:
+    virtual ~Callback();
+  };
+
+  explicit StreamParser(Callback*);
+
+  // Parses as much of |buf| as possible. On return |consumed| holds the
+  // number of leading bytes that have been fully processed; the caller must
+  // present the remaining (len - consumed) bytes again, followed by newly
+  // received data, on the next call. Returns 0 on success (including when
+  // more data is needed), or a negative value on error.
+  long Parse(const unsigned char* buf, long len, long& consumed);
+
+  long long GetPosition() const;  // absolute stream offset of buf[0]
+  long long GetTimecodeScale() const;
+
+ private:
+  enum State { kTopLevel, kSegment, kCluster };
+
+  Callback* const m_pCallback;
+  State m_state;
+  long long m_pos;
+  long long m_skip;  // payload bytes still to be skipped
+  long long m_segment_stop;  // -1 if unknown size
+  long long m_cluster_stop;  // -1 if unknown size
+  long long m_cluster_timecode;
+  long long m_timecode_scale;
+
+  long ParseInfo(IMkvReader*, long long pos, long long size);
+  long ParseTracks(IMkvReader*, long long pos, long long size,
+                   const unsigned char* buf);
+  long ParseTrackEntry(IMkvReader*, long long pos, long long size,
+                       const unsigned char* buf);
+  long ParseBlockGroup(IMkvReader*, long long pos, long long size,
+                       const unsigned char* buf);
+  long ParseBlock(IMkvReader*, long long pos, long long size, bool simple,
+                  bool key, long long discard_padding,
+                  const unsigned char* buf);
+};
+
 }  // end namespace mkvparser
 
 inline long mkvparser::Segment::LoadCluster() {
@@ -0,0 +1,307 @@
+// Copyright (c) 2012 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+
+// Compares the CPU time and peak memory use of Segment::Load and of
+// StreamParser on the same file.  Run each mode in a separate process so
+// that the peak RSS figures are meaningful:
+//
+//   stream_parser_benchmark generate <hours> <file.webm>
+//   stream_parser_benchmark load <file.webm>
+//   stream_parser_benchmark stream <file.webm> <chunk size>
+//
+// "generate" writes a synthetic 30 fps live-style stream (unknown-size
+// segment, a 5 second cluster per 150 frames) of the given duration.
+
+#include <sys/resource.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#include "mkvparser.hpp"
+
+namespace {
+
+class FileReader : public mkvparser::IMkvReader {
+ public:
+  explicit FileReader(FILE* file) : file_(file) {
+    fseek(file_, 0, SEEK_END);
+    length_ = ftell(file_);
+  }
+  virtual ~FileReader() {}
+
+  virtual int Read(long long pos, long len, unsigned char* buf) {
+    if (pos < 0 || len < 0 || pos + len > length_)
+      return -1;
+    if (fseek(file_, static_cast<long>(pos), SEEK_SET))
+      return -1;
+    return (fread(buf, 1, len, file_) == static_cast<size_t>(len)) ? 0 : -1;
+  }
+
+  virtual int Length(long long* total, long long* available) {
+    if (total)
+      *total = length_;
+    if (available)
+      *available = length_;
+    return 0;
+  }
+
+ private:
+  FILE* const file_;
+  long long length_;
+};
+
+struct Totals {
+  Totals() : frames(0), bytes(0), checksum(0), keys(0), last_time(0) {}
+
+  void Add(const unsigned char* data, long len, bool key, long long time) {
+    ++frames;
+    bytes += len;
+    checksum += (len > 0) ? data[len - 1] : 0;
+    keys += key;
+    last_time = time;
+  }
+
+  long long frames;
+  long long bytes;
+  long long checksum;
+  long long keys;
+  long long last_time;
+};
+
+class Sink : public mkvparser::StreamParser::Callback {
+ public:
+  explicit Sink(Totals* totals) : totals_(totals) {}
+  virtual ~Sink() {}
+
+  virtual long OnTrack(const mkvparser::StreamParser::TrackInfo&) {
+    return 0;
+  }
+
+  virtual long OnFrame(const mkvparser::StreamParser::Frame& frame) {
+    totals_->Add(frame.data, frame.len, frame.key, frame.time);
+    return 0;
+  }
+
+ private:
+  Totals* const totals_;
+};
+
+int Load(FILE* file, Totals* totals) {
+  FileReader reader(file);
+  long long pos = 0;
+  mkvparser::EBMLHeader header;
+  if (header.Parse(&reader, pos) < 0)
+    return -1;
+
+  mkvparser::Segment* segment;
+  if (mkvparser::Segment::CreateInstance(&reader, pos, segment))
+    return -1;
+  if (segment->Load() < 0) {
+    delete segment;
+    return -1;
+  }
+
+  std::vector<unsigned char> buf;
+  for (const mkvparser::Cluster* cluster = segment->GetFirst();
+       cluster && !cluster->EOS(); cluster = segment->GetNext(cluster)) {
+    const mkvparser::BlockEntry* entry;
+    if (cluster->GetFirst(entry) < 0)
+      break;
+    while (entry && !entry->EOS()) {
+      const mkvparser::Block* const block = entry->GetBlock();
+      for (int i = 0; i < block->GetFrameCount(); ++i) {
+        const mkvparser::Block::Frame& frame = block->GetFrame(i);
+        buf.resize(frame.len);
+        if (frame.len > 0 && frame.Read(&reader, &buf[0]) < 0) {
+          delete segment;
+          return -1;
+        }
+        totals->Add(buf.empty() ? NULL : &buf[0], frame.len, block->IsKey(),
+                    block->GetTime(cluster));
+      }
+      if (cluster->GetNext(entry, entry) < 0)
+        break;
+    }
+  }
+
+  delete segment;
+  return 0;
+}
+
+int Stream(FILE* file, long chunk, Totals* totals) {
+  Sink sink(totals);
+  mkvparser::StreamParser parser(&sink);
+  std::vector<unsigned char> buf(chunk);
+  long have = 0;
+
+  for (;;) {
+    if (have + chunk > static_cast<long>(buf.size()))
+      buf.resize(have + chunk);
+    const size_t n = fread(&buf[have], 1, chunk, file);
+    have += static_cast<long>(n);
+
+    long consumed;
+    if (parser.Parse(&buf[0], have, consumed))
+      return -1;
+    memmove(&buf[0], &buf[consumed], have - consumed);
+    have -= consumed;
+
+    if (n == 0)
+      break;
+  }
+  return have ? -1 : 0;
+}
+
+void WriteSize(FILE* file, unsigned long long size) {
+  int len = 1;
+  while (len < 8 && size >= (1ULL << (7 * len)) - 1)
+    ++len;
+  const unsigned long long value = (1ULL << (7 * len)) | size;
+  for (int i = len - 1; i >= 0; --i)
+    fputc(static_cast<int>((value >> (8 * i)) & 0xFF), file);
+}
+
+void WriteID(FILE* file, unsigned long id) {
+  int shift = 24;
+  while (shift > 0 && (id >> shift) == 0)
+    shift -= 8;
+  for (; shift >= 0; shift -= 8)
+    fputc(static_cast<int>((id >> shift) & 0xFF), file);
+}
+
+void WriteUInt(FILE* file, unsigned long id, unsigned long long value) {
+  int len = 1;
+  while (len < 8 && (value >> (8 * len)) != 0)
+    ++len;
+  WriteID(file, id);
+  WriteSize(file, len);
+  for (int i = len - 1; i >= 0; --i)
+    fputc(static_cast<int>((value >> (8 * i)) & 0xFF), file);
+}
+
+int Generate(double hours, FILE* file) {
+  static const unsigned char kEBMLHeader[] = {
+    0x1A, 0x45, 0xDF, 0xA3, 0x87, 0x42, 0x82, 0x84, 'w', 'e', 'b', 'm'
+  };
+  static const unsigned char kTracks[] = {
+    0x16, 0x54, 0xAE, 0x6B, 0x99, 0xAE, 0x97, 0xD7, 0x81, 0x01,
+    0x83, 0x81, 0x01, 0x86, 0x85, 'V', '_', 'V', 'P', '9',
+    0xE0, 0x88, 0xB0, 0x82, 0x02, 0x80, 0xBA, 0x82, 0x01, 0x68
+  };
+  const int kFps = 30;
+  const int kFramesPerCluster = 5 * kFps;
+  const long long frames = static_cast<long long>(hours * 3600 * kFps);
+  unsigned char payload[500];
+
+  for (size_t i = 0; i < sizeof(payload); ++i)
+    payload[i] = static_cast<unsigned char>(i);
+
+  fwrite(kEBMLHeader, 1, sizeof(kEBMLHeader), file);
+  WriteID(file, 0x18538067);  // Segment, of unknown size
+  fputc(0x01, file);
+  for (int i = 0; i < 7; ++i)
+    fputc(0xFF, file);
+  WriteID(file, 0x1549A966);  // Info
+  WriteSize(file, 7);
+  WriteUInt(file, 0x2AD7B1, 1000000);
+  fwrite(kTracks, 1, sizeof(kTracks), file);
+
+  for (long long c = 0; c < frames; c += kFramesPerCluster) {
+    const long long n = (frames - c < kFramesPerCluster)
+                            ? frames - c : kFramesPerCluster;
+    const long long timecode = c * 1000 / kFps;
+    unsigned long long size = 0;
+
+    for (long long i = 0; i < n; ++i)
+      size += 1 + 2 + 4 + (i ? 300 : 500);
+    size += 2 + 4;  // the cluster timecode
+
+    WriteID(file, 0x1F43B675);  // Cluster
+    WriteSize(file, size);
+    // Pad the timecode to 4 bytes so the cluster size is exact.
+    WriteID(file, 0xE7);
+    WriteSize(file, 4);
+    for (int i = 3; i >= 0; --i)
+      fputc(static_cast<int>((timecode >> (8 * i)) & 0xFF), file);
+
+    for (long long i = 0; i < n; ++i) {
+      const int len = i ? 300 : 500;
+      const int rel = static_cast<int>(i * 1000 / kFps);
+      WriteID(file, 0xA3);  // SimpleBlock
+      WriteSize(file, 4 + len);
+      fputc(0x81, file);
+      fputc((rel >> 8) & 0xFF, file);
+      fputc(rel & 0xFF, file);
+      fputc(i ? 0x00 : 0x80, file);
+      fwrite(payload, 1, len, file);
+    }
+  }
+  return ferror(file) ? -1 : 0;
+}
+
+long MaxRss() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+void Usage(const char* argv0) {
+  fprintf(stderr,
+          "Usage: %s generate <hours> <file.webm>\n"
+          "       %s load <file.webm>\n"
+          "       %s stream <file.webm> <chunk size>\n",
+          argv0, argv0, argv0);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc == 4 && !strcmp(argv[1], "generate")) {
+    FILE* const file = fopen(argv[3], "wb");
+    if (!file) {
+      perror(argv[3]);
+      return EXIT_FAILURE;
+    }
+    const int status = Generate(atof(argv[2]), file);
+    return (fclose(file) || status) ? EXIT_FAILURE : EXIT_SUCCESS;
+  }
+
+  const bool load = (argc == 3 && !strcmp(argv[1], "load"));
+  const bool stream = (argc == 4 && !strcmp(argv[1], "stream"));
+  if (!load && !stream) {
+    Usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  FILE* const file = fopen(argv[2], "rb");
+  if (!file) {
+    perror(argv[2]);
+    return EXIT_FAILURE;
+  }
+
+  Totals totals;
+  const clock_t start = clock();
+  const int status = load ? Load(file, &totals)
+                          : Stream(file, atol(argv[3]), &totals);
+  const double cpu = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+  fclose(file);
+
+  if (status) {
+    fprintf(stderr, "%s: parse error\n", argv[2]);
+    return EXIT_FAILURE;
+  }
+  printf("%s: %lld frames, %lld bytes, %lld key frames, checksum %lld, "
+         "last time %lld ns\n",
+         argv[1], totals.frames, totals.bytes, totals.keys, totals.checksum,
+         totals.last_time);
+  printf("%s: %.2f s CPU, %ld KB max RSS\n", argv[1], cpu, MaxRss());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,589 @@
+// Copyright (c) 2012 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+
+// Checks that StreamParser reports the same tracks and frames as
+// Segment::Load, whatever the size of the chunks it is fed.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "mkvparser.hpp"
+
+namespace {
+
+typedef std::vector<unsigned char> Bytes;
+
+// Element IDs, with their length markers.
+const unsigned long kEBML = 0x1A45DFA3;
+const unsigned long kDocType = 0x4282;
+const unsigned long kSegment = 0x18538067;
+const unsigned long kSeekHead = 0x114D9B74;
+const unsigned long kSeek = 0x4DBB;
+const unsigned long kInfo = 0x1549A966;
+const unsigned long kTimecodeScale = 0x2AD7B1;
+const unsigned long kTracks = 0x1654AE6B;
+const unsigned long kTrackEntry = 0xAE;
+const unsigned long kTrackNumber = 0xD7;
+const unsigned long kTrackUID = 0x73C5;
+const unsigned long kTrackType = 0x83;
+const unsigned long kCodecID = 0x86;
+const unsigned long kCodecPrivate = 0x63A2;
+const unsigned long kVideo = 0xE0;
+const unsigned long kPixelWidth = 0xB0;
+const unsigned long kPixelHeight = 0xBA;
+const unsigned long kAudio = 0xE1;
+const unsigned long kSamplingFrequency = 0xB5;
+const unsigned long kChannels = 0x9F;
+const unsigned long kCluster = 0x1F43B675;
+const unsigned long kTimecode = 0xE7;
+const unsigned long kSimpleBlock = 0xA3;
+const unsigned long kBlockGroup = 0xA0;
+const unsigned long kBlock = 0xA1;
+const unsigned long kReferenceBlock = 0xFB;
+const unsigned long kDiscardPadding = 0x75A2;
+const unsigned long kCues = 0x1C53BB6B;
+const unsigned long kVoid = 0xEC;
+
+const long long kTimecodeScaleValue = 500000;
+
+void Append(Bytes* out, const Bytes& b) {
+  out->insert(out->end(), b.begin(), b.end());
+}
+
+void AppendID(Bytes* out, unsigned long id) {
+  int shift = 24;
+  while (shift > 0 && (id >> shift) == 0)
+    shift -= 8;
+  for (; shift >= 0; shift -= 8)
+    out->push_back(static_cast<unsigned char>(id >> shift));
+}
+
+void AppendSize(Bytes* out, unsigned long long size) {
+  int len = 1;
+  while (len < 8 && size >= (1ULL << (7 * len)) - 1)
+    ++len;
+  const unsigned long long value = (1ULL << (7 * len)) | size;
+  for (int i = len - 1; i >= 0; --i)
+    out->push_back(static_cast<unsigned char>(value >> (8 * i)));
+}
+
+void AppendUnknownSize(Bytes* out) {
+  out->push_back(0x01);
+  for (int i = 0; i < 7; ++i)
+    out->push_back(0xFF);
+}
+
+Bytes Element(unsigned long id, const Bytes& payload) {
+  Bytes out;
+  AppendID(&out, id);
+  AppendSize(&out, payload.size());
+  Append(&out, payload);
+  return out;
+}
+
+Bytes UIntElement(unsigned long id, unsigned long long value) {
+  Bytes payload;
+  int len = 1;
+  while (len < 8 && (value >> (8 * len)) != 0)
+    ++len;
+  for (int i = len - 1; i >= 0; --i)
+    payload.push_back(static_cast<unsigned char>(value >> (8 * i)));
+  return Element(id, payload);
+}
+
+Bytes IntElement(unsigned long id, long long value) {
+  Bytes payload;
+  for (int i = 1; i >= 0; --i)
+    payload.push_back(static_cast<unsigned char>(value >> (8 * i)));
+  return Element(id, payload);
+}
+
+Bytes StringElement(unsigned long id, const char* s) {
+  return Element(id, Bytes(s, s + strlen(s)));
+}
+
+Bytes FloatElement(unsigned long id, double value) {
+  unsigned long long bits;
+  memcpy(&bits, &value, sizeof(bits));
+  Bytes payload;
+  for (int i = 7; i >= 0; --i)
+    payload.push_back(static_cast<unsigned char>(bits >> (8 * i)));
+  return Element(id, payload);
+}
+
+Bytes FrameData(int seed, int len) {
+  Bytes data(len);
+  for (int i = 0; i < len; ++i)
+    data[i] = static_cast<unsigned char>(seed * 31 + i * 7);
+  return data;
+}
+
+enum Lacing {
+  kNoLacing = 0,
+  kXiphLacing = 2,
+  kFixedLacing = 4,
+  kEbmlLacing = 6
+};
+
+// Track number, timecode, flags and (laced) frame data of a block.
+Bytes BlockPayload(int track, int timecode, unsigned char flags, Lacing lacing,
+                   const std::vector<Bytes>& frames) {
+  Bytes out;
+  out.push_back(static_cast<unsigned char>(0x80 | track));
+  out.push_back(static_cast<unsigned char>(timecode >> 8));
+  out.push_back(static_cast<unsigned char>(timecode));
+  out.push_back(static_cast<unsigned char>(flags | lacing));
+
+  if (lacing != kNoLacing) {
+    out.push_back(static_cast<unsigned char>(frames.size() - 1));
+
+    if (lacing == kXiphLacing) {
+      for (size_t i = 0; i + 1 < frames.size(); ++i) {
+        size_t n = frames[i].size();
+        for (; n >= 255; n -= 255)
+          out.push_back(255);
+        out.push_back(static_cast<unsigned char>(n));
+      }
+    } else if (lacing == kEbmlLacing) {
+      AppendSize(&out, frames[0].size());
+      for (size_t i = 1; i + 1 < frames.size(); ++i) {
+        // Signed differences, in one-byte form (range -63..63).
+        const long delta = static_cast<long>(frames[i].size()) -
+                           static_cast<long>(frames[i - 1].size());
+        out.push_back(static_cast<unsigned char>(0x80 | (delta + 63)));
+      }
+    }
+  }
+
+  for (size_t i = 0; i < frames.size(); ++i)
+    Append(&out, frames[i]);
+  return out;
+}
+
+Bytes SimpleBlock(int track, int timecode, bool key, Lacing lacing,
+                  const std::vector<Bytes>& frames) {
+  return Element(kSimpleBlock, BlockPayload(track, timecode, key ? 0x80 : 0,
+                                            lacing, frames));
+}
+
+Bytes BlockGroup(int track, int timecode, int reference,
+                 long long discard_padding, const Bytes& frame) {
+  Bytes payload =
+      Element(kBlock, BlockPayload(track, timecode, 0, kNoLacing,
+                                   std::vector<Bytes>(1, frame)));
+  if (reference)
+    Append(&payload, IntElement(kReferenceBlock, reference));
+  if (discard_padding)
+    Append(&payload, IntElement(kDiscardPadding, discard_padding));
+  return Element(kBlockGroup, payload);
+}
+
+Bytes EBMLHeader() {
+  return Element(kEBML, StringElement(kDocType, "webm"));
+}
+
+Bytes Tracks() {
+  Bytes video;
+  Append(&video, UIntElement(kTrackNumber, 1));
+  Append(&video, UIntElement(kTrackUID, 1));
+  Append(&video, UIntElement(kTrackType, 1));
+  Append(&video, StringElement(kCodecID, "V_VP8"));
+  Bytes video_settings = UIntElement(kPixelWidth, 320);
+  Append(&video_settings, UIntElement(kPixelHeight, 240));
+  Append(&video, Element(kVideo, video_settings));
+
+  Bytes audio;
+  Append(&audio, UIntElement(kTrackNumber, 2));
+  Append(&audio, UIntElement(kTrackUID, 2));
+  Append(&audio, UIntElement(kTrackType, 2));
+  Append(&audio, StringElement(kCodecID, "A_OPUS"));
+  Append(&audio, Element(kCodecPrivate, FrameData(99, 19)));
+  Bytes audio_settings = FloatElement(kSamplingFrequency, 48000.0);
+  Append(&audio_settings, UIntElement(kChannels, 2));
+  Append(&audio, Element(kAudio, audio_settings));
+
+  Bytes tracks = Element(kTrackEntry, video);
+  Append(&tracks, Element(kTrackEntry, audio));
+  return Element(kTracks, tracks);
+}
+
+// The contents of a cluster: every kind of block the parser handles.
+Bytes ClusterPayload(int n) {
+  Bytes out = UIntElement(kTimecode, 1000 * n);
+
+  std::vector<Bytes> frames(1, FrameData(n, 700 + n));
+  Append(&out, SimpleBlock(1, 0, true, kNoLacing, frames));
+
+  frames.clear();
+  frames.push_back(FrameData(n + 1, 300));
+  frames.push_back(FrameData(n + 2, 40));
+  frames.push_back(FrameData(n + 3, 600));
+  Append(&out, SimpleBlock(2, 10, true, kXiphLacing, frames));
+
+  Append(&out, BlockGroup(1, 33, -33, 0, FrameData(n + 4, 200)));
+
+  frames.assign(4, FrameData(n + 5, 80));
+  Append(&out, SimpleBlock(2, 30, true, kFixedLacing, frames));
+
+  frames.clear();
+  frames.push_back(FrameData(n + 6, 120));
+  frames.push_back(FrameData(n + 7, 150));
+  frames.push_back(FrameData(n + 8, 100));
+  Append(&out, SimpleBlock(2, 50, true, kEbmlLacing, frames));
+
+  Append(&out, Element(kVoid, Bytes(5)));
+  Append(&out, BlockGroup(2, 70, 0, 6500000, FrameData(n + 9, 90)));
+  Append(&out, BlockGroup(1, 66, -33, 0, FrameData(n + 10, 250)));
+  return out;
+}
+
+// A complete WebM file with known sizes, or with a Segment and Clusters
+// of unknown size, as produced by live encoders.
+Bytes MakeWebM(int clusters, bool unknown_sizes) {
+  Bytes segment;
+  Append(&segment, Element(kSeekHead, Element(kSeek, FrameData(1, 12))));
+  Append(&segment, Element(kInfo, UIntElement(kTimecodeScale,
+                                              kTimecodeScaleValue)));
+  Append(&segment, Tracks());
+  for (int i = 0; i < clusters; ++i) {
+    if (unknown_sizes) {
+      AppendID(&segment, kCluster);
+      AppendUnknownSize(&segment);
+      Append(&segment, ClusterPayload(i));
+    } else {
+      Append(&segment, Element(kCluster, ClusterPayload(i)));
+    }
+  }
+  Append(&segment, Element(kCues, FrameData(2, 300)));
+
+  Bytes out = EBMLHeader();
+  if (unknown_sizes) {
+    AppendID(&out, kSegment);
+    AppendUnknownSize(&out);
+    Append(&out, segment);
+  } else {
+    Append(&out, Element(kSegment, segment));
+  }
+  return out;
+}
+
+struct TrackRecord {
+  long long number;
+  long long type;
+  std::string codec_id;
+  Bytes codec_private;
+  long long width;
+  long long height;
+  double sampling_rate;
+  long long channels;
+
+  bool operator==(const TrackRecord& o) const {
+    return number == o.number && type == o.type && codec_id == o.codec_id &&
+           codec_private == o.codec_private && width == o.width &&
+           height == o.height && sampling_rate == o.sampling_rate &&
+           channels == o.channels;
+  }
+};
+
+struct FrameRecord {
+  long long track;
+  long long time;
+  bool key;
+  bool invisible;
+  long long discard_padding;
+  Bytes data;
+
+  bool operator==(const FrameRecord& o) const {
+    return track == o.track && time == o.time && key == o.key &&
+           invisible == o.invisible && discard_padding == o.discard_padding &&
+           data == o.data;
+  }
+};
+
+struct Result {
+  std::vector<TrackRecord> tracks;
+  std::vector<FrameRecord> frames;
+};
+
+class BufferReader : public mkvparser::IMkvReader {
+ public:
+  explicit BufferReader(const Bytes& data) : data_(data) {}
+  virtual ~BufferReader() {}
+
+  virtual int Read(long long pos, long len, unsigned char* buf) {
+    if (pos < 0 || len < 0 ||
+        pos + len > static_cast<long long>(data_.size()))
+      return -1;
+    if (len > 0)
+      memcpy(buf, &data_[static_cast<size_t>(pos)], len);
+    return 0;
+  }
+
+  virtual int Length(long long* total, long long* available) {
+    if (total)
+      *total = data_.size();
+    if (available)
+      *available = data_.size();
+    return 0;
+  }
+
+ private:
+  const Bytes& data_;
+};
+
+// The reference: load the whole segment and walk its clusters.
+bool LoadSegment(const Bytes& data, Result* result) {
+  BufferReader reader(data);
+  long long pos = 0;
+  mkvparser::EBMLHeader header;
+  if (header.Parse(&reader, pos) < 0)
+    return false;
+
+  mkvparser::Segment* segment;
+  if (mkvparser::Segment::CreateInstance(&reader, pos, segment))
+    return false;
+  if (segment->Load() < 0) {
+    delete segment;
+    return false;
+  }
+
+  const mkvparser::Tracks* const tracks = segment->GetTracks();
+  for (unsigned long i = 0; i < tracks->GetTracksCount(); ++i) {
+    const mkvparser::Track* const track = tracks->GetTrackByIndex(i);
+    TrackRecord t;
+    t.number = track->GetNumber();
+    t.type = track->GetType();
+    t.codec_id = track->GetCodecId() ? track->GetCodecId() : "";
+    size_t size;
+    long long priv_pos;
+    const unsigned char* priv = track->GetCodecPrivate(size, priv_pos);
+    if (priv)
+      t.codec_private.assign(priv, priv + size);
+    t.width = t.height = t.channels = 0;
+    t.sampling_rate = 0.0;
+    if (t.type == mkvparser::Track::kVideo) {
+      const mkvparser::VideoTrack* const v =
+          static_cast<const mkvparser::VideoTrack*>(track);
+      t.width = v->GetWidth();
+      t.height = v->GetHeight();
+    } else if (t.type == mkvparser::Track::kAudio) {
+      const mkvparser::AudioTrack* const a =
+          static_cast<const mkvparser::AudioTrack*>(track);
+      t.sampling_rate = a->GetSamplingRate();
+      t.channels = a->GetChannels();
+    }
+    result->tracks.push_back(t);
+  }
+
+  for (const mkvparser::Cluster* cluster = segment->GetFirst();
+       cluster && !cluster->EOS(); cluster = segment->GetNext(cluster)) {
+    const mkvparser::BlockEntry* entry;
+    if (cluster->GetFirst(entry) < 0)
+      break;
+    while (entry && !entry->EOS()) {
+      const mkvparser::Block* const block = entry->GetBlock();
+      for (int i = 0; i < block->GetFrameCount(); ++i) {
+        const mkvparser::Block::Frame& frame = block->GetFrame(i);
+        FrameRecord f;
+        f.track = block->GetTrackNumber();
+        f.time = block->GetTime(cluster);
+        f.key = block->IsKey();
+        f.invisible = block->IsInvisible();
+        f.discard_padding = block->GetDiscardPadding();
+        f.data.resize(frame.len);
+        frame.Read(&reader, &f.data[0]);
+        result->frames.push_back(f);
+      }
+      if (cluster->GetNext(entry, entry) < 0)
+        break;
+    }
+  }
+
+  delete segment;
+  return true;
+}
+
+class Collector : public mkvparser::StreamParser::Callback {
+ public:
+  explicit Collector(Result* result) : result_(result) {}
+  virtual ~Collector() {}
+
+  virtual long OnTrack(const mkvparser::StreamParser::TrackInfo& info) {
+    TrackRecord t;
+    t.number = info.number;
+    t.type = info.type;
+    t.codec_id = info.codec_id ? info.codec_id : "";
+    if (info.codec_private)
+      t.codec_private.assign(info.codec_private,
+                             info.codec_private + info.codec_private_size);
+    t.width = info.width;
+    t.height = info.height;
+    t.sampling_rate = info.sampling_rate;
+    t.channels = info.channels;
+    result_->tracks.push_back(t);
+    return 0;
+  }
+
+  virtual long OnFrame(const mkvparser::StreamParser::Frame& frame) {
+    FrameRecord f;
+    f.track = frame.track;
+    f.time = frame.time;
+    f.key = frame.key;
+    f.invisible = frame.invisible;
+    f.discard_padding = frame.discard_padding;
+    f.data.assign(frame.data, frame.data + frame.len);
+    result_->frames.push_back(f);
+    return 0;
+  }
+
+ private:
+  Result* const result_;
+};
+
+// Feeds |data| to a StreamParser in chunks of |chunk| bytes, or of random
+// sizes between 1 and -|chunk| bytes if |chunk| is negative.
+bool StreamParse(const Bytes& data, long chunk, Result* result) {
+  Collector collector(result);
+  mkvparser::StreamParser parser(&collector);
+  Bytes buf;
+  size_t pos = 0;
+  unsigned int seed = 1;
+
+  while (pos < data.size()) {
+    size_t n = (chunk > 0) ? chunk : 1 + rand_r(&seed) % -chunk;
+    if (n > data.size() - pos)
+      n = data.size() - pos;
+    buf.insert(buf.end(), data.begin() + pos, data.begin() + pos + n);
+    pos += n;
+
+    long consumed;
+    if (parser.Parse(&buf[0], static_cast<long>(buf.size()), consumed))
+      return false;
+    if (consumed < 0 || consumed > static_cast<long>(buf.size()))
+      return false;
+    buf.erase(buf.begin(), buf.begin() + consumed);
+  }
+  return buf.empty() &&
+         parser.GetPosition() == static_cast<long long>(data.size());
+}
+
+void ExpectSame(const Result& expected, const Result& actual) {
+  ASSERT_EQ(expected.tracks.size(), actual.tracks.size());
+  for (size_t i = 0; i < expected.tracks.size(); ++i)
+    EXPECT_TRUE(expected.tracks[i] == actual.tracks[i]) << "track " << i;
+  ASSERT_EQ(expected.frames.size(), actual.frames.size());
+  for (size_t i = 0; i < expected.frames.size(); ++i)
+    EXPECT_TRUE(expected.frames[i] == actual.frames[i]) << "frame " << i;
+}
+
+const long kChunkSizes[] = { 1, 2, 3, 7, 64, 1000, 65536, -17, -4096 };
+
+TEST(StreamParserTest, MatchesSegmentLoad) {
+  const Bytes data = MakeWebM(6, false);
+  Result expected;
+  ASSERT_TRUE(LoadSegment(data, &expected));
+  ASSERT_EQ(2U, expected.tracks.size());
+  ASSERT_EQ(6U * 14, expected.frames.size());
+
+  for (size_t i = 0; i < sizeof(kChunkSizes) / sizeof(kChunkSizes[0]); ++i) {
+    SCOPED_TRACE(kChunkSizes[i]);
+    Result actual;
+    ASSERT_TRUE(StreamParse(data, kChunkSizes[i], &actual));
+    ExpectSame(expected, actual);
+  }
+}
+
+TEST(StreamParserTest, UnknownSizes) {
+  Result expected;
+  ASSERT_TRUE(LoadSegment(MakeWebM(6, false), &expected));
+
+  const Bytes data = MakeWebM(6, true);
+  for (size_t i = 0; i < sizeof(kChunkSizes) / sizeof(kChunkSizes[0]); ++i) {
+    SCOPED_TRACE(kChunkSizes[i]);
+    Result actual;
+    ASSERT_TRUE(StreamParse(data, kChunkSizes[i], &actual));
+    ExpectSame(expected, actual);
+  }
+}
+
+TEST(StreamParserTest, ChainedSegments) {
+  Result first, second, expected;
+  ASSERT_TRUE(LoadSegment(MakeWebM(3, false), &first));
+  ASSERT_TRUE(LoadSegment(MakeWebM(4, false), &second));
+  expected = first;
+  expected.tracks.insert(expected.tracks.end(), second.tracks.begin(),
+                         second.tracks.end());
+  expected.frames.insert(expected.frames.end(), second.frames.begin(),
+                         second.frames.end());
+
+  Bytes data = MakeWebM(3, true);
+  Append(&data, MakeWebM(4, false));
+  for (size_t i = 0; i < sizeof(kChunkSizes) / sizeof(kChunkSizes[0]); ++i) {
+    SCOPED_TRACE(kChunkSizes[i]);
+    Result actual;
+    ASSERT_TRUE(StreamParse(data, kChunkSizes[i], &actual));
+    ExpectSame(expected, actual);
+  }
+}
+
+// A file written by vpxenc, as found in LIBWEBM_TEST_DATA_PATH.
+TEST(StreamParserTest, VpxencFile) {
+  const char* dir = getenv("LIBWEBM_TEST_DATA_PATH");
+  const std::string path =
+      std::string(dir ? dir : "testing/testdata") + "/vp9_stream.webm";
+  FILE* const file = fopen(path.c_str(), "rb");
+  ASSERT_TRUE(file != NULL) << "Unable to open " << path;
+  Bytes data;
+  unsigned char buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), file)) > 0)
+    data.insert(data.end(), buf, buf + n);
+  fclose(file);
+
+  Result expected;
+  ASSERT_TRUE(LoadSegment(data, &expected));
+  ASSERT_EQ(1U, expected.tracks.size());
+  EXPECT_EQ("V_VP9", expected.tracks[0].codec_id);
+  ASSERT_EQ(12U, expected.frames.size());
+
+  for (size_t i = 0; i < sizeof(kChunkSizes) / sizeof(kChunkSizes[0]); ++i) {
+    SCOPED_TRACE(kChunkSizes[i]);
+    Result actual;
+    ASSERT_TRUE(StreamParse(data, kChunkSizes[i], &actual));
+    ExpectSame(expected, actual);
+  }
+}
+
+TEST(StreamParserTest, TruncatedElement) {
+  const Bytes data = MakeWebM(2, false);
+  Result result;
+  Collector sink(&result);
+  mkvparser::StreamParser parser(&sink);
+
+  // Up to the middle of the first cluster: everything before the block
+  // being cut off is reported, and the rest is left for the next call.
+  const long len = static_cast<long>(data.size() / 2);
+  long consumed;
+  ASSERT_EQ(0, parser.Parse(&data[0], len, consumed));
+  EXPECT_LT(consumed, len);
+  EXPECT_EQ(2U, result.tracks.size());
+
+  const size_t frames = result.frames.size();
+  long more;
+  ASSERT_EQ(0, parser.Parse(&data[consumed],
+                            static_cast<long>(data.size()) - consumed, more));
+  EXPECT_EQ(static_cast<long>(data.size()) - consumed, more);
+  EXPECT_EQ(28U, result.frames.size());
+  EXPECT_LT(frames, result.frames.size());
+}
+
+}  // namespace
@@ -188,6 +188,7 @@ vg_local_src_files := \
 	coregrind/m_threadstate.c \
 	coregrind/m_tooliface.c \
 	coregrind/m_trampoline.S \
+	coregrind/m_transcache.c \
 	coregrind/m_translate.c \
 	coregrind/m_transtab.c \
 	coregrind/m_vki.c \
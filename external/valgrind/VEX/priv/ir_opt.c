@@ -525,6 +525,12 @@ static void redundant_get_removal_BB ( IRSB* bb )
 }
 
 
+void do_redundant_GET_removal_BB ( IRSB* bb )
+{
+   redundant_get_removal_BB( bb );
+}
+
+
 
 
 static void handle_gets_Stmt ( 
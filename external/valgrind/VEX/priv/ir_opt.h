@@ -53,6 +53,9 @@ IRSB* cprop_BB ( IRSB* );
 extern
 void do_deadcode_BB ( IRSB* bb );
 
+extern
+void do_redundant_GET_removal_BB ( IRSB* bb );
+
 extern
 Addr ado_treebuild_BB (
         IRSB* bb,
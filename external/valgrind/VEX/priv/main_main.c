@@ -176,6 +176,25 @@ void LibVEX_default_VexControl (  VexControl* vcon )
    vcon->guest_max_insns                = 60;
    vcon->guest_chase_thresh             = 10;
    vcon->guest_chase_cond               = False;
+   vcon->iropt_post_instr_getrm         = False;
+}
+
+
+static void check_VexControl ( const VexControl* vcon )
+{
+   vassert(vcon->iropt_verbosity >= 0);
+   vassert(vcon->iropt_level >= 0);
+   vassert(vcon->iropt_level <= 2);
+   vassert(vcon->iropt_unroll_thresh >= 0);
+   vassert(vcon->iropt_unroll_thresh <= 400);
+   vassert(vcon->guest_max_insns >= 1);
+   vassert(vcon->guest_max_insns <= 100);
+   vassert(vcon->guest_chase_thresh >= 0);
+   vassert(vcon->guest_chase_thresh < vcon->guest_max_insns);
+   vassert(vcon->guest_chase_cond == True 
+           || vcon->guest_chase_cond == False);
+   vassert(vcon->iropt_post_instr_getrm == True 
+           || vcon->iropt_post_instr_getrm == False);
 }
 
 
@@ -201,17 +220,7 @@ void LibVEX_Init (
    vassert(log_bytes);
    vassert(debuglevel >= 0);
 
-   vassert(vcon->iropt_verbosity >= 0);
-   vassert(vcon->iropt_level >= 0);
-   vassert(vcon->iropt_level <= 2);
-   vassert(vcon->iropt_unroll_thresh >= 0);
-   vassert(vcon->iropt_unroll_thresh <= 400);
-   vassert(vcon->guest_max_insns >= 1);
-   vassert(vcon->guest_max_insns <= 100);
-   vassert(vcon->guest_chase_thresh >= 0);
-   vassert(vcon->guest_chase_thresh < vcon->guest_max_insns);
-   vassert(vcon->guest_chase_cond == True 
-           || vcon->guest_chase_cond == False);
+   check_VexControl(vcon);
 
 
    vassert(1 == sizeof(UChar));
@@ -268,6 +277,14 @@ void LibVEX_Init (
 }
 
 
+void LibVEX_Update_Control ( const VexControl* vcon )
+{
+   vassert(vex_initdone);
+   check_VexControl(vcon);
+   vex_control = *vcon;
+}
+
+
 UInt s390_host_hwcaps;
 
 
@@ -906,6 +923,8 @@ VexTranslateResult LibVEX_Translate ( VexTranslateArgs* vta )
    
    if (vta->instrument1 || vta->instrument2) {
       do_deadcode_BB( irsb );
+      if (vex_control.iropt_post_instr_getrm)
+         do_redundant_GET_removal_BB( irsb );
       irsb = cprop_BB( irsb );
       do_deadcode_BB( irsb );
       sanityCheckIRSB( irsb, "after post-instrumentation cleanup",
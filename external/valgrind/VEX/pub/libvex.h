@@ -270,6 +270,7 @@ typedef
       Int guest_max_insns;
       Int guest_chase_thresh;
       Bool guest_chase_cond;
+      Bool iropt_post_instr_getrm;
    }
    VexControl;
 
@@ -336,6 +337,9 @@ extern void LibVEX_Init (
 );
 
 
+extern void LibVEX_Update_Control ( const VexControl* vcon );
+
+
 
 typedef
    struct {
@@ -435,3 +435,87 @@ configure_caches(cache_t *I1c, cache_t *D1c, cache_t *LLc,
    }
 }
 
+
+Bool VG_(str_clo_mid_cache_opt)(const HChar *arg,
+                                cache_t* clo_midc,
+                                Int* clo_n_midc,
+                                Bool* clo_midc_auto)
+{
+   const HChar* tmp_str;
+
+   if VG_STR_CLO(arg, "--mid-cache", tmp_str) {
+      if (VG_STREQ(tmp_str, "auto")) {
+         *clo_midc_auto = True;
+      } else if (VG_STREQ(tmp_str, "none")) {
+         *clo_midc_auto = False;
+         *clo_n_midc = 0;
+      } else {
+         if (*clo_n_midc == MAX_MID_CACHES)
+            VG_(fmsg_bad_option)(arg,
+               "At most %d intermediate cache levels can be simulated.\n",
+               MAX_MID_CACHES);
+         parse_cache_opt(&clo_midc[*clo_n_midc], arg, tmp_str);
+         (*clo_n_midc)++;
+      }
+      return True;
+   } else
+      return False;
+}
+
+void VG_(post_clo_init_configure_mid_caches)(cache_t* midc,
+                                             Int* n_midc,
+                                             cache_t* clo_midc,
+                                             Int clo_n_midc,
+                                             Bool clo_midc_auto)
+{
+   Int i;
+   UInt level;
+   HChar desc[8];
+   const HChar* checkRes;
+
+   *n_midc = 0;
+
+   if (clo_n_midc > 0) {
+      for (i = 0; i < clo_n_midc; i++)
+         midc[i] = clo_midc[i];
+      *n_midc = clo_n_midc;
+
+   } else if (clo_midc_auto) {
+      VexArchInfo vai;
+      const VexCacheInfo *ci;
+      const VexCache *c;
+
+      VG_(machine_get_VexArchInfo)(NULL, &vai);
+      ci = &vai.hwcache_info;
+
+      
+      for (level = 2; level < ci->num_levels; level++) {
+         c = locate_cache(ci, UNIFIED_CACHE, level);
+         if (c == NULL) {
+            VG_(dmsg)("warning: L%u cache is not unified, "
+                      "not simulating it.\n", level);
+            continue;
+         }
+         if (*n_midc == MAX_MID_CACHES)
+            break;
+         midc[*n_midc] = (cache_t) { c->sizeB, c->assoc, c->line_sizeB };
+         maybe_tweak_LLc(&midc[*n_midc]);
+         checkRes = check_cache(&midc[*n_midc]);
+         if (checkRes) {
+            VG_(dmsg)("warning: L%u cache configuration not supported, "
+                      "not simulating it: %s", level, checkRes);
+            continue;
+         }
+         (*n_midc)++;
+      }
+      if (*n_midc == 0)
+         VG_(dmsg)("warning: no intermediate cache levels detected.\n");
+   }
+
+   if (VG_(clo_verbosity) >= 2) {
+      for (i = 0; i < *n_midc; i++) {
+         VG_(sprintf)(desc, "L%d", i + 2);
+         umsg_cache_img(desc, &midc[i]);
+      }
+   }
+}
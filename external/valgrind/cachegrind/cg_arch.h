@@ -38,6 +38,8 @@ typedef struct {
 
 #define UNDEFINED_CACHE     { -1, -1, -1 }
 
+#define MAX_MID_CACHES        4
+
 Bool VG_(str_clo_cache_opt)(const HChar *arg,
                             cache_t* clo_I1c,
                             cache_t* clo_D1c,
@@ -52,5 +54,16 @@ void VG_(post_clo_init_configure_caches)(cache_t* I1c,
 
 void VG_(print_cache_clo_opts)(void);
 
+Bool VG_(str_clo_mid_cache_opt)(const HChar *arg,
+                                cache_t* clo_midc,
+                                Int* clo_n_midc,
+                                Bool* clo_midc_auto);
+
+void VG_(post_clo_init_configure_mid_caches)(cache_t* midc,
+                                             Int* n_midc,
+                                             cache_t* clo_midc,
+                                             Int clo_n_midc,
+                                             Bool clo_midc_auto);
+
 #endif   
 
@@ -321,7 +321,7 @@ void log_1IrNoX_1Dr_cache_access(InstrInfo* n, Addr data_addr, Word data_size)
 			 &n->parent->Ir.m1, &n->parent->Ir.mL);
    n->parent->Ir.a++;
 
-   cachesim_D1_doref(data_addr, data_size, 
+   cachesim_D1_doref(n->instr_addr, data_addr, data_size, CACHE_KIND_DR,
                      &n->parent->Dr.m1, &n->parent->Dr.mL);
    n->parent->Dr.a++;
 }
@@ -336,7 +336,7 @@ void log_1IrNoX_1Dw_cache_access(InstrInfo* n, Addr data_addr, Word data_size)
 			 &n->parent->Ir.m1, &n->parent->Ir.mL);
    n->parent->Ir.a++;
 
-   cachesim_D1_doref(data_addr, data_size, 
+   cachesim_D1_doref(n->instr_addr, data_addr, data_size, CACHE_KIND_DW,
                      &n->parent->Dw.m1, &n->parent->Dw.mL);
    n->parent->Dw.a++;
 }
@@ -346,7 +346,7 @@ void log_0Ir_1Dr_cache_access(InstrInfo* n, Addr data_addr, Word data_size)
 {
    
    
-   cachesim_D1_doref(data_addr, data_size, 
+   cachesim_D1_doref(n->instr_addr, data_addr, data_size, CACHE_KIND_DR,
                      &n->parent->Dr.m1, &n->parent->Dr.mL);
    n->parent->Dr.a++;
 }
@@ -356,7 +356,7 @@ void log_0Ir_1Dw_cache_access(InstrInfo* n, Addr data_addr, Word data_size)
 {
    
    
-   cachesim_D1_doref(data_addr, data_size, 
+   cachesim_D1_doref(n->instr_addr, data_addr, data_size, CACHE_KIND_DW,
                      &n->parent->Dw.m1, &n->parent->Dw.mL);
    n->parent->Dw.a++;
 }
@@ -1191,6 +1191,13 @@ IRSB* cg_instrument ( VgCallbackClosure* closure,
 static cache_t clo_I1_cache = UNDEFINED_CACHE;
 static cache_t clo_D1_cache = UNDEFINED_CACHE;
 static cache_t clo_LL_cache = UNDEFINED_CACHE;
+static cache_t clo_mid_caches[MAX_MID_CACHES];
+static Int     clo_n_mid_caches = 0;
+static Bool    clo_mid_caches_auto = False;
+
+static CachePolicy clo_cache_policy = Cache_NonInclusive;
+static Bool        clo_prefetch     = False;
+static Long        clo_cache_sample = 1;
 
 
 static CacheCC  Ir_total;
@@ -1199,6 +1206,27 @@ static CacheCC  Dw_total;
 static BranchCC Bc_total;
 static BranchCC Bi_total;
 
+static const HChar* cache_policy_name(CachePolicy policy)
+{
+   switch (policy) {
+      case Cache_NonInclusive: return "non-inclusive";
+      case Cache_Inclusive:    return "inclusive";
+      case Cache_Exclusive:    return "exclusive";
+      default:                 tl_assert(0);
+   }
+}
+
+static void scale_CacheCC(CacheCC* cc, Double scale)
+{
+   cc->m1 = (ULong)(cc->m1 * scale + 0.5);
+   cc->mL = (ULong)(cc->mL * scale + 0.5);
+}
+
+static ULong sample_error_ULong(Int kind_lo, Int kind_hi, Int level)
+{
+   return (ULong)(cachesim_sample_error(kind_lo, kind_hi, level) + 0.5);
+}
+
 static void fprint_CC_table_and_calc_totals(void)
 {
    Int     i;
@@ -1206,6 +1234,7 @@ static void fprint_CC_table_and_calc_totals(void)
    HChar   *currFile = NULL;
    const HChar *currFn = NULL;
    LineCC* lineCC;
+   Double  scale = (Double)sample_ratio;
 
    
    
@@ -1232,9 +1261,29 @@ static void fprint_CC_table_and_calc_totals(void)
    
    
    VG_(fprintf)(fp,  "desc: I1 cache:         %s\n"
-                     "desc: D1 cache:         %s\n"
-                     "desc: LL cache:         %s\n",
-                     I1.desc_line, D1.desc_line, LL.desc_line);
+                     "desc: D1 cache:         %s\n",
+                     I1.desc_line, D1.desc_line);
+   for (i = 0; i < n_mid; i++)
+      VG_(fprintf)(fp, "desc: L%d cache:         %s\n",
+                       i + 2, Mid[i].desc_line);
+   VG_(fprintf)(fp,  "desc: LL cache:         %s\n", LL.desc_line);
+   if (cachesim_policy != Cache_NonInclusive)
+      VG_(fprintf)(fp, "desc: Cache policy:     %s\n",
+                       cache_policy_name(cachesim_policy));
+   if (cachesim_prefetch)
+      VG_(fprintf)(fp, "desc: Prefetcher:       stride, into D1\n");
+   if (clo_cache_sim && sample_ratio > 1) {
+      VG_(fprintf)(fp, "desc: Sampling:         1 in %u cache sets\n",
+                       sample_ratio);
+      VG_(fprintf)(fp, "desc: Sampling error:   I1mr:%llu ILmr:%llu "
+                          "D1mr:%llu DLmr:%llu D1mw:%llu DLmw:%llu\n",
+                          sample_error_ULong(CACHE_KIND_IR, CACHE_KIND_IR, 0),
+                          sample_error_ULong(CACHE_KIND_IR, CACHE_KIND_IR, 1),
+                          sample_error_ULong(CACHE_KIND_DR, CACHE_KIND_DR, 0),
+                          sample_error_ULong(CACHE_KIND_DR, CACHE_KIND_DR, 1),
+                          sample_error_ULong(CACHE_KIND_DW, CACHE_KIND_DW, 0),
+                          sample_error_ULong(CACHE_KIND_DW, CACHE_KIND_DW, 1));
+   }
 
    
    VG_(fprintf)(fp, "cmd: %s", VG_(args_the_exename));
@@ -1283,6 +1332,12 @@ static void fprint_CC_table_and_calc_totals(void)
          distinct_fns++;
       }
 
+      if (scale != 1.0) {
+         scale_CacheCC(&lineCC->Ir, scale);
+         scale_CacheCC(&lineCC->Dr, scale);
+         scale_CacheCC(&lineCC->Dw, scale);
+      }
+
       
       if (clo_cache_sim && clo_branch_sim) {
          VG_(fprintf)(fp,  "%u %llu %llu %llu"
@@ -1396,7 +1451,7 @@ static void cg_fini(Int exitcode)
    BranchCC B_total;
    ULong LL_total_m, LL_total_mr, LL_total_mw,
          LL_total, LL_total_r, LL_total_w;
-   Int l1, l2, l3;
+   Int l1, l2, l3, i;
 
    fprint_CC_table_and_calc_totals();
 
@@ -1455,11 +1510,30 @@ static void cg_fini(Int exitcode)
                 l3, Dw_total.mL * 100.0 / Dw_total.a);
       VG_(umsg)("\n");
 
-      
-
-      LL_total   = Dr_total.m1 + Dw_total.m1 + Ir_total.m1;
       LL_total_r = Dr_total.m1 + Ir_total.m1;
       LL_total_w = Dw_total.m1;
+      for (i = 0; i < n_mid; i++) {
+         HChar label[16];
+         Double scale = (Double)sample_ratio;
+         ULong mid_r  = (ULong)((mid_misses[i][CACHE_KIND_IR]
+                                 + mid_misses[i][CACHE_KIND_DR]) * scale + 0.5);
+         ULong mid_w  = (ULong)(mid_misses[i][CACHE_KIND_DW] * scale + 0.5);
+
+         VG_(sprintf)(label, "L%d misses:    ", i + 2);
+         VG_(umsg)(fmt, label, mid_r + mid_w, mid_r, mid_w);
+         VG_(umsg)("L%d miss rate:  %*.1f%% (%*.1f%%     + %*.1f%%  )\n", i + 2,
+                   l1, (mid_r + mid_w) * 100.0 / (Ir_total.a + D_total.a),
+                   l2, mid_r * 100.0 / (Ir_total.a + Dr_total.a),
+                   l3, mid_w * 100.0 / Dw_total.a);
+         LL_total_r = mid_r;
+         LL_total_w = mid_w;
+      }
+      if (n_mid > 0)
+         VG_(umsg)("\n");
+
+      
+
+      LL_total   = LL_total_r + LL_total_w;
       VG_(umsg)(fmt, "LL refs:      ",
                      LL_total, LL_total_r, LL_total_w);
 
@@ -1473,6 +1547,33 @@ static void cg_fini(Int exitcode)
                 l1, LL_total_m  * 100.0 / (Ir_total.a + D_total.a),
                 l2, LL_total_mr * 100.0 / (Ir_total.a + Dr_total.a),
                 l3, LL_total_mw * 100.0 / Dw_total.a);
+
+      if (cachesim_prefetch) {
+         VG_(umsg)("\n");
+         VG_(umsg)("Prefetches:    %'llu (%'llu from memory)\n",
+                   n_prefetches, n_prefetches_mem);
+      }
+
+      if (sample_ratio > 1) {
+         VG_(umsg)("\n");
+         VG_(umsg)("Sampled 1 in %u cache sets; misses are estimates.\n",
+                   sample_ratio);
+         VG_(sprintf)(fmt, "%%s %%,%dllu\n", l1);
+         VG_(umsg)(fmt, "I1  std err:  ",
+                   sample_error_ULong(CACHE_KIND_IR, CACHE_KIND_IR, 0));
+         VG_(umsg)(fmt, "LLi std err:  ",
+                   sample_error_ULong(CACHE_KIND_IR, CACHE_KIND_IR, 1));
+         VG_(sprintf)(fmt, "%%s %%,%dllu  (%%,%dllu rd   + %%,%dllu wr)\n",
+                           l1, l2, l3);
+         VG_(umsg)(fmt, "D1  std err:  ",
+                   sample_error_ULong(CACHE_KIND_DR, CACHE_KIND_DW, 0),
+                   sample_error_ULong(CACHE_KIND_DR, CACHE_KIND_DR, 0),
+                   sample_error_ULong(CACHE_KIND_DW, CACHE_KIND_DW, 0));
+         VG_(umsg)(fmt, "LLd std err:  ",
+                   sample_error_ULong(CACHE_KIND_DR, CACHE_KIND_DW, 1),
+                   sample_error_ULong(CACHE_KIND_DR, CACHE_KIND_DR, 1),
+                   sample_error_ULong(CACHE_KIND_DW, CACHE_KIND_DW, 1));
+      }
    }
 
    
@@ -1527,6 +1628,9 @@ static void cg_fini(Int exitcode)
                 VG_(OSetGen_Size)(CC_table));
       VG_(dmsg)("cachegrind: InstrInfo table size: %lu\n",
                 VG_(OSetGen_Size)(instrInfoTable));
+      if (cachesim_policy == Cache_Inclusive)
+         VG_(dmsg)("cachegrind: back-invalidations: %llu\n",
+                   n_back_invalidations);
    }
 }
 
@@ -1559,9 +1663,22 @@ static Bool cg_process_cmd_line_option(const HChar* arg)
                               &clo_D1_cache,
                               &clo_LL_cache)) {}
 
+   else if (VG_(str_clo_mid_cache_opt)(arg,
+                                       clo_mid_caches,
+                                       &clo_n_mid_caches,
+                                       &clo_mid_caches_auto)) {}
+
    else if VG_STR_CLO( arg, "--cachegrind-out-file", clo_cachegrind_out_file) {}
    else if VG_BOOL_CLO(arg, "--cache-sim",  clo_cache_sim)  {}
    else if VG_BOOL_CLO(arg, "--branch-sim", clo_branch_sim) {}
+   else if VG_XACT_CLO(arg, "--cache-policy=non-inclusive",
+                            clo_cache_policy, Cache_NonInclusive) {}
+   else if VG_XACT_CLO(arg, "--cache-policy=inclusive",
+                            clo_cache_policy, Cache_Inclusive) {}
+   else if VG_XACT_CLO(arg, "--cache-policy=exclusive",
+                            clo_cache_policy, Cache_Exclusive) {}
+   else if VG_BOOL_CLO(arg, "--prefetch", clo_prefetch) {}
+   else if VG_BINT_CLO(arg, "--cache-sample", clo_cache_sample, 1, 65536) {}
    else
       return False;
 
@@ -1572,6 +1689,14 @@ static void cg_print_usage(void)
 {
    VG_(print_cache_clo_opts)();
    VG_(printf)(
+"    --mid-cache=<size>,<assoc>,<line_size>  add an intermediate unified\n"
+"                                     cache level (may be repeated)\n"
+"    --mid-cache=auto|none [none]     use the detected intermediate levels?\n"
+"    --cache-policy=non-inclusive|inclusive|exclusive [non-inclusive]\n"
+"                                     how cache levels share lines\n"
+"    --prefetch=yes|no   [no]         simulate a stride prefetcher into D1?\n"
+"    --cache-sample=<n>  [1]          simulate 1 in <n> cache sets and scale\n"
+"                                     the miss counts (<n> a power of two)\n"
 "    --cache-sim=yes|no  [yes]        collect cache stats?\n"
 "    --branch-sim=yes|no [no]         collect branch prediction stats?\n"
 "    --cachegrind-out-file=<file>     output file name [cachegrind.out.%%p]\n"
@@ -1615,6 +1740,8 @@ static void cg_pre_clo_init(void)
 static void cg_post_clo_init(void)
 {
    cache_t I1c, D1c, LLc; 
+   cache_t midc[MAX_MID_CACHES];
+   Int     n_midc, i;
 
    CC_table =
       VG_(OSetGen_Create)(offsetof(LineCC, loc),
@@ -1636,12 +1763,30 @@ static void cg_post_clo_init(void)
                                        &clo_I1_cache,
                                        &clo_D1_cache,
                                        &clo_LL_cache);
+   VG_(post_clo_init_configure_mid_caches)(midc, &n_midc,
+                                           clo_mid_caches,
+                                           clo_n_mid_caches,
+                                           clo_mid_caches_auto);
 
    
    
    
    min_line_size = (I1c.line_size < D1c.line_size) ? I1c.line_size : D1c.line_size;
    min_line_size = (LLc.line_size < min_line_size) ? LLc.line_size : min_line_size;
+   for (i = 0; i < n_midc; i++)
+      if (midc[i].line_size < min_line_size)
+         min_line_size = midc[i].line_size;
+
+   if (clo_cache_policy == Cache_Exclusive) {
+      Bool same = I1c.line_size == D1c.line_size
+                  && D1c.line_size == LLc.line_size;
+      for (i = 0; i < n_midc; i++)
+         if (midc[i].line_size != LLc.line_size)
+            same = False;
+      if (!same)
+         VG_(fmsg_bad_option)("--cache-policy=exclusive",
+            "All cache levels must have the same line size.\n");
+   }
 
    Int largest_load_or_store_size
       = VG_(machine_get_size_of_largest_guest_register)();
@@ -1654,7 +1799,17 @@ static void cg_post_clo_init(void)
       VG_(exit)(1);
    }
 
-   cachesim_initcaches(I1c, D1c, LLc);
+   cachesim_initcaches(I1c, D1c, midc, n_midc, LLc);
+
+   if (-1 == VG_(log2)((UInt)clo_cache_sample))
+      VG_(fmsg_bad_option)("--cache-sample",
+         "The sampling ratio must be a power of two.\n");
+   if (clo_cache_sample > cachesim_max_sample_ratio())
+      VG_(fmsg_bad_option)("--cache-sample",
+         "At most 1 in %u sets can be sampled with these caches.\n",
+         cachesim_max_sample_ratio());
+
+   cachesim_configure(clo_cache_policy, clo_prefetch, (UInt)clo_cache_sample);
 }
 
 VG_DETERMINE_INTERFACE_VERSION(cg_pre_clo_init)
@@ -141,18 +141,399 @@ Bool cachesim_ref_is_miss(cache_t2* c, Addr a, UChar size)
 static cache_t2 LL;
 static cache_t2 I1;
 static cache_t2 D1;
+static cache_t2 Mid[MAX_MID_CACHES];
+static Int      n_mid = 0;
 
-static void cachesim_initcaches(cache_t I1c, cache_t D1c, cache_t LLc)
+static cache_t2* lower[MAX_MID_CACHES + 1];
+static Int       n_lower = 0;
+
+static void cachesim_initcaches(cache_t I1c, cache_t D1c,
+                                cache_t* midc, Int n_midc, cache_t LLc)
 {
+   Int i;
+
    cachesim_initcache(I1c, &I1);
    cachesim_initcache(D1c, &D1);
+   for (i = 0; i < n_midc; i++) {
+      cachesim_initcache(midc[i], &Mid[i]);
+      lower[i] = &Mid[i];
+   }
+   n_mid = n_midc;
    cachesim_initcache(LLc, &LL);
+   lower[n_mid] = &LL;
+   n_lower = n_mid + 1;
+}
+
+
+typedef
+   enum { Cache_NonInclusive, Cache_Inclusive, Cache_Exclusive }
+   CachePolicy;
+
+#define CACHE_KIND_IR 0
+#define CACHE_KIND_DR 1
+#define CACHE_KIND_DW 2
+
+static Bool        cachesim_full     = False;
+static CachePolicy cachesim_policy   = Cache_NonInclusive;
+static Bool        cachesim_prefetch = False;
+
+static ULong mid_misses[MAX_MID_CACHES][3];
+static ULong n_back_invalidations = 0;
+static ULong n_prefetches         = 0;
+static ULong n_prefetches_mem     = 0;
+
+#define SAMPLE_GROUPS 64
+
+static UInt  sample_ratio       = 1;
+static Int   sample_shift       = 0;
+static UWord sample_mask        = 0;
+static Int   sample_group_shift = 0;
+static ULong sample_groups[3][2][SAMPLE_GROUPS];
+
+static Int cachesim_max_line_size_bits(void)
+{
+   Int i, bits = I1.line_size_bits;
+
+   if (D1.line_size_bits > bits) bits = D1.line_size_bits;
+   for (i = 0; i < n_lower; i++)
+      if (lower[i]->line_size_bits > bits) bits = lower[i]->line_size_bits;
+   return bits;
+}
+
+static UInt cachesim_max_sample_ratio(void)
+{
+   Int i, max_bits = cachesim_max_line_size_bits();
+   Int bits = I1.line_size_bits + VG_(log2)(I1.sets) - max_bits;
+
+   if (D1.line_size_bits + VG_(log2)(D1.sets) - max_bits < bits)
+      bits = D1.line_size_bits + VG_(log2)(D1.sets) - max_bits;
+   for (i = 0; i < n_lower; i++) {
+      Int b = lower[i]->line_size_bits + VG_(log2)(lower[i]->sets) - max_bits;
+      if (b < bits) bits = b;
+   }
+   return bits > 0 ? 1U << bits : 1;
+}
+
+static void cachesim_configure(CachePolicy policy, Bool prefetch, UInt ratio)
+{
+   tl_assert(VG_(log2)(ratio) >= 0 && ratio <= cachesim_max_sample_ratio());
+
+   cachesim_policy    = policy;
+   cachesim_prefetch  = prefetch;
+   sample_ratio       = ratio;
+   sample_shift       = cachesim_max_line_size_bits();
+   sample_mask        = ratio - 1;
+   sample_group_shift = sample_shift + VG_(log2)(ratio);
+   cachesim_full      = n_mid > 0 || policy != Cache_NonInclusive
+                        || prefetch || ratio > 1;
+}
+
+static __inline__ Bool cachesim_is_sampled(Addr a)
+{
+   return ((a >> sample_shift) & sample_mask) == 0;
+}
+
+static Bool cachesim_setref_victim(cache_t2* c, UInt set_no, UWord tag,
+                                   UWord* victim)
+{
+   Int i, j;
+   UWord *set;
+
+   set = &(c->tags[set_no * c->assoc]);
+   *victim = 0;
+
+   if (tag == set[0])
+      return False;
+
+   for (i = 1; i < c->assoc; i++) {
+      if (tag == set[i]) {
+         for (j = i; j > 0; j--) {
+            set[j] = set[j - 1];
+         }
+         set[0] = tag;
+
+         return False;
+      }
+   }
+
+   *victim = set[c->assoc - 1];
+   for (j = c->assoc - 1; j > 0; j--) {
+      set[j] = set[j - 1];
+   }
+   set[0] = tag;
+
+   return True;
+}
+
+static Bool cachesim_setref_remove(cache_t2* c, UInt set_no, UWord tag)
+{
+   Int i, j;
+   UWord *set;
+
+   set = &(c->tags[set_no * c->assoc]);
+
+   for (i = 0; i < c->assoc; i++) {
+      if (tag == set[i]) {
+         for (j = i; j < c->assoc - 1; j++) {
+            set[j] = set[j + 1];
+         }
+         set[c->assoc - 1] = 0;
+
+         return True;
+      }
+   }
+   return False;
+}
+
+static Bool cachesim_ref_victims(cache_t2* c, Addr a, UChar size,
+                                 UWord* victims)
+{
+   UWord block1 =  a         >> c->line_size_bits;
+   UWord block2 = (a+size-1) >> c->line_size_bits;
+   Bool  miss;
+
+   victims[1] = 0;
+   miss = cachesim_setref_victim(c, block1 & c->sets_min_1, block1,
+                                 &victims[0]);
+   if (block1 != block2) {
+      tl_assert(block1 + 1 == block2);
+      if (cachesim_setref_victim(c, block2 & c->sets_min_1, block2,
+                                 &victims[1]))
+         miss = True;
+   }
+   return miss;
+}
+
+static void cachesim_invalidate_range(cache_t2* c, Addr lo, Addr hi)
+{
+   UWord block;
+
+   for (block = lo >> c->line_size_bits;
+        block <= (hi >> c->line_size_bits); block++) {
+      if (cachesim_setref_remove(c, block & c->sets_min_1, block))
+         n_back_invalidations++;
+   }
+}
+
+static void cachesim_back_invalidate(Int level, UWord victim)
+{
+   Addr lo = victim << lower[level]->line_size_bits;
+   Addr hi = lo + lower[level]->line_size - 1;
+   Int  i;
+
+   for (i = 0; i < level; i++)
+      cachesim_invalidate_range(lower[i], lo, hi);
+   cachesim_invalidate_range(&I1, lo, hi);
+   cachesim_invalidate_range(&D1, lo, hi);
+}
+
+static Int cachesim_block_depth_excl(cache_t2* l1, UWord block)
+{
+   UWord victim;
+   Int   i, depth;
+
+   if (!cachesim_setref_victim(l1, block & l1->sets_min_1, block, &victim))
+      return 0;
+
+   depth = n_lower + 1;
+   for (i = 0; i < n_lower; i++) {
+      if (cachesim_setref_remove(lower[i], block & lower[i]->sets_min_1,
+                                 block)) {
+         depth = i + 1;
+         break;
+      }
+   }
+
+   for (i = 0; i < n_lower && victim != 0; i++)
+      cachesim_setref_victim(lower[i], victim & lower[i]->sets_min_1,
+                             victim, &victim);
+
+   return depth;
+}
+
+static Int cachesim_block_depth(cache_t2* l1, Addr a, UChar size)
+{
+   UWord block = a >> l1->line_size_bits;
+   UWord victims[2];
+   Int   i;
+
+   if (cachesim_policy == Cache_Exclusive)
+      return cachesim_block_depth_excl(l1, block);
+
+   if (!cachesim_setref_victim(l1, block & l1->sets_min_1, block,
+                               &victims[0]))
+      return 0;
+
+   for (i = 0; i < n_lower; i++) {
+      Bool miss = cachesim_ref_victims(lower[i], a, size, victims);
+      if (cachesim_policy == Cache_Inclusive) {
+         if (victims[0] != 0) cachesim_back_invalidate(i, victims[0]);
+         if (victims[1] != 0) cachesim_back_invalidate(i, victims[1]);
+      }
+      if (!miss)
+         return i + 1;
+   }
+   return n_lower + 1;
+}
+
+__attribute__((always_inline))
+static __inline__
+void cachesim_hier_ref(cache_t2* l1, Addr a, UChar size, Int kind,
+                              ULong* m1, ULong* mL)
+{
+   Addr  end   = a + size - 1;
+   Addr  next  = ((a >> l1->line_size_bits) + 1) << l1->line_size_bits;
+   Addr  ga    = a;
+   Int   i, d, depth = 0;
+   UWord g;
+
+   if (LIKELY(end < next)) {
+      UWord block = a >> l1->line_size_bits;
+      if (!cachesim_is_sampled(a))
+         return;
+      if (l1->tags[(block & l1->sets_min_1) * l1->assoc] == block)
+         return;
+      depth = cachesim_block_depth(l1, a, size);
+   } else {
+      if (cachesim_is_sampled(a))
+         depth = cachesim_block_depth(l1, a, next - a);
+      else
+         ga = next;
+      if (cachesim_is_sampled(next)) {
+         d = cachesim_block_depth(l1, next, end - next + 1);
+         if (d > depth) depth = d;
+      }
+   }
+   if (depth == 0)
+      return;
+
+   g = (ga >> sample_group_shift) & (SAMPLE_GROUPS - 1);
+   (*m1)++;
+   sample_groups[kind][0][g]++;
+   for (i = 0; i < n_mid && i + 2 <= depth; i++)
+      mid_misses[i][kind]++;
+   if (depth > n_lower) {
+      (*mL)++;
+      sample_groups[kind][1][g]++;
+   }
+}
+
+
+#define PREFETCH_TABLE_SIZE 256
+
+typedef struct {
+   Addr pc;
+   Addr last;
+   Word stride;
+   Int  confidence;
+} prefetch_entry;
+
+static prefetch_entry prefetch_table[PREFETCH_TABLE_SIZE];
+
+static void cachesim_prefetch_ref(Addr pc, Addr a)
+{
+   prefetch_entry* e
+      = &prefetch_table[(pc ^ (pc >> 8)) & (PREFETCH_TABLE_SIZE - 1)];
+   Word stride;
+   Addr target;
+
+   if (e->pc != pc) {
+      e->pc         = pc;
+      e->last       = a;
+      e->stride     = 0;
+      e->confidence = 0;
+      return;
+   }
+
+   stride  = (Word)(a - e->last);
+   e->last = a;
+   if (stride == 0 || stride != e->stride) {
+      e->stride     = stride;
+      e->confidence = 0;
+      return;
+   }
+   if (e->confidence < 2) {
+      e->confidence++;
+      return;
+   }
+
+   
+   if (stride >= D1.line_size || -stride >= D1.line_size)
+      target = a + stride;
+   else if (stride > 0)
+      target = a + D1.line_size;
+   else
+      target = a - D1.line_size;
+
+   if ((target >> D1.line_size_bits) == (a >> D1.line_size_bits))
+      return;
+
+   if (!cachesim_is_sampled(target))
+      return;
+   n_prefetches++;
+   if (cachesim_block_depth(&D1, target, 1) > n_lower)
+      n_prefetches_mem++;
+}
+
+
+static Double cachesim_sqrt(Double x)
+{
+   Double r = x;
+   Int    i;
+
+   if (x <= 0.0)
+      return 0.0;
+   for (i = 0; i < 64; i++)
+      r = 0.5 * (r + x / r);
+   return r;
+}
+
+static Double cachesim_sample_error(Int kind_lo, Int kind_hi, Int level)
+{
+   Double n = SAMPLE_GROUPS, sum = 0.0, sumsq = 0.0, mean, var;
+   Int    g, kind;
+
+   if (sample_ratio == 1)
+      return 0.0;
+
+   for (g = 0; g < SAMPLE_GROUPS; g++) {
+      Double x = 0.0;
+      for (kind = kind_lo; kind <= kind_hi; kind++)
+         x += (Double)sample_groups[kind][level][g];
+      sum   += x;
+      sumsq += x * x;
+   }
+   mean = sum / n;
+   var  = (sumsq - n * mean * mean) / (n - 1.0);
+   if (var < 0.0) var = 0.0;
+   return sample_ratio * cachesim_sqrt(n * var * (1.0 - 1.0 / sample_ratio));
+}
+
+__attribute__((always_inline))
+static __inline__
+void cachesim_I1_doref_full(Addr a, UChar size, ULong* m1, ULong* mL)
+{
+   cachesim_hier_ref(&I1, a, size, CACHE_KIND_IR, m1, mL);
+}
+
+__attribute__((always_inline))
+static __inline__
+void cachesim_D1_doref_full(Addr pc, Addr a, UChar size, Int kind,
+                                   ULong* m1, ULong* mL)
+{
+   cachesim_hier_ref(&D1, a, size, kind, m1, mL);
+   if (cachesim_prefetch)
+      cachesim_prefetch_ref(pc, a);
 }
 
 __attribute__((always_inline))
 static __inline__
 void cachesim_I1_doref_Gen(Addr a, UChar size, ULong* m1, ULong *mL)
 {
+   if (UNLIKELY(cachesim_full)) {
+      cachesim_I1_doref_full(a, size, m1, mL);
+      return;
+   }
    if (cachesim_ref_is_miss(&I1, a, size)) {
       (*m1)++;
       if (cachesim_ref_is_miss(&LL, a, size))
@@ -167,6 +548,11 @@ void cachesim_I1_doref_NoX(Addr a, UChar size, ULong* m1, ULong *mL)
    UWord block  = a >> I1.line_size_bits;
    UInt  I1_set = block & I1.sets_min_1;
 
+   if (UNLIKELY(cachesim_full)) {
+      cachesim_I1_doref_full(a, size, m1, mL);
+      return;
+   }
+
    
    if (cachesim_setref_is_miss(&I1, I1_set, block)) {
       UInt  LL_set = block & LL.sets_min_1;
@@ -179,8 +565,13 @@ void cachesim_I1_doref_NoX(Addr a, UChar size, ULong* m1, ULong *mL)
 
 __attribute__((always_inline))
 static __inline__
-void cachesim_D1_doref(Addr a, UChar size, ULong* m1, ULong *mL)
+void cachesim_D1_doref(Addr pc, Addr a, UChar size, Int kind,
+                       ULong* m1, ULong *mL)
 {
+   if (UNLIKELY(cachesim_full)) {
+      cachesim_D1_doref_full(pc, a, size, kind, m1, mL);
+      return;
+   }
    if (cachesim_ref_is_miss(&D1, a, size)) {
       (*m1)++;
       if (cachesim_ref_is_miss(&LL, a, size))
@@ -381,6 +381,11 @@ Bool CLG_(process_cmd_line_option)(const HChar* arg)
 
    else if VG_BOOL_CLO(arg, "--combine-dumps", CLG_(clo).combine_dumps) {}
 
+   else if VG_XACT_CLO(arg, "--dump-format=text",   CLG_(clo).binary_dumps, False) {}
+   else if VG_XACT_CLO(arg, "--dump-format=binary", CLG_(clo).binary_dumps, True) {}
+
+   else if VG_BOOL_CLO(arg, "--dump-background", CLG_(clo).background_dumps) {}
+
    else if VG_BOOL_CLO(arg, "--collect-atstart", CLG_(clo).collect_atstart) {}
 
    else if VG_BOOL_CLO(arg, "--instr-atstart", CLG_(clo).instrument_atstart) {}
@@ -519,6 +524,8 @@ void CLG_(print_usage)(void)
 "    --compress-strings=no|yes Compress strings in profile dump? [yes]\n"
 "    --compress-pos=no|yes     Compress positions in profile dump? [yes]\n"
 "    --combine-dumps=no|yes    Concat all dumps into same file [no]\n"
+"    --dump-format=text|binary Format of profile dumps [text]\n"
+"    --dump-background=no|yes  Write triggered dumps from a forked process? [no]\n"
 #if CLG_EXPERIMENTAL
 "    --compress-events=no|yes  Compress events in profile dump? [no]\n"
 "    --dump-bb=no|yes          Dump basic block address of costs? [no]\n"
@@ -591,6 +598,8 @@ void CLG_(set_clo_defaults)(void)
   
   CLG_(clo).out_format       = 0;
   CLG_(clo).combine_dumps    = False;
+  CLG_(clo).binary_dumps     = False;
+  CLG_(clo).background_dumps = False;
   CLG_(clo).compress_strings = True;
   CLG_(clo).compress_mangled = False;
   CLG_(clo).compress_events  = False;
@@ -99,6 +99,188 @@ void free_dump_array(void)
 }
 
 
+#define BIN_END     0
+#define BIN_TEXT    1
+#define BIN_NAME    2
+#define BIN_COST    3
+#define BIN_CALLS   4
+#define BIN_JUMP    5
+#define BIN_JCND    6
+
+static const HChar* bin_name_tags[] = {
+    "ob", "fl", "fi", "fe", "fn", "cob", "cfi", "cfn", "jfi", "jfn", "frfn", 0
+};
+
+static UChar* bin_rec = 0;
+static SizeT  bin_rec_size = 0;
+static SizeT  bin_rec_len = 0;
+
+static HChar* bin_text = 0;
+static SizeT  bin_text_size = 0;
+static SizeT  bin_text_len = 0;
+
+static ULong  bin_last_pos[3];
+static ULong* bin_last_cost = 0;
+static Int    bin_last_cost_size = 0;
+
+static void bin_reserve(SizeT n)
+{
+    if (bin_rec_len + n <= bin_rec_size) return;
+
+    while (bin_rec_len + n > bin_rec_size)
+	bin_rec_size = bin_rec_size ? 2 * bin_rec_size : 256;
+    bin_rec = VG_(realloc)("cl.dump.br.1", bin_rec, bin_rec_size);
+}
+
+static __inline__
+void bin_begin(UChar tag)
+{
+    bin_rec_len = 0;
+    bin_reserve(1);
+    bin_rec[bin_rec_len++] = tag;
+}
+
+static __inline__
+void bin_uint(ULong v)
+{
+    UChar tmp[10];
+    Int n = 0;
+
+    bin_reserve(10);
+    do {
+	tmp[n++] = (UChar)(v & 0x7f);
+	v >>= 7;
+    } while (v);
+    while (n > 1)
+	bin_rec[bin_rec_len++] = tmp[--n] | 0x80;
+    bin_rec[bin_rec_len++] = tmp[0];
+}
+
+static __inline__
+void bin_sint(Long v)
+{
+    bin_uint(((ULong)v << 1) ^ (ULong)(v >> 63));
+}
+
+static void bin_bytes(const void* p, SizeT n)
+{
+    bin_reserve(n);
+    VG_(memcpy)(bin_rec + bin_rec_len, p, n);
+    bin_rec_len += n;
+}
+
+static __inline__
+void bin_flush(VgFile *fp)
+{
+    VG_(fwrite)(fp, bin_rec, bin_rec_len);
+}
+
+static void bin_text_sink(HChar c, void* opaque)
+{
+    if (bin_text_len == bin_text_size) {
+	bin_text_size = bin_text_size ? 2 * bin_text_size : 256;
+	bin_text = VG_(realloc)("cl.dump.bts.1", bin_text, bin_text_size);
+    }
+    bin_text[bin_text_len++] = c;
+}
+
+static void bin_text_printf(const HChar* format, ...)
+{
+    va_list vargs;
+    va_start(vargs, format);
+    VG_(vcbprintf)(bin_text_sink, 0, format, vargs);
+    va_end(vargs);
+}
+
+static void bin_reset(void)
+{
+    Int i;
+
+    for(i=0;i<3;i++)
+	bin_last_pos[i] = 0;
+
+    if (bin_last_cost_size < CLG_(dumpmap)->size) {
+	bin_last_cost_size = CLG_(dumpmap)->size;
+	bin_last_cost = VG_(realloc)("cl.dump.blc.1", bin_last_cost,
+				     bin_last_cost_size * sizeof(ULong));
+    }
+    for(i=0;i<bin_last_cost_size;i++)
+	bin_last_cost[i] = 0;
+}
+
+static void bin_name(VgFile *fp, const HChar* tag, Int id, const HChar* name)
+{
+    Int kind, len;
+
+    for(kind=0; bin_name_tags[kind]; kind++) {
+	len = VG_(strlen)(bin_name_tags[kind]);
+	if ((VG_(strncmp)(tag, bin_name_tags[kind], len) == 0) &&
+	    (tag[len] == '=' || tag[len] == 0)) break;
+    }
+    CLG_ASSERT(bin_name_tags[kind] != 0);
+
+    bin_begin(BIN_NAME);
+    bin_uint(kind);
+    bin_uint(id);
+    if (name) {
+	len = VG_(strlen)(name);
+	bin_uint(len);
+	bin_bytes(name, len);
+    }
+    else
+	bin_uint(0);
+    bin_flush(fp);
+}
+
+static void bin_pos(const AddrPos* curr)
+{
+    if (CLG_(clo).dump_instr) {
+	bin_sint((Long)(curr->addr - bin_last_pos[0]));
+	bin_last_pos[0] = curr->addr;
+    }
+    if (CLG_(clo).dump_bb) {
+	bin_sint((Long)(curr->bb_addr - bin_last_pos[1]));
+	bin_last_pos[1] = curr->bb_addr;
+    }
+    if (CLG_(clo).dump_line) {
+	bin_sint((Long)curr->line - (Long)bin_last_pos[2]);
+	bin_last_pos[2] = curr->line;
+    }
+}
+
+static void bin_cost(const EventMapping* em, const ULong* cost)
+{
+    Int i, n = 1;
+
+    for(i=1; i<em->size; i++)
+	if (cost[em->entry[i].offset] != 0) n = i+1;
+
+    bin_uint(n);
+    for(i=0; i<n; i++) {
+	ULong v = cost[em->entry[i].offset];
+	bin_sint((Long)(v - bin_last_cost[i]));
+	bin_last_cost[i] = v;
+    }
+}
+
+static void out_printf(VgFile *fp, const HChar* format, ...)
+{
+    va_list vargs;
+    va_start(vargs, format);
+    if (CLG_(clo).binary_dumps) {
+	bin_text_len = 0;
+	VG_(vcbprintf)(bin_text_sink, 0, format, vargs);
+	bin_begin(BIN_TEXT);
+	bin_uint(bin_text_len);
+	bin_bytes(bin_text, bin_text_len);
+	bin_flush(fp);
+    }
+    else
+	VG_(vfprintf)(fp, format, vargs);
+    va_end(vargs);
+}
+
+
 static __inline__
 void init_fpos(FnPos* p)
  {
@@ -112,7 +294,12 @@ void init_fpos(FnPos* p)
 
 static void print_obj(VgFile *fp, const HChar* prefix, obj_node* obj)
 {
-    if (CLG_(clo).compress_strings) {
+    if (CLG_(clo).binary_dumps) {
+	CLG_ASSERT(obj_dumped != 0);
+	bin_name(fp, prefix, obj->number,
+		 obj_dumped[obj->number] ? 0 : obj->name);
+    }
+    else if (CLG_(clo).compress_strings) {
 	CLG_ASSERT(obj_dumped != 0);
 	if (obj_dumped[obj->number])
             VG_(fprintf)(fp, "%s(%d)\n", prefix, obj->number);
@@ -136,7 +323,13 @@ static void print_obj(VgFile *fp, const HChar* prefix, obj_node* obj)
 
 static void print_file(VgFile *fp, const char *prefix, const file_node* file)
 {
-    if (CLG_(clo).compress_strings) {
+    if (CLG_(clo).binary_dumps) {
+	CLG_ASSERT(file_dumped != 0);
+	bin_name(fp, prefix, file->number,
+		 file_dumped[file->number] ? 0 : file->name);
+	file_dumped[file->number] = True;
+    }
+    else if (CLG_(clo).compress_strings) {
 	CLG_ASSERT(file_dumped != 0);
 	if (file_dumped[file->number])
             VG_(fprintf)(fp, "%s(%d)\n", prefix, file->number);
@@ -151,6 +344,13 @@ static void print_file(VgFile *fp, const char *prefix, const file_node* file)
 
 static void print_fn(VgFile *fp, const HChar* tag, const fn_node* fn)
 {
+    if (CLG_(clo).binary_dumps) {
+	CLG_ASSERT(fn_dumped != 0);
+	bin_name(fp, tag, fn->number, fn_dumped[fn->number] ? 0 : fn->name);
+	fn_dumped[fn->number] = True;
+	return;
+    }
+
     VG_(fprintf)(fp, "%s=",tag);
     if (CLG_(clo).compress_strings) {
 	CLG_ASSERT(fn_dumped != 0);
@@ -170,6 +370,28 @@ static void print_mangled_fn(VgFile *fp, const HChar* tag,
 {
     int i;
 
+    if (CLG_(clo).binary_dumps && !CLG_(clo).compress_mangled) {
+	Int id = cxt->base_number + rec_index;
+
+	CLG_ASSERT(cxt_dumped != 0);
+	if (cxt_dumped[id]) {
+	    bin_name(fp, tag, id, 0);
+	    return;
+	}
+
+	bin_text_len = 0;
+	bin_text_printf("%s", cxt->fn[0]->name);
+	if (rec_index >0)
+	    bin_text_printf("'%d", rec_index +1);
+	for(i=1;i<cxt->size;i++)
+	    bin_text_printf("'%s", cxt->fn[i]->name);
+	bin_text_printf("%c", '\0');
+
+	bin_name(fp, tag, id, bin_text);
+	cxt_dumped[id] = True;
+	return;
+    }
+
     if (CLG_(clo).compress_strings && CLG_(clo).compress_mangled) {
 
 	int n;
@@ -177,7 +399,7 @@ static void print_mangled_fn(VgFile *fp, const HChar* tag,
 
 	CLG_ASSERT(cxt_dumped != 0);
 	if (cxt_dumped[cxt->base_number+rec_index]) {
-            VG_(fprintf)(fp, "%s=(%d)\n",
+            out_printf(fp, "%s=(%d)\n",
 			     tag, cxt->base_number + rec_index);
 	    return;
 	}
@@ -188,7 +410,7 @@ static void print_mangled_fn(VgFile *fp, const HChar* tag,
 	    CLG_ASSERT(cxt->fn[i-1]->pure_cxt != 0);
 	    n = cxt->fn[i-1]->pure_cxt->base_number;
 	    if (cxt_dumped[n]) continue;
-	    VG_(fprintf)(fp, "%s=(%d) %s\n",
+	    out_printf(fp, "%s=(%d) %s\n",
 			     tag, n, cxt->fn[i-1]->name);
 
 	    cxt_dumped[n] = True;
@@ -197,41 +419,41 @@ static void print_mangled_fn(VgFile *fp, const HChar* tag,
 	
 	if ((last == cxt) && (rec_index == 0)) return;
 
-	VG_(fprintf)(fp, "%s=(%d) (%d)", tag,
+	out_printf(fp, "%s=(%d) (%d)", tag,
 			 cxt->base_number + rec_index,
 			 cxt->fn[0]->pure_cxt->base_number);
 	if (rec_index >0)
-	    VG_(fprintf)(fp, "'%d", rec_index +1);
+	    out_printf(fp, "'%d", rec_index +1);
 	for(i=1;i<cxt->size;i++)
-	    VG_(fprintf)(fp, "'(%d)", 
+	    out_printf(fp, "'(%d)", 
 			      cxt->fn[i]->pure_cxt->base_number);
-	VG_(fprintf)(fp, "\n");
+	out_printf(fp, "\n");
 
 	cxt_dumped[cxt->base_number+rec_index] = True;
 	return;
     }
 
 
-    VG_(fprintf)(fp, "%s=", tag);
+    out_printf(fp, "%s=", tag);
     if (CLG_(clo).compress_strings) {
 	CLG_ASSERT(cxt_dumped != 0);
 	if (cxt_dumped[cxt->base_number+rec_index]) {
-	    VG_(fprintf)(fp, "(%d)\n", cxt->base_number + rec_index);
+	    out_printf(fp, "(%d)\n", cxt->base_number + rec_index);
 	    return;
 	}
 	else {
-	    VG_(fprintf)(fp, "(%d) ", cxt->base_number + rec_index);
+	    out_printf(fp, "(%d) ", cxt->base_number + rec_index);
 	    cxt_dumped[cxt->base_number+rec_index] = True;
 	}
     }
 
-    VG_(fprintf)(fp, "%s", cxt->fn[0]->name);
+    out_printf(fp, "%s", cxt->fn[0]->name);
     if (rec_index >0)
-	VG_(fprintf)(fp, "'%d", rec_index +1);
+	out_printf(fp, "'%d", rec_index +1);
     for(i=1;i<cxt->size;i++)
-	VG_(fprintf)(fp, "'%s", cxt->fn[i]->name);
+	out_printf(fp, "'%s", cxt->fn[i]->name);
 
-    VG_(fprintf)(fp, "\n");
+    out_printf(fp, "\n");
 }
 
 
@@ -249,7 +471,7 @@ static Bool print_fn_pos(VgFile *fp, FnPos* last, BBCC* bbcc)
 
     if (!CLG_(clo).mangle_names) {
 	if (last->rec_index != bbcc->rec_index) {
-	    VG_(fprintf)(fp, "rec=%d\n\n", bbcc->rec_index);
+	    out_printf(fp, "rec=%d\n\n", bbcc->rec_index);
 	    last->rec_index = bbcc->rec_index;
 	    last->cxt = 0; 
 	    res = True;
@@ -263,7 +485,7 @@ static Bool print_fn_pos(VgFile *fp, FnPos* last, BBCC* bbcc)
 	    if (curr_from == 0) {
 		if (last_from != 0) {
 		    
-		    VG_(fprintf)(fp, "frfn=(spontaneous)\n");
+		    out_printf(fp, "frfn=(spontaneous)\n");
 		    res = True;
 		}
 	    }
@@ -418,7 +640,7 @@ static void fprint_apos(VgFile *fp, AddrPos* curr, AddrPos* last,
 
     if (CLG_(clo).dump_bbs) {
 	if (curr->line != last->line) {
-	    VG_(fprintf)(fp, "ln=%d\n", curr->line);
+	    out_printf(fp, "ln=%d\n", curr->line);
 	}
     }
 }
@@ -504,10 +726,19 @@ static void fprint_fcost(VgFile *fp, AddrCost* c, AddrPos* last)
     CLG_(print_cost)(-5, CLG_(sets).full, c->cost);
   }
     
-  fprint_pos(fp, &(c->p), last);
-  copy_apos( last, &(c->p) ); 
+  if (CLG_(clo).binary_dumps) {
+    bin_begin(BIN_COST);
+    bin_pos(&(c->p));
+    bin_cost(CLG_(dumpmap), c->cost);
+    bin_flush(fp);
+    copy_apos( last, &(c->p) );
+  }
+  else {
+    fprint_pos(fp, &(c->p), last);
+    copy_apos( last, &(c->p) ); 
 
-  fprint_cost(fp, CLG_(dumpmap), c->cost);
+    fprint_cost(fp, CLG_(dumpmap), c->cost);
+  }
 
   
   CLG_(add_and_zero_cost)( CLG_(sets).full, dump_total_cost, c->cost );
@@ -559,6 +790,24 @@ static void fprint_jcc(VgFile *fp, jCC* jcc, AddrPos* curr, AddrPos* last,
 		print_fn(fp, "jfn", jcc->to->cxt->fn[0]);
 	}
 	    
+	if (CLG_(clo).binary_dumps) {
+	    if (jcc->jmpkind == jk_CondJump) {
+		bin_begin(BIN_JCND);
+		bin_uint(jcc->call_counter);
+		bin_uint(ecounter);
+	    }
+	    else {
+		bin_begin(BIN_JUMP);
+		bin_uint(jcc->call_counter);
+	    }
+	    bin_pos(&target);
+	    bin_pos(curr);
+	    bin_flush(fp);
+
+	    jcc->call_counter = 0;
+	    return;
+	}
+
 	if (jcc->jmpkind == jk_CondJump) {
 	    
 	    VG_(fprintf)(fp, "jcnd=%llu/%llu ",
@@ -598,13 +847,23 @@ static void fprint_jcc(VgFile *fp, jCC* jcc, AddrPos* curr, AddrPos* last,
 	print_fn(fp, "cfn", jcc->to->cxt->fn[0]);
 
     if (!CLG_(is_zero_cost)( CLG_(sets).full, jcc->cost)) {
-        VG_(fprintf)(fp, "calls=%llu ", 
-		   jcc->call_counter);
+	if (CLG_(clo).binary_dumps) {
+	    bin_begin(BIN_CALLS);
+	    bin_uint(jcc->call_counter);
+	    bin_pos(&target);
+	    bin_pos(curr);
+	    bin_cost(CLG_(dumpmap), jcc->cost);
+	    bin_flush(fp);
+	}
+	else {
+	    VG_(fprintf)(fp, "calls=%llu ", 
+		       jcc->call_counter);
 
-	fprint_pos(fp, &target, last);
-        VG_(fprintf)(fp, "\n");
-	fprint_pos(fp, curr, last);
-	fprint_cost(fp, CLG_(dumpmap), jcc->cost);
+	    fprint_pos(fp, &target, last);
+	    VG_(fprintf)(fp, "\n");
+	    fprint_pos(fp, curr, last);
+	    fprint_cost(fp, CLG_(dumpmap), jcc->cost);
+	}
 
 	CLG_(init_cost)( CLG_(sets).full, jcc->cost );
 
@@ -758,7 +1017,7 @@ static Bool fprint_bbcc(VgFile *fp, BBCC* bbcc, AddrPos* last)
       fprint_apos(fp, &(currCost->p), last, bbcc->cxt->fn[0]->file);
       fprint_fcost(fp, currCost, last);
     }
-    if (CLG_(clo).dump_bbs) VG_(fprintf)(fp, "\n");
+    if (CLG_(clo).dump_bbs) out_printf(fp, "\n");
     
     /* when every cost was immediatly written, we must have done so,
      * as this function is only called when there's cost in a BBCC
@@ -1239,6 +1498,11 @@ static VgFile *new_dumpfile(int tid, const HChar* trigger)
 
    VG_(fprintf)(fp, "\n\n");
 
+   if (CLG_(clo).binary_dumps) {
+       VG_(fprintf)(fp, "binary: 1\n");
+       bin_reset();
+   }
+
    if (VG_(clo_verbosity) > 1)
        VG_(message)(Vg_DebugMsg, "Dump to %s\n", filename);
 
@@ -1250,6 +1514,11 @@ static void close_dumpfile(VgFile *fp)
 {
     if (fp == NULL) return;
 
+    if (CLG_(clo).binary_dumps) {
+	bin_begin(BIN_END);
+	bin_flush(fp);
+    }
+
     fprint_cost_ln(fp, "totals: ", CLG_(dumpmap),
 		   dump_total_cost);
     
@@ -1306,7 +1575,7 @@ static void print_bbccs_of_thread(thread_info* ti)
 	
 	print_file(print_fp, "fe=", lastFnPos.cxt->fn[0]->file);
       }
-      VG_(fprintf)(print_fp, "\n");
+      out_printf(print_fp, "\n");
     }
     
     if (*p == 0) break;
@@ -1324,14 +1593,14 @@ static void print_bbccs_of_thread(thread_info* ti)
 	
         int i;
 	ULong ecounter = (*p)->ecounter_sum;
-        VG_(fprintf)(print_fp, "bb=%#lx ", (*p)->bb->offset);
+        out_printf(print_fp, "bb=%#lx ", (*p)->bb->offset);
 	for(i = 0; i<(*p)->bb->cjmp_count;i++) {
-	    VG_(fprintf)(print_fp, "%d %llu ", 
+	    out_printf(print_fp, "%d %llu ", 
 				(*p)->bb->jmp[i].instr,
 				ecounter);
 	    ecounter -= (*p)->jmp[i].ecounter;
 	}
-	VG_(fprintf)(print_fp, "%d %llu\n", 
+	out_printf(print_fp, "%d %llu\n", 
 		     (*p)->bb->instr_count,
 		     ecounter);
     }
@@ -1352,32 +1621,142 @@ static void print_bbccs_of_thread(thread_info* ti)
 }
 
 
-static void print_bbccs(const HChar* trigger, Bool only_current_thread)
+static void zero_bbcc(BBCC* bbcc)
 {
-  init_dump_array();
-  init_debug_cache();
+  InstrInfo* instr_info;
+  ULong ecounter;
+  jCC* jcc;
+  Int instr, i, jmp;
+  BB* bb = bbcc->bb;
 
-  print_trigger = trigger;
+  ecounter = bbcc->ecounter_sum;
+  jmp = 0;
+  instr_info = &(bb->instr[0]);
+  for(instr=0; instr<bb->instr_count; instr++, instr_info++) {
+    (*CLG_(cachesim).add_icost)(dump_total_cost, bbcc, instr_info, ecounter);
+
+    if (jmp < bb->cjmp_count)
+	if (bb->jmp[jmp].instr == instr) {
+	    ecounter -= bbcc->jmp[jmp].ecounter;
+	    jmp++;
+	}
+  }
+
+  if (bbcc->skipped)
+    CLG_(add_and_zero_cost)( CLG_(sets).full,
+			    dump_total_cost, bbcc->skipped );
+
+  for(i=0; i<=bb->cjmp_count; i++) {
+    for(jcc=bbcc->jmp[i].jcc_list; jcc; jcc=jcc->next_from) {
+      if (jcc->jmpkind != jk_Call)
+	jcc->call_counter = 0;
+      else if (!CLG_(is_zero_cost)( CLG_(sets).full, jcc->cost )) {
+	CLG_(init_cost)( CLG_(sets).full, jcc->cost );
+	jcc->call_counter = 0;
+      }
+    }
+    bbcc->jmp[i].ecounter = 0;
+  }
+  bbcc->ecounter_sum = 0;
+  bbcc->ret_counter = 0;
+}
+
+/* Same effect on the cost centers as print_bbccs_of_thread(), without
+ * writing anything: used in the parent of a background dump.
+ */
+static void zero_bbccs_of_thread(thread_info* ti)
+{
+  BBCC **p, **array;
+
+  CLG_(init_cost_lz)( CLG_(sets).full, &dump_total_cost );
+
+  array = prepare_dump();
+  for(p = array; *p; p++)
+    zero_bbcc(*p);
+  VG_(free)(array);
+
+  CLG_(add_cost_lz)(CLG_(sets).full, 
+		    &CLG_(total_cost), dump_total_cost);
+  CLG_(copy_cost)( CLG_(sets).full, ti->lastdump_cost,
+		  CLG_(current_state).cost );
+}
 
+
+static void forall_dump_threads(void (*func)(thread_info*),
+				Bool only_current_thread)
+{
   if (!CLG_(clo).separate_threads) {
     
     Int orig_tid = CLG_(current_tid);
 
     CLG_(switch_thread)(1);
-    print_bbccs_of_thread( CLG_(get_current_thread)() );
+    (*func)( CLG_(get_current_thread)() );
     CLG_(switch_thread)(orig_tid);
   }
   else if (only_current_thread)
-    print_bbccs_of_thread( CLG_(get_current_thread)() );
+    (*func)( CLG_(get_current_thread)() );
   else
-    CLG_(forall_threads)(print_bbccs_of_thread);
+    CLG_(forall_threads)(func);
+}
+
+static void print_bbccs(const HChar* trigger, Bool only_current_thread)
+{
+  init_dump_array();
+  init_debug_cache();
+
+  print_trigger = trigger;
+
+  forall_dump_threads(print_bbccs_of_thread, only_current_thread);
 
   free_dump_array();
 }
 
 
+static Int dump_child = 0;
+
+static void wait_for_dump_child(void)
+{
+  Int status;
+
+  if (dump_child <= 0) return;
+
+  if (VG_(waitpid)(dump_child, &status, __VKI_WCLONE) != dump_child)
+    VG_(message)(Vg_DebugMsg, "Warning: Lost background dump process %d\n",
+		 dump_child);
+  else if (status != 0)
+    VG_(message)(Vg_UserMsg, "Error: Background dump failed (status %d)\n",
+		 status);
+  dump_child = 0;
+}
+
+/* Writes the dump from a copy-on-write child process, so that the
+ * client only waits for the fork and for zeroing the cost centers.
+ * Returns False if no child could be created.
+ */
+static Bool print_bbccs_in_background(const HChar* trigger,
+				      Bool only_current_thread)
+{
+  Int pid;
+
+  pid = VG_(fork_nosigchld)();
+  if (pid < 0) return False;
+
+  if (pid == 0) {
+    print_bbccs(trigger, only_current_thread);
+    VG_(exit_now)(0);
+  }
+
+  dump_child = pid;
+  forall_dump_threads(zero_bbccs_of_thread, only_current_thread);
+
+  return True;
+}
+
+
 void CLG_(dump_profile)(const HChar* trigger, Bool only_current_thread)
 {
+   UInt start_ms = VG_(read_millisecond_timer)();
+
    CLG_DEBUG(2, "+ dump_profile(Trigger '%s')\n",
 	    trigger ? trigger : "Prg.Term.");
 
@@ -1388,14 +1767,19 @@ void CLG_(dump_profile)(const HChar* trigger, Bool only_current_thread)
 		    CLG_(stat).bb_executions,
 		    trigger ? trigger : "Prg.Term.");
 
+   wait_for_dump_child();
+
    out_counter++;
 
-   print_bbccs(trigger, only_current_thread);
+   if (!trigger || !CLG_(clo).background_dumps ||
+       !print_bbccs_in_background(trigger, only_current_thread))
+     print_bbccs(trigger, only_current_thread);
 
    bbs_done = CLG_(stat).bb_executions++;
 
    if (VG_(clo_verbosity) > 1)
-     VG_(message)(Vg_DebugMsg, "Dumping done.\n");
+     VG_(message)(Vg_DebugMsg, "Dumping done (%u ms).\n",
+		  VG_(read_millisecond_timer)() - start_ms);
 }
 
 static
@@ -1459,6 +1843,7 @@ void CLG_(init_dumps)()
        return;
    }
    thisPID = currentPID;
+   dump_child = 0;
    
    if (!CLG_(clo).out_format)
      CLG_(clo).out_format = DEFAULT_OUTFORMAT;
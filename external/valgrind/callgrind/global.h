@@ -65,6 +65,8 @@ struct _CommandLineOptions {
   
   const HChar* out_format;  
   Bool combine_dumps;       
+  Bool binary_dumps;
+  Bool background_dumps;
   Bool compress_strings;
   Bool compress_events;
   Bool compress_pos;
@@ -156,6 +156,10 @@ static void free_DebugInfo ( DebugInfo* di )
    if (di->fsm.filename) ML_(dinfo_free)(di->fsm.filename);
    if (di->fsm.dbgname)  ML_(dinfo_free)(di->fsm.dbgname);
    if (di->soname)       ML_(dinfo_free)(di->soname);
+   if (di->buildid)      ML_(dinfo_free)(di->buildid);
+#  if defined(VGO_linux)
+   if (di->lazy_dwarf)   ML_(free_lazy_dwarf)(di);
+#  endif
    if (di->loctab)       ML_(dinfo_free)(di->loctab);
    if (di->loctab_fndn_ix) ML_(dinfo_free)(di->loctab_fndn_ix);
    if (di->inltab)       ML_(dinfo_free)(di->inltab);
@@ -229,6 +233,23 @@ static void free_DebugInfo ( DebugInfo* di )
 }
 
 
+static void read_lazy_lines ( DebugInfo* di, Addr ptr )
+{
+#  if defined(VGO_linux)
+   if (di->lazy_dwarf)
+      ML_(read_lazy_dwarf_lines) ( di, ptr );
+#  endif
+}
+
+static void read_lazy_vars ( DebugInfo* di )
+{
+#  if defined(VGO_linux)
+   if (di->lazy_dwarf)
+      ML_(read_lazy_dwarf_vars) ( di );
+#  endif
+}
+
+
 static void discard_DebugInfo ( DebugInfo* di )
 {
    const HChar* reason = "munmap";
@@ -1243,6 +1264,8 @@ InlIPCursor* VG_(new_IIPC)(Addr eip)
 
    
    search_all_loctabs ( eip, &di, &locno );
+   if (di != NULL)
+      read_lazy_vars ( di );
    if (di == NULL || di->inltab_used == 0)
       return NULL; 
 
@@ -1351,6 +1374,7 @@ static void search_all_loctabs ( Addr ptr, DebugInfo** pdi,
           && di->text_size > 0
           && di->text_avma <= ptr 
           && ptr < di->text_avma + di->text_size) {
+         read_lazy_lines ( di, ptr );
          lno = ML_(search_one_loctab) ( di, ptr );
          if (lno == -1) goto not_found;
          *locno = lno;
@@ -2900,7 +2924,7 @@ Bool consider_vars_in_frame ( XArray*  dname1,
    }
    
 
-   
+   read_lazy_vars ( di );
    if (!di->varinfo)
       return False;
 
@@ -3004,6 +3028,7 @@ Bool VG_(get_data_description)(
       if (!di->text_present || di->text_size == 0)
          continue;
       
+      read_lazy_vars ( di );
       if (!di->varinfo)
          continue;
       
@@ -3259,7 +3284,7 @@ void*
    }
    
 
-   
+   read_lazy_vars ( di );
    if (!di->varinfo)
       return res; 
 
@@ -3327,7 +3352,7 @@ void*
    gvars = VG_(newXA)( ML_(dinfo_zalloc), "di.debuginfo.dggbfd.1",
                        ML_(dinfo_free), sizeof(GlobalBlock) );
 
-   
+   read_lazy_vars ( di );
    if (!di->varinfo)
       return gvars;
 
@@ -3477,6 +3502,11 @@ const HChar* VG_(DebugInfo_get_soname)(const DebugInfo* di)
    return di->soname;
 }
 
+const HChar* VG_(DebugInfo_get_buildid)(const DebugInfo* di)
+{
+   return di->buildid;
+}
+
 const HChar* VG_(DebugInfo_get_filename)(const DebugInfo* di)
 {
    return di->fsm.filename;
@@ -48,6 +48,8 @@ void ML_(img_done)(DiImage*);
 
 DiOffT ML_(img_size)(const DiImage* img);
 
+const HChar* ML_(img_local_path)(const DiImage* img);
+
 Bool ML_(img_valid)(const DiImage* img, DiOffT offset, SizeT size);
 
 void ML_(img_get)(void* dst,
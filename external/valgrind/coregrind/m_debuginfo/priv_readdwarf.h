@@ -30,6 +30,7 @@
 
 #include "pub_core_debuginfo.h"   
 #include "priv_image.h"           
+#include "pub_core_xarray.h"
 
 
 
@@ -43,6 +44,43 @@ void ML_(read_debuginfo_dwarf3)
           DiSlice escn_debug_str,       
           DiSlice escn_debug_str_alt ); 
 
+typedef
+   struct {
+      ULong offset;
+      Bool  indexed;
+      Bool  loaded;
+   }
+   DiUnit;
+
+typedef
+   struct {
+      Addr  aMin;
+      Addr  aMax;
+      UWord unit;
+   }
+   DiUnitRange;
+
+extern
+void ML_(index_debuginfo_dwarf3)
+        ( DebugInfo* di,
+          DiSlice escn_debug_info,
+          DiSlice escn_debug_abbv,
+          DiSlice escn_debug_str,
+          DiSlice escn_debug_str_alt,
+          DiSlice escn_debug_ranges,
+          XArray* units,
+          XArray* ranges );
+
+extern
+void ML_(read_debuginfo_dwarf3_unit)
+        ( DebugInfo* di,
+          DiSlice escn_debug_info,
+          DiSlice escn_debug_abbv,
+          DiSlice escn_debug_line,
+          DiSlice escn_debug_str,
+          DiSlice escn_debug_str_alt,
+          ULong   unit_offset );
+
 extern
 void ML_(read_debuginfo_dwarf1) ( DebugInfo* di,
                                   UChar* dwarf1d, Int dwarf1d_sz,
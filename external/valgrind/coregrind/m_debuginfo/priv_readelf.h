@@ -37,6 +37,12 @@ extern Bool ML_(is_elf_object_file)( const void* image, SizeT n_image,
 
 extern Bool ML_(read_elf_debug_info) ( DebugInfo* di );
 
+extern void ML_(read_lazy_dwarf_lines) ( DebugInfo* di, Addr avma );
+
+extern void ML_(read_lazy_dwarf_vars) ( DebugInfo* di );
+
+extern void ML_(free_lazy_dwarf) ( DebugInfo* di );
+
 
 #endif 
 
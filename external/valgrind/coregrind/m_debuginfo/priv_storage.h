@@ -423,6 +423,9 @@ struct _DebugInfo {
    HChar* soname;
 
    
+   HChar* buildid;
+
+   
    Bool     text_present;
    Addr     text_avma;
    Addr     text_svma;
@@ -544,6 +547,8 @@ struct _DebugInfo {
 
    XArray* varinfo;
 
+   struct _DiLazyDwarf* lazy_dwarf;
+
 
    XArray*  admin_tyents;
 
@@ -604,6 +609,8 @@ extern void ML_(addVar)( struct _DebugInfo* di,
 
 extern void ML_(canonicaliseTables) ( struct _DebugInfo* di );
 
+extern void ML_(canonicaliseLazyTables) ( struct _DebugInfo* di );
+
 extern void ML_(canonicaliseCFI) ( struct _DebugInfo* di );
 
 extern void ML_(finish_CFSI_arrays) ( struct _DebugInfo* di );
@@ -81,6 +81,13 @@ typedef struct
   DiCursor name;     
   ULong    stmt_list; 
   Bool     dw64;      
+  UChar    addr_size;
+  ULong    low_pc;
+  ULong    high_pc;
+  ULong    ranges;
+  Bool     have_low_pc;
+  Bool     have_high_pc;
+  Bool     high_pc_is_offset;
 } 
 UnitInfo;
 
@@ -711,6 +718,7 @@ void read_unitinfo_dwarf2( UnitInfo* ui,
 
    VG_(memset)( ui, 0, sizeof( UnitInfo ) );
    ui->stmt_list = -1LL;
+   ui->ranges = -1LL;
    
    
 
@@ -726,6 +734,7 @@ void read_unitinfo_dwarf2( UnitInfo* ui,
 
    
    addr_size = ML_(cur_step_UChar)(&p);
+   ui->addr_size = addr_size;
 
    
    end_img = ML_(cur_plus)(unitblock_img, blklen + (ui->dw64 ? 12 : 4)); 
@@ -797,12 +806,19 @@ void read_unitinfo_dwarf2( UnitInfo* ui,
                };
                break;
             case 0x07: 
-               if (ui->dw64) cval = ML_(cur_read_ULong)(p);
+               /* DW_FORM_data8 is 8 bytes whatever the DWARF format; it
+                  is read for 32-bit DWARF too, as DWARF 4 uses it for
+                  DW_AT_high_pc offsets. */
+               cval = ML_(cur_read_ULong)(p);
                p = ML_(cur_plus)(p, 8);
                
                break;
             
             case 0x01: 
+               if (addr_size == 8)
+                  cval = ML_(cur_read_ULong)(p);
+               else if (addr_size == 4)
+                  cval = ML_(cur_read_UInt)(p);
                p = ML_(cur_plus)(p, addr_size);
                break;
             case 0x03: 
@@ -877,6 +893,16 @@ void read_unitinfo_dwarf2( UnitInfo* ui,
                  if ( name == 0x03 ) ui->name = sval;      
             else if ( name == 0x1b ) ui->compdir = sval;   
             else if ( name == 0x10 ) ui->stmt_list = cval; 
+            else if ( name == 0x11 && form == 0x01 ) {
+               ui->low_pc = cval;
+               ui->have_low_pc = True;
+            }
+            else if ( name == 0x12 && cval != -1LL ) {
+               ui->high_pc = cval;
+               ui->have_high_pc = True;
+               ui->high_pc_is_offset = form != 0x01;
+            }
+            else if ( name == 0x55 ) ui->ranges = cval;
          }
       }
    } 
@@ -884,14 +910,17 @@ void read_unitinfo_dwarf2( UnitInfo* ui,
 
 
 
-void ML_(read_debuginfo_dwarf3)
-        ( struct _DebugInfo* di,
-          DiSlice escn_debug_info,      
-          DiSlice escn_debug_types,     
-          DiSlice escn_debug_abbv,      
-          DiSlice escn_debug_line,      
-          DiSlice escn_debug_str,       
-          DiSlice escn_debug_str_alt )  
+static
+void walk_units_dwarf3 ( struct _DebugInfo* di,
+                         DiSlice escn_debug_info,
+                         DiSlice escn_debug_abbv,
+                         DiSlice escn_debug_str,
+                         DiSlice escn_debug_str_alt,
+                         void (*fn)( struct _DebugInfo* di,
+                                     const UnitInfo* ui,
+                                     ULong unit_offset,
+                                     void* opaque ),
+                         void* opaque )
 {
    UnitInfo ui;
    UShort   ver;
@@ -956,23 +985,171 @@ void ML_(read_debuginfo_dwarf3)
       
       if ( ui.stmt_list == -1LL )
          continue;
-      
-      if (0) {
-         HChar* str_name = ML_(cur_read_strdup)(ui.name, "di.rdd3.3");
-         VG_(printf)("debug_line_sz %lld, ui.stmt_list %lld  %s\n",
-                     escn_debug_line.szB, ui.stmt_list, str_name );
-         ML_(dinfo_free)(str_name);
-      }
 
-      
-      read_dwarf2_lineblock(
-         di, &ui,
-         ML_(cur_plus)(ML_(cur_from_sli)(escn_debug_line), ui.stmt_list),
-         escn_debug_line.szB  - ui.stmt_list
-      );
+      fn( di, &ui,
+          ML_(cur_minus)(block_img, ML_(cur_from_sli)(escn_debug_info)),
+          opaque );
    }
 }
 
+static
+void read_unit_lines ( struct _DebugInfo* di, const UnitInfo* ui,
+                       ULong unit_offset, void* opaque )
+{
+   const DiSlice* escn_debug_line = opaque;
+
+   /* A stmt_list beyond .debug_line (a damaged object) would make
+      read_dwarf2_lineblock read past the section, lazily or not. */
+   if (ui->stmt_list >= escn_debug_line->szB) {
+      ML_(symerr)( di, True, "Unit line info beyond .debug_line; ignoring" );
+      return;
+   }
+   if (0) {
+      HChar* str_name = ML_(cur_read_strdup)(ui->name, "di.rdd3.3");
+      VG_(printf)("debug_line_sz %lld, ui.stmt_list %lld  %s\n",
+                  escn_debug_line->szB, ui->stmt_list, str_name );
+      ML_(dinfo_free)(str_name);
+   }
+
+   
+   read_dwarf2_lineblock(
+      di, ui,
+      ML_(cur_plus)(ML_(cur_from_sli)(*escn_debug_line), ui->stmt_list),
+      escn_debug_line->szB  - ui->stmt_list
+   );
+}
+
+void ML_(read_debuginfo_dwarf3)
+        ( struct _DebugInfo* di,
+          DiSlice escn_debug_info,      
+          DiSlice escn_debug_types,     
+          DiSlice escn_debug_abbv,      
+          DiSlice escn_debug_line,      
+          DiSlice escn_debug_str,       
+          DiSlice escn_debug_str_alt )  
+{
+   walk_units_dwarf3( di, escn_debug_info, escn_debug_abbv,
+                      escn_debug_str, escn_debug_str_alt,
+                      read_unit_lines, &escn_debug_line );
+}
+
+void ML_(read_debuginfo_dwarf3_unit)
+        ( struct _DebugInfo* di,
+          DiSlice escn_debug_info,
+          DiSlice escn_debug_abbv,
+          DiSlice escn_debug_line,
+          DiSlice escn_debug_str,
+          DiSlice escn_debug_str_alt,
+          ULong   unit_offset )
+{
+   UnitInfo ui;
+   Bool     is64;
+   ULong    blklen;
+
+   if (unit_offset + 4 > escn_debug_info.szB)
+      return;
+   blklen = read_initial_length_field(
+               ML_(cur_plus)(ML_(cur_from_sli)(escn_debug_info), unit_offset),
+               &is64 );
+   if (unit_offset + blklen + (is64 ? 12 : 4) > escn_debug_info.szB)
+      return;
+
+   read_unitinfo_dwarf2( &ui,
+                         ML_(cur_plus)(ML_(cur_from_sli)(escn_debug_info),
+                                       unit_offset),
+                         ML_(cur_from_sli)(escn_debug_abbv),
+                         ML_(cur_from_sli)(escn_debug_str),
+                         ML_(cur_from_sli)(escn_debug_str_alt) );
+   if (ui.stmt_list != -1LL)
+      read_unit_lines( di, &ui, unit_offset, &escn_debug_line );
+}
+
+typedef
+   struct {
+      DiSlice escn_debug_ranges;
+      XArray* units;
+      XArray* ranges;
+   }
+   UnitIndex;
+
+static void add_unit_range ( UnitIndex* ix, ULong aMin, ULong aMax,
+                             UWord unit )
+{
+   DiUnitRange r;
+   if (aMin > aMax || aMax == 0)
+      return;
+   r.aMin = aMin;
+   r.aMax = aMax;
+   r.unit = unit;
+   VG_(addToXA)( ix->ranges, &r );
+}
+
+static
+void index_unit ( struct _DebugInfo* di, const UnitInfo* ui,
+                  ULong unit_offset, void* opaque )
+{
+   UnitIndex* ix     = opaque;
+   UWord      n      = VG_(sizeXA)( ix->ranges );
+   UWord      unit;
+   DiUnit     u;
+
+   u.offset  = unit_offset;
+   u.indexed = False;
+   u.loaded  = False;
+   unit = VG_(addToXA)( ix->units, &u );
+
+   if (ui->ranges != -1LL && ML_(sli_is_valid)(ix->escn_debug_ranges)
+       && (ui->addr_size == 4 || ui->addr_size == 8)) {
+      ULong    base = ui->have_low_pc ? ui->low_pc : 0;
+      ULong    max  = ui->addr_size == 8 ? ~0ULL : 0xFFFFFFFFULL;
+      DiOffT   off  = ui->ranges;
+      while (off + 2 * ui->addr_size <= ix->escn_debug_ranges.szB) {
+         DiCursor c = ML_(cur_plus)(ML_(cur_from_sli)(ix->escn_debug_ranges),
+                                    off);
+         ULong lo = ui->addr_size == 8 ? ML_(cur_step_ULong)(&c)
+                                       : ML_(cur_step_UInt)(&c);
+         ULong hi = ui->addr_size == 8 ? ML_(cur_step_ULong)(&c)
+                                       : ML_(cur_step_UInt)(&c);
+         off += 2 * ui->addr_size;
+         if (lo == 0 && hi == 0)
+            break;
+         if (lo == max) {
+            base = hi;
+            continue;
+         }
+         if (lo < hi)
+            add_unit_range( ix, base + lo, base + hi - 1, unit );
+      }
+   } else if (ui->have_low_pc && ui->have_high_pc) {
+      ULong hi = ui->high_pc_is_offset ? ui->low_pc + ui->high_pc
+                                       : ui->high_pc;
+      if (ui->low_pc < hi)
+         add_unit_range( ix, ui->low_pc, hi - 1, unit );
+   }
+
+   if (VG_(sizeXA)( ix->ranges ) > n)
+      ((DiUnit*)VG_(indexXA)( ix->units, unit ))->indexed = True;
+}
+
+void ML_(index_debuginfo_dwarf3)
+        ( struct _DebugInfo* di,
+          DiSlice escn_debug_info,
+          DiSlice escn_debug_abbv,
+          DiSlice escn_debug_str,
+          DiSlice escn_debug_str_alt,
+          DiSlice escn_debug_ranges,
+          XArray* units,
+          XArray* ranges )
+{
+   UnitIndex ix;
+   ix.escn_debug_ranges = escn_debug_ranges;
+   ix.units             = units;
+   ix.ranges            = ranges;
+   walk_units_dwarf3( di, escn_debug_info, escn_debug_abbv,
+                      escn_debug_str, escn_debug_str_alt,
+                      index_unit, &ix );
+}
+
 
 
 
@@ -1216,6 +1216,270 @@ Word file_offset_from_svma ( Bool* ok,
 
 
 
+enum {
+   LZ_INFO, LZ_TYPES, LZ_ABBV, LZ_LINE, LZ_STR, LZ_RANGES, LZ_LOC,
+   LZ_INFO_ALT, LZ_ABBV_ALT, LZ_LINE_ALT, LZ_STR_ALT,
+   LZ_N_SLICES
+};
+
+typedef
+   struct {
+      Int    img;
+      DiOffT ioff;
+      DiOffT szB;
+   }
+   DiLazySlice;
+
+struct _DiLazyDwarf {
+   HChar*      img_path[3];
+   DiOffT      img_size[3];
+   DiLazySlice escn[LZ_N_SLICES];
+   XArray*     units;
+   XArray*     ranges;
+   Addr        max_range_szB;
+   UWord       n_units_pending;
+   Bool        vars_pending;
+};
+
+static Int cmp_DiUnitRange ( const void* va, const void* vb )
+{
+   const DiUnitRange* a = va;
+   const DiUnitRange* b = vb;
+   if (a->aMin < b->aMin) return -1;
+   if (a->aMin > b->aMin) return  1;
+   return 0;
+}
+
+void ML_(free_lazy_dwarf) ( struct _DebugInfo* di )
+{
+   struct _DiLazyDwarf* lz = di->lazy_dwarf;
+   Int i;
+   if (lz == NULL)
+      return;
+   for (i = 0; i < 3; i++)
+      if (lz->img_path[i])
+         ML_(dinfo_free)(lz->img_path[i]);
+   VG_(deleteXA)(lz->units);
+   VG_(deleteXA)(lz->ranges);
+   ML_(dinfo_free)(lz);
+   di->lazy_dwarf = NULL;
+}
+
+static Bool lazy_open ( const struct _DiLazyDwarf* lz,
+                        DiImage* imgs[3], DiSlice escn[LZ_N_SLICES] )
+{
+   Int i;
+   for (i = 0; i < 3; i++) {
+      imgs[i] = NULL;
+      if (lz->img_path[i] == NULL)
+         continue;
+      imgs[i] = ML_(img_from_local_file)(lz->img_path[i]);
+      if (imgs[i] == NULL || ML_(img_size)(imgs[i]) != lz->img_size[i]) {
+         for (; i >= 0; i--)
+            if (imgs[i])
+               ML_(img_done)(imgs[i]);
+         return False;
+      }
+   }
+   for (i = 0; i < LZ_N_SLICES; i++) {
+      if (lz->escn[i].img < 0)
+         escn[i] = DiSlice_INVALID;
+      else
+         escn[i] = mk_DiSlice(imgs[lz->escn[i].img],
+                              lz->escn[i].ioff, lz->escn[i].szB);
+   }
+   return True;
+}
+
+static void lazy_close ( DiImage* imgs[3] )
+{
+   Int i;
+   for (i = 0; i < 3; i++)
+      if (imgs[i])
+         ML_(img_done)(imgs[i]);
+}
+
+static void lazy_finish ( struct _DebugInfo* di )
+{
+   struct _DiLazyDwarf* lz = di->lazy_dwarf;
+   if (lz->n_units_pending == 0 && !lz->vars_pending)
+      ML_(free_lazy_dwarf)(di);
+   ML_(canonicaliseLazyTables)(di);
+}
+
+static void lazy_give_up ( struct _DebugInfo* di )
+{
+   struct _DiLazyDwarf* lz = di->lazy_dwarf;
+   if (VG_(clo_verbosity) > 1)
+      VG_(message)(Vg_DebugMsg, "Warning: cannot reopen debuginfo for %s; "
+                   "line and variable info will be missing\n",
+                   di->fsm.filename);
+   lz->n_units_pending = 0;
+   lz->vars_pending = False;
+   lazy_finish(di);
+}
+
+static
+Bool setup_lazy_dwarf ( struct _DebugInfo* di,
+                        DiImage* mimg, DiImage* dimg, DiImage* aimg,
+                        DiSlice escn[LZ_N_SLICES] )
+{
+   struct _DiLazyDwarf* lz;
+   DiImage* imgs[3];
+   Word     i, j, n;
+
+   imgs[0] = mimg;
+   imgs[1] = dimg;
+   imgs[2] = aimg;
+
+   lz = ML_(dinfo_zalloc)("di.readelf.sld.1", sizeof(*lz));
+   for (i = 0; i < LZ_N_SLICES; i++) {
+      lz->escn[i].img = -1;
+      if (!ML_(sli_is_valid)(escn[i]))
+         continue;
+      for (j = 0; j < 3; j++)
+         if (escn[i].img == imgs[j])
+            break;
+      vg_assert(j < 3);
+      if (lz->img_path[j] == NULL) {
+         const HChar* path = ML_(img_local_path)(imgs[j]);
+         if (path == NULL) {
+            di->lazy_dwarf = lz;
+            ML_(free_lazy_dwarf)(di);
+            return False;
+         }
+         lz->img_path[j] = ML_(dinfo_strdup)("di.readelf.sld.2", path);
+         lz->img_size[j] = ML_(img_size)(imgs[j]);
+      }
+      lz->escn[i].img  = j;
+      lz->escn[i].ioff = escn[i].ioff;
+      lz->escn[i].szB  = escn[i].szB;
+   }
+
+   lz->units  = VG_(newXA)(ML_(dinfo_zalloc), "di.readelf.sld.3",
+                           ML_(dinfo_free), sizeof(DiUnit));
+   lz->ranges = VG_(newXA)(ML_(dinfo_zalloc), "di.readelf.sld.4",
+                           ML_(dinfo_free), sizeof(DiUnitRange));
+   ML_(index_debuginfo_dwarf3)( di, escn[LZ_INFO], escn[LZ_ABBV],
+                                escn[LZ_STR], escn[LZ_STR_ALT],
+                                escn[LZ_RANGES], lz->units, lz->ranges );
+   VG_(setCmpFnXA)(lz->ranges, cmp_DiUnitRange);
+   VG_(sortXA)(lz->ranges);
+
+   n = VG_(sizeXA)(lz->ranges);
+   for (i = 0; i < n; i++) {
+      DiUnitRange* r = VG_(indexXA)(lz->ranges, i);
+      if (r->aMax - r->aMin > lz->max_range_szB)
+         lz->max_range_szB = r->aMax - r->aMin;
+   }
+
+   n = VG_(sizeXA)(lz->units);
+   for (i = 0; i < n; i++) {
+      DiUnit* u = VG_(indexXA)(lz->units, i);
+      if (u->indexed) {
+         lz->n_units_pending++;
+         continue;
+      }
+      ML_(read_debuginfo_dwarf3_unit)( di, escn[LZ_INFO], escn[LZ_ABBV],
+                                       escn[LZ_LINE], escn[LZ_STR],
+                                       escn[LZ_STR_ALT], u->offset );
+      u->loaded = True;
+   }
+
+   lz->vars_pending = VG_(clo_read_var_info) || VG_(clo_read_inline_info);
+
+   TRACE_SYMTAB("lazy dwarf: %lu units, %lu indexed, %lu ranges\n",
+                (UWord)n, lz->n_units_pending,
+                (UWord)VG_(sizeXA)(lz->ranges));
+
+   di->lazy_dwarf = lz;
+   if (lz->n_units_pending == 0 && !lz->vars_pending)
+      ML_(free_lazy_dwarf)(di);
+   return True;
+}
+
+void ML_(read_lazy_dwarf_lines) ( struct _DebugInfo* di, Addr avma )
+{
+   struct _DiLazyDwarf* lz = di->lazy_dwarf;
+   DiImage* imgs[3];
+   DiSlice  escn[LZ_N_SLICES];
+   Addr     svma;
+   Word     lo, hi, mid, i;
+   Bool     opened = False;
+
+   if (lz == NULL || lz->n_units_pending == 0)
+      return;
+
+   svma = avma - di->text_debug_bias;
+
+   lo = 0;
+   hi = VG_(sizeXA)(lz->ranges);
+   while (lo < hi) {
+      mid = (lo + hi) / 2;
+      if (((DiUnitRange*)VG_(indexXA)(lz->ranges, mid))->aMin <= svma)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+
+   for (i = lo - 1; i >= 0; i--) {
+      DiUnitRange* r = VG_(indexXA)(lz->ranges, i);
+      DiUnit*      u;
+      if (svma - r->aMin > lz->max_range_szB)
+         break;
+      if (svma > r->aMax)
+         continue;
+      u = VG_(indexXA)(lz->units, r->unit);
+      if (u->loaded)
+         continue;
+      if (!opened) {
+         if (!lazy_open(lz, imgs, escn)) {
+            lazy_give_up(di);
+            return;
+         }
+         opened = True;
+      }
+      ML_(read_debuginfo_dwarf3_unit)( di, escn[LZ_INFO], escn[LZ_ABBV],
+                                       escn[LZ_LINE], escn[LZ_STR],
+                                       escn[LZ_STR_ALT], u->offset );
+      u->loaded = True;
+      lz->n_units_pending--;
+   }
+
+   if (opened) {
+      lazy_close(imgs);
+      lazy_finish(di);
+   }
+}
+
+void ML_(read_lazy_dwarf_vars) ( struct _DebugInfo* di )
+{
+   struct _DiLazyDwarf* lz = di->lazy_dwarf;
+   DiImage* imgs[3];
+   DiSlice  escn[LZ_N_SLICES];
+
+   if (lz == NULL || !lz->vars_pending)
+      return;
+
+   if (!lazy_open(lz, imgs, escn)) {
+      lazy_give_up(di);
+      return;
+   }
+   lz->vars_pending = False;
+   ML_(new_dwarf3_reader)(
+      di, escn[LZ_INFO],     escn[LZ_TYPES],
+          escn[LZ_ABBV],     escn[LZ_LINE],
+          escn[LZ_STR],      escn[LZ_RANGES],
+          escn[LZ_LOC],      escn[LZ_INFO_ALT],
+          escn[LZ_ABBV_ALT], escn[LZ_LINE_ALT],
+          escn[LZ_STR_ALT]
+   );
+   lazy_close(imgs);
+   lazy_finish(di);
+}
+
+
+
 Bool ML_(read_elf_debug_info) ( struct _DebugInfo* di )
 {
 
@@ -2141,7 +2405,10 @@ Bool ML_(read_elf_debug_info) ( struct _DebugInfo* di )
       }
 
       if (buildid) {
-         ML_(dinfo_free)(buildid);
+         if (di->buildid == NULL)
+            di->buildid = buildid;
+         else
+            ML_(dinfo_free)(buildid);
          buildid = NULL; 
       }
 
@@ -2518,16 +2785,35 @@ Bool ML_(read_elf_debug_info) ( struct _DebugInfo* di )
       if (ML_(sli_is_valid)(debug_info_escn) 
           && ML_(sli_is_valid)(debug_abbv_escn)
           && ML_(sli_is_valid)(debug_line_escn)) {
+         DiSlice lazy_escn[LZ_N_SLICES];
+         Bool    lazy;
+         lazy_escn[LZ_INFO]     = debug_info_escn;
+         lazy_escn[LZ_TYPES]    = debug_types_escn;
+         lazy_escn[LZ_ABBV]     = debug_abbv_escn;
+         lazy_escn[LZ_LINE]     = debug_line_escn;
+         lazy_escn[LZ_STR]      = debug_str_escn;
+         lazy_escn[LZ_RANGES]   = debug_ranges_escn;
+         lazy_escn[LZ_LOC]      = debug_loc_escn;
+         lazy_escn[LZ_INFO_ALT] = debug_info_alt_escn;
+         lazy_escn[LZ_ABBV_ALT] = debug_abbv_alt_escn;
+         lazy_escn[LZ_LINE_ALT] = debug_line_alt_escn;
+         lazy_escn[LZ_STR_ALT]  = debug_str_alt_escn;
+         lazy = VG_(clo_lazy_debuginfo)
+                && !di->trace_symtab && !di->ddump_line
+                && setup_lazy_dwarf(di, mimg, dimg, aimg, lazy_escn);
+
          
-         ML_(read_debuginfo_dwarf3) ( di,
-                                      debug_info_escn,
-                                      debug_types_escn,
-                                      debug_abbv_escn,
-                                      debug_line_escn,
-                                      debug_str_escn,
-                                      debug_str_alt_escn );
-         if (VG_(clo_read_var_info) 
-             || VG_(clo_read_inline_info)) {
+         if (!lazy)
+            ML_(read_debuginfo_dwarf3) ( di,
+                                         debug_info_escn,
+                                         debug_types_escn,
+                                         debug_abbv_escn,
+                                         debug_line_escn,
+                                         debug_str_escn,
+                                         debug_str_alt_escn );
+         if (!lazy
+             && (VG_(clo_read_var_info) 
+                 || VG_(clo_read_inline_info))) {
             ML_(new_dwarf3_reader)(
                di, debug_info_escn,     debug_types_escn,
                    debug_abbv_escn,     debug_line_escn,
@@ -2013,6 +2013,21 @@ void ML_(canonicaliseTables) ( struct _DebugInfo* di )
    if (di->cfsi_m_pool)
       VG_(freezeDedupPA) (di->cfsi_m_pool, ML_(dinfo_shrink_block));
    canonicaliseVarInfo ( di );
+   if (di->lazy_dwarf)
+      return;
+   if (di->strpool)
+      VG_(freezeDedupPA) (di->strpool, ML_(dinfo_shrink_block));
+   if (di->fndnpool)
+      VG_(freezeDedupPA) (di->fndnpool, ML_(dinfo_shrink_block));
+}
+
+void ML_(canonicaliseLazyTables) ( struct _DebugInfo* di )
+{
+   canonicaliseLoctab ( di );
+   canonicaliseInltab ( di );
+   canonicaliseVarInfo ( di );
+   if (di->lazy_dwarf)
+      return;
    if (di->strpool)
       VG_(freezeDedupPA) (di->strpool, ML_(dinfo_shrink_block));
    if (di->fndnpool)
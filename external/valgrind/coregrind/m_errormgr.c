@@ -34,6 +34,7 @@
 #include "pub_core_errormgr.h"
 #include "pub_core_execontext.h"
 #include "pub_core_gdbserver.h"
+#include "pub_core_hashtable.h"
 #include "pub_core_libcbase.h"
 #include "pub_core_libcassert.h"
 #include "pub_core_libcfile.h"
@@ -60,6 +61,8 @@ static Error* errors = NULL;
 
 static Supp* suppressions = NULL;
 
+static UInt supp_stamp = 0;
+
 static UInt n_errs_found = 0;
 
 static UInt n_errs_suppressed = 0;
@@ -73,6 +76,8 @@ static UInt n_supp_contexts = 0;
 
 static Supp* is_suppressible_error ( const Error* err );
 
+static void build_supp_trie ( void );
+
 static ThreadId last_tid_printed = 1;
 
 static UWord em_errlist_searches = 0;
@@ -83,6 +88,8 @@ static UWord em_supplist_searches = 0;
 
 static UWord em_supplist_cmps = 0;
 
+static UWord em_suppcache_hits = 0;
+
 
 struct _Error {
    struct _Error* next;
@@ -188,6 +195,9 @@ struct _Supp {
    SuppKind skind;   
    HChar* string;    
    void* extra;      
+
+   UInt stamp;
+   UInt search_mark;
 };
 
 SuppKind VG_(get_supp_kind) ( const Supp* su )
@@ -745,18 +755,39 @@ Bool VG_(unique_error) ( ThreadId tid, ErrorKind ekind, Addr a, const HChar* s,
 
 
 
+static Int cmp_Supp_by_stamp ( const void* v1, const void* v2 )
+{
+   const Supp* su1 = *(const Supp* const*)v1;
+   const Supp* su2 = *(const Supp* const*)v2;
+   if (su1->stamp > su2->stamp) return -1;
+   if (su1->stamp < su2->stamp) return 1;
+   return 0;
+}
+
 static Bool show_used_suppressions ( void )
 {
    Supp  *su;
+   Supp  **used;
+   UInt  n_used, i;
    Bool  any_supp;
 
    if (VG_(clo_xml))
       VG_(printf_xml)("<suppcounts>\n");
 
+   n_used = 0;
+   for (su = suppressions; su != NULL; su = su->next)
+      if (su->count > 0)
+         n_used++;
+   used = VG_(malloc)("errormgr.sus.2", (n_used + 1) * sizeof(Supp*));
+   n_used = 0;
+   for (su = suppressions; su != NULL; su = su->next)
+      if (su->count > 0)
+         used[n_used++] = su;
+   VG_(ssort)(used, n_used, sizeof(Supp*), cmp_Supp_by_stamp);
+
    any_supp = False;
-   for (su = suppressions; su != NULL; su = su->next) {
-      if (su->count <= 0)
-         continue;
+   for (i = 0; i < n_used; i++) {
+      su = used[i];
       if (VG_(clo_xml)) {
          VG_(printf_xml)( "  <pair>\n"
                                  "    <count>%d</count>\n"
@@ -791,6 +822,7 @@ static Bool show_used_suppressions ( void )
       }
       any_supp = True;
    }
+   VG_(free)(used);
 
    if (VG_(clo_xml))
       VG_(printf_xml)("</suppcounts>\n");
@@ -1090,6 +1122,7 @@ static void load_one_suppressions_file ( Int clo_suppressions_i )
       Supp* supp;
       supp        = VG_(malloc)("errormgr.losf.1", sizeof(Supp));
       supp->count = 0;
+      supp->search_mark = 0;
 
       
       for (i = 0; i < VG_MAX_SUPP_CALLERS; i++) {
@@ -1234,6 +1267,7 @@ static void load_one_suppressions_file ( Int clo_suppressions_i )
          supp->callers[i] = tmp_callers[i];
       }
 
+      supp->stamp = ++supp_stamp;
       supp->next = suppressions;
       suppressions = supp;
    }
@@ -1267,21 +1301,11 @@ void VG_(load_suppressions) ( void )
       }
       load_one_suppressions_file( i );
    }
+   build_supp_trie();
 }
 
 
 
-static Bool supploc_IsStar ( const void* supplocV )
-{
-   const SuppLoc* supploc = supplocV;
-   return supploc->ty == DotDotDot;
-}
-
-static Bool supploc_IsQuery ( const void* supplocV )
-{
-   return False; 
-}
-
 typedef
    struct {
       StackTrace ips; 
@@ -1597,35 +1621,6 @@ static Bool supp_pattEQinp ( const void* supplocV, const void* addrV,
 }
 
 
-static Bool supp_matches_callers(IPtoFunOrObjCompleter* ip2fo,
-                                 const Supp* su)
-{
-   
-   SuppLoc*   supps    = su->callers;
-   UWord      n_supps  = su->n_callers;
-   UWord      szbPatt  = sizeof(SuppLoc);
-   Bool       matchAll = False; 
-   if (DEBUG_ERRORMGR) {
-      HChar *filename = *(HChar**) VG_(indexXA)(VG_(clo_suppressions),
-                                                su->clo_suppressions_i);
-      VG_(dmsg)("   errormgr Checking match with  %s  %s:%d\n",
-                su->sname,
-                filename,
-                su->sname_lineno);
-   }
-   return
-      VG_(generic_match)(
-         matchAll,
-         supps, szbPatt, n_supps, 0,
-         
-         NULL, 0, 0,   
-         0,
-         supploc_IsStar, supploc_IsQuery, supp_pattEQinp,
-         ip2fo, haveInputInpC
-      );
-}
-
-
 static
 Bool supp_matches_error(const Supp* su, const Error* err)
 {
@@ -1647,10 +1642,268 @@ Bool supp_matches_error(const Supp* su, const Error* err)
 }
 
 
+typedef
+   struct _SuppTrieNode {
+      struct _SuppTrieNode* star;
+      XArray* wild;
+      XArray* ends;
+      UInt    n_fun;
+      UInt    n_obj;
+   }
+   SuppTrieNode;
+
+typedef
+   struct _SuppTrieEdge {
+      struct _SuppTrieEdge* next;
+      UWord                 key;
+      const SuppTrieNode*   parent;
+      const SuppLoc*        loc;
+      SuppTrieNode*         child;
+   }
+   SuppTrieEdge;
+
+typedef
+   struct _SuppCacheEnt {
+      struct _SuppCacheEnt* next;
+      UWord                 key;
+      UInt                  n_cands;
+      Supp**                cands;
+   }
+   SuppCacheEnt;
+
+static SuppTrieNode* supp_trie = NULL;
+
+static VgHashTable* supp_trie_edges = NULL;
+
+static VgHashTable* supp_cache = NULL;
+
+static UInt supp_cache_generation = 0;
+
+static UInt supp_search_mark = 0;
+
+static SuppTrieNode* new_SuppTrieNode ( void )
+{
+   return VG_(calloc)("errormgr.nstn.1", 1, sizeof(SuppTrieNode));
+}
+
+static UWord supp_trie_key ( const SuppTrieNode* parent,
+                             SuppLocTy ty, const HChar* name )
+{
+   UWord h = (UWord)parent ^ (UWord)ty;
+   while (*name)
+      h = h * 31 + (UChar)*name++;
+   return h;
+}
+
+static Word cmp_SuppTrieEdge ( const void* e1V, const void* e2V )
+{
+   const SuppTrieEdge* e1 = e1V;
+   const SuppTrieEdge* e2 = e2V;
+   if (e1->parent != e2->parent || e1->loc->ty != e2->loc->ty)
+      return 1;
+   return VG_(strcmp)(e1->loc->name, e2->loc->name);
+}
+
+static SuppTrieNode* supp_trie_child ( SuppTrieNode* node,
+                                       const SuppLoc* loc )
+{
+   SuppTrieEdge  key;
+   SuppTrieEdge* edge;
+   Word          i;
+
+   if (loc->ty == DotDotDot) {
+      if (node->star == NULL)
+         node->star = new_SuppTrieNode();
+      return node->star;
+   }
+   vg_assert(loc->ty == FunName || loc->ty == ObjName);
+
+   key.next   = NULL;
+   key.parent = node;
+   key.loc    = loc;
+   key.child  = NULL;
+
+   if (!loc->name_is_simple_str) {
+      if (node->wild == NULL)
+         node->wild = VG_(newXA)(VG_(malloc), "errormgr.stc.1",
+                                 VG_(free), sizeof(SuppTrieEdge));
+      for (i = 0; i < VG_(sizeXA)(node->wild); i++) {
+         edge = VG_(indexXA)(node->wild, i);
+         if (edge->loc->ty == loc->ty
+             && VG_STREQ(edge->loc->name, loc->name))
+            return edge->child;
+      }
+      key.key   = 0;
+      key.child = new_SuppTrieNode();
+      VG_(addToXA)(node->wild, &key);
+      return key.child;
+   }
+
+   key.key = supp_trie_key(node, loc->ty, loc->name);
+   edge = VG_(HT_gen_lookup)(supp_trie_edges, &key, cmp_SuppTrieEdge);
+   if (edge == NULL) {
+      edge = VG_(malloc)("errormgr.stc.2", sizeof(SuppTrieEdge));
+      *edge = key;
+      edge->child = new_SuppTrieNode();
+      VG_(HT_add_node)(supp_trie_edges, edge);
+      if (loc->ty == FunName)
+         node->n_fun++;
+      else
+         node->n_obj++;
+   }
+   return edge->child;
+}
+
+static void build_supp_trie ( void )
+{
+   Supp* su;
+   Int   i;
+
+   supp_trie = new_SuppTrieNode();
+   supp_trie_edges = VG_(HT_construct)("errormgr.bst.1");
+   for (su = suppressions; su != NULL; su = su->next) {
+      SuppTrieNode* node = supp_trie;
+      for (i = 0; i < su->n_callers; i++)
+         node = supp_trie_child(node, &su->callers[i]);
+      if (node->ends == NULL)
+         node->ends = VG_(newXA)(VG_(malloc), "errormgr.bst.2",
+                                 VG_(free), sizeof(Supp*));
+      VG_(addToXA)(node->ends, &su);
+   }
+}
+
+static void supp_trie_match ( const SuppTrieNode* node,
+                              IPtoFunOrObjCompleter* ip2fo,
+                              UWord ixInput, XArray* cands );
+
+static void supp_trie_match_name ( const SuppTrieNode* node,
+                                   IPtoFunOrObjCompleter* ip2fo,
+                                   UWord ixInput, SuppLocTy ty,
+                                   XArray* cands )
+{
+   SuppLoc       probe;
+   SuppTrieEdge  key;
+   SuppTrieEdge* edge;
+
+   probe.ty = ty;
+   probe.name_is_simple_str = True;
+   probe.name = foComplete(ip2fo, ixInput, ty == FunName);
+   key.key    = supp_trie_key(node, ty, probe.name);
+   key.parent = node;
+   key.loc    = &probe;
+   edge = VG_(HT_gen_lookup)(supp_trie_edges, &key, cmp_SuppTrieEdge);
+   if (edge)
+      supp_trie_match(edge->child, ip2fo, ixInput + 1, cands);
+}
+
+static void supp_trie_match ( const SuppTrieNode* node,
+                              IPtoFunOrObjCompleter* ip2fo,
+                              UWord ixInput, XArray* cands )
+{
+   Word i;
+
+   if (node->ends) {
+      for (i = 0; i < VG_(sizeXA)(node->ends); i++) {
+         Supp* su = *(Supp**)VG_(indexXA)(node->ends, i);
+         if (DEBUG_ERRORMGR || VG_(debugLog_getLevel)() >= 4) {
+            HChar *filename = *(HChar**) VG_(indexXA)(VG_(clo_suppressions),
+                                                      su->clo_suppressions_i);
+            VG_(dmsg)("   errormgr Checking match with  %s  %s:%d\n",
+                      su->sname,
+                      filename,
+                      su->sname_lineno);
+         }
+         if (su->search_mark != supp_search_mark) {
+            su->search_mark = supp_search_mark;
+            VG_(addToXA)(cands, &su);
+         }
+      }
+   }
+
+   if (node->star) {
+      UWord ix;
+      for (ix = ixInput; ; ix++) {
+         supp_trie_match(node->star, ip2fo, ix, cands);
+         if (!haveInputInpC(ip2fo, ix))
+            break;
+      }
+   }
+
+   if (!haveInputInpC(ip2fo, ixInput))
+      return;
+
+   if (node->n_fun > 0)
+      supp_trie_match_name(node, ip2fo, ixInput, FunName, cands);
+   if (node->n_obj > 0)
+      supp_trie_match_name(node, ip2fo, ixInput, ObjName, cands);
+   if (node->wild) {
+      for (i = 0; i < VG_(sizeXA)(node->wild); i++) {
+         SuppTrieEdge* edge = VG_(indexXA)(node->wild, i);
+         if (supp_pattEQinp(edge->loc, NULL, ip2fo, ixInput))
+            supp_trie_match(edge->child, ip2fo, ixInput + 1, cands);
+      }
+   }
+}
+
+static void free_SuppCacheEnt ( void* entV )
+{
+   SuppCacheEnt* ent = entV;
+   if (ent->cands)
+      VG_(free)(ent->cands);
+   VG_(free)(ent);
+}
+
+static SuppCacheEnt* supp_candidates ( ExeContext* where,
+                                       IPtoFunOrObjCompleter* ip2fo,
+                                       Bool* searched )
+{
+   UWord         ecu;
+   SuppCacheEnt* ent;
+   XArray*       cands;
+
+   if (supp_cache == NULL
+       || supp_cache_generation != VG_(CF_info_generation)()) {
+      if (supp_cache)
+         VG_(HT_destruct)(supp_cache, free_SuppCacheEnt);
+      supp_cache = VG_(HT_construct)("errormgr.sc.1");
+      supp_cache_generation = VG_(CF_info_generation)();
+   }
+
+   ecu = VG_(get_ECU_from_ExeContext)(where);
+   ent = VG_(HT_lookup)(supp_cache, ecu);
+   *searched = ent == NULL;
+   if (ent) {
+      em_suppcache_hits++;
+      return ent;
+   }
+
+   if (DEBUG_ERRORMGR || VG_(debugLog_getLevel)() >= 4)
+     VG_(dmsg)("errormgr matching begin\n");
+   cands = VG_(newXA)(VG_(malloc), "errormgr.sc.2", VG_(free), sizeof(Supp*));
+   supp_search_mark++;
+   if (supp_trie)
+      supp_trie_match(supp_trie, ip2fo, 0, cands);
+
+   ent = VG_(malloc)("errormgr.sc.3", sizeof(SuppCacheEnt));
+   ent->key = ecu;
+   ent->n_cands = VG_(sizeXA)(cands);
+   ent->cands = NULL;
+   if (ent->n_cands > 0) {
+      ent->cands = VG_(malloc)("errormgr.sc.4", ent->n_cands * sizeof(Supp*));
+      VG_(memcpy)(ent->cands, VG_(indexXA)(cands, 0),
+                  ent->n_cands * sizeof(Supp*));
+   }
+   VG_(deleteXA)(cands);
+   VG_(HT_add_node)(supp_cache, ent);
+   return ent;
+}
+
 static Supp* is_suppressible_error ( const Error* err )
 {
    Supp* su;
-   Supp* su_prev;
+   SuppCacheEnt* ent;
+   UInt i;
+   Bool searched;
 
    IPtoFunOrObjCompleter ip2fo;
 
@@ -1671,29 +1924,23 @@ static Supp* is_suppressible_error ( const Error* err )
    ip2fo.names_free = 0;
 
    
-   if (DEBUG_ERRORMGR || VG_(debugLog_getLevel)() >= 4)
-     VG_(dmsg)("errormgr matching begin\n");
-   su_prev = NULL;
-   for (su = suppressions; su != NULL; su = su->next) {
+   ent = supp_candidates(err->where, &ip2fo, &searched);
+
+   su = NULL;
+   for (i = 0; i < ent->n_cands; i++) {
+      Supp* cand = ent->cands[i];
       em_supplist_cmps++;
-      if (supp_matches_error(su, err) 
-          && supp_matches_callers(&ip2fo, su)) {
-         
-         
-         (void)VG_TDICT_CALL(tool_update_extra_suppression_use, err, su);
-         if (su_prev) {
-            vg_assert(su_prev->next == su);
-            su_prev->next = su->next;
-            su->next = suppressions;
-            suppressions = su;
-         }
-         clearIPtoFunOrObjCompleter(su, &ip2fo);
-         return su;
-      }
-      su_prev = su;
+      if ((su == NULL || cand->stamp > su->stamp)
+          && supp_matches_error(cand, err))
+         su = cand;
    }
-   clearIPtoFunOrObjCompleter(NULL, &ip2fo);
-   return NULL;      
+   if (su) {
+      (void)VG_TDICT_CALL(tool_update_extra_suppression_use, err, su);
+      su->stamp = ++supp_stamp;
+   }
+   if (searched)
+      clearIPtoFunOrObjCompleter(su, &ip2fo);
+   return su;
 }
 
 void VG_(print_errormgr_stats) ( void )
@@ -1702,6 +1949,10 @@ void VG_(print_errormgr_stats) ( void )
       " errormgr: %'lu supplist searches, %'lu comparisons during search\n",
       em_supplist_searches, em_supplist_cmps
    );
+   VG_(dmsg)(
+      " errormgr: %'lu supplist searches answered from the cache\n",
+      em_suppcache_hits
+   );
    VG_(dmsg)(
       " errormgr: %'lu errlist searches, %'lu comparisons during search\n",
       em_errlist_searches, em_errlist_cmps
@@ -388,7 +388,7 @@ Bool VG_(is_watched)(PointKind kind, Addr addr, Int szB)
    return watched;
 }
 
-static VgVgdb VG_(gdbserver_instrumentation_needed) (const VexGuestExtents* vge)
+VgVgdb VG_(gdbserver_instrumentation_needed) (const VexGuestExtents* vge)
 {
    GS_Address* g;
    int e;
@@ -31,6 +31,7 @@
 #include "pub_core_syswrap.h"      
 #include "pub_core_scheduler.h"
 #include "pub_core_transtab.h"
+#include "pub_core_transcache.h"
 #include "pub_core_debuginfo.h"
 #include "pub_core_addrinfo.h"
 #include "pub_core_aspacemgr.h"
@@ -148,6 +149,7 @@ void VG_(print_all_stats) (Bool memory_stats, Bool tool_stats)
 
    VG_(print_translation_stats)();
    VG_(print_tt_tc_stats)();
+   VG_(transcache_print_stats)();
    VG_(print_scheduler_stats)();
    VG_(print_ExeContext_stats)( False  );
    VG_(print_errormgr_stats)();
@@ -317,6 +317,26 @@ UInt VG_(fprintf) ( VgFile *fp, const HChar *format, ... )
    return ret;
 }
 
+void VG_(fwrite) ( VgFile *fp, const void *buf, SizeT nbytes )
+{
+   const HChar *p = buf;
+
+   while (nbytes > 0) {
+      SizeT n = VGFILE_BUFSIZE - fp->num_chars;
+      if (n > nbytes)
+         n = nbytes;
+      VG_(memcpy)(fp->buf + fp->num_chars, p, n);
+      fp->num_chars += n;
+      p += n;
+      nbytes -= n;
+
+      if (fp->num_chars == VGFILE_BUFSIZE) {
+         VG_(write)(fp->fd, fp->buf, fp->num_chars);
+         fp->num_chars = 0;
+      }
+   }
+}
+
 void VG_(fclose)( VgFile *fp )
 {
    
@@ -550,6 +550,21 @@ Int VG_(fork) ( void )
 #  endif
 }
 
+Int VG_(fork_nosigchld) ( void )
+{
+#  if defined(VGO_linux)
+   SysRes res;
+   res = VG_(do_syscall5)(__NR_clone, 0,
+                          (UWord)NULL, (UWord)NULL, (UWord)NULL, (UWord)NULL);
+   if (sr_isError(res))
+      return -1;
+   return sr_Res(res);
+
+#  else
+   return -1;
+#  endif
+}
+
 
 UInt VG_(read_millisecond_timer) ( void )
 {
@@ -62,6 +62,7 @@
 #include "pub_core_translate.h"     
 #include "pub_core_trampoline.h"
 #include "pub_core_transtab.h"
+#include "pub_core_transcache.h"
 #include "pub_core_inner.h"
 #if defined(ENABLE_INNER_CLIENT_REQUEST)
 #include "pub_core_clreq.h"
@@ -164,6 +165,9 @@ static void usage_NORETURN ( Bool debug_help )
 "                              and use it to print better error messages in\n"
 "                              tools that make use of it (Memcheck, Helgrind,\n"
 "                              DRD) [no]\n"
+"    --lazy-debuginfo=yes|no   only index the DWARF line, inline and variable\n"
+"                              info of each object when it is loaded, and\n"
+"                              read it when first needed [no]\n"
 "    --vgdb-poll=<number>      gdbserver poll max every <number> basic blocks [%d] \n"
 "    --vgdb-shadow-registers=no|yes   let gdb see the shadow registers [no]\n"
 "    --vgdb-prefix=<prefix>    prefix for vgdb FIFOs [%s]\n"
@@ -184,6 +188,12 @@ static void usage_NORETURN ( Bool debug_help )
 "           more sectors may increase performance, but use more memory.\n"
 "    --avg-transtab-entry-size=<number> avg size in bytes of a translated\n"
 "           basic block [0, meaning use tool provided default]\n"
+"    --translation-cache-dir=<dir> reuse translations of unmodified\n"
+"           shared objects across runs, stored in <dir> [none]\n"
+"    --hot-sb-threshold=<number> re-translate superblocks run <number>\n"
+"           times as optimised multi-block traces [0, meaning never]\n"
+"    --parallel-threads=no|yes run guest threads truly in parallel, for\n"
+"           tools that support it; needs --vgdb=no [no]\n"
 "    --aspace-minaddr=0xPP     avoid mapping memory below 0xPP [guessed]\n"
 "    --valgrind-stacksize=<number> size of valgrind (host) thread's stack\n"
 "                               (in bytes) ["
@@ -626,6 +636,7 @@ void main_process_cmd_line_options ( Bool* logging_to_fd,
       else if VG_BOOL_CLO(arg, "--sym-offsets",      VG_(clo_sym_offsets)) {}
       else if VG_BOOL_CLO(arg, "--read-inline-info", VG_(clo_read_inline_info)) {}
       else if VG_BOOL_CLO(arg, "--read-var-info",    VG_(clo_read_var_info)) {}
+      else if VG_BOOL_CLO(arg, "--lazy-debuginfo",   VG_(clo_lazy_debuginfo)) {}
 
       else if VG_INT_CLO (arg, "--dump-error",       VG_(clo_dump_error))   {}
       else if VG_INT_CLO (arg, "--input-fd",         VG_(clo_input_fd))     {}
@@ -638,6 +649,12 @@ void main_process_cmd_line_options ( Bool* logging_to_fd,
       else if VG_BINT_CLO(arg, "--avg-transtab-entry-size",
                                VG_(clo_avg_transtab_entry_size),
                                50, 5000) {}
+      else if VG_STR_CLO(arg, "--translation-cache-dir",
+                              VG_(clo_translation_cache_dir)) {}
+      else if VG_BINT_CLO(arg, "--hot-sb-threshold",
+                               VG_(clo_hot_sb_threshold), 0, 1000000000) {}
+      else if VG_BOOL_CLO(arg, "--parallel-threads",
+                               VG_(clo_parallel_threads)) {}
       else if VG_BINT_CLO(arg, "--merge-recursive-frames",
                                VG_(clo_merge_recursive_frames), 0,
                                VG_DEEPEST_BACKTRACE) {}
@@ -1924,6 +1941,18 @@ Int valgrind_main ( Int argc, HChar **argv, HChar **envp )
    
    VG_(debugLog)(1, "main", "Initialise TT/TC\n");
    VG_(init_tt_tc)();
+   VG_(transcache_init)();
+
+   if (VG_(clo_parallel_threads)
+       && (!VG_TT_FAST_PER_THREAD
+           || !VG_(needs).thread_safe_instrumentation
+           || VG_(clo_vgdb) != Vg_VgdbNo || VG_(clo_profyle_sbs))) {
+      if (VG_(clo_verbosity) > 0)
+         VG_(message)(Vg_UserMsg, "Warning: --parallel-threads=yes is "
+                      "not supported on this platform or by this tool "
+                      "(or these tool options) and is ignored\n");
+      VG_(clo_parallel_threads) = False;
+   }
 
    
    
@@ -2350,6 +2379,8 @@ void shutdown_actions_NORETURN( ThreadId tid,
 
    VG_TDICT_CALL(tool_fini, 0);
 
+   VG_(transcache_save)();
+
    
    if (VG_(clo_xml)
        && (VG_(needs).core_errors || VG_(needs).tool_errors)) {
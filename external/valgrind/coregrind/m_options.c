@@ -85,6 +85,8 @@ XArray *VG_(clo_suppressions);
 XArray *VG_(clo_fullpath_after); 
 const HChar* VG_(clo_extra_debuginfo_path) = NULL;
 const HChar* VG_(clo_debuginfo_server) = NULL;
+const HChar* VG_(clo_translation_cache_dir) = NULL;
+Bool   VG_(clo_parallel_threads) = False;
 Bool   VG_(clo_allow_mismatched_debuginfo) = False;
 UChar  VG_(clo_trace_flags)    = 0; 
 Bool   VG_(clo_profyle_sbs)    = False;
@@ -114,6 +116,7 @@ UInt   VG_(clo_sim_hints)      = 0;
 Bool   VG_(clo_sym_offsets)    = False;
 Bool   VG_(clo_read_inline_info) = False; 
 Bool   VG_(clo_read_var_info)  = False;
+Bool   VG_(clo_lazy_debuginfo) = False;
 XArray *VG_(clo_req_tsyms);  
 Bool   VG_(clo_run_libc_freeres) = True;
 Bool   VG_(clo_track_fds)      = False;
@@ -72,6 +72,11 @@
 
 Bool VG_(in_generated_code) = False;
 
+static volatile Int n_running_in_parallel = 0;
+
+static ULong n_parallel_runs = 0;
+static ULong n_parallel_stops = 0;
+
 static ULong bbs_done = 0;
 
 static ULong vgdb_next_poll;
@@ -107,6 +112,10 @@ void VG_(print_scheduler_stats)(void)
    VG_(message)(Vg_DebugMsg, 
                 "   sanity: %d cheap, %d expensive checks.\n",
                 sanity_fast_count, sanity_slow_count );
+   if (VG_(clo_parallel_threads))
+      VG_(message)(Vg_DebugMsg,
+                   "scheduler: %'llu parallel runs, %'llu stop-the-world "
+                   "waits\n", n_parallel_runs, n_parallel_stops );
 }
 
 static struct sched_lock *the_BigLock;
@@ -267,6 +276,21 @@ static void deinit_BigLock(void)
    the_BigLock = NULL;
 }
 
+static void wait_for_parallel_threads ( void )
+{
+   ThreadId tid;
+
+   n_parallel_stops++;
+   while (n_running_in_parallel > 0) {
+      for (tid = 1; tid < VG_N_THREADS; tid++) {
+         if (VG_(threads)[tid].in_parallel)
+            VG_(threads)[tid].arch.vex.host_EvC_COUNTER = 0;
+      }
+      VG_(do_syscall0)(__NR_sched_yield);
+   }
+   __sync_synchronize();
+}
+
 void VG_(acquire_BigLock_LL) ( const HChar* who )
 {
    ML_(acquire_sched_lock)(the_BigLock);
@@ -283,6 +307,55 @@ Bool VG_(owns_BigLock_LL) ( ThreadId tid )
            == VG_(threads)[tid].os_state.lwpid);
 }
 
+static void start_running_in_parallel ( ThreadId tid )
+{
+   ThreadState *tst = VG_(get_ThreadState)(tid);
+
+   vg_assert(tst->status == VgTs_Runnable);
+   vg_assert(VG_(running_tid) == tid);
+   vg_assert(VG_(in_generated_code) == True);
+   vg_assert(!tst->in_parallel);
+
+   n_parallel_runs++;
+   VG_(in_generated_code) = False;
+   tst->status = VgTs_Yielding;
+   VG_(running_tid) = VG_INVALID_THREADID;
+   tst->in_parallel = True;
+   __sync_fetch_and_add(&n_running_in_parallel, 1);
+   VG_(release_BigLock_LL)(NULL);
+}
+
+Bool VG_(stop_running_in_parallel) ( ThreadId tid )
+{
+   ThreadState *tst = VG_(get_ThreadState)(tid);
+
+   if (!tst->in_parallel)
+      return False;
+
+   tst->in_parallel = False;
+   __sync_fetch_and_sub(&n_running_in_parallel, 1);
+   VG_(acquire_BigLock_LL)(NULL);
+
+   vg_assert(tst->status == VgTs_Yielding);
+   vg_assert(VG_(running_tid) == VG_INVALID_THREADID);
+   vg_assert(VG_(in_generated_code) == False);
+   tst->status = VgTs_Runnable;
+   VG_(running_tid) = tid;
+   VG_(in_generated_code) = True;
+   return True;
+}
+
+void VG_(resume_running_in_parallel) ( ThreadId tid )
+{
+   start_running_in_parallel(tid);
+}
+
+void VG_(stop_parallel_threads) ( void )
+{
+   if (n_running_in_parallel > 0)
+      wait_for_parallel_threads();
+}
+
 
 void VG_(exit_thread)(ThreadId tid)
 {
@@ -658,6 +731,7 @@ void run_thread_for_a_while ( HWord* two_words,
    volatile ThreadState* tst            = NULL; 
    volatile Int          done_this_time = 0;
    volatile HWord        host_code_addr = 0;
+   const FastCacheEntry* fast_cache     = NULL;
 
    
    vg_assert(VG_(is_valid_tid)(tid));
@@ -667,11 +741,16 @@ void run_thread_for_a_while ( HWord* two_words,
 
    tst = VG_(get_ThreadState)(tid);
    do_pre_run_checks( tst );
+   fast_cache = VG_(tt_fast_for)(tid);
    
 
    
-   vg_assert(VG_(stats__n_xindirs_32) == 0);
-   vg_assert(VG_(stats__n_xindir_misses_32) == 0);
+   /* Threads running in parallel bump these too, so then they are only
+      approximate. */
+   if (!VG_(clo_parallel_threads)) {
+      vg_assert(VG_(stats__n_xindirs_32) == 0);
+      vg_assert(VG_(stats__n_xindir_misses_32) == 0);
+   }
 
    
    two_words[0] = two_words[1] = 0;
@@ -683,8 +762,8 @@ void run_thread_for_a_while ( HWord* two_words,
    } else {
       
       UInt cno = (UInt)VG_TT_FAST_HASH((Addr)tst->arch.vex.VG_INSTR_PTR);
-      if (LIKELY(VG_(tt_fast)[cno].guest == (Addr)tst->arch.vex.VG_INSTR_PTR))
-         host_code_addr = VG_(tt_fast)[cno].host;
+      if (LIKELY(fast_cache[cno].guest == (Addr)tst->arch.vex.VG_INSTR_PTR))
+         host_code_addr = fast_cache[cno].host;
       else {
          Addr res = 0;
          Bool  found = VG_(search_transtab)(&res, NULL, NULL,
@@ -729,16 +808,22 @@ void run_thread_for_a_while ( HWord* two_words,
    vg_assert(VG_(in_generated_code) == False);
    VG_(in_generated_code) = True;
 
+   if (VG_(clo_parallel_threads))
+      start_running_in_parallel(tid);
+
    SCHEDSETJMP(
       tid, 
       jumped, 
       VG_(disp_run_translations)( 
          two_words,
          (volatile void*)&tst->arch.vex,
-         host_code_addr
+         host_code_addr,
+         fast_cache
       )
    );
 
+   VG_(stop_running_in_parallel)(tid);
+
    vg_assert(VG_(in_generated_code) == True);
    VG_(in_generated_code) = False;
 
@@ -991,11 +1076,13 @@ VgSchedReturnCode VG_(scheduler) ( ThreadId tid )
 
 
 
-	 VG_(release_BigLock)(tid, VgTs_Yielding, 
-                                   "VG_(scheduler):timeslice");
-	 
+	 if (!VG_(clo_parallel_threads)) {
+	    VG_(release_BigLock)(tid, VgTs_Yielding, 
+                                      "VG_(scheduler):timeslice");
+	    
 
-	 VG_(acquire_BigLock)(tid, "VG_(scheduler):timeslice");
+	    VG_(acquire_BigLock)(tid, "VG_(scheduler):timeslice");
+	 }
 	 
 
 	 
@@ -1098,6 +1185,8 @@ VgSchedReturnCode VG_(scheduler) ( ThreadId tid )
       case VG_TRC_INNER_COUNTERZERO:
 	 
 	 vg_assert(dispatch_ctr == 0);
+         if (VG_(clo_hot_sb_threshold) > 0)
+            VG_(translate_hot_traces)( tid, VG_(get_IP)(tid), bbs_done );
 	 break;
 
       case VG_TRC_FAULT_SIGNAL:
@@ -1278,6 +1367,7 @@ void VG_(nuke_all_threads_except) ( ThreadId me, VgSchedReturnCode src )
    ThreadId tid;
 
    vg_assert(VG_(is_running_thread)(me));
+   VG_(stop_parallel_threads)();
 
    for (tid = 1; tid < VG_N_THREADS; tid++) {
       if (tid == me
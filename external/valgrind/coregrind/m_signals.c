@@ -1928,10 +1928,13 @@ void sync_signalhandler ( Int sigNo,
 {
    ThreadId tid = VG_(lwpid_to_vgtid)(VG_(gettid)());
    Bool from_user;
+   Bool in_parallel;
 
    if (0) 
       VG_(printf)("sync_sighandler(%d, %p, %p)\n", sigNo, info, uc);
 
+   in_parallel = VG_(stop_running_in_parallel)(tid);
+
    vg_assert(info != NULL);
    vg_assert(info->si_signo == sigNo);
    vg_assert(sigNo == VKI_SIGSEGV ||
@@ -1959,6 +1962,9 @@ void sync_signalhandler ( Int sigNo,
    } else {
       sync_signalhandler_from_kernel(tid, sigNo, info, uc);
    }
+
+   if (in_parallel)
+      VG_(resume_running_in_parallel)(tid);
 }
 
 
@@ -55,6 +55,7 @@ void VG_(init_Threads)(void)
    VG_(threads) = (ThreadState *)aligned_addr;
 
    for (tid = 1; tid < VG_N_THREADS; tid++) {
+      VG_(threads)[tid].in_parallel = False;
       INNER_REQUEST(
          ANNOTATE_BENIGN_RACE_SIZED(&VG_(threads)[tid].status,
                                     sizeof(VG_(threads)[tid].status), ""));
@@ -85,7 +85,9 @@ VgNeeds VG_(needs) = {
    .var_info	         = False,
    .malloc_replacement   = False,
    .xml_output           = False,
-   .final_IR_tidy_pass   = False
+   .final_IR_tidy_pass   = False,
+   .persistent_translations = False,
+   .thread_safe_instrumentation = False
 };
 
 Bool VG_(sanity_check_needs)(const HChar** failmsg)
@@ -344,6 +346,16 @@ void VG_(needs_final_IR_tidy_pass)(
    VG_(tdict).tool_final_IR_tidy_pass = final_tidy;
 }
 
+void VG_(needs_persistent_translations)( void )
+{
+   VG_(needs).persistent_translations = True;
+}
+
+void VG_(needs_thread_safe_instrumentation)( void )
+{
+   VG_(needs).thread_safe_instrumentation = True;
+}
+
 
 #define DEF0(fn, args...) \
 void VG_(fn)(void(*f)(args)) { \
@@ -0,0 +1,614 @@
+
+
+/*
+   This file is part of Valgrind, a dynamic binary instrumentation
+   framework.
+
+   Copyright (C) 2015-2015 The Android Open Source Project
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+   02111-1307, USA.
+
+   The GNU General Public License is contained in the file COPYING.
+*/
+
+#include "pub_core_basics.h"
+#include "pub_core_vki.h"
+#include "pub_core_aspacemgr.h"
+#include "pub_core_clientstate.h"
+#include "pub_core_debuginfo.h"
+#include "pub_core_gdbserver.h"
+#include "pub_core_hashtable.h"
+#include "pub_core_libcbase.h"
+#include "pub_core_libcassert.h"
+#include "pub_core_libcfile.h"
+#include "pub_core_libcprint.h"
+#include "pub_core_libcproc.h"
+#include "pub_core_machine.h"
+#include "pub_core_mallocfree.h"
+#include "pub_core_options.h"
+#include "pub_core_redir.h"
+#include "pub_core_tooliface.h"
+#include "pub_core_transtab.h"
+#include "pub_core_xarray.h"
+#include "pub_core_transcache.h"
+
+
+#define TC_MAGIC    0x43544756
+#define TC_VERSION  1
+
+#define TC_MAX_RECORDED_BYTES  (256 * 1024 * 1024)
+
+typedef
+   struct {
+      UInt  magic;
+      UInt  version;
+      ULong config_hash;
+      ULong text_avma;
+      ULong text_size;
+      UInt  n_entries;
+      UInt  unused;
+   }
+   TCFileHeader;
+
+typedef
+   struct {
+      UInt   entry_offs;
+      UInt   base_offs[3];
+      UShort len[3];
+      UShort n_used;
+      UInt   n_guest_instrs;
+      UInt   code_len;
+      ULong  guest_hash;
+   }
+   TCFileEntry;
+
+typedef
+   struct _TCEntry {
+      struct _TCEntry* next;
+      UWord            key;
+      VexGuestExtents  vge;
+      ULong            guest_hash;
+      UInt             n_guest_instrs;
+      UInt             code_len;
+      UChar*           code;
+      Bool             owns_code;
+      Bool             stale;
+   }
+   TCEntry;
+
+typedef
+   struct {
+      HChar*       buildid;
+      Addr         text_avma;
+      SizeT        text_size;
+      VgHashTable* entries;
+      UChar*       image;
+      Bool         dirty;
+   }
+   TCObject;
+
+static Bool    tc_active = False;
+static ULong   tc_config_hash = 0;
+static XArray* tc_objects = NULL;
+static TCObject* tc_last_object = NULL;
+static ULong   tc_recorded_bytes = 0;
+
+static ULong n_tc_reloaded  = 0;
+static ULong n_tc_recorded  = 0;
+static ULong n_tc_stale     = 0;
+static ULong n_tc_files_read     = 0;
+static ULong n_tc_files_rejected = 0;
+static ULong n_tc_files_written  = 0;
+
+
+static ULong fnv1a ( ULong h, const void* p, SizeT n )
+{
+   const UChar* b = p;
+   SizeT i;
+   for (i = 0; i < n; i++) {
+      h ^= b[i];
+      h *= 0x100000001b3ULL;
+   }
+   return h;
+}
+
+#define FNV_INIT 0xcbf29ce484222325ULL
+
+static ULong hash_guest_code ( const VexGuestExtents* vge )
+{
+   ULong h = FNV_INIT;
+   UInt  i;
+   for (i = 0; i < vge->n_used; i++)
+      h = fnv1a(h, (const void*)vge->base[i], vge->len[i]);
+   return h;
+}
+
+static Bool extent_cacheable ( Addr base, UShort len )
+{
+   NSegment const* seg = VG_(am_find_nsegment)(base);
+   return seg != NULL
+          && seg->kind == SkFileC
+          && seg->hasR && seg->hasX && !seg->hasW
+          && (len == 0 || base + len - 1 <= seg->end);
+}
+
+static Bool extents_cacheable ( const TCObject* obj,
+                                const VexGuestExtents* vge )
+{
+   Bool isWrap;
+   UInt i;
+   if (vge->n_used < 1 || vge->n_used > 3)
+      return False;
+   for (i = 0; i < vge->n_used; i++) {
+      Addr base = vge->base[i];
+      if (base < obj->text_avma
+          || base + vge->len[i] > obj->text_avma + obj->text_size)
+         return False;
+      if (!extent_cacheable(base, vge->len[i]))
+         return False;
+      if (VG_(redir_do_lookup)(base, &isWrap) != base)
+         return False;
+   }
+   return True;
+}
+
+static Bool skip_option ( const HChar* arg )
+{
+   return VG_STREQN(10, arg, "--log-file")
+          || VG_STREQN(8,  arg, "--log-fd")
+          || VG_STREQN(12, arg, "--log-socket")
+          || VG_STREQN(10, arg, "--xml-file")
+          || VG_STREQN(8,  arg, "--xml-fd")
+          || VG_STREQN(12, arg, "--xml-socket")
+          || VG_STREQN(21, arg, "--translation-cache-d");
+}
+
+static ULong compute_config_hash ( void )
+{
+   ULong       h = FNV_INIT;
+   VexArch     arch;
+   VexArchInfo archinfo;
+   Word        i;
+
+   h = fnv1a(h, VERSION, VG_(strlen)(VERSION));
+   h = fnv1a(h, VG_(details).name, VG_(strlen)(VG_(details).name));
+
+   VG_(machine_get_VexArchInfo)( &arch, &archinfo );
+   h = fnv1a(h, &arch, sizeof(arch));
+   h = fnv1a(h, &archinfo.hwcaps, sizeof(archinfo.hwcaps));
+
+   /* /proc/self/exe is the tool binary (eg. none-amd64-linux), not the
+      valgrind launcher, so a rebuilt tool invalidates its caches. */
+#  if defined(VGO_linux)
+   {
+      struct vg_stat st;
+      SysRes sres = VG_(stat)("/proc/self/exe", &st);
+      if (!sr_isError(sres)) {
+         h = fnv1a(h, &st.ino, sizeof(st.ino));
+         h = fnv1a(h, &st.size, sizeof(st.size));
+         h = fnv1a(h, &st.mtime, sizeof(st.mtime));
+      }
+   }
+#  endif
+
+   for (i = 0; i < VG_(sizeXA)(VG_(args_for_valgrind)); i++) {
+      const HChar* arg = *(HChar**)VG_(indexXA)(VG_(args_for_valgrind), i);
+      if (skip_option(arg))
+         continue;
+      h = fnv1a(h, arg, VG_(strlen)(arg) + 1);
+   }
+   return h;
+}
+
+static HChar* cache_file_name ( const TCObject* obj )
+{
+   const HChar* dir  = VG_(clo_translation_cache_dir);
+   const HChar* tool = VG_(details).name;
+   HChar* name = VG_(malloc)("transcache.cfn.1",
+                             VG_(strlen)(dir) + VG_(strlen)(obj->buildid)
+                             + VG_(strlen)(tool) + 40);
+   VG_(sprintf)(name, "%s/%s-%s-%016llx.vgtc",
+                dir, obj->buildid, tool, tc_config_hash);
+   return name;
+}
+
+static Bool read_all ( Int fd, UChar* buf, SizeT size )
+{
+   SizeT done = 0;
+   while (done < size) {
+      Int n = VG_(read)(fd, buf + done, size - done > (1 << 30)
+                                        ? (1 << 30) : (Int)(size - done));
+      if (n <= 0)
+         return False;
+      done += n;
+   }
+   return True;
+}
+
+static Bool write_all ( Int fd, const void* buf, SizeT size )
+{
+   const UChar* p = buf;
+   SizeT done = 0;
+   while (done < size) {
+      Int n = VG_(write)(fd, p + done, size - done > (1 << 30)
+                                       ? (1 << 30) : (Int)(size - done));
+      if (n <= 0)
+         return False;
+      done += n;
+   }
+   return True;
+}
+
+static Bool parse_image ( TCObject* obj, SizeT size )
+{
+   const TCFileHeader* hdr = (const TCFileHeader*)obj->image;
+   SizeT off = sizeof(TCFileHeader);
+   UInt  i, j;
+
+   if (size < sizeof(TCFileHeader)
+       || hdr->magic != TC_MAGIC
+       || hdr->version != TC_VERSION
+       || hdr->config_hash != tc_config_hash
+       || hdr->text_avma != obj->text_avma
+       || hdr->text_size != obj->text_size)
+      return False;
+
+   for (i = 0; i < hdr->n_entries; i++) {
+      TCFileEntry fe;
+      TCEntry*    ent;
+
+      if (size - off < sizeof(TCFileEntry))
+         return False;
+      VG_(memcpy)(&fe, obj->image + off, sizeof(fe));
+      off += sizeof(TCFileEntry);
+
+      if (fe.n_used < 1 || fe.n_used > 3
+          || fe.code_len == 0 || fe.code_len >= 65536
+          || size - off < fe.code_len
+          || fe.entry_offs >= obj->text_size)
+         return False;
+      for (j = 0; j < fe.n_used; j++)
+         if (fe.base_offs[j] > obj->text_size
+             || fe.len[j] > obj->text_size - fe.base_offs[j])
+            return False;
+
+      ent = VG_(malloc)("transcache.pi.1", sizeof(TCEntry));
+      ent->key = obj->text_avma + fe.entry_offs;
+      VG_(memset)(&ent->vge, 0, sizeof(ent->vge));
+      ent->vge.n_used = fe.n_used;
+      for (j = 0; j < fe.n_used; j++) {
+         ent->vge.base[j] = obj->text_avma + fe.base_offs[j];
+         ent->vge.len[j]  = fe.len[j];
+      }
+      ent->guest_hash     = fe.guest_hash;
+      ent->n_guest_instrs = fe.n_guest_instrs;
+      ent->code_len       = fe.code_len;
+      ent->code           = obj->image + off;
+      ent->owns_code      = False;
+      ent->stale          = False;
+      if (VG_(HT_lookup)(obj->entries, ent->key) != NULL) {
+         VG_(free)(ent);
+         return False;
+      }
+      VG_(HT_add_node)(obj->entries, ent);
+
+      off += VG_ROUNDUP(fe.code_len, 8);
+      if (off > size)
+         return False;
+   }
+   return True;
+}
+
+static void free_entry ( void* node )
+{
+   TCEntry* ent = node;
+   if (ent->owns_code)
+      VG_(free)(ent->code);
+   VG_(free)(ent);
+}
+
+static void load_object ( TCObject* obj )
+{
+   HChar*         name = cache_file_name(obj);
+   struct vg_stat st;
+   SysRes         sres;
+   Int            fd;
+   Bool           ok;
+
+   sres = VG_(open)(name, VKI_O_RDONLY, 0);
+   if (sr_isError(sres)) {
+      VG_(free)(name);
+      return;
+   }
+   fd = sr_Res(sres);
+
+   ok = VG_(fstat)(fd, &st) == 0 && st.size > 0;
+   if (ok) {
+      obj->image = VG_(malloc)("transcache.lo.1", st.size);
+      ok = read_all(fd, obj->image, st.size) && parse_image(obj, st.size);
+   }
+   VG_(close)(fd);
+
+   if (ok) {
+      n_tc_files_read++;
+      if (VG_(clo_verbosity) > 1)
+         VG_(message)(Vg_DebugMsg, "transcache: loaded %d translations "
+                      "from %s\n", VG_(HT_count_nodes)(obj->entries), name);
+   } else {
+      n_tc_files_rejected++;
+      if (VG_(clo_verbosity) > 1)
+         VG_(message)(Vg_DebugMsg, "transcache: discarding stale or "
+                      "damaged %s\n", name);
+      VG_(HT_destruct)(obj->entries, free_entry);
+      obj->entries = VG_(HT_construct)("transcache.lo.2");
+      if (obj->image) {
+         VG_(free)(obj->image);
+         obj->image = NULL;
+      }
+      VG_(unlink)(name);
+      obj->dirty = True;
+   }
+   VG_(free)(name);
+}
+
+static TCObject* object_for ( Addr a )
+{
+   DebugInfo*   di;
+   const HChar* buildid;
+   Addr         avma;
+   SizeT        size;
+   TCObject*    obj;
+   Word         i;
+
+   di = VG_(find_DebugInfo)(a);
+   if (di == NULL)
+      return NULL;
+   buildid = VG_(DebugInfo_get_buildid)(di);
+   if (buildid == NULL)
+      return NULL;
+   avma = VG_(DebugInfo_get_text_avma)(di);
+   size = VG_(DebugInfo_get_text_size)(di);
+
+   obj = tc_last_object;
+   if (obj && obj->text_avma == avma && obj->text_size == size
+       && VG_(strcmp)(obj->buildid, buildid) == 0)
+      return obj;
+
+   for (i = 0; i < VG_(sizeXA)(tc_objects); i++) {
+      obj = *(TCObject**)VG_(indexXA)(tc_objects, i);
+      if (obj->text_avma == avma && obj->text_size == size
+          && VG_(strcmp)(obj->buildid, buildid) == 0) {
+         tc_last_object = obj;
+         return obj;
+      }
+   }
+
+   obj = VG_(malloc)("transcache.of.1", sizeof(TCObject));
+   obj->buildid   = VG_(strdup)("transcache.of.2", buildid);
+   obj->text_avma = avma;
+   obj->text_size = size;
+   obj->entries   = VG_(HT_construct)("transcache.of.3");
+   obj->image     = NULL;
+   obj->dirty     = False;
+   load_object(obj);
+   VG_(addToXA)(tc_objects, &obj);
+   tc_last_object = obj;
+   return obj;
+}
+
+void VG_(transcache_init) ( void )
+{
+   if (VG_(clo_translation_cache_dir) == NULL)
+      return;
+
+   if (!VG_(needs).persistent_translations) {
+      if (VG_(clo_verbosity) > 0)
+         VG_(message)(Vg_UserMsg, "Warning: --translation-cache-dir is "
+                      "not supported by this tool (or these tool options)"
+                      " and is ignored\n");
+      return;
+   }
+   if (VG_(clo_profyle_sbs) || VG_(clo_trace_flags) != 0
+       || VG_(clo_vgdb) == Vg_VgdbFull)
+      return;
+
+   tc_config_hash = compute_config_hash();
+   tc_objects = VG_(newXA)(VG_(malloc), "transcache.init.1", VG_(free),
+                           sizeof(TCObject*));
+   tc_active = True;
+
+   if (VG_(clo_verbosity) > 1)
+      VG_(message)(Vg_DebugMsg, "transcache: using %s (config %016llx)\n",
+                   VG_(clo_translation_cache_dir), tc_config_hash);
+}
+
+Bool VG_(transcache_reload) ( Addr nraddr )
+{
+   TCObject* obj;
+   TCEntry*  ent;
+   UInt      i;
+
+   if (!tc_active)
+      return False;
+   obj = object_for(nraddr);
+   if (obj == NULL)
+      return False;
+   ent = VG_(HT_lookup)(obj->entries, nraddr);
+   if (ent == NULL || ent->stale)
+      return False;
+   if (VG_(gdbserver_instrumentation_needed)(&ent->vge) != Vg_VgdbNo)
+      return False;
+
+   if (!extents_cacheable(obj, &ent->vge)
+       || hash_guest_code(&ent->vge) != ent->guest_hash) {
+      ent->stale = True;
+      obj->dirty = True;
+      n_tc_stale++;
+      return False;
+   }
+
+   VG_(add_to_transtab)( &ent->vge, nraddr, (Addr)ent->code, ent->code_len,
+                         False, -1, ent->n_guest_instrs );
+   for (i = 0; i < ent->vge.n_used; i++)
+      VG_(am_set_segment_hasT)( ent->vge.base[i] );
+   n_tc_reloaded++;
+   return True;
+}
+
+void VG_(transcache_record) ( const VexGuestExtents* vge,
+                              Addr         nraddr,
+                              const UChar* code,
+                              UInt         code_len,
+                              UInt         n_guest_instrs )
+{
+   TCObject* obj;
+   TCEntry*  ent;
+   UChar*    copy;
+
+   if (!tc_active)
+      return;
+   if (VG_(gdbserver_instrumentation_needed)(vge) != Vg_VgdbNo)
+      return;
+   if (tc_recorded_bytes + code_len > TC_MAX_RECORDED_BYTES)
+      return;
+   obj = object_for(nraddr);
+   if (obj == NULL || !extents_cacheable(obj, vge))
+      return;
+
+   ent = VG_(HT_lookup)(obj->entries, nraddr);
+   if (ent != NULL) {
+      if (!ent->stale)
+         return;
+      VG_(HT_remove)(obj->entries, nraddr);
+      free_entry(ent);
+   }
+
+   copy = VG_(malloc)("transcache.rec.1", code_len);
+   VG_(memcpy)(copy, code, code_len);
+
+   ent = VG_(malloc)("transcache.rec.2", sizeof(TCEntry));
+   ent->key            = nraddr;
+   ent->vge            = *vge;
+   ent->guest_hash     = hash_guest_code(vge);
+   ent->n_guest_instrs = n_guest_instrs;
+   ent->code_len       = code_len;
+   ent->code           = copy;
+   ent->owns_code      = True;
+   ent->stale          = False;
+   VG_(HT_add_node)(obj->entries, ent);
+
+   obj->dirty = True;
+   tc_recorded_bytes += code_len;
+   n_tc_recorded++;
+}
+
+static Bool save_object ( const TCObject* obj, const HChar* name )
+{
+   static const UChar zeroes[8] = { 0 };
+   HChar*        tmpname;
+   TCFileHeader  hdr;
+   TCEntry*      ent;
+   SysRes        sres;
+   Int           fd;
+   Bool          ok = True;
+   UInt          j;
+
+   tmpname = VG_(malloc)("transcache.so.1", VG_(strlen)(name) + 32);
+   VG_(sprintf)(tmpname, "%s.%d.tmp", name, VG_(getpid)());
+   sres = VG_(open)(tmpname, VKI_O_WRONLY | VKI_O_CREAT | VKI_O_TRUNC,
+                    VKI_S_IRUSR | VKI_S_IWUSR | VKI_S_IRGRP | VKI_S_IROTH);
+   if (sr_isError(sres)) {
+      VG_(free)(tmpname);
+      return False;
+   }
+   fd = sr_Res(sres);
+
+   VG_(memset)(&hdr, 0, sizeof(hdr));
+   hdr.magic       = TC_MAGIC;
+   hdr.version     = TC_VERSION;
+   hdr.config_hash = tc_config_hash;
+   hdr.text_avma   = obj->text_avma;
+   hdr.text_size   = obj->text_size;
+   VG_(HT_ResetIter)(obj->entries);
+   while ((ent = VG_(HT_Next)(obj->entries)))
+      if (!ent->stale)
+         hdr.n_entries++;
+   ok = write_all(fd, &hdr, sizeof(hdr));
+
+   VG_(HT_ResetIter)(obj->entries);
+   while (ok && (ent = VG_(HT_Next)(obj->entries))) {
+      TCFileEntry fe;
+      if (ent->stale)
+         continue;
+      VG_(memset)(&fe, 0, sizeof(fe));
+      fe.entry_offs = ent->key - obj->text_avma;
+      fe.n_used     = ent->vge.n_used;
+      for (j = 0; j < ent->vge.n_used; j++) {
+         fe.base_offs[j] = ent->vge.base[j] - obj->text_avma;
+         fe.len[j]       = ent->vge.len[j];
+      }
+      fe.n_guest_instrs = ent->n_guest_instrs;
+      fe.code_len       = ent->code_len;
+      fe.guest_hash     = ent->guest_hash;
+      ok = write_all(fd, &fe, sizeof(fe))
+           && write_all(fd, ent->code, ent->code_len)
+           && write_all(fd, zeroes, VG_ROUNDUP(ent->code_len, 8)
+                                    - ent->code_len);
+   }
+   VG_(close)(fd);
+
+   if (ok)
+      ok = VG_(rename)(tmpname, name) == 0;
+   if (!ok)
+      VG_(unlink)(tmpname);
+   VG_(free)(tmpname);
+   return ok;
+}
+
+void VG_(transcache_save) ( void )
+{
+   Word i;
+
+   if (!tc_active)
+      return;
+
+   for (i = 0; i < VG_(sizeXA)(tc_objects); i++) {
+      TCObject* obj = *(TCObject**)VG_(indexXA)(tc_objects, i);
+      HChar*    name;
+      if (!obj->dirty)
+         continue;
+      name = cache_file_name(obj);
+      if (save_object(obj, name))
+         n_tc_files_written++;
+      else if (VG_(clo_verbosity) > 1)
+         VG_(message)(Vg_DebugMsg, "transcache: cannot write %s\n", name);
+      VG_(free)(name);
+   }
+}
+
+void VG_(transcache_print_stats) ( void )
+{
+   if (!tc_active)
+      return;
+   VG_(message)(Vg_DebugMsg,
+                "transcache: %'llu reloaded, %'llu recorded, %'llu stale\n",
+                n_tc_reloaded, n_tc_recorded, n_tc_stale);
+   VG_(message)(Vg_DebugMsg,
+                "transcache: files: %'llu read, %'llu rejected, "
+                "%'llu written\n",
+                n_tc_files_read, n_tc_files_rejected, n_tc_files_written);
+}
+
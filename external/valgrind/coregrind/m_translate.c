@@ -46,6 +46,7 @@
 
 #include "pub_core_translate.h"
 #include "pub_core_transtab.h"
+#include "pub_core_transcache.h"
 #include "pub_core_dispatch.h" 
                                
 
@@ -68,6 +69,9 @@ static ULong n_PX_VexRegUpdUnwindregsAtMemAccess = 0;
 static ULong n_PX_VexRegUpdAllregsAtMemAccess    = 0;
 static ULong n_PX_VexRegUpdAllregsAtEachInsn     = 0;
 
+static ULong n_hot_traces        = 0;
+static ULong n_hot_trace_extents = 0;
+
 void VG_(print_translation_stats) ( void )
 {
    UInt n_SP_updates = n_SP_updates_fast + n_SP_updates_generic_known
@@ -92,6 +96,11 @@ void VG_(print_translation_stats) ( void )
 
    VG_(message)(Vg_DebugMsg,
                 "translate: PX: SPonly %'llu,  UnwRegs %'llu,  AllRegs %'llu,  AllRegsAllInsns %'llu\n", n_PX_VexRegUpdSpAtMemAccess, n_PX_VexRegUpdUnwindregsAtMemAccess, n_PX_VexRegUpdAllregsAtMemAccess, n_PX_VexRegUpdAllregsAtEachInsn);
+
+   if (VG_(clo_hot_sb_threshold) > 0)
+      VG_(message)(Vg_DebugMsg,
+                   "translate: hot SBs re-translated as traces: %'llu "
+                   "(%'llu extents)\n", n_hot_traces, n_hot_trace_extents);
 }
 
 
@@ -738,6 +747,20 @@ static UInt needs_self_check ( void* closureV,
 }
 
 
+#define N_TRACE_TARGETS 16
+
+static const Addr* trace_targets   = NULL;
+static UInt        n_trace_targets = 0;
+
+static Bool is_trace_target ( Addr addr )
+{
+   UInt i;
+   for (i = 0; i < n_trace_targets; i++)
+      if (trace_targets[i] == addr)
+         return True;
+   return False;
+}
+
 static Bool chase_into_ok ( void* closureV, Addr addr )
 {
    NSegment const*    seg     = VG_(am_find_nsegment)(addr);
@@ -760,6 +783,9 @@ static Bool chase_into_ok ( void* closureV, Addr addr )
    if (addr == TRANSTAB_BOGUS_GUEST_ADDR)
       goto dontchase;
 
+   if (trace_targets != NULL && !is_trace_target(addr))
+      goto dontchase;
+
 #  if defined(VGA_s390x)
    if (((UChar *)addr)[0] == 0x44 ||   
        ((UChar *)addr)[0] == 0xC6)     
@@ -1328,6 +1354,10 @@ Bool VG_(translate) ( ThreadId tid,
       return False;
    }
 
+   if (kind == T_Normal && !debugging_translation && trace_targets == NULL
+       && VG_(transcache_reload)(nraddr))
+      return True;
+
    
    verbosity = 0;
    if (debugging_translation) {
@@ -1432,7 +1462,10 @@ Bool VG_(translate) ( ThreadId tid,
    vta.preamble_function = preamble_fn;
    vta.traceflags        = verbosity;
    vta.sigill_diag       = VG_(clo_sigill_diag);
-   vta.addProfInc        = VG_(clo_profyle_sbs) && kind != T_NoRedir;
+   vta.addProfInc        = (VG_(clo_profyle_sbs)
+                            || (VG_(clo_hot_sb_threshold) > 0
+                                && trace_targets == NULL))
+                           && kind != T_NoRedir;
 
    if (allow_redirection) {
       vta.disp_cp_chain_me_to_slowEP
@@ -1463,6 +1496,11 @@ Bool VG_(translate) ( ThreadId tid,
       VG_(am_set_segment_hasT)( vge.base[i] );
    }
 
+   if (trace_targets != NULL && !debugging_translation) {
+      n_hot_traces++;
+      n_hot_trace_extents += vge.n_used;
+   }
+
    
    vg_assert(tmpbuf_used > 0 && tmpbuf_used < 65536);
 
@@ -1483,6 +1521,10 @@ Bool VG_(translate) ( ThreadId tid,
                                 tres.n_sc_extents > 0,
                                 tres.offs_profInc,
                                 tres.n_guest_instrs );
+          if (kind == T_Normal && tres.n_sc_extents == 0
+              && tres.offs_profInc == -1)
+             VG_(transcache_record)( &vge, nraddr, &tmpbuf[0], tmpbuf_used,
+                                     tres.n_guest_instrs );
       } else {
           vg_assert(tres.offs_profInc == -1); 
           VG_(add_to_unredir_transtab)( &vge,
@@ -1495,3 +1537,64 @@ Bool VG_(translate) ( ThreadId tid,
    return True;
 }
 
+
+/* Re-translate the hot superblock at 'nraddr' as a trace: chase
+   conditional branches too, but only along edges its translation was
+   chained through, unroll loops further, and remove redundant GETs
+   (including the tool's shadow ones) after instrumentation. */
+static Bool translate_hot_trace ( ThreadId tid,
+                                  Addr     nraddr,
+                                  ULong    bbs_done )
+{
+   Addr       targets[N_TRACE_TARGETS];
+   UInt       n_targets;
+   VexControl vcon;
+   Bool       ok;
+
+   if (!VG_(discard_hot_translation)( nraddr, VG_(clo_hot_sb_threshold),
+                                      targets, &n_targets,
+                                      N_TRACE_TARGETS ))
+      return False;
+
+   vcon = VG_(clo_vex_control);
+   /* Tools that need each superblock's IR to match its guest
+      instructions one to one (callgrind, exp-sgcheck) set the unroll
+      threshold to 0; their traces must not be unrolled either. */
+   if (vcon.iropt_unroll_thresh > 0)
+      vcon.iropt_unroll_thresh = 400;
+   vcon.iropt_post_instr_getrm = True;
+   if (vcon.guest_chase_thresh > 0) {
+      vcon.guest_chase_thresh = vcon.guest_max_insns - 1;
+      vcon.guest_chase_cond   = True;
+   }
+   LibVEX_Update_Control( &vcon );
+   trace_targets   = targets;
+   n_trace_targets = n_targets;
+
+   ok = VG_(translate)( tid, nraddr, False, 0, bbs_done, True );
+
+   trace_targets   = NULL;
+   n_trace_targets = 0;
+   LibVEX_Update_Control( &VG_(clo_vex_control) );
+   return ok;
+}
+
+#define N_HOT_TRACES 8
+
+void VG_(translate_hot_traces) ( ThreadId tid,
+                                 Addr     nraddr,
+                                 ULong    bbs_done )
+{
+   Addr hot[N_HOT_TRACES];
+   UInt i, n_hot;
+
+   if (VG_(clo_hot_sb_threshold) == 0 || VG_(clo_profyle_sbs))
+      return;
+
+   n_hot = VG_(find_hot_translations)( nraddr, VG_(clo_hot_sb_threshold),
+                                       hot, N_HOT_TRACES );
+   for (i = 0; i < n_hot; i++)
+      if (!translate_hot_trace( tid, hot[i], bbs_done ))
+         break;
+}
+
@@ -40,6 +40,8 @@
 #include "pub_core_mallocfree.h" 
 #include "pub_core_xarray.h"
 #include "pub_core_dispatch.h"   
+#include "pub_core_scheduler.h"
+#include "pub_core_threadstate.h"
 
 
 #define DEBUG_TRANSTAB 0
@@ -51,6 +53,8 @@ static SECno n_sectors = 0;
 
 UInt VG_(clo_avg_transtab_entry_size) = 0;
 
+UInt VG_(clo_hot_sb_threshold) = 0;
+
 #define N_HTTES_PER_SECTOR    65521
 
 #define EC2TTE_DELETED  0xFFFF 
@@ -248,6 +252,12 @@ static SECno sector_search_order[MAX_N_SECTORS];
  __attribute__((aligned(16)))
            FastCacheEntry VG_(tt_fast)[VG_TT_FAST_SIZE];
 
+/* With --parallel-threads=yes each thread has a fast cache of its own,
+   indexed by ThreadId and allocated on first use, so that a thread can
+   fill it on a miss without stopping the threads running in parallel.
+   Otherwise all threads share VG_(tt_fast). */
+static FastCacheEntry** tt_fast_of_thread = NULL;
+
 static Bool init_done = False;
 
 
@@ -584,6 +594,7 @@ void VG_(tt_tc_do_chaining) ( void* from__patch_addr,
    VG_(machine_get_VexArchInfo)( &arch_host, &archinfo_host );
    VexEndness endness_host = archinfo_host.endness;
 
+   VG_(stop_parallel_threads)();
    
    
    
@@ -1113,27 +1124,70 @@ static inline HTTno HASH_TT ( Addr key )
    return (HTTno)(k32 % N_HTTES_PER_SECTOR);
 }
 
+static void invalidateFastCacheEntries ( FastCacheEntry* cache )
+{
+   UInt j;
+   vg_assert(VG_TT_FAST_SIZE > 0 && (VG_TT_FAST_SIZE % 4) == 0);
+   for (j = 0; j < VG_TT_FAST_SIZE; j += 4) {
+      cache[j+0].guest = TRANSTAB_BOGUS_GUEST_ADDR;
+      cache[j+1].guest = TRANSTAB_BOGUS_GUEST_ADDR;
+      cache[j+2].guest = TRANSTAB_BOGUS_GUEST_ADDR;
+      cache[j+3].guest = TRANSTAB_BOGUS_GUEST_ADDR;
+   }
+
+   vg_assert(j == VG_TT_FAST_SIZE);
+}
+
+FastCacheEntry* VG_(tt_fast_for) ( ThreadId tid )
+{
+   vg_assert(tid >= 1 && tid < VG_N_THREADS);
+   if (!VG_(clo_parallel_threads))
+      return VG_(tt_fast);
+
+   if (tt_fast_of_thread == NULL) {
+      tt_fast_of_thread = ttaux_malloc("transtab.tt_fast_of_thread",
+                                       VG_N_THREADS * sizeof(FastCacheEntry*));
+      VG_(memset)(tt_fast_of_thread, 0,
+                  VG_N_THREADS * sizeof(FastCacheEntry*));
+   }
+   if (tt_fast_of_thread[tid] == NULL) {
+      SysRes sres = VG_(am_mmap_anon_float_valgrind)( sizeof(VG_(tt_fast)) );
+      if (sr_isError(sres)) {
+         VG_(out_of_memory_NORETURN)("VG_(tt_fast_for)",
+                                     sizeof(VG_(tt_fast)));
+         /*NOTREACHED*/
+      }
+      tt_fast_of_thread[tid] = (FastCacheEntry*)(Addr)sr_Res(sres);
+      invalidateFastCacheEntries(tt_fast_of_thread[tid]);
+   }
+   return tt_fast_of_thread[tid];
+}
+
+/* Fills in the fast cache of the running thread only, so there is no
+   need to stop the threads running in parallel: none of them reads it. */
 static void setFastCacheEntry ( Addr key, ULong* tcptr )
 {
-   UInt cno = (UInt)VG_TT_FAST_HASH(key);
-   VG_(tt_fast)[cno].guest = key;
-   VG_(tt_fast)[cno].host  = (Addr)tcptr;
+   UInt            cno   = (UInt)VG_TT_FAST_HASH(key);
+   ThreadId        tid   = VG_(running_tid);
+   FastCacheEntry* cache = tid == VG_INVALID_THREADID
+                              ? VG_(tt_fast) : VG_(tt_fast_for)(tid);
+   cache[cno].guest = key;
+   cache[cno].host  = (Addr)tcptr;
    n_fast_updates++;
-   vg_assert(VG_(tt_fast)[cno].guest != TRANSTAB_BOGUS_GUEST_ADDR);
+   vg_assert(cache[cno].guest != TRANSTAB_BOGUS_GUEST_ADDR);
 }
 
 static void invalidateFastCache ( void )
 {
-   UInt j;
-   vg_assert(VG_TT_FAST_SIZE > 0 && (VG_TT_FAST_SIZE % 4) == 0);
-   for (j = 0; j < VG_TT_FAST_SIZE; j += 4) {
-      VG_(tt_fast)[j+0].guest = TRANSTAB_BOGUS_GUEST_ADDR;
-      VG_(tt_fast)[j+1].guest = TRANSTAB_BOGUS_GUEST_ADDR;
-      VG_(tt_fast)[j+2].guest = TRANSTAB_BOGUS_GUEST_ADDR;
-      VG_(tt_fast)[j+3].guest = TRANSTAB_BOGUS_GUEST_ADDR;
+   ThreadId tid;
+   VG_(stop_parallel_threads)();
+   invalidateFastCacheEntries(VG_(tt_fast));
+   if (tt_fast_of_thread != NULL) {
+      for (tid = 1; tid < VG_N_THREADS; tid++) {
+         if (tt_fast_of_thread[tid] != NULL)
+            invalidateFastCacheEntries(tt_fast_of_thread[tid]);
+      }
    }
-
-   vg_assert(j == VG_TT_FAST_SIZE);
    n_fast_flushes++;
 }
 
@@ -1237,6 +1291,7 @@ static void initialiseSector ( SECno sno )
    } else {
 
       
+      VG_(stop_parallel_threads)();
       if (VG_(clo_stats) || VG_(debugLog_getLevel)() >= 1)
          VG_(dmsg)("transtab: " "recycle  sector %d\n", sno);
       n_sectors_recycled++;
@@ -1580,6 +1635,7 @@ static void delete_tte ( Sector* sec, SECno secNo, TTEno tteno,
 
    
    vg_assert(sec == &sectors[secNo]);
+   VG_(stop_parallel_threads)();
 
    vg_assert(tteno >= 0 && tteno < N_TTES_PER_SECTOR);
    tte = &sec->tt[tteno];
@@ -1797,6 +1853,110 @@ void VG_(discard_translations) ( Addr guest_start, ULong range,
    }
 }
 
+static void add_trace_target ( Addr* targets, UInt* n_targets,
+                               UInt max_targets, Addr addr )
+{
+   UInt i;
+   for (i = 0; i < *n_targets; i++)
+      if (targets[i] == addr)
+         return;
+   if (*n_targets < max_targets)
+      targets[(*n_targets)++] = addr;
+}
+
+static void add_trace_targets ( TTEntry* tte, Int depth, Addr* targets,
+                                UInt* n_targets, UInt max_targets )
+{
+   UWord i, n;
+
+   for (i = 0; i < tte->vge.n_used; i++)
+      add_trace_target(targets, n_targets, max_targets, tte->vge.base[i]);
+
+   n = OutEdgeArr__size(&tte->out_edges);
+   for (i = 0; i < n; i++) {
+      OutEdge* oe     = OutEdgeArr__index(&tte->out_edges, i);
+      TTEntry* to_tte = index_tte(oe->to_sNo, oe->to_tteNo);
+      if (depth > 0)
+         add_trace_targets(to_tte, depth-1, targets, n_targets, max_targets);
+      else
+         add_trace_target(targets, n_targets, max_targets, to_tte->entry);
+   }
+}
+
+#define N_HOT_SEARCH 32
+
+/* Returns in 'hot' the entries of the translations that have run at
+   least 'threshold' times, among the one for 'entry' and those
+   reachable from it through chained jumps. */
+UInt VG_(find_hot_translations) ( Addr entry, ULong threshold,
+                                  Addr* hot, UInt max_hot )
+{
+   SECno sNos[N_HOT_SEARCH];
+   TTEno tteNos[N_HOT_SEARCH];
+   UInt  n_seen, n_hot, i, j;
+   UWord e, n;
+
+   vg_assert(init_done);
+
+   if (!VG_(search_transtab)(NULL, &sNos[0], &tteNos[0], entry, False))
+      return 0;
+   n_seen = 1;
+   n_hot  = 0;
+
+   for (i = 0; i < n_seen && n_hot < max_hot; i++) {
+      TTEntry* tte = index_tte(sNos[i], tteNos[i]);
+      if (tte->usage.prof.count >= threshold)
+         hot[n_hot++] = tte->entry;
+      n = OutEdgeArr__size(&tte->out_edges);
+      for (e = 0; e < n && n_seen < N_HOT_SEARCH; e++) {
+         OutEdge* oe = OutEdgeArr__index(&tte->out_edges, e);
+         for (j = 0; j < n_seen; j++)
+            if (sNos[j] == oe->to_sNo && tteNos[j] == oe->to_tteNo)
+               break;
+         if (j == n_seen) {
+            sNos[n_seen]   = oe->to_sNo;
+            tteNos[n_seen] = oe->to_tteNo;
+            n_seen++;
+         }
+      }
+   }
+   return n_hot;
+}
+
+/* If the translation for 'entry' has run at least 'threshold' times,
+   discard it and return in 'targets' the guest addresses its trace
+   may run through: the extents of it and of the translations it is
+   chained to, and the entries these are chained to in turn. */
+Bool VG_(discard_hot_translation) ( Addr entry, ULong threshold,
+                                    Addr* targets, UInt* n_targets,
+                                    UInt max_targets )
+{
+   SECno    sNo;
+   TTEno    tteNo;
+   TTEntry* tte;
+
+   vg_assert(init_done);
+
+   if (!VG_(search_transtab)(NULL, &sNo, &tteNo, entry, False))
+      return False;
+   tte = index_tte(sNo, tteNo);
+   if (tte->usage.prof.count < threshold)
+      return False;
+
+   *n_targets = 0;
+   add_trace_targets(tte, 1, targets, n_targets, max_targets);
+
+   VexArch     arch_host = VexArch_INVALID;
+   VexArchInfo archinfo_host;
+   VG_(bzero_inline)(&archinfo_host, sizeof(archinfo_host));
+   VG_(machine_get_VexArchInfo)( &arch_host, &archinfo_host );
+   VexEndness endness_host = archinfo_host.endness;
+
+   delete_tte(&sectors[sNo], sNo, tteNo, arch_host, endness_host);
+   invalidateFastCache();
+   return True;
+}
+
 Bool  VG_(ok_to_discard_translations) = False;
 
 void VG_(discard_translations_safely) ( Addr  start, SizeT len,
@@ -1888,6 +2048,7 @@ void VG_(add_to_unredir_transtab)( const VexGuestExtents* vge,
 
    if (i >= N_UNREDIR_TT || code_szQ > (N_UNREDIR_TCQ - unredir_tc_used)) {
       
+      VG_(stop_parallel_threads)();
       init_unredir_tt_tc();
       i = 0;
    }
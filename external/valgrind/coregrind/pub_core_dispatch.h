@@ -34,7 +34,8 @@
 
 void VG_(disp_run_translations)( HWord* two_words,
                                  volatile void*  guest_state, 
-                                 Addr   host_addr );
+                                 Addr   host_addr,
+                                 const void* fast_cache );
 
 void VG_(disp_cp_chain_me_to_slowEP)(void);
 void VG_(disp_cp_chain_me_to_fastEP)(void);
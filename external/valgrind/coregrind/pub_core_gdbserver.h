@@ -50,6 +50,8 @@ Bool VG_(gdbserver_point) (PointKind kind, Bool insert,
 
 Bool VG_(has_gdbserver_breakpoint) (Addr addr);
 
+VgVgdb VG_(gdbserver_instrumentation_needed) (const VexGuestExtents* vge);
+
 extern void VG_(invoke_gdbserver) ( int check );
 
 extern Bool VG_(gdbserver_report_signal) (vki_siginfo_t *info, ThreadId tid);
@@ -59,9 +59,6 @@ extern void  VG_(core_panic_at)   ( const HChar* str, const UnwindStartRegs* );
 
 extern void VG_(client_exit)( Int status );
 
-__attribute__ ((__noreturn__))
-extern void VG_(exit_now)( Int status );
-
 extern void VG_(unimplemented) ( const HChar* msg )
             __attribute__((__noreturn__));
 
@@ -138,6 +138,7 @@ extern UInt VG_(clo_sim_hints);
 extern Bool VG_(clo_sym_offsets);
 extern Bool VG_(clo_read_inline_info);
 extern Bool VG_(clo_read_var_info);
+extern Bool VG_(clo_lazy_debuginfo);
 extern const HChar* VG_(clo_prefix_to_strip);
 
 /* An array of strings harvested from --require-text-symbol= 
@@ -190,6 +191,12 @@ extern UInt VG_(clo_num_transtab_sectors);
 
 extern UInt VG_(clo_avg_transtab_entry_size);
 
+extern const HChar* VG_(clo_translation_cache_dir);
+
+extern UInt VG_(clo_hot_sb_threshold);
+
+extern Bool VG_(clo_parallel_threads);
+
 extern Addr VG_(clo_aspacem_minAddr);
 
 extern Word VG_(clo_valgrind_stacksize);
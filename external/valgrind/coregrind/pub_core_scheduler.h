@@ -69,6 +69,12 @@ extern void VG_(print_scheduler_stats) ( void );
 
 extern Bool VG_(in_generated_code);
 
+extern Bool VG_(stop_running_in_parallel) ( ThreadId tid );
+
+extern void VG_(resume_running_in_parallel) ( ThreadId tid );
+
+extern void VG_(stop_parallel_threads) ( void );
+
 extern void VG_(sanity_check_general) ( Bool force_expensive );
 
 #endif   
@@ -271,6 +271,8 @@ typedef struct {
    Bool               sched_jmpbuf_valid;
    VG_MINIMAL_JMP_BUF(sched_jmpbuf);
 
+   volatile Bool in_parallel;
+
    
    HChar *thread_name;
 }
@@ -74,6 +74,8 @@ typedef
       Bool malloc_replacement;
       Bool xml_output;
       Bool final_IR_tidy_pass;
+      Bool persistent_translations;
+      Bool thread_safe_instrumentation;
    } 
    VgNeeds;
 
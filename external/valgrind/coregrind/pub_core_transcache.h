@@ -0,0 +1,48 @@
+
+
+/*
+   This file is part of Valgrind, a dynamic binary instrumentation
+   framework.
+
+   Copyright (C) 2015-2015 The Android Open Source Project
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+   02111-1307, USA.
+
+   The GNU General Public License is contained in the file COPYING.
+*/
+
+#ifndef __PUB_CORE_TRANSCACHE_H
+#define __PUB_CORE_TRANSCACHE_H
+
+#include "pub_core_basics.h"
+#include "libvex.h"
+
+extern void VG_(transcache_init) ( void );
+
+extern Bool VG_(transcache_reload) ( Addr nraddr );
+
+extern void VG_(transcache_record) ( const VexGuestExtents* vge,
+                                     Addr         nraddr,
+                                     const UChar* code,
+                                     UInt         code_len,
+                                     UInt         n_guest_instrs );
+
+extern void VG_(transcache_save) ( void );
+
+extern void VG_(transcache_print_stats) ( void );
+
+#endif
+
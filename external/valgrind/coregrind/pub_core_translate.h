@@ -39,6 +39,11 @@ Bool VG_(translate) ( ThreadId tid,
                       ULong    bbs_done,
                       Bool     allow_redirection );
 
+extern
+void VG_(translate_hot_traces) ( ThreadId tid,
+                                 Addr     nraddr,
+                                 ULong    bbs_done );
+
 extern void VG_(print_translation_stats) ( void );
 
 #endif   
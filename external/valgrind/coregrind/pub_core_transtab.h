@@ -43,6 +43,10 @@ typedef
 extern __attribute__((aligned(16)))
        FastCacheEntry VG_(tt_fast) [VG_TT_FAST_SIZE];
 
+/* The fast cache the dispatcher uses for thread tid: VG_(tt_fast),
+   unless --parallel-threads=yes gives each thread its own. */
+extern FastCacheEntry* VG_(tt_fast_for) ( ThreadId tid );
+
 #define TRANSTAB_BOGUS_GUEST_ADDR ((Addr)1)
 
 
@@ -92,6 +96,13 @@ extern Bool VG_(search_transtab) ( Addr*  res_hcode,
 extern void VG_(discard_translations) ( Addr  start, ULong range,
                                         const HChar* who );
 
+extern UInt VG_(find_hot_translations) ( Addr  entry, ULong threshold,
+                                         Addr* hot, UInt max_hot );
+
+extern Bool VG_(discard_hot_translation) ( Addr  entry, ULong threshold,
+                                           Addr* targets, UInt* n_targets,
+                                           UInt  max_targets );
+
 extern void VG_(print_tt_tc_stats) ( void );
 
 extern UInt VG_(get_bbs_translated) ( void );
@@ -33,6 +33,15 @@
 #define VG_TT_FAST_SIZE (1 << VG_TT_FAST_BITS)
 #define VG_TT_FAST_MASK ((VG_TT_FAST_SIZE) - 1)
 
+/* Whether VG_(disp_run_translations) looks up indirect jumps in the fast
+   cache it is passed, rather than always in VG_(tt_fast).  Only then can
+   threads run in parallel, each with a cache of its own. */
+#if defined(VGP_amd64_linux)
+#  define VG_TT_FAST_PER_THREAD 1
+#else
+#  define VG_TT_FAST_PER_THREAD 0
+#endif
+
 
 #if defined(VGA_x86) || defined(VGA_amd64)
 #  define VG_TT_FAST_HASH(_addr)  ((((UWord)(_addr))     ) & VG_TT_FAST_MASK)
@@ -2225,6 +2225,39 @@ static VtsID vts_tab_freelist = VtsID_INVALID;
 
 static Word vts_next_GC_at = 1000;
 
+static ThrID* vts_owner = NULL;
+static UWord  vts_owner_size = 0;
+
+static ULong stats__vts_owner_hits = 0;
+
+static void VtsID__set_owner ( VtsID ii, Thr* thr )
+{
+   if (UNLIKELY(ii >= vts_owner_size)) {
+      UWord  new_size = vts_owner_size == 0 ? 1024 : 2 * vts_owner_size;
+      ThrID* new_owner;
+      while (new_size <= ii)
+         new_size *= 2;
+      new_owner = HG_(zalloc)( "libhb.VtsID__set_owner.1",
+                               new_size * sizeof(ThrID) );
+      if (vts_owner) {
+         VG_(memcpy)( new_owner, vts_owner, vts_owner_size * sizeof(ThrID) );
+         HG_(free)( vts_owner );
+      }
+      vts_owner = new_owner;
+      vts_owner_size = new_size;
+   }
+   vts_owner[ii] = thr->thrid;
+}
+
+static inline Bool VtsID__is_owned_by ( VtsID ii, const Thr* thr )
+{
+   if (LIKELY(ii < vts_owner_size && vts_owner[ii] == thr->thrid)) {
+      stats__vts_owner_hits++;
+      return True;
+   }
+   return False;
+}
+
 static void vts_tab_init ( void )
 {
    vts_tab = VG_(newXA)( HG_(zalloc), "libhb.vts_tab_init.1",
@@ -2314,6 +2347,8 @@ static VtsID vts_tab__find__or__clone_and_add ( VTS* cand )
       ie->rc = 0;
       ie->u.freelink = VtsID_INVALID;
       in_tab->id = ii;
+      if (ii < vts_owner_size)
+         vts_owner[ii] = 0;
       return ii;
    }
 }
@@ -2600,6 +2635,9 @@ static void vts_tab__do_GC ( Bool show_stats )
    }
    VG_(doneIterFM)( map_shmem );
 
+   if (vts_owner)
+      VG_(memset)( vts_owner, 0, vts_owner_size * sizeof(ThrID) );
+
    Thread* hgthread = get_admin_threads();
    tl_assert(hgthread);
    while (hgthread) {
@@ -2613,6 +2651,7 @@ static void vts_tab__do_GC ( Bool show_stats )
       }
       remap_VtsID( vts_tab, new_tab, &hbthr->viR );
       remap_VtsID( vts_tab, new_tab, &hbthr->viW );
+      VtsID__set_owner( hbthr->viW, hbthr );
       hgthread = hgthread->admin;
    }
 
@@ -2701,12 +2740,12 @@ static inline UInt hash_VtsIDs ( VtsID vi1, VtsID vi2, UInt nTab ) {
    return hash % nTab;
 }
 
-#define N_CMPLEQ_CACHE 1023
+#define N_CMPLEQ_CACHE 8191
 static
    struct { VtsID vi1; VtsID vi2; Bool leq; }
    cmpLEQ_cache[N_CMPLEQ_CACHE];
 
-#define N_JOIN2_CACHE 1023
+#define N_JOIN2_CACHE 8191
 static
    struct { VtsID vi1; VtsID vi2; VtsID res; }
    join2_cache[N_JOIN2_CACHE];
@@ -4112,11 +4151,14 @@ static inline SVal msmcread ( SVal svOld,
       VtsID tviW  = acc_thr->viW;
       VtsID rmini = SVal__unC_Rmin(svOld);
       VtsID wmini = SVal__unC_Wmin(svOld);
-      Bool  leq   = VtsID__cmpLEQ(rmini,tviR);
+      Bool  leq   = VtsID__is_owned_by(rmini, acc_thr)
+                    || VtsID__cmpLEQ(rmini,tviR);
       if (LIKELY(leq)) {
          
          
-         svNew = SVal__mkC( rmini, VtsID__join2(wmini, tviW) );
+         svNew = SVal__mkC( rmini,
+                            VtsID__is_owned_by(wmini, acc_thr)
+                               ? tviW : VtsID__join2(wmini, tviW) );
          goto out;
       } else {
          
@@ -4172,7 +4214,8 @@ static inline SVal msmcwrite ( SVal svOld,
    if (LIKELY(SVal__isC(svOld))) {
       VtsID tviW  = acc_thr->viW;
       VtsID wmini = SVal__unC_Wmin(svOld);
-      Bool  leq   = VtsID__cmpLEQ(wmini,tviW);
+      Bool  leq   = VtsID__is_owned_by(wmini, acc_thr)
+                    || VtsID__cmpLEQ(wmini,tviW);
       if (LIKELY(leq)) {
          
          svNew = SVal__mkC( tviW, tviW );
@@ -5184,6 +5227,7 @@ Thr* libhb_init (
    thr->viW = vi;
    VtsID__rcinc(thr->viR);
    VtsID__rcinc(thr->viW);
+   VtsID__set_owner(thr->viW, thr);
 
    show_thread_state("  root", thr);
    return thr;
@@ -5199,6 +5243,7 @@ Thr* libhb_create ( Thr* parent )
    Filter__clear(child->filter, "libhb_create(child)");
    VtsID__rcinc(child->viR);
    VtsID__rcinc(child->viW);
+   VtsID__set_owner(child->viW, child);
 
    tl_assert(VtsID__indexAt( child->viR, child ) == 1);
    tl_assert(VtsID__indexAt( child->viW, child ) == 1);
@@ -5211,6 +5256,7 @@ Thr* libhb_create ( Thr* parent )
    Filter__clear(parent->filter, "libhb_create(parent)");
    VtsID__rcinc(parent->viR);
    VtsID__rcinc(parent->viW);
+   VtsID__set_owner(parent->viW, parent);
    note_local_Kw_n_stack_for( parent );
 
    show_thread_state(" child", child);
@@ -5305,6 +5351,8 @@ void libhb_shutdown ( Bool show_stats )
                   stats__cmpLEQ_queries, stats__cmpLEQ_misses);
       VG_(printf)("   libhb: %'13llu join2  queries (%'llu misses)\n",
                   stats__join2_queries, stats__join2_misses);
+      VG_(printf)("   libhb: %'13llu clock queries answered by owner\n",
+                  stats__vts_owner_hits);
 
       VG_(printf)("%s","\n");
       VG_(printf)("   libhb: VTSops: tick %'lu,  join %'lu,  cmpLEQ %'lu\n",
@@ -5526,6 +5574,7 @@ void libhb_so_send ( Thr* thr, SO* so, Bool strong_send )
    }
    VtsID__rcinc(thr->viR);
    VtsID__rcinc(thr->viW);
+   VtsID__set_owner(thr->viW, thr);
 
    if (strong_send)
       show_thread_state("s-send", thr);
@@ -5553,6 +5602,7 @@ void libhb_so_recv ( Thr* thr, SO* so, Bool strong_recv )
          VtsID__rcdec(thr->viW);
          thr->viW = VtsID__join2( thr->viW, so->viW );
          VtsID__rcinc(thr->viW);
+         VtsID__set_owner(thr->viW, thr);
 
          
          
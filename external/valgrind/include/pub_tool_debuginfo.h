@@ -176,6 +176,7 @@ Addr          VG_(DebugInfo_get_got_avma)    ( const DebugInfo *di );
 SizeT         VG_(DebugInfo_get_got_size)    ( const DebugInfo *di );
 const HChar*  VG_(DebugInfo_get_soname)      ( const DebugInfo *di );
 const HChar*  VG_(DebugInfo_get_filename)    ( const DebugInfo *di );
+const HChar*  VG_(DebugInfo_get_buildid)     ( const DebugInfo *di );
 PtrdiffT      VG_(DebugInfo_get_text_bias)   ( const DebugInfo *di );
 
 const DebugInfo* VG_(next_DebugInfo)    ( const DebugInfo *di );
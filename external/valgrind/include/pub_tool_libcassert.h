@@ -49,6 +49,9 @@
 __attribute__ ((__noreturn__))
 extern void VG_(exit)( Int status );
 
+__attribute__ ((__noreturn__))
+extern void VG_(exit_now)( Int status );
+
 __attribute__ ((__noreturn__))
 extern void  VG_(tool_panic) ( const HChar* str );
 
@@ -79,6 +79,7 @@ extern UInt    VG_(fprintf)  ( VgFile *fp, const HChar *format, ... )
                                PRINTF_CHECK(2, 3);
 extern UInt    VG_(vfprintf) ( VgFile *fp, const HChar *format, va_list vargs )
                                PRINTF_CHECK(2, 0);
+extern void    VG_(fwrite)   ( VgFile *fp, const void *buf, SizeT nbytes );
 
 extern UInt VG_(emit) ( const HChar* format, ... ) PRINTF_CHECK(1, 2);
 
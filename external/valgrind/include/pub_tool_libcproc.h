@@ -44,6 +44,7 @@ extern const HChar* VG_(LD_PRELOAD_var_name);
 extern Int  VG_(waitpid)( Int pid, Int *status, Int options );
 extern Int  VG_(system) ( const HChar* cmd );
 extern Int  VG_(fork)   ( void);
+extern Int  VG_(fork_nosigchld) ( void );
 extern void VG_(execv)  ( const HChar* filename, HChar** argv );
 extern Int  VG_(sysctl) ( Int *name, UInt namelen, void *oldp, SizeT *oldlenp, void *newp, SizeT newlen );
 
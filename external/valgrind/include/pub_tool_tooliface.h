@@ -330,6 +330,10 @@ extern void VG_(needs_xml_output) ( void );
 
 extern void VG_(needs_final_IR_tidy_pass) ( IRSB*(*final_tidy)(IRSB*) );
 
+extern void VG_(needs_persistent_translations) ( void );
+
+extern void VG_(needs_thread_safe_instrumentation) ( void );
+
 
 
 typedef
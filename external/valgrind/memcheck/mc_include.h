@@ -107,6 +107,7 @@ void MC_(copy_address_range_state) ( Addr src, Addr dst, SizeT len );
 
 void MC_(print_malloc_stats) ( void );
 SizeT MC_(get_cmalloc_n_frees) ( void );
+SizeT MC_(get_cmalloc_n_mallocs) ( void );
 
 void* MC_(malloc)               ( ThreadId tid, SizeT n );
 void* MC_(__builtin_new)        ( ThreadId tid, SizeT n );
@@ -143,8 +143,8 @@ find_active_chunks(Int* pn_chunks)
    
    
    MC_Mempool *mp;
-   MC_Chunk **mallocs, **chunks, *mc;
-   UInt n_mallocs, n_chunks, m, s;
+   MC_Chunk **mallocs, **chunks, **pool_chunks = NULL, *mc;
+   UInt n_mallocs, n_chunks, n_pool_chunks, m, s, p;
    Bool *malloc_chunk_holds_a_pool_chunk;
 
    
@@ -210,17 +210,39 @@ find_active_chunks(Int* pn_chunks)
          chunks[s++] = mc;
       }
    }
+   n_pool_chunks = s;
+   if (n_pool_chunks > 0) {
+      pool_chunks = VG_(malloc)("mc.fas.3",
+                                sizeof(VgHashNode*) * n_pool_chunks);
+      VG_(memcpy)(pool_chunks, chunks, sizeof(VgHashNode*) * n_pool_chunks);
+      VG_(ssort)(pool_chunks, n_pool_chunks, sizeof(VgHashNode*),
+                 compare_MC_Chunks);
+   }
+
+   
+   s = 0;
+   p = 0;
    for (m = 0; m < n_mallocs; ++m) {
-      if (!malloc_chunk_holds_a_pool_chunk[m]) {
+      if (malloc_chunk_holds_a_pool_chunk[m])
+         continue;
+      while (p < n_pool_chunks && pool_chunks[p]->data <= mallocs[m]->data) {
          tl_assert(s < n_chunks);
-         chunks[s++] = mallocs[m];
+         chunks[s++] = pool_chunks[p++];
       }
+      tl_assert(s < n_chunks);
+      chunks[s++] = mallocs[m];
+   }
+   while (p < n_pool_chunks) {
+      tl_assert(s < n_chunks);
+      chunks[s++] = pool_chunks[p++];
    }
    tl_assert(s == n_chunks);
 
    
    VG_(free)(mallocs);
    VG_(free)(malloc_chunk_holds_a_pool_chunk);
+   if (pool_chunks)
+      VG_(free)(pool_chunks);
 
    *pn_chunks = n_chunks;
 
@@ -249,6 +271,12 @@ typedef
 static MC_Chunk** lc_chunks;
 static Int        lc_n_chunks;
 static SizeT lc_chunks_n_frees_marker;
+static SizeT lc_chunks_n_mallocs_marker;
+static Bool  lc_chunks_reusable;
+
+static Addr* lc_chunk_starts;
+static Addr  lc_chunks_min;
+static Addr  lc_chunks_max;
 static LC_Extra* lc_extras;
 
 static OSet*        lr_table;
@@ -284,6 +312,32 @@ static SizeT MC_(bytes_heuristically_reachable)[N_LEAK_CHECK_HEURISTICS]
 static SizeT MC_(blocks_heuristically_reachable)[N_LEAK_CHECK_HEURISTICS]
                                                 = {0,0,0,0};
 
+static Int lc_find_chunk ( Addr ptr )
+{
+   const Addr* base = lc_chunk_starts;
+   Int n = lc_n_chunks;
+   Int half, ch_no;
+   MC_Chunk* ch;
+
+   if (n == 0 || ptr < lc_chunks_min || ptr > lc_chunks_max)
+      return -1;
+
+   while (n > 1) {
+      half = n / 2;
+      base = base[half] <= ptr ? base + half : base;
+      n -= half;
+   }
+   ch_no = base - lc_chunk_starts;
+   ch = lc_chunks[ch_no];
+   if (ptr >= ch->data + ch->szB + (ch->szB == 0 ? 1 : 0))
+      ch_no = -1;
+
+#  if VG_DEBUG_LEAKCHECK
+   tl_assert(ch_no == find_chunk_for(ptr, lc_chunks, lc_n_chunks));
+#  endif
+   return ch_no;
+}
+
 static Bool
 lc_is_a_chunk_ptr(Addr ptr, Int* pch_no, MC_Chunk** pch, LC_Extra** pex)
 {
@@ -295,32 +349,30 @@ lc_is_a_chunk_ptr(Addr ptr, Int* pch_no, MC_Chunk** pch, LC_Extra** pex)
    
    
    
-   if (!VG_(am_is_valid_for_client)(ptr, 1, VKI_PROT_READ)) {
+   ch_no = lc_find_chunk(ptr);
+   tl_assert(ch_no >= -1 && ch_no < lc_n_chunks);
+
+   if (ch_no == -1) {
+      return False;
+   } else if (!VG_(am_is_valid_for_client)(ptr, 1, VKI_PROT_READ)) {
       return False;
    } else {
-      ch_no = find_chunk_for(ptr, lc_chunks, lc_n_chunks);
-      tl_assert(ch_no >= -1 && ch_no < lc_n_chunks);
-
-      if (ch_no == -1) {
-         return False;
-      } else {
-         
-         
-         ch = lc_chunks[ch_no];
-         ex = &(lc_extras[ch_no]);
+      
+      
+      ch = lc_chunks[ch_no];
+      ex = &(lc_extras[ch_no]);
 
-         tl_assert(ptr >= ch->data);
-         tl_assert(ptr < ch->data + ch->szB + (ch->szB==0  ? 1  : 0));
+      tl_assert(ptr >= ch->data);
+      tl_assert(ptr < ch->data + ch->szB + (ch->szB==0  ? 1  : 0));
 
-         if (VG_DEBUG_LEAKCHECK)
-            VG_(printf)("ptr=%#lx -> block %d\n", ptr, ch_no);
+      if (VG_DEBUG_LEAKCHECK)
+         VG_(printf)("ptr=%#lx -> block %d\n", ptr, ch_no);
 
-         *pch_no = ch_no;
-         *pch    = ch;
-         *pex    = ex;
+      *pch_no = ch_no;
+      *pch    = ch;
+      *pex    = ex;
 
-         return True;
-      }
+      return True;
    }
 }
 
@@ -1368,12 +1420,24 @@ void MC_(detect_memory_leaks) ( ThreadId tid, LeakCheckParams* lcp)
    detect_memory_leaks_last_heuristics = lcp->heuristics;
 
    
-   if (lc_chunks) {
-      VG_(free)(lc_chunks);
-      lc_chunks = NULL;
+   
+   
+   if (lc_chunks && lc_chunks_reusable
+       && lc_chunks_n_frees_marker == MC_(get_cmalloc_n_frees)()
+       && lc_chunks_n_mallocs_marker == MC_(get_cmalloc_n_mallocs)()
+       && VG_(HT_count_nodes)(MC_(mempool_list)) == 0) {
+      if (VG_(clo_verbosity) > 1 && !VG_(clo_xml))
+         VG_(umsg)("Reusing the block list of the previous leak search\n");
+   } else {
+      if (lc_chunks) {
+         VG_(free)(lc_chunks);
+         lc_chunks = NULL;
+      }
+      lc_chunks = find_active_chunks(&lc_n_chunks);
+      lc_chunks_n_frees_marker = MC_(get_cmalloc_n_frees)();
+      lc_chunks_n_mallocs_marker = MC_(get_cmalloc_n_mallocs)();
+      lc_chunks_reusable = VG_(HT_count_nodes)(MC_(mempool_list)) == 0;
    }
-   lc_chunks = find_active_chunks(&lc_n_chunks);
-   lc_chunks_n_frees_marker = MC_(get_cmalloc_n_frees)();
    if (lc_n_chunks == 0) {
       tl_assert(lc_chunks == NULL);
       if (lr_table != NULL) {
@@ -1393,9 +1457,6 @@ void MC_(detect_memory_leaks) ( ThreadId tid, LeakCheckParams* lcp)
    }
 
    
-   VG_(ssort)(lc_chunks, lc_n_chunks, sizeof(VgHashNode*), compare_MC_Chunks);
-
-   
    for (i = 0; i < lc_n_chunks-1; i++) {
       tl_assert( lc_chunks[i]->data <= lc_chunks[i+1]->data);
    }
@@ -1416,9 +1477,9 @@ void MC_(detect_memory_leaks) ( ThreadId tid, LeakCheckParams* lcp)
    
    
    
-   for (i = 0; i < lc_n_chunks-1; i++) {
-      MC_Chunk* ch1 = lc_chunks[i];
-      MC_Chunk* ch2 = lc_chunks[i+1];
+   for (i = 1, j = 1; i < lc_n_chunks; i++) {
+      MC_Chunk* ch1 = lc_chunks[j-1];
+      MC_Chunk* ch2 = lc_chunks[i];
 
       Addr start1    = ch1->data;
       Addr start2    = ch2->data;
@@ -1433,22 +1494,16 @@ void MC_(detect_memory_leaks) ( ThreadId tid, LeakCheckParams* lcp)
       
       
          
+         lc_chunks[j++] = ch2;
 
       } else if (start1 >= start2 && end1 <= end2 && isCustom1 && !isCustom2) {
          
          
-         for (j = i+1; j < lc_n_chunks-1; j++) {
-            lc_chunks[j] = lc_chunks[j+1];
-         }
-         lc_n_chunks--;
 
       } else if (start2 >= start1 && end2 <= end1 && isCustom2 && !isCustom1) {
          
          
-         for (j = i; j < lc_n_chunks-1; j++) {
-            lc_chunks[j] = lc_chunks[j+1];
-         }
-         lc_n_chunks--;
+         lc_chunks[j-1] = ch2;
 
       } else {
          VG_(umsg)("Block 0x%lx..0x%lx overlaps with block 0x%lx..0x%lx\n",
@@ -1462,6 +1517,23 @@ void MC_(detect_memory_leaks) ( ThreadId tid, LeakCheckParams* lcp)
          tl_assert (0);
       }
    }
+   lc_n_chunks = j;
+
+   
+   if (lc_chunk_starts) {
+      VG_(free)(lc_chunk_starts);
+      lc_chunk_starts = NULL;
+   }
+   lc_chunk_starts = VG_(malloc)( "mc.dml.1", lc_n_chunks * sizeof(Addr) );
+   lc_chunks_max = 0;
+   for (i = 0; i < lc_n_chunks; i++) {
+      MC_Chunk* ch = lc_chunks[i];
+      Addr last = ch->data + (ch->szB == 0 ? 0 : ch->szB - 1);
+      lc_chunk_starts[i] = ch->data;
+      if (last > lc_chunks_max)
+         lc_chunks_max = last;
+   }
+   lc_chunks_min = lc_chunk_starts[0];
 
    
    if (lc_extras) {
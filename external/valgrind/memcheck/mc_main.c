@@ -175,6 +175,7 @@ static ULong n_auxmap_L1_searches  = 0;
 static ULong n_auxmap_L1_cmps      = 0;
 static ULong n_auxmap_L2_searches  = 0;
 static ULong n_auxmap_L2_nodes     = 0;
+static ULong n_highmap_tables      = 0;
 
 static Int   n_sanity_cheap     = 0;
 static Int   n_sanity_expensive = 0;
@@ -408,9 +409,107 @@ static INLINE SecMap** get_secmap_low_ptr ( Addr a )
    return &primary_map[ pm_off ];
 }
 
+#if VG_WORDSIZE == 8
+
+#define HM_L1_BITS  12
+#define HM_L2_BITS  10
+#define HM_L3_BITS  10
+
+#define HM_L1_SIZE  (1 << HM_L1_BITS)
+#define HM_L2_SIZE  (1 << HM_L2_BITS)
+#define HM_L3_SIZE  (1 << HM_L3_BITS)
+
+#define MAX_HIGHMAP_ADDRESS \
+   (Addr)((((Addr)65536) << (HM_L1_BITS + HM_L2_BITS + HM_L3_BITS)) - 1)
+
+#define HM_L1_IX(_a) ((_a) >> (16 + HM_L2_BITS + HM_L3_BITS))
+#define HM_L2_IX(_a) (((_a) >> (16 + HM_L3_BITS)) & (HM_L2_SIZE-1))
+#define HM_L3_IX(_a) (((_a) >> 16) & (HM_L3_SIZE-1))
+
+typedef SecMap*    HighMapL3[HM_L3_SIZE];
+typedef HighMapL3* HighMapL2[HM_L2_SIZE];
+
+static HighMapL2* highmap_L1[HM_L1_SIZE];
+
+static HighMapL2 highmap_noaccess_L2;
+static HighMapL3 highmap_noaccess_L3;
+
+static void init_highmap ( void )
+{
+   Int i;
+   for (i = 0; i < HM_L3_SIZE; i++)
+      highmap_noaccess_L3[i] = &sm_distinguished[SM_DIST_NOACCESS];
+   for (i = 0; i < HM_L2_SIZE; i++)
+      highmap_noaccess_L2[i] = &highmap_noaccess_L3;
+   for (i = 0; i < HM_L1_SIZE; i++)
+      highmap_L1[i] = &highmap_noaccess_L2;
+}
+
+static INLINE SecMap* get_secmap_for_reading_highmap ( Addr a )
+{
+   return (*(*highmap_L1[HM_L1_IX(a)])[HM_L2_IX(a)])[HM_L3_IX(a)];
+}
+
+static SecMap** get_secmap_highmap_ptr ( Addr a )
+{
+   HighMapL2** l2p = &highmap_L1[HM_L1_IX(a)];
+   HighMapL3** l3p;
+
+   if (UNLIKELY(*l2p == &highmap_noaccess_L2)) {
+      *l2p = VG_(malloc)("mc.gshp.1", sizeof(HighMapL2));
+      VG_(memcpy)(*l2p, &highmap_noaccess_L2, sizeof(HighMapL2));
+      n_highmap_tables++;
+   }
+   l3p = &(**l2p)[HM_L2_IX(a)];
+   if (UNLIKELY(*l3p == &highmap_noaccess_L3)) {
+      *l3p = VG_(malloc)("mc.gshp.2", sizeof(HighMapL3));
+      VG_(memcpy)(*l3p, &highmap_noaccess_L3, sizeof(HighMapL3));
+      n_highmap_tables++;
+   }
+   return &(**l3p)[HM_L3_IX(a)];
+}
+
+static const HChar* check_highmap_sanity ( Word* n_secmaps_found )
+{
+   Word i, j, k;
+   for (i = 0; i < HM_L3_SIZE; i++)
+      if (highmap_noaccess_L3[i] != &sm_distinguished[SM_DIST_NOACCESS])
+         return "highmap: shared L3 table was written";
+   for (i = 0; i < HM_L2_SIZE; i++)
+      if (highmap_noaccess_L2[i] != &highmap_noaccess_L3)
+         return "highmap: shared L2 table was written";
+   for (i = 0; i < HM_L1_SIZE; i++) {
+      if (highmap_L1[i] == NULL)
+         return "highmap: NULL L1 entry";
+      if (highmap_L1[i] == &highmap_noaccess_L2)
+         continue;
+      for (j = 0; j < HM_L2_SIZE; j++) {
+         HighMapL3* l3 = (*highmap_L1[i])[j];
+         if (l3 == NULL)
+            return "highmap: NULL L2 entry";
+         if (l3 == &highmap_noaccess_L3)
+            continue;
+         for (k = 0; k < HM_L3_SIZE; k++) {
+            if ((*l3)[k] == NULL)
+               return "highmap: NULL L3 entry";
+            if (!is_distinguished_sm((*l3)[k]))
+               (*n_secmaps_found)++;
+         }
+      }
+   }
+   return NULL;
+}
+
+#endif
+
 static INLINE SecMap** get_secmap_high_ptr ( Addr a )
 {
-   AuxMapEnt* am = find_or_alloc_in_auxmap(a);
+   AuxMapEnt* am;
+#  if VG_WORDSIZE == 8
+   if (LIKELY(a <= MAX_HIGHMAP_ADDRESS))
+      return get_secmap_highmap_ptr(a);
+#  endif
+   am = find_or_alloc_in_auxmap(a);
    return &am->sm;
 }
 
@@ -428,9 +527,22 @@ static INLINE SecMap* get_secmap_for_reading_low ( Addr a )
 
 static INLINE SecMap* get_secmap_for_reading_high ( Addr a )
 {
+#  if VG_WORDSIZE == 8
+   if (LIKELY(a <= MAX_HIGHMAP_ADDRESS))
+      return get_secmap_for_reading_highmap(a);
+#  endif
    return *get_secmap_high_ptr(a);
 }
 
+static INLINE SecMap* get_secmap_for_fast_high ( Addr a, UWord szInBytes )
+{
+#  if VG_WORDSIZE == 8
+   if (LIKELY((a & (szInBytes-1)) == 0 && a <= MAX_HIGHMAP_ADDRESS))
+      return get_secmap_for_reading_highmap(a);
+#  endif
+   return NULL;
+}
+
 static INLINE SecMap* get_secmap_for_writing_low(Addr a)
 {
    SecMap** p = get_secmap_low_ptr(a);
@@ -465,6 +577,10 @@ static SecMap* maybe_get_secmap_for ( Addr a )
 {
    if (a <= MAX_PRIMARY_ADDRESS) {
       return get_secmap_for_reading_low(a);
+#  if VG_WORDSIZE == 8
+   } else if (a <= MAX_HIGHMAP_ADDRESS) {
+      return get_secmap_for_reading_highmap(a);
+#  endif
    } else {
       AuxMapEnt* am = maybe_find_in_auxmap(a);
       return am ? am->sm : NULL;
@@ -3250,13 +3366,17 @@ void mc_LOADV_128_or_256 ( ULong* res,
       SecMap* sm;
 
       if (UNLIKELY( UNALIGNED_OR_HIGH(a,nBits) )) {
-         PROF_EVENT(201, "mc_LOADV_128_or_256-slow1");
-         mc_LOADV_128_or_256_slow( res, a, nBits, isBigEndian );
-         return;
+         sm = get_secmap_for_fast_high(a, nBytes);
+         if (UNLIKELY(sm == NULL)) {
+            PROF_EVENT(201, "mc_LOADV_128_or_256-slow1");
+            mc_LOADV_128_or_256_slow( res, a, nBits, isBigEndian );
+            return;
+         }
+      } else {
+         sm = get_secmap_for_reading_low(a);
       }
 
       for (j = 0; j < nULongs; j++) {
-         sm       = get_secmap_for_reading_low(a + 8*j);
          sm_off16 = SM_OFF_16(a + 8*j);
          vabits16 = ((UShort*)(sm->vabits8))[sm_off16];
 
@@ -3309,11 +3429,14 @@ ULong mc_LOADV64 ( Addr a, Bool isBigEndian )
       SecMap* sm;
 
       if (UNLIKELY( UNALIGNED_OR_HIGH(a,64) )) {
-         PROF_EVENT(201, "mc_LOADV64-slow1");
-         return (ULong)mc_LOADVn_slow( a, 64, isBigEndian );
+         sm = get_secmap_for_fast_high(a, 8);
+         if (UNLIKELY(sm == NULL)) {
+            PROF_EVENT(201, "mc_LOADV64-slow1");
+            return (ULong)mc_LOADVn_slow( a, 64, isBigEndian );
+         }
+      } else {
+         sm = get_secmap_for_reading_low(a);
       }
-
-      sm       = get_secmap_for_reading_low(a);
       sm_off16 = SM_OFF_16(a);
       vabits16 = ((UShort*)(sm->vabits8))[sm_off16];
 
@@ -3358,12 +3481,15 @@ void mc_STOREV64 ( Addr a, ULong vbits64, Bool isBigEndian )
       SecMap* sm;
 
       if (UNLIKELY( UNALIGNED_OR_HIGH(a,64) )) {
-         PROF_EVENT(211, "mc_STOREV64-slow1");
-         mc_STOREVn_slow( a, 64, vbits64, isBigEndian );
-         return;
+         sm = get_secmap_for_fast_high(a, 8);
+         if (UNLIKELY(sm == NULL)) {
+            PROF_EVENT(211, "mc_STOREV64-slow1");
+            mc_STOREVn_slow( a, 64, vbits64, isBigEndian );
+            return;
+         }
+      } else {
+         sm = get_secmap_for_reading_low(a);
       }
-
-      sm       = get_secmap_for_reading_low(a);
       sm_off16 = SM_OFF_16(a);
       vabits16 = ((UShort*)(sm->vabits8))[sm_off16];
 
@@ -3424,11 +3550,14 @@ UWord mc_LOADV32 ( Addr a, Bool isBigEndian )
       SecMap* sm;
 
       if (UNLIKELY( UNALIGNED_OR_HIGH(a,32) )) {
-         PROF_EVENT(221, "mc_LOADV32-slow1");
-         return (UWord)mc_LOADVn_slow( a, 32, isBigEndian );
+         sm = get_secmap_for_fast_high(a, 4);
+         if (UNLIKELY(sm == NULL)) {
+            PROF_EVENT(221, "mc_LOADV32-slow1");
+            return (UWord)mc_LOADVn_slow( a, 32, isBigEndian );
+         }
+      } else {
+         sm = get_secmap_for_reading_low(a);
       }
-
-      sm      = get_secmap_for_reading_low(a);
       sm_off  = SM_OFF(a);
       vabits8 = sm->vabits8[sm_off];
 
@@ -3473,12 +3602,15 @@ void mc_STOREV32 ( Addr a, UWord vbits32, Bool isBigEndian )
       SecMap* sm;
 
       if (UNLIKELY( UNALIGNED_OR_HIGH(a,32) )) {
-         PROF_EVENT(231, "mc_STOREV32-slow1");
-         mc_STOREVn_slow( a, 32, (ULong)vbits32, isBigEndian );
-         return;
+         sm = get_secmap_for_fast_high(a, 4);
+         if (UNLIKELY(sm == NULL)) {
+            PROF_EVENT(231, "mc_STOREV32-slow1");
+            mc_STOREVn_slow( a, 32, (ULong)vbits32, isBigEndian );
+            return;
+         }
+      } else {
+         sm = get_secmap_for_reading_low(a);
       }
-
-      sm      = get_secmap_for_reading_low(a);
       sm_off  = SM_OFF(a);
       vabits8 = sm->vabits8[sm_off];
 
@@ -3539,11 +3671,14 @@ UWord mc_LOADV16 ( Addr a, Bool isBigEndian )
       SecMap* sm;
 
       if (UNLIKELY( UNALIGNED_OR_HIGH(a,16) )) {
-         PROF_EVENT(241, "mc_LOADV16-slow1");
-         return (UWord)mc_LOADVn_slow( a, 16, isBigEndian );
+         sm = get_secmap_for_fast_high(a, 2);
+         if (UNLIKELY(sm == NULL)) {
+            PROF_EVENT(241, "mc_LOADV16-slow1");
+            return (UWord)mc_LOADVn_slow( a, 16, isBigEndian );
+         }
+      } else {
+         sm = get_secmap_for_reading_low(a);
       }
-
-      sm      = get_secmap_for_reading_low(a);
       sm_off  = SM_OFF(a);
       vabits8 = sm->vabits8[sm_off];
       
@@ -3601,12 +3736,15 @@ void mc_STOREV16 ( Addr a, UWord vbits16, Bool isBigEndian )
       SecMap* sm;
 
       if (UNLIKELY( UNALIGNED_OR_HIGH(a,16) )) {
-         PROF_EVENT(251, "mc_STOREV16-slow1");
-         mc_STOREVn_slow( a, 16, (ULong)vbits16, isBigEndian );
-         return;
+         sm = get_secmap_for_fast_high(a, 2);
+         if (UNLIKELY(sm == NULL)) {
+            PROF_EVENT(251, "mc_STOREV16-slow1");
+            mc_STOREVn_slow( a, 16, (ULong)vbits16, isBigEndian );
+            return;
+         }
+      } else {
+         sm = get_secmap_for_reading_low(a);
       }
-
-      sm      = get_secmap_for_reading_low(a);
       sm_off  = SM_OFF(a);
       vabits8 = sm->vabits8[sm_off];
 
@@ -3670,11 +3808,14 @@ UWord MC_(helperc_LOADV8) ( Addr a )
       SecMap* sm;
 
       if (UNLIKELY( UNALIGNED_OR_HIGH(a,8) )) {
-         PROF_EVENT(261, "mc_LOADV8-slow1");
-         return (UWord)mc_LOADVn_slow( a, 8, False );
+         sm = get_secmap_for_fast_high(a, 1);
+         if (UNLIKELY(sm == NULL)) {
+            PROF_EVENT(261, "mc_LOADV8-slow1");
+            return (UWord)mc_LOADVn_slow( a, 8, False );
+         }
+      } else {
+         sm = get_secmap_for_reading_low(a);
       }
-
-      sm      = get_secmap_for_reading_low(a);
       sm_off  = SM_OFF(a);
       vabits8 = sm->vabits8[sm_off];
       
@@ -3712,12 +3853,15 @@ void MC_(helperc_STOREV8) ( Addr a, UWord vbits8 )
       SecMap* sm;
 
       if (UNLIKELY( UNALIGNED_OR_HIGH(a,8) )) {
-         PROF_EVENT(271, "mc_STOREV8-slow1");
-         mc_STOREVn_slow( a, 8, (ULong)vbits8, False );
-         return;
+         sm = get_secmap_for_fast_high(a, 1);
+         if (UNLIKELY(sm == NULL)) {
+            PROF_EVENT(271, "mc_STOREV8-slow1");
+            mc_STOREVn_slow( a, 8, (ULong)vbits8, False );
+            return;
+         }
+      } else {
+         sm = get_secmap_for_reading_low(a);
       }
-
-      sm      = get_secmap_for_reading_low(a);
       sm_off  = SM_OFF(a);
       vabits8 = sm->vabits8[sm_off];
 
@@ -3954,6 +4098,9 @@ static void init_shadow_memory ( void )
 
    
    init_auxmap_L1_L2();
+#  if VG_WORDSIZE == 8
+   init_highmap();
+#  endif
 
 
    
@@ -4029,6 +4176,13 @@ static Bool mc_expensive_sanity_check ( void )
       VG_(printf)("memcheck expensive sanity, auxmaps:\n\t%s", errmsg);
       return False;
    }
+#  if VG_WORDSIZE == 8
+   errmsg = check_highmap_sanity( &n_secmaps_found );
+   if (errmsg) {
+      VG_(printf)("memcheck expensive sanity, highmap:\n\t%s", errmsg);
+      return False;
+   }
+#  endif
 
    for (i = 0; i < N_PRIMARY_MAP; i++) {
       if (primary_map[i] == NULL) {
@@ -5413,6 +5567,10 @@ static void mc_post_clo_init ( void )
 #     endif
       VG_(track_new_mem_stack)     ( mc_new_mem_stack     );
       VG_(track_new_mem_stack_signal) ( mc_new_mem_w_tid_no_ECU );
+
+      
+      
+      VG_(needs_persistent_translations) ();
    }
 
    
@@ -5525,6 +5683,9 @@ static void mc_print_stats (void)
       " memcheck: auxmaps_L2: %lld searches, %lld nodes\n",
       n_auxmap_L2_searches, n_auxmap_L2_nodes
    );   
+   VG_(message)(Vg_DebugMsg,
+      " memcheck: highmap: %lld tables (%lldk) in use\n",
+      n_highmap_tables, n_highmap_tables * 8 );
 
    print_SM_info("n_issued     ", n_issued_SMs);
    print_SM_info("n_deissued   ", n_deissued_SMs);
@@ -995,4 +995,9 @@ SizeT MC_(get_cmalloc_n_frees) ( void )
    return cmalloc_n_frees;
 }
 
+SizeT MC_(get_cmalloc_n_mallocs) ( void )
+{
+   return cmalloc_n_mallocs;
+}
+
 
@@ -0,0 +1,34 @@
+/* count_big's loop runs often enough to be turned into a trace by
+   --hot-sb-threshold before it meets an undefined value; the trace must
+   still carry memcheck's instrumentation and report it. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../memcheck.h"
+
+static int count_big ( const int* a, int n )
+{
+   int i, big = 0;
+   for (i = 0; i < n; i++)
+      if (a[i] > 5000)
+         big++;
+   return big;
+}
+
+int main ( void )
+{
+   int* a = malloc(1000 * sizeof(int));
+   int  i, r, big = 0;
+
+   for (i = 0; i < 1000; i++)
+      a[i] = i;
+   for (r = 0; r < 1000; r++)
+      big += count_big(a, 1000);
+
+   VALGRIND_MAKE_MEM_UNDEFINED(&a[999], sizeof(int));
+   count_big(a, 1000);
+
+   printf("%d\n", big);
+   free(a);
+   return 0;
+}
@@ -0,0 +1,38 @@
+/* Reports the same error from three call stacks, each matched by several
+   of the overlapping suppressions in suppoverlap.supp. */
+
+#include <stdio.h>
+
+static int sink;
+
+__attribute__((noinline)) static void cond_error ( int* p )
+{
+   if (*p)
+      sink++;
+}
+
+__attribute__((noinline)) static void via_a ( void )
+{
+   int u;
+   cond_error(&u);
+}
+
+__attribute__((noinline)) static void via_b ( void )
+{
+   int u;
+   cond_error(&u);
+}
+
+__attribute__((noinline)) static void via_c ( void )
+{
+   via_b();
+}
+
+int main ( void )
+{
+   via_a();
+   via_b();
+   via_c();
+   printf("done\n");
+   return 0;
+}
@@ -62,6 +62,9 @@ static void nl_pre_clo_init(void)
                                  nl_instrument,
                                  nl_fini);
 
+   VG_(needs_persistent_translations) ();
+   VG_(needs_thread_safe_instrumentation) ();
+
    
 }
 
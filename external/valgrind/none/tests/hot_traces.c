@@ -0,0 +1,54 @@
+/* Runs a few loops often enough for --hot-sb-threshold to turn them into
+   traces, and prints results that depend on every branch taken. */
+
+#include <stdio.h>
+
+static unsigned int collatz_steps ( unsigned int n )
+{
+   unsigned int steps = 0;
+   while (n != 1) {
+      if (n & 1)
+         n = 3 * n + 1;
+      else
+         n /= 2;
+      steps++;
+   }
+   return steps;
+}
+
+static unsigned int crc32 ( const unsigned char* p, int len )
+{
+   unsigned int crc = 0xFFFFFFFF;
+   int i, j;
+   for (i = 0; i < len; i++) {
+      crc ^= p[i];
+      for (j = 0; j < 8; j++)
+         crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+   }
+   return ~crc;
+}
+
+int main ( void )
+{
+   unsigned char buf[4096];
+   unsigned int n, max = 0, arg = 0, sum = 0;
+   int i;
+
+   for (n = 1; n < 30000; n++) {
+      unsigned int s = collatz_steps(n);
+      if (s > max) {
+         max = s;
+         arg = n;
+      }
+   }
+   printf("longest collatz chain below 30000: %u (%u steps)\n", arg, max);
+
+   for (i = 0; i < (int)sizeof(buf); i++)
+      buf[i] = (unsigned char)(i * 7 + (i >> 5));
+   for (i = 0; i < 50; i++) {
+      buf[i] ^= (unsigned char)sum;
+      sum += crc32(buf, sizeof(buf));
+   }
+   printf("crc sum: %08x\n", sum);
+   return 0;
+}
@@ -0,0 +1,54 @@
+/* Runs a few busy threads, with indirect calls so that they all go
+   through their fast lookup caches, and checks that each computes the
+   same result as the main thread did on its own beforehand. */
+
+#include <pthread.h>
+#include <stdio.h>
+
+#define N_THREADS 4
+
+static unsigned int step_add ( unsigned int x ) { return x + 0x9E3779B9; }
+static unsigned int step_xor ( unsigned int x ) { return x ^ (x >> 7); }
+static unsigned int step_mul ( unsigned int x ) { return x * 2654435761u; }
+static unsigned int step_rot ( unsigned int x ) { return (x << 13) | (x >> 19); }
+
+static unsigned int (*const steps[4])(unsigned int)
+   = { step_add, step_xor, step_mul, step_rot };
+
+static unsigned int work ( unsigned int seed )
+{
+   unsigned int x = seed;
+   int i;
+   for (i = 0; i < 2000000; i++)
+      x = steps[(x >> 3) & 3](x);
+   return x;
+}
+
+static unsigned int serial[N_THREADS];
+static unsigned int parallel[N_THREADS];
+
+static void* thread_main ( void* arg )
+{
+   long t = (long)arg;
+   parallel[t] = work(t + 1);
+   return NULL;
+}
+
+int main ( void )
+{
+   pthread_t threads[N_THREADS];
+   long t;
+
+   for (t = 0; t < N_THREADS; t++)
+      serial[t] = work(t + 1);
+
+   for (t = 0; t < N_THREADS; t++)
+      pthread_create(&threads[t], NULL, thread_main, (void*)t);
+   for (t = 0; t < N_THREADS; t++)
+      pthread_join(threads[t], NULL);
+
+   for (t = 0; t < N_THREADS; t++)
+      printf("thread %ld: %08x %s\n", t, parallel[t],
+             parallel[t] == serial[t] ? "ok" : "MISMATCH");
+   return 0;
+}
@@ -0,0 +1,29 @@
+/* Does a little work in the main executable and in libc, so that a
+   second run against the same --translation-cache-dir has translations
+   to reload. */
+
+#include <stdio.h>
+#include <string.h>
+
+static unsigned int hash ( const char* p, int n )
+{
+   unsigned int h = 2166136261u;
+   int i;
+   for (i = 0; i < n; i++)
+      h = (h ^ (unsigned char)p[i]) * 16777619u;
+   return h;
+}
+
+int main ( void )
+{
+   char buf[1024];
+   unsigned int h = 0;
+   int r;
+
+   for (r = 0; r < 100; r++) {
+      memset(buf, r, sizeof(buf));
+      h += hash(buf, sizeof(buf));
+   }
+   printf("%u\n", h);
+   return 0;
+}
@@ -0,0 +1,69 @@
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define N_ITERS   200
+#define N_PRIVATE 256
+
+static pthread_mutex_t mx = PTHREAD_MUTEX_INITIALIZER;
+static long shared[64];
+static int  nr_thr;
+
+static void* worker(void* v)
+{
+   long  me = (long)v;
+   long* priv = calloc(N_PRIVATE, sizeof(long));
+   long  sum = 0;
+   int   i, k;
+
+   for (i = 0; i < N_ITERS; i++) {
+      for (k = 0; k < N_PRIVATE; k++)
+         priv[k] += k ^ i;
+
+      pthread_mutex_lock(&mx);
+      shared[i & 63] += me;
+      sum += shared[(i + me) & 63];
+      pthread_mutex_unlock(&mx);
+
+      for (k = 0; k < N_PRIVATE; k++)
+         sum += priv[k]--;
+   }
+   free(priv);
+   return (void*)sum;
+}
+
+int main(int argc, char* argv[])
+{
+   pthread_t* thr;
+   long total = 0;
+   int  i;
+
+   nr_thr = argc > 1 ? atoi(argv[1]) : 8;
+   if (nr_thr < 1)
+      nr_thr = 1;
+
+   thr = malloc(nr_thr * sizeof(pthread_t));
+   for (i = 0; i < nr_thr; i++) {
+      pthread_attr_t attr;
+      pthread_attr_init(&attr);
+      pthread_attr_setstacksize(&attr, 256 * 1024);
+      if (pthread_create(&thr[i], &attr, worker, (void*)(long)i) != 0) {
+         perror("pthread_create");
+         exit(1);
+      }
+      pthread_attr_destroy(&attr);
+   }
+   for (i = 0; i < nr_thr; i++) {
+      void* res;
+      pthread_join(thr[i], &res);
+      total += (long)res;
+   }
+   free(thr);
+
+   for (i = 0; i < 64; i++)
+      total += shared[i];
+   if (total == 42)
+      printf("unlikely\n");
+   return 0;
+}